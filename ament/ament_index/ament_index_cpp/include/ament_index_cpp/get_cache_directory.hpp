@@ -0,0 +1,69 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AMENT_INDEX_CPP__GET_CACHE_DIRECTORY_HPP_
+#define AMENT_INDEX_CPP__GET_CACHE_DIRECTORY_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include "ament_index_cpp/visibility_control.h"
+
+namespace ament_index_cpp
+{
+
+/// Return the directory where the content of the resource index may be cached between processes.
+/**
+ * The directory is given by the environment variable AMENT_INDEX_CACHE_DIR, it is created when
+ * the cache is written.
+ * Cached entries are validated against the modification time of the files and directories they
+ * were read from before being used.
+ *
+ * \return The directory, or an empty string if the environment variable is not set.
+ */
+AMENT_INDEX_CPP_PUBLIC
+std::string
+get_cache_directory();
+
+/// Return true if the content of a file or directory modified at the given time can be cached.
+/**
+ * Files and directories modified during the last two seconds are not cached, since they could
+ * still change without changing their modification time on file systems with a coarse timestamp
+ * resolution.
+ *
+ * \param mtime_sec The modification time, in seconds since the epoch.
+ */
+AMENT_INDEX_CPP_PUBLIC
+bool
+is_modification_time_cacheable(int64_t mtime_sec);
+
+/// Replace a file of a cache directory.
+/**
+ * The directory is created if needed.
+ * The content is written to a file unique to the process which is then renamed, so that
+ * concurrent readers always see a complete file.
+ *
+ * \param directory The cache directory.
+ * \param file_name The name of the file in the directory.
+ * \param content The new content of the file.
+ * \return false if the file could not be written.
+ */
+AMENT_INDEX_CPP_PUBLIC
+bool
+write_cache_file(
+  const std::string & directory, const std::string & file_name, const std::string & content);
+
+}  // namespace ament_index_cpp
+
+#endif  // AMENT_INDEX_CPP__GET_CACHE_DIRECTORY_HPP_
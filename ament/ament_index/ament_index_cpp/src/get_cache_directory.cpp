@@ -0,0 +1,122 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ament_index_cpp/get_cache_directory.hpp"
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <direct.h>
+#include <process.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <string>
+
+namespace ament_index_cpp
+{
+
+namespace
+{
+
+const int64_t racy_interval = 2;
+
+bool
+create_directories(const std::string & path)
+{
+  for (size_t pos = path.find_first_of("/\\", 1); ; pos = path.find_first_of("/\\", pos + 1)) {
+    std::string parent = path.substr(0, pos);
+#ifndef _WIN32
+    if (mkdir(parent.c_str(), 0755) != 0 && errno != EEXIST) {
+#else
+    // skip drive letters
+    if (parent.back() != ':' && _mkdir(parent.c_str()) != 0 && errno != EEXIST) {
+#endif
+      return false;
+    }
+    if (pos == std::string::npos) {
+      return true;
+    }
+  }
+}
+
+}  // namespace
+
+std::string
+get_cache_directory()
+{
+  char * cache_dir = nullptr;
+  const char * env_var = "AMENT_INDEX_CACHE_DIR";
+
+#ifndef _WIN32
+  cache_dir = getenv(env_var);
+  return cache_dir ? cache_dir : "";
+#else
+  size_t cache_dir_size;
+  _dupenv_s(&cache_dir, &cache_dir_size, env_var);
+  std::string result = cache_dir ? cache_dir : "";
+  if (cache_dir) {
+    free(cache_dir);
+  }
+  return result;
+#endif
+}
+
+bool
+is_modification_time_cacheable(int64_t mtime_sec)
+{
+  return mtime_sec + racy_interval <= static_cast<int64_t>(time(nullptr));
+}
+
+bool
+write_cache_file(
+  const std::string & directory, const std::string & file_name, const std::string & content)
+{
+  if (!create_directories(directory)) {
+    return false;
+  }
+  std::string path = directory + "/" + file_name;
+#ifndef _WIN32
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+#else
+  std::string tmp_path = path + ".tmp." + std::to_string(_getpid());
+#endif
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return false;
+    }
+    if (!file.write(content.data(), content.size()) || !file.flush()) {
+      file.close();
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+#ifdef _WIN32
+  std::remove(path.c_str());
+#endif
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace ament_index_cpp
@@ -14,17 +14,13 @@
 
 #include "ament_index_cpp/get_resources.hpp"
 
-#ifndef _WIN32
-#include <dirent.h>
-#include <errno.h>
-#else
-#include <windows.h>
-#endif
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "ament_index_cpp/get_search_paths.hpp"
+#include "resource_cache.hpp"
 
 namespace ament_index_cpp
 {
@@ -39,60 +35,17 @@ get_resources(const std::string & resource_type)
   auto paths = get_search_paths();
   for (auto base_path : paths) {
     auto path = base_path + "/share/ament_index/resource_index/" + resource_type;
-
-#ifndef _WIN32
-    auto dir = opendir(path.c_str());
-    if (!dir) {
+    std::vector<std::string> names;
+    if (!impl::list_resource_directory(path, names)) {
       continue;
     }
-    dirent * entry;
-    while ((entry = readdir(dir)) != NULL) {
-      // ignore directories
-      auto subdir = opendir((path + "/" + entry->d_name).c_str());
-      if (subdir) {
-        closedir(subdir);
-        continue;
-      }
-      if (errno != ENOTDIR) {
-        continue;
-      }
-
-      // ignore files starting with a dot
-      if (entry->d_name[0] == '.') {
-        continue;
+    for (const auto & name : names) {
+      if (resources.find(name) == resources.end()) {
+        resources[name] = base_path;
       }
-
-      if (resources.find(entry->d_name) == resources.end()) {
-        resources[entry->d_name] = base_path;
-      }
-    }
-    closedir(dir);
-
-#else
-    std::string pattern = path + "/*";
-    WIN32_FIND_DATA find_data;
-    HANDLE find_handle = FindFirstFile(pattern.c_str(), &find_data);
-    if (find_handle == INVALID_HANDLE_VALUE) {
-      continue;
     }
-    do {
-      // ignore directories
-      if ((find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-        continue;
-      }
-
-      // ignore files starting with a dot
-      if (find_data.cFileName[0] == '.') {
-        continue;
-      }
-
-      if (resources.find(find_data.cFileName) == resources.end()) {
-        resources[find_data.cFileName] = base_path;
-      }
-    } while (FindNextFile(find_handle, &find_data));
-    FindClose(find_handle);
-#endif
   }
+  impl::save_resource_cache();
   return resources;
 }
 
@@ -0,0 +1,300 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "resource_cache.hpp"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifndef _WIN32
+#include <dirent.h>
+#include <errno.h>
+#else
+#include <windows.h>
+#endif
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ament_index_cpp/get_cache_directory.hpp"
+
+namespace ament_index_cpp
+{
+namespace impl
+{
+
+namespace
+{
+
+const char * const cache_file_name = "ament_index_cpp_resources.cache";
+const char * const cache_file_header = "ament_index_cpp resources 1";
+
+struct Timestamp
+{
+  int64_t sec;
+  int64_t nsec;
+
+  bool operator==(const Timestamp & other) const
+  {
+    return sec == other.sec && nsec == other.nsec;
+  }
+};
+
+struct Listing
+{
+  Timestamp mtime;
+  std::vector<std::string> names;
+};
+
+struct ResourceCache
+{
+  std::mutex mutex;
+  std::unordered_map<std::string, Listing> listings;
+  // The cache directory the listings were loaded from, the cache file is read once per directory
+  std::string loaded_directory;
+  bool loaded = false;
+  bool dirty = false;
+};
+
+ResourceCache &
+get_cache()
+{
+  static ResourceCache cache;
+  return cache;
+}
+
+bool
+get_modification_time(const std::string & path, Timestamp & mtime)
+{
+#ifndef _WIN32
+  struct stat s;
+  if (stat(path.c_str(), &s) != 0 || !S_ISDIR(s.st_mode)) {
+    return false;
+  }
+  mtime.sec = static_cast<int64_t>(s.st_mtime);
+#ifdef __APPLE__
+  mtime.nsec = static_cast<int64_t>(s.st_mtimespec.tv_nsec);
+#else
+  mtime.nsec = static_cast<int64_t>(s.st_mtim.tv_nsec);
+#endif
+#else
+  struct _stat64 s;
+  if (_stat64(path.c_str(), &s) != 0 || !(s.st_mode & _S_IFDIR)) {
+    return false;
+  }
+  mtime.sec = static_cast<int64_t>(s.st_mtime);
+  mtime.nsec = 0;
+#endif
+  return true;
+}
+
+#ifndef _WIN32
+// Return true if the entry is a directory or its type cannot be determined.
+bool
+is_directory_entry(const std::string & path, const dirent * entry)
+{
+#ifdef _DIRENT_HAVE_D_TYPE
+  // the type is usually provided by readdir(), which saves a system call per entry
+  if (entry->d_type == DT_REG) {
+    return false;
+  }
+  if (entry->d_type == DT_DIR) {
+    return true;
+  }
+#endif
+  auto subdir = opendir((path + "/" + entry->d_name).c_str());
+  if (subdir) {
+    closedir(subdir);
+    return true;
+  }
+  return errno != ENOTDIR;
+}
+#endif
+
+bool
+scan_directory(const std::string & path, std::vector<std::string> & names)
+{
+  names.clear();
+#ifndef _WIN32
+  auto dir = opendir(path.c_str());
+  if (!dir) {
+    return false;
+  }
+  dirent * entry;
+  while ((entry = readdir(dir)) != NULL) {
+    // ignore files starting with a dot
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+
+    // ignore directories
+    if (is_directory_entry(path, entry)) {
+      continue;
+    }
+
+    names.push_back(entry->d_name);
+  }
+  closedir(dir);
+
+#else
+  std::string pattern = path + "/*";
+  WIN32_FIND_DATA find_data;
+  HANDLE find_handle = FindFirstFile(pattern.c_str(), &find_data);
+  if (find_handle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  do {
+    // ignore directories
+    if ((find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+      continue;
+    }
+
+    // ignore files starting with a dot
+    if (find_data.cFileName[0] == '.') {
+      continue;
+    }
+
+    names.push_back(find_data.cFileName);
+  } while (FindNextFile(find_handle, &find_data));
+  FindClose(find_handle);
+#endif
+  return true;
+}
+
+// Read the listings of the cache file, an invalid file is ignored as a whole.
+// Format: a header line, then for each directory a line "<sec> <nsec> <count> <path>" followed by
+// one line per resource name.
+void
+load_cache_file(
+  const std::string & directory, std::unordered_map<std::string, Listing> & listings)
+{
+  std::ifstream file(directory + "/" + cache_file_name);
+  if (!file) {
+    return;
+  }
+  std::string line;
+  if (!std::getline(file, line) || line != cache_file_header) {
+    return;
+  }
+  std::unordered_map<std::string, Listing> loaded;
+  Listing listing;
+  size_t count;
+  while (file >> listing.mtime.sec >> listing.mtime.nsec >> count) {
+    std::string path;
+    if (file.get() != ' ' || !std::getline(file, path) || path.empty()) {
+      return;
+    }
+    listing.names.resize(count);
+    for (auto & name : listing.names) {
+      if (!std::getline(file, name)) {
+        return;
+      }
+    }
+    loaded[path] = listing;
+  }
+  if (!file.eof()) {
+    return;
+  }
+  for (auto & entry : loaded) {
+    listings.insert(std::move(entry));
+  }
+}
+
+void
+write_cache(
+  const std::string & directory, const std::unordered_map<std::string, Listing> & listings)
+{
+  std::ostringstream content;
+  content << cache_file_header << "\n";
+  for (const auto & entry : listings) {
+    content << entry.second.mtime.sec << " " << entry.second.mtime.nsec << " " <<
+      entry.second.names.size() << " " << entry.first << "\n";
+    for (const auto & name : entry.second.names) {
+      content << name << "\n";
+    }
+  }
+  write_cache_file(directory, cache_file_name, content.str());
+}
+
+// Must be called with the cache mutex held.
+void
+load_cache(ResourceCache & cache, const std::string & directory)
+{
+  if (cache.loaded && cache.loaded_directory == directory) {
+    return;
+  }
+  cache.loaded = true;
+  cache.loaded_directory = directory;
+  if (!directory.empty()) {
+    // the listings of this process are missing from the cache file of the new directory
+    cache.dirty = !cache.listings.empty();
+    load_cache_file(directory, cache.listings);
+  }
+}
+
+}  // namespace
+
+bool
+list_resource_directory(const std::string & path, std::vector<std::string> & names)
+{
+  auto & cache = get_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  load_cache(cache, get_cache_directory());
+
+  Timestamp mtime;
+  if (!get_modification_time(path, mtime)) {
+    cache.listings.erase(path);
+    names.clear();
+    return false;
+  }
+  auto it = cache.listings.find(path);
+  if (it != cache.listings.end() && it->second.mtime == mtime) {
+    names = it->second.names;
+    return true;
+  }
+
+  if (!scan_directory(path, names)) {
+    return false;
+  }
+  if (!is_modification_time_cacheable(mtime.sec)) {
+    if (it != cache.listings.end()) {
+      cache.listings.erase(it);
+      cache.dirty = true;
+    }
+    return true;
+  }
+  cache.listings[path] = Listing{mtime, names};
+  cache.dirty = true;
+  return true;
+}
+
+void
+save_resource_cache()
+{
+  auto & cache = get_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (!cache.dirty || cache.loaded_directory.empty()) {
+    return;
+  }
+  cache.dirty = false;
+  write_cache(cache.loaded_directory, cache.listings);
+}
+
+}  // namespace impl
+}  // namespace ament_index_cpp
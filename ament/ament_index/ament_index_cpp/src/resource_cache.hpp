@@ -0,0 +1,49 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RESOURCE_CACHE_HPP_
+#define RESOURCE_CACHE_HPP_
+
+#include <string>
+#include <vector>
+
+namespace ament_index_cpp
+{
+namespace impl
+{
+
+/// List the resources of a resource type directory.
+/**
+ * Subdirectories and files starting with a dot are ignored.
+ * The listing is cached for the lifetime of the process, and in the directory returned by
+ * get_cache_directory() if any, as long as the modification time of the directory doesn't change.
+ *
+ * \param path The resource type directory.
+ * \param names The names of the resources, in no particular order.
+ * \return false if the directory doesn't exist.
+ */
+bool
+list_resource_directory(const std::string & path, std::vector<std::string> & names);
+
+/// Write the listings added since the last call to the cache directory, if any.
+/**
+ * Errors are ignored, the cache is only an optimization.
+ */
+void
+save_resource_cache();
+
+}  // namespace impl
+}  // namespace ament_index_cpp
+
+#endif  // RESOURCE_CACHE_HPP_
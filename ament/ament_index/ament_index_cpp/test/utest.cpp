@@ -15,12 +15,21 @@
 #include <gtest/gtest.h>
 
 #include <stdlib.h>
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#include <fstream>
 
 #include <list>
 #include <map>
 #include <stdexcept>
 #include <string>
 
+#include "ament_index_cpp/get_cache_directory.hpp"
 #include "ament_index_cpp/get_package_prefix.hpp"
 #include "ament_index_cpp/get_package_share_directory.hpp"
 #include "ament_index_cpp/get_packages_with_prefixes.hpp"
@@ -266,3 +275,87 @@ TEST(AmentIndexCpp, get_packages_with_prefixes) {
   // baz is found in prefix 2 only
   EXPECT_EQ(generate_subfolder_path("prefix2"), packages_with_prefixes["baz"]);
 }
+
+#ifndef _WIN32
+void set_modification_time(const std::string & path, time_t mtime)
+{
+  struct utimbuf times;
+  times.actime = mtime;
+  times.modtime = mtime;
+  if (utime(path.c_str(), &times)) {
+    throw std::runtime_error("Failed to set the modification time of '" + path + "'");
+  }
+}
+
+TEST(AmentIndexCpp, get_resources_cached) {
+  // Ensure that resource listings written to the cache directory are invalidated by changes
+  char prefix_template[] = "/tmp/ament_index_cpp_utest_XXXXXX";
+  ASSERT_NE(nullptr, mkdtemp(prefix_template));
+  std::string prefix = prefix_template;
+  std::string resource_path = prefix + "/share/ament_index/resource_index/cached_resource_type";
+  std::string cache_directory = prefix + "/cache/nested";
+  ASSERT_EQ(0, mkdir((prefix + "/share").c_str(), 0755));
+  ASSERT_EQ(0, mkdir((prefix + "/share/ament_index").c_str(), 0755));
+  ASSERT_EQ(0, mkdir((prefix + "/share/ament_index/resource_index").c_str(), 0755));
+  ASSERT_EQ(0, mkdir(resource_path.c_str(), 0755));
+  std::ofstream(resource_path + "/foo");
+  // Listings of directories modified during the last seconds are never cached
+  const time_t old_mtime = time(nullptr) - 100;
+  set_modification_time(resource_path, old_mtime);
+
+  ASSERT_EQ(0, setenv("AMENT_PREFIX_PATH", prefix.c_str(), 1));
+  ASSERT_EQ(0, setenv("AMENT_INDEX_CACHE_DIR", cache_directory.c_str(), 1));
+  EXPECT_EQ(cache_directory, ament_index_cpp::get_cache_directory());
+
+  std::map<std::string, std::string> resources =
+    ament_index_cpp::get_resources("cached_resource_type");
+  EXPECT_EQ(1UL, resources.size());
+  EXPECT_EQ(prefix, resources["foo"]);
+  std::string cache_file = cache_directory + "/ament_index_cpp_resources.cache";
+  EXPECT_TRUE(std::ifstream(cache_file).good());
+
+  // The cached listing is used as long as the modification time of the directory is the same
+  std::ofstream(resource_path + "/baz");
+  set_modification_time(resource_path, old_mtime);
+  resources = ament_index_cpp::get_resources("cached_resource_type");
+  EXPECT_EQ(1UL, resources.size());
+  EXPECT_EQ(0UL, resources.count("baz"));
+
+  // A new resource changes the modification time of the directory
+  std::ofstream(resource_path + "/bar");
+  set_modification_time(resource_path, time(nullptr) - 50);
+  resources = ament_index_cpp::get_resources("cached_resource_type");
+  EXPECT_EQ(3UL, resources.size());
+  EXPECT_EQ(prefix, resources["bar"]);
+  EXPECT_EQ(prefix, resources["baz"]);
+
+  // A directory modified just now is listed again even if its modification time is the same
+  const time_t new_mtime = time(nullptr);
+  unlink((resource_path + "/baz").c_str());
+  set_modification_time(resource_path, new_mtime);
+  resources = ament_index_cpp::get_resources("cached_resource_type");
+  EXPECT_EQ(2UL, resources.size());
+  std::ofstream(resource_path + "/baz");
+  set_modification_time(resource_path, new_mtime);
+  resources = ament_index_cpp::get_resources("cached_resource_type");
+  EXPECT_EQ(3UL, resources.size());
+
+  // A removed resource type directory is not found anymore
+  unlink((resource_path + "/foo").c_str());
+  unlink((resource_path + "/bar").c_str());
+  unlink((resource_path + "/baz").c_str());
+  rmdir(resource_path.c_str());
+  resources = ament_index_cpp::get_resources("cached_resource_type");
+  EXPECT_EQ(0UL, resources.size());
+
+  ASSERT_EQ(0, unsetenv("AMENT_INDEX_CACHE_DIR"));
+  EXPECT_EQ("", ament_index_cpp::get_cache_directory());
+  unlink(cache_file.c_str());
+  rmdir(cache_directory.c_str());
+  rmdir((prefix + "/cache").c_str());
+  rmdir((prefix + "/share/ament_index/resource_index").c_str());
+  rmdir((prefix + "/share/ament_index").c_str());
+  rmdir((prefix + "/share").c_str());
+  rmdir(prefix.c_str());
+}
+#endif
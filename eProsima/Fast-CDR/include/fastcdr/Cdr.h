@@ -1444,18 +1444,13 @@ namespace eprosima
 
                 /*!
                  * @brief This function serializes an array of strings.
+                 * The size of the whole array is computed first, so the buffer is only checked (and resized) once.
                  * @param string_t The array of strings that will be serialized in the buffer.
                  * @param numElements Number of the elements in the array.
                  * @return Reference to the eprosima::fastcdr::Cdr object.
                  * @exception exception::NotEnoughMemoryException This exception is thrown when trying to serialize a position that exceeds the internal memory size.
                  */
-                inline
-                    Cdr& serializeArray(const std::string *string_t, size_t numElements)
-                    {
-                        for(size_t count = 0; count < numElements; ++count)
-                            serialize(string_t[count].c_str());
-                        return *this;
-                    }
+                Cdr& serializeArray(const std::string *string_t, size_t numElements);
 
                 /*!
                  * @brief This function serializes an array of wide-strings.
@@ -1999,7 +1994,7 @@ namespace eprosima
                     {
                         uint32_t length = 0;
                         const char *str = readString(length);
-                        string_t = std::string(str, length);
+                        string_t.assign(str, length);
                         return *this;
                     }
 
@@ -2542,18 +2537,13 @@ namespace eprosima
 
                 /*!
                  * @brief This function deserializes an array of strings.
+                 * The strings reuse the memory they already own when it is large enough.
                  * @param string_t The variable that will store the array of strings read from the buffer.
                  * @param numElements Number of the elements in the array.
                  * @return Reference to the eprosima::fastcdr::Cdr object.
                  * @exception exception::NotEnoughMemoryException This exception is thrown when trying to deserialize a position that exceeds the internal memory size.
                  */
-                inline
-                    Cdr& deserializeArray(std::string *string_t, size_t numElements)
-                    {
-                        for(size_t count = 0; count < numElements; ++count)
-                            deserialize(string_t[count]);
-                        return *this;
-                    }
+                Cdr& deserializeArray(std::string *string_t, size_t numElements);
 
                 /*!
                  * @brief This function deserializes an array of wide-strings.
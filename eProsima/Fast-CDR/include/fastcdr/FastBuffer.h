@@ -277,6 +277,23 @@ namespace eprosima
                  */
                 bool resize(size_t minSizeInc);
 
+                /*!
+                 * @brief This function makes the object manage a stream of bytes allocated by the user with malloc.
+                 * From then on the stream is grown with realloc when needed and freed in the object's destruction, as an internal stream would.
+                 * It will only do so if the object has an internal stream that is not yet allocated.
+                 * @param buffer The user's stream, allocated with malloc. Cannot be NULL.
+                 * @param bufferSize The length of user's stream.
+                 * @return True if the stream was adopted. False if the raw buffer was set externally or is already allocated.
+                 */
+                bool adopt(char* const buffer, const size_t bufferSize);
+
+                /*!
+                 * @brief This function gives the internal stream back to the user, who has to free it.
+                 * The object is left without stream, as if it was just created with the default constructor.
+                 * @return The internal stream, or NULL if the object has no internal stream.
+                 */
+                char* release();
+
             private:
 
                 FastBuffer(const FastBuffer&) = delete;
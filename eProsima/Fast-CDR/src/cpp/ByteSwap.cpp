@@ -0,0 +1,345 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ByteSwap.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+// Vector instruction sets available at compile time.
+#if defined(__AVX2__)
+#define FASTCDR_BYTESWAP_AVX2 1
+#endif
+
+#if defined(__SSSE3__) || defined(FASTCDR_BYTESWAP_AVX2)
+#define FASTCDR_BYTESWAP_SSSE3 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FASTCDR_BYTESWAP_SSE2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FASTCDR_BYTESWAP_NEON 1
+#endif
+
+// x86 builds are usually not compiled for AVX2, so GCC and Clang select it at runtime.
+#if !defined(FASTCDR_BYTESWAP_AVX2) && defined(FASTCDR_BYTESWAP_SSE2) && \
+    (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FASTCDR_BYTESWAP_AVX2_DISPATCH 1
+#define FASTCDR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FASTCDR_TARGET_AVX2
+#endif
+
+#if defined(FASTCDR_BYTESWAP_AVX2) || defined(FASTCDR_BYTESWAP_AVX2_DISPATCH)
+#include <immintrin.h>
+#elif defined(FASTCDR_BYTESWAP_SSSE3)
+#include <tmmintrin.h>
+#elif defined(FASTCDR_BYTESWAP_SSE2)
+#include <emmintrin.h>
+#elif defined(FASTCDR_BYTESWAP_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace eprosima::fastcdr;
+
+namespace
+{
+    inline uint16_t swap16(uint16_t value)
+    {
+        return static_cast<uint16_t>((value >> 8) | (value << 8));
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    inline uint32_t swap32(uint32_t value) { return __builtin_bswap32(value); }
+
+    inline uint64_t swap64(uint64_t value) { return __builtin_bswap64(value); }
+#elif defined(_MSC_VER)
+    inline uint32_t swap32(uint32_t value) { return _byteswap_ulong(value); }
+
+    inline uint64_t swap64(uint64_t value) { return _byteswap_uint64(value); }
+#else
+    inline uint32_t swap32(uint32_t value)
+    {
+        return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) |
+            ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
+    }
+
+    inline uint64_t swap64(uint64_t value)
+    {
+        return (static_cast<uint64_t>(swap32(static_cast<uint32_t>(value))) << 32) |
+            swap32(static_cast<uint32_t>(value >> 32));
+    }
+#endif
+
+    // Portable kernels, also used for the elements left after the vector ones.
+
+    void scalarSwap2(char *dst, const char *src, size_t numElements)
+    {
+        for(size_t count = 0; count < numElements; ++count, dst += 2, src += 2)
+        {
+            uint16_t value;
+            memcpy(&value, src, sizeof(value));
+            value = swap16(value);
+            memcpy(dst, &value, sizeof(value));
+        }
+    }
+
+    void scalarSwap4(char *dst, const char *src, size_t numElements)
+    {
+        for(size_t count = 0; count < numElements; ++count, dst += 4, src += 4)
+        {
+            uint32_t value;
+            memcpy(&value, src, sizeof(value));
+            value = swap32(value);
+            memcpy(dst, &value, sizeof(value));
+        }
+    }
+
+    void scalarSwap8(char *dst, const char *src, size_t numElements)
+    {
+        for(size_t count = 0; count < numElements; ++count, dst += 8, src += 8)
+        {
+            uint64_t value;
+            memcpy(&value, src, sizeof(value));
+            value = swap64(value);
+            memcpy(dst, &value, sizeof(value));
+        }
+    }
+
+    void scalarSwap16(char *dst, const char *src, size_t numElements)
+    {
+        for(size_t count = 0; count < numElements; ++count, dst += 16, src += 16)
+        {
+            uint64_t low, high;
+            memcpy(&low, src, sizeof(low));
+            memcpy(&high, src + 8, sizeof(high));
+            low = swap64(low);
+            high = swap64(high);
+            memcpy(dst, &high, sizeof(high));
+            memcpy(dst + 8, &low, sizeof(low));
+        }
+    }
+
+#if defined(FASTCDR_BYTESWAP_SSSE3) || defined(FASTCDR_BYTESWAP_AVX2_DISPATCH)
+    // Byte shuffles that reverse each element of a 16 bytes lane.
+    template<size_t Size> struct ShuffleMask;
+
+    template<> struct ShuffleMask<2>
+    {
+        static const char *get()
+        {
+            static const char mask[16] = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+            return mask;
+        }
+    };
+
+    template<> struct ShuffleMask<4>
+    {
+        static const char *get()
+        {
+            static const char mask[16] = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+            return mask;
+        }
+    };
+
+    template<> struct ShuffleMask<8>
+    {
+        static const char *get()
+        {
+            static const char mask[16] = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+            return mask;
+        }
+    };
+
+    template<> struct ShuffleMask<16>
+    {
+        static const char *get()
+        {
+            static const char mask[16] = {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+            return mask;
+        }
+    };
+#endif
+
+#if defined(FASTCDR_BYTESWAP_AVX2) || defined(FASTCDR_BYTESWAP_AVX2_DISPATCH)
+    template<size_t Size>
+    FASTCDR_TARGET_AVX2 size_t avx2Swap(char *dst, const char *src, size_t numBytes)
+    {
+        const __m256i mask = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ShuffleMask<Size>::get())));
+        size_t done = 0;
+
+        for(; done + 32 <= numBytes; done += 32)
+        {
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + done));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + done), _mm256_shuffle_epi8(value, mask));
+        }
+
+        return done;
+    }
+#endif
+
+#if defined(FASTCDR_BYTESWAP_SSSE3)
+    template<size_t Size>
+    inline __m128i sseSwap(__m128i value)
+    {
+        return _mm_shuffle_epi8(value,
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ShuffleMask<Size>::get())));
+    }
+#elif defined(FASTCDR_BYTESWAP_SSE2)
+    // Without SSSE3 there is no byte shuffle: swap the bytes of each 16 bits word, then reorder the words.
+    inline __m128i swapWordBytes(__m128i value)
+    {
+        return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+    }
+
+    template<size_t Size> inline __m128i sseSwap(__m128i value);
+
+    template<> inline __m128i sseSwap<2>(__m128i value)
+    {
+        return swapWordBytes(value);
+    }
+
+    template<> inline __m128i sseSwap<4>(__m128i value)
+    {
+        value = swapWordBytes(value);
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    template<> inline __m128i sseSwap<8>(__m128i value)
+    {
+        value = swapWordBytes(value);
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+        return _mm_shufflehi_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+
+    template<> inline __m128i sseSwap<16>(__m128i value)
+    {
+        return _mm_shuffle_epi32(sseSwap<8>(value), _MM_SHUFFLE(1, 0, 3, 2));
+    }
+#endif
+
+#if defined(FASTCDR_BYTESWAP_SSSE3) || defined(FASTCDR_BYTESWAP_SSE2)
+    template<size_t Size>
+    size_t sseSwap(char *dst, const char *src, size_t numBytes)
+    {
+        size_t done = 0;
+
+        for(; done + 16 <= numBytes; done += 16)
+        {
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + done));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + done), sseSwap<Size>(value));
+        }
+
+        return done;
+    }
+#endif
+
+#if defined(FASTCDR_BYTESWAP_NEON)
+    template<size_t Size> inline uint8x16_t neonSwap(uint8x16_t value);
+
+    template<> inline uint8x16_t neonSwap<2>(uint8x16_t value) { return vrev16q_u8(value); }
+
+    template<> inline uint8x16_t neonSwap<4>(uint8x16_t value) { return vrev32q_u8(value); }
+
+    template<> inline uint8x16_t neonSwap<8>(uint8x16_t value) { return vrev64q_u8(value); }
+
+    template<> inline uint8x16_t neonSwap<16>(uint8x16_t value)
+    {
+        value = vrev64q_u8(value);
+        return vcombine_u8(vget_high_u8(value), vget_low_u8(value));
+    }
+
+    template<size_t Size>
+    size_t neonSwap(char *dst, const char *src, size_t numBytes)
+    {
+        size_t done = 0;
+
+        for(; done + 16 <= numBytes; done += 16)
+        {
+            uint8x16_t value = vld1q_u8(reinterpret_cast<const uint8_t*>(src + done));
+            vst1q_u8(reinterpret_cast<uint8_t*>(dst + done), neonSwap<Size>(value));
+        }
+
+        return done;
+    }
+#endif
+
+#if defined(FASTCDR_BYTESWAP_AVX2_DISPATCH)
+    bool hasAVX2()
+    {
+        static const bool available = []()
+        {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+        }();
+        return available;
+    }
+#endif
+
+    //! Swaps as many whole 16 (or 32) bytes blocks as possible, returns the number of bytes done.
+    template<size_t Size>
+    size_t vectorSwap(char *dst, const char *src, size_t numBytes)
+    {
+#if defined(FASTCDR_BYTESWAP_AVX2)
+        return avx2Swap<Size>(dst, src, numBytes);
+#elif defined(FASTCDR_BYTESWAP_AVX2_DISPATCH)
+        if(hasAVX2())
+        {
+            return avx2Swap<Size>(dst, src, numBytes);
+        }
+        return sseSwap<Size>(dst, src, numBytes);
+#elif defined(FASTCDR_BYTESWAP_SSSE3) || defined(FASTCDR_BYTESWAP_SSE2)
+        return sseSwap<Size>(dst, src, numBytes);
+#elif defined(FASTCDR_BYTESWAP_NEON)
+        return neonSwap<Size>(dst, src, numBytes);
+#else
+        (void)dst;
+        (void)src;
+        (void)numBytes;
+        return 0;
+#endif
+    }
+} // namespace
+
+void eprosima::fastcdr::byteSwapArray2(char *dst, const char *src, size_t numElements)
+{
+    size_t done = vectorSwap<2>(dst, src, numElements * 2);
+    scalarSwap2(dst + done, src + done, numElements - done / 2);
+}
+
+void eprosima::fastcdr::byteSwapArray4(char *dst, const char *src, size_t numElements)
+{
+    size_t done = vectorSwap<4>(dst, src, numElements * 4);
+    scalarSwap4(dst + done, src + done, numElements - done / 4);
+}
+
+void eprosima::fastcdr::byteSwapArray8(char *dst, const char *src, size_t numElements)
+{
+    size_t done = vectorSwap<8>(dst, src, numElements * 8);
+    scalarSwap8(dst + done, src + done, numElements - done / 8);
+}
+
+void eprosima::fastcdr::byteSwapArray16(char *dst, const char *src, size_t numElements)
+{
+    size_t done = vectorSwap<16>(dst, src, numElements * 16);
+    scalarSwap16(dst + done, src + done, numElements - done / 16);
+}
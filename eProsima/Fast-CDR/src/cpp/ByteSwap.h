@@ -0,0 +1,39 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _FASTCDR_BYTESWAP_H_
+#define _FASTCDR_BYTESWAP_H_
+
+#include <stddef.h>
+
+namespace eprosima
+{
+    namespace fastcdr
+    {
+        /*!
+         * @brief Kernels used to (de)serialize arrays of primitives whose endianness differs from the host one.
+         * Each one copies numElements elements of the given size from src to dst, reversing the byte order of every element.
+         * Neither buffer has to be aligned. They use SSE2/SSSE3/AVX2 or NEON when available, with a portable fallback.
+         */
+        void byteSwapArray2(char *dst, const char *src, size_t numElements);
+
+        void byteSwapArray4(char *dst, const char *src, size_t numElements);
+
+        void byteSwapArray8(char *dst, const char *src, size_t numElements);
+
+        void byteSwapArray16(char *dst, const char *src, size_t numElements);
+    } //namespace fastcdr
+} //namespace eprosima
+
+#endif // _FASTCDR_BYTESWAP_H_
@@ -14,6 +14,9 @@
 
 #include <fastcdr/Cdr.h>
 #include <fastcdr/exceptions/BadParamException.h>
+#include "ByteSwap.h"
+
+#include <string.h>
 
 using namespace eprosima::fastcdr;
 using namespace ::exception;
@@ -808,14 +811,8 @@ Cdr& Cdr::serializeArray(const int16_t *short_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            const char *dst = reinterpret_cast<const char*>(&short_t);
-            const char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*short_t))
-            {
-                m_currentPosition++ << dst[1];
-                m_currentPosition++ << dst[0];
-            }
+            byteSwapArray2(&m_currentPosition, reinterpret_cast<const char*>(short_t), numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -870,16 +867,8 @@ Cdr& Cdr::serializeArray(const int32_t *long_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            const char *dst = reinterpret_cast<const char*>(&long_t);
-            const char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*long_t))
-            {
-                m_currentPosition++ << dst[3];
-                m_currentPosition++ << dst[2];
-                m_currentPosition++ << dst[1];
-                m_currentPosition++ << dst[0];
-            }
+            byteSwapArray4(&m_currentPosition, reinterpret_cast<const char*>(long_t), numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -965,20 +954,8 @@ Cdr& Cdr::serializeArray(const int64_t *longlong_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            const char *dst = reinterpret_cast<const char*>(&longlong_t);
-            const char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*longlong_t))
-            {
-                m_currentPosition++ << dst[7];
-                m_currentPosition++ << dst[6];
-                m_currentPosition++ << dst[5];
-                m_currentPosition++ << dst[4];
-                m_currentPosition++ << dst[3];
-                m_currentPosition++ << dst[2];
-                m_currentPosition++ << dst[1];
-                m_currentPosition++ << dst[0];
-            }
+            byteSwapArray8(&m_currentPosition, reinterpret_cast<const char*>(longlong_t), numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -1033,16 +1010,8 @@ Cdr& Cdr::serializeArray(const float *float_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            const char *dst = reinterpret_cast<const char*>(&float_t);
-            const char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*float_t))
-            {
-                m_currentPosition++ << dst[3];
-                m_currentPosition++ << dst[2];
-                m_currentPosition++ << dst[1];
-                m_currentPosition++ << dst[0];
-            }
+            byteSwapArray4(&m_currentPosition, reinterpret_cast<const char*>(float_t), numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -1097,20 +1066,8 @@ Cdr& Cdr::serializeArray(const double *double_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            const char *dst = reinterpret_cast<const char*>(&double_t);
-            const char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*double_t))
-            {
-                m_currentPosition++ << dst[7];
-                m_currentPosition++ << dst[6];
-                m_currentPosition++ << dst[5];
-                m_currentPosition++ << dst[4];
-                m_currentPosition++ << dst[3];
-                m_currentPosition++ << dst[2];
-                m_currentPosition++ << dst[1];
-                m_currentPosition++ << dst[0];
-            }
+            byteSwapArray8(&m_currentPosition, reinterpret_cast<const char*>(double_t), numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -1166,48 +1123,19 @@ Cdr& Cdr::serializeArray(const long double *ldouble_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            const char *dst = reinterpret_cast<const char*>(&ldouble_t);
-            const char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*ldouble_t))
-            {
 #if defined(_WIN32)
+            for(size_t count = 0; count < numElements; ++count)
+            {
                 // Filled with 0's.
-                m_currentPosition++ << static_cast<char>(0);
-                m_currentPosition++ << static_cast<char>(0);
-                m_currentPosition++ << static_cast<char>(0);
-                m_currentPosition++ << static_cast<char>(0);
-                m_currentPosition++ << static_cast<char>(0);
-                m_currentPosition++ << static_cast<char>(0);
-                m_currentPosition++ << static_cast<char>(0);
-                m_currentPosition++ << static_cast<char>(0);
-                m_currentPosition++ << dst[7];
-                m_currentPosition++ << dst[6];
-                m_currentPosition++ << dst[5];
-                m_currentPosition++ << dst[4];
-                m_currentPosition++ << dst[3];
-                m_currentPosition++ << dst[2];
-                m_currentPosition++ << dst[1];
-                m_currentPosition++ << dst[0];
+                memset(&m_currentPosition, 0, 8);
+                m_currentPosition += 8;
+                byteSwapArray8(&m_currentPosition, reinterpret_cast<const char*>(&ldouble_t[count]), 1);
+                m_currentPosition += 8;
+            }
 #else
-                m_currentPosition++ << dst[15];
-                m_currentPosition++ << dst[14];
-                m_currentPosition++ << dst[13];
-                m_currentPosition++ << dst[12];
-                m_currentPosition++ << dst[11];
-                m_currentPosition++ << dst[10];
-                m_currentPosition++ << dst[9];
-                m_currentPosition++ << dst[8];
-                m_currentPosition++ << dst[7];
-                m_currentPosition++ << dst[6];
-                m_currentPosition++ << dst[5];
-                m_currentPosition++ << dst[4];
-                m_currentPosition++ << dst[3];
-                m_currentPosition++ << dst[2];
-                m_currentPosition++ << dst[1];
-                m_currentPosition++ << dst[0];
+            byteSwapArray16(&m_currentPosition, reinterpret_cast<const char*>(ldouble_t), numElements);
+            m_currentPosition += totalSize;
 #endif
-            }
         }
         else
         {
@@ -1250,6 +1178,52 @@ Cdr& Cdr::serializeArray(const long double *ldouble_t, size_t numElements, Endia
     return *this;
 }
 
+Cdr& Cdr::serializeArray(const std::string *string_t, size_t numElements)
+{
+    if(numElements == 0)
+    {
+        return *this;
+    }
+
+    // Each string is its length, aligned to 4 bytes, followed by its characters and the terminator.
+    size_t offset = m_currentPosition - m_alignPosition;
+    size_t totalSize = 0;
+
+    for(size_t count = 0; count < numElements; ++count)
+    {
+        totalSize += (sizeof(uint32_t) - ((offset + totalSize) % sizeof(uint32_t))) & (sizeof(uint32_t) - 1);
+        totalSize += sizeof(uint32_t) + strlen(string_t[count].c_str()) + 1;
+    }
+
+    if(((m_lastPosition - m_currentPosition) >= totalSize) || resize(totalSize))
+    {
+        for(size_t count = 0; count < numElements; ++count)
+        {
+            const char *str = string_t[count].c_str();
+            uint32_t length = static_cast<uint32_t>(strlen(str)) + 1;
+
+            m_currentPosition += (sizeof(uint32_t) - ((m_currentPosition - m_alignPosition) % sizeof(uint32_t))) &
+                (sizeof(uint32_t) - 1);
+
+            if(m_swapBytes)
+                byteSwapArray4(&m_currentPosition, reinterpret_cast<const char*>(&length), 1);
+            else
+                m_currentPosition.memcopy(&length, sizeof(length));
+            m_currentPosition += sizeof(length);
+
+            m_currentPosition.memcopy(str, length);
+            m_currentPosition += length;
+        }
+
+        // Save last datasize.
+        m_lastDataSize = sizeof(uint8_t);
+
+        return *this;
+    }
+
+    throw NotEnoughMemoryException(NotEnoughMemoryException::NOT_ENOUGH_MEMORY_MESSAGE_DEFAULT);
+}
+
 Cdr& Cdr::deserialize(char &char_t)
 {
     if((m_lastPosition - m_currentPosition) >= sizeof(char_t))
@@ -1885,14 +1859,8 @@ Cdr& Cdr::deserializeArray(int16_t *short_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            char *dst = reinterpret_cast<char*>(&short_t);
-            char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*short_t))
-            {
-                m_currentPosition++ >> dst[1];
-                m_currentPosition++ >> dst[0];
-            }
+            byteSwapArray2(reinterpret_cast<char*>(short_t), &m_currentPosition, numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -1947,16 +1915,8 @@ Cdr& Cdr::deserializeArray(int32_t *long_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            char *dst = reinterpret_cast<char*>(&long_t);
-            char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*long_t))
-            {
-                m_currentPosition++ >> dst[3];
-                m_currentPosition++ >> dst[2];
-                m_currentPosition++ >> dst[1];
-                m_currentPosition++ >> dst[0];
-            }
+            byteSwapArray4(reinterpret_cast<char*>(long_t), &m_currentPosition, numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -2046,20 +2006,8 @@ Cdr& Cdr::deserializeArray(int64_t *longlong_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            char *dst = reinterpret_cast<char*>(&longlong_t);
-            char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*longlong_t))
-            {
-                m_currentPosition++ >> dst[7];
-                m_currentPosition++ >> dst[6];
-                m_currentPosition++ >> dst[5];
-                m_currentPosition++ >> dst[4];
-                m_currentPosition++ >> dst[3];
-                m_currentPosition++ >> dst[2];
-                m_currentPosition++ >> dst[1];
-                m_currentPosition++ >> dst[0];
-            }
+            byteSwapArray8(reinterpret_cast<char*>(longlong_t), &m_currentPosition, numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -2114,16 +2062,8 @@ Cdr& Cdr::deserializeArray(float *float_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            char *dst = reinterpret_cast<char*>(&float_t);
-            char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*float_t))
-            {
-                m_currentPosition++ >> dst[3];
-                m_currentPosition++ >> dst[2];
-                m_currentPosition++ >> dst[1];
-                m_currentPosition++ >> dst[0];
-            }
+            byteSwapArray4(reinterpret_cast<char*>(float_t), &m_currentPosition, numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -2178,20 +2118,8 @@ Cdr& Cdr::deserializeArray(double *double_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            char *dst = reinterpret_cast<char*>(&double_t);
-            char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*double_t))
-            {
-                m_currentPosition++ >> dst[7];
-                m_currentPosition++ >> dst[6];
-                m_currentPosition++ >> dst[5];
-                m_currentPosition++ >> dst[4];
-                m_currentPosition++ >> dst[3];
-                m_currentPosition++ >> dst[2];
-                m_currentPosition++ >> dst[1];
-                m_currentPosition++ >> dst[0];
-            }
+            byteSwapArray8(reinterpret_cast<char*>(double_t), &m_currentPosition, numElements);
+            m_currentPosition += totalSize;
         }
         else
         {
@@ -2247,40 +2175,17 @@ Cdr& Cdr::deserializeArray(long double *ldouble_t, size_t numElements)
 
         if(m_swapBytes)
         {
-            char *dst = reinterpret_cast<char*>(&ldouble_t);
-            char *end = dst + totalSize;
-
-            for(; dst < end; dst += sizeof(*ldouble_t))
-            {
 #if defined(_WIN32)
+            for(size_t count = 0; count < numElements; ++count)
+            {
+                m_currentPosition += 8;   // Ignore first 8 bytes
+                byteSwapArray8(reinterpret_cast<char*>(&ldouble_t[count]), &m_currentPosition, 1);
                 m_currentPosition += 8;
-                m_currentPosition++ >> dst[7];
-                m_currentPosition++ >> dst[6];
-                m_currentPosition++ >> dst[5];
-                m_currentPosition++ >> dst[4];
-                m_currentPosition++ >> dst[3];
-                m_currentPosition++ >> dst[2];
-                m_currentPosition++ >> dst[1];
-                m_currentPosition++ >> dst[0];
+            }
 #else
-                m_currentPosition++ >> dst[15];
-                m_currentPosition++ >> dst[14];
-                m_currentPosition++ >> dst[13];
-                m_currentPosition++ >> dst[12];
-                m_currentPosition++ >> dst[11];
-                m_currentPosition++ >> dst[10];
-                m_currentPosition++ >> dst[9];
-                m_currentPosition++ >> dst[8];
-                m_currentPosition++ >> dst[7];
-                m_currentPosition++ >> dst[6];
-                m_currentPosition++ >> dst[5];
-                m_currentPosition++ >> dst[4];
-                m_currentPosition++ >> dst[3];
-                m_currentPosition++ >> dst[2];
-                m_currentPosition++ >> dst[1];
-                m_currentPosition++ >> dst[0];
+            byteSwapArray16(reinterpret_cast<char*>(ldouble_t), &m_currentPosition, numElements);
+            m_currentPosition += totalSize;
 #endif
-            }
         }
         else
         {
@@ -2322,6 +2227,54 @@ Cdr& Cdr::deserializeArray(long double *ldouble_t, size_t numElements, Endiannes
     return *this;
 }
 
+Cdr& Cdr::deserializeArray(std::string *string_t, size_t numElements)
+{
+    if(numElements == 0)
+    {
+        return *this;
+    }
+
+    state state_before_error(*this);
+
+    for(size_t count = 0; count < numElements; ++count)
+    {
+        size_t align = (sizeof(uint32_t) - ((m_currentPosition - m_alignPosition) % sizeof(uint32_t))) &
+            (sizeof(uint32_t) - 1);
+        uint32_t length = 0;
+
+        if((m_lastPosition - m_currentPosition) < align + sizeof(length))
+        {
+            setState(state_before_error);
+            throw NotEnoughMemoryException(NotEnoughMemoryException::NOT_ENOUGH_MEMORY_MESSAGE_DEFAULT);
+        }
+
+        m_currentPosition += align;
+        if(m_swapBytes)
+            byteSwapArray4(reinterpret_cast<char*>(&length), &m_currentPosition, 1);
+        else
+            m_currentPosition.rmemcopy(&length, sizeof(length));
+        m_currentPosition += sizeof(length);
+
+        if((m_lastPosition - m_currentPosition) < length)
+        {
+            setState(state_before_error);
+            throw NotEnoughMemoryException(NotEnoughMemoryException::NOT_ENOUGH_MEMORY_MESSAGE_DEFAULT);
+        }
+
+        const char *str = &m_currentPosition;
+        m_currentPosition += length;
+
+        if(length > 0 && str[length - 1] == '\0')
+            --length;
+        string_t[count].assign(str, length);
+    }
+
+    // Save last datasize.
+    m_lastDataSize = sizeof(uint8_t);
+
+    return *this;
+}
+
 Cdr& Cdr::serializeBoolSequence(const std::vector<bool> &vector_t)
 {
     state state_before_error(*this);
@@ -2335,15 +2288,13 @@ Cdr& Cdr::serializeBoolSequence(const std::vector<bool> &vector_t)
         // Save last datasize.
         m_lastDataSize = sizeof(bool);
 
-        for(size_t count = 0; count < vector_t.size(); ++count)
-        {
-            uint8_t value = 0;
-            std::vector<bool>::const_reference ref = vector_t[count];
+        char *dst = &m_currentPosition;
+        std::vector<bool>::const_iterator it = vector_t.begin();
 
-            if(ref)
-                value = 1;
-            m_currentPosition++ << value;
-        }
+        for(size_t count = 0; count < vector_t.size(); ++count, ++it)
+            dst[count] = *it ? 1 : 0;
+
+        m_currentPosition += totalSize;
     }
     else
     {
@@ -2369,22 +2320,24 @@ Cdr& Cdr::deserializeBoolSequence(std::vector<bool> &vector_t)
         // Save last datasize.
         m_lastDataSize = sizeof(bool);
 
+        const char *src = &m_currentPosition;
+        char invalid = 0;
+
+        // Validate the whole sequence first, so the conversion loop has no branches.
         for(uint32_t count = 0; count < seqLength; ++count)
-        {
-            uint8_t value = 0;
-            m_currentPosition++ >> value;
+            invalid |= src[count] & ~1;
 
-            if(value == 1)
-            {
-                vector_t[count] = true;
-            }
-            else if(value == 0)
-            {
-                vector_t[count] = false;
-            } else {
-                throw BadParamException("Unexpected byte value in Cdr::deserializeBoolSequence, expected 0 or 1");
-            }
+        if(invalid)
+        {
+            throw BadParamException("Unexpected byte value in Cdr::deserializeBoolSequence, expected 0 or 1");
         }
+
+        std::vector<bool>::iterator it = vector_t.begin();
+
+        for(uint32_t count = 0; count < seqLength; ++count, ++it)
+            *it = src[count] != 0;
+
+        m_currentPosition += totalSize;
     }
     else
     {
@@ -2409,7 +2362,7 @@ Cdr& Cdr::deserializeStringSequence(std::string *&sequence_t, size_t &numElement
     }
     catch(eprosima::fastcdr::exception::Exception &ex)
     {
-        free(sequence_t);
+        delete [] sequence_t;
         sequence_t = NULL;
         setState(state_before_error);
         ex.raise();
@@ -2433,7 +2386,7 @@ Cdr& Cdr::deserializeWStringSequence(std::wstring *&sequence_t, size_t &numEleme
     }
     catch(eprosima::fastcdr::exception::Exception &ex)
     {
-        free(sequence_t);
+        delete [] sequence_t;
         sequence_t = NULL;
         setState(state_before_error);
         ex.raise();
@@ -61,7 +61,13 @@ bool FastBuffer::resize(size_t minSizeInc)
 
     if(m_internalBuffer)
     {
-        if(minSizeInc > BUFFER_START_LENGTH)
+        // Grow geometrically, so serializing into a buffer that starts small is still linear.
+        if(incBufferSize < m_bufferSize / 2)
+        {
+            incBufferSize = m_bufferSize / 2;
+        }
+
+        if(minSizeInc > incBufferSize)
         {
             incBufferSize = minSizeInc;
         }
@@ -79,12 +85,12 @@ bool FastBuffer::resize(size_t minSizeInc)
         }
         else
         {
-            m_bufferSize += incBufferSize;
+            char* newBuffer = reinterpret_cast<char*>(realloc(m_buffer, m_bufferSize + incBufferSize));
 
-            m_buffer = reinterpret_cast<char*>(realloc(m_buffer, m_bufferSize));
-
-            if(m_buffer != NULL)
+            if(newBuffer != NULL)
             {
+                m_buffer = newBuffer;
+                m_bufferSize += incBufferSize;
                 return true;
             }
         }
@@ -92,3 +98,29 @@ bool FastBuffer::resize(size_t minSizeInc)
 
     return false;
 }
+
+bool FastBuffer::adopt(char* const buffer, const size_t bufferSize)
+{
+    if(m_internalBuffer && m_buffer == NULL && buffer != NULL)
+    {
+        m_buffer = buffer;
+        m_bufferSize = bufferSize;
+        return true;
+    }
+
+    return false;
+}
+
+char* FastBuffer::release()
+{
+    char* buffer = NULL;
+
+    if(m_internalBuffer)
+    {
+        buffer = m_buffer;
+        m_buffer = NULL;
+        m_bufferSize = 0;
+    }
+
+    return buffer;
+}
@@ -0,0 +1,136 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of the (de)serialization of arrays, both in the host endianness and in the
+// opposite one, and of sequences of strings.
+//
+// Usage: ArraysBenchmark [elements] [iterations]
+
+#include <fastcdr/Cdr.h>
+#include <fastcdr/FastBuffer.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace eprosima::fastcdr;
+
+typedef std::chrono::steady_clock Clock;
+
+static double megabytesPerSecond(Clock::time_point start, size_t bytes)
+{
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds;
+}
+
+template<class T>
+static void benchmarkArray(const char *name, size_t elements, size_t iterations)
+{
+    const Cdr::Endianness endianness[2] = {Cdr::DEFAULT_ENDIAN,
+        Cdr::DEFAULT_ENDIAN == Cdr::BIG_ENDIANNESS ? Cdr::LITTLE_ENDIANNESS : Cdr::BIG_ENDIANNESS};
+    std::vector<T> input(elements), output(elements);
+    std::vector<char> raw(elements * sizeof(T) + 16);
+    double results[4];
+
+    for(size_t count = 0; count < elements; ++count)
+        input[count] = static_cast<T>(count);
+
+    for(int swap = 0; swap < 2; ++swap)
+    {
+        FastBuffer buffer(raw.data(), raw.size());
+
+        Clock::time_point start = Clock::now();
+        for(size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            Cdr ser(buffer, endianness[swap]);
+            ser.serializeArray(input.data(), elements);
+        }
+        results[swap * 2] = megabytesPerSecond(start, iterations * elements * sizeof(T));
+
+        start = Clock::now();
+        for(size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            Cdr deser(buffer, endianness[swap]);
+            deser.deserializeArray(output.data(), elements);
+        }
+        results[swap * 2 + 1] = megabytesPerSecond(start, iterations * elements * sizeof(T));
+
+        if(input != output)
+        {
+            fprintf(stderr, "%s: round trip failed\n", name);
+            exit(1);
+        }
+    }
+
+    printf("%-16s %12.1f %12.1f %12.1f %12.1f\n", name, results[0], results[1], results[2], results[3]);
+}
+
+static void benchmarkStrings(size_t elements, size_t iterations)
+{
+    std::vector<std::string> input(elements), output;
+    size_t bytes = 0;
+
+    for(size_t count = 0; count < elements; ++count)
+    {
+        input[count] = std::string("string_") + std::to_string(count * 7919);
+        bytes += input[count].size();
+    }
+
+    FastBuffer buffer;
+    double results[2];
+
+    Clock::time_point start = Clock::now();
+    for(size_t iteration = 0; iteration < iterations; ++iteration)
+    {
+        Cdr ser(buffer);
+        ser << input;
+    }
+    results[0] = megabytesPerSecond(start, iterations * bytes);
+
+    start = Clock::now();
+    for(size_t iteration = 0; iteration < iterations; ++iteration)
+    {
+        Cdr deser(buffer);
+        deser >> output;
+    }
+    results[1] = megabytesPerSecond(start, iterations * bytes);
+
+    if(input != output)
+    {
+        fprintf(stderr, "string sequence: round trip failed\n");
+        exit(1);
+    }
+
+    printf("%-16s %12.1f %12.1f %12s %12s\n", "string sequence", results[0], results[1], "-", "-");
+}
+
+int main(int argc, char **argv)
+{
+    size_t elements = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 4096;
+    size_t iterations = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 10000;
+
+    printf("MB/s for %zu elements over %zu iterations\n", elements, iterations);
+    printf("%-16s %12s %12s %12s %12s\n", "type", "ser", "deser", "ser swap", "deser swap");
+
+    benchmarkArray<int16_t>("int16", elements, iterations);
+    benchmarkArray<int32_t>("int32", elements, iterations);
+    benchmarkArray<int64_t>("int64", elements, iterations);
+    benchmarkArray<float>("float", elements, iterations);
+    benchmarkArray<double>("double", elements, iterations);
+    benchmarkStrings(elements, iterations / 10 + 1);
+
+    return 0;
+}
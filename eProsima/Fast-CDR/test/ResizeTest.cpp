@@ -4814,3 +4814,37 @@ TEST(CDRResizeTests, ReserveBuffer)
     EXPECT_EQ(false, buffer2.reserve(100));
     EXPECT_EQ(10u, buffer2.getBufferSize());
 }
+
+TEST(CDRResizeTests, AdoptBuffer)
+{
+    char* raw_buffer = reinterpret_cast<char*>(malloc(4));
+
+    FastBuffer buffer;
+    EXPECT_EQ(true, buffer.adopt(raw_buffer, 4));
+    EXPECT_EQ(4u, buffer.getBufferSize());
+    EXPECT_EQ(false, buffer.adopt(raw_buffer, 4));
+
+    // The adopted stream grows while serializing.
+    Cdr cdr(buffer);
+    cdr << string_t;
+    EXPECT_LE(cdr.getSerializedDataLength(), buffer.getBufferSize());
+
+    size_t size = buffer.getBufferSize();
+    char* serialized = buffer.release();
+    ASSERT_NE(nullptr, serialized);
+    EXPECT_EQ(nullptr, buffer.getBuffer());
+    EXPECT_EQ(0u, buffer.getBufferSize());
+
+    FastBuffer input(serialized, size);
+    Cdr cdr_input(input);
+    std::string string_value;
+    cdr_input >> string_value;
+    EXPECT_EQ(string_t, string_value);
+    free(serialized);
+
+    char stack_buffer[10];
+    FastBuffer buffer_external(&stack_buffer[0], 10);
+    EXPECT_EQ(false, buffer_external.adopt(raw_buffer, 4));
+    EXPECT_EQ(nullptr, buffer_external.release());
+    EXPECT_EQ(10u, buffer_external.getBufferSize());
+}
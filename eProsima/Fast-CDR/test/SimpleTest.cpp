@@ -15,10 +15,14 @@
 #include <fastcdr/Cdr.h>
 #include <fastcdr/FastCdr.h>
 #include <fastcdr/exceptions/Exception.h>
+#include <fastcdr/exceptions/BadParamException.h>
+#include <fastcdr/exceptions/NotEnoughMemoryException.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <limits>
 #include <iostream>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -9346,3 +9350,163 @@ TEST(FastCDRTests, ZeroSequenceAtTheEnd)
         cdr_des_bool >> value >> bool_zero_sequence;
     });
 }
+
+// Arrays whose endianness differs from the host one are swapped in blocks. The elements are checked against the
+// ones serialized one by one, using enough of them to go through both the block and the tail code paths.
+template<typename T>
+static void checkSwappedArray(const std::vector<T> &values)
+{
+    const Cdr::Endianness swapped = Cdr::DEFAULT_ENDIAN == Cdr::BIG_ENDIANNESS ?
+        Cdr::LITTLE_ENDIANNESS : Cdr::BIG_ENDIANNESS;
+    // Unaligned in memory on purpose.
+    char array_buffer[BUFFER_LENGTH + 1];
+    char element_buffer[BUFFER_LENGTH];
+    // Padding bytes are not written.
+    memset(array_buffer, 0, sizeof(array_buffer));
+    memset(element_buffer, 0, sizeof(element_buffer));
+
+    FastBuffer array_cdrbuffer(array_buffer + 1, BUFFER_LENGTH);
+    FastBuffer element_cdrbuffer(element_buffer, BUFFER_LENGTH);
+    Cdr cdr_array_ser(array_cdrbuffer, swapped);
+    Cdr cdr_element_ser(element_cdrbuffer, swapped);
+
+    EXPECT_NO_THROW(
+    {
+        cdr_array_ser << octet_t;
+        cdr_array_ser.serializeArray(values.data(), values.size());
+        cdr_array_ser << octet_t;
+        cdr_element_ser << octet_t;
+        for(size_t count = 0; count < values.size(); ++count)
+            cdr_element_ser << values[count];
+        cdr_element_ser << octet_t;
+    });
+
+    ASSERT_EQ(cdr_array_ser.getSerializedDataLength(), cdr_element_ser.getSerializedDataLength());
+    EXPECT_EQ(memcmp(array_buffer + 1, element_buffer, cdr_array_ser.getSerializedDataLength()), 0);
+
+    Cdr cdr_des(array_cdrbuffer, swapped);
+    std::vector<T> result(values.size());
+    uint8_t octet_value = 0, octet_value_end = 0;
+
+    EXPECT_NO_THROW(
+    {
+        cdr_des >> octet_value;
+        cdr_des.deserializeArray(&result[0], result.size());
+        cdr_des >> octet_value_end;
+    });
+
+    EXPECT_EQ(octet_value, octet_t);
+    EXPECT_EQ(octet_value_end, octet_t);
+    EXPECT_TRUE(result == values);
+}
+
+TEST(CDRTests, SwappedEndiannessArrays)
+{
+    std::vector<int16_t> short_values;
+    std::vector<int32_t> long_values;
+    std::vector<int64_t> longlong_values;
+    std::vector<float> float_values;
+    std::vector<double> double_values;
+
+    for(int count = 0; count < 37; ++count)
+    {
+        short_values.push_back(static_cast<int16_t>(short_t + count * 259));
+        long_values.push_back(long_t + count * 16843009);
+        longlong_values.push_back(longlong_t + count * 72340172838076673LL);
+        float_values.push_back(float_tt + static_cast<float>(count) * 1.5f);
+        double_values.push_back(double_tt + static_cast<double>(count) * 1.5);
+    }
+
+    checkSwappedArray(short_values);
+    checkSwappedArray(long_values);
+    checkSwappedArray(longlong_values);
+    checkSwappedArray(float_values);
+    checkSwappedArray(double_values);
+}
+
+TEST(CDRTests, SwappedEndiannessStringArray)
+{
+    const Cdr::Endianness swapped = Cdr::DEFAULT_ENDIAN == Cdr::BIG_ENDIANNESS ?
+        Cdr::LITTLE_ENDIANNESS : Cdr::BIG_ENDIANNESS;
+    char array_buffer[BUFFER_LENGTH];
+    char element_buffer[BUFFER_LENGTH];
+    // Padding bytes are not written.
+    memset(array_buffer, 0, sizeof(array_buffer));
+    memset(element_buffer, 0, sizeof(element_buffer));
+
+    FastBuffer array_cdrbuffer(array_buffer, BUFFER_LENGTH);
+    FastBuffer element_cdrbuffer(element_buffer, BUFFER_LENGTH);
+    Cdr cdr_array_ser(array_cdrbuffer, swapped);
+    Cdr cdr_element_ser(element_cdrbuffer, swapped);
+
+    EXPECT_NO_THROW(
+    {
+        cdr_array_ser << octet_t << string_array_t << emptystring_t << octet_t;
+        cdr_element_ser << octet_t;
+        for(size_t count = 0; count < string_array_t.size(); ++count)
+            cdr_element_ser << string_array_t[count];
+        cdr_element_ser << emptystring_t << octet_t;
+    });
+
+    ASSERT_EQ(cdr_array_ser.getSerializedDataLength(), cdr_element_ser.getSerializedDataLength());
+    EXPECT_EQ(memcmp(array_buffer, element_buffer, cdr_array_ser.getSerializedDataLength()), 0);
+
+    Cdr cdr_des(array_cdrbuffer, swapped);
+    std::array<std::string, 5> string_array_value;
+    std::string emptystring_value = "not empty";
+    uint8_t octet_value = 0, octet_value_end = 0;
+
+    EXPECT_NO_THROW(
+    {
+        cdr_des >> octet_value >> string_array_value >> emptystring_value >> octet_value_end;
+    });
+
+    EXPECT_EQ(octet_value, octet_t);
+    EXPECT_TRUE(string_array_value == string_array_t);
+    EXPECT_EQ(emptystring_value, emptystring_t);
+    EXPECT_EQ(octet_value_end, octet_t);
+
+    // Not enough data for the last string.
+    FastBuffer short_cdrbuffer(array_buffer, 20);
+    Cdr cdr_short_des(short_cdrbuffer, swapped);
+
+    EXPECT_THROW(
+    {
+        cdr_short_des >> octet_value >> string_array_value;
+    },
+    NotEnoughMemoryException);
+}
+
+TEST(CDRTests, BoolSequenceInvalidValue)
+{
+    char buffer[BUFFER_LENGTH];
+    std::vector<bool> bool_seq_sent = {true, false, true, true, false};
+
+    FastBuffer cdrbuffer(buffer, BUFFER_LENGTH);
+    Cdr cdr_ser(cdrbuffer);
+
+    EXPECT_NO_THROW(
+    {
+        cdr_ser << bool_seq_sent;
+    });
+
+    Cdr cdr_des(cdrbuffer);
+    std::vector<bool> bool_seq_value;
+
+    EXPECT_NO_THROW(
+    {
+        cdr_des >> bool_seq_value;
+    });
+
+    EXPECT_TRUE(bool_seq_value == bool_seq_sent);
+
+    // A byte other than 0 or 1 is rejected.
+    buffer[sizeof(uint32_t) + 3] = 2;
+    Cdr cdr_bad_des(cdrbuffer);
+
+    EXPECT_THROW(
+    {
+        cdr_bad_des >> bool_seq_value;
+    },
+    BadParamException);
+}
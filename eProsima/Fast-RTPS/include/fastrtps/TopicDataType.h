@@ -59,6 +59,13 @@ class  TopicDataType {
          */
         RTPS_DllAPI virtual bool deserialize(rtps::SerializedPayload_t* payload, void* data) = 0;
 
+        /**
+         * Get a function that computes the serialized size of the data, used to reserve the payload passed to serialize.
+         * The function may return 0 when the size is not known beforehand. The payload then starts with the
+         * initial payload size of the history, and serialize is responsible for growing it (with realloc) if needed.
+         * @param[in] data Pointer to the data
+         * @return Function that returns the serialized size of the data.
+         */
         RTPS_DllAPI virtual std::function<uint32_t()> getSerializedSizeProvider(void* data) = 0;
 
         /**
@@ -16,12 +16,17 @@
 #ifndef _FASTRTPS_LOG_LOG_H_
 #define _FASTRTPS_LOG_LOG_H_
 
-#include <fastrtps/utils/DBQueue.h>
+#include <fastrtps/utils/BoundedLockFreeQueue.h>
 #include <fastrtps/fastrtps_dll.h>
 #include <thread>
-#include <sstream>
+#include <ostream>
+#include <streambuf>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <regex>
+#include <type_traits>
+#include <vector>
 
 /**
  * eProsima log layer. Logging categories and verbosities can be specified dynamically at runtime. However, even on a category 
@@ -32,7 +37,20 @@
  * * #define LOG_NO_WARNING
  * * #define LOG_NO_INFO
  *
+ * Whole categories can be compiled out as well, by defining LOG_NO_CATEGORIES as a string
+ * literal holding a comma-separated list of category names (no spaces), for example:
+ *
+ * * #define LOG_NO_CATEGORIES "RTPS_MSG_IN,RTPS_WRITER"
+ *
+ * This last one requires a compiler with constexpr support.
+ *
  * Additionally. the lowest level (Info) is disabled by default on release branches.
+ *
+ * The hot path of an enabled log macro does not allocate nor lock: category and filename filters
+ * are evaluated once per call site and cached until the filters change, the message is formatted
+ * into a fixed-size record on the stack, and the record is handed to the logging thread through
+ * a bounded lock-free queue. Messages longer than Log::MaxMessageLength are truncated, and entries
+ * that do not fit in the queue are dropped and reported as such by the logging thread.
  */
 
 // Logging API:
@@ -112,6 +130,63 @@ public:
       Log::Kind kind;
    };
 
+   //! Longest message a log entry can carry, including the terminating null character.
+   static const size_t MaxMessageLength = 256;
+   //! Number of log records that can be waiting for the logging thread at any time.
+   static const size_t QueueCapacity = 1024;
+
+   /**
+    * Preformatted log entry, as it travels from the logging macros to the logging thread.
+    * It has a fixed size, so queueing it never allocates.
+    */
+   struct Record
+   {
+      char message[MaxMessageLength];
+      size_t length;
+      Log::Context context;
+      Log::Kind kind;
+   };
+
+   /**
+    * Formats a log message into a Record, truncating it if it does not fit.
+    * Meant to be created on the stack of the logging call site.
+    */
+   class RecordStream : private std::streambuf, public std::ostream
+   {
+   public:
+      RTPS_DllAPI RecordStream();
+      const Record& GetRecord(const Log::Context&, Log::Kind);
+
+   private:
+      std::streambuf::int_type overflow(std::streambuf::int_type) override;
+
+      Record mRecord;
+      bool mTruncated;
+   };
+
+   /**
+    * Cached result of the category and filename filters for a single logging call site.
+    * Both only depend on the call site, so they are evaluated once, and then again only
+    * after the filters are changed. Meant to be a zero-initialized static of the call site.
+    */
+   struct CallSite
+   {
+      // Filter generation the cached result belongs to (upper bits) and the result itself (lowest bit).
+      std::atomic<uint32_t> mState;
+   };
+
+   //! Returns true if the call site passes the category and filename filters.
+   RTPS_DllAPI static bool Accepts(CallSite&, const Log::Context&);
+
+#if HAVE_CXX_CONSTEXPR
+   //! Returns true if the category appears in the comma-separated list. Usable in constant expressions.
+   static constexpr bool IsCategoryListed(const char* list, const char* category)
+   {
+      return *list == '\0' ? false :
+         (CategoryMatches(list, category) ? true : IsCategoryListed(NextCategory(list), category));
+   }
+#endif
+
    /** 
     * Not recommended to call this method directly! Use the following macros:
     *  * logInfo(cat, msg);
@@ -120,10 +195,14 @@ public:
     */
    RTPS_DllAPI static void QueueLog(const std::string& message, const Log::Context&, Log::Kind);
 
+   //! Queues a preformatted record. Used by the logging macros.
+   RTPS_DllAPI static void QueueRecord(const Record&);
+
 private:
    struct Resources 
    {
-      DBQueue<Entry> mLogs;
+      BoundedLockFreeQueue<Record> mLogs;
+      std::atomic<uint32_t> mDroppedEntries;
       std::vector<std::unique_ptr<LogConsumer> > mConsumers;
       std::unique_ptr<LogConsumer> mDefaultConsumer;
 
@@ -132,8 +211,8 @@ private:
       // Condition variable segment.
       std::condition_variable mCv;
       std::mutex mCvMutex;
-      bool mLogging;
-      bool mWork;
+      std::atomic<bool> mLogging;
+      std::atomic<bool> mSleeping;
 
       // Context configuration.
       std::mutex mConfigMutex;
@@ -142,6 +221,8 @@ private:
       std::unique_ptr<std::regex> mCategoryFilter;
       std::unique_ptr<std::regex> mFilenameFilter;
       std::unique_ptr<std::regex> mErrorStringFilter;
+      // Bumped every time the category or filename filters change, invalidating every CallSite.
+      std::atomic<uint32_t> mFilterGeneration;
 
       std::atomic<Log::Kind> mVerbosity;
 
@@ -151,12 +232,27 @@ private:
 
    static struct Resources mResources;
 
+#if HAVE_CXX_CONSTEXPR
+   static constexpr bool CategoryMatches(const char* list, const char* category)
+   {
+      return *category == '\0' ? (*list == '\0' || *list == ',') :
+         (*list == *category ? CategoryMatches(list + 1, category + 1) : false);
+   }
+
+   static constexpr const char* NextCategory(const char* list)
+   {
+      return *list == '\0' ? list : (*list == ',' ? list + 1 : NextCategory(list + 1));
+   }
+#endif
+
    // Applies transformations to the entries compliant with the options selected (such as
    // erasure of certain context information, or filtering by category. Returns false 
    // if the log entry is blacklisted.
    static bool Preprocess(Entry&);
    static void LaunchThread();
    static void Run();
+   static void Consume(Entry&);
+   static void ReportDroppedEntries();
 };
 
 /**
@@ -172,14 +268,28 @@ public:
    #define __func__ __FUNCTION__
 #endif
 
+#if defined(LOG_NO_CATEGORIES) && HAVE_CXX_CONSTEXPR
+   #define LOG_CATEGORY_COMPILED_(cat) \
+      (!std::integral_constant<bool, Log::IsCategoryListed(LOG_NO_CATEGORIES, #cat)>::value)
+#else
+   #define LOG_CATEGORY_COMPILED_(cat) true
+#endif
+
+#define LOG_QUEUE_(cat, msg, kind) { \
+      static Log::CallSite logCallSite_; \
+      const Log::Context logContext_{__FILE__, __LINE__, __func__, #cat}; \
+      if (Log::Accepts(logCallSite_, logContext_)) { \
+         Log::RecordStream logStream_; logStream_ << msg; \
+         Log::QueueRecord(logStream_.GetRecord(logContext_, kind)); } }
+
 #ifndef LOG_NO_ERROR
-   #define logError_(cat, msg) {std::stringstream ss; ss << msg; Log::QueueLog(ss.str(), Log::Context{__FILE__, __LINE__, __func__, #cat}, Log::Kind::Error); }
+   #define logError_(cat, msg) { if (LOG_CATEGORY_COMPILED_(cat)) LOG_QUEUE_(cat, msg, Log::Kind::Error) }
 #else
    #define logError_(cat, msg) 
 #endif
 
 #ifndef LOG_NO_WARNING
-   #define logWarning_(cat, msg) { if (Log::GetVerbosity() >= Log::Kind::Warning) { std::stringstream ss; ss << msg; Log::QueueLog(ss.str(), Log::Context{__FILE__, __LINE__, __func__, #cat}, Log::Kind::Warning); } } 
+   #define logWarning_(cat, msg) { if (LOG_CATEGORY_COMPILED_(cat) && Log::GetVerbosity() >= Log::Kind::Warning) LOG_QUEUE_(cat, msg, Log::Kind::Warning) } 
 #else 
    #define logWarning_(cat, msg) 
 #endif
@@ -191,7 +301,7 @@ public:
 #endif
 
 #if COMPOSITE_LOG_NO_INFO 
-   #define logInfo_(cat, msg) { if (Log::GetVerbosity() >= Log::Kind::Info) { std::stringstream ss; ss << msg; Log::QueueLog(ss.str(), Log::Context{__FILE__, __LINE__, __func__, #cat}, Log::Kind::Info); } }
+   #define logInfo_(cat, msg) { if (LOG_CATEGORY_COMPILED_(cat) && Log::GetVerbosity() >= Log::Kind::Info) LOG_QUEUE_(cat, msg, Log::Kind::Info) }
 #else
    #define logInfo_(cat, msg)
 #endif
@@ -22,6 +22,7 @@
 #include "Types.h"
 #include "WriteParams.h"
 #include "SerializedPayload.h"
+#include "SharedPayload.h"
 #include "Time_t.h"
 #include "InstanceHandle.h"
 #include <fastrtps/rtps/common/FragmentNumber.h>
@@ -78,6 +79,8 @@ namespace eprosima
 
                 WriteParams write_params;
                 bool is_untyped_;
+                //!Shared payload serializedPayload points to, if any (only used in READERS)
+                SharedPayload_t* shared_payload;
 
                 /*!
                  * @brief Default constructor.
@@ -87,8 +90,11 @@ namespace eprosima
                     kind(ALIVE),
                     isRead(false),
                     is_untyped_(true),
+                    shared_payload(nullptr),
                     dataFragments_(new std::vector<uint32_t>()),
-                    fragment_size_(0)
+                    fragment_size_(0),
+                    owned_data_(nullptr),
+                    owned_max_size_(0)
                 {
                 }
 
@@ -105,8 +111,11 @@ namespace eprosima
                     serializedPayload(payload_size),
                     isRead(false),
                     is_untyped_(is_untyped),
+                    shared_payload(nullptr),
                     dataFragments_(new std::vector<uint32_t>()),
-                    fragment_size_(0)
+                    fragment_size_(0),
+                    owned_data_(nullptr),
+                    owned_max_size_(0)
                 {
                 }
 
@@ -152,8 +161,44 @@ namespace eprosima
                     isRead = ch_ptr->isRead;
                 }
 
+                /*!
+                 * Copy a different change into this one, referencing its shared payload instead of copying the data.
+                 * The own payload buffer of this change is kept aside until release_shared_payload() is called.
+                 * @param[in] ch_ptr Pointer to the change, which must have a shared payload.
+                 */
+                void share(const CacheChange_t* ch_ptr)
+                {
+                    copy_not_memcpy(ch_ptr);
+                    release_shared_payload();
+
+                    shared_payload = ch_ptr->shared_payload;
+                    shared_payload->acquire();
+                    owned_data_ = serializedPayload.data;
+                    owned_max_size_ = serializedPayload.max_size;
+                    serializedPayload.data = shared_payload->data();
+                    serializedPayload.length = shared_payload->length();
+                    serializedPayload.max_size = shared_payload->length();
+                    serializedPayload.pos = 0;
+                }
+
+                //! Release the shared payload of this change, if any, and restore its own payload buffer.
+                void release_shared_payload()
+                {
+                    if(shared_payload != nullptr)
+                    {
+                        serializedPayload.data = owned_data_;
+                        serializedPayload.max_size = owned_max_size_;
+                        serializedPayload.length = 0;
+                        owned_data_ = nullptr;
+                        owned_max_size_ = 0;
+                        shared_payload->release();
+                        shared_payload = nullptr;
+                    }
+                }
+
                 ~CacheChange_t()
                 {
+                    release_shared_payload();
                     if (dataFragments_)
                         delete dataFragments_;
                 }
@@ -191,6 +236,11 @@ namespace eprosima
 
                 // Fragment size
                 uint16_t fragment_size_;
+
+                // Payload buffer of this change, kept aside while it references a shared payload
+                octet* owned_data_;
+
+                uint32_t owned_max_size_;
             };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS_PUBLIC
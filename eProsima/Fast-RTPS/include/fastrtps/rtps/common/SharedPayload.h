@@ -0,0 +1,115 @@
+// Copyright 2016 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file SharedPayload.h
+ */
+
+#ifndef SHAREDPAYLOAD_H_
+#define SHAREDPAYLOAD_H_
+#include "../../fastrtps_dll.h"
+#include "Types.h"
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace eprosima{
+    namespace fastrtps{
+        namespace rtps{
+
+            /*!
+             * @brief Reference counted copy of a received serialized payload.
+             * When several local readers accept the same sample, the MessageReceiver copies its payload once
+             * into a SharedPayload_t and every reader references it instead of copying it again.
+             * The payload is freed when the last reference is released. The data follows the header in the same
+             * allocation, the header is aligned so that the data is aligned for deserialization.
+             * @ingroup COMMON_MODULE
+             */
+            class alignas(8) SharedPayload_t
+            {
+                public:
+
+                    /*!
+                     * Create a shared payload holding a copy of the given data.
+                     * @param data Pointer to the data to copy.
+                     * @param length Length of the data.
+                     * @return The shared payload, with a reference owned by the caller, or nullptr on failure.
+                     */
+                    static SharedPayload_t* create(const octet* data, uint32_t length)
+                    {
+                        void* memory = malloc(sizeof(SharedPayload_t) + length);
+                        if(memory == nullptr)
+                        {
+                            return nullptr;
+                        }
+                        SharedPayload_t* payload = new (memory) SharedPayload_t(length);
+                        memcpy(payload->data(), data, length);
+                        return payload;
+                    }
+
+                    //! Add a reference to the payload.
+                    void acquire()
+                    {
+                        references_.fetch_add(1, std::memory_order_relaxed);
+                    }
+
+                    //! Release a reference to the payload, the last one frees it.
+                    void release()
+                    {
+                        if(references_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        {
+                            this->~SharedPayload_t();
+                            free(this);
+                        }
+                    }
+
+                    //! Pointer to the data.
+                    octet* data()
+                    {
+                        return reinterpret_cast<octet*>(this + 1);
+                    }
+
+                    //! Length of the data.
+                    uint32_t length() const
+                    {
+                        return length_;
+                    }
+
+                    //! Number of references, only meaningful when no other thread holds one.
+                    uint32_t references() const
+                    {
+                        return references_.load(std::memory_order_relaxed);
+                    }
+
+                private:
+
+                    explicit SharedPayload_t(uint32_t length) : references_(1), length_(length)
+                    {
+                    }
+
+                    ~SharedPayload_t() = default;
+
+                    SharedPayload_t(const SharedPayload_t&) = delete;
+                    SharedPayload_t& operator=(const SharedPayload_t&) = delete;
+
+                    std::atomic<uint32_t> references_;
+                    uint32_t length_;
+            };
+        }
+    }
+}
+
+#endif /* SHAREDPAYLOAD_H_ */
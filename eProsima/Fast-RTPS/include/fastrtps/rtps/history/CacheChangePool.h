@@ -58,7 +58,8 @@ class CacheChangePool {
          * @param chan Returned pointer to the reserved CacheChange.
          * @param calculateSizeFunc Function that returns the size of the data which will go into the CacheChange.
          * This function is executed depending on the memory management policy (DYNAMIC_RESERVE_MEMORY_MODE and
-         * PREALLOCATED_WITH_REALLOC_MEMORY_MODE)
+         * PREALLOCATED_WITH_REALLOC_MEMORY_MODE). It may return 0 if the size is not known beforehand, in which case
+         * the payload is reserved with the initial payload size and the caller is expected to grow it.
          * @return True whether the CacheChange could be allocated. In other case returns false.
          */
         bool reserve_Cache(CacheChange_t** chan, const std::function<uint32_t()>& calculateSizeFunc);
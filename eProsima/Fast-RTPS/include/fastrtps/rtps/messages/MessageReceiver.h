@@ -26,6 +26,8 @@
 #include <fastrtps/rtps/writer/StatelessWriter.h>
 #include <fastrtps/rtps/writer/StatefulWriter.h>
 
+#include <unordered_map>
+#include <vector>
 
 namespace eprosima {
 namespace fastrtps{
@@ -81,6 +83,10 @@ class MessageReceiver
     private:
         std::vector<RTPSWriter *> AssociatedWriters;
         std::vector<RTPSReader *> AssociatedReaders;
+        //!Associated readers indexed by their entity id, to dispatch the messages directed to a reader.
+        std::unordered_map<uint32_t, std::vector<RTPSReader *>> readers_by_entity_;
+        //!Readers accepting a message directed to an unknown reader, reused between messages.
+        std::vector<RTPSReader *> matched_readers_;
         std::mutex mtx;
         //!Protocol version of the message
         ProtocolVersion_t sourceVersion;
@@ -150,6 +156,14 @@ class MessageReceiver
         bool proc_Submsg_HeartbeatFrag(CDRMessage_t*msg, SubmessageHeader_t* smh, bool*last);
         bool proc_Submsg_SecureMessage(CDRMessage_t*msg, SubmessageHeader_t* smh,bool*last);
         bool proc_Submsg_SecureSubMessage(CDRMessage_t*msg, SubmessageHeader_t* smh,bool*last);
+        ///@}
+
+        /**
+         * Find the associated readers accepting a message. Must be called with mtx locked.
+         * @param readerId Entity id the message is directed to.
+         * @return The readers, valid until the next call or until the associated readers change.
+         */
+        const std::vector<RTPSReader*>& find_readers(const EntityId_t& readerId);
 
         RTPSParticipantImpl* participant_;
 };
@@ -49,6 +49,8 @@ namespace eprosima
              */
             class ReaderProxy
             {
+                friend class StatefulWriter;
+
                 public:
                     ~ReaderProxy();
 
@@ -188,6 +190,15 @@ namespace eprosima
                 uint32_t lastNackfragCount_;
 
                 SequenceNumber_t changesFromRLowMark_;
+
+                //! Position of this reader in the low mark heap of the writer.
+                size_t low_mark_heap_position_;
+
+                /*!
+                 * Moves the low mark and lets the writer update its lowest low mark.
+                 * Must be called with the writer mutex locked.
+                 */
+                void set_low_mark_nts(const SequenceNumber_t& seq_num);
             };
         }
     } /* namespace rtps */
@@ -24,6 +24,7 @@
 #include "RTPSWriter.h"
 #include "timedevent/PeriodicHeartbeat.h"
 #include <condition_variable>
+#include <map>
 #include <mutex>
 
 namespace eprosima
@@ -62,6 +63,10 @@ namespace eprosima
 
                 //! Vector containin all the associated ReaderProxies.
                 std::vector<ReaderProxy*> matched_readers;
+                //! Associated ReaderProxies indexed by the reader GUID.
+                std::map<GUID_t, ReaderProxy*> matched_readers_by_guid_;
+                //! Matched readers as a binary min-heap ordered by their low mark.
+                std::vector<ReaderProxy*> low_mark_heap_;
                 //!EntityId used to send the HB.(only for builtin types performance)
                 EntityId_t m_HBReaderEntityId;
                 // TODO Join this mutex when main mutex would not be recursive.
@@ -197,6 +202,18 @@ namespace eprosima
 
                 void check_acked_status();
 
+                //! Lowest low mark of the matched readers. Must be called with mp_mutex locked.
+                SequenceNumber_t min_readers_low_mark_nts() const;
+
+                void low_mark_heap_add_nts(ReaderProxy* remote_reader);
+
+                void low_mark_heap_remove_nts(ReaderProxy* remote_reader);
+
+                //! Called by a ReaderProxy when its low mark moves. Must be called with mp_mutex locked.
+                void low_mark_changed_nts(ReaderProxy* remote_reader);
+
+                void low_mark_heap_sift_nts(size_t position);
+
                 bool disableHeartbeatPiggyback_;
 
                 const uint32_t sendBufferSize_;
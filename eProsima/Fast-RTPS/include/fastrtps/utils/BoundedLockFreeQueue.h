@@ -0,0 +1,132 @@
+// Copyright 2016 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef BOUNDED_LOCK_FREE_QUEUE_H
+#define BOUNDED_LOCK_FREE_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace eprosima {
+namespace fastrtps{
+
+/**
+ * Bounded, lock-free queue for MPSC (multi-producer, single-consumer) comms.
+ * All storage is allocated on construction, so pushing and popping never allocate.
+ * Each slot carries a sequence number that tells producers and the consumer whether
+ * it is free or holds a published item, so no operation ever takes a lock.
+ * Capacity is rounded up to the next power of two.
+ */
+template<class T>
+class BoundedLockFreeQueue {
+
+public:
+   explicit BoundedLockFreeQueue(size_t capacity):
+      mMask(RoundUpPowerOfTwo(capacity) - 1),
+      mCells(new Cell[mMask + 1]),
+      mEnqueuePosition(0),
+      mDequeuePosition(0)
+   {
+      for (size_t i = 0; i <= mMask; ++i)
+         mCells[i].sequence.store(i, std::memory_order_relaxed);
+   }
+
+   BoundedLockFreeQueue(const BoundedLockFreeQueue&) = delete;
+   BoundedLockFreeQueue& operator=(const BoundedLockFreeQueue&) = delete;
+
+   //! Copies an item into the queue. Returns false, dropping the item, if the queue is full.
+   bool Push(const T& item)
+   {
+      Cell* cell;
+      size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+      for (;;)
+      {
+         cell = &mCells[position & mMask];
+         size_t sequence = cell->sequence.load(std::memory_order_acquire);
+         intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+         if (difference == 0)
+         {
+            if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+               break;
+         }
+         else if (difference < 0)
+            return false;
+         else
+            position = mEnqueuePosition.load(std::memory_order_relaxed);
+      }
+
+      cell->data = item;
+      cell->sequence.store(position + 1, std::memory_order_release);
+      return true;
+   }
+
+   //! Moves the oldest item out of the queue. Returns false if there is none.
+   //! Only one thread may pop at a time.
+   bool Pop(T& item)
+   {
+      size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+      Cell* cell = &mCells[position & mMask];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      if (sequence != position + 1)
+         return false;
+
+      item = cell->data;
+      cell->sequence.store(position + mMask + 1, std::memory_order_release);
+      mDequeuePosition.store(position + 1, std::memory_order_relaxed);
+      return true;
+   }
+
+   //! Reports whether there is an item ready to be popped. Consumer side only.
+   bool Empty() const
+   {
+      size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+      return mCells[position & mMask].sequence.load(std::memory_order_acquire) != position + 1;
+   }
+
+   //! Maximum number of items the queue can hold.
+   size_t Capacity() const
+   {
+      return mMask + 1;
+   }
+
+private:
+   struct Cell
+   {
+      std::atomic<size_t> sequence;
+      T data;
+   };
+
+   static size_t RoundUpPowerOfTwo(size_t value)
+   {
+      size_t power = 1;
+      while (power < value)
+         power <<= 1;
+      return power;
+   }
+
+   const size_t mMask;
+   std::unique_ptr<Cell[]> mCells;
+
+   // Producers and consumer touch different positions; keep them on separate cache lines.
+   alignas(64) std::atomic<size_t> mEnqueuePosition;
+   alignas(64) std::atomic<size_t> mDequeuePosition;
+};
+
+
+} // namespace fastrtps
+} // namespace eprosima
+
+#endif
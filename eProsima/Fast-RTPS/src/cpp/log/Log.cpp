@@ -5,19 +5,25 @@
 #include <fastrtps/log/Log.h>
 #include <fastrtps/log/StdoutConsumer.h>
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 namespace eprosima {
 namespace fastrtps {
 
 struct Log::Resources Log::mResources;
+const size_t Log::MaxMessageLength;
+const size_t Log::QueueCapacity;
 
 Log::Resources::Resources():
+   mLogs(Log::QueueCapacity),
+   mDroppedEntries(0),
    mDefaultConsumer(new StdoutConsumer),
    mLogging(false),
-   mWork(false),
+   mSleeping(false),
    mFilenames(false),
    mFunctions(true),
+   mFilterGeneration(1),
    mVerbosity(Log::Error)
 {
 }
@@ -39,6 +45,7 @@ void Log::Reset()
    mResources.mCategoryFilter.reset();
    mResources.mFilenameFilter.reset();
    mResources.mErrorStringFilter.reset();
+   mResources.mFilterGeneration++;
    mResources.mFilenames = false;
    mResources.mFunctions = true;
    mResources.mVerbosity = Log::Error;
@@ -47,36 +54,57 @@ void Log::Reset()
 
 void Log::Run() 
 {
-   std::unique_lock<std::mutex> guard(mResources.mCvMutex);
-   while (mResources.mLogging) 
+   Record record;
+   Entry entry;
+   for (;;)
    {
-      while (mResources.mWork) 
+      while (mResources.mLogs.Pop(record))
       {
-         mResources.mWork = false;
-         guard.unlock();
+         entry.message.assign(record.message, record.length);
+         entry.context = record.context;
+         entry.kind = record.kind;
+         Consume(entry);
+      }
+      ReportDroppedEntries();
 
-         mResources.mLogs.Swap();
-         while (!mResources.mLogs.Empty())
-         {
-            std::unique_lock<std::mutex> configGuard(mResources.mConfigMutex);
-            if (Preprocess(mResources.mLogs.Front()))
-            {
-               for (auto& consumer: mResources.mConsumers)
-                  consumer->Consume(mResources.mLogs.Front());
+      std::unique_lock<std::mutex> guard(mResources.mCvMutex);
+      if (!mResources.mLogging)
+         break;
 
-               mResources.mDefaultConsumer->Consume(mResources.mLogs.Front());
-            }
+      // Producers only notify when they see us sleeping. The fences order our flag against their
+      // push, so either they see the flag or we see their record.
+      mResources.mSleeping = true;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (mResources.mLogs.Empty())
+         mResources.mCv.wait(guard);
+      mResources.mSleeping = false;
+   }
+}
 
-            mResources.mLogs.Pop();
-         }
+void Log::Consume(Log::Entry& entry)
+{
+   std::unique_lock<std::mutex> configGuard(mResources.mConfigMutex);
+   if (Preprocess(entry))
+   {
+      for (auto& consumer: mResources.mConsumers)
+         consumer->Consume(entry);
 
-         guard.lock();
-      }
-      if (mResources.mLogging)
-         mResources.mCv.wait(guard);
+      mResources.mDefaultConsumer->Consume(entry);
    }
 }
 
+void Log::ReportDroppedEntries()
+{
+   uint32_t dropped = mResources.mDroppedEntries.exchange(0);
+   if (dropped == 0)
+      return;
+
+   std::stringstream ss;
+   ss << dropped << " log entries dropped, the logging queue was full";
+   Entry entry{ss.str(), Log::Context{nullptr, 0, nullptr, "LOG"}, Log::Kind::Warning};
+   Consume(entry);
+}
+
 void Log::ReportFilenames(bool report)
 {
    std::unique_lock<std::mutex> configGuard(mResources.mConfigMutex);
@@ -91,10 +119,7 @@ void Log::ReportFunctions(bool report)
 
 bool Log::Preprocess(Log::Entry& entry)
 {
-   if (mResources.mCategoryFilter && !regex_search(entry.context.category, *mResources.mCategoryFilter))
-      return false;
-   if (mResources.mFilenameFilter && !regex_search(entry.context.filename, *mResources.mFilenameFilter))
-      return false;
+   // Category and filename filters were already applied on the call site, see Log::Accepts.
    if (mResources.mErrorStringFilter && !regex_search(entry.message, *mResources.mErrorStringFilter))
       return false;
    if (!mResources.mFilenames)
@@ -105,12 +130,30 @@ bool Log::Preprocess(Log::Entry& entry)
    return true;
 }
 
+bool Log::Accepts(Log::CallSite& site, const Log::Context& context)
+{
+   uint32_t generation = mResources.mFilterGeneration.load(std::memory_order_acquire);
+   uint32_t state = site.mState.load(std::memory_order_relaxed);
+   if ((state >> 1) == generation)
+      return (state & 1u) != 0;
+
+   std::unique_lock<std::mutex> configGuard(mResources.mConfigMutex);
+   generation = mResources.mFilterGeneration.load(std::memory_order_relaxed);
+   bool accepted = true;
+   if (mResources.mCategoryFilter && !regex_search(context.category, *mResources.mCategoryFilter))
+      accepted = false;
+   else if (mResources.mFilenameFilter && !regex_search(context.filename, *mResources.mFilenameFilter))
+      accepted = false;
+
+   site.mState.store((generation << 1) | (accepted ? 1u : 0u), std::memory_order_relaxed);
+   return accepted;
+}
+
 void Log::KillThread() 
 {
    {
       std::unique_lock<std::mutex> guard(mResources.mCvMutex);
       mResources.mLogging = false;
-      mResources.mWork = false;
    }
    if (mResources.mLoggingThread) 
    {
@@ -127,6 +170,14 @@ void Log::KillThread()
 
 void Log::QueueLog(const std::string& message, const Log::Context& context, Log::Kind kind)
 {
+   RecordStream stream;
+   stream << message;
+   QueueRecord(stream.GetRecord(context, kind));
+}
+
+void Log::QueueRecord(const Log::Record& record)
+{
+   if (!mResources.mLogging.load(std::memory_order_acquire))
    {
       std::unique_lock<std::mutex> guard(mResources.mCvMutex);
       if (!mResources.mLogging && !mResources.mLoggingThread) 
@@ -136,12 +187,47 @@ void Log::QueueLog(const std::string& message, const Log::Context& context, Log:
       }
    }
 
-   mResources.mLogs.Push(Log::Entry{message, context, kind});
+   if (!mResources.mLogs.Push(record))
+   {
+      mResources.mDroppedEntries.fetch_add(1, std::memory_order_relaxed);
+      return;
+   }
+
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   if (mResources.mSleeping.load(std::memory_order_relaxed))
    {
       std::unique_lock<std::mutex> guard(mResources.mCvMutex);
-      mResources.mWork = true;
+      mResources.mCv.notify_all();
+   }
+}
+
+Log::RecordStream::RecordStream():
+   std::ostream(this),
+   mTruncated(false)
+{
+   // Leave room for the terminating null character.
+   setp(mRecord.message, mRecord.message + MaxMessageLength - 1);
+}
+
+std::streambuf::int_type Log::RecordStream::overflow(std::streambuf::int_type)
+{
+   mTruncated = true;
+   return std::streambuf::traits_type::eof();
+}
+
+const Log::Record& Log::RecordStream::GetRecord(const Log::Context& context, Log::Kind kind)
+{
+   mRecord.length = static_cast<size_t>(pptr() - pbase());
+   if (mTruncated)
+   {
+      // Make it evident the message did not fit.
+      for (size_t i = mRecord.length - 3; i < mRecord.length; ++i)
+         mRecord.message[i] = '.';
    }
-   mResources.mCv.notify_all();
+   mRecord.message[mRecord.length] = '\0';
+   mRecord.context = context;
+   mRecord.kind = kind;
+   return mRecord;
 }
 
 Log::Kind Log::GetVerbosity()
@@ -159,12 +245,14 @@ void Log::SetCategoryFilter(const std::regex& filter)
 {
    std::unique_lock<std::mutex> configGuard(mResources.mConfigMutex);
    mResources.mCategoryFilter.reset(new std::regex(filter));
+   mResources.mFilterGeneration++;
 }
 
 void Log::SetFilenameFilter(const std::regex& filter)
 {
    std::unique_lock<std::mutex> configGuard(mResources.mConfigMutex);
    mResources.mFilenameFilter.reset(new std::regex(filter));
+   mResources.mFilterGeneration++;
 }
 
 void Log::SetErrorStringFilter(const std::regex& filter)
@@ -84,8 +84,14 @@ bool CacheChangePool::reserve_Cache(CacheChange_t** chan, const std::function<ui
     uint32_t dataSize = 0;
 
     if(memoryMode != PREALLOCATED_MEMORY_MODE)
+    {
         dataSize = calculateSizeFunc();
 
+        // Unknown size, the payload will be grown while serializing.
+        if(dataSize == 0)
+            dataSize = m_payload_size;
+    }
+
     if(reserve_Cache(chan, dataSize))
     {
         (*chan)->setFragmentSize(0);
@@ -150,6 +156,9 @@ bool CacheChangePool::reserve_Cache(CacheChange_t** chan, uint32_t dataSize)
 
 void CacheChangePool::release_Cache(CacheChange_t* ch)
 {
+    // Gives the change its own payload buffer back
+    ch->release_shared_payload();
+
     std::lock_guard<std::mutex> guard(*this->mp_mutex);
 
     switch(memoryMode)
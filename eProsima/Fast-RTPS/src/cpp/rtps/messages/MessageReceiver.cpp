@@ -35,6 +35,7 @@
 
 #include <mutex>
 
+#include <algorithm>
 #include <limits>
 #include <cassert>
 
@@ -49,6 +50,13 @@ namespace eprosima {
 namespace fastrtps{
 namespace rtps {
 
+static uint32_t entity_key(const EntityId_t& entityId)
+{
+    uint32_t key;
+    memcpy(&key, entityId.value, sizeof(key));
+    return key;
+}
+
 
 MessageReceiver::MessageReceiver(RTPSParticipantImpl* participant) : participant_(participant) {}
 
@@ -109,7 +117,11 @@ void MessageReceiver::associateEndpoint(Endpoint *to_add){
                 break;
             }
         }
-        if(!found) AssociatedReaders.push_back((RTPSReader*)to_add);
+        if(!found)
+        {
+            AssociatedReaders.push_back((RTPSReader*)to_add);
+            readers_by_entity_[entity_key(to_add->getGuid().entityId)].push_back((RTPSReader*)to_add);
+        }
     }
     return;
 }
@@ -132,10 +144,45 @@ void MessageReceiver::removeEndpoint(Endpoint *to_remove){
                 break;
             }
         }
+        auto entity = readers_by_entity_.find(entity_key(var->getGuid().entityId));
+        if(entity != readers_by_entity_.end())
+        {
+            std::vector<RTPSReader*>& readers = entity->second;
+            readers.erase(std::remove(readers.begin(), readers.end(), var), readers.end());
+            if(readers.empty())
+            {
+                readers_by_entity_.erase(entity);
+            }
+        }
     }
     return;
 }
 
+const std::vector<RTPSReader*>& MessageReceiver::find_readers(const EntityId_t& readerId)
+{
+    if(readerId != c_EntityId_Unknown)
+    {
+        // Only the readers with this entity id accept the message
+        auto entity = readers_by_entity_.find(entity_key(readerId));
+        if(entity != readers_by_entity_.end())
+        {
+            return entity->second;
+        }
+        matched_readers_.clear();
+        return matched_readers_;
+    }
+
+    matched_readers_.clear();
+    for(RTPSReader* reader : AssociatedReaders)
+    {
+        if(reader->acceptMsgDirectedTo(const_cast<EntityId_t&>(readerId)))
+        {
+            matched_readers_.push_back(reader);
+        }
+    }
+    return matched_readers_;
+}
+
 
 void MessageReceiver::reset(){
     destVersion = c_ProtocolVersion;
@@ -471,23 +518,14 @@ bool MessageReceiver::proc_Submsg_Data(CDRMessage_t* msg,SubmessageHeader_t* smh
 
     //WE KNOW THE READER THAT THE MESSAGE IS DIRECTED TO SO WE LOOK FOR IT:
 
-    RTPSReader* firstReader = nullptr;
     if(AssociatedReaders.empty())
     {
         logWarning(RTPS_MSG_IN,IDSTRING"Data received when NO readers are listening");
         return false;
     }
 
-    for(std::vector<RTPSReader*>::iterator it=AssociatedReaders.begin();
-            it != AssociatedReaders.end(); ++it)
-    {
-        if((*it)->acceptMsgDirectedTo(readerID)) //add
-        {
-            firstReader = *it;
-            break;
-        }
-    }
-    if(firstReader == nullptr) //Reader not found
+    const std::vector<RTPSReader*>& readers = find_readers(readerID);
+    if(readers.empty()) //Reader not found
     {
         logWarning(RTPS_MSG_IN, IDSTRING"No Reader accepts this message (directed to: " <<readerID << ")");
         return false;
@@ -595,20 +633,27 @@ bool MessageReceiver::proc_Submsg_Data(CDRMessage_t* msg,SubmessageHeader_t* smh
     }
 
 
-    //FIXME: DO SOMETHING WITH PARAMETERLIST CREATED.
-    logInfo(RTPS_MSG_IN,IDSTRING"from Writer " << ch.writerGUID << "; possible RTPSReaders: "<<AssociatedReaders.size());
-    //Look for the correct reader to add the change
-    for(std::vector<RTPSReader*>::iterator it = AssociatedReaders.begin();
-            it != AssociatedReaders.end(); ++it)
+    // When several readers accept the sample, the payload is copied once and shared by all of them.
+    // The reference of the receiver is released below, the readers release theirs with their changes.
+    if(readers.size() > 1 && ch.serializedPayload.length > 0)
     {
-        if((*it)->acceptMsgDirectedTo(readerID))
+        ch.shared_payload = SharedPayload_t::create(ch.serializedPayload.data, ch.serializedPayload.length);
+        if(ch.shared_payload != nullptr)
         {
-            (*it)->processDataMsg(&ch);
+            ch.serializedPayload.data = ch.shared_payload->data();
         }
     }
 
+    //FIXME: DO SOMETHING WITH PARAMETERLIST CREATED.
+    logInfo(RTPS_MSG_IN,IDSTRING"from Writer " << ch.writerGUID << "; possible RTPSReaders: "<<readers.size());
+    for(RTPSReader* reader : readers)
+    {
+        reader->processDataMsg(&ch);
+    }
+
     //TODO(Ricardo) If a exception is thrown (ex, by fastcdr), this line is not executed -> segmentation fault
     ch.serializedPayload.data = nullptr;
+    ch.release_shared_payload();
 
     logInfo(RTPS_MSG_IN,IDSTRING"Sub Message DATA processed");
     return true;
@@ -654,18 +699,8 @@ bool MessageReceiver::proc_Submsg_DataFrag(CDRMessage_t* msg, SubmessageHeader_t
         return false;
     }
 
-    RTPSReader* firstReader = nullptr;
-    for (std::vector<RTPSReader*>::iterator it = AssociatedReaders.begin();
-            it != AssociatedReaders.end(); ++it)
-    {
-        if ((*it)->acceptMsgDirectedTo(readerID)) //add
-        {
-            firstReader = *it;
-            break;
-        }
-    }
-
-    if (firstReader == nullptr) //Reader not found
+    const std::vector<RTPSReader*>& readers = find_readers(readerID);
+    if (readers.empty()) //Reader not found
     {
         logWarning(RTPS_MSG_IN, IDSTRING"No Reader accepts this message (directed to: " << readerID << ")");
         return false;
@@ -796,15 +831,10 @@ bool MessageReceiver::proc_Submsg_DataFrag(CDRMessage_t* msg, SubmessageHeader_t
         ch.sourceTimestamp = this->timestamp;
 
     //FIXME: DO SOMETHING WITH PARAMETERLIST CREATED.
-    logInfo(RTPS_MSG_IN, IDSTRING"from Writer " << ch.writerGUID << "; possible RTPSReaders: " << AssociatedReaders.size());
-    //Look for the correct reader to add the change
-    for (std::vector<RTPSReader*>::iterator it = AssociatedReaders.begin();
-            it != AssociatedReaders.end(); ++it)
+    logInfo(RTPS_MSG_IN, IDSTRING"from Writer " << ch.writerGUID << "; possible RTPSReaders: " << readers.size());
+    for (RTPSReader* reader : readers)
     {
-        if ((*it)->acceptMsgDirectedTo(readerID))
-        {
-            (*it)->processDataFragMsg(&ch, sampleSize, fragmentStartingNum);
-        }
+        reader->processDataFragMsg(&ch, sampleSize, fragmentStartingNum);
     }
 
     ch.serializedPayload.data = nullptr;
@@ -845,13 +875,9 @@ bool MessageReceiver::proc_Submsg_Heartbeat(CDRMessage_t* msg,SubmessageHeader_t
 
     std::lock_guard<std::mutex> guard(mtx);
     //Look for the correct reader and writers:
-    for (std::vector<RTPSReader*>::iterator it = AssociatedReaders.begin();
-            it != AssociatedReaders.end(); ++it)
+    for (RTPSReader* reader : find_readers(readerGUID.entityId))
     {
-        if((*it)->acceptMsgDirectedTo(readerGUID.entityId))
-        {
-            (*it)->processHeartbeatMsg(writerGUID, HBCount, firstSN, lastSN, finalFlag, livelinessFlag);
-        }
+        reader->processHeartbeatMsg(writerGUID, HBCount, firstSN, lastSN, finalFlag, livelinessFlag);
     }
     //Is the final message?
     if(smh->submessageLength == 0)
@@ -937,13 +963,9 @@ bool MessageReceiver::proc_Submsg_Gap(CDRMessage_t* msg,SubmessageHeader_t* smh,
         return false;
 
     std::lock_guard<std::mutex> guard(mtx);
-    for (std::vector<RTPSReader*>::iterator it = AssociatedReaders.begin();
-            it != AssociatedReaders.end(); ++it)
+    for (RTPSReader* reader : find_readers(readerGUID.entityId))
     {
-        if((*it)->acceptMsgDirectedTo(readerGUID.entityId))
-        {
-            (*it)->processGapMsg(writerGUID, gapStart, gapList);
-        }
+        reader->processGapMsg(writerGUID, gapStart, gapList);
     }
 
     return true;
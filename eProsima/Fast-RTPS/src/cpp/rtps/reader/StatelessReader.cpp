@@ -163,10 +163,20 @@ bool StatelessReader::processDataMsg(CacheChange_t *change)
 
         CacheChange_t* change_to_add;
 
-        if(reserveCache(&change_to_add, change->serializedPayload.length)) //Reserve a new cache from the corresponding cache pool
+        // A payload shared with other local readers is referenced, the change needs no buffer of its own
+        bool share_payload = change->shared_payload != nullptr;
+#if HAVE_SECURITY
+        share_payload = share_payload && !getAttributes()->security_attributes().is_payload_protected;
+#endif
+
+        if(reserveCache(&change_to_add, share_payload ? 0 : change->serializedPayload.length)) //Reserve a new cache from the corresponding cache pool
         {
+            if(share_payload)
+            {
+                change_to_add->share(change);
+            }
 #if HAVE_SECURITY
-            if(getAttributes()->security_attributes().is_payload_protected)
+            else if(getAttributes()->security_attributes().is_payload_protected)
             {
                 change_to_add->copy_not_memcpy(change);
                 if(!getRTPSParticipant()->security_manager().decode_serialized_payload(change->serializedPayload,
@@ -177,9 +187,9 @@ bool StatelessReader::processDataMsg(CacheChange_t *change)
                     return false;
                 }
             }
+#endif
             else
             {
-#endif
                 if (!change_to_add->copy(change))
                 {
                     logWarning(RTPS_MSG_IN,IDSTRING"Problem copying CacheChange, received data is: " << change->serializedPayload.length
@@ -187,9 +197,7 @@ bool StatelessReader::processDataMsg(CacheChange_t *change)
                     releaseCache(change_to_add);
                     return false;
                 }
-#if HAVE_SECURITY
             }
-#endif
         }
         else
         {
@@ -62,14 +62,18 @@ namespace eprosima
 using namespace eprosima::fastrtps::rtps;
 
 TimedEventImpl::TimedEventImpl(TimedEvent* event, asio::io_service &service, const std::thread& event_thread, std::chrono::microseconds interval, TimedEvent::AUTODESTRUCTION_MODE autodestruction) :
-timer_(service, interval), m_interval_microsec(interval), mp_event(event),
+service_(service), wheel_(asio::use_service<TimerWheel>(service)),
+deadline_(std::chrono::steady_clock::now() + interval), m_interval_microsec(interval), mp_event(event),
 autodestruction_(autodestruction), state_(std::make_shared<TimerState>(autodestruction)), event_thread_id_(event_thread.get_id())
 {
 	//TIME_INFINITE(m_timeInfinite);
+    node_.event = this;
 }
 
 TimedEventImpl::~TimedEventImpl()
 {
+    // The event could still be scheduled when it was restarted while running.
+    wheel_.cancel(node_);
 }
 
 void TimedEventImpl::destroy()
@@ -83,7 +87,7 @@ void TimedEventImpl::destroy()
 
     // If the event is waiting, cancel it.
     if(code == TimerState::WAITING)
-        timer_.cancel();
+        wheel_.cancel(node_);
 
     // If the event is waiting or running, wait it finishes.
     // Don't wait if it is the event thread.
@@ -108,10 +112,16 @@ void TimedEventImpl::cancel_timer()
 
     if(ret)
     {
+        std::shared_ptr<TimerState> cancelled_state = state_;
         // Unattach the event state from future event execution.
         state_.reset(new TimerState(autodestruction_));
-        // Cancel the event.
-        timer_.cancel();
+        // Cancel the event. If its expiration is already being notified, it will find the state cancelled.
+        // Otherwise an event destroying itself always is notified of the cancellation.
+        if(wheel_.cancel(node_) && autodestruction_ == TimedEvent::ALLWAYS)
+        {
+            asio::error_code aborted = asio::error::operation_aborted;
+            service_.post(std::bind(&TimedEventImpl::event, this, std::error_code(aborted), cancelled_state));
+        }
         // Alert to user.
         mp_event->event(TimedEvent::EVENT_ABORT, nullptr);
     }
@@ -144,8 +154,9 @@ void TimedEventImpl::restart_timer()
 
         if(restartTimer)
         {
-            timer_.expires_from_now(m_interval_microsec);
-            timer_.async_wait(std::bind(&TimedEventImpl::event,this,std::placeholders::_1, state_));
+            deadline_ = std::chrono::steady_clock::now() + m_interval_microsec;
+            node_.state = state_;
+            wheel_.schedule(node_, deadline_);
         }
     }
 }
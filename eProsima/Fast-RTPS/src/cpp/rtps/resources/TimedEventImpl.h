@@ -36,6 +36,8 @@
 
 #include <fastrtps/utils/Semaphore.h>
 
+#include "TimerWheel.h"
+
 #include <thread>
 #include <functional>
 #include <mutex>
@@ -79,8 +81,14 @@ namespace eprosima
 
 
                 protected:
-                    //!Pointer to the timer.
-                    asio::steady_timer timer_;
+                    //!IO service running the event.
+                    asio::io_service& service_;
+                    //!Timer wheel of the IO service.
+                    TimerWheel& wheel_;
+                    //!Link of the event in the timer wheel.
+                    TimerWheelNode node_;
+                    //!Time point the event expires at.
+                    std::chrono::steady_clock::time_point deadline_;
                     //!Interval to be used in the timed Event.
                     std::chrono::microseconds m_interval_microsec;
                     //!TimedEvent pointer
@@ -129,7 +137,8 @@ namespace eprosima
                     double getRemainingTimeMilliSec()
                     {
                         std::unique_lock<std::mutex> lock(mutex_);
-                        return static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(timer_.expires_from_now()).count());
+                        return static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    deadline_ - std::chrono::steady_clock::now()).count());
                     }
 
                 private:
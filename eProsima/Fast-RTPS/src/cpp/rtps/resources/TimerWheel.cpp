@@ -0,0 +1,343 @@
+// Copyright 2016 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TimerWheel.cpp
+ *
+ */
+
+#include "TimerWheel.h"
+#include "TimedEventImpl.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+
+using namespace eprosima::fastrtps::rtps;
+
+//!Duration of a tick of the wheel.
+static const std::chrono::microseconds TICK(1000);
+
+asio::io_service::id TimerWheel::id;
+
+//!Index of the lowest bit set of a non zero word.
+static uint32_t lowest_bit(uint64_t word)
+{
+    uint32_t bit = 0;
+    while((word & 0xFF) == 0)
+    {
+        word >>= 8;
+        bit += 8;
+    }
+    while((word & 1) == 0)
+    {
+        word >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+TimerWheel::TimerWheel(asio::io_service& service) : asio::io_service::service(service),
+    timer_(new asio::steady_timer(service)), origin_(std::chrono::steady_clock::now()),
+    next_tick_(1), armed_tick_(0), slots_(LEVELS * SLOTS), size_(0), wake_ups_(0), shutdown_(false)
+{
+    for(TimerWheelNode& slot : slots_)
+    {
+        slot.prev = &slot;
+        slot.next = &slot;
+    }
+
+    memset(occupied_, 0, sizeof(occupied_));
+}
+
+TimerWheel::~TimerWheel()
+{
+}
+
+void TimerWheel::shutdown_service()
+{
+    shutdown();
+}
+
+void TimerWheel::shutdown()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+    timer_.reset();
+}
+
+uint64_t TimerWheel::wake_ups() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wake_ups_;
+}
+
+uint64_t TimerWheel::to_tick(std::chrono::steady_clock::time_point time_point, bool round_up) const
+{
+    if(time_point <= origin_)
+    {
+        return 0;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time_point - origin_);
+    uint64_t tick = static_cast<uint64_t>(elapsed.count() / TICK.count());
+
+    if(round_up && elapsed.count() % TICK.count() != 0)
+    {
+        ++tick;
+    }
+
+    return tick;
+}
+
+void TimerWheel::schedule(TimerWheelNode& node, std::chrono::steady_clock::time_point deadline)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    assert(node.prev == nullptr);
+
+    if(size_ == 0)
+    {
+        // Nothing to notify until now, skip the idle ticks.
+        next_tick_ = std::max(next_tick_, to_tick(std::chrono::steady_clock::now(), false));
+    }
+
+    node.expiry = to_tick(deadline, true);
+    add_nts(node);
+    ++size_;
+
+    arm_timer_nts();
+}
+
+bool TimerWheel::cancel(TimerWheelNode& node)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if(node.prev == nullptr)
+    {
+        return false;
+    }
+
+    unlink_nts(node);
+    node.state.reset();
+    --size_;
+
+    // The timer is left armed, an early wake-up is cheaper than re-arming it.
+    return true;
+}
+
+void TimerWheel::add_nts(TimerWheelNode& node)
+{
+    // Expired events are notified on the next tick.
+    uint64_t expiry = std::max(node.expiry, next_tick_);
+    uint64_t delta = expiry - next_tick_;
+
+    // Events beyond the last level wait in its farthest slot and are placed again when it is cascaded.
+    const uint64_t max_delta = (static_cast<uint64_t>(1) << (SLOT_BITS * LEVELS)) - 1;
+    if(delta > max_delta)
+    {
+        delta = max_delta;
+        expiry = next_tick_ + max_delta;
+    }
+
+    uint32_t level = 0;
+    while(level < LEVELS - 1 && delta >= (static_cast<uint64_t>(1) << (SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+
+    uint32_t index = static_cast<uint32_t>(expiry >> (SLOT_BITS * level)) & (SLOTS - 1);
+    TimerWheelNode& slot = slots_[level * SLOTS + index];
+
+    node.prev = slot.prev;
+    node.next = &slot;
+    slot.prev->next = &node;
+    slot.prev = &node;
+
+    occupied_[level][index / 64] |= static_cast<uint64_t>(1) << (index % 64);
+}
+
+void TimerWheel::unlink_nts(TimerWheelNode& node)
+{
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+
+    // A slot left empty only links to its sentinel.
+    if(node.next == node.prev && node.next >= &slots_.front() && node.next <= &slots_.back())
+    {
+        size_t slot = static_cast<size_t>(node.next - &slots_.front());
+        occupied_[slot / SLOTS][(slot % SLOTS) / 64] &= ~(static_cast<uint64_t>(1) << (slot % 64));
+    }
+
+    node.prev = nullptr;
+    node.next = nullptr;
+}
+
+uint32_t TimerWheel::cascade_nts(uint32_t level)
+{
+    uint32_t index = static_cast<uint32_t>(next_tick_ >> (SLOT_BITS * level)) & (SLOTS - 1);
+    TimerWheelNode& slot = slots_[level * SLOTS + index];
+
+    // Detach the list first, events can be placed again in this same slot.
+    TimerWheelNode* node = slot.next;
+    slot.prev->next = nullptr;
+    slot.prev = &slot;
+    slot.next = &slot;
+    occupied_[level][index / 64] &= ~(static_cast<uint64_t>(1) << (index % 64));
+
+    while(node != nullptr && node != &slot)
+    {
+        TimerWheelNode* next = node->next;
+        add_nts(*node);
+        node = next;
+    }
+
+    return index;
+}
+
+uint32_t TimerWheel::first_occupied_nts(uint32_t level, uint32_t from) const
+{
+    for(uint32_t distance = 0; distance < SLOTS;)
+    {
+        uint32_t index = (from + distance) & (SLOTS - 1);
+        uint64_t word = occupied_[level][index / 64] >> (index % 64);
+
+        if(word != 0)
+        {
+            uint32_t found = distance + lowest_bit(word);
+            return found < SLOTS ? found : SLOTS;
+        }
+
+        distance += 64 - (index % 64);
+    }
+
+    return SLOTS;
+}
+
+uint64_t TimerWheel::next_wake_up_nts() const
+{
+    if(size_ == 0)
+    {
+        return 0;
+    }
+
+    uint64_t wake_up = UINT64_MAX;
+
+    uint32_t distance = first_occupied_nts(0, static_cast<uint32_t>(next_tick_) & (SLOTS - 1));
+    if(distance < SLOTS)
+    {
+        wake_up = next_tick_ + distance;
+    }
+
+    // Higher levels are cascaded at the start of the window of their slot.
+    for(uint32_t level = 1; level < LEVELS; ++level)
+    {
+        const uint32_t shift = SLOT_BITS * level;
+        const uint64_t window = next_tick_ >> shift;
+        const bool window_started = (next_tick_ & ((static_cast<uint64_t>(1) << shift) - 1)) != 0;
+        const uint32_t current = static_cast<uint32_t>(window) & (SLOTS - 1);
+
+        distance = first_occupied_nts(level, window_started ? current + 1 : current);
+        if(distance < SLOTS)
+        {
+            uint64_t cascade = (window + distance + (window_started ? 1 : 0)) << shift;
+            wake_up = std::min(wake_up, cascade);
+        }
+    }
+
+    return wake_up;
+}
+
+void TimerWheel::arm_timer_nts()
+{
+    if(shutdown_)
+    {
+        return;
+    }
+
+    uint64_t wake_up = next_wake_up_nts();
+
+    if(wake_up != 0 && (armed_tick_ == 0 || wake_up < armed_tick_))
+    {
+        armed_tick_ = wake_up;
+        timer_->expires_at(origin_ + TICK * wake_up);
+        timer_->async_wait(std::bind(&TimerWheel::expired, this, std::placeholders::_1));
+    }
+}
+
+void TimerWheel::advance_nts(uint64_t now,
+        std::vector<std::pair<TimedEventImpl*, std::shared_ptr<TimerState>>>& due)
+{
+    while(next_tick_ <= now)
+    {
+        uint32_t index = static_cast<uint32_t>(next_tick_) & (SLOTS - 1);
+
+        if(index == 0)
+        {
+            for(uint32_t level = 1; level < LEVELS && cascade_nts(level) == 0; ++level)
+            {
+            }
+        }
+
+        TimerWheelNode& slot = slots_[index];
+        while(slot.next != &slot)
+        {
+            TimerWheelNode* node = slot.next;
+            due.emplace_back(node->event, std::move(node->state));
+            unlink_nts(*node);
+            --size_;
+        }
+
+        ++next_tick_;
+
+        // Skip to the end of the window when nothing expires before it.
+        if(first_occupied_nts(0, 0) == SLOTS && (next_tick_ & (SLOTS - 1)) != 0)
+        {
+            next_tick_ = std::min((next_tick_ | (SLOTS - 1)) + 1, now + 1);
+        }
+    }
+}
+
+void TimerWheel::expired(const std::error_code& ec)
+{
+    // Aborted waits were replaced by an earlier one.
+    if(ec == asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    std::vector<std::pair<TimedEventImpl*, std::shared_ptr<TimerState>>> due;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if(shutdown_)
+    {
+        return;
+    }
+
+    armed_tick_ = 0;
+    ++wake_ups_;
+
+    advance_nts(to_tick(std::chrono::steady_clock::now(), false), due);
+
+    arm_timer_nts();
+
+    lock.unlock();
+
+    for(auto& event : due)
+    {
+        event.first->event(std::error_code(), event.second);
+    }
+}
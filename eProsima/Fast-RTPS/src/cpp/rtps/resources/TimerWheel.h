@@ -0,0 +1,167 @@
+// Copyright 2016 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TimerWheel.h
+ *
+ */
+
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+#ifndef DOXYGEN_SHOULD_SKIP_THIS_PUBLIC
+
+#include <asio/io_service.hpp>
+#include <asio/steady_timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Testing purpose
+#ifndef TEST_FRIENDS
+#define TEST_FRIENDS
+#endif // TEST_FRIENDS
+
+namespace eprosima
+{
+    namespace fastrtps
+    {
+        namespace rtps
+        {
+            class TimedEventImpl;
+            class TimerState;
+
+            /**
+             * Link of a TimedEventImpl in the wheel. It is owned by the event and only accessed with the wheel locked.
+             * @ingroup MANAGEMENT_MODULE
+             */
+            struct TimerWheelNode
+            {
+                TimerWheelNode() : prev(nullptr), next(nullptr), expiry(0), event(nullptr) {}
+
+                TimerWheelNode* prev;
+                TimerWheelNode* next;
+                //!Tick at which the event expires.
+                uint64_t expiry;
+                //!Event to notify.
+                TimedEventImpl* event;
+                //!State of the event when it was scheduled, given to the event on expiration.
+                std::shared_ptr<TimerState> state;
+            };
+
+            /**
+             * Hierarchical timer wheel running the timed events of an IO service.
+             * There is a single wheel, and a single asio timer, for each IO service. Events are scheduled and
+             * cancelled in constant time. Deadlines are rounded up to the tick of the wheel (1 millisecond) and all
+             * the events expiring in the same tick are notified in the same wake-up of the event thread.
+             * @ingroup MANAGEMENT_MODULE
+             */
+            class TimerWheel : public asio::io_service::service
+            {
+                TEST_FRIENDS
+
+                public:
+
+                    static asio::io_service::id id;
+
+                    explicit TimerWheel(asio::io_service& service);
+
+                    ~TimerWheel();
+
+                    /**
+                     * Schedule an event. The node must not be scheduled.
+                     * @param node Node of the event, with its event and state set.
+                     * @param deadline Time point at which the event expires.
+                     */
+                    void schedule(TimerWheelNode& node, std::chrono::steady_clock::time_point deadline);
+
+                    /**
+                     * Remove an event from the wheel.
+                     * @param node Node of the event.
+                     * @return True if the event was scheduled. False if it was not, or if its expiration is already
+                     * being notified.
+                     */
+                    bool cancel(TimerWheelNode& node);
+
+                    //!Number of wake-ups of the event thread, used to measure the coalescing of events.
+                    uint64_t wake_ups() const;
+
+                    // asio 1.10 calls shutdown_service(), later versions call shutdown().
+                    void shutdown_service();
+
+                    void shutdown();
+
+                private:
+
+                    static const uint32_t SLOT_BITS = 8;
+                    static const uint32_t SLOTS = 1 << SLOT_BITS;
+                    static const uint32_t LEVELS = 4;
+
+                    uint64_t to_tick(std::chrono::steady_clock::time_point time_point, bool round_up) const;
+
+                    //!Circular distance from a slot index to the first non empty slot of a level, SLOTS if none.
+                    uint32_t first_occupied_nts(uint32_t level, uint32_t from) const;
+
+                    void add_nts(TimerWheelNode& node);
+
+                    void unlink_nts(TimerWheelNode& node);
+
+                    //!Move the events of a slot to their place in the lower levels.
+                    uint32_t cascade_nts(uint32_t level);
+
+                    //!Tick of the next wake-up needed, or 0 when the wheel is empty.
+                    uint64_t next_wake_up_nts() const;
+
+                    void arm_timer_nts();
+
+                    //!Process the ticks up to the given one, collecting the events expiring in them.
+                    void advance_nts(uint64_t now,
+                            std::vector<std::pair<TimedEventImpl*, std::shared_ptr<TimerState>>>& due);
+
+                    void expired(const std::error_code& ec);
+
+                    mutable std::mutex mutex_;
+
+                    //!Released on shutdown, before the timer service is destroyed.
+                    std::unique_ptr<asio::steady_timer> timer_;
+
+                    //!Origin of the ticks.
+                    const std::chrono::steady_clock::time_point origin_;
+
+                    //!Next tick to process, all the events expiring before it were notified.
+                    uint64_t next_tick_;
+
+                    //!Tick the timer is armed at, 0 if not armed.
+                    uint64_t armed_tick_;
+
+                    //!Slots of every level, each one a list of nodes linked through a sentinel.
+                    std::vector<TimerWheelNode> slots_;
+
+                    //!Bitmap of non empty slots of every level.
+                    uint64_t occupied_[LEVELS][SLOTS / 64];
+
+                    size_t size_;
+
+                    uint64_t wake_ups_;
+
+                    bool shutdown_;
+            };
+        }
+    }
+} /* namespace eprosima */
+#endif
+#endif /* TIMERWHEEL_H_ */
@@ -37,7 +37,7 @@ using namespace eprosima::fastrtps::rtps;
 ReaderProxy::ReaderProxy(const RemoteReaderAttributes& rdata,const WriterTimes& times,StatefulWriter* SW) :
     m_att(rdata), mp_SFW(SW),
     mp_nackResponse(nullptr), mp_nackSupression(nullptr), m_lastAcknackCount(0),
-    mp_mutex(new std::recursive_mutex()), lastNackfragCount_(0)
+    mp_mutex(new std::recursive_mutex()), lastNackfragCount_(0), low_mark_heap_position_(0)
 {
     if(rdata.endpoint.reliabilityKind == RELIABLE)
     {
@@ -82,7 +82,7 @@ void ReaderProxy::addChange(const ChangeForReader_t& change)
     // For best effort readers, changes are acked when being sent
     if(m_changesForReader.size() == 0 && change.getStatus() == ACKNOWLEDGED)
     {
-        changesFromRLowMark_ = change.getSequenceNumber();
+        set_low_mark_nts(change.getSequenceNumber());
         return;
     }
 
@@ -153,7 +153,7 @@ void ReaderProxy::acked_changes_set(const SequenceNumber_t& seqNum)
         }
     }
 
-    changesFromRLowMark_ = future_low_mark - 1;
+    set_low_mark_nts(future_low_mark - 1);
 }
 
 bool ReaderProxy::requested_changes_set(std::vector<SequenceNumber_t>& seqNumSet)
@@ -233,7 +233,7 @@ void ReaderProxy::set_change_to_status(const SequenceNumber_t& seq_num, ChangeFo
         if(status == ACKNOWLEDGED && it == m_changesForReader.begin())
         {
             m_changesForReader.erase(it);
-            changesFromRLowMark_ = seq_num;
+            set_low_mark_nts(seq_num);
         }
         else
         {
@@ -291,7 +291,7 @@ void ReaderProxy::convert_status_on_all_changes(ChangeForReaderStatus_t previous
         {
             if(next == ACKNOWLEDGED && it == m_changesForReader.begin())
             {
-                changesFromRLowMark_ = it->getSequenceNumber();
+                set_low_mark_nts(it->getSequenceNumber());
                 it = m_changesForReader.erase(it);
                 continue;
             }
@@ -415,3 +415,9 @@ bool ReaderProxy::requested_fragment_set(SequenceNumber_t sequence_number, const
 
     return true;
 }
+
+void ReaderProxy::set_low_mark_nts(const SequenceNumber_t& seq_num)
+{
+    changesFromRLowMark_ = seq_num;
+    mp_SFW->low_mark_changed_nts(this);
+}
@@ -519,6 +519,8 @@ bool StatefulWriter::matched_reader_add(const RemoteReaderAttributes& rdata)
     }
 
     matched_readers.push_back(rp);
+    matched_readers_by_guid_[rp->m_att.guid] = rp;
+    low_mark_heap_add_nts(rp);
 
     logInfo(RTPS_WRITER, "Reader Proxy "<< rp->m_att.guid<< " added to " << this->m_guid.entityId << " with "
             <<rp->m_att.endpoint.unicastLocatorList.size()<<"(u)-"
@@ -545,6 +547,8 @@ bool StatefulWriter::matched_reader_remove(const RemoteReaderAttributes& rdata)
             logInfo(RTPS_WRITER, "Reader Proxy removed: " << (*it)->m_att.guid);
             rproxy = std::move(*it);
             it = matched_readers.erase(it);
+            matched_readers_by_guid_.erase(rproxy->m_att.guid);
+            low_mark_heap_remove_nts(rproxy);
 
             continue;
         }
@@ -616,6 +620,11 @@ bool StatefulWriter::is_acked_by_all(const CacheChange_t* change) const
         return false;
     }
 
+    if(!low_mark_heap_.empty() && change->sequenceNumber <= min_readers_low_mark_nts())
+    {
+        return true;
+    }
+
     for(auto it = matched_readers.begin(); it!=matched_readers.end(); ++it)
     {
         if(!(*it)->change_is_acked(change->sequenceNumber))
@@ -632,15 +641,15 @@ bool StatefulWriter::wait_for_all_acked(const Duration_t& max_wait)
     std::unique_lock<std::recursive_mutex> lock(*mp_mutex);
     std::unique_lock<std::mutex> all_acked_lock(all_acked_mutex_);
 
-    all_acked_ = true;
+    // A reader which has not acknowledged the whole history has changes pending.
+    all_acked_ = low_mark_heap_.empty() || min_readers_low_mark_nts() >= get_seq_num_max();
 
-    for(auto it = matched_readers.begin(); it != matched_readers.end(); ++it)
+    for(auto it = matched_readers.begin(); all_acked_ && it != matched_readers.end(); ++it)
     {
         std::lock_guard<std::recursive_mutex> rguard(*(*it)->mp_mutex);
         if((*it)->countChangesForReader() > 0)
         {
             all_acked_ = false;
-            break;
         }
     }
     lock.unlock();
@@ -658,41 +667,19 @@ void StatefulWriter::check_acked_status()
 {
     std::unique_lock<std::recursive_mutex> lock(*mp_mutex);
 
-    bool all_acked = true;
-    SequenceNumber_t min_low_mark;
-
-
-    for(auto it = matched_readers.begin(); it != matched_readers.end(); ++it)
-    {
-        std::lock_guard<std::recursive_mutex> rguard(*(*it)->mp_mutex);
-
-        if(min_low_mark == SequenceNumber_t() || (*it)->get_low_mark() < min_low_mark)
-        {
-            min_low_mark = (*it)->get_low_mark();
-        }
-
-        if((*it)->countChangesForReader() > 0)
-        {
-            all_acked = false;
-        }
-    }
+    SequenceNumber_t min_low_mark = min_readers_low_mark_nts();
 
     if(get_seq_num_min() != SequenceNumber_t::unknown())
     {
         // Inform of samples acked.
         if(mp_listener != nullptr)
         {
+            // Changes in the history are ordered by sequence number.
             std::vector<CacheChange_t*> all_acked_changes;
-            for(SequenceNumber_t current_seq = get_seq_num_min(); current_seq <= min_low_mark; ++current_seq)
+            for(std::vector<CacheChange_t*>::iterator cit = mp_history->changesBegin();
+                    cit != mp_history->changesEnd() && (*cit)->sequenceNumber <= min_low_mark; ++cit)
             {
-                for(std::vector<CacheChange_t*>::iterator cit = mp_history->changesBegin();
-                        cit != mp_history->changesEnd(); ++cit)
-                {
-                    if((*cit)->sequenceNumber == current_seq)
-                    {
-                        all_acked_changes.push_back(*cit);
-                    }
-                }
+                all_acked_changes.push_back(*cit);
             }
             for(auto cit = all_acked_changes.begin(); cit != all_acked_changes.end(); ++cit)
             {
@@ -710,31 +697,115 @@ void StatefulWriter::check_acked_status()
         }
     }
 
-    if(all_acked)
+    // Only when every reader acknowledged the whole history some of them may have no changes pending.
+    if(low_mark_heap_.empty() || min_low_mark >= get_seq_num_max())
     {
         std::unique_lock<std::mutex> all_acked_lock(all_acked_mutex_);
-        all_acked_ = true;
-        all_acked_cond_.notify_all();
+
+        // Nobody waits while all_acked_ is set.
+        if(!all_acked_)
+        {
+            bool all_acked = true;
+
+            for(auto it = matched_readers.begin(); all_acked && it != matched_readers.end(); ++it)
+            {
+                std::lock_guard<std::recursive_mutex> rguard(*(*it)->mp_mutex);
+                all_acked = (*it)->countChangesForReader() == 0;
+            }
+
+            if(all_acked)
+            {
+                all_acked_ = true;
+                all_acked_cond_.notify_all();
+            }
+        }
     }
 }
 
-bool StatefulWriter::try_remove_change(std::chrono::microseconds& microseconds,
-        std::unique_lock<std::recursive_mutex>& lock)
+SequenceNumber_t StatefulWriter::min_readers_low_mark_nts() const
 {
-    logInfo(RTPS_WRITER, "Starting process try remove change for writer " << getGuid());
+    return low_mark_heap_.empty() ? SequenceNumber_t() : low_mark_heap_.front()->get_low_mark();
+}
 
-    SequenceNumber_t min_low_mark;
+void StatefulWriter::low_mark_heap_add_nts(ReaderProxy* remote_reader)
+{
+    remote_reader->low_mark_heap_position_ = low_mark_heap_.size();
+    low_mark_heap_.push_back(remote_reader);
+    low_mark_heap_sift_nts(remote_reader->low_mark_heap_position_);
+}
 
-    for(auto it = matched_readers.begin(); it != matched_readers.end(); ++it)
+void StatefulWriter::low_mark_heap_remove_nts(ReaderProxy* remote_reader)
+{
+    size_t position = remote_reader->low_mark_heap_position_;
+    if(position >= low_mark_heap_.size() || low_mark_heap_[position] != remote_reader)
     {
-        std::lock_guard<std::recursive_mutex> rguard(*(*it)->mp_mutex);
+        return;
+    }
+
+    // The last reader takes its place.
+    ReaderProxy* last = low_mark_heap_.back();
+    low_mark_heap_.pop_back();
+    if(last != remote_reader)
+    {
+        low_mark_heap_[position] = last;
+        low_mark_heap_sift_nts(position);
+    }
+}
+
+void StatefulWriter::low_mark_changed_nts(ReaderProxy* remote_reader)
+{
+    // Low marks also move while the reader is being added.
+    size_t position = remote_reader->low_mark_heap_position_;
+    if(position < low_mark_heap_.size() && low_mark_heap_[position] == remote_reader)
+    {
+        low_mark_heap_sift_nts(position);
+    }
+}
 
-        if(min_low_mark == SequenceNumber_t() || (*it)->get_low_mark() < min_low_mark)
+void StatefulWriter::low_mark_heap_sift_nts(size_t position)
+{
+    ReaderProxy* remote_reader = low_mark_heap_[position];
+    const SequenceNumber_t low_mark = remote_reader->get_low_mark();
+    const size_t size = low_mark_heap_.size();
+
+    while(position > 0)
+    {
+        size_t parent = (position - 1) / 2;
+        if(!(low_mark < low_mark_heap_[parent]->get_low_mark()))
         {
-            min_low_mark = (*it)->get_low_mark();
+            break;
         }
+        low_mark_heap_[position] = low_mark_heap_[parent];
+        low_mark_heap_[position]->low_mark_heap_position_ = position;
+        position = parent;
     }
 
+    for(size_t child = 2 * position + 1; child < size; child = 2 * position + 1)
+    {
+        if(child + 1 < size && low_mark_heap_[child + 1]->get_low_mark() < low_mark_heap_[child]->get_low_mark())
+        {
+            ++child;
+        }
+        if(!(low_mark_heap_[child]->get_low_mark() < low_mark))
+        {
+            break;
+        }
+        low_mark_heap_[position] = low_mark_heap_[child];
+        low_mark_heap_[position]->low_mark_heap_position_ = position;
+        position = child;
+    }
+
+    low_mark_heap_[position] = remote_reader;
+    remote_reader->low_mark_heap_position_ = position;
+}
+
+bool StatefulWriter::try_remove_change(std::chrono::microseconds& microseconds,
+        std::unique_lock<std::recursive_mutex>& lock)
+{
+    logInfo(RTPS_WRITER, "Starting process try remove change for writer " << getGuid());
+
+    SequenceNumber_t min_low_mark = min_readers_low_mark_nts();
+
     SequenceNumber_t calc = min_low_mark < get_seq_num_min() ? SequenceNumber_t() :
         (min_low_mark - get_seq_num_min()) + 1;
     unsigned int may_remove_change = 1;
@@ -880,39 +951,37 @@ void StatefulWriter::process_acknack(const GUID_t reader_guid, uint32_t ack_coun
 {
     std::unique_lock<std::recursive_mutex> lock(*mp_mutex);
 
-    for(auto remote_reader : matched_readers)
+    auto remote = matched_readers_by_guid_.find(reader_guid);
+    if(remote != matched_readers_by_guid_.end())
     {
+        ReaderProxy* remote_reader = remote->second;
         std::lock_guard<std::recursive_mutex> reader_guard(*remote_reader->mp_mutex);
 
-        if(remote_reader->m_att.guid == reader_guid)
+        if(remote_reader->m_lastAcknackCount < ack_count)
         {
-            if(remote_reader->m_lastAcknackCount < ack_count)
+            remote_reader->m_lastAcknackCount = ack_count;
+            if(sn_set.base != SequenceNumber_t(0, 0))
             {
-                remote_reader->m_lastAcknackCount = ack_count;
-                if(sn_set.base != SequenceNumber_t(0, 0))
+                // Sequence numbers before Base are set as Acknowledged.
+                remote_reader->acked_changes_set(sn_set.base);
+                std::vector<SequenceNumber_t> set_vec = sn_set.get_set();
+                if (remote_reader->requested_changes_set(set_vec) && remote_reader->mp_nackResponse != nullptr)
                 {
-                    // Sequence numbers before Base are set as Acknowledged.
-                    remote_reader->acked_changes_set(sn_set.base);
-                    std::vector<SequenceNumber_t> set_vec = sn_set.get_set();
-                    if (remote_reader->requested_changes_set(set_vec) && remote_reader->mp_nackResponse != nullptr)
-                    {
-                        remote_reader->mp_nackResponse->restart_timer();
-                    }
-                    else if(!final_flag)
-                    {
-                        mp_periodicHB->restart_timer();
-                    }
+                    remote_reader->mp_nackResponse->restart_timer();
                 }
-                else if(sn_set.isSetEmpty() && !final_flag)
+                else if(!final_flag)
                 {
-                    send_heartbeat_to_nts(*remote_reader, true, remote_reader->m_att.is_eprosima_endpoint);
+                    mp_periodicHB->restart_timer();
                 }
-
-                // Check if all CacheChange are acknowledge, because a user could be waiting
-                // for this, of if VOLATILE should be removed CacheChanges
-                check_acked_status();
             }
-            break;
+            else if(sn_set.isSetEmpty() && !final_flag)
+            {
+                send_heartbeat_to_nts(*remote_reader, true, remote_reader->m_att.is_eprosima_endpoint);
+            }
+
+            // Check if all CacheChange are acknowledge, because a user could be waiting
+            // for this, of if VOLATILE should be removed CacheChanges
+            check_acked_status();
         }
     }
 }
@@ -137,6 +137,44 @@ void ThroughputSubscriber::DataSubListener::saveNumbers()
     saved_lostsamples = lostsamples;
 }
 
+ThroughputSubscriber::ExtraDataSubListener::ExtraDataSubListener(ThroughputSubscriber& up)
+    : m_up(up)
+    , throughputin(nullptr)
+{
+}
+
+ThroughputSubscriber::ExtraDataSubListener::~ExtraDataSubListener()
+{
+    delete(throughputin);
+}
+
+void ThroughputSubscriber::ExtraDataSubListener::onSubscriptionMatched(Subscriber* /*sub*/, MatchingInfo& match_info)
+{
+    std::unique_lock<std::mutex> lock(m_up.dataMutex_);
+
+    if (match_info.status == MATCHED_MATCHING)
+    {
+        ++m_up.data_disc_count_;
+    }
+    else
+    {
+        --m_up.data_disc_count_;
+    }
+
+    lock.unlock();
+    m_up.data_disc_cond_.notify_one();
+}
+
+void ThroughputSubscriber::ExtraDataSubListener::onNewDataMessage(Subscriber* subscriber)
+{
+    if (throughputin != nullptr)
+    {
+        while (subscriber->takeNextData((void*)throughputin, &info))
+        {
+        }
+    }
+}
+
 ThroughputSubscriber::CommandSubListener::CommandSubListener(ThroughputSubscriber& up):m_up(up){}
 ThroughputSubscriber::CommandSubListener::~CommandSubListener(){}
 
@@ -208,13 +246,18 @@ void ThroughputSubscriber::CommandSubListener::onNewDataMessage(Subscriber* subs
                     delete(m_up.throughputin);
                     //m_up.throughputin = nullptr;
                     m_up.throughputin = new ThroughputType((uint16_t)m_up.m_datasize);
+                    for (ExtraDataSubListener* listener : m_up.m_extra_listeners)
+                    {
+                        delete(listener->throughputin);
+                        listener->throughputin = new ThroughputType((uint16_t)m_up.m_datasize);
+                    }
                 }
 
                 std::cout << "Waiting for data discovery" << std::endl;
                 std::unique_lock<std::mutex> data_disc_lock(m_up.dataMutex_);
                 m_up.data_disc_cond_.wait(data_disc_lock, [&]()
                 {
-                    return m_up.data_disc_count_ > 0;
+                    return m_up.data_disc_count_ >= m_up.m_subscribers;
                 });
                 data_disc_lock.unlock();
                 std::cout << "Discovery data complete" << std::endl;
@@ -295,12 +338,16 @@ void ThroughputSubscriber::CommandPubListener::onPublicationMatched(Publisher* /
 ThroughputSubscriber::~ThroughputSubscriber()
 {
     Domain::stopAll();
+    for (ExtraDataSubListener* listener : m_extra_listeners)
+    {
+        delete(listener);
+    }
 }
 
 ThroughputSubscriber::ThroughputSubscriber(bool reliable, uint32_t pid, bool hostname,
     const eprosima::fastrtps::rtps::PropertyPolicy& part_property_policy,
     const eprosima::fastrtps::rtps::PropertyPolicy& property_policy,
-    const std::string& sXMLConfigFile, bool /*dynamic_types*/, int forced_domain)
+    const std::string& sXMLConfigFile, bool /*dynamic_types*/, int forced_domain, uint32_t subscribers)
     : disc_count_(0)
     , data_disc_count_(0)
     , stop_count_(0)
@@ -314,6 +361,7 @@ ThroughputSubscriber::ThroughputSubscriber(bool reliable, uint32_t pid, bool hos
     , m_sXMLConfigFile(sXMLConfigFile)
     //, dynamic_data(dynamic_types)
     , m_forced_domain(forced_domain)
+    , m_subscribers(subscribers > 0 ? subscribers : 1)
     , throughputin(nullptr)
 {
     //if (dynamic_data) // Dummy type registration
@@ -420,6 +468,27 @@ ThroughputSubscriber::ThroughputSubscriber(bool reliable, uint32_t pid, bool hos
         mp_datasub = Domain::createSubscriber(mp_par, Sparam, (SubscriberListener*)&this->m_DataSubListener);
     }
 
+    // Additional subscribers on the same topic, every received sample is delivered to all of them
+    for (uint32_t i = 1; i < m_subscribers; ++i)
+    {
+        ExtraDataSubListener* listener = new ExtraDataSubListener(*this);
+        m_extra_listeners.push_back(listener);
+        Subscriber* sub = nullptr;
+        if (m_sXMLConfigFile.length() > 0)
+        {
+            sub = Domain::createSubscriber(mp_par, profile_name, listener);
+        }
+        else
+        {
+            sub = Domain::createSubscriber(mp_par, Sparam, listener);
+        }
+        if (sub == nullptr)
+        {
+            ready = false;
+        }
+        mp_extra_datasubs.push_back(sub);
+    }
+
     //COMMAND
     PublisherAttributes Wparam;
     //Wparam.historyMaxSize = 20;
@@ -42,6 +42,7 @@
 
 #include <condition_variable>
 #include <chrono>
+#include <vector>
 
 #include <fstream>
 #include <iostream>
@@ -55,7 +56,7 @@ public:
     ThroughputSubscriber(bool reliable, uint32_t pid, bool hostname,
         const eprosima::fastrtps::rtps::PropertyPolicy& part_property_policy,
         const eprosima::fastrtps::rtps::PropertyPolicy& property_policy,
-        const std::string& sXMLConfigFile, bool dynamic_types, int forced_domain);
+        const std::string& sXMLConfigFile, bool dynamic_types, int forced_domain, uint32_t subscribers = 1);
     virtual ~ThroughputSubscriber();
     eprosima::fastrtps::Participant* mp_par;
     eprosima::fastrtps::Subscriber* mp_datasub;
@@ -91,6 +92,25 @@ public:
         std::ofstream myfile;
     }m_DataSubListener;
 
+    //! Listener of the additional data subscribers, they only take the samples.
+    class ExtraDataSubListener : public eprosima::fastrtps::SubscriberListener
+    {
+    public:
+
+        ExtraDataSubListener(ThroughputSubscriber& up);
+        virtual ~ExtraDataSubListener();
+        ThroughputSubscriber& m_up;
+        ThroughputType* throughputin;
+        eprosima::fastrtps::SampleInfo_t info;
+        void onSubscriptionMatched(eprosima::fastrtps::Subscriber* sub,
+            eprosima::fastrtps::rtps::MatchingInfo& info);
+        void onNewDataMessage(eprosima::fastrtps::Subscriber* sub);
+
+    private:
+
+        ExtraDataSubListener& operator=(const ExtraDataSubListener&);
+    };
+
     class CommandSubListener : public eprosima::fastrtps::SubscriberListener
     {
     public:
@@ -133,6 +153,10 @@ public:
     std::string m_sXMLConfigFile;
     //bool dynamic_data = false;
     int m_forced_domain;
+    //! Number of data subscribers in the participant, all of them receive every sample.
+    uint32_t m_subscribers;
+    std::vector<eprosima::fastrtps::Subscriber*> mp_extra_datasubs;
+    std::vector<ExtraDataSubListener*> m_extra_listeners;
 
     // Static Data
     ThroughputDataType throughput_t;
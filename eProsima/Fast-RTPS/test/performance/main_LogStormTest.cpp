@@ -0,0 +1,98 @@
+// Copyright 2016 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * Logging storm benchmark.
+ *
+ * Reproduces what the receive and writer threads do under heavy packet loss: several threads
+ * hitting the same handful of warning call sites in a tight loop. Reports the cost per call seen
+ * by the logging threads, which is what ends up stalling the middleware.
+ *
+ * Usage: LogStormTest [threads] [iterations per thread]
+ */
+
+#include <fastrtps/log/Log.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <thread>
+#include <vector>
+
+using namespace eprosima::fastrtps;
+
+namespace {
+
+void storm(uint32_t iterations)
+{
+    for (uint32_t sequence = 0; sequence != iterations; ++sequence)
+    {
+        if (sequence % 2)
+        {
+            logWarning(RTPS_MSG_IN, "Received message too short, ignoring (sequence " << sequence << ")");
+        }
+        else
+        {
+            logWarning(RTPS_WRITER, "Sample " << sequence << " lost, sending GAP");
+        }
+    }
+}
+
+double run(const char* name, uint32_t threads, uint32_t iterations)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i != threads; ++i)
+        workers.emplace_back(storm, iterations);
+    for (auto& worker : workers)
+        worker.join();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    double ns_per_call = static_cast<double>(elapsed) / iterations;
+    std::cerr << std::setw(28) << std::left << name << std::fixed << std::setprecision(1)
+        << ns_per_call << " ns/call per thread" << std::endl;
+    return ns_per_call;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint32_t threads = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 4;
+    uint32_t iterations = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 1000000;
+
+    std::cerr << "Logging storm: " << threads << " threads x " << iterations << " calls" << std::endl;
+
+    Log::SetVerbosity(Log::Error);
+    run("verbosity disabled", threads, iterations);
+
+    Log::SetVerbosity(Log::Warning);
+    Log::SetCategoryFilter(std::regex("(RTPS_PDP)"));
+    run("category filtered out", threads, iterations);
+
+    // Let everything through the call sites, but keep the consumers quiet so the
+    // measurement is not dominated by the terminal. Entries that do not fit in the
+    // queue are dropped, as they would be during a real storm.
+    Log::Reset();
+    Log::SetVerbosity(Log::Warning);
+    Log::SetErrorStringFilter(std::regex("(never matches this)"));
+    run("queued", threads, iterations);
+
+    Log::KillThread();
+    return 0;
+}
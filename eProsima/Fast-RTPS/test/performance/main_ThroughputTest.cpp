@@ -120,7 +120,8 @@ enum  optionIndex {
     CERTS_PATH,
     XML_FILE,
     DYNAMIC_TYPES,
-    FORCED_DOMAIN
+    FORCED_DOMAIN,
+    SUBSCRIBERS
 };
 
 const option::Descriptor usage[] = {
@@ -135,6 +136,8 @@ const option::Descriptor usage[] = {
     { MSG_SIZE, 0,"s","msg_size",           Arg::Numeric,   "  -s <num>, \t--msg_size=<num>  \tSize of the message." },
     { FILE_R,0,"f","file",                  Arg::Required,  "  -f <arg>, \t--file=<arg>   \tFile to read the payload demands from.\t" },
     { UNKNOWN_OPT, 0,"", "",                Arg::None,      "\nNote:\nIf no demand or msg_size is provided the .csv file is used.\n"},
+    { UNKNOWN_OPT, 0,"", "",                Arg::None,      "Subscriber options:"},
+    { SUBSCRIBERS, 0,"","subscribers",      Arg::Numeric,   "  \t--subscribers=<num>  \tNumber of data subscribers receiving every sample." },
     { HOSTNAME,0,"","hostname",             Arg::None,      "" },
     { EXPORT_CSV,0,"","export_csv",         Arg::None,      "" },
     { EXPORT_PREFIX,0,"","export_prefix",   Arg::String,    "\t--export_prefix \tFile prefix for the CSV file." },
@@ -184,6 +187,7 @@ int main(int argc, char** argv)
     std::string sXMLConfigFile = "";
     bool dynamic_types = false;
     int forced_domain = -1;
+    uint32_t subscribers = 1;
 #if HAVE_SECURITY
     bool use_security = false;
     std::string certs_path;
@@ -315,6 +319,10 @@ int main(int argc, char** argv)
                 forced_domain = strtol(opt.arg, nullptr, 10);
                 break;
 
+            case SUBSCRIBERS:
+                subscribers = strtol(opt.arg, nullptr, 10);
+                break;
+
 #if HAVE_SECURITY
             case USE_SECURITY:
                 if (strcmp(opt.arg, "true") == 0)
@@ -403,7 +411,8 @@ int main(int argc, char** argv)
     }
     else
     {
-        ThroughputSubscriber tsub(reliable, seed, hostname, sub_part_property_policy, sub_property_policy, sXMLConfigFile, dynamic_types, forced_domain);
+        ThroughputSubscriber tsub(reliable, seed, hostname, sub_part_property_policy, sub_property_policy, sXMLConfigFile, dynamic_types, forced_domain,
+            subscribers);
         tsub.run();
     }
 
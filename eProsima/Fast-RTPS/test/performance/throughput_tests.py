@@ -14,9 +14,9 @@
 
 import shlex, subprocess, time, os, socket, sys
 
-if len(sys.argv) != 2 :
+if len(sys.argv) != 2 and len(sys.argv) != 3 :
     print("ERROR: Provide a payload size")
-    print("usage: python throughput_tests.py PAYLOAD_SIZE")
+    print("usage: python throughput_tests.py PAYLOAD_SIZE [SUBSCRIBERS]")
     quit(-1)
 
 payload_demands = os.environ.get("CMAKE_CURRENT_SOURCE_DIR") + "/payloads_demands_" + sys.argv[1] + ".csv"
@@ -29,6 +29,18 @@ security_options = []
 if certs_path:
     security_options = ["--security=true", "--certs=" + certs_path]
 
+# Fan-out execution, one reliable writer matched with several readers
+if len(sys.argv) == 3 :
+    subscriber_proc = subprocess.Popen([command, "subscriber", "-r", "reliable", "--hostname",
+        "--subscribers=" + sys.argv[2]] + security_options)
+    publisher_proc = subprocess.Popen([command, "publisher", "-r", "reliable", "--file", payload_demands, "--hostname",
+        "--export_csv"] + security_options)
+
+    subscriber_proc.communicate()
+    publisher_proc.communicate()
+
+    quit()
+
 # Best effort execution
 subscriber_proc = subprocess.Popen([command, "subscriber", "--hostname"] + security_options)
 publisher_proc = subprocess.Popen([command, "publisher", "--file", payload_demands, "--hostname", "--export_csv"] +
@@ -13,6 +13,8 @@
 // limitations under the License.
 //
 
+#define LOG_NO_CATEGORIES "CompiledOutCategory,AnotherCompiledOutCategory"
+
 #include <fastrtps/log/Log.h>
 #include <fastrtps/log/StdoutConsumer.h>
 #include "mock/MockConsumer.h"
@@ -144,6 +146,43 @@ TEST_F(LogTests, multiple_verbosity_levels)
    ASSERT_EQ(3, consumedEntries.size());
 }
 
+TEST_F(LogTests, compiled_out_categories)
+{
+   logError(CompiledOutCategory, "If you're seeing this, something went wrong");
+   logWarning(AnotherCompiledOutCategory, "If you're seeing this, something went wrong");
+   logError(CompiledOut, "This should be logged, only whole category names are compiled out");
+   auto consumedEntries = HELPER_WaitForEntries(3);
+   ASSERT_EQ(1, consumedEntries.size());
+   ASSERT_STREQ("CompiledOut", consumedEntries.back().context.category);
+}
+
+TEST_F(LogTests, long_messages_are_truncated)
+{
+   std::string longMessage(2 * Log::MaxMessageLength, 'x');
+   logError(Truncation, longMessage);
+   auto consumedEntries = HELPER_WaitForEntries(1);
+   ASSERT_EQ(1, consumedEntries.size());
+
+   auto message = consumedEntries.back().message;
+   ASSERT_EQ(Log::MaxMessageLength - 1, message.size());
+   ASSERT_EQ("...", message.substr(message.size() - 3));
+}
+
+TEST_F(LogTests, filters_are_reevaluated_on_cached_call_sites)
+{
+   for (int i = 0; i != 3; i++)
+   {
+      if (i == 1)
+         Log::SetCategoryFilter(std::regex("(Bad)"));
+      else if (i == 2)
+         Log::SetCategoryFilter(std::regex("(Cached)"));
+
+      logError(CachedCategory, "Logged on the first and last iterations only");
+   }
+   auto consumedEntries = HELPER_WaitForEntries(3);
+   ASSERT_EQ(2, consumedEntries.size());
+}
+
 std::vector<Log::Entry> LogTests::HELPER_WaitForEntries(uint32_t amount)
 {
    size_t entries = 0;
@@ -0,0 +1,90 @@
+// Copyright 2016 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fastrtps/rtps/common/CacheChange.h>
+
+#include <cstring>
+#include <gtest/gtest.h>
+
+using namespace eprosima::fastrtps::rtps;
+
+/*!
+ * @fn TEST(SharedPayload, Create)
+ * @brief This test checks a shared payload holds a copy of the data and a single reference.
+ */
+TEST(SharedPayload, Create)
+{
+    octet data[] = {1, 2, 3, 4, 5, 6, 7};
+
+    SharedPayload_t* payload = SharedPayload_t::create(data, sizeof(data));
+    ASSERT_NE(payload, nullptr);
+
+    ASSERT_EQ(payload->length(), sizeof(data));
+    ASSERT_EQ(payload->references(), 1u);
+    ASSERT_NE(payload->data(), data);
+    ASSERT_EQ(memcmp(payload->data(), data, sizeof(data)), 0);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(payload->data()) % 8, 0u);
+
+    payload->release();
+}
+
+/*!
+ * @fn TEST(SharedPayload, ShareAndRelease)
+ * @brief This test checks changes referencing a shared payload and getting their own buffer back.
+ */
+TEST(SharedPayload, ShareAndRelease)
+{
+    octet data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    CacheChange_t received;
+    received.sequenceNumber = SequenceNumber_t(0, 3);
+    received.shared_payload = SharedPayload_t::create(data, sizeof(data));
+    received.serializedPayload.data = received.shared_payload->data();
+    received.serializedPayload.length = sizeof(data);
+
+    CacheChange_t first(16);
+    octet* first_buffer = first.serializedPayload.data;
+    first.share(&received);
+
+    CacheChange_t second;
+    second.share(&received);
+
+    ASSERT_EQ(received.shared_payload->references(), 3u);
+    ASSERT_EQ(first.sequenceNumber, received.sequenceNumber);
+    ASSERT_EQ(first.serializedPayload.data, received.shared_payload->data());
+    ASSERT_EQ(second.serializedPayload.data, received.shared_payload->data());
+    ASSERT_EQ(first.serializedPayload.length, sizeof(data));
+
+    // The receiver drops its reference, the readers still reference the data.
+    received.serializedPayload.data = nullptr;
+    received.release_shared_payload();
+    ASSERT_EQ(received.shared_payload, nullptr);
+    ASSERT_EQ(memcmp(first.serializedPayload.data, data, sizeof(data)), 0);
+    ASSERT_EQ(second.shared_payload->references(), 2u);
+
+    first.release_shared_payload();
+    ASSERT_EQ(first.shared_payload, nullptr);
+    ASSERT_EQ(first.serializedPayload.data, first_buffer);
+    ASSERT_EQ(first.serializedPayload.max_size, 16u);
+    ASSERT_EQ(first.serializedPayload.length, 0u);
+    ASSERT_EQ(second.shared_payload->references(), 1u);
+
+    // The last reference is released by the destructor of the change.
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
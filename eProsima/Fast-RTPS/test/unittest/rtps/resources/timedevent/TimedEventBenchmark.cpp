@@ -0,0 +1,115 @@
+// Copyright 2016 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the CPU used by the event thread to run many periodic events, as the heartbeats of a participant
+// with many writers, while other events are cancelled and restarted, as the response delays of the writers.
+//
+// Usage: TimedEventBenchmark [events] [period in ms] [restarts per ms] [seconds]
+
+#include "mock/MockEvent.h"
+
+#include <pthread.h>
+#include <time.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+static double thread_cpu_ms(std::thread& thread)
+{
+    clockid_t clock;
+    timespec ts;
+    if(pthread_getcpuclockid(thread.native_handle(), &clock) != 0 || clock_gettime(clock, &ts) != 0)
+    {
+        return 0.0;
+    }
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+int main(int argc, char** argv)
+{
+    size_t num_events = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    double period = argc > 2 ? std::strtod(argv[2], nullptr) : 10.0;
+    size_t restarts = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20;
+    size_t seconds = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 5;
+    if(num_events == 0 || period <= 0.0 || seconds == 0)
+    {
+        fprintf(stderr, "Usage: %s [events] [period in ms] [restarts per ms] [seconds]\n", argv[0]);
+        return 1;
+    }
+
+    asio::io_service service;
+    asio::io_service::work work(service);
+    std::thread thread([&service]() { service.run(); });
+
+    // Periodic events, started along a period.
+    std::vector<std::unique_ptr<MockEvent>> periodic;
+    for(size_t i = 0; i < num_events; ++i)
+    {
+        periodic.emplace_back(new MockEvent(service, thread, period, true));
+        periodic.back()->restart_timer();
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(period * 1000.0 / num_events)));
+    }
+
+    // Events restarted and cancelled before they expire.
+    std::vector<std::unique_ptr<MockEvent>> delayed;
+    for(size_t i = 0; i < num_events; ++i)
+    {
+        delayed.emplace_back(new MockEvent(service, thread, period * 5, false));
+    }
+
+    std::mt19937 random(0);
+    std::uniform_int_distribution<size_t> pick(0, num_events - 1);
+
+    double cpu_start = thread_cpu_ms(thread);
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(seconds);
+    size_t churn = 0;
+    for(auto tick = start; tick < end; tick += std::chrono::milliseconds(1))
+    {
+        for(size_t i = 0; i < restarts; ++i)
+        {
+            MockEvent& event = *delayed[pick(random)];
+            event.cancel_timer();
+            event.restart_timer();
+            ++churn;
+        }
+        std::this_thread::sleep_until(tick + std::chrono::milliseconds(1));
+    }
+    double cpu = thread_cpu_ms(thread) - cpu_start;
+
+    size_t notified = 0;
+    for(auto& event : periodic)
+    {
+        notified += static_cast<size_t>(event->successed_.load());
+    }
+    size_t expected = static_cast<size_t>((seconds * 1000.0 + period) * num_events / period);
+
+    periodic.clear();
+    delayed.clear();
+    service.stop();
+    thread.join();
+
+    printf("%zu periodic events of %.1f ms, %zu restarts per ms, %zu s\n", num_events, period, restarts, seconds);
+    printf("%-32s %10zu\n", "notifications", notified);
+    printf("%-32s %10zu\n", "expected at most", expected);
+    printf("%-32s %10zu\n", "restarts", churn);
+    printf("%-32s %10.3f\n", "event thread CPU (ms)", cpu);
+    printf("%-32s %10.3f\n", "CPU per notification (us)", notified > 0 ? cpu * 1000.0 / notified : 0.0);
+    return 0;
+}
@@ -0,0 +1,338 @@
+// Copyright 2016 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#define TEST_FRIENDS \
+    FRIEND_TEST(TimerWheelTests, CascadeAcrossFirstLevel); \
+    FRIEND_TEST(TimerWheelTests, CascadeAcrossSecondLevel); \
+    FRIEND_TEST(TimerWheelTests, DeadlineBeyondMaxDelta); \
+    FRIEND_TEST(TimerWheelTests, CancelLastNodeClearsSlot);
+
+#include "../../../../../src/cpp/rtps/resources/TimerWheel.h"
+#include "mock/MockEvent.h"
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace eprosima
+{
+    namespace fastrtps
+    {
+        namespace rtps
+        {
+            typedef std::vector<std::pair<TimedEventImpl*, std::shared_ptr<TimerState>>> DueEvents;
+
+            // The events are never notified by these tests, their address only identifies the node.
+            static TimedEventImpl* tag(int i)
+            {
+                static char tags[8];
+                return reinterpret_cast<TimedEventImpl*>(&tags[i]);
+            }
+
+            static std::vector<TimedEventImpl*> events(const DueEvents& due)
+            {
+                std::vector<TimedEventImpl*> result;
+                for(auto& event : due)
+                {
+                    result.push_back(event.first);
+                }
+                return result;
+            }
+
+            /*!
+             * @fn TEST(TimerWheelTests, CascadeAcrossFirstLevel)
+             * @brief This test checks that events of the second level are moved to the first one when the
+             * wheel crosses a multiple of 256 ticks, and notified on their tick.
+             */
+            TEST(TimerWheelTests, CascadeAcrossFirstLevel)
+            {
+                asio::io_service service;
+                TimerWheel& wheel = asio::use_service<TimerWheel>(service);
+                TimerWheelNode nodes[3];
+                for(int i = 0; i < 3; ++i)
+                {
+                    nodes[i].event = tag(i);
+                }
+
+                wheel.next_tick_ = 3 * 256 - 10;
+                // Wraps in the first level.
+                wheel.schedule(nodes[0], wheel.origin_ + std::chrono::milliseconds(3 * 256 + 3));
+                // In the second level, in the slot cascaded at 3 * 256.
+                wheel.schedule(nodes[1], wheel.origin_ + std::chrono::milliseconds(3 * 256 + 246));
+                // In the second level, in the slot cascaded at 4 * 256.
+                wheel.schedule(nodes[2], wheel.origin_ + std::chrono::milliseconds(4 * 256 + 34));
+                ASSERT_NE(0u, wheel.occupied_[1][0] & (1u << 3));
+                ASSERT_NE(0u, wheel.occupied_[1][0] & (1u << 4));
+
+                DueEvents due;
+                wheel.advance_nts(3 * 256, due);
+                EXPECT_TRUE(due.empty());
+                EXPECT_EQ(0u, wheel.occupied_[1][0] & (1u << 3));
+                ASSERT_NE(0u, wheel.occupied_[1][0] & (1u << 4));
+
+                wheel.advance_nts(3 * 256 + 2, due);
+                EXPECT_TRUE(due.empty());
+                wheel.advance_nts(3 * 256 + 3, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(0)}, events(due));
+
+                due.clear();
+                wheel.advance_nts(3 * 256 + 245, due);
+                EXPECT_TRUE(due.empty());
+                wheel.advance_nts(4 * 256 + 33, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(1)}, events(due));
+                EXPECT_EQ(0u, wheel.occupied_[1][0] & (1u << 4));
+
+                due.clear();
+                wheel.advance_nts(4 * 256 + 34, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(2)}, events(due));
+                EXPECT_EQ(0u, wheel.size_);
+                EXPECT_EQ(0u, wheel.next_wake_up_nts());
+            }
+
+            /*!
+             * @fn TEST(TimerWheelTests, CascadeAcrossSecondLevel)
+             * @brief This test checks the cascades of the second and third levels when the wheel crosses a
+             * multiple of 65536 ticks.
+             */
+            TEST(TimerWheelTests, CascadeAcrossSecondLevel)
+            {
+                asio::io_service service;
+                TimerWheel& wheel = asio::use_service<TimerWheel>(service);
+                TimerWheelNode nodes[4];
+                for(int i = 0; i < 4; ++i)
+                {
+                    nodes[i].event = tag(i);
+                }
+
+                const uint64_t boundary = 65536;
+                wheel.next_tick_ = boundary - 10;
+                wheel.schedule(nodes[0], wheel.origin_ + std::chrono::milliseconds(boundary + 100));
+                // In the slot 0 of the second level, cascaded with the third level.
+                wheel.schedule(nodes[1], wheel.origin_ + std::chrono::milliseconds(boundary + 246));
+                wheel.schedule(nodes[2], wheel.origin_ + std::chrono::milliseconds(boundary + 290));
+                // In the third level.
+                wheel.schedule(nodes[3], wheel.origin_ + std::chrono::milliseconds(2 * boundary + 5));
+                ASSERT_NE(0u, wheel.occupied_[1][0] & 1u);
+                ASSERT_NE(0u, wheel.occupied_[2][0] & (1u << 2));
+                EXPECT_EQ(boundary, wheel.next_wake_up_nts());
+
+                DueEvents due;
+                wheel.advance_nts(boundary, due);
+                EXPECT_TRUE(due.empty());
+                EXPECT_EQ(0u, wheel.occupied_[1][0] & 1u);
+                EXPECT_EQ(boundary + 100, wheel.next_wake_up_nts());
+
+                wheel.advance_nts(boundary + 100, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(0)}, events(due));
+                due.clear();
+                wheel.advance_nts(boundary + 246, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(1)}, events(due));
+                due.clear();
+                wheel.advance_nts(boundary + 290, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(2)}, events(due));
+                due.clear();
+
+                // The last event waits in the third level until its window starts.
+                EXPECT_EQ(2 * boundary, wheel.next_wake_up_nts());
+                wheel.advance_nts(2 * boundary + 4, due);
+                EXPECT_TRUE(due.empty());
+                EXPECT_EQ(0u, wheel.occupied_[2][0] & (1u << 2));
+                wheel.advance_nts(2 * boundary + 5, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(3)}, events(due));
+                EXPECT_EQ(0u, wheel.size_);
+            }
+
+            /*!
+             * @fn TEST(TimerWheelTests, DeadlineBeyondMaxDelta)
+             * @brief This test checks that an event beyond the range of the wheel waits in its last level and
+             * is placed again when that slot is cascaded, without being notified early.
+             */
+            TEST(TimerWheelTests, DeadlineBeyondMaxDelta)
+            {
+                asio::io_service service;
+                TimerWheel& wheel = asio::use_service<TimerWheel>(service);
+                TimerWheelNode node;
+                node.event = tag(0);
+
+                const uint64_t range = static_cast<uint64_t>(1) << 32;
+                wheel.next_tick_ = 10;
+                wheel.schedule(node, wheel.origin_ + std::chrono::milliseconds(range + 1000));
+                EXPECT_EQ(range + 1000, node.expiry);
+                // Clamped to the farthest slot, the first one of the next turn of the last level.
+                ASSERT_NE(0u, wheel.occupied_[3][0] & 1u);
+                EXPECT_EQ(range, wheel.next_wake_up_nts());
+
+                // Nothing else is in the wheel, skip the ticks before the cascade.
+                DueEvents due;
+                wheel.next_tick_ = range - 1;
+                wheel.advance_nts(range, due);
+                EXPECT_TRUE(due.empty());
+                EXPECT_EQ(0u, wheel.occupied_[3][0] & 1u);
+                // Now in the second level, cascaded at the start of the window of its tick.
+                EXPECT_EQ(range + 3 * 256, wheel.next_wake_up_nts());
+
+                wheel.advance_nts(range + 999, due);
+                EXPECT_TRUE(due.empty());
+                wheel.advance_nts(range + 1000, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(0)}, events(due));
+                EXPECT_EQ(0u, wheel.size_);
+            }
+
+            /*!
+             * @fn TEST(TimerWheelTests, CancelLastNodeClearsSlot)
+             * @brief This test checks that a slot is marked empty only when its last event is cancelled, so
+             * no wake-up is scheduled for it.
+             */
+            TEST(TimerWheelTests, CancelLastNodeClearsSlot)
+            {
+                asio::io_service service;
+                TimerWheel& wheel = asio::use_service<TimerWheel>(service);
+                TimerWheelNode nodes[3];
+                for(int i = 0; i < 3; ++i)
+                {
+                    nodes[i].event = tag(i);
+                }
+
+                EXPECT_FALSE(wheel.cancel(nodes[0]));
+
+                wheel.next_tick_ = 100;
+                wheel.schedule(nodes[0], wheel.origin_ + std::chrono::milliseconds(150));
+                wheel.schedule(nodes[1], wheel.origin_ + std::chrono::milliseconds(150));
+                wheel.schedule(nodes[2], wheel.origin_ + std::chrono::milliseconds(600));
+                EXPECT_EQ(150u, wheel.next_wake_up_nts());
+
+                EXPECT_TRUE(wheel.cancel(nodes[0]));
+                EXPECT_FALSE(wheel.cancel(nodes[0]));
+                EXPECT_NE(0u, wheel.occupied_[0][150 / 64] & (static_cast<uint64_t>(1) << (150 % 64)));
+                EXPECT_EQ(150u, wheel.next_wake_up_nts());
+
+                EXPECT_TRUE(wheel.cancel(nodes[1]));
+                EXPECT_EQ(0u, wheel.occupied_[0][150 / 64]);
+                EXPECT_EQ(512u, wheel.next_wake_up_nts());
+
+                EXPECT_TRUE(wheel.cancel(nodes[2]));
+                EXPECT_EQ(0u, wheel.occupied_[1][0]);
+                EXPECT_EQ(0u, wheel.size_);
+                EXPECT_EQ(0u, wheel.next_wake_up_nts());
+
+                // A cancelled node can be scheduled again.
+                wheel.schedule(nodes[1], wheel.origin_ + std::chrono::milliseconds(120));
+                DueEvents due;
+                wheel.advance_nts(150, due);
+                EXPECT_EQ(std::vector<TimedEventImpl*>{tag(1)}, events(due));
+            }
+        }
+    }
+}
+
+class TimerWheelEnvironment
+{
+    public:
+
+        TimerWheelEnvironment() : work_(new asio::io_service::work(service_)),
+            thread_(&TimerWheelEnvironment::run, this) {}
+
+        ~TimerWheelEnvironment()
+        {
+            stop();
+        }
+
+        void run()
+        {
+            service_.run();
+        }
+
+        void stop()
+        {
+            if(thread_.joinable())
+            {
+                work_.reset();
+                service_.stop();
+                thread_.join();
+            }
+        }
+
+        asio::io_service service_;
+
+        std::unique_ptr<asio::io_service::work> work_;
+
+        std::thread thread_;
+};
+
+/*!
+ * @fn TEST(TimerWheelTests, RestartFromCallback)
+ * @brief This test checks that an event restarted from its own notification is scheduled again, while the
+ * wheel notifies the events collected in the same wake-up.
+ */
+TEST(TimerWheelTests, RestartFromCallback)
+{
+    TimerWheelEnvironment env;
+    {
+        MockEvent restarted(env.service_, env.thread_, 5, true);
+        MockEvent other(env.service_, env.thread_, 5, false);
+
+        restarted.restart_timer();
+        other.restart_timer();
+        for(int i = 0; i < 10; ++i)
+        {
+            ASSERT_TRUE(restarted.wait(1000));
+        }
+        ASSERT_TRUE(other.wait(1000));
+
+        EXPECT_GE(restarted.successed_.load(std::memory_order_relaxed), 10);
+        EXPECT_EQ(1, other.successed_.load(std::memory_order_relaxed));
+        EXPECT_EQ(0, restarted.cancelled_.load(std::memory_order_relaxed));
+    }
+    env.stop();
+}
+
+/*!
+ * @fn TEST(TimerWheelTests, ShutdownWithPendingEvents)
+ * @brief This test checks that pending events are not notified once the wheel is shut down, and that they can
+ * still be cancelled, restarted and destroyed.
+ */
+TEST(TimerWheelTests, ShutdownWithPendingEvents)
+{
+    TimerWheelEnvironment env;
+    {
+        MockEvent soon(env.service_, env.thread_, 20, false);
+        MockEvent late(env.service_, env.thread_, 10000, false);
+
+        soon.restart_timer();
+        late.restart_timer();
+        asio::use_service<eprosima::fastrtps::rtps::TimerWheel>(env.service_).shutdown();
+
+        EXPECT_FALSE(soon.wait(200));
+        EXPECT_EQ(0, soon.successed_.load(std::memory_order_relaxed));
+
+        // Events can still be cancelled and restarted, they are not notified anymore.
+        soon.cancel_timer();
+        ASSERT_TRUE(soon.wait(1000));
+        EXPECT_EQ(1, soon.cancelled_.load(std::memory_order_relaxed));
+        soon.restart_timer();
+        EXPECT_FALSE(soon.wait(100));
+        EXPECT_EQ(0, soon.successed_.load(std::memory_order_relaxed));
+
+        // The late event is destroyed while it is still in the wheel.
+    }
+    env.stop();
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
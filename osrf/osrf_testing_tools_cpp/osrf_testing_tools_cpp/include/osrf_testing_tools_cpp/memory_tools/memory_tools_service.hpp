@@ -15,6 +15,8 @@
 #ifndef OSRF_TESTING_TOOLS_CPP__MEMORY_TOOLS__MEMORY_TOOLS_SERVICE_HPP_
 #define OSRF_TESTING_TOOLS_CPP__MEMORY_TOOLS__MEMORY_TOOLS_SERVICE_HPP_
 
+#include <cstddef>
+
 #include "./stack_trace.hpp"
 #include "./visibility_control.hpp"
 
@@ -77,6 +79,15 @@ struct MemoryToolsService
   const char *
   get_memory_function_type_str() const;
 
+  /// Return the number of bytes requested by the memory function.
+  /**
+   * For realloc this is the new size of the block, for calloc the element
+   * count times the element size, and for free it is always 0.
+   */
+  OSRF_TESTING_TOOLS_CPP_MEMORY_TOOLS_PUBLIC
+  size_t
+  get_requested_size() const;
+
   /// If called last, no log message for the dynamic memory event will be logged.
   OSRF_TESTING_TOOLS_CPP_MEMORY_TOOLS_PUBLIC
   void
@@ -110,7 +121,8 @@ struct MemoryToolsService
 protected:
   explicit MemoryToolsService(
     MemoryFunctionType memory_function_type,
-    const char * source_function_name);
+    const char * source_function_name,
+    size_t requested_size = 0);
 
   std::shared_ptr<MemoryToolsServiceImpl> impl_;
 
@@ -66,7 +66,8 @@ custom_malloc_with_original_except(
   ScopedImplementationSection section;
 
   using osrf_testing_tools_cpp::memory_tools::MemoryToolsServiceFactory;
-  MemoryToolsServiceFactory factory(MemoryFunctionType::Malloc, replacement_malloc_function_name);
+  MemoryToolsServiceFactory factory(
+    MemoryFunctionType::Malloc, replacement_malloc_function_name, size);
   osrf_testing_tools_cpp::memory_tools::dispatch_malloc(factory.get_memory_tools_service());
 
   void * memory = original_malloc(size);
@@ -137,7 +138,8 @@ custom_realloc_with_original_except(
   using osrf_testing_tools_cpp::memory_tools::MemoryToolsServiceFactory;
   MemoryToolsServiceFactory factory(
     MemoryFunctionType::Realloc,
-    replacement_realloc_function_name);
+    replacement_realloc_function_name,
+    size);
   osrf_testing_tools_cpp::memory_tools::dispatch_realloc(factory.get_memory_tools_service());
 
   void * memory = original_realloc(memory_in, size);
@@ -208,7 +210,8 @@ custom_calloc_with_original_except(
   ScopedImplementationSection section;
 
   using osrf_testing_tools_cpp::memory_tools::MemoryToolsServiceFactory;
-  MemoryToolsServiceFactory factory(MemoryFunctionType::Calloc, replacement_calloc_function_name);
+  MemoryToolsServiceFactory factory(
+    MemoryFunctionType::Calloc, replacement_calloc_function_name, count * size);
   osrf_testing_tools_cpp::memory_tools::dispatch_calloc(factory.get_memory_tools_service());
 
   void * memory = original_calloc(count, size);
@@ -28,8 +28,9 @@ namespace memory_tools
 
 MemoryToolsService::MemoryToolsService(
   MemoryFunctionType memory_function_type,
-  const char * source_function_name)
-: impl_(new MemoryToolsServiceImpl(memory_function_type, source_function_name))
+  const char * source_function_name,
+  size_t requested_size)
+: impl_(new MemoryToolsServiceImpl(memory_function_type, source_function_name, requested_size))
 {
   switch(get_verbosity_level()) {
     case VerbosityLevel::quiet:
@@ -75,6 +76,12 @@ MemoryToolsService::get_memory_function_type_str() const
   }
 }
 
+size_t
+MemoryToolsService::get_requested_size() const
+{
+  return impl_->requested_size;
+}
+
 void
 MemoryToolsService::ignore()
 {
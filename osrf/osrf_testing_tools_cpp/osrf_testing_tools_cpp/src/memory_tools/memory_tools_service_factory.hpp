@@ -28,8 +28,9 @@ class MemoryToolsServiceFactory
 public:
   MemoryToolsServiceFactory(
     MemoryFunctionType memory_function_type,
-    const char * source_function_name)
-  : service_(memory_function_type, source_function_name)
+    const char * source_function_name,
+    size_t requested_size = 0)
+  : service_(memory_function_type, source_function_name, requested_size)
   {}
 
   MemoryToolsService &
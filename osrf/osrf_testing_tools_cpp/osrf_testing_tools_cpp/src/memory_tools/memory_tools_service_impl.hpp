@@ -15,6 +15,7 @@
 #ifndef MEMORY_TOOLS__MEMORY_TOOLS_SERVICE_IMPL_HPP_
 #define MEMORY_TOOLS__MEMORY_TOOLS_SERVICE_IMPL_HPP_
 
+#include <cstddef>
 #include <memory>
 
 #include "osrf_testing_tools_cpp/memory_tools/memory_tools_service.hpp"
@@ -29,14 +30,17 @@ class MemoryToolsServiceImpl
 public:
   MemoryToolsServiceImpl(
     MemoryFunctionType memory_function_type_in,
-    const char * source_function_name_in)
+    const char * source_function_name_in,
+    size_t requested_size_in)
   : memory_function_type(memory_function_type_in),
     source_function_name(source_function_name_in),
+    requested_size(requested_size_in),
     lazy_stack_trace(nullptr)
   {}
 
   MemoryFunctionType memory_function_type;
   const char * source_function_name;
+  size_t requested_size;
 
   bool ignored;
   bool should_print_backtrace;
@@ -149,6 +149,66 @@ TEST(TestMemoryTools, test_allocation_checking_tools) {
   EXPECT_EQ(4u, unexpected_frees);
 }
 
+/**
+ * Tests the requested size given to the callbacks.
+ */
+TEST(TestMemoryTools, test_requested_size) {
+  osrf_testing_tools_cpp::memory_tools::initialize();
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    osrf_testing_tools_cpp::memory_tools::uninitialize();
+  });
+
+  using osrf_testing_tools_cpp::memory_tools::MemoryToolsService;
+  bool recording = false;
+  size_t malloc_size = 0;
+  size_t realloc_size = 0;
+  size_t calloc_size = 0;
+  size_t free_size = 1;
+  osrf_testing_tools_cpp::memory_tools::on_malloc(
+    [&recording, &malloc_size](MemoryToolsService & service) {
+      if (recording) {
+        malloc_size = service.get_requested_size();
+      }
+      service.ignore();
+    });
+  osrf_testing_tools_cpp::memory_tools::on_realloc(
+    [&recording, &realloc_size](MemoryToolsService & service) {
+      if (recording) {
+        realloc_size = service.get_requested_size();
+      }
+      service.ignore();
+    });
+  osrf_testing_tools_cpp::memory_tools::on_calloc(
+    [&recording, &calloc_size](MemoryToolsService & service) {
+      if (recording) {
+        calloc_size = service.get_requested_size();
+      }
+      service.ignore();
+    });
+  osrf_testing_tools_cpp::memory_tools::on_free(
+    [&recording, &free_size](MemoryToolsService & service) {
+      if (recording) {
+        free_size = service.get_requested_size();
+      }
+      service.ignore();
+    });
+
+  osrf_testing_tools_cpp::memory_tools::enable_monitoring();
+  recording = true;
+  void * mem = malloc(1024);
+  void * remem = realloc(mem, 2048);
+  free(remem);
+  mem = calloc(16, 8);
+  free(mem);
+  recording = false;
+  osrf_testing_tools_cpp::memory_tools::disable_monitoring();
+
+  EXPECT_EQ(1024u, malloc_size);
+  EXPECT_EQ(2048u, realloc_size);
+  EXPECT_EQ(128u, calloc_size);
+  EXPECT_EQ(0u, free_size);
+}
+
 void my_first_function(const std::string& str)
 {
   osrf_testing_tools_cpp::memory_tools::guaranteed_malloc(str);
@@ -36,6 +36,7 @@
 #include <cstdio>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <typeinfo>
 #include <utility>
@@ -108,6 +109,7 @@ LibraryVector & getLoadedLibraryVector();
 /**
  * @brief When a library is being loaded, in order for factories to know which library they are being associated with, they use this function to query which library is being loaded.
  * @return The currently set loading library name as a string
+ * @note The library name is specific to the calling thread, as libraries may be loaded concurrently by several threads.
  */
 CLASS_LOADER_PUBLIC
 std::string getCurrentlyLoadingLibraryName();
@@ -123,6 +125,7 @@ void setCurrentlyLoadingLibraryName(const std::string & library_name);
 /**
  * @brief Gets the ClassLoader currently in scope which used when a library is being loaded.
  * @return A pointer to the currently active ClassLoader.
+ * @note The ClassLoader is specific to the calling thread, as libraries may be loaded concurrently by several threads.
  */
 CLASS_LOADER_PUBLIC
 ClassLoader * getCurrentlyActiveClassLoader();
@@ -137,6 +140,7 @@ void setCurrentlyActiveClassLoader(ClassLoader * loader);
 
 /**
  * @brief This function extracts a reference to the FactoryMap for appropriate base class out of the global plugin base to factory map. This function should be used by functions in this namespace that need to access the various factories so as to make sure the right key is generated to index into the global map.
+ * @note The mutex returned by getPluginBaseToFactoryMapMapMutex() must be locked exclusively by the caller.
  * @return A reference to the FactoryMap contained within the global Base-to-FactoryMap map.
  */
 CLASS_LOADER_PUBLIC
@@ -153,13 +157,74 @@ FactoryMap & getFactoryMapForBaseClass()
 }
 
 /**
- * @brief To provide thread safety, all exposed plugin functions can only be run serially by multiple threads. This is implemented by using critical sections enforced by a single mutex which is locked and released with the following two functions
+ * @brief Gets a handle to the FactoryMap of a base class, creating it if needed. FactoryMaps are never removed from the global map, so the handle stays valid for the lifetime of the process.
+ * @param typeid_base_class_name - The name of the base class as returned by typeid(Base).name()
+ * @return A pointer to the FactoryMap, to be passed to the functions below.
+ */
+CLASS_LOADER_PUBLIC
+FactoryMap * getFactoryMapHandle(const std::string & typeid_base_class_name);
+
+/**
+ * @brief Same as above but uses a type parameter, the handle is looked up once per base class.
+ * @return A pointer to the FactoryMap, to be passed to the functions below.
+ */
+template<typename Base>
+FactoryMap * getFactoryMapHandle()
+{
+  static FactoryMap * const factory_map = getFactoryMapHandle(typeid(Base).name());
+  return factory_map;
+}
+
+/**
+ * @brief Inserts a factory into a FactoryMap, replacing (and warning about) any factory previously registered for the same class name.
+ * @param factory_map - The handle to the FactoryMap of the base class of the factory
+ * @param meta_obj - The factory, with its owning ClassLoader and library path already set
+ */
+CLASS_LOADER_PUBLIC
+void insertMetaObject(FactoryMap * factory_map, AbstractMetaObjectBase * meta_obj);
+
+/**
+ * @brief Finds the factory for a class.
+ * @param factory_map - The handle to the FactoryMap of the base class
+ * @param class_name - The name of the derived class (unmangled)
+ * @param loader - The ClassLoader whose scope we are within
+ * @param is_owned_by_loader - Set to true if the factory is owned by loader
+ * @param has_no_owner - Set to true if the factory isn't owned by any ClassLoader
+ * @return The factory, or nullptr if no factory exists for the class.
+ */
+CLASS_LOADER_PUBLIC
+AbstractMetaObjectBase * findMetaObject(
+  FactoryMap * factory_map, const std::string & class_name, const ClassLoader * loader,
+  bool & is_owned_by_loader, bool & has_no_owner);
+
+/**
+ * @brief Returns the classes of a FactoryMap owned by a ClassLoader, followed by the classes not owned by any ClassLoader.
+ * @param factory_map - The handle to the FactoryMap of the base class
+ * @param loader - The ClassLoader whose scope we are within
+ * @return A vector of class names
+ */
+CLASS_LOADER_PUBLIC
+std::vector<std::string> getAvailableClasses(FactoryMap * factory_map, const ClassLoader * loader);
+
+/**
+ * @brief Indicates if a class of a FactoryMap is owned by a ClassLoader, or by no ClassLoader at all.
+ * @param factory_map - The handle to the FactoryMap of the base class
+ * @param class_name - The name of the derived class (unmangled)
+ * @param loader - The ClassLoader whose scope we are within
+ * @return true if the class can be created within the scope of loader
+ */
+CLASS_LOADER_PUBLIC
+bool isClassAvailable(
+  FactoryMap * factory_map, const std::string & class_name, const ClassLoader * loader);
+
+/**
+ * @brief The factories are read far more often than they change: creating instances and querying classes take the factory map mutex in shared mode, loading and unloading libraries take it exclusively. The loaded library vector is protected in the same way by its own mutex. Neither mutex is held while a library is opened, so that several libraries can be loaded concurrently.
  * @return A reference to the global mutex
  */
 CLASS_LOADER_PUBLIC
-std::recursive_mutex & getLoadedLibraryVectorMutex();
+std::shared_timed_mutex & getLoadedLibraryVectorMutex();
 CLASS_LOADER_PUBLIC
-std::recursive_mutex & getPluginBaseToFactoryMapMapMutex();
+std::shared_timed_mutex & getPluginBaseToFactoryMapMapMutex();
 
 /**
  * @brief Indicates if a library containing more than just plugins has been opened by the running process
@@ -224,21 +289,7 @@ void registerPlugin(const std::string & class_name, const std::string & base_cla
 
 
   // Add it to global factory map map
-  getPluginBaseToFactoryMapMapMutex().lock();
-  FactoryMap & factoryMap = getFactoryMapForBaseClass<Base>();
-  if (factoryMap.find(class_name) != factoryMap.end()) {
-    CONSOLE_BRIDGE_logWarn(
-      "class_loader.impl: SEVERE WARNING!!! "
-      "A namespace collision has occured with plugin factory for class %s. "
-      "New factory will OVERWRITE existing one. "
-      "This situation occurs when libraries containing plugins are directly linked against an "
-      "executable (the one running right now generating this message). "
-      "Please separate plugins out into their own library or just don't link against the library "
-      "and use either class_loader::ClassLoader/MultiLibraryClassLoader to open.",
-      class_name.c_str());
-  }
-  factoryMap[class_name] = new_factory;
-  getPluginBaseToFactoryMapMapMutex().unlock();
+  insertMetaObject(getFactoryMapHandle<Base>(), new_factory);
 
   CONSOLE_BRIDGE_logDebug(
     "class_loader.impl: "
@@ -255,25 +306,23 @@ void registerPlugin(const std::string & class_name, const std::string & base_cla
 template<typename Base>
 Base * createInstance(const std::string & derived_class_name, ClassLoader * loader)
 {
-  AbstractMetaObject<Base> * factory = nullptr;
-
-  getPluginBaseToFactoryMapMapMutex().lock();
-  FactoryMap & factoryMap = getFactoryMapForBaseClass<Base>();
-  if (factoryMap.find(derived_class_name) != factoryMap.end()) {
-    factory = dynamic_cast<impl::AbstractMetaObject<Base> *>(factoryMap[derived_class_name]);
-  } else {
+  bool is_owned_by_loader = false;
+  bool has_no_owner = false;
+  AbstractMetaObject<Base> * factory = dynamic_cast<impl::AbstractMetaObject<Base> *>(
+    findMetaObject(
+      getFactoryMapHandle<Base>(), derived_class_name, loader, is_owned_by_loader, has_no_owner));
+  if (nullptr == factory) {
     CONSOLE_BRIDGE_logError(
       "class_loader.impl: No metaobject exists for class type %s.", derived_class_name.c_str());
   }
-  getPluginBaseToFactoryMapMapMutex().unlock();
 
   Base * obj = nullptr;
-  if (factory != nullptr && factory->isOwnedBy(loader)) {
+  if (factory != nullptr && is_owned_by_loader) {
     obj = factory->create();
   }
 
   if (nullptr == obj) {  // Was never created
-    if (factory && factory->isOwnedBy(nullptr)) {
+    if (factory && has_no_owner) {
       CONSOLE_BRIDGE_logDebug("%s",
         "class_loader.impl: ALERT!!! "
         "A metaobject (i.e. factory) exists for desired class, but has no owner. "
@@ -307,25 +356,21 @@ Base * createInstance(const std::string & derived_class_name, ClassLoader * load
 template<typename Base>
 std::vector<std::string> getAvailableClasses(const ClassLoader * loader)
 {
-  std::lock_guard<std::recursive_mutex> lock(getPluginBaseToFactoryMapMapMutex());
-
-  FactoryMap & factory_map = getFactoryMapForBaseClass<Base>();
-  std::vector<std::string> classes;
-  std::vector<std::string> classes_with_no_owner;
-
-  for (auto & it : factory_map) {
-    AbstractMetaObjectBase * factory = it.second;
-    if (factory->isOwnedBy(loader)) {
-      classes.push_back(it.first);
-    } else if (factory->isOwnedBy(nullptr)) {
-      classes_with_no_owner.push_back(it.first);
-    }
-  }
-
   // Added classes not associated with a class loader (Which can happen through
-  // an unexpected dlopen() to the library)
-  classes.insert(classes.end(), classes_with_no_owner.begin(), classes_with_no_owner.end());
-  return classes;
+  // an unexpected dlopen() to the library) come last
+  return getAvailableClasses(getFactoryMapHandle<Base>(), loader);
+}
+
+/**
+ * @brief Indicates if a class derived from Base can be created within scope of the passed ClassLoader.
+ * @param class_name - The name of the derived class (unmangled)
+ * @param loader - The pointer to the ClassLoader whose scope we are within
+ * @return true if the class is available, otherwise false
+ */
+template<typename Base>
+bool isClassAvailable(const std::string & class_name, const ClassLoader * loader)
+{
+  return isClassAvailable(getFactoryMapHandle<Base>(), class_name, loader);
 }
 
 /**
@@ -32,9 +32,13 @@
 
 #include <Poco/SharedLibrary.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace class_loader
@@ -44,18 +48,26 @@ namespace impl
 
 // Global data
 
-std::recursive_mutex & getLoadedLibraryVectorMutex()
+std::shared_timed_mutex & getLoadedLibraryVectorMutex()
 {
-  static std::recursive_mutex m;
+  static std::shared_timed_mutex m;
   return m;
 }
 
-std::recursive_mutex & getPluginBaseToFactoryMapMapMutex()
+std::shared_timed_mutex & getPluginBaseToFactoryMapMapMutex()
 {
-  static std::recursive_mutex m;
+  static std::shared_timed_mutex m;
   return m;
 }
 
+std::recursive_mutex & getLibraryMutex(const std::string & library_path)
+{
+  static std::mutex m;
+  static std::map<LibraryPath, std::recursive_mutex> library_mutexes;
+  std::lock_guard<std::mutex> lock(m);
+  return library_mutexes[library_path];
+}
+
 BaseToFactoryMapMap & getGlobalPluginBaseToFactoryMapMap()
 {
   static BaseToFactoryMapMap instance;
@@ -64,13 +76,51 @@ BaseToFactoryMapMap & getGlobalPluginBaseToFactoryMapMap()
 
 FactoryMap & getFactoryMapForBaseClass(const std::string & typeid_base_class_name)
 {
-  BaseToFactoryMapMap & factoryMapMap = getGlobalPluginBaseToFactoryMapMap();
-  std::string base_class_name = typeid_base_class_name;
-  if (factoryMapMap.find(base_class_name) == factoryMapMap.end()) {
-    factoryMapMap[base_class_name] = FactoryMap();
+  return getGlobalPluginBaseToFactoryMapMap()[typeid_base_class_name];
+}
+
+FactoryMap * getFactoryMapHandle(const std::string & typeid_base_class_name)
+{
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+    BaseToFactoryMapMap & factory_map_map = getGlobalPluginBaseToFactoryMapMap();
+    BaseToFactoryMapMap::iterator it = factory_map_map.find(typeid_base_class_name);
+    if (it != factory_map_map.end()) {
+      return &it->second;
+    }
   }
+  std::lock_guard<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+  return &getFactoryMapForBaseClass(typeid_base_class_name);
+}
 
-  return factoryMapMap[base_class_name];
+// The MetaObjects of the global factory maps indexed by library, so that loading and unloading a
+// library doesn't have to walk the factories of every library.
+// Protected by the plugin base to factory map map mutex.
+typedef std::map<LibraryPath, MetaObjectVector> LibraryToMetaObjectsMap;
+
+LibraryToMetaObjectsMap & getLibraryToMetaObjectsMap()
+{
+  static LibraryToMetaObjectsMap instance;
+  return instance;
+}
+
+void addMetaObjectToLibraryIndex(AbstractMetaObjectBase * meta_obj)
+{
+  getLibraryToMetaObjectsMap()[meta_obj->getAssociatedLibraryPath()].push_back(meta_obj);
+}
+
+void removeMetaObjectFromLibraryIndex(AbstractMetaObjectBase * meta_obj)
+{
+  LibraryToMetaObjectsMap & index = getLibraryToMetaObjectsMap();
+  LibraryToMetaObjectsMap::iterator it = index.find(meta_obj->getAssociatedLibraryPath());
+  if (it == index.end()) {
+    return;
+  }
+  MetaObjectVector & meta_objs = it->second;
+  meta_objs.erase(std::remove(meta_objs.begin(), meta_objs.end(), meta_obj), meta_objs.end());
+  if (meta_objs.empty()) {
+    index.erase(it);
+  }
 }
 
 MetaObjectVector & getMetaObjectGraveyard()
@@ -87,7 +137,7 @@ LibraryVector & getLoadedLibraryVector()
 
 std::string & getCurrentlyLoadingLibraryNameReference()
 {
-  static std::string library_name;
+  static thread_local std::string library_name;
   return library_name;
 }
 
@@ -104,7 +154,7 @@ void setCurrentlyLoadingLibraryName(const std::string & library_name)
 
 ClassLoader * & getCurrentlyActiveClassLoaderReference()
 {
-  static ClassLoader * loader = nullptr;
+  static thread_local ClassLoader * loader = nullptr;
   return loader;
 }
 
@@ -119,9 +169,9 @@ void setCurrentlyActiveClassLoader(ClassLoader * loader)
   loader_ref = loader;
 }
 
-bool & hasANonPurePluginLibraryBeenOpenedReference()
+std::atomic<bool> & hasANonPurePluginLibraryBeenOpenedReference()
 {
-  static bool hasANonPurePluginLibraryBeenOpenedReference = false;
+  static std::atomic<bool> hasANonPurePluginLibraryBeenOpenedReference(false);
   return hasANonPurePluginLibraryBeenOpenedReference;
 }
 
@@ -138,6 +188,76 @@ void hasANonPurePluginLibraryBeenOpened(bool hasIt)
 
 // MetaObject search/insert/removal/query
 
+void insertMetaObject(FactoryMap * factory_map, AbstractMetaObjectBase * meta_obj)
+{
+  std::lock_guard<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+
+  FactoryMap::iterator it = factory_map->find(meta_obj->className());
+  if (it != factory_map->end()) {
+    CONSOLE_BRIDGE_logWarn(
+      "class_loader.impl: SEVERE WARNING!!! "
+      "A namespace collision has occured with plugin factory for class %s. "
+      "New factory will OVERWRITE existing one. "
+      "This situation occurs when libraries containing plugins are directly linked against an "
+      "executable (the one running right now generating this message). "
+      "Please separate plugins out into their own library or just don't link against the library "
+      "and use either class_loader::ClassLoader/MultiLibraryClassLoader to open.",
+      meta_obj->className().c_str());
+    removeMetaObjectFromLibraryIndex(it->second);
+    it->second = meta_obj;
+  } else {
+    factory_map->insert(std::make_pair(meta_obj->className(), meta_obj));
+  }
+  addMetaObjectToLibraryIndex(meta_obj);
+}
+
+AbstractMetaObjectBase * findMetaObject(
+  FactoryMap * factory_map, const std::string & class_name, const ClassLoader * loader,
+  bool & is_owned_by_loader, bool & has_no_owner)
+{
+  std::shared_lock<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+
+  FactoryMap::const_iterator it = factory_map->find(class_name);
+  if (it == factory_map->end()) {
+    is_owned_by_loader = false;
+    has_no_owner = false;
+    return nullptr;
+  }
+  is_owned_by_loader = it->second->isOwnedBy(loader);
+  has_no_owner = it->second->isOwnedBy(nullptr);
+  return it->second;
+}
+
+std::vector<std::string> getAvailableClasses(FactoryMap * factory_map, const ClassLoader * loader)
+{
+  std::shared_lock<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+
+  std::vector<std::string> classes;
+  std::vector<std::string> classes_with_no_owner;
+
+  for (auto & it : *factory_map) {
+    AbstractMetaObjectBase * factory = it.second;
+    if (factory->isOwnedBy(loader)) {
+      classes.push_back(it.first);
+    } else if (factory->isOwnedBy(nullptr)) {
+      classes_with_no_owner.push_back(it.first);
+    }
+  }
+
+  classes.insert(classes.end(), classes_with_no_owner.begin(), classes_with_no_owner.end());
+  return classes;
+}
+
+bool isClassAvailable(
+  FactoryMap * factory_map, const std::string & class_name, const ClassLoader * loader)
+{
+  std::shared_lock<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+
+  FactoryMap::const_iterator it = factory_map->find(class_name);
+  return it != factory_map->end() &&
+         (it->second->isOwnedBy(loader) || it->second->isOwnedBy(nullptr));
+}
+
 MetaObjectVector allMetaObjects(const FactoryMap & factories)
 {
   MetaObjectVector all_meta_objs;
@@ -153,7 +273,7 @@ MetaObjectVector allMetaObjects(const FactoryMap & factories)
 
 MetaObjectVector allMetaObjects()
 {
-  std::lock_guard<std::recursive_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+  std::shared_lock<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
 
   MetaObjectVector all_meta_objs;
   BaseToFactoryMapMap & factory_map_map = getGlobalPluginBaseToFactoryMapMap();
@@ -165,47 +285,14 @@ MetaObjectVector allMetaObjects()
   return all_meta_objs;
 }
 
-MetaObjectVector
-filterAllMetaObjectsOwnedBy(const MetaObjectVector & to_filter, const ClassLoader * owner)
-{
-  MetaObjectVector filtered_objs;
-  for (auto & f : to_filter) {
-    if (f->isOwnedBy(owner)) {
-      filtered_objs.push_back(f);
-    }
-  }
-  return filtered_objs;
-}
-
-MetaObjectVector
-filterAllMetaObjectsAssociatedWithLibrary(
-  const MetaObjectVector & to_filter, const std::string & library_path)
-{
-  MetaObjectVector filtered_objs;
-  for (auto & f : to_filter) {
-    if (f->getAssociatedLibraryPath() == library_path) {
-      filtered_objs.push_back(f);
-    }
-  }
-  return filtered_objs;
-}
-
-MetaObjectVector
-allMetaObjectsForClassLoader(const ClassLoader * owner)
-{
-  return filterAllMetaObjectsOwnedBy(allMetaObjects(), owner);
-}
-
 MetaObjectVector
 allMetaObjectsForLibrary(const std::string & library_path)
 {
-  return filterAllMetaObjectsAssociatedWithLibrary(allMetaObjects(), library_path);
-}
+  std::shared_lock<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
 
-MetaObjectVector
-allMetaObjectsForLibraryOwnedBy(const std::string & library_path, const ClassLoader * owner)
-{
-  return filterAllMetaObjectsOwnedBy(allMetaObjectsForLibrary(library_path), owner);
+  LibraryToMetaObjectsMap & index = getLibraryToMetaObjectsMap();
+  LibraryToMetaObjectsMap::const_iterator it = index.find(library_path);
+  return it != index.end() ? it->second : MetaObjectVector();
 }
 
 void insertMetaObjectIntoGraveyard(AbstractMetaObjectBase * meta_obj)
@@ -218,43 +305,9 @@ void insertMetaObjectIntoGraveyard(AbstractMetaObjectBase * meta_obj)
   getMetaObjectGraveyard().push_back(meta_obj);
 }
 
-void destroyMetaObjectsForLibrary(
-  const std::string & library_path, FactoryMap & factories, const ClassLoader * loader)
-{
-  FactoryMap::iterator factory_itr = factories.begin();
-  while (factory_itr != factories.end()) {
-    AbstractMetaObjectBase * meta_obj = factory_itr->second;
-    if (meta_obj->getAssociatedLibraryPath() == library_path && meta_obj->isOwnedBy(loader)) {
-      meta_obj->removeOwningClassLoader(loader);
-      if (!meta_obj->isOwnedByAnybody()) {
-        FactoryMap::iterator factory_itr_copy = factory_itr;
-        factory_itr++;
-        // TODO(mikaelarguedas) fix this when branching out for melodic
-        // Note: map::erase does not return iterator like vector::erase does.
-        // Hence the ugliness of this code and a need for copy. Should be fixed in next C++ revision
-        factories.erase(factory_itr_copy);
-
-        // Insert into graveyard
-        // We remove the metaobject from its factory map, but we don't destroy it...instead it
-        // saved to a "graveyard" to the side.
-        // This is due to our static global variable initialization problem that causes factories
-        // to not be registered when a library is closed and then reopened.
-        // This is because it's truly not closed due to the use of global symbol binding i.e.
-        // calling dlopen with RTLD_GLOBAL instead of RTLD_LOCAL.
-        // We require using the former as the which is required to support RTTI
-        insertMetaObjectIntoGraveyard(meta_obj);
-      } else {
-        ++factory_itr;
-      }
-    } else {
-      ++factory_itr;
-    }
-  }
-}
-
 void destroyMetaObjectsForLibrary(const std::string & library_path, const ClassLoader * loader)
 {
-  std::lock_guard<std::recursive_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+  std::lock_guard<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
 
   CONSOLE_BRIDGE_logDebug(
     "class_loader.impl: "
@@ -262,10 +315,32 @@ void destroyMetaObjectsForLibrary(const std::string & library_path, const ClassL
     "plugin-to-factorymap map.\n",
     library_path.c_str(), reinterpret_cast<const void *>(loader));
 
-  // We have to walk through all FactoryMaps to be sure
-  BaseToFactoryMapMap & factory_map_map = getGlobalPluginBaseToFactoryMapMap();
-  for (auto & it : factory_map_map) {
-    destroyMetaObjectsForLibrary(library_path, it.second, loader);
+  LibraryToMetaObjectsMap & index = getLibraryToMetaObjectsMap();
+  LibraryToMetaObjectsMap::const_iterator it = index.find(library_path);
+  if (it == index.end()) {
+    return;
+  }
+  // Copied, as the index entry is modified (and maybe erased) while iterating
+  MetaObjectVector meta_objs = it->second;
+  for (auto & meta_obj : meta_objs) {
+    if (!meta_obj->isOwnedBy(loader)) {
+      continue;
+    }
+    meta_obj->removeOwningClassLoader(loader);
+    if (!meta_obj->isOwnedByAnybody()) {
+      getFactoryMapForBaseClass(meta_obj->typeidBaseClassName()).erase(meta_obj->className());
+      removeMetaObjectFromLibraryIndex(meta_obj);
+
+      // Insert into graveyard
+      // We remove the metaobject from its factory map, but we don't destroy it...instead it
+      // saved to a "graveyard" to the side.
+      // This is due to our static global variable initialization problem that causes factories
+      // to not be registered when a library is closed and then reopened.
+      // This is because it's truly not closed due to the use of global symbol binding i.e.
+      // calling dlopen with RTLD_GLOBAL instead of RTLD_LOCAL.
+      // We require using the former as the which is required to support RTTI
+      insertMetaObjectIntoGraveyard(meta_obj);
+    }
   }
 
   CONSOLE_BRIDGE_logDebug("%s", "class_loader.impl: Metaobjects removed.");
@@ -290,7 +365,7 @@ LibraryVector::iterator findLoadedLibrary(const std::string & library_path)
 
 bool isLibraryLoadedByAnybody(const std::string & library_path)
 {
-  std::lock_guard<std::recursive_mutex> lock(getLoadedLibraryVectorMutex());
+  std::shared_lock<std::shared_timed_mutex> lock(getLoadedLibraryVectorMutex());
 
   LibraryVector & open_libraries = getLoadedLibraryVector();
   LibraryVector::iterator itr = findLoadedLibrary(library_path);
@@ -305,25 +380,22 @@ bool isLibraryLoadedByAnybody(const std::string & library_path)
 
 bool isLibraryLoaded(const std::string & library_path, const ClassLoader * loader)
 {
-  bool is_lib_loaded_by_anyone = isLibraryLoadedByAnybody(library_path);
-  size_t num_meta_objs_for_lib = allMetaObjectsForLibrary(library_path).size();
-  size_t num_meta_objs_for_lib_bound_to_loader =
-    allMetaObjectsForLibraryOwnedBy(library_path, loader).size();
-  bool are_meta_objs_bound_to_loader =
-    (0 == num_meta_objs_for_lib) ? true : (
-    num_meta_objs_for_lib_bound_to_loader <= num_meta_objs_for_lib);
-
-  return is_lib_loaded_by_anyone && are_meta_objs_bound_to_loader;
+  // The MetaObjects of a library loaded by anybody are always bound to a subset of its loaders
+  (void)loader;
+  return isLibraryLoadedByAnybody(library_path);
 }
 
 std::vector<std::string> getAllLibrariesUsedByClassLoader(const ClassLoader * loader)
 {
-  MetaObjectVector all_loader_meta_objs = allMetaObjectsForClassLoader(loader);
+  std::shared_lock<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+
   std::vector<std::string> all_libs;
-  for (auto & meta_obj : all_loader_meta_objs) {
-    std::string lib_path = meta_obj->getAssociatedLibraryPath();
-    if (std::find(all_libs.begin(), all_libs.end(), lib_path) == all_libs.end()) {
-      all_libs.push_back(lib_path);
+  for (auto & it : getLibraryToMetaObjectsMap()) {
+    for (auto & meta_obj : it.second) {
+      if (meta_obj->isOwnedBy(loader)) {
+        all_libs.push_back(it.first);
+        break;
+      }
     }
   }
   return all_libs;
@@ -335,8 +407,14 @@ std::vector<std::string> getAllLibrariesUsedByClassLoader(const ClassLoader * lo
 void addClassLoaderOwnerForAllExistingMetaObjectsForLibrary(
   const std::string & library_path, ClassLoader * loader)
 {
-  MetaObjectVector all_meta_objs = allMetaObjectsForLibrary(library_path);
-  for (auto & meta_obj : all_meta_objs) {
+  std::lock_guard<std::shared_timed_mutex> lock(getPluginBaseToFactoryMapMapMutex());
+
+  LibraryToMetaObjectsMap & index = getLibraryToMetaObjectsMap();
+  LibraryToMetaObjectsMap::const_iterator it = index.find(library_path);
+  if (it == index.end()) {
+    return;
+  }
+  for (auto & meta_obj : it->second) {
     CONSOLE_BRIDGE_logDebug(
       "class_loader.impl: "
       "Tagging existing MetaObject %p (base = %s, derived = %s) with "
@@ -352,7 +430,7 @@ void addClassLoaderOwnerForAllExistingMetaObjectsForLibrary(
 void revivePreviouslyCreateMetaobjectsFromGraveyard(
   const std::string & library_path, ClassLoader * loader)
 {
-  std::lock_guard<std::recursive_mutex> b2fmm_lock(getPluginBaseToFactoryMapMapMutex());
+  std::lock_guard<std::shared_timed_mutex> b2fmm_lock(getPluginBaseToFactoryMapMapMutex());
   MetaObjectVector & graveyard = getMetaObjectGraveyard();
 
   for (auto & obj : graveyard) {
@@ -368,7 +446,14 @@ void revivePreviouslyCreateMetaobjectsFromGraveyard(
       obj->addOwningClassLoader(loader);
       assert(obj->typeidBaseClassName() != "UNSET");
       FactoryMap & factory = getFactoryMapForBaseClass(obj->typeidBaseClassName());
-      factory[obj->className()] = obj;
+      AbstractMetaObjectBase * & factory_obj = factory[obj->className()];
+      if (factory_obj != obj) {
+        if (factory_obj) {
+          removeMetaObjectFromLibraryIndex(factory_obj);
+        }
+        factory_obj = obj;
+        addMetaObjectToLibraryIndex(obj);
+      }
     }
   }
 }
@@ -376,9 +461,14 @@ void revivePreviouslyCreateMetaobjectsFromGraveyard(
 void purgeGraveyardOfMetaobjects(
   const std::string & library_path, ClassLoader * loader, bool delete_objs)
 {
-  MetaObjectVector all_meta_objs = allMetaObjects();
-  // Note: Lock must happen after call to allMetaObjects as that will lock
-  std::lock_guard<std::recursive_mutex> b2fmm_lock(getPluginBaseToFactoryMapMapMutex());
+  std::lock_guard<std::shared_timed_mutex> b2fmm_lock(getPluginBaseToFactoryMapMapMutex());
+
+  // The graveyard only holds MetaObjects of library_path, so they can only be in its index entry
+  LibraryToMetaObjectsMap & index = getLibraryToMetaObjectsMap();
+  LibraryToMetaObjectsMap::const_iterator index_itr = index.find(library_path);
+  const MetaObjectVector no_meta_objs;
+  const MetaObjectVector & lib_meta_objs =
+    index_itr != index.end() ? index_itr->second : no_meta_objs;
 
   MetaObjectVector & graveyard = getMetaObjectGraveyard();
   MetaObjectVector::iterator itr = graveyard.begin();
@@ -395,7 +485,7 @@ void purgeGraveyardOfMetaobjects(
         nullptr == loader ? loader->getLibraryPath().c_str() : "NULL");
 
       bool is_address_in_graveyard_same_as_global_factory_map =
-        std::find(all_meta_objs.begin(), all_meta_objs.end(), *itr) != all_meta_objs.end();
+        std::find(lib_meta_objs.begin(), lib_meta_objs.end(), *itr) != lib_meta_objs.end();
       itr = graveyard.erase(itr);
       if (delete_objs) {
         if (is_address_in_graveyard_same_as_global_factory_map) {
@@ -434,6 +524,10 @@ void loadLibrary(const std::string & library_path, ClassLoader * loader)
     "Attempting to load library %s on behalf of ClassLoader handle %p...\n",
     library_path.c_str(), reinterpret_cast<void *>(loader));
 
+  // Only loads and unloads of the same library are serialized, the global mutexes are not held
+  // while the library is opened and its factories register themselves.
+  std::lock_guard<std::recursive_mutex> library_lock(getLibraryMutex(library_path));
+
   // If it's already open, just update existing metaobjects to have an additional owner.
   if (isLibraryLoadedByAnybody(library_path)) {
     CONSOLE_BRIDGE_logDebug("%s",
@@ -444,36 +538,31 @@ void loadLibrary(const std::string & library_path, ClassLoader * loader)
   }
 
   Poco::SharedLibrary * library_handle = nullptr;
-  static std::recursive_mutex loader_mutex;
-
-  {
-    std::lock_guard<std::recursive_mutex> loader_lock(loader_mutex);
-
-    try {
-      setCurrentlyActiveClassLoader(loader);
-      setCurrentlyLoadingLibraryName(library_path);
-      library_handle = new Poco::SharedLibrary(library_path);
-    } catch (const Poco::LibraryLoadException & e) {
-      setCurrentlyLoadingLibraryName("");
-      setCurrentlyActiveClassLoader(nullptr);
-      throw class_loader::LibraryLoadException(
-              "Could not load library (Poco exception = " + std::string(e.message()) + ")");
-    } catch (const Poco::LibraryAlreadyLoadedException & e) {
-      setCurrentlyLoadingLibraryName("");
-      setCurrentlyActiveClassLoader(nullptr);
-      throw class_loader::LibraryLoadException(
-              "Library already loaded (Poco exception = " + std::string(e.message()) + ")");
-    } catch (const Poco::NotFoundException & e) {
-      setCurrentlyLoadingLibraryName("");
-      setCurrentlyActiveClassLoader(nullptr);
-      throw class_loader::LibraryLoadException(
-              "Library not found (Poco exception = " + std::string(e.message()) + ")");
-    }
 
+  try {
+    setCurrentlyActiveClassLoader(loader);
+    setCurrentlyLoadingLibraryName(library_path);
+    library_handle = new Poco::SharedLibrary(library_path);
+  } catch (const Poco::LibraryLoadException & e) {
     setCurrentlyLoadingLibraryName("");
     setCurrentlyActiveClassLoader(nullptr);
+    throw class_loader::LibraryLoadException(
+            "Could not load library (Poco exception = " + std::string(e.message()) + ")");
+  } catch (const Poco::LibraryAlreadyLoadedException & e) {
+    setCurrentlyLoadingLibraryName("");
+    setCurrentlyActiveClassLoader(nullptr);
+    throw class_loader::LibraryLoadException(
+            "Library already loaded (Poco exception = " + std::string(e.message()) + ")");
+  } catch (const Poco::NotFoundException & e) {
+    setCurrentlyLoadingLibraryName("");
+    setCurrentlyActiveClassLoader(nullptr);
+    throw class_loader::LibraryLoadException(
+            "Library not found (Poco exception = " + std::string(e.message()) + ")");
   }
 
+  setCurrentlyLoadingLibraryName("");
+  setCurrentlyActiveClassLoader(nullptr);
+
   assert(library_handle != nullptr);
   CONSOLE_BRIDGE_logDebug(
     "class_loader.impl: "
@@ -501,7 +590,7 @@ void loadLibrary(const std::string & library_path, ClassLoader * loader)
   }
 
   // Insert library into global loaded library vectory
-  std::lock_guard<std::recursive_mutex> llv_lock(getLoadedLibraryVectorMutex());
+  std::lock_guard<std::shared_timed_mutex> llv_lock(getLoadedLibraryVectorMutex());
   LibraryVector & open_libraries = getLoadedLibraryVector();
   // Note: Poco::SharedLibrary automatically calls load() when library passed to constructor
   open_libraries.push_back(LibraryPair(library_path, library_handle));
@@ -525,41 +614,46 @@ void unloadLibrary(const std::string & library_path, ClassLoader * loader)
       "Unloading library %s on behalf of ClassLoader %p...",
       library_path.c_str(), reinterpret_cast<void *>(loader));
 
-    LibraryVector & open_libraries = getLoadedLibraryVector();
-    LibraryVector::iterator itr = findLoadedLibrary(library_path);
-    if (itr != open_libraries.end()) {
-      Poco::SharedLibrary * library = itr->second;
-      std::string library_path = itr->first;
-      try {
-        destroyMetaObjectsForLibrary(library_path, loader);
-
-        // Remove from loaded library list as well if no more factories associated with said library
-        if (!areThereAnyExistingMetaObjectsForLibrary(library_path)) {
-          CONSOLE_BRIDGE_logDebug(
-            "class_loader.impl: "
-            "There are no more MetaObjects left for %s so unloading library and "
-            "removing from loaded library vector.\n",
-            library_path.c_str());
-          library->unload();
-          assert(library->isLoaded() == false);
-          delete (library);
-          itr = open_libraries.erase(itr);
-        } else {
-          CONSOLE_BRIDGE_logDebug(
-            "class_loader.impl: "
-            "MetaObjects still remain in memory meaning other ClassLoaders are still using library"
-            ", keeping library %s open.",
-            library_path.c_str());
-        }
-        return;
-      } catch (const Poco::RuntimeException & e) {
-        delete (library);
+    std::lock_guard<std::recursive_mutex> library_lock(getLibraryMutex(library_path));
+    Poco::SharedLibrary * library = nullptr;
+    {
+      // The static destructors run by unloading the library may use the loaded library vector,
+      // so the entry is removed here and the library is unloaded once the lock is released.
+      std::lock_guard<std::shared_timed_mutex> llv_lock(getLoadedLibraryVectorMutex());
+      LibraryVector & open_libraries = getLoadedLibraryVector();
+      LibraryVector::iterator itr = findLoadedLibrary(library_path);
+      if (itr == open_libraries.end()) {
         throw class_loader::LibraryUnloadException(
-                "Could not unload library (Poco exception = " + std::string(e.message()) + ")");
+                "Attempt to unload library that class_loader is unaware of.");
       }
+      destroyMetaObjectsForLibrary(library_path, loader);
+
+      // Remove from loaded library list as well if no more factories associated with said library
+      if (areThereAnyExistingMetaObjectsForLibrary(library_path)) {
+        CONSOLE_BRIDGE_logDebug(
+          "class_loader.impl: "
+          "MetaObjects still remain in memory meaning other ClassLoaders are still using library"
+          ", keeping library %s open.",
+          library_path.c_str());
+        return;
+      }
+      library = itr->second;
+      open_libraries.erase(itr);
+    }
+    CONSOLE_BRIDGE_logDebug(
+      "class_loader.impl: "
+      "There are no more MetaObjects left for %s so unloading library and "
+      "removing from loaded library vector.\n",
+      library_path.c_str());
+    try {
+      library->unload();
+      assert(library->isLoaded() == false);
+      delete (library);
+    } catch (const Poco::RuntimeException & e) {
+      delete (library);
+      throw class_loader::LibraryUnloadException(
+              "Could not unload library (Poco exception = " + std::string(e.message()) + ")");
     }
-    throw class_loader::LibraryUnloadException(
-            "Attempt to unload library that class_loader is unaware of.");
   }
 }
 
@@ -574,7 +668,7 @@ void printDebugInfoToScreen()
 
   printf("OPEN LIBRARIES IN MEMORY:\n");
   printf("--------------------------------------------------------------------------------\n");
-  std::lock_guard<std::recursive_mutex> lock(getLoadedLibraryVectorMutex());
+  std::shared_lock<std::shared_timed_mutex> lock(getLoadedLibraryVectorMutex());
   LibraryVector libs = getLoadedLibraryVector();
   for (size_t c = 0; c < libs.size(); c++) {
     printf(
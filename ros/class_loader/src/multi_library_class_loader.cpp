@@ -29,6 +29,7 @@
 
 #include "class_loader/multi_library_class_loader.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <mutex>
 #include <string>
@@ -59,6 +60,7 @@ MultiLibraryClassLoader::~MultiLibraryClassLoader()
 
 std::vector<std::string> MultiLibraryClassLoader::getRegisteredLibraries() const
 {
+  std::lock_guard<std::mutex> lock(impl_->loader_mutex_);
   std::vector<std::string> libraries;
   for (auto & it : impl_->active_class_loaders_) {
     if (it.second != nullptr) {
@@ -70,14 +72,19 @@ std::vector<std::string> MultiLibraryClassLoader::getRegisteredLibraries() const
 
 ClassLoader * MultiLibraryClassLoader::getClassLoaderForLibrary(const std::string & library_path)
 {
-  return impl_->active_class_loaders_[library_path];
+  std::lock_guard<std::mutex> lock(impl_->loader_mutex_);
+  LibraryToClassLoaderMap::iterator it = impl_->active_class_loaders_.find(library_path);
+  return it != impl_->active_class_loaders_.end() ? it->second : nullptr;
 }
 
 ClassLoaderVector MultiLibraryClassLoader::getAllAvailableClassLoaders() const
 {
+  std::lock_guard<std::mutex> lock(impl_->loader_mutex_);
   ClassLoaderVector loaders;
   for (auto & it : impl_->active_class_loaders_) {
-    loaders.push_back(it.second);
+    if (it.second != nullptr) {
+      loaders.push_back(it.second);
+    }
   }
   return loaders;
 }
@@ -91,10 +98,22 @@ bool MultiLibraryClassLoader::isLibraryAvailable(const std::string & library_nam
 
 void MultiLibraryClassLoader::loadLibrary(const std::string & library_path)
 {
-  if (!isLibraryAvailable(library_path)) {
-    impl_->active_class_loaders_[library_path] =
-      new class_loader::ClassLoader(library_path, isOnDemandLoadUnloadEnabled());
+  if (isLibraryAvailable(library_path)) {
+    return;
   }
+  // The library is opened without holding the lock, so that several libraries can be loaded
+  // concurrently
+  ClassLoader * loader = new class_loader::ClassLoader(library_path, isOnDemandLoadUnloadEnabled());
+  {
+    std::lock_guard<std::mutex> lock(impl_->loader_mutex_);
+    ClassLoader * & active_loader = impl_->active_class_loaders_[library_path];
+    if (nullptr == active_loader) {
+      active_loader = loader;
+      return;
+    }
+  }
+  // Loaded by another thread in the meantime
+  delete (loader);
 }
 
 void MultiLibraryClassLoader::shutdownAllClassLoaders()
@@ -106,12 +125,14 @@ void MultiLibraryClassLoader::shutdownAllClassLoaders()
 
 int MultiLibraryClassLoader::unloadLibrary(const std::string & library_path)
 {
+  std::lock_guard<std::mutex> lock(impl_->loader_mutex_);
   int remaining_unloads = 0;
-  if (isLibraryAvailable(library_path)) {
-    ClassLoader * loader = getClassLoaderForLibrary(library_path);
+  LibraryToClassLoaderMap::iterator it = impl_->active_class_loaders_.find(library_path);
+  if (it != impl_->active_class_loaders_.end() && it->second != nullptr) {
+    ClassLoader * loader = it->second;
     remaining_unloads = loader->unloadLibrary();
     if (remaining_unloads == 0) {
-      impl_->active_class_loaders_[library_path] = nullptr;
+      it->second = nullptr;
       delete (loader);
     }
   }
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2018, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holders nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the throughput of plugin instantiation, class queries and library loading when they
+// are done concurrently by several threads, each thread using its own ClassLoader.
+// Usage: benchmark_concurrent_loading [threads] [iterations]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "class_loader/class_loader.hpp"
+
+#include "./base.hpp"
+
+const std::string LIBRARY_1 = class_loader::systemLibraryFormat("class_loader_TestPlugins1");  // NOLINT
+const std::string LIBRARY_2 = class_loader::systemLibraryFormat("class_loader_TestPlugins2");  // NOLINT
+
+const char * const CLASSES_1[] = {"Dog", "Cat", "Duck", "Cow", "Sheep"};
+
+// Run body(thread_index, iteration) from the given number of threads, return the operations per second
+double run(size_t threads, size_t iterations, const std::function<void(size_t, size_t)> & body)
+{
+  std::atomic<bool> start(false);
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back(
+      [&start, &body, t, iterations]() {
+        while (!start) {
+          std::this_thread::yield();
+        }
+        for (size_t i = 0; i < iterations; ++i) {
+          body(t, i);
+        }
+      });
+  }
+  auto begin = std::chrono::steady_clock::now();
+  start = true;
+  for (auto & worker : workers) {
+    worker.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+  return static_cast<double>(threads * iterations) / elapsed.count();
+}
+
+int main(int argc, char ** argv)
+{
+  size_t threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+  size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+  if (threads == 0 || iterations == 0) {
+    fprintf(stderr, "Usage: %s [threads] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  {
+    std::vector<std::unique_ptr<class_loader::ClassLoader>> loaders_1;
+    for (size_t t = 0; t < threads; ++t) {
+      loaders_1.emplace_back(new class_loader::ClassLoader(LIBRARY_1, false));
+    }
+
+    double rate = run(
+      threads, iterations, [&loaders_1](size_t t, size_t i) {
+        auto obj = loaders_1[t]->createInstance<Base>(CLASSES_1[i % 5]);
+      });
+    printf("createInstance:   %12.0f instances/s\n", rate);
+
+    rate = run(
+      threads, iterations, [&loaders_1](size_t t, size_t i) {
+        if (!loaders_1[t]->isClassAvailable<Base>(CLASSES_1[i % 5])) {
+          abort();
+        }
+      });
+    printf("isClassAvailable: %12.0f queries/s\n", rate);
+  }
+
+  // Each iteration opens and closes a library while the other threads do the same
+  double rate = run(
+    threads, iterations / 100 + 1, [](size_t t, size_t) {
+      class_loader::ClassLoader loader(t % 2 ? LIBRARY_2 : LIBRARY_1, false);
+      auto obj = loader.createInstance<Base>(t % 2 ? "Robot" : "Dog");
+    });
+  printf("load/unload:      %12.0f libraries/s\n", rate);
+
+  printf("(%zu threads)\n", threads);
+  return 0;
+}
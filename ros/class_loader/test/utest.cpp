@@ -29,6 +29,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -44,6 +45,7 @@
 
 const std::string LIBRARY_1 = class_loader::systemLibraryFormat("class_loader_TestPlugins1");  // NOLINT
 const std::string LIBRARY_2 = class_loader::systemLibraryFormat("class_loader_TestPlugins2");  // NOLINT
+const std::string LIBRARY_3 = class_loader::systemLibraryFormat("class_loader_TestPlugins3");  // NOLINT
 
 TEST(ClassLoaderTest, basicLoad) {
   try {
@@ -195,6 +197,20 @@ TEST(ClassLoaderTest, threadSafety) {
   }
 }
 
+TEST(ClassLoaderTest, reentrantUnload) {
+  // The static destructors of this library query class_loader while it is being unloaded
+  auto unload = std::async(std::launch::async, []() {
+        class_loader::ClassLoader loader1(LIBRARY_3, false);
+        loader1.createInstance<Base>("Ghost")->saySomething();
+        loader1.unloadLibrary();
+        return loader1.isLibraryLoaded();
+      });
+  ASSERT_EQ(std::future_status::ready, unload.wait_for(std::chrono::seconds(10))) <<
+    "Unloading a library which uses class_loader in its static destructors deadlocked.";
+  ASSERT_FALSE(unload.get());
+  ASSERT_FALSE(class_loader::impl::isLibraryLoadedByAnybody(LIBRARY_3));
+}
+
 TEST(ClassLoaderTest, loadRefCountingNonLazy) {
   try {
     class_loader::ClassLoader loader1(LIBRARY_1, false);
@@ -38,6 +38,7 @@
 #define PLUGINLIB__CLASS_LOADER_IMP_HPP_
 
 #include <cstdlib>
+#include <fstream>
 #include <list>
 #include <map>
 #include <sstream>
@@ -65,13 +66,13 @@
 
 #include "ament_index_cpp/get_package_prefix.hpp"
 #include "ament_index_cpp/get_package_share_directory.hpp"
-#include "ament_index_cpp/get_resource.hpp"
 #include "ament_index_cpp/get_resources.hpp"
 #include "class_loader/class_loader.hpp"
 #include "rcutils/logging_macros.h"
 
 #include "./class_loader.hpp"
 #include "./impl/filesystem_helper.hpp"
+#include "./impl/plugin_manifest_cache.hpp"
 #include "./impl/split.hpp"
 
 #ifdef _WIN32
@@ -288,20 +289,22 @@ std::vector<std::string> ClassLoader<T>::getPluginXmlPaths(
     for (const auto & package_prefix_pair : plugin_packages_with_prefixes) {
       // it is also convention to place the relative path to the plugin xml in
       // the ament resource file
-      std::string resource_content;
-      {
-        using ament_index_cpp::get_resource;
-        if (!get_resource(resource_name, package_prefix_pair.first, resource_content)) {
-          RCUTILS_LOG_WARN_NAMED("pluginlib.ClassLoader",
-            "unexpectedly not able to find ament resource '%s' for package '%s'",
-            resource_name.c_str(),
-            package_prefix_pair.first.c_str()
-          );
-          continue;
-        }
+      // the resource is read from the prefix it was found in, rather than
+      // searching all prefixes again with ament_index_cpp::get_resource()
+      std::string resource_path = package_prefix_pair.second +
+        "/share/ament_index/resource_index/" + resource_name + "/" + package_prefix_pair.first;
+      std::ifstream resource_file(resource_path);
+      if (!resource_file) {
+        RCUTILS_LOG_WARN_NAMED("pluginlib.ClassLoader",
+          "unexpectedly not able to find ament resource '%s' for package '%s'",
+          resource_name.c_str(),
+          package_prefix_pair.first.c_str()
+        );
+        continue;
       }
+      std::stringstream ss;
+      ss << resource_file.rdbuf();
       // the content may contain multiple plugin description files
-      std::stringstream ss(resource_content);
       std::string line;
       while (std::getline(ss, line, '\n')) {
         if (!line.empty()) {
@@ -341,6 +344,9 @@ std::map<std::string, ClassDesc> ClassLoader<T>::determineAvailableClasses(
     }
   }
 
+  // persist the manifests parsed for this class loader for the next processes
+  pluginlib::impl::PluginManifestCache::get_instance().save();
+
   RCUTILS_LOG_DEBUG_NAMED("pluginlib.ClassLoader", "Exiting determineAvailableClasses()...");
   return classes_available;
 }
@@ -349,28 +355,7 @@ template<class T>
 std::string ClassLoader<T>::extractPackageNameFromPackageXML(const std::string & package_xml_path)
 /***************************************************************************/
 {
-  tinyxml2::XMLDocument document;
-  document.LoadFile(package_xml_path.c_str());
-  tinyxml2::XMLElement * doc_root_node = document.FirstChildElement("package");
-  if (NULL == doc_root_node) {
-    RCUTILS_LOG_ERROR_NAMED("pluginlib.ClassLoader",
-      "Could not find a root element for package manifest at %s.",
-      package_xml_path.c_str());
-    return "";
-  }
-
-  assert(document.RootElement() == doc_root_node);
-
-  tinyxml2::XMLElement * package_name_node = doc_root_node->FirstChildElement("name");
-  if (NULL == package_name_node) {
-    RCUTILS_LOG_ERROR_NAMED("pluginlib.ClassLoader",
-      "package.xml at %s does not have a <name> tag! Cannot determine package "
-      "which exports plugin.",
-      package_xml_path.c_str());
-    return "";
-  }
-
-  return package_name_node->GetText();
+  return pluginlib::impl::extract_package_name_from_package_xml(package_xml_path);
 }
 
 template<class T>
@@ -618,27 +603,11 @@ ClassLoader<T>::getPackageFromPluginXMLFilePath(const std::string & plugin_xml_f
   // 1. Find nearest encasing package.xml
   // 2. Extract name of package from package.xml
 
-  std::string package_name;
-  pluginlib::impl::fs::path p(plugin_xml_file_path);
-  pluginlib::impl::fs::path parent = p.parent_path();
-
-  // Figure out exactly which package the passed XML file is exported by.
-  while (true) {
-    if (pluginlib::impl::fs::exists(parent / "package.xml")) {
-      std::string package_file_path = (parent / "package.xml").string();
-      return extractPackageNameFromPackageXML(package_file_path);
-    }
-
-    // Recursive case - hop one folder up
-    parent = parent.parent_path();
-
-    // Base case - reached root and cannot find what we're looking for
-    if (parent.string().empty()) {
-      return "";
-    }
+  std::string package_xml_path = pluginlib::impl::find_package_xml(plugin_xml_file_path);
+  if (package_xml_path.empty()) {
+    return "";
   }
-
-  return package_name;
+  return extractPackageNameFromPackageXML(package_xml_path);
 }
 
 template<class T>
@@ -727,39 +696,20 @@ void ClassLoader<T>::processSingleXMLPluginFile(
 /***************************************************************************/
 {
   RCUTILS_LOG_DEBUG_NAMED("pluginlib.ClassLoader", "Processing xml file %s...", xml_file.c_str());
-  tinyxml2::XMLDocument document;
-  document.LoadFile(xml_file.c_str());
-  tinyxml2::XMLElement * config = document.RootElement();
-  if (NULL == config) {
-    throw pluginlib::InvalidXMLException(
-            "XML Document '" + xml_file +
-            "' has no Root Element. This likely means the XML is malformed or missing.");
-    return;
-  }
-  if (!(strcmp(config->Value(), "library") == 0 ||
-    strcmp(config->Value(), "class_libraries") == 0))
-  {
-    throw pluginlib::InvalidXMLException(
-            "The XML document '" + xml_file + "' given to add must have either \"library\" or "
-            "\"class_libraries\" as the root tag");
-    return;
-  }
-  // Step into the filter list if necessary
-  if (strcmp(config->Value(), "class_libraries") == 0) {
-    config = config->FirstChildElement("library");
+  // the file is only parsed again if it changed since another class loader processed it
+  auto manifest = pluginlib::impl::PluginManifestCache::get_instance().get_manifest(xml_file);
+  if (!manifest->error.empty()) {
+    throw pluginlib::InvalidXMLException(manifest->error);
   }
 
-  tinyxml2::XMLElement * library = config;
-  while (library != NULL) {
-    std::string library_path = library->Attribute("path");
-    if (0 == library_path.size()) {
+  for (const auto & library : manifest->libraries) {
+    if (0 == library.path.size()) {
       RCUTILS_LOG_ERROR_NAMED("pluginlib.ClassLoader",
         "Failed to find Path Attirbute in library element in %s", xml_file.c_str());
       continue;
     }
 
-    std::string package_name = getPackageFromPluginXMLFilePath(xml_file);
-    if ("" == package_name) {
+    if ("" == manifest->package_name) {
       RCUTILS_LOG_ERROR_NAMED("pluginlib.ClassLoader",
         "Could not find package manifest (neither package.xml or deprecated "
         "manifest.xml) at same directory level as the plugin XML file %s. "
@@ -767,58 +717,23 @@ void ClassLoader<T>::processSingleXMLPluginFile(
         xml_file.c_str());
     }
 
-    tinyxml2::XMLElement * class_element = library->FirstChildElement("class");
-    while (class_element) {
-      std::string derived_class;
-      if (class_element->Attribute("type") != NULL) {
-        derived_class = std::string(class_element->Attribute("type"));
-      } else {
+    for (const auto & class_info : library.classes) {
+      if (!class_info.has_type) {
         throw pluginlib::ClassLoaderException(
                 "Class could not be loaded. Attribute 'type' in class tag is missing.");
       }
-
-      std::string base_class_type;
-      if (class_element->Attribute("base_class_type") != NULL) {
-        base_class_type = std::string(class_element->Attribute("base_class_type"));
-      } else {
+      if (!class_info.has_base_class_type) {
         throw pluginlib::ClassLoaderException(
                 "Class could not be loaded. Attribute 'base_class_type' in class tag is missing.");
       }
 
-      std::string lookup_name;
-      if (class_element->Attribute("name") != NULL) {
-        lookup_name = class_element->Attribute("name");
-        RCUTILS_LOG_DEBUG_NAMED("pluginlib.ClassLoader",
-          "XML file specifies lookup name (i.e. magic name) = %s.",
-          lookup_name.c_str());
-      } else {
-        RCUTILS_LOG_DEBUG_NAMED("pluginlib.ClassLoader",
-          "XML file has no lookup name (i.e. magic name) for class %s, "
-          "assuming lookup_name == real class name.",
-          derived_class.c_str());
-        lookup_name = derived_class;
-      }
-
       // make sure that this class is of the right type before registering it
-      if (base_class_type == base_class_) {
-        // register class here
-        tinyxml2::XMLElement * description = class_element->FirstChildElement("description");
-        std::string description_str;
-        if (description) {
-          description_str = description->GetText() ? description->GetText() : "";
-        } else {
-          description_str = "No 'description' tag for this plugin in plugin description file.";
-        }
-
-        classes_available.insert(std::pair<std::string, ClassDesc>(lookup_name,
-          ClassDesc(lookup_name, derived_class, base_class_type, package_name, description_str,
-          library_path, xml_file)));
+      if (class_info.base_class_type == base_class_) {
+        classes_available.insert(std::pair<std::string, ClassDesc>(class_info.lookup_name,
+          ClassDesc(class_info.lookup_name, class_info.type, class_info.base_class_type,
+          manifest->package_name, class_info.description, library.path, xml_file)));
       }
-
-      // step to next class_element
-      class_element = class_element->NextSiblingElement("class");
     }
-    library = library->NextSiblingElement("library");
   }
 }
 
@@ -0,0 +1,486 @@
+/*
+ * Copyright (c) 2018, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLUGINLIB__IMPL__PLUGIN_MANIFEST_CACHE_HPP_
+#define PLUGINLIB__IMPL__PLUGIN_MANIFEST_CACHE_HPP_
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ament_index_cpp/get_cache_directory.hpp"
+#include "rcutils/logging_macros.h"
+#include "tinyxml2.h"  // NOLINT
+
+#include "./filesystem_helper.hpp"
+
+namespace pluginlib
+{
+namespace impl
+{
+
+/// Modification time and size of a file, used to detect that a cached file changed.
+struct FileStamp
+{
+  int64_t mtime_sec = 0;
+  int64_t mtime_nsec = 0;
+  int64_t size = -1;
+
+  bool operator==(const FileStamp & other) const
+  {
+    return mtime_sec == other.mtime_sec && mtime_nsec == other.mtime_nsec &&
+           size == other.size;
+  }
+};
+
+inline bool
+get_file_stamp(const std::string & path, FileStamp & stamp)
+{
+#ifndef _WIN32
+  struct stat s;
+  if (stat(path.c_str(), &s) != 0) {
+    return false;
+  }
+  stamp.mtime_sec = static_cast<int64_t>(s.st_mtime);
+# ifdef __APPLE__
+  stamp.mtime_nsec = static_cast<int64_t>(s.st_mtimespec.tv_nsec);
+# else
+  stamp.mtime_nsec = static_cast<int64_t>(s.st_mtim.tv_nsec);
+# endif
+#else
+  struct _stat64 s;
+  if (_stat64(path.c_str(), &s) != 0) {
+    return false;
+  }
+  stamp.mtime_sec = static_cast<int64_t>(s.st_mtime);
+  stamp.mtime_nsec = 0;
+#endif
+  stamp.size = static_cast<int64_t>(s.st_size);
+  return true;
+}
+
+/// Open a package.xml file and extract the package name (i.e. contents of <name> tag).
+inline std::string
+extract_package_name_from_package_xml(const std::string & package_xml_path)
+{
+  tinyxml2::XMLDocument document;
+  document.LoadFile(package_xml_path.c_str());
+  tinyxml2::XMLElement * doc_root_node = document.FirstChildElement("package");
+  if (NULL == doc_root_node) {
+    RCUTILS_LOG_ERROR_NAMED("pluginlib.ClassLoader",
+      "Could not find a root element for package manifest at %s.",
+      package_xml_path.c_str());
+    return "";
+  }
+
+  tinyxml2::XMLElement * package_name_node = doc_root_node->FirstChildElement("name");
+  if (NULL == package_name_node || NULL == package_name_node->GetText()) {
+    RCUTILS_LOG_ERROR_NAMED("pluginlib.ClassLoader",
+      "package.xml at %s does not have a <name> tag! Cannot determine package "
+      "which exports plugin.",
+      package_xml_path.c_str());
+    return "";
+  }
+
+  return package_name_node->GetText();
+}
+
+/// Find the nearest package.xml encasing a plugin xml file.
+/**
+ * \return The path to the package.xml file, or an empty string if none was found.
+ */
+inline std::string
+find_package_xml(const std::string & plugin_xml_file_path)
+{
+  pluginlib::impl::fs::path parent = pluginlib::impl::fs::path(plugin_xml_file_path).parent_path();
+  while (!parent.string().empty()) {
+    if (pluginlib::impl::fs::exists(parent / "package.xml")) {
+      return (parent / "package.xml").string();
+    }
+    // hop one folder up, until the root is reached
+    pluginlib::impl::fs::path grandparent = parent.parent_path();
+    if (grandparent.string() == parent.string()) {
+      break;
+    }
+    parent = grandparent;
+  }
+  return "";
+}
+
+/// Content of a plugin description file.
+struct PluginManifest
+{
+  struct Class
+  {
+    // The attributes are mandatory, a class without them makes the whole file invalid
+    bool has_type = false;
+    bool has_base_class_type = false;
+    std::string type;
+    std::string base_class_type;
+    std::string lookup_name;
+    std::string description;
+  };
+
+  struct Library
+  {
+    std::string path;
+    std::vector<Class> classes;
+  };
+
+  /// Error message if the file is not a valid plugin description.
+  std::string error;
+  /// Name of the package exporting the plugins, empty if it couldn't be determined.
+  std::string package_name;
+  /// Path of the package.xml the package name was read from.
+  std::string package_xml_path;
+  std::vector<Library> libraries;
+
+  /// Stamps of xml file and of the package.xml when the manifest was parsed.
+  FileStamp stamp;
+  FileStamp package_xml_stamp;
+};
+
+/// Parse a plugin description file.
+inline std::shared_ptr<PluginManifest>
+parse_plugin_manifest(const std::string & xml_file)
+{
+  auto manifest = std::make_shared<PluginManifest>();
+  get_file_stamp(xml_file, manifest->stamp);
+
+  tinyxml2::XMLDocument document;
+  document.LoadFile(xml_file.c_str());
+  tinyxml2::XMLElement * config = document.RootElement();
+  if (NULL == config) {
+    manifest->error =
+      "XML Document '" + xml_file +
+      "' has no Root Element. This likely means the XML is malformed or missing.";
+    return manifest;
+  }
+  if (!(strcmp(config->Value(), "library") == 0 ||
+    strcmp(config->Value(), "class_libraries") == 0))
+  {
+    manifest->error =
+      "The XML document '" + xml_file + "' given to add must have either \"library\" or "
+      "\"class_libraries\" as the root tag";
+    return manifest;
+  }
+  // Step into the filter list if necessary
+  if (strcmp(config->Value(), "class_libraries") == 0) {
+    config = config->FirstChildElement("library");
+  }
+
+  manifest->package_xml_path = find_package_xml(xml_file);
+  if (!manifest->package_xml_path.empty()) {
+    get_file_stamp(manifest->package_xml_path, manifest->package_xml_stamp);
+    manifest->package_name = extract_package_name_from_package_xml(manifest->package_xml_path);
+  }
+
+  for (tinyxml2::XMLElement * library = config; library != NULL;
+    library = library->NextSiblingElement("library"))
+  {
+    PluginManifest::Library library_info;
+    if (library->Attribute("path") != NULL) {
+      library_info.path = library->Attribute("path");
+    }
+    for (tinyxml2::XMLElement * class_element = library->FirstChildElement("class");
+      class_element != NULL; class_element = class_element->NextSiblingElement("class"))
+    {
+      PluginManifest::Class class_info;
+      if (class_element->Attribute("type") != NULL) {
+        class_info.has_type = true;
+        class_info.type = class_element->Attribute("type");
+      }
+      if (class_element->Attribute("base_class_type") != NULL) {
+        class_info.has_base_class_type = true;
+        class_info.base_class_type = class_element->Attribute("base_class_type");
+      }
+      if (class_element->Attribute("name") != NULL) {
+        class_info.lookup_name = class_element->Attribute("name");
+      } else {
+        class_info.lookup_name = class_info.type;
+      }
+      tinyxml2::XMLElement * description = class_element->FirstChildElement("description");
+      if (description) {
+        class_info.description = description->GetText() ? description->GetText() : "";
+      } else {
+        class_info.description =
+          "No 'description' tag for this plugin in plugin description file.";
+      }
+      library_info.classes.push_back(class_info);
+    }
+    manifest->libraries.push_back(library_info);
+  }
+  return manifest;
+}
+
+/// Process-wide cache of the parsed plugin description files, shared by all ClassLoaders.
+/**
+ * A cached manifest is used as long as the modification time and the size of the plugin xml file
+ * and of the package.xml it was exported by don't change.
+ * Manifests of files modified too recently, as told by
+ * ament_index_cpp::is_modification_time_cacheable(), are parsed again on each call.
+ * If a cache directory is given by ament_index_cpp::get_cache_directory(), the manifests are also
+ * written to it and read by the next processes.
+ * All functions are thread-safe.
+ */
+class PluginManifestCache
+{
+public:
+  PluginManifestCache() = default;
+
+  static PluginManifestCache &
+  get_instance()
+  {
+    static PluginManifestCache instance;
+    return instance;
+  }
+
+  /// Return the parsed content of a plugin description file, parsing it if needed.
+  std::shared_ptr<const PluginManifest>
+  get_manifest(const std::string & xml_file)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load(ament_index_cpp::get_cache_directory());
+
+    FileStamp stamp;
+    bool exists = get_file_stamp(xml_file, stamp);
+    auto it = manifests_.find(xml_file);
+    if (exists && it != manifests_.end() && it->second->stamp == stamp &&
+      is_package_valid(*it->second))
+    {
+      return it->second;
+    }
+
+    RCUTILS_LOG_DEBUG_NAMED("pluginlib.ClassLoader", "Parsing xml file %s...", xml_file.c_str());
+    std::shared_ptr<const PluginManifest> manifest = parse_plugin_manifest(xml_file);
+    if (exists && is_cacheable(*manifest)) {
+      manifests_[xml_file] = manifest;
+      dirty_ = true;
+    } else if (it != manifests_.end()) {
+      manifests_.erase(it);
+      dirty_ = true;
+    }
+    return manifest;
+  }
+
+  /// Write the manifests parsed since the last call to the cache directory, if any.
+  /**
+   * Errors are ignored, the cache is only an optimization.
+   */
+  void
+  save()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!dirty_ || loaded_directory_.empty()) {
+      return;
+    }
+    dirty_ = false;
+    write_file(loaded_directory_);
+  }
+
+private:
+  static bool
+  is_cacheable(const PluginManifest & manifest)
+  {
+    return ament_index_cpp::is_modification_time_cacheable(manifest.stamp.mtime_sec) &&
+           (manifest.package_xml_path.empty() ||
+           ament_index_cpp::is_modification_time_cacheable(manifest.package_xml_stamp.mtime_sec));
+  }
+
+  static bool
+  is_package_valid(const PluginManifest & manifest)
+  {
+    if (manifest.package_xml_path.empty()) {
+      return true;
+    }
+    FileStamp stamp;
+    return get_file_stamp(manifest.package_xml_path, stamp) && stamp == manifest.package_xml_stamp;
+  }
+
+  static const char *
+  file_name()
+  {
+    return "pluginlib_manifests.cache";
+  }
+
+  // The format is a header line followed by the manifests, strings are prefixed by their length.
+
+  static void
+  write_string(std::ostream & out, const std::string & value)
+  {
+    out << value.size() << ' ' << value << '\n';
+  }
+
+  static bool
+  read_string(std::istream & in, std::string & value)
+  {
+    size_t size;
+    if (!(in >> size) || in.get() != ' ') {
+      return false;
+    }
+    value.resize(size);
+    if (size > 0 && !in.read(&value[0], size)) {
+      return false;
+    }
+    return in.get() == '\n';
+  }
+
+  static void
+  write_stamp(std::ostream & out, const FileStamp & stamp)
+  {
+    out << stamp.mtime_sec << ' ' << stamp.mtime_nsec << ' ' << stamp.size << '\n';
+  }
+
+  static bool
+  read_stamp(std::istream & in, FileStamp & stamp)
+  {
+    return static_cast<bool>(in >> stamp.mtime_sec >> stamp.mtime_nsec >> stamp.size);
+  }
+
+  static bool
+  read_manifest(std::istream & in, PluginManifest & manifest)
+  {
+    size_t library_count;
+    if (!read_stamp(in, manifest.stamp) || !read_stamp(in, manifest.package_xml_stamp) ||
+      !read_string(in, manifest.error) || !read_string(in, manifest.package_name) ||
+      !read_string(in, manifest.package_xml_path) || !(in >> library_count))
+    {
+      return false;
+    }
+    manifest.libraries.resize(library_count);
+    for (auto & library : manifest.libraries) {
+      size_t class_count;
+      if (!read_string(in, library.path) || !(in >> class_count)) {
+        return false;
+      }
+      library.classes.resize(class_count);
+      for (auto & class_info : library.classes) {
+        if (!(in >> class_info.has_type >> class_info.has_base_class_type) ||
+          !read_string(in, class_info.type) || !read_string(in, class_info.base_class_type) ||
+          !read_string(in, class_info.lookup_name) || !read_string(in, class_info.description))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Must be called with mutex_ held, the cache file is read once per cache directory.
+  void
+  load(const std::string & directory)
+  {
+    if (loaded_ && loaded_directory_ == directory) {
+      return;
+    }
+    loaded_ = true;
+    loaded_directory_ = directory;
+    if (directory.empty()) {
+      return;
+    }
+    // the manifests of this process are missing from the cache file of the new directory
+    dirty_ = !manifests_.empty();
+
+    std::ifstream in(directory + "/" + file_name(), std::ios::binary);
+    std::string header;
+    if (!in || !std::getline(in, header) || header != file_header()) {
+      return;
+    }
+    std::unordered_map<std::string, std::shared_ptr<const PluginManifest>> loaded;
+    std::string xml_file;
+    while (in >> std::ws && !in.eof()) {
+      auto manifest = std::make_shared<PluginManifest>();
+      if (!read_string(in, xml_file) || !read_manifest(in, *manifest)) {
+        // ignore a corrupted file as a whole
+        return;
+      }
+      loaded[xml_file] = manifest;
+    }
+    for (auto & entry : loaded) {
+      manifests_.insert(std::move(entry));
+    }
+  }
+
+  // Must be called with mutex_ held.
+  void
+  write_file(const std::string & directory)
+  {
+    std::ostringstream out;
+    out << file_header() << '\n';
+    for (const auto & entry : manifests_) {
+      const PluginManifest & manifest = *entry.second;
+      write_string(out, entry.first);
+      write_stamp(out, manifest.stamp);
+      write_stamp(out, manifest.package_xml_stamp);
+      write_string(out, manifest.error);
+      write_string(out, manifest.package_name);
+      write_string(out, manifest.package_xml_path);
+      out << manifest.libraries.size() << '\n';
+      for (const auto & library : manifest.libraries) {
+        write_string(out, library.path);
+        out << library.classes.size() << '\n';
+        for (const auto & class_info : library.classes) {
+          out << class_info.has_type << ' ' << class_info.has_base_class_type << '\n';
+          write_string(out, class_info.type);
+          write_string(out, class_info.base_class_type);
+          write_string(out, class_info.lookup_name);
+          write_string(out, class_info.description);
+        }
+      }
+    }
+    ament_index_cpp::write_cache_file(directory, file_name(), out.str());
+  }
+
+  static const char *
+  file_header()
+  {
+    return "pluginlib manifests 1";
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const PluginManifest>> manifests_;
+  std::string loaded_directory_;
+  bool loaded_ = false;
+  bool dirty_ = false;
+};
+
+}  // namespace impl
+}  // namespace pluginlib
+
+#endif  // PLUGINLIB__IMPL__PLUGIN_MANIFEST_CACHE_HPP_
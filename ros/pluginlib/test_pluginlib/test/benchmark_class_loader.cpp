@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2018, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the time it takes to create pluginlib::ClassLoaders in a workspace with many packages.
+// A fake workspace with one install prefix per package, each exporting a plugin for
+// test_base::Fubar, is generated in a temporary directory and prepended to AMENT_PREFIX_PATH.
+// The measurement runs in a new process for each configuration of the cache directory, so that
+// only the cache written to disk is shared between the runs:
+//   - no cache directory: the resource index and the plugin manifests are read by each process,
+//   - empty cache directory: same, and the cache is written,
+//   - cache directory written by the previous run.
+// Within a process, the loaders created after the first one only use the in-memory cache.
+//
+// Usage: benchmark_class_loader [packages] [loaders]
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <utime.h>
+#else
+#include <direct.h>
+#include <sys/utime.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "pluginlib/class_loader.hpp"
+
+#include "test_pluginlib_fixture/test_base.h"
+
+#ifdef _WIN32
+#define PATH_SEPARATOR ";"
+#else
+#define PATH_SEPARATOR ":"
+#endif
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void set_env(const std::string & name, const std::string & value)
+{
+#ifndef _WIN32
+  if (value.empty()) {
+    unsetenv(name.c_str());
+  } else {
+    setenv(name.c_str(), value.c_str(), 1);
+  }
+#else
+  _putenv_s(name.c_str(), value.c_str());
+#endif
+}
+
+std::string get_env(const std::string & name)
+{
+  const char * value = std::getenv(name.c_str());
+  return value ? value : "";
+}
+
+// Files and directories created by the benchmark, removed in reverse order at the end.
+std::vector<std::string> created_files;
+std::vector<std::string> created_directories;
+
+void make_directory(const std::string & path)
+{
+#ifndef _WIN32
+  mkdir(path.c_str(), 0755);
+#else
+  _mkdir(path.c_str());
+#endif
+  created_directories.push_back(path);
+}
+
+void write_file(const std::string & path, const std::string & content)
+{
+  std::ofstream(path) << content;
+  created_files.push_back(path);
+}
+
+// Installed workspaces are not modified while they are used, make the directories look that way
+void set_old_modification_time(const std::string & path)
+{
+#ifndef _WIN32
+  struct utimbuf times;
+#else
+  struct _utimbuf times;
+#endif
+  times.actime = times.modtime = time(nullptr) - 3600;
+#ifndef _WIN32
+  utime(path.c_str(), &times);
+#else
+  _utime(path.c_str(), &times);
+#endif
+}
+
+std::string create_workspace(const std::string & root, int packages)
+{
+  std::string prefix_path;
+  make_directory(root);
+  for (int i = 0; i < packages; ++i) {
+    std::string package = "benchmark_package_" + std::to_string(i);
+    std::string prefix = root + "/" + package;
+    std::string index = prefix + "/share/ament_index/resource_index";
+    make_directory(prefix);
+    make_directory(prefix + "/share");
+    make_directory(prefix + "/share/" + package);
+    make_directory(prefix + "/share/ament_index");
+    make_directory(index);
+    make_directory(index + "/packages");
+    make_directory(index + "/test_pluginlib_fixture__pluginlib__plugin");
+
+    write_file(index + "/packages/" + package, "");
+    write_file(
+      index + "/test_pluginlib_fixture__pluginlib__plugin/" + package,
+      "share/" + package + "/plugins.xml\n");
+    write_file(
+      prefix + "/share/" + package + "/package.xml",
+      "<?xml version=\"1.0\"?>\n<package format=\"2\">\n  <name>" + package + "</name>\n"
+      "  <version>0.0.0</version>\n  <description>Benchmark package</description>\n"
+      "  <maintainer email=\"benchmark@example.com\">Benchmark</maintainer>\n"
+      "  <license>BSD</license>\n</package>\n");
+    write_file(
+      prefix + "/share/" + package + "/plugins.xml",
+      "<library path=\"" + package + "\">\n"
+      "  <class name=\"" + package + "/foo\" type=\"" + package + "::Foo\" "
+      "base_class_type=\"test_base::Fubar\">\n"
+      "    <description>A benchmark plugin.</description>\n  </class>\n</library>\n");
+
+    set_old_modification_time(index + "/packages");
+    set_old_modification_time(index + "/test_pluginlib_fixture__pluginlib__plugin");
+    set_old_modification_time(index);
+    prefix_path += prefix + (i + 1 < packages ? PATH_SEPARATOR : "");
+  }
+  return prefix_path;
+}
+
+void remove_workspace()
+{
+  for (auto it = created_files.rbegin(); it != created_files.rend(); ++it) {
+    std::remove(it->c_str());
+  }
+  for (auto it = created_directories.rbegin(); it != created_directories.rend(); ++it) {
+#ifndef _WIN32
+    rmdir(it->c_str());
+#else
+    _rmdir(it->c_str());
+#endif
+  }
+}
+
+int run_child(int packages, int loaders)
+{
+  auto start = Clock::now();
+  size_t classes;
+  {
+    pluginlib::ClassLoader<test_base::Fubar> loader("test_pluginlib_fixture", "test_base::Fubar");
+    classes = loader.getDeclaredClasses().size();
+  }
+  double first = ms_since(start);
+
+  start = Clock::now();
+  for (int i = 0; i < loaders; ++i) {
+    pluginlib::ClassLoader<test_base::Fubar> loader("test_pluginlib_fixture", "test_base::Fubar");
+  }
+  double next = loaders > 0 ? ms_since(start) / loaders : 0.0;
+
+  // the classes of the fixture are declared too
+  if (classes < static_cast<size_t>(packages)) {
+    fprintf(stderr, "Only %zu classes declared for %d packages\n", classes, packages);
+    return 1;
+  }
+  printf("%10.2f ms %10.2f ms\n", first, next);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  int packages = argc > 1 ? std::atoi(argv[1]) : 300;
+  int loaders = argc > 2 ? std::atoi(argv[2]) : 20;
+  if (argc > 3 && std::string(argv[3]) == "--child") {
+    return run_child(packages, loaders);
+  }
+
+  std::string root = get_env("TMPDIR");
+  root = (root.empty() ? "/tmp" : root) + "/benchmark_class_loader_" +
+    std::to_string(time(nullptr));
+  std::string prefix_path = create_workspace(root + "_workspace", packages);
+  std::string cache_directory = root + "_cache";
+  set_env("AMENT_PREFIX_PATH", prefix_path + PATH_SEPARATOR + get_env("AMENT_PREFIX_PATH"));
+
+  std::string command = std::string("\"") + argv[0] + "\" " + std::to_string(packages) + " " +
+    std::to_string(loaders) + " --child";
+  printf("%d packages, %d loaders\n", packages, loaders);
+  printf("%-24s %13s %13s\n", "cache", "first loader", "next loaders");
+  const char * runs[] = {"none", "cold", "warm"};
+  int result = 0;
+  for (const char * run : runs) {
+    set_env("AMENT_INDEX_CACHE_DIR", std::string(run) == "none" ? "" : cache_directory);
+    printf("%-24s ", run);
+    fflush(stdout);
+    if (std::system(command.c_str()) != 0) {
+      result = 1;
+    }
+  }
+
+  std::remove((cache_directory + "/ament_index_cpp_resources.cache").c_str());
+  std::remove((cache_directory + "/pluginlib_manifests.cache").c_str());
+#ifndef _WIN32
+  rmdir(cache_directory.c_str());
+#else
+  _rmdir(cache_directory.c_str());
+#endif
+  remove_workspace();
+  return result;
+}
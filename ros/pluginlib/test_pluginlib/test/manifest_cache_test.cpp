@@ -0,0 +1,194 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#ifndef _WIN32
+#include <stdlib.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <pluginlib/impl/plugin_manifest_cache.hpp>  // NOLINT
+
+namespace
+{
+
+void write_file(const std::string & path, const std::string & content)
+{
+  std::ofstream out(path, std::ios::trunc);
+  out << content;
+  if (!out) {
+    throw std::runtime_error("Failed to write '" + path + "'");
+  }
+}
+
+void set_modification_time(const std::string & path, time_t mtime)
+{
+  struct utimbuf times;
+  times.actime = mtime;
+  times.modtime = mtime;
+  if (utime(path.c_str(), &times)) {
+    throw std::runtime_error("Failed to set the modification time of '" + path + "'");
+  }
+}
+
+std::string plugin_xml(const std::string & class_name)
+{
+  return
+    "<library path=\"test_plugins\">\n"
+    "  <class name=\"" + class_name + "\" type=\"test_plugins::" + class_name + "\"\n"
+    "    base_class_type=\"test_base::Fubar\">\n"
+    "    <description>A test plugin</description>\n"
+    "  </class>\n"
+    "</library>\n";
+}
+
+class PluginManifestCacheTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    char directory_template[] = "/tmp/pluginlib_manifest_cache_test_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(directory_template));
+    directory_ = directory_template;
+    package_xml_ = directory_ + "/package.xml";
+    xml_file_ = directory_ + "/plugins.xml";
+    cache_directory_ = directory_ + "/cache";
+    write_file(package_xml_, "<package><name>test_plugins</name></package>\n");
+    write_file(xml_file_, plugin_xml("Foo"));
+    old_mtime_ = time(nullptr) - 100;
+    set_modification_time(package_xml_, old_mtime_);
+    set_modification_time(xml_file_, old_mtime_);
+    ASSERT_EQ(0, unsetenv("AMENT_INDEX_CACHE_DIR"));
+  }
+
+  void TearDown() override
+  {
+    unsetenv("AMENT_INDEX_CACHE_DIR");
+    unlink((cache_directory_ + "/pluginlib_manifests.cache").c_str());
+    rmdir(cache_directory_.c_str());
+    unlink(xml_file_.c_str());
+    unlink(package_xml_.c_str());
+    rmdir(directory_.c_str());
+  }
+
+  std::string directory_;
+  std::string package_xml_;
+  std::string xml_file_;
+  std::string cache_directory_;
+  time_t old_mtime_;
+};
+
+}  // namespace
+
+TEST_F(PluginManifestCacheTest, parse) {
+  pluginlib::impl::PluginManifestCache cache;
+  auto manifest = cache.get_manifest(xml_file_);
+  ASSERT_TRUE(manifest->error.empty()) << manifest->error;
+  EXPECT_EQ("test_plugins", manifest->package_name);
+  EXPECT_EQ(package_xml_, manifest->package_xml_path);
+  ASSERT_EQ(1u, manifest->libraries.size());
+  EXPECT_EQ("test_plugins", manifest->libraries[0].path);
+  ASSERT_EQ(1u, manifest->libraries[0].classes.size());
+  EXPECT_EQ("Foo", manifest->libraries[0].classes[0].lookup_name);
+  EXPECT_EQ("test_plugins::Foo", manifest->libraries[0].classes[0].type);
+  EXPECT_EQ("test_base::Fubar", manifest->libraries[0].classes[0].base_class_type);
+  EXPECT_EQ("A test plugin", manifest->libraries[0].classes[0].description);
+
+  auto missing = cache.get_manifest(directory_ + "/missing.xml");
+  EXPECT_FALSE(missing->error.empty());
+}
+
+TEST_F(PluginManifestCacheTest, cache_hit_and_invalidation) {
+  pluginlib::impl::PluginManifestCache cache;
+  auto manifest = cache.get_manifest(xml_file_);
+  EXPECT_EQ(manifest, cache.get_manifest(xml_file_));
+
+  // a change of the size is detected even if the modification time is the same
+  write_file(xml_file_, plugin_xml("Foobar"));
+  set_modification_time(xml_file_, old_mtime_);
+  auto changed = cache.get_manifest(xml_file_);
+  EXPECT_NE(manifest, changed);
+  ASSERT_EQ(1u, changed->libraries.size());
+  ASSERT_EQ(1u, changed->libraries[0].classes.size());
+  EXPECT_EQ("Foobar", changed->libraries[0].classes[0].lookup_name);
+  EXPECT_EQ(changed, cache.get_manifest(xml_file_));
+
+  // as is a change of the modification time of the package.xml
+  set_modification_time(package_xml_, old_mtime_ - 10);
+  auto repackaged = cache.get_manifest(xml_file_);
+  EXPECT_NE(changed, repackaged);
+  EXPECT_EQ(repackaged, cache.get_manifest(xml_file_));
+}
+
+TEST_F(PluginManifestCacheTest, racy_modification_time) {
+  // a file modified within the granularity of the modification time may change again unnoticed,
+  // so its manifest is parsed on each call
+  pluginlib::impl::PluginManifestCache cache;
+  time_t now = time(nullptr);
+  set_modification_time(xml_file_, now);
+  auto manifest = cache.get_manifest(xml_file_);
+  EXPECT_NE(manifest, cache.get_manifest(xml_file_));
+
+  // a change of the same size within the same second is seen
+  write_file(xml_file_, plugin_xml("Baz"));
+  set_modification_time(xml_file_, now);
+  auto changed = cache.get_manifest(xml_file_);
+  ASSERT_EQ(1u, changed->libraries.size());
+  ASSERT_EQ(1u, changed->libraries[0].classes.size());
+  EXPECT_EQ("Baz", changed->libraries[0].classes[0].lookup_name);
+
+  // the same applies to the package.xml
+  set_modification_time(xml_file_, old_mtime_);
+  set_modification_time(package_xml_, now);
+  manifest = cache.get_manifest(xml_file_);
+  EXPECT_NE(manifest, cache.get_manifest(xml_file_));
+}
+
+TEST_F(PluginManifestCacheTest, cache_directory) {
+  ASSERT_EQ(0, setenv("AMENT_INDEX_CACHE_DIR", cache_directory_.c_str(), 1));
+  {
+    pluginlib::impl::PluginManifestCache cache;
+    ASSERT_TRUE(cache.get_manifest(xml_file_)->error.empty());
+    cache.save();
+  }
+
+  // the manifest is read from the cache file, so replacing the xml file by an invalid one with the
+  // same stamp is not noticed
+  std::string content = plugin_xml("Foo");
+  write_file(xml_file_, std::string(content.size(), ' '));
+  set_modification_time(xml_file_, old_mtime_);
+  {
+    pluginlib::impl::PluginManifestCache cache;
+    auto manifest = cache.get_manifest(xml_file_);
+    ASSERT_TRUE(manifest->error.empty()) << manifest->error;
+    ASSERT_EQ(1u, manifest->libraries.size());
+    ASSERT_EQ(1u, manifest->libraries[0].classes.size());
+    EXPECT_EQ("Foo", manifest->libraries[0].classes[0].lookup_name);
+  }
+
+  // while a change of the stamp is
+  set_modification_time(xml_file_, old_mtime_ - 10);
+  {
+    pluginlib::impl::PluginManifestCache cache;
+    EXPECT_FALSE(cache.get_manifest(xml_file_)->error.empty());
+  }
+}
+#endif
@@ -15,7 +15,9 @@
 #ifndef IMAGE_PIPELINE__CAMERA_NODE_HPP_
 #define IMAGE_PIPELINE__CAMERA_NODE_HPP_
 
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -25,28 +27,43 @@
 #include "sensor_msgs/msg/image.hpp"
 
 #include "common.hpp"
+#include "frame_pool.hpp"
+#include "pipeline_statistics.hpp"
 
 // Node which captures images from a camera using OpenCV and publishes them.
 // Images are annotated with this process's id as well as the message's ptr.
+// With a frame pool, frames are captured directly into recycled messages instead of being
+// copied into new ones. A negative device selects a synthetic source, which renders frames of
+// the requested size at the given rate without any camera.
 class CameraNode : public rclcpp::Node
 {
 public:
   CameraNode(
     const std::string & output, const std::string & node_name = "camera_node",
-    bool watermark = true, int device = 0, int width = 320, int height = 240)
-  : Node(node_name, "", true), canceled_(false), watermark_(watermark)
+    bool watermark = true, int device = 0, int width = 320, int height = 240,
+    std::shared_ptr<FramePool> pool = nullptr,
+    std::shared_ptr<PipelineStatistics> statistics = nullptr, double synthetic_rate = 30.0)
+  : Node(node_name, "", true), canceled_(false), watermark_(watermark),
+    synthetic_(device < 0), width_(width), height_(height), synthetic_rate_(synthetic_rate),
+    frame_count_(0), pool_(pool), statistics_(statistics)
   {
-    // Initialize OpenCV
-    cap_.open(device);
-    cap_.set(CV_CAP_PROP_FRAME_WIDTH, static_cast<double>(width));
-    cap_.set(CV_CAP_PROP_FRAME_HEIGHT, static_cast<double>(height));
-    if (!cap_.isOpened()) {
-      throw std::runtime_error("Could not open video stream!");
+    if (!synthetic_) {
+      // Initialize OpenCV
+      cap_.open(device);
+      cap_.set(CV_CAP_PROP_FRAME_WIDTH, static_cast<double>(width));
+      cap_.set(CV_CAP_PROP_FRAME_HEIGHT, static_cast<double>(height));
+      if (!cap_.isOpened()) {
+        throw std::runtime_error("Could not open video stream!");
+      }
     }
     // Create a publisher on the output topic.
     pub_ = this->create_publisher<sensor_msgs::msg::Image>(output, rmw_qos_profile_sensor_data);
     // Create the camera reading loop.
-    thread_ = std::thread(std::bind(&CameraNode::loop, this));
+    if (pool_) {
+      thread_ = std::thread(std::bind(&CameraNode::pooled_loop, this));
+    } else {
+      thread_ = std::thread(std::bind(&CameraNode::loop, this));
+    }
   }
 
   virtual ~CameraNode()
@@ -63,7 +80,7 @@ public:
     // While running...
     while (rclcpp::ok() && !canceled_.load()) {
       // Capture a frame from OpenCV.
-      cap_ >> frame_;
+      capture(frame_);
       if (frame_.empty()) {
         continue;
       }
@@ -85,11 +102,81 @@ public:
       msg->is_bigendian = false;
       msg->step = static_cast<sensor_msgs::msg::Image::_step_type>(frame_.step);
       msg->data.assign(frame_.datastart, frame_.dataend);
+      if (statistics_) {
+        statistics_->record(PipelineStage::camera, msg->header.stamp, true);
+      }
       pub_->publish(msg);  // Publish.
     }
   }
 
+  // Same as loop(), but the frames are captured into the data of messages taken from the pool.
+  void pooled_loop()
+  {
+    while (rclcpp::ok() && !canceled_.load()) {
+      sensor_msgs::msg::Image::UniquePtr msg = pool_->acquire();
+      // Wrap the message data in the format of the previous frame, it is resized in place once
+      // the message has been through the pipeline.
+      cv::Mat frame;
+      if (!frame_.empty()) {
+        msg->data.resize(frame_.step * frame_.rows);
+        frame = cv::Mat(frame_.rows, frame_.cols, frame_.type(), msg->data.data(), frame_.step);
+      }
+      capture(frame);
+      if (frame.empty()) {
+        pool_->give_back_unused(std::move(msg));
+        continue;
+      }
+      // The capture reallocates the frame when its format changed, e.g. for the first one.
+      bool copied = frame.data != msg->data.data();
+      if (copied) {
+        frame_ = frame;
+        msg->data.assign(frame.datastart, frame.dataend);
+        frame = cv::Mat(frame_.rows, frame_.cols, frame_.type(), msg->data.data(), frame_.step);
+      }
+
+      if (watermark_) {
+        std::stringstream ss;
+        // Put this process's id and the msg's pointer address on the image.
+        ss << "pid: " << GETPID() << ", ptr: " << msg.get();
+        draw_on_image(frame, ss.str(), 20);
+      }
+      set_now(msg->header.stamp);
+      msg->header.frame_id = "camera_frame";
+      msg->height = frame.rows;
+      msg->width = frame.cols;
+      msg->encoding = mat_type2encoding(frame.type());
+      msg->is_bigendian = false;
+      msg->step = static_cast<sensor_msgs::msg::Image::_step_type>(frame.step);
+      if (statistics_) {
+        statistics_->record(PipelineStage::camera, msg->header.stamp, copied);
+      }
+      pub_->publish(msg);  // Publish, the frame comes back to the pool at the end of the pipeline.
+    }
+  }
+
 private:
+  // Capture a frame from the camera, or render a synthetic one in place when it has the
+  // requested size already.
+  void capture(cv::Mat & frame)
+  {
+    if (!synthetic_) {
+      cap_ >> frame;
+      return;
+    }
+    // Keep the rate of a camera, from the first frame
+    if (0 == frame_count_) {
+      start_ = std::chrono::steady_clock::now();
+    } else {
+      auto period = std::chrono::duration<double>(frame_count_ / synthetic_rate_);
+      std::this_thread::sleep_until(
+        start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period));
+    }
+    ++frame_count_;
+    frame.create(height_, width_, CV_8UC3);
+    int shade = static_cast<int>(frame_count_ % 256);
+    frame.setTo(cv::Scalar(shade, 128, 255 - shade));
+  }
+
   rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr pub_;
   std::thread thread_;
   std::atomic<bool> canceled_;
@@ -98,6 +185,16 @@ private:
   /// pointer location
   bool watermark_;
 
+  bool synthetic_;
+  int width_;
+  int height_;
+  double synthetic_rate_;
+  uint64_t frame_count_;
+  std::chrono::steady_clock::time_point start_;
+
+  std::shared_ptr<FramePool> pool_;
+  std::shared_ptr<PipelineStatistics> statistics_;
+
   cv::VideoCapture cap_;
   cv::Mat frame_;
 };
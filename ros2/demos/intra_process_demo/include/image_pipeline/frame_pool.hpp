@@ -0,0 +1,143 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IMAGE_PIPELINE__FRAME_POOL_HPP_
+#define IMAGE_PIPELINE__FRAME_POOL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "sensor_msgs/msg/image.hpp"
+
+// Pool of image messages recycled through a pipeline.
+// The camera takes a frame out of the pool, writes into it and publishes it, the frame is moved
+// from node to node by unique_ptr and the last node gives it back. Once warmed up, no frame is
+// allocated and, as their data keeps its capacity, no image buffer either.
+// Frames are only lost when the intra-process manager drops them, e.g. when the last node falls
+// behind by more than the history depth; the pool then allocates new ones.
+// The pool is not told about the frames dropped, but as frames go through the pipeline in order,
+// the frames handed out before a frame which comes back, and not given back yet, were dropped.
+// Forgetting them keeps the frames tracked bounded and a copy later allocated at the address of
+// a dropped frame from being taken for a pooled frame.
+class FramePool
+{
+public:
+  explicit FramePool(size_t capacity)
+  : capacity_(capacity), allocated_(0), foreign_(0), dropped_(0)
+  {
+    free_.reserve(capacity_);
+  }
+
+  // Take a frame out of the pool, allocating one if the pool is empty.
+  sensor_msgs::msg::Image::UniquePtr acquire()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sensor_msgs::msg::Image::UniquePtr msg;
+    if (free_.empty()) {
+      msg.reset(new sensor_msgs::msg::Image());
+      ++allocated_;
+      // A frame handed out at the same address was freed, so it was dropped on the way
+      auto stale = std::find(in_flight_.begin(), in_flight_.end(), msg.get());
+      if (stale != in_flight_.end()) {
+        in_flight_.erase(stale);
+        ++dropped_;
+      }
+    } else {
+      msg = std::move(free_.back());
+      free_.pop_back();
+    }
+    in_flight_.push_back(msg.get());
+    return msg;
+  }
+
+  // Give a frame back to the pool at the end of the pipeline.
+  // Frames which did not come out of the pool, i.e. copies made on the way, are released.
+  void give_back(sensor_msgs::msg::Image::UniquePtr msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(in_flight_.begin(), in_flight_.end(), msg.get());
+    if (it == in_flight_.end()) {
+      ++foreign_;
+      return;
+    }
+    // The frames handed out before this one were dropped
+    dropped_ += static_cast<size_t>(it - in_flight_.begin());
+    in_flight_.erase(in_flight_.begin(), it + 1);
+    recycle(std::move(msg));
+  }
+
+  // Give back a frame which was taken out of the pool but not published.
+  void give_back_unused(sensor_msgs::msg::Image::UniquePtr msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(in_flight_.begin(), in_flight_.end(), msg.get());
+    if (it != in_flight_.end()) {
+      in_flight_.erase(it);
+    }
+    recycle(std::move(msg));
+  }
+
+  // Whether a frame came out of the pool, as opposed to being a copy of one.
+  bool owns(const sensor_msgs::msg::Image * msg) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::find(in_flight_.begin(), in_flight_.end(), msg) != in_flight_.end();
+  }
+
+  // Number of frames allocated by the pool, it stops growing once the pipeline is warmed up.
+  size_t allocated() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocated_;
+  }
+
+  // Number of frames given back which did not come out of the pool.
+  size_t foreign() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return foreign_;
+  }
+
+  // Number of frames known to have been dropped on the way.
+  size_t dropped() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+  }
+
+private:
+  // Must be called with mutex_ held.
+  void recycle(sensor_msgs::msg::Image::UniquePtr msg)
+  {
+    if (free_.size() < capacity_) {
+      free_.push_back(std::move(msg));
+    }
+  }
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  size_t allocated_;
+  size_t foreign_;
+  size_t dropped_;
+  std::vector<sensor_msgs::msg::Image::UniquePtr> free_;
+  // Addresses of the frames handed out and not given back yet, in the order they were handed out
+  std::deque<const sensor_msgs::msg::Image *> in_flight_;
+};
+
+#endif  // IMAGE_PIPELINE__FRAME_POOL_HPP_
@@ -15,57 +15,92 @@
 #ifndef IMAGE_PIPELINE__IMAGE_VIEW_NODE_HPP_
 #define IMAGE_PIPELINE__IMAGE_VIEW_NODE_HPP_
 
+#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "opencv2/highgui/highgui.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "sensor_msgs/msg/image.hpp"
 
 #include "common.hpp"
+#include "frame_pool.hpp"
+#include "pipeline_statistics.hpp"
 
 // Node which receives sensor_msgs/Image messages and renders them using OpenCV.
+// With a frame pool, it is the end of the pipeline: frames are received by unique_ptr and given
+// back to the pool once shown.
 class ImageViewNode : public rclcpp::Node
 {
 public:
   explicit ImageViewNode(
     const std::string & input, const std::string & node_name = "image_view_node",
-    bool watermark = true)
+    bool watermark = true, std::shared_ptr<FramePool> pool = nullptr,
+    std::shared_ptr<PipelineStatistics> statistics = nullptr, bool display = true)
   : Node(node_name, "", true)
   {
     // Create a subscription on the input topic.
+    if (pool) {
+      sub_ = this->create_subscription<sensor_msgs::msg::Image>(
+        input,
+        [node_name, watermark, pool, statistics, display](sensor_msgs::msg::Image::UniquePtr msg) {
+          if (statistics) {
+            // The frame is a copy if it is not the message the camera wrote into.
+            statistics->record(
+              PipelineStage::image_view, msg->header.stamp, !pool->owns(msg.get()));
+          }
+          if (display) {
+            show(*msg, node_name, watermark);
+          }
+          pool->give_back(std::move(msg));
+        },
+        rmw_qos_profile_sensor_data);
+      return;
+    }
     sub_ = this->create_subscription<sensor_msgs::msg::Image>(
       input,
-      [node_name, watermark](const sensor_msgs::msg::Image::SharedPtr msg) {
-        // Create a cv::Mat from the image message (without copying).
-        cv::Mat cv_mat(
-          msg->height, msg->width,
-          encoding2mat_type(msg->encoding),
-          msg->data.data());
-        if (watermark) {
-          // Annotate with the pid and pointer address.
-          std::stringstream ss;
-          ss << "pid: " << GETPID() << ", ptr: " << msg.get();
-          draw_on_image(cv_mat, ss.str(), 60);
+      [node_name, watermark, statistics, display](const sensor_msgs::msg::Image::SharedPtr msg) {
+        if (statistics) {
+          statistics->record(PipelineStage::image_view, msg->header.stamp, false);
         }
-        // Show the image.
-        CvMat c_mat = cv_mat;
-        cvShowImage(node_name.c_str(), &c_mat);
-        char key = cv::waitKey(1);    // Look for key presses.
-        if (key == 27 /* ESC */ || key == 'q') {
-          rclcpp::shutdown();
-        }
-        if (key == ' ') {    // If <space> then pause until another <space>.
-          key = '\0';
-          while (key != ' ') {
-            key = cv::waitKey(1);
-          }
+        if (display) {
+          show(*msg, node_name, watermark);
         }
       },
       rmw_qos_profile_sensor_data);
   }
 
 private:
+  static void show(
+    sensor_msgs::msg::Image & msg, const std::string & node_name, bool watermark)
+  {
+    // Create a cv::Mat from the image message (without copying).
+    cv::Mat cv_mat(
+      msg.height, msg.width,
+      encoding2mat_type(msg.encoding),
+      msg.data.data());
+    if (watermark) {
+      // Annotate with the pid and pointer address.
+      std::stringstream ss;
+      ss << "pid: " << GETPID() << ", ptr: " << &msg;
+      draw_on_image(cv_mat, ss.str(), 60);
+    }
+    // Show the image.
+    CvMat c_mat = cv_mat;
+    cvShowImage(node_name.c_str(), &c_mat);
+    char key = cv::waitKey(1);    // Look for key presses.
+    if (key == 27 /* ESC */ || key == 'q') {
+      rclcpp::shutdown();
+    }
+    if (key == ' ') {    // If <space> then pause until another <space>.
+      key = '\0';
+      while (key != ' ') {
+        key = cv::waitKey(1);
+      }
+    }
+  }
+
   rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr sub_;
 
   cv::VideoCapture cap_;
@@ -0,0 +1,91 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IMAGE_PIPELINE__PIPELINE_STATISTICS_HPP_
+#define IMAGE_PIPELINE__PIPELINE_STATISTICS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#include "builtin_interfaces/msg/time.hpp"
+
+enum class PipelineStage
+{
+  camera = 0,
+  watermark,
+  image_view,
+};
+
+// Latency since capture and number of copies of the frames, for each stage of the image pipeline.
+// A copy is counted when a stage gets a frame which is not the buffer the camera wrote into.
+class PipelineStatistics
+{
+public:
+  PipelineStatistics()
+  : stages_() {}
+
+  // Record a frame going through a stage, with the stamp it was captured at.
+  void record(PipelineStage stage, const builtin_interfaces::msg::Time & stamp, bool copied)
+  {
+    std::chrono::nanoseconds now = std::chrono::high_resolution_clock::now().time_since_epoch();
+    int64_t latency = now.count() - (static_cast<int64_t>(stamp.sec) * 1000000000 + stamp.nanosec);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stage & s = stages_[static_cast<size_t>(stage)];
+    ++s.frames;
+    s.copies += copied ? 1 : 0;
+    s.latency_sum += latency;
+    s.latency_max = std::max(s.latency_max, latency);
+  }
+
+  // Number of frames which went through a stage.
+  uint64_t frames(PipelineStage stage) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stages_[static_cast<size_t>(stage)].frames;
+  }
+
+  // Print the frames, mean and max latency in microseconds and copies of each stage.
+  void print(FILE * stream) const
+  {
+    static const char * names[] = {"camera", "watermark", "image_view"};
+    std::lock_guard<std::mutex> lock(mutex_);
+    fprintf(stream, "%12s %10s %12s %12s %8s\n",
+      "stage", "frames", "mean (us)", "max (us)", "copies");
+    for (size_t i = 0; i < stages_.size(); ++i) {
+      const Stage & s = stages_[i];
+      double mean = s.frames ? static_cast<double>(s.latency_sum) / s.frames / 1000.0 : 0.0;
+      fprintf(stream, "%12s %10" PRIu64 " %12.1f %12.1f %8" PRIu64 "\n",
+        names[i], s.frames, mean, s.latency_max / 1000.0, s.copies);
+    }
+  }
+
+private:
+  struct Stage
+  {
+    uint64_t frames = 0;
+    uint64_t copies = 0;
+    int64_t latency_sum = 0;
+    int64_t latency_max = 0;
+  };
+
+  mutable std::mutex mutex_;
+  std::array<Stage, 3> stages_;
+};
+
+#endif  // IMAGE_PIPELINE__PIPELINE_STATISTICS_HPP_
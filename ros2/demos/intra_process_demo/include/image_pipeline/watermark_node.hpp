@@ -24,6 +24,8 @@
 #include "sensor_msgs/msg/image.hpp"
 
 #include "common.hpp"
+#include "frame_pool.hpp"
+#include "pipeline_statistics.hpp"
 
 // Node that receives an image, adds some text as a watermark, and publishes it again.
 class WatermarkNode : public rclcpp::Node
@@ -31,7 +33,9 @@ class WatermarkNode : public rclcpp::Node
 public:
   WatermarkNode(
     const std::string & input, const std::string & output, const std::string & text,
-    const std::string & node_name = "watermark_node")
+    const std::string & node_name = "watermark_node",
+    std::shared_ptr<FramePool> pool = nullptr,
+    std::shared_ptr<PipelineStatistics> statistics = nullptr)
   : Node(node_name, "", true)
   {
     auto qos = rmw_qos_profile_sensor_data;
@@ -41,11 +45,16 @@ public:
     // Create a subscription on the output topic.
     sub_ = this->create_subscription<sensor_msgs::msg::Image>(
       input,
-      [captured_pub, text](sensor_msgs::msg::Image::UniquePtr msg) {
+      [captured_pub, text, pool, statistics](sensor_msgs::msg::Image::UniquePtr msg) {
         auto pub_ptr = captured_pub.lock();
         if (!pub_ptr) {
           return;
         }
+        if (statistics) {
+          // The frame is a copy if it is not the message the camera wrote into.
+          statistics->record(
+            PipelineStage::watermark, msg->header.stamp, pool && !pool->owns(msg.get()));
+        }
         // Create a cv::Mat from the image message (without copying).
         cv::Mat cv_mat(
           msg->height, msg->width,
@@ -14,34 +14,98 @@
 
 #include <rclcpp/rclcpp.hpp>
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <memory>
 
+#include "rcutils/cmdline_parser.h"
+
 #include "image_pipeline/camera_node.hpp"
+#include "image_pipeline/frame_pool.hpp"
 #include "image_pipeline/image_view_node.hpp"
+#include "image_pipeline/pipeline_statistics.hpp"
 #include "image_pipeline/watermark_node.hpp"
 
+void print_usage()
+{
+  printf("Usage for image_pipeline_all_in_one app:\n");
+  printf("image_pipeline_all_in_one [-p] [-s] [-d] [-n frames] [-h]\n");
+  printf("options:\n");
+  printf("-h : Print this help function.\n");
+  printf("-p : Recycle the frames through a pool, the camera captures into them without copy.\n");
+  printf("-s : Use a synthetic 640x480 source at 30 frames per second instead of a camera.\n");
+  printf("-d : Do not display the images.\n");
+  printf("-n frames : Exit after this many frames were shown. Defaults to 0, for never.\n");
+  printf("The latency and copies of each stage are printed every 100 frames and on exit.\n");
+}
+
 int main(int argc, char * argv[])
 {
+  if (rcutils_cli_option_exist(argv, argv + argc, "-h")) {
+    print_usage();
+    return 0;
+  }
+  bool pooled = rcutils_cli_option_exist(argv, argv + argc, "-p");
+  bool synthetic = rcutils_cli_option_exist(argv, argv + argc, "-s");
+  bool display = !rcutils_cli_option_exist(argv, argv + argc, "-d");
+  uint64_t frames = 0;
+  char * cli_option = rcutils_cli_get_option(argv, argv + argc, "-n");
+  if (nullptr != cli_option) {
+    frames = std::strtoull(cli_option, nullptr, 10);
+  }
+
   rclcpp::init(argc, argv);
   rclcpp::executors::SingleThreadedExecutor executor;
 
+  // The frames in flight are bound by the history depth of each of the two topics.
+  std::shared_ptr<FramePool> pool = nullptr;
+  if (pooled) {
+    pool = std::make_shared<FramePool>(2 * rmw_qos_profile_sensor_data.depth + 2);
+  }
+  auto statistics = std::make_shared<PipelineStatistics>();
+
   // Connect the nodes as a pipeline: camera_node -> watermark_node -> image_view_node
   std::shared_ptr<CameraNode> camera_node = nullptr;
   try {
-    camera_node = std::make_shared<CameraNode>("image");
+    if (synthetic) {
+      camera_node = std::make_shared<CameraNode>(
+        "image", "camera_node", true, -1, 640, 480, pool, statistics);
+    } else {
+      camera_node = std::make_shared<CameraNode>(
+        "image", "camera_node", true, 0, 320, 240, pool, statistics);
+    }
   } catch (const std::exception & e) {
     fprintf(stderr, "%s Exiting ..\n", e.what());
     return 1;
   }
-  auto watermark_node =
-    std::make_shared<WatermarkNode>("image", "watermarked_image", "Hello world!");
-  auto image_view_node = std::make_shared<ImageViewNode>("watermarked_image");
+  auto watermark_node = std::make_shared<WatermarkNode>(
+    "image", "watermarked_image", "Hello world!", "watermark_node", pool, statistics);
+  auto image_view_node = std::make_shared<ImageViewNode>(
+    "watermarked_image", "image_view_node", true, pool, statistics, display);
 
   executor.add_node(camera_node);
   executor.add_node(watermark_node);
   executor.add_node(image_view_node);
 
-  executor.spin();
+  uint64_t next_report = 100;
+  while (rclcpp::ok()) {
+    executor.spin_once(std::chrono::milliseconds(100));
+    uint64_t shown = statistics->frames(PipelineStage::image_view);
+    if (shown >= next_report) {
+      statistics->print(stdout);
+      next_report = shown + 100;
+    }
+    if (frames && shown >= frames) {
+      break;
+    }
+  }
+
+  statistics->print(stdout);
+  if (pool) {
+    printf("frames allocated by the pool: %zu, copies given back: %zu, frames dropped: %zu\n",
+      pool->allocated(), pool->foreign(), pool->dropped());
+  }
 
   rclcpp::shutdown();
 
@@ -24,33 +24,36 @@
 
 #include <rttest/rttest.h>
 
-#include <tlsf_cpp/tlsf.hpp>
+#include <tlsf_cpp/tlsf_arena.hpp>
 
 #include <pendulum_msgs/msg/joint_command.hpp>
 #include <pendulum_msgs/msg/joint_state.hpp>
 #include <pendulum_msgs/msg/rttest_results.hpp>
 
+#include <atomic>
 #include <memory>
+#include <thread>
 
 #include "pendulum_control/pendulum_controller.hpp"
 #include "pendulum_control/pendulum_motor.hpp"
 #include "pendulum_control/rtt_executor.hpp"
 
 
-static bool running = false;
+static std::atomic<bool> running(false);
+static std::atomic<size_t> realtime_allocations(0);
 
 // Initialize a malloc hook so we can show that no mallocs are made during real-time execution
 
-/// Declare a function pointer into which we will store the default malloc.
-static void * (* prev_malloc_hook)(size_t, const void *);
+// The default malloc of glibc, called by the hook so that it doesn't need to be swapped with the
+// default hook, which would race with the mallocs of the other threads.
+extern "C" void * __libc_malloc(size_t size);
 
 // Use pragma to ignore a warning for using __malloc_hook, which is deprecated (but still awesome).
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 /// Implement a custom malloc.
 /**
- * Our custom malloc backtraces to find the address of the function that called malloc and formats
- * the line as a string (if the code was compiled with debug symbols.
+ * Our custom malloc counts the mallocs made by any thread during the realtime execution phase.
  * \param[in] size Requested malloc size.
  * \param[in] caller pointer to the caller of this function (unused).
  * \return Pointer to the allocated memory
@@ -58,28 +61,16 @@ static void * (* prev_malloc_hook)(size_t, const void *);
 static void * testing_malloc(size_t size, const void * caller)
 {
   (void)caller;
-  // Set the malloc implementation to the default malloc hook so that we can call it implicitly
-  // to initialize a string, otherwise this function will loop infinitely.
-  __malloc_hook = prev_malloc_hook;
-
   if (running) {
-    fprintf(stderr, "Called malloc during realtime execution phase!\n");
-    rclcpp::shutdown();
-    exit(-1);
+    realtime_allocations.fetch_add(1, std::memory_order_relaxed);
   }
-
   // Execute the requested malloc.
-  void * mem = malloc(size);
-  // Set the malloc hook back to this function, so that we can intercept future mallocs.
-  __malloc_hook = testing_malloc;
-  return mem;
+  return __libc_malloc(size);
 }
 
 /// Function to be called when the malloc hook is initialized.
 void init_malloc_hook()
 {
-  // Store the default malloc.
-  prev_malloc_hook = __malloc_hook;
   // Set our custom malloc to the malloc hook.
   __malloc_hook = testing_malloc;
 }
@@ -92,7 +83,7 @@ using rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrateg
 using rclcpp::memory_strategies::allocator_memory_strategy::AllocatorMemoryStrategy;
 
 template<typename T = void>
-using TLSFAllocator = tlsf_heap_allocator<T>;
+using TLSFAllocator = tlsf_cpp::tlsf_arena_allocator<T>;
 
 int main(int argc, char * argv[])
 {
@@ -100,6 +91,11 @@ int main(int argc, char * argv[])
   // In the initialization phase of a realtime program, non-realtime-safe operations such as
   // allocation memory are permitted.
 
+  // Create the TLSF arena used by the executors, with a pool of a fixed size which is allocated and
+  // touched once now.
+  // The arena is thread-safe, it is shared by the executors of the motor and controller threads.
+  tlsf_cpp::tlsf_arena & arena = tlsf_cpp::tlsf_arena::get_default(16 * 1024 * 1024);
+
   // Create a structure with the default physical propreties of the pendulum (length and mass).
   pendulum_control::PendulumProperties properties;
   // Instantiate a PendulumMotor class which simulates the physics of the inverted pendulum
@@ -126,7 +122,8 @@ int main(int argc, char * argv[])
   // Typically, one MessagePoolMemoryStrategy is used per subscription type, and the size of the
   // message pool is determined by the number of threads (the maximum number of concurrent accesses
   // to the subscription).
-  // Since this example is single-threaded, we choose a message pool size of 1 for each strategy.
+  // Since each subscription of this example is executed by a single thread, we choose a message
+  // pool size of 1 for each strategy.
   auto state_msg_strategy =
     std::make_shared<MessagePoolMemoryStrategy<pendulum_msgs::msg::JointState, 1>>();
   auto command_msg_strategy =
@@ -210,7 +207,7 @@ int main(int argc, char * argv[])
     "pendulum_statistics", qos_profile);
   std::chrono::nanoseconds logger_publisher_period(1000000);
 
-  // Initialize the executor.
+  // Initialize the executors.
   rclcpp::executor::ExecutorArgs args;
   // One of the arguments passed to the Executor is the memory strategy, which delegates the
   // runtime-execution allocations to the TLSF allocator.
@@ -221,8 +218,14 @@ int main(int argc, char * argv[])
   // real-time performance statistics.
   auto executor = std::make_shared<pendulum_control::RttExecutor>(args);
 
-  // Add the motor and controller nodes to the executor.
-  executor->add_node(motor_node);
+  // The motor node is executed by a second thread, with its own memory strategy allocating from the
+  // same arena.
+  rclcpp::executor::ExecutorArgs motor_args;
+  motor_args.memory_strategy = std::make_shared<AllocatorMemoryStrategy<TLSFAllocator<void>>>();
+  rclcpp::executors::SingleThreadedExecutor motor_executor(motor_args);
+
+  // Add the motor and controller nodes to the executors.
+  motor_executor.add_node(motor_node);
   executor->add_node(controller_node);
 
   // Create a lambda function that will fire regularly to publish the next sensor message.
@@ -265,6 +268,31 @@ int main(int argc, char * argv[])
   auto logger_publisher_timer = controller_node->create_wall_timer(
     logger_publisher_period, logger_publish_callback);
 
+  // Start the motor thread, which runs until the pendulum is done.
+  std::thread motor_thread([&motor_executor, &pendulum_motor, &arena]() {
+      // The motor thread runs at a slightly lower priority than the controller thread.
+      if (rttest_set_sched_priority(97, SCHED_RR)) {
+        perror("Couldn't set scheduling priority and policy of the motor thread");
+      }
+      // Register the cache of the TLSF arena for this thread, which allocates from the system.
+      arena.prepare_thread();
+      while (rclcpp::ok() && !pendulum_motor->done()) {
+        motor_executor.spin_once(std::chrono::milliseconds(10));
+      }
+    });
+
+  // Register the cache of the TLSF arena for this thread, which allocates from the system.
+  arena.prepare_thread();
+
+  // Warm up: exchange messages until the pools, the caches of the arena and the middleware have
+  // reached their steady state. Allocations are permitted until then.
+  auto warmup_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (rclcpp::ok() && pendulum_controller->messages_received < 100 &&
+    std::chrono::steady_clock::now() < warmup_deadline)
+  {
+    executor->spin_some();
+  }
+
   // Set the priority of this thread to the maximum safe value, and set its scheduling policy to a
   // deterministic (real-time safe) algorithm, round robin.
   if (rttest_set_sched_priority(98, SCHED_RR)) {
@@ -291,19 +319,28 @@ int main(int argc, char * argv[])
   // Unlike the default SingleThreadedExecutor::spin function, RttExecutor::spin runs in
   // bounded time (for as many iterations as specified in the rttest parameters).
   executor->spin();
-  // Once the executor has exited, notify the physics simulation to stop running.
+  // Once the executor has exited, notify the physics simulation and the motor thread to stop
+  // running.
+  running = false;
   pendulum_motor->set_done(true);
+  motor_thread.join();
 
   // End execution phase
 
   // Teardown phase
   // deallocation is handled automatically by objects going out of scope
-  running = false;
 
   printf("PendulumMotor received %lu messages\n", pendulum_motor->messages_received);
   printf("PendulumController received %lu messages\n", pendulum_controller->messages_received);
+  auto arena_statistics = arena.get_statistics();
+  printf("TLSF arena: %zu of %zu bytes used at most, %zu allocations from the pool, "
+    "%zu failed allocations\n", arena_statistics.high_water_mark, arena_statistics.pool_size,
+    arena_statistics.pool_allocations, arena_statistics.failed_allocations);
+  size_t allocations = realtime_allocations.load();
+  printf("Allocations during the execution phase: %zu\n", allocations);
 
   rclcpp::shutdown();
 
-  return 0;
+  // Fail if the steady state made any allocation.
+  return allocations == 0 ? 0 : 1;
 }
@@ -44,6 +44,8 @@
 
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <mutex>
 #include <functional>
 #include <memory>
@@ -361,6 +363,9 @@ private:
   uint32_t transformable_callbacks_counter_;
   std::mutex transformable_callbacks_mutex_;
 
+  /// Pending requests of a frame, ordered by the time they were made for
+  typedef std::multimap<TimePoint, TransformableRequestHandle> M_TimeToTransformableRequest;
+
   struct TransformableRequest
   {
     TimePoint time;
@@ -370,15 +375,20 @@ private:
     CompactFrameID source_id;
     std::string target_string;
     std::string source_string;
+    /// The frames the request is indexed by, and its entry in the index of each of them
+    std::vector<CompactFrameID> frames;
+    std::vector<M_TimeToTransformableRequest::iterator> frame_entries;
   };
-  typedef std::vector<TransformableRequest> V_TransformableRequest;
-  V_TransformableRequest transformable_requests_;
+  typedef std::unordered_map<TransformableRequestHandle, TransformableRequest> M_TransformableRequest;
+  M_TransformableRequest transformable_requests_;
+  /** \brief Pending requests by the frames whose data their result depends on
+   * An update of a frame only has to test the requests indexed by that frame. */
+  std::unordered_map<CompactFrameID, M_TimeToTransformableRequest> transformable_requests_by_frame_;
+  /// Pending requests by the name of their frames which do not exist yet
+  std::unordered_map<std::string, std::unordered_set<TransformableRequestHandle>> transformable_requests_by_name_;
   std::mutex transformable_requests_mutex_;
   uint64_t transformable_requests_counter_;
 
-  struct RemoveRequestByCallback;
-  struct RemoveRequestByID;
-
 
   /************************* Internal Functions ****************************/
 
@@ -429,7 +439,22 @@ private:
   template<typename F>
   tf2::TF2Error walkToTopParent(F& f, TimePoint time, CompactFrameID target_id, CompactFrameID source_id, std::string* error_string, std::vector<CompactFrameID> *frame_chain) const;
 
-  void testTransformableRequests();
+  /** \brief Test the pending requests an update of a frame may have made transformable (or too old)
+   * \param frame_id The frame which received data
+   * \param stamp The time of the data
+   * \param any_time Whether requests made for times after the stamp may be affected as well
+   * (static data, or data older than the latest one the frame had)
+   * \param frame_name, child_frame_name The names of the frames of the update, which may have just been created
+   */
+  void testTransformableRequests(CompactFrameID frame_id, TimePoint stamp, bool any_time,
+                                 const std::string& frame_name, const std::string& child_frame_name);
+  /// Add a request to the indexes, must be called with both the requests and the frame mutexes held
+  void indexTransformableRequest(TransformableRequest& req);
+  /// Remove a request from the indexes, must be called with the requests mutex held
+  void unindexTransformableRequest(TransformableRequest& req);
+  /** \brief The frames a request depends on: the ones looked up at the time of the request and the
+   * ones used to compute the latest common time, starting from both its source and its target frames */
+  void getTransformableRequestFrames(const TransformableRequest& req, std::vector<CompactFrameID>& frames) const;
   bool canTransformInternal(CompactFrameID target_id, CompactFrameID source_id,
                     const TimePoint& time, std::string* error_msg) const;
   bool canTransformNoLock(CompactFrameID target_id, CompactFrameID source_id,
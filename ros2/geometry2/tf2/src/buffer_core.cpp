@@ -275,16 +275,23 @@ bool BufferCore::setTransformImpl(const tf2::Transform& transform_in, const std:
   if (error_exists)
     return false;
   
+  CompactFrameID frame_number;
+  bool any_time;
   {
     std::unique_lock<std::mutex> lock(frame_mutex_);
-    CompactFrameID frame_number = lookupOrInsertFrameNumber(stripped_child_frame_id);
+    frame_number = lookupOrInsertFrameNumber(stripped_child_frame_id);
     TimeCacheInterfacePtr frame = getFrame(frame_number);
     if (frame == NULL)
       frame = allocateFrame(frame_number, is_static);
 
+    TimePoint previous_latest = frame->getLatestTimestamp();
+
     if (frame->insertData(TransformStorage(stamp, transform_in.getRotation(), transform_in.getOrigin(), lookupOrInsertFrameNumber(stripped_frame_id), frame_number)))
     {
       frame_authority_[frame_number] = authority;
+      // Data appended after the latest one of a time cache can only answer lookups up to its own
+      // stamp. Anything else (out of order data, or a static cache) may answer any time.
+      any_time = !(previous_latest < stamp && frame->getLatestTimestamp() == stamp);
     }
     else
     {
@@ -294,7 +301,7 @@ bool BufferCore::setTransformImpl(const tf2::Transform& transform_in, const std:
     }
   }
 
-  testTransformableRequests();
+  testTransformableRequests(frame_number, stamp, any_time, stripped_frame_id, stripped_child_frame_id);
 
   return true;
 }
@@ -1225,20 +1232,6 @@ TransformableCallbackHandle BufferCore::addTransformableCallback(const Transform
   return handle;
 }
 
-struct BufferCore::RemoveRequestByCallback
-{
-  RemoveRequestByCallback(TransformableCallbackHandle handle)
-  : handle_(handle)
-  {}
-
-  bool operator()(const TransformableRequest& req)
-  {
-    return req.cb_handle == handle_;
-  }
-
-  TransformableCallbackHandle handle_;
-};
-
 void BufferCore::removeTransformableCallback(TransformableCallbackHandle handle)
 {
   {
@@ -1248,8 +1241,19 @@ void BufferCore::removeTransformableCallback(TransformableCallbackHandle handle)
 
   {
     std::unique_lock<std::mutex> lock(transformable_requests_mutex_);
-    V_TransformableRequest::iterator it = std::remove_if(transformable_requests_.begin(), transformable_requests_.end(), RemoveRequestByCallback(handle));
-    transformable_requests_.erase(it, transformable_requests_.end());
+    M_TransformableRequest::iterator it = transformable_requests_.begin();
+    while (it != transformable_requests_.end())
+    {
+      if (it->second.cb_handle == handle)
+      {
+        unindexTransformableRequest(it->second);
+        it = transformable_requests_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
   }
 }
 
@@ -1261,12 +1265,16 @@ TransformableRequestHandle BufferCore::addTransformableRequest(TransformableCall
     return 0;
   }
 
+  // Both mutexes are held until the request is indexed, so that no update can be missed in between
+  std::unique_lock<std::mutex> lock(transformable_requests_mutex_);
+  std::unique_lock<std::mutex> frame_lock(frame_mutex_);
+
   TransformableRequest req;
   req.target_id = lookupFrameNumber(target_frame);
   req.source_id = lookupFrameNumber(source_frame);
 
   // First check if the request is already transformable.  If it is, return immediately
-  if (canTransformInternal(req.target_id, req.source_id, time, 0))
+  if (canTransformNoLock(req.target_id, req.source_id, time, 0))
   {
     return 0;
   }
@@ -1302,34 +1310,22 @@ TransformableRequestHandle BufferCore::addTransformableRequest(TransformableCall
     req.source_string = source_frame;
   }
 
-  std::unique_lock<std::mutex> lock(transformable_requests_mutex_);
-  transformable_requests_.push_back(req);
+  TransformableRequest& stored = transformable_requests_[req.request_handle];
+  stored = req;
+  indexTransformableRequest(stored);
 
   return req.request_handle;
 }
 
-struct BufferCore::RemoveRequestByID
-{
-  RemoveRequestByID(TransformableRequestHandle handle)
-  : handle_((TransformableCallbackHandle)handle)
-  {}
-
-  bool operator()(const TransformableRequest& req)
-  {
-    return req.request_handle == handle_;
-  }
-
-  TransformableCallbackHandle handle_;
-};
-
 void BufferCore::cancelTransformableRequest(TransformableRequestHandle handle)
 {
   std::unique_lock<std::mutex> lock(transformable_requests_mutex_);
-  V_TransformableRequest::iterator it = std::remove_if(transformable_requests_.begin(), transformable_requests_.end(), RemoveRequestByID(handle));
+  M_TransformableRequest::iterator it = transformable_requests_.find(handle);
 
   if (it != transformable_requests_.end())
   {
-    transformable_requests_.erase(it, transformable_requests_.end());
+    unindexTransformableRequest(it->second);
+    transformable_requests_.erase(it);
   }
 }
 
@@ -1379,64 +1375,239 @@ void BufferCore::_getFrameStrings(std::vector<std::string> & vec) const
 
 
 
-void BufferCore::testTransformableRequests()
+void BufferCore::getTransformableRequestFrames(const TransformableRequest& req, std::vector<CompactFrameID>& frames) const
 {
-  std::unique_lock<std::mutex> lock(transformable_requests_mutex_);
-  V_TransformableRequest::iterator it = transformable_requests_.begin();
-  for (; it != transformable_requests_.end();)
+  frames.clear();
+
+  // A request for the latest data is looked up at the latest common time
+  TimePoint time = req.time;
+  if (time == TimePointZero)
   {
-    TransformableRequest& req = *it;
+    getLatestCommonTime(req.target_id, req.source_id, time, NULL);
+  }
 
-    // One or both of the frames may not have existed when the request was originally made.
+  const CompactFrameID ends[2] = {req.source_id, req.target_id};
+  for (CompactFrameID end : ends)
+  {
+    // The frames canTransform looks up at the time of the request, then the ones getLatestCommonTime
+    // looks up to tell whether the request is too old. Going on until the root of the tree visits
+    // at least all the frames they do.
+    for (int latest = 0; latest < 2; ++latest)
+    {
+      CompactFrameID frame = end;
+      for (uint32_t depth = 0; frame != 0 && depth <= MAX_GRAPH_DEPTH; ++depth)
+      {
+        frames.push_back(frame);
+
+        TimeCacheInterfacePtr cache = getFrame(frame);
+        if (!cache)
+        {
+          break;
+        }
+
+        frame = latest ? cache->getLatestTimeAndParent().second : cache->getParent(time, NULL);
+      }
+    }
+  }
+
+  std::sort(frames.begin(), frames.end());
+  frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+}
+
+void BufferCore::indexTransformableRequest(TransformableRequest& req)
+{
+  // A request for a frame which does not exist yet can only change once that frame is created
+  if (req.target_id == 0 || req.source_id == 0)
+  {
     if (req.target_id == 0)
     {
-      req.target_id = lookupFrameNumber(req.target_string);
+      transformable_requests_by_name_[req.target_string].insert(req.request_handle);
     }
 
     if (req.source_id == 0)
     {
-      req.source_id = lookupFrameNumber(req.source_string);
+      transformable_requests_by_name_[req.source_string].insert(req.request_handle);
     }
 
-    TimePoint latest_time;
-    bool do_cb = false;
-    TransformableResult result = TransformAvailable;
-    // TODO: This is incorrect, but better than nothing.  Really we want the latest time for
-    // any of the frames
-    getLatestCommonTime(req.target_id, req.source_id, latest_time, 0);
-    if ((latest_time != TimePointZero) && (req.time + cache_time_ < latest_time))
+    return;
+  }
+
+  getTransformableRequestFrames(req, req.frames);
+
+  req.frame_entries.resize(req.frames.size());
+  for (size_t i = 0; i < req.frames.size(); ++i)
+  {
+    req.frame_entries[i] = transformable_requests_by_frame_[req.frames[i]].insert(std::make_pair(req.time, req.request_handle));
+  }
+}
+
+void BufferCore::unindexTransformableRequest(TransformableRequest& req)
+{
+  const CompactFrameID ids[2] = {req.target_id, req.source_id};
+  const std::string* names[2] = {&req.target_string, &req.source_string};
+  for (int i = 0; i < 2; ++i)
+  {
+    if (ids[i] != 0)
     {
-      do_cb = true;
-      result = TransformFailure;
+      continue;
     }
-    else if (canTransformInternal(req.target_id, req.source_id, req.time, 0))
+
+    std::unordered_map<std::string, std::unordered_set<TransformableRequestHandle>>::iterator by_name = transformable_requests_by_name_.find(*names[i]);
+    if (by_name != transformable_requests_by_name_.end())
+    {
+      by_name->second.erase(req.request_handle);
+      if (by_name->second.empty())
+      {
+        transformable_requests_by_name_.erase(by_name);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < req.frames.size(); ++i)
+  {
+    std::unordered_map<CompactFrameID, M_TimeToTransformableRequest>::iterator by_frame = transformable_requests_by_frame_.find(req.frames[i]);
+    by_frame->second.erase(req.frame_entries[i]);
+    if (by_frame->second.empty())
+    {
+      transformable_requests_by_frame_.erase(by_frame);
+    }
+  }
+
+  req.frames.clear();
+  req.frame_entries.clear();
+}
+
+void BufferCore::testTransformableRequests(CompactFrameID frame_id, TimePoint stamp, bool any_time,
+                                           const std::string& frame_name, const std::string& child_frame_name)
+{
+  std::unique_lock<std::mutex> lock(transformable_requests_mutex_);
+
+  // Requests waiting for one of the frames to exist
+  std::vector<TransformableRequestHandle> candidates;
+  const std::string* names[2] = {&frame_name, &child_frame_name};
+  for (const std::string* name : names)
+  {
+    std::unordered_map<std::string, std::unordered_set<TransformableRequestHandle>>::iterator by_name = transformable_requests_by_name_.find(*name);
+    if (by_name != transformable_requests_by_name_.end())
+    {
+      candidates.insert(candidates.end(), by_name->second.begin(), by_name->second.end());
+      transformable_requests_by_name_.erase(by_name);
+    }
+  }
+
+  // Requests going through the updated frame. Unless the data is older than the one the frame
+  // already had, the requests made for a later time still need more recent data.
+  std::unordered_map<CompactFrameID, M_TimeToTransformableRequest>::iterator by_frame = transformable_requests_by_frame_.find(frame_id);
+  if (by_frame != transformable_requests_by_frame_.end())
+  {
+    M_TimeToTransformableRequest::iterator end = any_time ? by_frame->second.end() : by_frame->second.upper_bound(stamp);
+    for (M_TimeToTransformableRequest::iterator it = by_frame->second.begin(); it != end; ++it)
     {
-      do_cb = true;
-      result = TransformAvailable;
+      candidates.push_back(it->second);
     }
+  }
+
+  if (candidates.empty())
+  {
+    return;
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+  struct Result
+  {
+    TransformableRequestHandle request_handle;
+    TransformableCallbackHandle cb_handle;
+    TimePoint time;
+    TransformableResult result;
+    std::string target_frame;
+    std::string source_frame;
+  };
+  std::vector<Result> results;
+
+  {
+    std::unique_lock<std::mutex> frame_lock(frame_mutex_);
+    std::vector<CompactFrameID> frames;
 
-    if (do_cb)
+    for (TransformableRequestHandle handle : candidates)
     {
+      M_TransformableRequest::iterator it = transformable_requests_.find(handle);
+      if (it == transformable_requests_.end())
       {
-        std::unique_lock<std::mutex> lock2(transformable_callbacks_mutex_);
-        M_TransformableCallback::iterator it = transformable_callbacks_.find(req.cb_handle);
-        if (it != transformable_callbacks_.end())
-        {
-          const TransformableCallback& cb = it->second;
-          cb(req.request_handle, lookupFrameString(req.target_id), lookupFrameString(req.source_id), req.time, result);
-        }
+        continue;
+      }
+
+      TransformableRequest& req = it->second;
+      bool was_named = req.target_id == 0 || req.source_id == 0;
+
+      // One or both of the frames may not have existed when the request was originally made.
+      if (req.target_id == 0)
+      {
+        req.target_id = lookupFrameNumber(req.target_string);
+      }
+
+      if (req.source_id == 0)
+      {
+        req.source_id = lookupFrameNumber(req.source_string);
+      }
+
+      TimePoint latest_time;
+      bool do_cb = false;
+      TransformableResult result = TransformAvailable;
+      // TODO: This is incorrect, but better than nothing.  Really we want the latest time for
+      // any of the frames
+      getLatestCommonTime(req.target_id, req.source_id, latest_time, 0);
+      if ((latest_time != TimePointZero) && (req.time + cache_time_ < latest_time))
+      {
+        do_cb = true;
+        result = TransformFailure;
+      }
+      else if (canTransformNoLock(req.target_id, req.source_id, req.time, 0))
+      {
+        do_cb = true;
+        result = TransformAvailable;
       }
 
-      if (transformable_requests_.size() > 1)
+      if (do_cb)
       {
-        transformable_requests_[it - transformable_requests_.begin()] = transformable_requests_.back();
+        unindexTransformableRequest(req);
+        Result done = {req.request_handle, req.cb_handle, req.time, result,
+                       lookupFrameString(req.target_id), lookupFrameString(req.source_id)};
+        results.push_back(done);
+        transformable_requests_.erase(it);
+        continue;
       }
 
-      transformable_requests_.erase(transformable_requests_.end() - 1);
+      // Still pending, the update may have changed the frames it depends on
+      if (was_named)
+      {
+        // Its entries for the names of the update were removed above
+        indexTransformableRequest(req);
+      }
+      else
+      {
+        getTransformableRequestFrames(req, frames);
+        if (frames != req.frames)
+        {
+          unindexTransformableRequest(req);
+          indexTransformableRequest(req);
+        }
+      }
     }
-    else
+  }
+
+  if (!results.empty())
+  {
+    std::unique_lock<std::mutex> lock2(transformable_callbacks_mutex_);
+    for (const Result& done : results)
     {
-      ++it;
+      M_TransformableCallback::iterator it = transformable_callbacks_.find(done.cb_handle);
+      if (it != transformable_callbacks_.end())
+      {
+        const TransformableCallback& cb = it->second;
+        cb(done.request_handle, done.target_frame, done.source_frame, done.time, done.result);
+      }
     }
   }
 
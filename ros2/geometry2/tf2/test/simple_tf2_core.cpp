@@ -28,6 +28,8 @@
  */
 
 #include <chrono>
+#include <functional>
+#include <map>
 #include <gtest/gtest.h>
 #include <tf2/buffer_core.h>
 #include "tf2/LinearMath/Vector3.h"
@@ -178,6 +180,144 @@ TEST(tf2_time, To_From_Duration)
 }
 
 
+static geometry_msgs::msg::TransformStamped makeTransform(
+  const std::string& frame_id, const std::string& child_frame_id, int32_t sec)
+{
+  geometry_msgs::msg::TransformStamped st;
+  st.header.frame_id = frame_id;
+  st.header.stamp.sec = sec;
+  st.header.stamp.nanosec = 0;
+  st.child_frame_id = child_frame_id;
+  st.transform.rotation.w = 1;
+  return st;
+}
+
+struct TransformableResults
+{
+  void callback(tf2::TransformableRequestHandle request_handle, const std::string& target_frame,
+                const std::string& source_frame, tf2::TimePoint time, tf2::TransformableResult result)
+  {
+    (void)target_frame;
+    (void)source_frame;
+    (void)time;
+    results[request_handle] = result;
+  }
+
+  std::map<tf2::TransformableRequestHandle, tf2::TransformableResult> results;
+};
+
+TEST(tf2_transformableRequests, Available_When_Data_Arrives)
+{
+  tf2::BufferCore tfc;
+  TransformableResults results;
+  tf2::TransformableCallbackHandle cb = tfc.addTransformableCallback(std::bind(
+    &TransformableResults::callback, &results, std::placeholders::_1, std::placeholders::_2,
+    std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
+
+  EXPECT_TRUE(tfc.setTransform(makeTransform("world", "base", 1), "authority1"));
+  EXPECT_TRUE(tfc.setTransform(makeTransform("base", "laser", 1), "authority1"));
+
+  // Already transformable
+  EXPECT_EQ(0u, tfc.addTransformableRequest(cb, "world", "laser", tf2::TimePoint(std::chrono::seconds(1))));
+
+  tf2::TransformableRequestHandle early = tfc.addTransformableRequest(cb, "world", "laser", tf2::TimePoint(std::chrono::seconds(2)));
+  tf2::TransformableRequestHandle late = tfc.addTransformableRequest(cb, "world", "laser", tf2::TimePoint(std::chrono::seconds(4)));
+  ASSERT_NE(0u, early);
+  ASSERT_NE(0u, late);
+
+  // Only one of the frames on the path is up to date
+  EXPECT_TRUE(tfc.setTransform(makeTransform("base", "laser", 3), "authority1"));
+  EXPECT_TRUE(results.results.empty());
+
+  EXPECT_TRUE(tfc.setTransform(makeTransform("world", "base", 3), "authority1"));
+  ASSERT_EQ(1u, results.results.size());
+  EXPECT_EQ(tf2::TransformAvailable, results.results[early]);
+
+  EXPECT_TRUE(tfc.setTransform(makeTransform("world", "base", 5), "authority1"));
+  EXPECT_TRUE(tfc.setTransform(makeTransform("base", "laser", 5), "authority1"));
+  ASSERT_EQ(2u, results.results.size());
+  EXPECT_EQ(tf2::TransformAvailable, results.results[late]);
+}
+
+TEST(tf2_transformableRequests, Available_When_Frames_Are_Created)
+{
+  tf2::BufferCore tfc;
+  TransformableResults results;
+  tf2::TransformableCallbackHandle cb = tfc.addTransformableCallback(std::bind(
+    &TransformableResults::callback, &results, std::placeholders::_1, std::placeholders::_2,
+    std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
+
+  tf2::TransformableRequestHandle handle = tfc.addTransformableRequest(cb, "world", "laser", tf2::TimePoint(std::chrono::seconds(1)));
+  ASSERT_NE(0u, handle);
+
+  EXPECT_TRUE(tfc.setTransform(makeTransform("world", "base", 1), "authority1"));
+  EXPECT_TRUE(results.results.empty());
+
+  // Connects the tree, through a frame the request was not waiting for
+  EXPECT_TRUE(tfc.setTransform(makeTransform("odom", "laser", 1), "authority1"));
+  EXPECT_TRUE(results.results.empty());
+  EXPECT_TRUE(tfc.setTransform(makeTransform("base", "odom", 1), "authority1"));
+  ASSERT_EQ(1u, results.results.size());
+  EXPECT_EQ(tf2::TransformAvailable, results.results[handle]);
+}
+
+TEST(tf2_transformableRequests, Out_Of_Order_And_Static_Data)
+{
+  tf2::BufferCore tfc;
+  TransformableResults results;
+  tf2::TransformableCallbackHandle cb = tfc.addTransformableCallback(std::bind(
+    &TransformableResults::callback, &results, std::placeholders::_1, std::placeholders::_2,
+    std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
+
+  EXPECT_TRUE(tfc.setTransform(makeTransform("world", "base", 5), "authority1"));
+  EXPECT_TRUE(tfc.setTransform(makeTransform("base", "laser", 5), "authority1"));
+
+  // Older than all the data of the frames
+  tf2::TransformableRequestHandle past = tfc.addTransformableRequest(cb, "world", "laser", tf2::TimePoint(std::chrono::seconds(3)));
+  ASSERT_NE(0u, past);
+
+  EXPECT_TRUE(tfc.setTransform(makeTransform("world", "base", 2), "authority1"));
+  EXPECT_TRUE(results.results.empty());
+  EXPECT_TRUE(tfc.setTransform(makeTransform("base", "laser", 2), "authority1"));
+  ASSERT_EQ(1u, results.results.size());
+  EXPECT_EQ(tf2::TransformAvailable, results.results[past]);
+
+  // Static data is valid at any time
+  tf2::TransformableRequestHandle later = tfc.addTransformableRequest(cb, "world", "camera", tf2::TimePoint(std::chrono::seconds(4)));
+  ASSERT_NE(0u, later);
+  EXPECT_TRUE(tfc.setTransform(makeTransform("laser", "camera", 1), "authority1", true));
+  ASSERT_EQ(2u, results.results.size());
+  EXPECT_EQ(tf2::TransformAvailable, results.results[later]);
+}
+
+TEST(tf2_transformableRequests, Failure_When_Too_Old)
+{
+  tf2::BufferCore tfc(tf2::Duration(std::chrono::seconds(10)));
+  TransformableResults results;
+  tf2::TransformableCallbackHandle cb = tfc.addTransformableCallback(std::bind(
+    &TransformableResults::callback, &results, std::placeholders::_1, std::placeholders::_2,
+    std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
+
+  EXPECT_TRUE(tfc.setTransform(makeTransform("world", "base", 5), "authority1"));
+  EXPECT_TRUE(tfc.setTransform(makeTransform("base", "laser", 5), "authority1"));
+
+  tf2::TransformableRequestHandle handle = tfc.addTransformableRequest(cb, "world", "laser", tf2::TimePoint(std::chrono::seconds(1)));
+  tf2::TransformableRequestHandle cancelled = tfc.addTransformableRequest(cb, "world", "laser", tf2::TimePoint(std::chrono::seconds(2)));
+  ASSERT_NE(0u, handle);
+  ASSERT_NE(0u, cancelled);
+  tfc.cancelTransformableRequest(cancelled);
+
+  EXPECT_TRUE(tfc.setTransform(makeTransform("world", "base", 20), "authority1"));
+  EXPECT_TRUE(results.results.empty());
+  EXPECT_TRUE(tfc.setTransform(makeTransform("base", "laser", 20), "authority1"));
+  ASSERT_EQ(1u, results.results.size());
+  EXPECT_EQ(tf2::TransformFailure, results.results[handle]);
+
+  // Too old already
+  EXPECT_EQ(0xffffffffffffffffULL, tfc.addTransformableRequest(cb, "world", "laser", tf2::TimePoint(std::chrono::seconds(1))));
+}
+
+
 int main(int argc, char **argv){
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
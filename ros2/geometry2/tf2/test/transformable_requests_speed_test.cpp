@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2018, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the cost of setTransform while tf2_ros::MessageFilter like users keep requests pending:
+// every filter queues messages stamped ahead of the transforms received so far, and waits for them
+// to become transformable to its target frame.
+//
+// Usage: transformable_requests_speed_test [filters] [queue_size] [joints] [updates]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <tf2/buffer_core.h>
+
+namespace
+{
+
+struct Filter
+{
+  std::string target_frame;
+  std::string source_frame;
+  tf2::TimePoint next_stamp;
+  size_t pending;
+};
+
+geometry_msgs::msg::TransformStamped makeTransform(
+  const std::string& frame_id, const std::string& child_frame_id, tf2::TimePoint stamp)
+{
+  std::chrono::nanoseconds ns = stamp.time_since_epoch();
+  geometry_msgs::msg::TransformStamped t;
+  t.header.stamp.sec = static_cast<int32_t>(ns.count() / 1000000000);
+  t.header.stamp.nanosec = static_cast<uint32_t>(ns.count() % 1000000000);
+  t.header.frame_id = frame_id;
+  t.child_frame_id = child_frame_id;
+  t.transform.translation.x = 1;
+  t.transform.rotation.w = 1.0;
+  return t;
+}
+
+double run(size_t num_filters, size_t queue_size, size_t num_joints, size_t num_updates)
+{
+  const tf2::Duration period = std::chrono::milliseconds(10);
+  const char* targets[] = {"map", "odom", "base_link"};
+
+  tf2::BufferCore bc;
+  std::vector<Filter> filters(num_filters);
+  tf2::TransformableCallbackHandle cb = bc.addTransformableCallback(
+    [&filters](tf2::TransformableRequestHandle, const std::string& target_frame,
+               const std::string& source_frame, tf2::TimePoint, tf2::TransformableResult)
+    {
+      for (Filter& filter : filters)
+      {
+        if (filter.target_frame == target_frame && filter.source_frame == source_frame && filter.pending > 0)
+        {
+          --filter.pending;
+          break;
+        }
+      }
+    });
+
+  tf2::TimePoint now(std::chrono::seconds(1));
+  std::vector<geometry_msgs::msg::TransformStamped> transforms;
+  transforms.push_back(makeTransform("map", "odom", now));
+  transforms.push_back(makeTransform("odom", "base_link", now));
+  for (size_t i = 0; i < num_filters; ++i)
+  {
+    filters[i].target_frame = targets[i % 3];
+    filters[i].source_frame = "sensor_" + std::to_string(i);
+    filters[i].next_stamp = now + period;
+    filters[i].pending = 0;
+    transforms.push_back(makeTransform("base_link", filters[i].source_frame, now));
+  }
+  for (size_t i = 0; i < num_joints; ++i)
+  {
+    transforms.push_back(makeTransform("base_link", "joint_" + std::to_string(i), now));
+  }
+
+  std::chrono::nanoseconds elapsed(0);
+  size_t calls = 0;
+  for (size_t update = 0; update < num_updates; ++update)
+  {
+    // The filters receive messages ahead of the transforms
+    for (Filter& filter : filters)
+    {
+      while (filter.pending < queue_size)
+      {
+        tf2::TransformableRequestHandle handle = bc.addTransformableRequest(
+          cb, filter.target_frame, filter.source_frame, filter.next_stamp);
+        if (handle != 0 && handle != 0xffffffffffffffffULL)
+        {
+          ++filter.pending;
+        }
+        filter.next_stamp += period;
+      }
+    }
+
+    now += period;
+    auto start = std::chrono::steady_clock::now();
+    for (geometry_msgs::msg::TransformStamped& t : transforms)
+    {
+      std::chrono::nanoseconds ns = now.time_since_epoch();
+      t.header.stamp.sec = static_cast<int32_t>(ns.count() / 1000000000);
+      t.header.stamp.nanosec = static_cast<uint32_t>(ns.count() % 1000000000);
+      bc.setTransform(t, "me");
+    }
+    elapsed += std::chrono::steady_clock::now() - start;
+    calls += transforms.size();
+  }
+
+  return static_cast<double>(elapsed.count()) / static_cast<double>(calls);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  size_t num_filters = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 5;
+  size_t queue_size = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 100;
+  size_t num_joints = argc > 3 ? std::strtoul(argv[3], NULL, 10) : 20;
+  size_t num_updates = argc > 4 ? std::strtoul(argv[4], NULL, 10) : 2000;
+
+  printf("%zu filters, %zu queued messages each, %zu other frames, %zu updates\n",
+         num_filters, queue_size, num_joints, num_updates);
+  printf("setTransform without pending requests: %10.1f ns\n", run(0, 0, num_filters + num_joints, num_updates));
+  printf("setTransform with pending requests:    %10.1f ns\n", run(num_filters, queue_size, num_joints, num_updates));
+
+  return 0;
+}
@@ -26,6 +26,7 @@ extern "C"
 
 #include "rcl/arguments.h"
 #include "rcl/error_handling.h"
+#include "rcl/expand_topic_name.h"
 #include "rcl/rcl.h"
 #include "rcl/remap.h"
 #include "rcutils/filesystem.h"
@@ -36,21 +37,40 @@ extern "C"
 #include "rcutils/macros.h"
 #include "rcutils/repl_str.h"
 #include "rcutils/snprintf.h"
+#include "rcutils/stdatomic_helper.h"
 #include "rcutils/strdup.h"
+#include "rcutils/types/string_map.h"
 #include "rmw/error_handling.h"
 #include "rmw/node_security_options.h"
 #include "rmw/rmw.h"
+#include "rmw/validate_full_topic_name.h"
 #include "rmw/validate_namespace.h"
 #include "rmw/validate_node_name.h"
 
 #include "./common.h"
 #include "./context_impl.h"
+#include "./node_impl.h"
 
 #define ROS_SECURITY_NODE_DIRECTORY_VAR_NAME "ROS_SECURITY_NODE_DIRECTORY"
 #define ROS_SECURITY_ROOT_DIRECTORY_VAR_NAME "ROS_SECURITY_ROOT_DIRECTORY"
 #define ROS_SECURITY_STRATEGY_VAR_NAME "ROS_SECURITY_STRATEGY"
 #define ROS_SECURITY_ENABLE_VAR_NAME "ROS_SECURITY_ENABLE"
 
+// Number of lists of resolved names, a power of two
+#define RCL_NODE_RESOLVED_NAME_BUCKETS 64
+// Names are no longer memoized past this many, in case a node makes up names at runtime
+#define RCL_NODE_RESOLVED_NAME_MAX 4096
+
+/// A topic or service name resolved for a node, immutable once it is in the node's lists.
+typedef struct rcl_node_resolved_name_t
+{
+  struct rcl_node_resolved_name_t * next;
+  rcl_remap_type_t type;
+  size_t hash;
+  char * input_name;
+  char * resolved_name;
+} rcl_node_resolved_name_t;
+
 typedef struct rcl_node_impl_t
 {
   rcl_node_options_t options;
@@ -58,8 +78,33 @@ typedef struct rcl_node_impl_t
   rmw_node_t * rmw_node_handle;
   rcl_guard_condition_t * graph_guard_condition;
   const char * logger_name;
+  /// Substitutions used to expand the topic and service names of the node.
+  rcutils_string_map_t substitutions;
+  /// Topic and service remap rules compiled for the name and namespace of the node.
+  rcl_remap_matcher_t remap_matcher;
+  /// Lists of resolved names, which are only prepended to until the node is finalized.
+  atomic_uintptr_t resolved_names[RCL_NODE_RESOLVED_NAME_BUCKETS];
+  atomic_uint_least64_t num_resolved_names;
 } rcl_node_impl_t;
 
+/// Free the resolved names of a node, which must not be used by any other thread.
+static void
+_rcl_node_fini_resolved_names(rcl_node_impl_t * impl, rcl_allocator_t allocator)
+{
+  for (size_t i = 0; i < RCL_NODE_RESOLVED_NAME_BUCKETS; ++i) {
+    rcl_node_resolved_name_t * entry =
+      (rcl_node_resolved_name_t *)rcutils_atomic_load_uintptr_t(&impl->resolved_names[i]);
+    while (NULL != entry) {
+      rcl_node_resolved_name_t * next = entry->next;
+      allocator.deallocate(entry->input_name, allocator.state);
+      allocator.deallocate(entry->resolved_name, allocator.state);
+      allocator.deallocate(entry, allocator.state);
+      entry = next;
+    }
+    rcutils_atomic_store(&impl->resolved_names[i], (uintptr_t)0);
+  }
+}
+
 
 /// Return the logger name associated with a node given the validated node name and namespace.
 /**
@@ -284,6 +329,12 @@ rcl_node_init(
   node->impl->graph_guard_condition = NULL;
   node->impl->logger_name = NULL;
   node->impl->options = rcl_node_get_default_options();
+  node->impl->substitutions = rcutils_get_zero_initialized_string_map();
+  node->impl->remap_matcher = rcl_remap_get_zero_initialized_matcher();
+  for (size_t i = 0; i < RCL_NODE_RESOLVED_NAME_BUCKETS; ++i) {
+    atomic_init(&node->impl->resolved_names[i], (uintptr_t)0);
+  }
+  atomic_init(&node->impl->num_resolved_names, (uint64_t)0);
   node->context = context;
   // Initialize node impl.
   ret = rcl_node_options_copy(options, &(node->impl->options));
@@ -421,6 +472,23 @@ rcl_node_init(
     // error message already set
     goto fail;
   }
+  // substitutions and remap rules used to resolve the names of the node's entities
+  if (RCUTILS_RET_OK != rcutils_string_map_init(&node->impl->substitutions, 0, *allocator)) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    goto fail;
+  }
+  ret = rcl_get_default_topic_name_substitutions(&node->impl->substitutions);
+  if (ret != RCL_RET_OK) {
+    goto fail;
+  }
+  ret = rcl_remap_matcher_init(
+    &(node->impl->options.arguments), global_args,
+    node->impl->rmw_node_handle->name, node->impl->rmw_node_handle->namespace_,
+    &node->impl->substitutions, *allocator, &node->impl->remap_matcher);
+  if (ret != RCL_RET_OK) {
+    // error message already set
+    goto fail;
+  }
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Node initialized");
   ret = RCL_RET_OK;
   goto cleanup;
@@ -448,6 +516,18 @@ fail:
       }
       allocator->deallocate(node->impl->graph_guard_condition, allocator->state);
     }
+    if (RCUTILS_RET_OK != rcutils_string_map_fini(&node->impl->substitutions)) {
+      RCUTILS_LOG_ERROR_NAMED(
+        ROS_PACKAGE_NAME,
+        "failed to fini string_map in error recovery: %s", rcutils_get_error_string().str
+      );
+    }
+    if (RCL_RET_OK != rcl_remap_matcher_fini(&node->impl->remap_matcher)) {
+      RCUTILS_LOG_ERROR_NAMED(
+        ROS_PACKAGE_NAME,
+        "failed to fini remap matcher in error recovery: %s", rcl_get_error_string().str
+      );
+    }
     if (NULL != node->impl->options.arguments.impl) {
       ret = rcl_arguments_fini(&(node->impl->options.arguments));
       if (ret != RCL_RET_OK) {
@@ -498,6 +578,16 @@ rcl_node_fini(rcl_node_t * node)
   allocator.deallocate(node->impl->graph_guard_condition, allocator.state);
   // assuming that allocate and deallocate are ok since they are checked in init
   allocator.deallocate((char *)node->impl->logger_name, allocator.state);
+  _rcl_node_fini_resolved_names(node->impl, allocator);
+  if (RCUTILS_RET_OK != rcutils_string_map_fini(&node->impl->substitutions)) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    result = RCL_RET_ERROR;
+  }
+  // The rules it points to are finalized with the arguments below
+  rcl_ret = rcl_remap_matcher_fini(&node->impl->remap_matcher);
+  if (rcl_ret != RCL_RET_OK) {
+    result = RCL_RET_ERROR;
+  }
   if (NULL != node->impl->options.arguments.impl) {
     rcl_ret_t ret = rcl_arguments_fini(&(node->impl->options.arguments));
     if (ret != RCL_RET_OK) {
@@ -644,6 +734,144 @@ rcl_node_get_logger_name(const rcl_node_t * node)
   return node->impl->logger_name;
 }
 
+static inline bool
+_rcl_node_compare_exchange_uintptr_t(
+  atomic_uintptr_t * a_uintptr_t, uintptr_t * expected, uintptr_t desired)
+{
+  bool result;
+#if defined(__clang__)
+# pragma clang diagnostic push
+  // we know it's a gnu feature, but clang supports it, so suppress pedantic warning
+# pragma clang diagnostic ignored "-Wgnu-statement-expression"
+#endif
+  rcutils_atomic_compare_exchange_strong(a_uintptr_t, result, expected, desired);
+#if defined(__clang__)
+# pragma clang diagnostic pop
+#endif
+  return result;
+}
+
+/// Memoize a resolved name, on failure it is only resolved again next time.
+static void
+_rcl_node_add_resolved_name(
+  rcl_node_impl_t * impl,
+  const char * input_name,
+  rcl_remap_type_t type,
+  size_t hash,
+  const char * resolved_name)
+{
+  if (rcutils_atomic_fetch_add_uint64_t(&impl->num_resolved_names, 1) >=
+    RCL_NODE_RESOLVED_NAME_MAX)
+  {
+    return;
+  }
+  rcl_allocator_t allocator = impl->options.allocator;
+  rcl_node_resolved_name_t * entry = (rcl_node_resolved_name_t *)allocator.allocate(
+    sizeof(rcl_node_resolved_name_t), allocator.state);
+  if (NULL == entry) {
+    return;
+  }
+  entry->type = type;
+  entry->hash = hash;
+  entry->input_name = rcutils_strdup(input_name, allocator);
+  entry->resolved_name = rcutils_strdup(resolved_name, allocator);
+  if (NULL == entry->input_name || NULL == entry->resolved_name) {
+    if (NULL != entry->input_name) {
+      allocator.deallocate(entry->input_name, allocator.state);
+    }
+    if (NULL != entry->resolved_name) {
+      allocator.deallocate(entry->resolved_name, allocator.state);
+    }
+    allocator.deallocate(entry, allocator.state);
+    return;
+  }
+  // Two threads resolving the same name may both add it, which is harmless
+  atomic_uintptr_t * head = &impl->resolved_names[hash & (RCL_NODE_RESOLVED_NAME_BUCKETS - 1)];
+  uintptr_t expected = rcutils_atomic_load_uintptr_t(head);
+  do {
+    entry->next = (rcl_node_resolved_name_t *)expected;
+  } while (!_rcl_node_compare_exchange_uintptr_t(head, &expected, (uintptr_t)entry));
+}
+
+rcl_ret_t
+rcl_node_resolve_name(
+  const rcl_node_t * node,
+  const char * input_name,
+  rcl_remap_type_t type,
+  rcl_allocator_t allocator,
+  char ** output_name)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(input_name, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(output_name, RCL_RET_INVALID_ARGUMENT);
+  const rcl_ret_t invalid_name_ret =
+    (RCL_SERVICE_REMAP == type) ? RCL_RET_SERVICE_NAME_INVALID : RCL_RET_TOPIC_NAME_INVALID;
+  rcl_node_impl_t * impl = node->impl;
+  *output_name = NULL;
+
+  // Look for the name among the ones already resolved
+  const size_t hash = rcl_remap_hash_name(input_name);
+  const rcl_node_resolved_name_t * entry = (const rcl_node_resolved_name_t *)
+    rcutils_atomic_load_uintptr_t(
+    &impl->resolved_names[hash & (RCL_NODE_RESOLVED_NAME_BUCKETS - 1)]);
+  for (; NULL != entry; entry = entry->next) {
+    if (entry->type == type && entry->hash == hash && 0 == strcmp(entry->input_name, input_name)) {
+      *output_name = rcutils_strdup(entry->resolved_name, allocator);
+      if (NULL == *output_name) {
+        RCL_SET_ERROR_MSG("allocating memory failed");
+        return RCL_RET_BAD_ALLOC;
+      }
+      return RCL_RET_OK;
+    }
+  }
+
+  // Expand the name
+  char * expanded_name = NULL;
+  rcl_ret_t ret = rcl_expand_topic_name(
+    input_name,
+    impl->rmw_node_handle->name,
+    impl->rmw_node_handle->namespace_,
+    &impl->substitutions,
+    allocator,
+    &expanded_name);
+  if (ret != RCL_RET_OK) {
+    if (ret == RCL_RET_TOPIC_NAME_INVALID || ret == RCL_RET_UNKNOWN_SUBSTITUTION) {
+      return invalid_name_ret;
+    }
+    return RCL_RET_ERROR;
+  }
+  // Remap it
+  const char * remapped_name = NULL;
+  ret = rcl_remap_matcher_lookup(&impl->remap_matcher, type, expanded_name, &remapped_name);
+  if (ret != RCL_RET_OK) {
+    allocator.deallocate(expanded_name, allocator.state);
+    return RCL_RET_ERROR;
+  }
+  if (NULL != remapped_name) {
+    allocator.deallocate(expanded_name, allocator.state);
+    expanded_name = rcutils_strdup(remapped_name, allocator);
+    if (NULL == expanded_name) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return RCL_RET_BAD_ALLOC;
+    }
+  }
+  // Validate it
+  int validation_result;
+  rmw_ret_t rmw_ret = rmw_validate_full_topic_name(expanded_name, &validation_result, NULL);
+  if (rmw_ret != RMW_RET_OK) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    allocator.deallocate(expanded_name, allocator.state);
+    return RCL_RET_ERROR;
+  }
+  if (validation_result != RMW_TOPIC_VALID) {
+    RCL_SET_ERROR_MSG(rmw_full_topic_name_validation_result_string(validation_result));
+    allocator.deallocate(expanded_name, allocator.state);
+    return invalid_name_ret;
+  }
+  _rcl_node_add_resolved_name(impl, input_name, type, hash, expanded_name);
+  *output_name = expanded_name;
+  return RCL_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,60 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__NODE_IMPL_H_
+#define RCL__NODE_IMPL_H_
+
+#include "rcl/node.h"
+
+#include "./remap_impl.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Expand, remap and validate the topic or service name of an entity of a node.
+/**
+ * The remap rules of the node are compiled once when the node is initialized, and the names
+ * resolved here are memoized by the node, so creating many entities with the same name does not
+ * expand and match the rules again.
+ * Names which fail to resolve are not memoized.
+ *
+ * This function may be called concurrently for the same node.
+ *
+ * \param[in] node A valid node.
+ * \param[in] input_name The topic or service name given for the entity.
+ * \param[in] type Either RCL_TOPIC_REMAP or RCL_SERVICE_REMAP.
+ * \param[in] allocator The allocator used to allocate the output name.
+ * \param[out] output_name The fully qualified, remapped and valid name.
+ * \return `RCL_RET_OK` if the name was resolved, or
+ * \return `RCL_RET_TOPIC_NAME_INVALID` if the topic name is invalid, or
+ * \return `RCL_RET_SERVICE_NAME_INVALID` if the service name is invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_node_resolve_name(
+  const rcl_node_t * node,
+  const char * input_name,
+  rcl_remap_type_t type,
+  rcl_allocator_t allocator,
+  char ** output_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__NODE_IMPL_H_
@@ -14,6 +14,8 @@
 
 #include "rcl/remap.h"
 
+#include <string.h>
+
 #include "./arguments_impl.h"
 #include "./remap_impl.h"
 #include "rcl/error_handling.h"
@@ -311,6 +313,257 @@ rcl_remap_node_namespace(
     allocator, output_namespace);
 }
 
+size_t
+rcl_remap_hash_name(const char * name)
+{
+  // FNV-1a
+  size_t hash = 2166136261u;
+  for (const char * c = name; '\0' != *c; ++c) {
+    hash = (hash ^ (unsigned char)*c) * 16777619u;
+  }
+  return hash;
+}
+
+rcl_remap_matcher_t
+rcl_remap_get_zero_initialized_matcher()
+{
+  rcl_remap_matcher_t matcher;
+  matcher.slots = NULL;
+  matcher.capacity = 0;
+  matcher.allocator = rcutils_get_zero_initialized_allocator();
+  return matcher;
+}
+
+/// Get the slot of a type and name, which is empty if no rule matched them.
+RCL_LOCAL
+rcl_remap_compiled_t *
+_rcl_remap_matcher_find(
+  const rcl_remap_matcher_t * matcher,
+  rcl_remap_type_t type,
+  const char * name,
+  size_t hash)
+{
+  // The table is never full, so probing always ends on the slot or on an empty one
+  const size_t mask = matcher->capacity - 1;
+  for (size_t i = (hash + type) & mask; ; i = (i + 1) & mask) {
+    rcl_remap_compiled_t * slot = &(matcher->slots[i]);
+    if (NULL == slot->match ||
+      (slot->type == type && slot->hash == hash && 0 == strcmp(slot->match, name)))
+    {
+      return slot;
+    }
+  }
+}
+
+/// Count the topic and service rules that could apply to a node, once per type.
+RCL_LOCAL
+size_t
+_rcl_remap_count_candidates(const rcl_arguments_t * arguments, const char * node_name)
+{
+  size_t count = 0;
+  for (int i = 0; i < arguments->impl->num_remap_rules; ++i) {
+    const rcl_remap_t * rule = &(arguments->impl->remap_rules[i]);
+    if (rule->node_name != NULL && 0 != strcmp(rule->node_name, node_name)) {
+      continue;
+    }
+    count += (rule->type & RCL_TOPIC_REMAP) ? 1 : 0;
+    count += (rule->type & RCL_SERVICE_REMAP) ? 1 : 0;
+  }
+  return count;
+}
+
+/// Add the rules of some arguments to a matcher, keeping rules added before.
+RCL_LOCAL
+rcl_ret_t
+_rcl_remap_matcher_add(
+  rcl_remap_matcher_t * matcher,
+  const rcl_arguments_t * arguments,
+  const char * node_name,
+  const char * node_namespace,
+  const rcutils_string_map_t * substitutions)
+{
+  const rcl_remap_type_t types[] = {RCL_TOPIC_REMAP, RCL_SERVICE_REMAP};
+  rcl_allocator_t allocator = matcher->allocator;
+  for (int i = 0; i < arguments->impl->num_remap_rules; ++i) {
+    const rcl_remap_t * rule = &(arguments->impl->remap_rules[i]);
+    if (!(rule->type & (RCL_TOPIC_REMAP | RCL_SERVICE_REMAP))) {
+      continue;
+    }
+    if (rule->node_name != NULL && 0 != strcmp(rule->node_name, node_name)) {
+      continue;
+    }
+    char * expanded_match = NULL;
+    rcl_ret_t ret = rcl_expand_topic_name(
+      rule->match, node_name, node_namespace, substitutions, allocator, &expanded_match);
+    if (RCL_RET_OK != ret) {
+      rcl_reset_error();
+      if (
+        RCL_RET_NODE_INVALID_NAMESPACE == ret ||
+        RCL_RET_NODE_INVALID_NAME == ret ||
+        RCL_RET_BAD_ALLOC == ret)
+      {
+        return ret;
+      }
+      continue;
+    }
+    const size_t hash = rcl_remap_hash_name(expanded_match);
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+      if (!(rule->type & types[t])) {
+        continue;
+      }
+      rcl_remap_compiled_t * slot = _rcl_remap_matcher_find(
+        matcher, types[t], expanded_match, hash);
+      if (NULL != slot->match) {
+        // An earlier rule matches the same name
+        continue;
+      }
+      char * expanded_replacement = NULL;
+      ret = rcl_expand_topic_name(
+        rule->replacement, node_name, node_namespace, substitutions, allocator,
+        &expanded_replacement);
+      if (RCL_RET_OK != ret) {
+        rcl_reset_error();
+        if (RCL_RET_BAD_ALLOC == ret) {
+          allocator.deallocate(expanded_match, allocator.state);
+          return ret;
+        }
+        // Reported when a name is remapped by this rule
+        expanded_replacement = NULL;
+      }
+      char * match = rcutils_strdup(expanded_match, allocator);
+      if (NULL == match) {
+        if (NULL != expanded_replacement) {
+          allocator.deallocate(expanded_replacement, allocator.state);
+        }
+        allocator.deallocate(expanded_match, allocator.state);
+        return RCL_RET_BAD_ALLOC;
+      }
+      slot->type = types[t];
+      slot->hash = hash;
+      slot->match = match;
+      slot->replacement = expanded_replacement;
+      slot->rule = rule;
+    }
+    allocator.deallocate(expanded_match, allocator.state);
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_remap_matcher_init(
+  const rcl_arguments_t * local_arguments,
+  const rcl_arguments_t * global_arguments,
+  const char * node_name,
+  const char * node_namespace,
+  const rcutils_string_map_t * substitutions,
+  rcl_allocator_t allocator,
+  rcl_remap_matcher_t * matcher)
+{
+  RCL_CHECK_ALLOCATOR_WITH_MSG(&allocator, "allocator is invalid", return RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(node_name, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(node_namespace, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(substitutions, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(matcher, RCL_RET_INVALID_ARGUMENT);
+  if (NULL != local_arguments && NULL == local_arguments->impl) {
+    local_arguments = NULL;
+  }
+  if (NULL != global_arguments && NULL == global_arguments->impl) {
+    global_arguments = NULL;
+  }
+
+  *matcher = rcl_remap_get_zero_initialized_matcher();
+  matcher->allocator = allocator;
+  size_t count = 0;
+  if (NULL != local_arguments) {
+    count += _rcl_remap_count_candidates(local_arguments, node_name);
+  }
+  if (NULL != global_arguments) {
+    count += _rcl_remap_count_candidates(global_arguments, node_name);
+  }
+  if (0u == count) {
+    return RCL_RET_OK;
+  }
+  // Keep the table at most half full
+  size_t capacity = 8;
+  while (capacity < 2 * count) {
+    capacity *= 2;
+  }
+  matcher->slots = (rcl_remap_compiled_t *)allocator.zero_allocate(
+    capacity, sizeof(rcl_remap_compiled_t), allocator.state);
+  if (NULL == matcher->slots) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  matcher->capacity = capacity;
+
+  // Local rules first, so they are kept over global rules matching the same name
+  rcl_ret_t ret = RCL_RET_OK;
+  if (NULL != local_arguments) {
+    ret = _rcl_remap_matcher_add(
+      matcher, local_arguments, node_name, node_namespace, substitutions);
+  }
+  if (RCL_RET_OK == ret && NULL != global_arguments) {
+    ret = _rcl_remap_matcher_add(
+      matcher, global_arguments, node_name, node_namespace, substitutions);
+  }
+  if (RCL_RET_OK != ret) {
+    RCL_SET_ERROR_MSG("failed to compile the remap rules of the node");
+    if (RCL_RET_OK != rcl_remap_matcher_fini(matcher)) {
+      RCL_SET_ERROR_MSG("Error while finalizing remap matcher due to another error");
+    }
+  }
+  return ret;
+}
+
+rcl_ret_t
+rcl_remap_matcher_lookup(
+  const rcl_remap_matcher_t * matcher,
+  rcl_remap_type_t type,
+  const char * name,
+  const char ** output_name)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(matcher, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(name, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(output_name, RCL_RET_INVALID_ARGUMENT);
+  *output_name = NULL;
+  if (0u == matcher->capacity) {
+    return RCL_RET_OK;
+  }
+  const rcl_remap_compiled_t * slot = _rcl_remap_matcher_find(
+    matcher, type, name, rcl_remap_hash_name(name));
+  if (NULL == slot->match) {
+    return RCL_RET_OK;
+  }
+  if (NULL == slot->replacement) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to expand the replacement '%s' of a remap rule", slot->rule->replacement);
+    return RCL_RET_ERROR;
+  }
+  *output_name = slot->replacement;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_remap_matcher_fini(
+  rcl_remap_matcher_t * matcher)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(matcher, RCL_RET_INVALID_ARGUMENT);
+  rcl_allocator_t allocator = matcher->allocator;
+  for (size_t i = 0; i < matcher->capacity; ++i) {
+    if (NULL != matcher->slots[i].match) {
+      allocator.deallocate(matcher->slots[i].match, allocator.state);
+    }
+    if (NULL != matcher->slots[i].replacement) {
+      allocator.deallocate(matcher->slots[i].replacement, allocator.state);
+    }
+  }
+  if (NULL != matcher->slots) {
+    allocator.deallocate(matcher->slots, allocator.state);
+  }
+  *matcher = rcl_remap_get_zero_initialized_matcher();
+  return RCL_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,9 +16,11 @@
 #define RCL__REMAP_IMPL_H_
 
 #include "rcl/allocator.h"
+#include "rcl/arguments.h"
 #include "rcl/macros.h"
 #include "rcl/types.h"
 #include "rcl/visibility_control.h"
+#include "rcutils/types/string_map.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -101,6 +103,122 @@ rcl_ret_t
 rcl_remap_fini(
   rcl_remap_t * rule);
 
+/// A topic or service remap rule with its match and replacement expanded for one node.
+typedef struct rcl_remap_compiled_t
+{
+  /// Either RCL_TOPIC_REMAP or RCL_SERVICE_REMAP.
+  rcl_remap_type_t type;
+  /// Hash of the expanded match.
+  size_t hash;
+  /// Fully qualified match, or NULL if this slot is empty.
+  char * match;
+  /// Fully qualified replacement, or NULL if it could not be expanded.
+  char * replacement;
+  /// The rule this was compiled from.
+  const rcl_remap_t * rule;
+} rcl_remap_compiled_t;
+
+/// Topic and service remap rules of one node, in a hash table keyed by their expanded match.
+/**
+ * Only the first rule matching a name is kept for each type, local rules before global ones,
+ * so looking up a name gives the same result as checking each rule in order.
+ */
+typedef struct rcl_remap_matcher_t
+{
+  /// Open addressed table, or NULL if there are no topic or service rules for the node.
+  rcl_remap_compiled_t * slots;
+  /// Number of slots, a power of two.
+  size_t capacity;
+
+  /// Allocator used to allocate objects in this struct
+  rcl_allocator_t allocator;
+} rcl_remap_matcher_t;
+
+/// Get an rcl_remap_matcher_t structure initialized with NULL.
+RCL_PUBLIC
+rcl_remap_matcher_t
+rcl_remap_get_zero_initialized_matcher();
+
+/// Compile the topic and service remap rules that apply to a node.
+/**
+ * The match and replacement of each rule are expanded once here, instead of each time a name
+ * is remapped.
+ * Rules whose match cannot be expanded are skipped, like rcl_remap_topic_name() does.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] local_arguments Arguments whose rules are used before global arguments, or `NULL`.
+ * \param[in] global_arguments Arguments whose rules are used if no local rule matched, or `NULL`.
+ * \param[in] node_name The name of the node, after it was remapped.
+ * \param[in] node_namespace The namespace of the node, after it was remapped.
+ * \param[in] substitutions Substitutions used to expand the rules.
+ * \param[in] allocator A valid allocator to use.
+ * \param[out] matcher A zero-initialized matcher.
+ * \return `RCL_RET_OK` if the rules were compiled, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_NODE_INVALID_NAME` if the node name is invalid, or
+ * \return `RCL_RET_NODE_INVALID_NAMESPACE` if the node namespace is invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_remap_matcher_init(
+  const rcl_arguments_t * local_arguments,
+  const rcl_arguments_t * global_arguments,
+  const char * node_name,
+  const char * node_namespace,
+  const rcutils_string_map_t * substitutions,
+  rcl_allocator_t allocator,
+  rcl_remap_matcher_t * matcher);
+
+/// Find the replacement of a fully qualified topic or service name.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] matcher A matcher initialized with rcl_remap_matcher_init().
+ * \param[in] type Either RCL_TOPIC_REMAP or RCL_SERVICE_REMAP.
+ * \param[in] name A fully qualified and expanded name.
+ * \param[out] output_name The replacement, owned by the matcher, or
+ *   `NULL` if no remap rules matched the name.
+ * \return `RCL_RET_OK` if the name was remapped or no rules matched, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ERROR` if the replacement of the matching rule could not be expanded.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_remap_matcher_lookup(
+  const rcl_remap_matcher_t * matcher,
+  rcl_remap_type_t type,
+  const char * name,
+  const char ** output_name);
+
+/// Reclaim resources used in an rcl_remap_matcher_t structure.
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_remap_matcher_fini(
+  rcl_remap_matcher_t * matcher);
+
+/// Hash a topic or service name.
+RCL_LOCAL
+size_t
+rcl_remap_hash_name(const char * name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,161 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the creation of nodes, publishers and services against the number of remap rules given
+// on the command line, as for a component container launched with many remaps.
+// Each node creates its entities with a few distinct names, so most names are created again.
+// The rule counts are 0, 10, 100 and so on up to the given maximum.
+//
+// Usage: benchmark_remap [max rules] [nodes] [entities per node]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "rcl/error_handling.h"
+#include "rcl/rcl.h"
+
+#include "test_msgs/msg/primitives.h"
+#include "test_msgs/srv/primitives.h"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Entities are created with this many distinct names per node
+const size_t distinct_names = 20;
+
+struct Result
+{
+  double node_ms = 0.0;
+  double publisher_ms = 0.0;
+  double service_ms = 0.0;
+};
+
+bool run(size_t num_rules, size_t num_nodes, size_t num_entities, Result & result)
+{
+  // Most rules match none of the names, the last ones remap some of them
+  std::vector<std::string> args = {"benchmark_remap"};
+  for (size_t i = 0; i < num_rules; ++i) {
+    if (i + distinct_names / 2 >= num_rules) {
+      size_t name = num_rules - i - 1;
+      args.push_back("topic_" + std::to_string(name) + ":=remapped_" + std::to_string(name));
+    } else {
+      args.push_back("/unused/topic_" + std::to_string(i) + ":=~/unused_" + std::to_string(i));
+    }
+  }
+  std::vector<const char *> argv;
+  for (const auto & arg : args) {
+    argv.push_back(arg.c_str());
+  }
+
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  if (RCL_RET_OK != rcl_init_options_init(&init_options, rcl_get_default_allocator()) ||
+    RCL_RET_OK != rcl_init(static_cast<int>(argv.size()), argv.data(), &init_options, &context))
+  {
+    fprintf(stderr, "rcl_init failed: %s\n", rcl_get_error_string().str);
+    return false;
+  }
+
+  const rosidl_message_type_support_t * msg_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  const rosidl_service_type_support_t * srv_ts =
+    ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, Primitives);
+  rcl_node_options_t node_options = rcl_node_get_default_options();
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  std::vector<rcl_node_t> nodes(num_nodes, rcl_get_zero_initialized_node());
+  std::vector<rcl_publisher_t> publishers(
+    num_nodes * num_entities, rcl_get_zero_initialized_publisher());
+  std::vector<rcl_service_t> services(num_nodes * num_entities, rcl_get_zero_initialized_service());
+  bool ok = true;
+
+  auto start = Clock::now();
+  for (size_t i = 0; ok && i < num_nodes; ++i) {
+    std::string name = "node_" + std::to_string(i);
+    ok = RCL_RET_OK == rcl_node_init(&nodes[i], name.c_str(), "/ns", &context, &node_options);
+  }
+  result.node_ms = ms_since(start);
+
+  start = Clock::now();
+  for (size_t i = 0; ok && i < publishers.size(); ++i) {
+    std::string name = "topic_" + std::to_string(i % distinct_names);
+    ok = RCL_RET_OK == rcl_publisher_init(
+      &publishers[i], &nodes[i / num_entities], msg_ts, name.c_str(), &publisher_options);
+  }
+  result.publisher_ms = ms_since(start);
+
+  start = Clock::now();
+  for (size_t i = 0; ok && i < services.size(); ++i) {
+    std::string name = "service_" + std::to_string(i % distinct_names);
+    ok = RCL_RET_OK == rcl_service_init(
+      &services[i], &nodes[i / num_entities], srv_ts, name.c_str(), &service_options);
+  }
+  result.service_ms = ms_since(start);
+  if (!ok) {
+    fprintf(stderr, "creating the entities failed: %s\n", rcl_get_error_string().str);
+    rcl_reset_error();
+  }
+
+  // Entities which were not created are zero initialized, which fini ignores
+  for (size_t i = 0; i < publishers.size(); ++i) {
+    (void)rcl_publisher_fini(&publishers[i], &nodes[i / num_entities]);
+    (void)rcl_service_fini(&services[i], &nodes[i / num_entities]);
+  }
+  for (auto & node : nodes) {
+    (void)rcl_node_fini(&node);
+  }
+  (void)rcl_shutdown(&context);
+  (void)rcl_context_fini(&context);
+  (void)rcl_init_options_fini(&init_options);
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t max_rules = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+  size_t num_nodes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+  size_t num_entities = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100;
+  if (num_nodes == 0 || num_entities == 0) {
+    fprintf(stderr, "Usage: %s [max rules] [nodes] [entities per node]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%zu nodes, %zu publishers and %zu services per node\n",
+    num_nodes, num_entities, num_entities);
+  printf("%8s %14s %16s %16s\n", "rules", "node (ms)", "publisher (us)", "service (us)");
+  for (size_t num_rules = 0; num_rules <= max_rules; num_rules = num_rules ? num_rules * 10 : 10) {
+    Result result;
+    if (!run(num_rules, num_nodes, num_entities, result)) {
+      return 1;
+    }
+    const double num_created = static_cast<double>(num_nodes * num_entities);
+    printf("%8zu %14.3f %16.3f %16.3f\n", num_rules,
+      result.node_ms / num_nodes,
+      result.publisher_ms * 1000.0 / num_created,
+      result.service_ms * 1000.0 / num_created);
+  }
+  return 0;
+}
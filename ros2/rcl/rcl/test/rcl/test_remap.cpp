@@ -19,6 +19,7 @@
 #include "rcl/error_handling.h"
 
 #include "./arg_macros.hpp"
+#include "../../src/rcl/remap_impl.h"
 
 #ifdef RMW_IMPLEMENTATION
 # define CLASSNAME_(NAME, SUFFIX) NAME ## __ ## SUFFIX
@@ -501,3 +502,89 @@ TEST_F(CLASSNAME(TestRemapFixture, RMW_IMPLEMENTATION), url_scheme_rostopic) {
   EXPECT_EQ(RCL_RET_OK, ret);
   EXPECT_EQ(NULL, output);
 }
+
+TEST_F(CLASSNAME(TestRemapFixture, RMW_IMPLEMENTATION), compiled_rules_match_like_rules) {
+  rcl_ret_t ret;
+  rcl_arguments_t local_arguments;
+  SCOPE_ARGS(local_arguments, "process_name", "/foo:=/local_foo", "NodeName:__ns:=/ns");
+  rcl_arguments_t global_arguments;
+  SCOPE_ARGS(
+    global_arguments, "process_name", "/foo:=/global_foo", "rosservice://bar:=/service_bar",
+    "bar:=/topic_bar", "/bar:=/first_bar", "/bar:=/second_bar", "OtherNode:baz:=/other_baz",
+    "NodeName:baz:=~/baz", "rostopic://~/qux:=quux");
+
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcutils_string_map_t substitutions = rcutils_get_zero_initialized_string_map();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_map_init(&substitutions, 0, allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_map_fini(&substitutions));
+  });
+  rcl_remap_matcher_t matcher = rcl_remap_get_zero_initialized_matcher();
+  ret = rcl_remap_matcher_init(
+    &local_arguments, &global_arguments, "NodeName", "/ns", &substitutions, allocator, &matcher);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_remap_matcher_fini(&matcher));
+  });
+
+  const char * names[] = {"/foo", "/bar", "/ns/bar", "/ns/baz", "/ns/NodeName/qux", "/nothing"};
+  for (const char * name : names) {
+    char * expected = NULL;
+    const char * output = NULL;
+    ret = rcl_remap_topic_name(
+      &local_arguments, &global_arguments, name, "NodeName", "/ns", allocator, &expected);
+    ASSERT_EQ(RCL_RET_OK, ret);
+    ret = rcl_remap_matcher_lookup(&matcher, RCL_TOPIC_REMAP, name, &output);
+    ASSERT_EQ(RCL_RET_OK, ret);
+    if (NULL == expected) {
+      EXPECT_EQ(NULL, output) << name;
+    } else {
+      EXPECT_STREQ(expected, output) << name;
+      allocator.deallocate(expected, allocator.state);
+    }
+
+    ret = rcl_remap_service_name(
+      &local_arguments, &global_arguments, name, "NodeName", "/ns", allocator, &expected);
+    ASSERT_EQ(RCL_RET_OK, ret);
+    ret = rcl_remap_matcher_lookup(&matcher, RCL_SERVICE_REMAP, name, &output);
+    ASSERT_EQ(RCL_RET_OK, ret);
+    if (NULL == expected) {
+      EXPECT_EQ(NULL, output) << name;
+    } else {
+      EXPECT_STREQ(expected, output) << name;
+      allocator.deallocate(expected, allocator.state);
+    }
+  }
+
+  const char * output = NULL;
+  EXPECT_EQ(RCL_RET_OK, rcl_remap_matcher_lookup(&matcher, RCL_TOPIC_REMAP, "/bar", &output));
+  EXPECT_STREQ("/first_bar", output);
+  EXPECT_EQ(RCL_RET_OK, rcl_remap_matcher_lookup(&matcher, RCL_TOPIC_REMAP, "/ns/bar", &output));
+  EXPECT_STREQ("/topic_bar", output);
+  EXPECT_EQ(RCL_RET_OK, rcl_remap_matcher_lookup(&matcher, RCL_SERVICE_REMAP, "/ns/bar", &output));
+  EXPECT_STREQ("/service_bar", output);
+  EXPECT_EQ(RCL_RET_OK, rcl_remap_matcher_lookup(&matcher, RCL_TOPIC_REMAP, "/ns/baz", &output));
+  EXPECT_STREQ("/ns/NodeName/baz", output);
+}
+
+TEST_F(CLASSNAME(TestRemapFixture, RMW_IMPLEMENTATION), compiled_rules_without_rules) {
+  rcl_arguments_t global_arguments;
+  SCOPE_ARGS(global_arguments, "process_name", "__node:=other_name");
+
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcutils_string_map_t substitutions = rcutils_get_zero_initialized_string_map();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_map_init(&substitutions, 0, allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_map_fini(&substitutions));
+  });
+  rcl_remap_matcher_t matcher = rcl_remap_get_zero_initialized_matcher();
+  rcl_ret_t ret = rcl_remap_matcher_init(
+    NULL, &global_arguments, "NodeName", "/", &substitutions, allocator, &matcher);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(NULL, matcher.slots);
+
+  const char * output = "not set";
+  EXPECT_EQ(RCL_RET_OK, rcl_remap_matcher_lookup(&matcher, RCL_TOPIC_REMAP, "/foo", &output));
+  EXPECT_EQ(NULL, output);
+  EXPECT_EQ(RCL_RET_OK, rcl_remap_matcher_fini(&matcher));
+}
@@ -314,3 +314,65 @@ TEST_F(CLASSNAME(TestRemapIntegrationFixture, RMW_IMPLEMENTATION), remap_using_n
   }
   EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node));
 }
+
+TEST_F(CLASSNAME(TestRemapIntegrationFixture, RMW_IMPLEMENTATION), remap_same_name_again) {
+  int argc;
+  char ** argv;
+  SCOPE_GLOBAL_ARGS(
+    argc, argv, "process_name", "rosservice://foo:=/service_foo", "foo:=/topic_foo",
+    "original_name:bar:=~/bar");
+
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t default_options = rcl_node_get_default_options();
+  ASSERT_EQ(RCL_RET_OK, rcl_node_init(&node, "original_name", "/ns", &context, &default_options));
+
+  // Names are memoized by the node the first time, the second entity uses the memoized name
+  const rosidl_message_type_support_t * msg_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  const rosidl_service_type_support_t * srv_ts =
+    ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, Primitives);
+  for (int i = 0; i < 2; ++i) {
+    {  // Publisher topic gets remapped
+      rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+      rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+      rcl_ret_t ret = rcl_publisher_init(&publisher, &node, msg_ts, "foo", &publisher_options);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_STREQ("/topic_foo", rcl_publisher_get_topic_name(&publisher));
+      EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, &node));
+    }
+    {  // Node specific rule
+      rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+      rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+      rcl_ret_t ret = rcl_subscription_init(
+        &subscription, &node, msg_ts, "bar", &subscription_options);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_STREQ("/ns/original_name/bar", rcl_subscription_get_topic_name(&subscription));
+      EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, &node));
+    }
+    {  // Same name as the publisher, remapped by a service rule
+      rcl_client_options_t client_options = rcl_client_get_default_options();
+      rcl_client_t client = rcl_get_zero_initialized_client();
+      rcl_ret_t ret = rcl_client_init(&client, &node, srv_ts, "foo", &client_options);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_STREQ("/service_foo", rcl_client_get_service_name(&client));
+      EXPECT_EQ(RCL_RET_OK, rcl_client_fini(&client, &node));
+    }
+    {  // Not remapped
+      rcl_service_options_t service_options = rcl_service_get_default_options();
+      rcl_service_t service = rcl_get_zero_initialized_service();
+      rcl_ret_t ret = rcl_service_init(&service, &node, srv_ts, "baz", &service_options);
+      EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_STREQ("/ns/baz", rcl_service_get_service_name(&service));
+      EXPECT_EQ(RCL_RET_OK, rcl_service_fini(&service, &node));
+    }
+    {  // Invalid names are not memoized and fail each time
+      rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+      rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+      rcl_ret_t ret = rcl_publisher_init(&publisher, &node, msg_ts, "foo//", &publisher_options);
+      EXPECT_EQ(RCL_RET_TOPIC_NAME_INVALID, ret);
+      rcl_reset_error();
+    }
+  }
+
+  EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node));
+}
@@ -463,6 +463,45 @@ rcl_action_get_goal_status_array(
   const rcl_action_server_t * action_server,
   rcl_action_goal_status_array_t * status_message);
 
+/// Update the status array message kept by an action server for its accepted goals.
+/**
+ * Unlike rcl_action_get_goal_status_array(), the status array message is owned by the
+ * action server and is not copied.
+ * Only the status of the goals that were still active is queried again, and `changed` tells
+ * whether any goal was accepted, changed state or expired since the previous call.
+ * When it did not change, publishing the status again with rcl_action_publish_status() can
+ * be skipped.
+ *
+ * The status array message is valid until the next call to this function,
+ * rcl_action_accept_new_goal(), rcl_action_expire_goals() or rcl_action_server_fini().
+ *
+ * This function updates the goal bookkeeping of the action server, it must not be called
+ * concurrently with any other function using the same action server.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] action_server handle to the action server that will publish the status message
+ * \param[out] status_message the action_msgs/StatusArray ROS message of the action server
+ * \param[out] changed whether the status changed since the previous call
+ * \return `RCL_RET_OK` if the status array message was updated successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ACTION_SERVER_INVALID` if the action server is invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_ACTION_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_action_update_goal_status_array(
+  rcl_action_server_t * action_server,
+  const rcl_action_goal_status_array_t ** status_message,
+  bool * changed);
+
 /// Publish a status array message for accepted goals associated with an action server.
 /**
  * This function acts like a ROS publisher and is potentially a blocking call.
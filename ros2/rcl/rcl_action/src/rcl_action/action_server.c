@@ -34,6 +34,14 @@ extern "C"
 
 #include "rmw/rmw.h"
 
+/// Bookkeeping of a goal handle tracked by an action server.
+typedef struct rcl_action_goal_entry_t
+{
+  // Position in active_goals if active, or in expire_heap if terminated
+  size_t position;
+  bool active;
+} rcl_action_goal_entry_t;
+
 /// Internal rcl_action implementation struct.
 typedef struct rcl_action_server_impl_t
 {
@@ -48,6 +56,21 @@ typedef struct rcl_action_server_impl_t
   // Array of goal handles
   rcl_action_goal_handle_t ** goal_handles;
   size_t num_goal_handles;
+  size_t goal_handles_capacity;
+  // Status of the goals as of the last sweep, in the same order as goal_handles
+  rcl_action_goal_status_array_t goal_status_array;
+  bool goal_status_changed;
+  // Bookkeeping of the goals, in the same order as goal_handles
+  rcl_action_goal_entry_t * goal_entries;
+  // Open addressing table on the goal UUIDs, holding positions in goal_handles plus one
+  size_t * goal_table;
+  size_t goal_table_capacity;
+  // Positions of the goals that were active in the last sweep
+  size_t * active_goals;
+  size_t num_active_goals;
+  // Min-heap of the positions of terminated goals on their stamp, next to expire on top
+  size_t * expire_heap;
+  size_t num_terminated_goals;
   // Clock
   rcl_clock_t clock;
   // Wait set records
@@ -179,6 +202,17 @@ rcl_action_server_init(
   action_server->impl->options = *options;  // copy options
   action_server->impl->goal_handles = NULL;
   action_server->impl->num_goal_handles = 0u;
+  action_server->impl->goal_handles_capacity = 0u;
+  action_server->impl->goal_status_array = rcl_action_get_zero_initialized_goal_status_array();
+  action_server->impl->goal_status_array.allocator = allocator;
+  action_server->impl->goal_status_changed = false;
+  action_server->impl->goal_entries = NULL;
+  action_server->impl->goal_table = NULL;
+  action_server->impl->goal_table_capacity = 0u;
+  action_server->impl->active_goals = NULL;
+  action_server->impl->num_active_goals = 0u;
+  action_server->impl->expire_heap = NULL;
+  action_server->impl->num_terminated_goals = 0u;
   action_server->impl->clock.type = RCL_CLOCK_UNINITIALIZED;
 
   rcl_ret_t ret = RCL_RET_OK;
@@ -268,6 +302,12 @@ rcl_action_server_fini(rcl_action_server_t * action_server, rcl_node_t * node)
     }
     allocator.deallocate(action_server->impl->goal_handles, allocator.state);
     action_server->impl->goal_handles = NULL;
+    allocator.deallocate(
+      action_server->impl->goal_status_array.msg.status_list.data, allocator.state);
+    allocator.deallocate(action_server->impl->goal_entries, allocator.state);
+    allocator.deallocate(action_server->impl->goal_table, allocator.state);
+    allocator.deallocate(action_server->impl->active_goals, allocator.state);
+    allocator.deallocate(action_server->impl->expire_heap, allocator.state);
     // Deallocate struct
     allocator.deallocate(action_server->impl, allocator.state);
     action_server->impl = NULL;
@@ -358,6 +398,248 @@ _nanosec_to_goal_info_stamp(const int64_t * nanosec, rcl_action_goal_info_t * go
   goal_info->stamp.nanosec = *nanosec % RCUTILS_S_TO_NS(1);
 }
 
+// Implementation only
+static rcl_action_goal_status_t *
+_goal_status(const rcl_action_server_impl_t * impl, size_t position)
+{
+  return &impl->goal_status_array.msg.status_list.data[position];
+}
+
+// Implementation only
+static size_t
+_goal_table_hash(const uint8_t * uuid, size_t capacity)
+{
+  // FNV-1a, goal IDs are chosen by the clients
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0u; i < UUID_SIZE; ++i) {
+    hash ^= uuid[i];
+    hash *= 1099511628211ULL;
+  }
+  return (size_t)hash & (capacity - 1u);
+}
+
+// Implementation only
+// Return the slot of the table holding the goal, or the empty slot where it would be
+static size_t
+_goal_table_find(const rcl_action_server_impl_t * impl, const uint8_t * uuid)
+{
+  assert(impl->goal_table_capacity > 0u);
+  const size_t mask = impl->goal_table_capacity - 1u;
+  size_t slot = _goal_table_hash(uuid, impl->goal_table_capacity);
+  while (0u != impl->goal_table[slot] &&
+    !uuidcmp(_goal_status(impl, impl->goal_table[slot] - 1u)->goal_info.uuid, uuid))
+  {
+    slot = (slot + 1u) & mask;
+  }
+  return slot;
+}
+
+// Implementation only
+static void
+_goal_table_remove(rcl_action_server_impl_t * impl, size_t slot)
+{
+  // Shift back the following goals of the cluster that can take the freed slot
+  const size_t mask = impl->goal_table_capacity - 1u;
+  size_t next = (slot + 1u) & mask;
+  while (0u != impl->goal_table[next]) {
+    const uint8_t * uuid = _goal_status(impl, impl->goal_table[next] - 1u)->goal_info.uuid;
+    size_t home = _goal_table_hash(uuid, impl->goal_table_capacity);
+    if (((next - home) & mask) >= ((next - slot) & mask)) {
+      impl->goal_table[slot] = impl->goal_table[next];
+      slot = next;
+    }
+    next = (next + 1u) & mask;
+  }
+  impl->goal_table[slot] = 0u;
+}
+
+// Implementation only
+static int64_t
+_goal_expire_key(const rcl_action_server_impl_t * impl, size_t heap_index)
+{
+  return _goal_info_stamp_to_nanosec(&_goal_status(impl, impl->expire_heap[heap_index])->goal_info);
+}
+
+// Implementation only
+static void
+_expire_heap_swap(rcl_action_server_impl_t * impl, size_t a, size_t b)
+{
+  size_t position = impl->expire_heap[a];
+  impl->expire_heap[a] = impl->expire_heap[b];
+  impl->expire_heap[b] = position;
+  impl->goal_entries[impl->expire_heap[a]].position = a;
+  impl->goal_entries[impl->expire_heap[b]].position = b;
+}
+
+// Implementation only
+static void
+_expire_heap_push(rcl_action_server_impl_t * impl, size_t position)
+{
+  size_t index = impl->num_terminated_goals++;
+  impl->expire_heap[index] = position;
+  impl->goal_entries[position].position = index;
+  impl->goal_entries[position].active = false;
+  while (index > 0u) {
+    size_t parent = (index - 1u) / 2u;
+    if (_goal_expire_key(impl, parent) <= _goal_expire_key(impl, index)) {
+      break;
+    }
+    _expire_heap_swap(impl, parent, index);
+    index = parent;
+  }
+}
+
+// Implementation only
+static void
+_expire_heap_pop(rcl_action_server_impl_t * impl)
+{
+  assert(impl->num_terminated_goals > 0u);
+  const size_t size = --impl->num_terminated_goals;
+  if (0u == size) {
+    return;
+  }
+  impl->expire_heap[0] = impl->expire_heap[size];
+  impl->goal_entries[impl->expire_heap[0]].position = 0u;
+  size_t index = 0u;
+  for (;; ) {
+    size_t smallest = index;
+    size_t child = 2u * index + 1u;
+    if (child < size && _goal_expire_key(impl, child) < _goal_expire_key(impl, smallest)) {
+      smallest = child;
+    }
+    ++child;
+    if (child < size && _goal_expire_key(impl, child) < _goal_expire_key(impl, smallest)) {
+      smallest = child;
+    }
+    if (smallest == index) {
+      break;
+    }
+    _expire_heap_swap(impl, index, smallest);
+    index = smallest;
+  }
+}
+
+// Implementation only
+static bool
+_goal_state_is_active(rcl_action_goal_state_t state)
+{
+  return GOAL_STATE_ACCEPTED == state || GOAL_STATE_EXECUTING == state ||
+         GOAL_STATE_CANCELING == state;
+}
+
+// Implementation only
+// Update the status of the goals that were active, and move the terminated ones to the heap
+static void
+_sweep_active_goals(rcl_action_server_impl_t * impl)
+{
+  size_t i = 0u;
+  while (i < impl->num_active_goals) {
+    const size_t position = impl->active_goals[i];
+    rcl_action_goal_status_t * goal_status = _goal_status(impl, position);
+    rcl_action_goal_state_t state;
+    rcl_ret_t ret = rcl_action_goal_handle_get_status(impl->goal_handles[position], &state);
+    if (RCL_RET_OK == ret) {
+      if (state != goal_status->status) {
+        goal_status->status = state;
+        impl->goal_status_changed = true;
+      }
+      if (_goal_state_is_active(state)) {
+        ++i;
+        continue;
+      }
+    } else {
+      // The goal handle was finalized through the pointer returned by rcl_action_accept_new_goal()
+      rcl_reset_error();
+    }
+    impl->active_goals[i] = impl->active_goals[--impl->num_active_goals];
+    impl->goal_entries[impl->active_goals[i]].position = i;
+    _expire_heap_push(impl, position);
+  }
+}
+
+// Implementation only
+// Stop tracking the goal at a position, once removed from the table and the heap
+static void
+_remove_goal(rcl_action_server_impl_t * impl, size_t position)
+{
+  rcl_allocator_t allocator = impl->options.allocator;
+  allocator.deallocate(impl->goal_handles[position], allocator.state);
+  // Fill in the gap with the last goal
+  const size_t last = --impl->num_goal_handles;
+  impl->goal_status_array.msg.status_list.size = impl->num_goal_handles;
+  impl->goal_status_changed = true;
+  if (position != last) {
+    impl->goal_handles[position] = impl->goal_handles[last];
+    *_goal_status(impl, position) = *_goal_status(impl, last);
+    impl->goal_entries[position] = impl->goal_entries[last];
+    impl->goal_table[_goal_table_find(impl, _goal_status(impl, position)->goal_info.uuid)] =
+      position + 1u;
+    if (impl->goal_entries[position].active) {
+      impl->active_goals[impl->goal_entries[position].position] = position;
+    } else {
+      impl->expire_heap[impl->goal_entries[position].position] = position;
+    }
+  }
+  impl->goal_handles[last] = NULL;
+}
+
+// Implementation only
+static bool
+_reserve_goals(rcl_action_server_impl_t * impl, size_t num_goals)
+{
+  rcl_allocator_t allocator = impl->options.allocator;
+  if (num_goals > impl->goal_handles_capacity) {
+    // Grow geometrically, the arrays that could be grown keep their size on failure
+    size_t capacity = impl->goal_handles_capacity > 0u ? impl->goal_handles_capacity * 2u : 8u;
+    void * tmp_ptr = allocator.reallocate(
+      impl->goal_handles, capacity * sizeof(rcl_action_goal_handle_t *), allocator.state);
+    if (!tmp_ptr) {
+      return false;
+    }
+    impl->goal_handles = (rcl_action_goal_handle_t **)tmp_ptr;
+    tmp_ptr = allocator.reallocate(
+      impl->goal_status_array.msg.status_list.data,
+      capacity * sizeof(rcl_action_goal_status_t), allocator.state);
+    if (!tmp_ptr) {
+      return false;
+    }
+    impl->goal_status_array.msg.status_list.data = (rcl_action_goal_status_t *)tmp_ptr;
+    tmp_ptr = allocator.reallocate(
+      impl->goal_entries, capacity * sizeof(rcl_action_goal_entry_t), allocator.state);
+    if (!tmp_ptr) {
+      return false;
+    }
+    impl->goal_entries = (rcl_action_goal_entry_t *)tmp_ptr;
+    tmp_ptr = allocator.reallocate(impl->active_goals, capacity * sizeof(size_t), allocator.state);
+    if (!tmp_ptr) {
+      return false;
+    }
+    impl->active_goals = (size_t *)tmp_ptr;
+    tmp_ptr = allocator.reallocate(impl->expire_heap, capacity * sizeof(size_t), allocator.state);
+    if (!tmp_ptr) {
+      return false;
+    }
+    impl->expire_heap = (size_t *)tmp_ptr;
+    impl->goal_handles_capacity = capacity;
+    impl->goal_status_array.msg.status_list.capacity = capacity;
+  }
+  if (2u * num_goals > impl->goal_table_capacity) {
+    // Keep the table at most half full, and place the goals again
+    size_t capacity = impl->goal_table_capacity > 0u ? impl->goal_table_capacity * 2u : 16u;
+    size_t * table = (size_t *)allocator.zero_allocate(capacity, sizeof(size_t), allocator.state);
+    if (!table) {
+      return false;
+    }
+    allocator.deallocate(impl->goal_table, allocator.state);
+    impl->goal_table = table;
+    impl->goal_table_capacity = capacity;
+    for (size_t i = 0u; i < impl->num_goal_handles; ++i) {
+      impl->goal_table[_goal_table_find(impl, _goal_status(impl, i)->goal_info.uuid)] = i + 1u;
+    }
+  }
+  return true;
+}
+
 rcl_action_goal_handle_t *
 rcl_action_accept_new_goal(
   rcl_action_server_t * action_server,
@@ -374,109 +656,91 @@ rcl_action_accept_new_goal(
     return NULL;
   }
 
-  // Allocate space in the goal handle pointer array
-  rcl_allocator_t allocator = action_server->impl->options.allocator;
-  rcl_action_goal_handle_t ** goal_handles = action_server->impl->goal_handles;
-  const size_t num_goal_handles = action_server->impl->num_goal_handles;
-  // TODO(jacobperron): Don't allocate for every accepted goal handle,
-  //                    instead double the memory allocated if needed.
-  const size_t new_num_goal_handles = num_goal_handles + 1u;
-  void * tmp_ptr = allocator.reallocate(
-    goal_handles, new_num_goal_handles * sizeof(rcl_action_goal_handle_t *), allocator.state);
-  if (!tmp_ptr) {
+  // Make room for the goal handle
+  rcl_action_server_impl_t * impl = action_server->impl;
+  rcl_allocator_t allocator = impl->options.allocator;
+  if (!_reserve_goals(impl, impl->num_goal_handles + 1u)) {
     RCL_SET_ERROR_MSG("memory allocation failed for goal handle pointer");
     return NULL;
   }
-  goal_handles = (rcl_action_goal_handle_t **)tmp_ptr;
 
   // Allocate space for a new goal handle
-  tmp_ptr = allocator.allocate(sizeof(rcl_action_goal_handle_t), allocator.state);
-  if (!tmp_ptr) {
+  rcl_action_goal_handle_t * goal_handle = (rcl_action_goal_handle_t *)allocator.allocate(
+    sizeof(rcl_action_goal_handle_t), allocator.state);
+  if (!goal_handle) {
     RCL_SET_ERROR_MSG("memory allocation failed for new goal handle");
     return NULL;
   }
-  goal_handles[num_goal_handles] = (rcl_action_goal_handle_t *) tmp_ptr;
 
   // Re-stamp goal info with current time
   rcl_action_goal_info_t goal_info_stamp_now = rcl_action_get_zero_initialized_goal_info();
   goal_info_stamp_now = *goal_info;
   rcl_time_point_value_t now_time_point;
-  rcl_ret_t ret = rcl_clock_get_now(&action_server->impl->clock, &now_time_point);
+  rcl_ret_t ret = rcl_clock_get_now(&impl->clock, &now_time_point);
   if (RCL_RET_OK != ret) {
+    allocator.deallocate(goal_handle, allocator.state);
     return NULL;  // Error already set
   }
   _nanosec_to_goal_info_stamp(&now_time_point, &goal_info_stamp_now);
 
   // Create a new goal handle
-  *goal_handles[num_goal_handles] = rcl_action_get_zero_initialized_goal_handle();
-  ret = rcl_action_goal_handle_init(
-    goal_handles[num_goal_handles], &goal_info_stamp_now, allocator);
+  *goal_handle = rcl_action_get_zero_initialized_goal_handle();
+  ret = rcl_action_goal_handle_init(goal_handle, &goal_info_stamp_now, allocator);
   if (RCL_RET_OK != ret) {
+    allocator.deallocate(goal_handle, allocator.state);
     RCL_SET_ERROR_MSG("failed to initialize goal handle");
     return NULL;
   }
 
-  action_server->impl->goal_handles = goal_handles;
-  action_server->impl->num_goal_handles = new_num_goal_handles;
-  return goal_handles[num_goal_handles];
+  // Track the goal
+  const size_t position = impl->num_goal_handles++;
+  impl->goal_handles[position] = goal_handle;
+  impl->goal_status_array.msg.status_list.size = impl->num_goal_handles;
+  _goal_status(impl, position)->goal_info = goal_info_stamp_now;
+  _goal_status(impl, position)->status = GOAL_STATE_ACCEPTED;
+  impl->goal_status_changed = true;
+  impl->goal_table[_goal_table_find(impl, goal_info_stamp_now.uuid)] = position + 1u;
+  impl->goal_entries[position].position = impl->num_active_goals;
+  impl->goal_entries[position].active = true;
+  impl->active_goals[impl->num_active_goals++] = position;
+  return goal_handle;
 }
 
 // Implementation only
 static rcl_ret_t
-_recalculate_expire_timer(
-  rcl_timer_t * expire_timer,
-  const int64_t timeout,
-  rcl_action_goal_handle_t ** goal_handles,
-  size_t num_goal_handles,
-  rcl_clock_t * clock)
+_recalculate_expire_timer(rcl_action_server_impl_t * impl)
 {
-  size_t num_inactive_goals = 0u;
-  int64_t minimum_period = 0;
+  _sweep_active_goals(impl);
+
+  if (0u == impl->num_terminated_goals) {
+    // No idea when the next goal will expire, so cancel timer
+    return rcl_timer_cancel(&impl->expire_timer);
+  }
 
   // Get current time (nanosec)
   int64_t current_time;
-  rcl_ret_t ret = rcl_clock_get_now(clock, &current_time);
+  rcl_ret_t ret = rcl_clock_get_now(&impl->clock, &current_time);
   if (RCL_RET_OK != ret) {
     return RCL_RET_ERROR;
   }
 
-  for (size_t i = 0; i < num_goal_handles; ++i) {
-    rcl_action_goal_handle_t * goal_handle = goal_handles[i];
-    if (!rcl_action_goal_handle_is_active(goal_handle)) {
-      ++num_inactive_goals;
-
-      rcl_action_goal_info_t goal_info;
-      ret = rcl_action_goal_handle_get_info(goal_handle, &goal_info);
-      if (RCL_RET_OK != ret) {
-        return RCL_RET_ERROR;
-      }
-
-      int64_t delta = timeout - current_time - _goal_info_stamp_to_nanosec(&goal_info);
-      if (delta < minimum_period) {
-        minimum_period = delta;
-      }
-    }
+  // The goal on top of the heap is the next one to expire
+  const int64_t timeout = (int64_t)impl->options.result_timeout.nanoseconds;
+  int64_t minimum_period = timeout - (current_time - _goal_expire_key(impl, 0u));
+  if (minimum_period < 0) {
+    // Already expired, or time jumped
+    minimum_period = 0;
   }
-
-  if (0u == num_goal_handles || 0u == num_inactive_goals) {
-    // No idea when the next goal will expire, so cancel timer
-    return rcl_timer_cancel(expire_timer);
-  } else {
-    if (minimum_period < 0) {
-      // Time jumped backwards
-      minimum_period = 0;
-    }
-    // Un-cancel timer
-    ret = rcl_timer_reset(expire_timer);
-    if (RCL_RET_OK != ret) {
-      return ret;
-    }
-    // Make timer fire when next goal expires
-    int64_t old_period;
-    ret = rcl_timer_exchange_period(expire_timer, minimum_period, &old_period);
-    if (RCL_RET_OK != ret) {
-      return ret;
-    }
+  // Un-cancel timer
+  ret = rcl_timer_reset(&impl->expire_timer);
+  if (RCL_RET_OK != ret) {
+    return ret;
+  }
+  // Make timer fire when next goal expires
+  int64_t old_period;
+  ret = rcl_timer_exchange_period(&impl->expire_timer, minimum_period, &old_period);
+  if (RCL_RET_OK != ret) {
+    return ret;
   }
   return RCL_RET_OK;
 }
@@ -525,28 +789,40 @@ rcl_action_get_goal_status_array(
     return RCL_RET_ERROR;
   }
 
-  // Populate status array
-  for (size_t i = 0u; i < num_goals; ++i) {
-    ret = rcl_action_goal_handle_get_info(
-      action_server->impl->goal_handles[i], &status_message->msg.status_list.data[i].goal_info);
-    if (RCL_RET_OK != ret) {
-      ret = RCL_RET_ERROR;
-      goto fail;
-    }
-    ret = rcl_action_goal_handle_get_status(
-      action_server->impl->goal_handles[i], &status_message->msg.status_list.data[i].status);
-    if (RCL_RET_OK != ret) {
-      ret = RCL_RET_ERROR;
-      goto fail;
+  // Populate status array, only the goals that were active can have changed
+  const rcl_action_server_impl_t * impl = action_server->impl;
+  rcl_action_goal_status_t * status_list = status_message->msg.status_list.data;
+  memcpy(status_list, _goal_status(impl, 0u), num_goals * sizeof(rcl_action_goal_status_t));
+  for (size_t i = 0u; i < impl->num_active_goals; ++i) {
+    const size_t position = impl->active_goals[i];
+    rcl_action_goal_state_t state;
+    if (RCL_RET_OK == rcl_action_goal_handle_get_status(impl->goal_handles[position], &state)) {
+      status_list[position].status = state;
+    } else {
+      rcl_reset_error();
     }
   }
   return RCL_RET_OK;
-fail:
-  {
-    rcl_ret_t ret_throwaway = rcl_action_goal_status_array_fini(status_message);
-    (void)ret_throwaway;
-    return ret;
+}
+
+rcl_ret_t
+rcl_action_update_goal_status_array(
+  rcl_action_server_t * action_server,
+  const rcl_action_goal_status_array_t ** status_message,
+  bool * changed)
+{
+  if (!rcl_action_server_is_valid(action_server)) {
+    return RCL_RET_ACTION_SERVER_INVALID;  // error already set
   }
+  RCL_CHECK_ARGUMENT_FOR_NULL(status_message, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(changed, RCL_RET_INVALID_ARGUMENT);
+
+  rcl_action_server_impl_t * impl = action_server->impl;
+  _sweep_active_goals(impl);
+  *status_message = &impl->goal_status_array;
+  *changed = impl->goal_status_changed;
+  impl->goal_status_changed = false;
+  return RCL_RET_OK;
 }
 
 rcl_ret_t
@@ -610,91 +886,49 @@ rcl_action_expire_goals(
     return RCL_RET_ERROR;
   }
 
-  // Used for shrinking goal handle array
-  rcl_allocator_t allocator = action_server->impl->options.allocator;
+  // Expiration only applys to terminated goals, oldest first
+  rcl_action_server_impl_t * impl = action_server->impl;
+  _sweep_active_goals(impl);
 
   size_t num_goals_expired = 0u;
-  rcl_ret_t ret_final = RCL_RET_OK;
-  const int64_t timeout = (int64_t)action_server->impl->options.result_timeout.nanoseconds;
-  rcl_action_goal_handle_t * goal_handle;
-  rcl_action_goal_info_t goal_info;
-  int64_t goal_time;
-  size_t num_goal_handles = action_server->impl->num_goal_handles;
-  for (size_t i = 0u; i < num_goal_handles; ++i) {
-    if (output_expired && i >= expired_goals_capacity) {
+  const int64_t timeout = (int64_t)impl->options.result_timeout.nanoseconds;
+  while (impl->num_terminated_goals > 0u) {
+    if (output_expired && num_goals_expired >= expired_goals_capacity) {
       // no more space to output expired goals, so stop expiring them
       break;
     }
-    goal_handle = action_server->impl->goal_handles[i];
-    // Expiration only applys to terminated goals
-    if (rcl_action_goal_handle_is_active(goal_handle)) {
-      continue;
+    if ((current_time - _goal_expire_key(impl, 0u)) <= timeout) {
+      break;
     }
-    rcl_action_goal_info_t * info_ptr = &goal_info;
+    // Stop tracking goal handle
+    const size_t position = impl->expire_heap[0];
+    const rcl_action_goal_info_t * goal_info = &_goal_status(impl, position)->goal_info;
     if (output_expired) {
-      info_ptr = &(expired_goals[num_goals_expired]);
-    }
-    ret = rcl_action_goal_handle_get_info(goal_handle, info_ptr);
-    if (RCL_RET_OK != ret) {
-      ret_final = RCL_RET_ERROR;
-      continue;
-    }
-    goal_time = _goal_info_stamp_to_nanosec(info_ptr);
-    if ((current_time - goal_time) > timeout) {
-      // Stop tracking goal handle
-      // Fill in any gaps left in the array with pointers from the end
-      --num_goal_handles;
-      action_server->impl->goal_handles[i] = action_server->impl->goal_handles[num_goal_handles];
-      allocator.deallocate(action_server->impl->goal_handles[num_goal_handles], allocator.state);
-      action_server->impl->goal_handles[num_goal_handles] = NULL;
-      ++num_goals_expired;
+      expired_goals[num_goals_expired] = *goal_info;
     }
+    _expire_heap_pop(impl);
+    _goal_table_remove(impl, _goal_table_find(impl, goal_info->uuid));
+    _remove_goal(impl, position);
+    ++num_goals_expired;
   }
 
-  if (num_goals_expired > 0u) {
-    // Shrink goal handle array if some goals expired
-    if (0u == num_goal_handles) {
-      allocator.deallocate(action_server->impl->goal_handles, allocator.state);
-      action_server->impl->goal_handles = NULL;
-      action_server->impl->num_goal_handles = num_goal_handles;
-    } else {
-      void * tmp_ptr = allocator.reallocate(
-        action_server->impl->goal_handles,
-        num_goal_handles * sizeof(rcl_action_goal_handle_t *),
-        allocator.state);
-      if (!tmp_ptr) {
-        RCL_SET_ERROR_MSG("failed to shrink size of goal handle array");
-        ret_final = RCL_RET_ERROR;
-      } else {
-        action_server->impl->goal_handles = (rcl_action_goal_handle_t **)tmp_ptr;
-        action_server->impl->num_goal_handles = num_goal_handles;
-      }
-    }
-  }
-  ret_final = _recalculate_expire_timer(
-    &action_server->impl->expire_timer,
-    action_server->impl->options.result_timeout.nanoseconds,
-    action_server->impl->goal_handles,
-    action_server->impl->num_goal_handles,
-    &action_server->impl->clock);
+  ret = _recalculate_expire_timer(impl);
 
   // If argument is not null, then set it
   if (NULL != num_expired) {
     (*num_expired) = num_goals_expired;
   }
-  return ret_final;
+  return ret;
 }
 
 rcl_ret_t
 rcl_action_notify_goal_done(
   const rcl_action_server_t * action_server)
 {
-  return _recalculate_expire_timer(
-    &action_server->impl->expire_timer,
-    action_server->impl->options.result_timeout.nanoseconds,
-    action_server->impl->goal_handles,
-    action_server->impl->num_goal_handles,
-    &action_server->impl->clock);
+  if (!rcl_action_server_is_valid(action_server)) {
+    return RCL_RET_ACTION_SERVER_INVALID;
+  }
+  return _recalculate_expire_timer(action_server->impl);
 }
 
 rcl_ret_t
@@ -718,18 +952,13 @@ rcl_action_process_cancel_request(
   RCL_CHECK_ARGUMENT_FOR_NULL(cancel_request, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(cancel_response, RCL_RET_INVALID_ARGUMENT);
 
-  rcl_allocator_t allocator = action_server->impl->options.allocator;
-  const size_t total_num_goals = action_server->impl->num_goal_handles;
+  rcl_action_server_impl_t * impl = action_server->impl;
+  rcl_allocator_t allocator = impl->options.allocator;
 
   // Storage for pointers to active goals handles that will be transitioned to canceling
   // Note, we need heap allocation for MSVC support
-  rcl_action_goal_handle_t ** goal_handles_to_cancel =
-    (rcl_action_goal_handle_t **)allocator.allocate(
-    sizeof(rcl_action_goal_handle_t *) * total_num_goals, allocator.state);
-  if (!goal_handles_to_cancel) {
-    RCL_SET_ERROR_MSG("allocation failed for temporary goal handle array");
-    return RCL_RET_BAD_ALLOC;
-  }
+  rcl_action_goal_handle_t ** goal_handles_to_cancel = NULL;
+  rcl_action_goal_handle_t * single_goal_handle = NULL;
   size_t num_goals_to_cancel = 0u;
 
   // Request data
@@ -741,22 +970,14 @@ rcl_action_process_cancel_request(
   // Determine how many goals should transition to canceling
   if (!uuidcmpzero(request_uuid) && (0u == request_nanosec)) {
     // UUID is not zero and timestamp is zero; cancel exactly one goal (if it exists)
-    rcl_action_goal_info_t goal_info = rcl_action_get_zero_initialized_goal_info();
-    rcl_action_goal_handle_t * goal_handle;
-    for (size_t i = 0u; i < total_num_goals; ++i) {
-      goal_handle = action_server->impl->goal_handles[i];
-      rcl_ret_t ret = rcl_action_goal_handle_get_info(goal_handle, &goal_info);
-      if (RCL_RET_OK != ret) {
-        ret_final = RCL_RET_ERROR;
-        continue;
-      }
-
-      if (uuidcmp(request_uuid, goal_info.uuid)) {
-        if (rcl_action_goal_handle_is_cancelable(goal_handle)) {
-          goal_handles_to_cancel[num_goals_to_cancel++] = goal_handle;
-        }
-        break;
-      }
+    size_t position = 0u;
+    if (0u != impl->goal_table_capacity) {
+      position = impl->goal_table[_goal_table_find(impl, request_uuid)];
+    }
+    if (0u != position && rcl_action_goal_handle_is_cancelable(impl->goal_handles[position - 1u])) {
+      single_goal_handle = impl->goal_handles[position - 1u];
+      goal_handles_to_cancel = &single_goal_handle;
+      num_goals_to_cancel = 1u;
     }
   } else {
     if (uuidcmpzero(request_uuid) && (0u == request_nanosec)) {
@@ -765,21 +986,26 @@ rcl_action_process_cancel_request(
       request_nanosec = INT64_MAX;
     }
 
-    // Cancel all active goals at or before the timestamp
-    // Also cancel any goal matching the UUID in the cancel request
-    rcl_action_goal_info_t goal_info = rcl_action_get_zero_initialized_goal_info();
-    rcl_action_goal_handle_t * goal_handle;
-    for (size_t i = 0u; i < total_num_goals; ++i) {
-      goal_handle = action_server->impl->goal_handles[i];
-      rcl_ret_t ret = rcl_action_goal_handle_get_info(goal_handle, &goal_info);
-      if (RCL_RET_OK != ret) {
-        ret_final = RCL_RET_ERROR;
-        continue;
+    // Only active goals can be canceled
+    _sweep_active_goals(impl);
+    if (impl->num_active_goals > 0u) {
+      goal_handles_to_cancel = (rcl_action_goal_handle_t **)allocator.allocate(
+        sizeof(rcl_action_goal_handle_t *) * impl->num_active_goals, allocator.state);
+      if (!goal_handles_to_cancel) {
+        RCL_SET_ERROR_MSG("allocation failed for temporary goal handle array");
+        return RCL_RET_BAD_ALLOC;
       }
+    }
 
-      const int64_t goal_nanosec = _goal_info_stamp_to_nanosec(&goal_info);
+    // Cancel all active goals at or before the timestamp
+    // Also cancel any goal matching the UUID in the cancel request
+    for (size_t i = 0u; i < impl->num_active_goals; ++i) {
+      const size_t position = impl->active_goals[i];
+      const rcl_action_goal_info_t * goal_info = &_goal_status(impl, position)->goal_info;
+      rcl_action_goal_handle_t * goal_handle = impl->goal_handles[position];
+      const int64_t goal_nanosec = _goal_info_stamp_to_nanosec(goal_info);
       if (rcl_action_goal_handle_is_cancelable(goal_handle) &&
-        ((goal_nanosec <= request_nanosec) || uuidcmp(request_uuid, goal_info.uuid)))
+        ((goal_nanosec <= request_nanosec) || uuidcmp(request_uuid, goal_info->uuid)))
       {
         goal_handles_to_cancel[num_goals_to_cancel++] = goal_handle;
       }
@@ -814,7 +1040,9 @@ rcl_action_process_cancel_request(
     }
   }
 cleanup:
-  allocator.deallocate(goal_handles_to_cancel, allocator.state);
+  if (goal_handles_to_cancel != &single_goal_handle) {
+    allocator.deallocate(goal_handles_to_cancel, allocator.state);
+  }
   return ret_final;
 }
 
@@ -871,20 +1099,9 @@ rcl_action_server_goal_exists(
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(goal_info, false);
 
-  rcl_action_goal_info_t gh_goal_info = rcl_action_get_zero_initialized_goal_info();
-  rcl_ret_t ret;
-  for (size_t i = 0u; i < action_server->impl->num_goal_handles; ++i) {
-    ret = rcl_action_goal_handle_get_info(action_server->impl->goal_handles[i], &gh_goal_info);
-    if (RCL_RET_OK != ret) {
-      RCL_SET_ERROR_MSG("failed to get info for goal handle");
-      return false;
-    }
-    // Compare UUIDs
-    if (uuidcmp(gh_goal_info.uuid, goal_info->uuid)) {
-      return true;
-    }
-  }
-  return false;
+  const rcl_action_server_impl_t * impl = action_server->impl;
+  return 0u != impl->goal_table_capacity &&
+         0u != impl->goal_table[_goal_table_find(impl, goal_info->uuid)];
 }
 
 bool
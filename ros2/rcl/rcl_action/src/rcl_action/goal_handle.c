@@ -73,6 +73,7 @@ rcl_action_goal_handle_fini(rcl_action_goal_handle_t * goal_handle)
   RCL_CHECK_ARGUMENT_FOR_NULL(goal_handle, RCL_RET_ACTION_GOAL_HANDLE_INVALID);
   if (goal_handle->impl) {
     goal_handle->impl->allocator.deallocate(goal_handle->impl, goal_handle->impl->allocator.state);
+    goal_handle->impl = NULL;
   }
   return RCL_RET_OK;
 }
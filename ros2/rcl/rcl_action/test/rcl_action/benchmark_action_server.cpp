@@ -0,0 +1,248 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the goal accept, cancel and expire rates of an action server, and the cost of getting
+// its status array, against the number of live goals: goals that terminated and wait for their
+// result timeout, as for servers handling many short goals.
+//
+// Usage: benchmark_action_server [operations] [live goals...]
+
+#include <stdio.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "rcl_action/action_server.h"
+
+#include "rcl/error_handling.h"
+#include "rcl/rcl.h"
+
+#include "test_msgs/action/fibonacci.h"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double us_since(Clock::time_point start, size_t operations)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / operations;
+}
+
+// Goals are stamped one microsecond apart, starting at one second
+const int64_t goal_period = RCUTILS_US_TO_NS(1);
+const int64_t first_stamp = RCUTILS_S_TO_NS(1);
+
+class Benchmark
+{
+public:
+  Benchmark(rcl_node_t * node, rcl_clock_t * clock)
+  : node_(node), clock_(clock), next_id_(0u), now_(first_stamp)
+  {
+    options_ = rcl_action_server_get_default_options();
+    action_server_ = rcl_action_get_zero_initialized_server();
+    const rosidl_action_type_support_t * ts = ROSIDL_GET_ACTION_TYPE_SUPPORT(test_msgs, Fibonacci);
+    ok_ = RCL_RET_OK == rcl_action_server_init(
+      &action_server_, node_, clock_, ts, "benchmark_action_server", &options_);
+  }
+
+  ~Benchmark()
+  {
+    for (auto & handle : handles_) {
+      (void)rcl_action_goal_handle_fini(&handle);
+    }
+    (void)rcl_action_server_fini(&action_server_, node_);
+  }
+
+  bool ok() const
+  {
+    return ok_;
+  }
+
+  // Accept a goal, stamped one period after the previous one
+  rcl_action_goal_handle_t * accept(rcl_action_goal_info_t * goal_info)
+  {
+    *goal_info = rcl_action_get_zero_initialized_goal_info();
+    ++next_id_;
+    memcpy(goal_info->uuid, &next_id_, sizeof(next_id_));
+    now_ += goal_period;
+    ok_ = ok_ && RCL_RET_OK == rcl_set_ros_time_override(clock_, now_);
+    rcl_action_goal_handle_t * goal_handle = rcl_action_accept_new_goal(&action_server_, goal_info);
+    ok_ = ok_ && nullptr != goal_handle;
+    if (nullptr != goal_handle) {
+      handles_.push_back(*goal_handle);
+    }
+    return goal_handle;
+  }
+
+  // Accept a goal and terminate it, as short goals do
+  void accept_and_succeed()
+  {
+    rcl_action_goal_info_t goal_info;
+    rcl_action_goal_handle_t * goal_handle = accept(&goal_info);
+    ok_ = ok_ && RCL_RET_OK == rcl_action_update_goal_state(goal_handle, GOAL_EVENT_EXECUTE);
+    ok_ = ok_ && RCL_RET_OK == rcl_action_update_goal_state(goal_handle, GOAL_EVENT_SET_SUCCEEDED);
+    ok_ = ok_ && RCL_RET_OK == rcl_action_notify_goal_done(&action_server_);
+  }
+
+  // Accept a goal, then cancel it by its ID
+  void accept_and_cancel()
+  {
+    rcl_action_goal_info_t goal_info;
+    rcl_action_goal_handle_t * goal_handle = accept(&goal_info);
+    rcl_action_cancel_request_t cancel_request = rcl_action_get_zero_initialized_cancel_request();
+    memcpy(cancel_request.goal_info.uuid, goal_info.uuid, UUID_SIZE);
+    rcl_action_cancel_response_t cancel_response =
+      rcl_action_get_zero_initialized_cancel_response();
+    ok_ = ok_ && RCL_RET_OK == rcl_action_process_cancel_request(
+      &action_server_, &cancel_request, &cancel_response);
+    ok_ = ok_ && 1u == cancel_response.msg.goals_canceling.size;
+    ok_ = ok_ && RCL_RET_OK == rcl_action_cancel_response_fini(&cancel_response);
+    ok_ = ok_ && RCL_RET_OK == rcl_action_update_goal_state(goal_handle, GOAL_EVENT_CANCEL);
+    ok_ = ok_ && RCL_RET_OK == rcl_action_update_goal_state(goal_handle, GOAL_EVENT_SET_CANCELED);
+    ok_ = ok_ && RCL_RET_OK == rcl_action_notify_goal_done(&action_server_);
+  }
+
+  // Expire the oldest goal
+  void expire(size_t expired)
+  {
+    int64_t now = first_stamp + static_cast<int64_t>(expired + 2) * goal_period +
+      static_cast<int64_t>(options_.result_timeout.nanoseconds);
+    ok_ = ok_ && RCL_RET_OK == rcl_set_ros_time_override(clock_, now);
+    rcl_action_goal_info_t expired_goal;
+    size_t num_expired = 0u;
+    ok_ = ok_ && RCL_RET_OK ==
+      rcl_action_expire_goals(&action_server_, &expired_goal, 1u, &num_expired);
+    ok_ = ok_ && 1u == num_expired;
+  }
+
+  void get_status()
+  {
+    rcl_action_goal_status_array_t status_array =
+      rcl_action_get_zero_initialized_goal_status_array();
+    ok_ = ok_ && RCL_RET_OK == rcl_action_get_goal_status_array(&action_server_, &status_array);
+    ok_ = ok_ && RCL_RET_OK == rcl_action_goal_status_array_fini(&status_array);
+  }
+
+  void update_status()
+  {
+    const rcl_action_goal_status_array_t * status_array = nullptr;
+    bool changed = false;
+    ok_ = ok_ && RCL_RET_OK ==
+      rcl_action_update_goal_status_array(&action_server_, &status_array, &changed);
+  }
+
+private:
+  rcl_node_t * node_;
+  rcl_clock_t * clock_;
+  rcl_action_server_options_t options_;
+  rcl_action_server_t action_server_;
+  std::vector<rcl_action_goal_handle_t> handles_;
+  uint64_t next_id_;
+  int64_t now_;
+  bool ok_;
+};
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t operations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+  std::vector<size_t> live_goals;
+  for (int i = 2; i < argc; ++i) {
+    live_goals.push_back(std::strtoul(argv[i], nullptr, 10));
+  }
+  if (live_goals.empty()) {
+    live_goals = {100, 1000, 10000};
+  }
+  if (0 == operations) {
+    fprintf(stderr, "Usage: %s [operations] [live goals...]\n", argv[0]);
+    return 1;
+  }
+
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t node_options = rcl_node_get_default_options();
+  rcl_clock_t clock;
+  if (RCL_RET_OK != rcl_init_options_init(&init_options, allocator) ||
+    RCL_RET_OK != rcl_init(0, nullptr, &init_options, &context) ||
+    RCL_RET_OK != rcl_node_init(
+      &node, "benchmark_action_server_node", "", &context, &node_options) ||
+    RCL_RET_OK != rcl_clock_init(RCL_ROS_TIME, &clock, &allocator) ||
+    RCL_RET_OK != rcl_enable_ros_time_override(&clock))
+  {
+    fprintf(stderr, "failed to initialize: %s\n", rcl_get_error_string().str);
+    return 1;
+  }
+
+  bool ok = true;
+  printf("%12s %12s %12s %12s %12s %12s\n",
+    "live goals", "accept (us)", "cancel (us)", "expire (us)", "status (us)", "update (us)");
+  for (size_t num_goals : live_goals) {
+    Benchmark benchmark(&node, &clock);
+    for (size_t i = 0; i < num_goals; ++i) {
+      benchmark.accept_and_succeed();
+    }
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+      benchmark.accept_and_succeed();
+    }
+    double accept = us_since(start, operations);
+
+    start = Clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+      benchmark.accept_and_cancel();
+    }
+    double cancel = us_since(start, operations);
+
+    // Expire as many goals as were added, back to the same number of live goals
+    start = Clock::now();
+    for (size_t i = 0; i < 2 * operations; ++i) {
+      benchmark.expire(i);
+    }
+    double expire = us_since(start, 2 * operations);
+
+    start = Clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+      benchmark.get_status();
+    }
+    double status = us_since(start, operations);
+
+    start = Clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+      benchmark.update_status();
+    }
+    double update = us_since(start, operations);
+
+    ok = ok && benchmark.ok();
+    printf("%12zu %12.3f %12.3f %12.3f %12.3f %12.3f\n",
+      num_goals, accept, cancel, expire, status, update);
+  }
+
+  (void)rcl_node_fini(&node);
+  (void)rcl_clock_fini(&clock);
+  (void)rcl_shutdown(&context);
+  (void)rcl_context_fini(&context);
+  (void)rcl_init_options_fini(&init_options);
+  if (!ok) {
+    fprintf(stderr, "benchmark failed: %s\n", rcl_get_error_string().str);
+    return 1;
+  }
+  return 0;
+}
@@ -343,6 +343,260 @@ TEST_F(TestActionServer, test_action_clear_expired_goals)
   }
 }
 
+// The goal table of an action server starts with 16 slots, goals are placed from the FNV-1a hash
+// of their UUID
+static size_t goal_table_home_slot(const uint8_t * uuid)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0u; i < UUID_SIZE; ++i) {
+    hash ^= uuid[i];
+    hash *= 1099511628211ULL;
+  }
+  return static_cast<size_t>(hash) & 15u;
+}
+
+TEST_F(TestActionServer, test_action_goal_lookup_after_expire)
+{
+  // Find goals A, B and C with the same home slot and D with the next slot, so that they are
+  // placed in four consecutive slots and removing A or B shifts back the following goals
+  std::vector<rcl_action_goal_info_t> goal_infos;
+  size_t home = 0u;
+  for (uint16_t i = 0u; goal_infos.size() < 4u; ++i) {
+    rcl_action_goal_info_t goal_info = rcl_action_get_zero_initialized_goal_info();
+    goal_info.uuid[0] = static_cast<uint8_t>(i & 0xff);
+    goal_info.uuid[1] = static_cast<uint8_t>(i >> 8);
+    const size_t slot = goal_table_home_slot(goal_info.uuid);
+    if (goal_infos.empty()) {
+      home = slot;
+    }
+    if (goal_infos.size() < 3u ? slot == home : slot == ((home + 1u) & 15u)) {
+      goal_infos.push_back(goal_info);
+    }
+  }
+
+  // Accept them one second apart, so that they expire in that order
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&this->clock));
+  std::vector<rcl_action_goal_handle_t> handles;
+  for (size_t i = 0u; i < goal_infos.size(); ++i) {
+    const int64_t stamp = RCUTILS_S_TO_NS(1) * static_cast<int64_t>(i + 1);
+    ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&this->clock, stamp));
+    rcl_action_goal_handle_t * goal_handle =
+      rcl_action_accept_new_goal(&this->action_server, &goal_infos[i]);
+    ASSERT_NE(goal_handle, nullptr) << rcl_get_error_string().str;
+    ASSERT_EQ(RCL_RET_OK, rcl_action_update_goal_state(goal_handle, GOAL_EVENT_EXECUTE));
+    handles.push_back(*goal_handle);
+  }
+  ASSERT_EQ(RCL_RET_OK, rcl_action_update_goal_state(&handles[0], GOAL_EVENT_SET_SUCCEEDED));
+  ASSERT_EQ(RCL_RET_OK, rcl_action_update_goal_state(&handles[1], GOAL_EVENT_SET_ABORTED));
+
+  const int64_t timeout =
+    rcl_action_server_get_options(&this->action_server)->result_timeout.nanoseconds;
+  for (size_t expired = 0u; expired < 2u; ++expired) {
+    const int64_t stamp = RCUTILS_S_TO_NS(1) * static_cast<int64_t>(expired + 1);
+    ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(
+        &this->clock, stamp + timeout + RCUTILS_MS_TO_NS(500)));
+    rcl_action_goal_info_t expired_goals[4u];
+    size_t num_expired = 0u;
+    rcl_ret_t ret = rcl_action_expire_goals(
+      &this->action_server, expired_goals, 4u, &num_expired);
+    ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+    ASSERT_EQ(num_expired, 1u);
+    EXPECT_TRUE(uuidcmp(expired_goals[0].uuid, goal_infos[expired].uuid));
+
+    // The goals after it in the table are still found
+    for (size_t i = 0u; i < goal_infos.size(); ++i) {
+      EXPECT_EQ(i > expired, rcl_action_server_goal_exists(&this->action_server, &goal_infos[i]));
+    }
+  }
+
+  // And they can still be canceled one by one
+  for (size_t i = 2u; i < goal_infos.size(); ++i) {
+    rcl_action_cancel_request_t cancel_request = rcl_action_get_zero_initialized_cancel_request();
+    cancel_request.goal_info = goal_infos[i];
+    rcl_action_cancel_response_t cancel_response =
+      rcl_action_get_zero_initialized_cancel_response();
+    rcl_ret_t ret = rcl_action_process_cancel_request(
+      &this->action_server, &cancel_request, &cancel_response);
+    ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+    ASSERT_EQ(cancel_response.msg.goals_canceling.size, 1u);
+    EXPECT_TRUE(uuidcmp(cancel_response.msg.goals_canceling.data[0].uuid, goal_infos[i].uuid));
+    EXPECT_EQ(RCL_RET_OK, rcl_action_cancel_response_fini(&cancel_response));
+  }
+
+  // An expired goal ID can be used again
+  rcl_action_goal_handle_t * goal_handle =
+    rcl_action_accept_new_goal(&this->action_server, &goal_infos[0]);
+  ASSERT_NE(goal_handle, nullptr) << rcl_get_error_string().str;
+  EXPECT_TRUE(rcl_action_server_goal_exists(&this->action_server, &goal_infos[0]));
+  handles.push_back(*goal_handle);
+
+  for (auto & handle : handles) {
+    EXPECT_EQ(RCL_RET_OK, rcl_action_goal_handle_fini(&handle));
+  }
+}
+
+TEST_F(TestActionServer, test_action_expire_goals_in_stamp_order)
+{
+  // Accept goals one second apart, and terminate them in another order
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&this->clock));
+  const size_t num_goals = 5u;
+  std::vector<rcl_action_goal_handle_t> handles;
+  for (size_t i = 0u; i < num_goals; ++i) {
+    const int64_t stamp = RCUTILS_S_TO_NS(1) * static_cast<int64_t>(i + 1);
+    ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&this->clock, stamp));
+    rcl_action_goal_info_t goal_info = rcl_action_get_zero_initialized_goal_info();
+    goal_info.uuid[0] = static_cast<uint8_t>(i);
+    rcl_action_goal_handle_t * goal_handle =
+      rcl_action_accept_new_goal(&this->action_server, &goal_info);
+    ASSERT_NE(goal_handle, nullptr) << rcl_get_error_string().str;
+    handles.push_back(*goal_handle);
+  }
+  for (size_t i : {3u, 0u, 4u, 1u, 2u}) {
+    ASSERT_EQ(RCL_RET_OK, rcl_action_update_goal_state(&handles[i], GOAL_EVENT_CANCEL));
+    ASSERT_EQ(RCL_RET_OK, rcl_action_update_goal_state(&handles[i], GOAL_EVENT_SET_CANCELED));
+    EXPECT_EQ(RCL_RET_OK, rcl_action_notify_goal_done(&this->action_server));
+  }
+
+  // The oldest goals expire first, and no more than fit in the output array
+  const int64_t timeout =
+    rcl_action_server_get_options(&this->action_server)->result_timeout.nanoseconds;
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(
+      &this->clock, RCUTILS_S_TO_NS(2) + timeout + RCUTILS_MS_TO_NS(500)));
+  rcl_action_goal_info_t expired_goals[5u];
+  size_t num_expired = 0u;
+  rcl_ret_t ret = rcl_action_expire_goals(
+    &this->action_server, expired_goals, num_goals, &num_expired);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  ASSERT_EQ(num_expired, 2u);
+  EXPECT_EQ(expired_goals[0].uuid[0], 0u);
+  EXPECT_EQ(expired_goals[1].uuid[0], 1u);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&this->clock, RCUTILS_S_TO_NS(99999)));
+  ret = rcl_action_expire_goals(&this->action_server, expired_goals, 1u, &num_expired);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  ASSERT_EQ(num_expired, 1u);
+  EXPECT_EQ(expired_goals[0].uuid[0], 2u);
+  ret = rcl_action_expire_goals(&this->action_server, expired_goals, num_goals, &num_expired);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  ASSERT_EQ(num_expired, 2u);
+  EXPECT_EQ(expired_goals[0].uuid[0], 3u);
+  EXPECT_EQ(expired_goals[1].uuid[0], 4u);
+
+  for (auto & handle : handles) {
+    EXPECT_EQ(RCL_RET_OK, rcl_action_goal_handle_fini(&handle));
+  }
+}
+
+TEST_F(TestActionServer, test_action_update_goal_status_array)
+{
+  const rcl_action_goal_status_array_t * status_array = nullptr;
+  bool changed = true;
+  // Update with null arguments
+  rcl_ret_t ret = rcl_action_update_goal_status_array(nullptr, &status_array, &changed);
+  EXPECT_EQ(ret, RCL_RET_ACTION_SERVER_INVALID);
+  rcl_reset_error();
+  ret = rcl_action_update_goal_status_array(&this->action_server, nullptr, &changed);
+  EXPECT_EQ(ret, RCL_RET_INVALID_ARGUMENT);
+  rcl_reset_error();
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_array, nullptr);
+  EXPECT_EQ(ret, RCL_RET_INVALID_ARGUMENT);
+  rcl_reset_error();
+
+  // Nothing changed yet
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_array, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  ASSERT_NE(status_array, nullptr);
+  EXPECT_FALSE(changed);
+  EXPECT_EQ(status_array->msg.status_list.size, 0u);
+
+  // Accepting a goal is a change
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&this->clock));
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&this->clock, RCUTILS_S_TO_NS(1)));
+  rcl_action_goal_info_t goal_info_in = rcl_action_get_zero_initialized_goal_info();
+  init_test_uuid0(goal_info_in.uuid);
+  rcl_action_goal_handle_t * accepted_handle =
+    rcl_action_accept_new_goal(&this->action_server, &goal_info_in);
+  ASSERT_NE(accepted_handle, nullptr) << rcl_get_error_string().str;
+  // The action server frees its goal handle when the goal expires
+  rcl_action_goal_handle_t goal_handle = *accepted_handle;
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_array, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_TRUE(changed);
+  ASSERT_EQ(status_array->msg.status_list.size, 1u);
+  EXPECT_TRUE(uuidcmp(status_array->msg.status_list.data[0].goal_info.uuid, goal_info_in.uuid));
+  EXPECT_EQ(status_array->msg.status_list.data[0].status, GOAL_STATE_ACCEPTED);
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_array, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_FALSE(changed);
+
+  // So is a state change of the goal
+  ASSERT_EQ(RCL_RET_OK, rcl_action_update_goal_state(&goal_handle, GOAL_EVENT_EXECUTE));
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_array, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(status_array->msg.status_list.data[0].status, GOAL_STATE_EXECUTING);
+  ASSERT_EQ(RCL_RET_OK, rcl_action_update_goal_state(&goal_handle, GOAL_EVENT_SET_SUCCEEDED));
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_array, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(status_array->msg.status_list.data[0].status, GOAL_STATE_SUCCEEDED);
+
+  // A terminated goal does not change until it expires
+  ret = rcl_action_expire_goals(&this->action_server, nullptr, 0u, nullptr);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_array, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_FALSE(changed);
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&this->clock, RCUTILS_S_TO_NS(99999)));
+  ret = rcl_action_expire_goals(&this->action_server, nullptr, 0u, nullptr);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_array, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(status_array->msg.status_list.size, 0u);
+
+  EXPECT_EQ(RCL_RET_OK, rcl_action_goal_handle_fini(&goal_handle));
+}
+
+TEST_F(TestActionServer, test_action_finalized_goal_handle)
+{
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(&this->clock));
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&this->clock, RCUTILS_S_TO_NS(1)));
+  rcl_action_goal_info_t goal_info_in = rcl_action_get_zero_initialized_goal_info();
+  init_test_uuid0(goal_info_in.uuid);
+  rcl_action_goal_handle_t * goal_handle =
+    rcl_action_accept_new_goal(&this->action_server, &goal_info_in);
+  ASSERT_NE(goal_handle, nullptr) << rcl_get_error_string().str;
+
+  // Finalize the goal handle tracked by the action server while it is still active
+  EXPECT_EQ(RCL_RET_OK, rcl_action_goal_handle_fini(goal_handle));
+  EXPECT_FALSE(rcl_action_goal_handle_is_valid(goal_handle));
+  rcl_reset_error();
+
+  // It can no longer be canceled, but it is still reported until it expires
+  rcl_action_cancel_request_t cancel_request = rcl_action_get_zero_initialized_cancel_request();
+  rcl_action_cancel_response_t cancel_response = rcl_action_get_zero_initialized_cancel_response();
+  rcl_ret_t ret = rcl_action_process_cancel_request(
+    &this->action_server, &cancel_request, &cancel_response);
+  EXPECT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_EQ(cancel_response.msg.goals_canceling.size, 0u);
+  EXPECT_EQ(RCL_RET_OK, rcl_action_cancel_response_fini(&cancel_response));
+  rcl_action_goal_status_array_t status_array =
+    rcl_action_get_zero_initialized_goal_status_array();
+  ret = rcl_action_get_goal_status_array(&this->action_server, &status_array);
+  EXPECT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_EQ(status_array.msg.status_list.size, 1u);
+  EXPECT_EQ(RCL_RET_OK, rcl_action_goal_status_array_fini(&status_array));
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(&this->clock, RCUTILS_S_TO_NS(99999)));
+  rcl_action_goal_info_t expired_goals[1u];
+  size_t num_expired = 0u;
+  ret = rcl_action_expire_goals(&this->action_server, expired_goals, 1u, &num_expired);
+  EXPECT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_EQ(num_expired, 1u);
+  EXPECT_TRUE(uuidcmp(expired_goals[0].uuid, goal_info_in.uuid));
+}
+
 TEST_F(TestActionServer, test_action_process_cancel_request)
 {
   rcl_action_cancel_request_t cancel_request = rcl_action_get_zero_initialized_cancel_request();
@@ -450,6 +704,39 @@ TEST_F(TestActionServer, test_action_server_get_goal_status_array)
   }
 }
 
+TEST_F(TestActionServer, test_action_server_get_goal_status_array_is_read_only)
+{
+  rcl_action_goal_info_t goal_info_in = rcl_action_get_zero_initialized_goal_info();
+  init_test_uuid0(goal_info_in.uuid);
+  rcl_action_goal_handle_t * goal_handle =
+    rcl_action_accept_new_goal(&this->action_server, &goal_info_in);
+  ASSERT_NE(goal_handle, nullptr) << rcl_get_error_string().str;
+  const rcl_action_goal_status_array_t * status_cache = nullptr;
+  bool changed = false;
+  rcl_ret_t ret = rcl_action_update_goal_status_array(
+    &this->action_server, &status_cache, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_TRUE(changed);
+
+  // The copy reports the current state of the goal
+  ASSERT_EQ(RCL_RET_OK, rcl_action_update_goal_state(goal_handle, GOAL_EVENT_EXECUTE));
+  rcl_action_goal_status_array_t status_array =
+    rcl_action_get_zero_initialized_goal_status_array();
+  ret = rcl_action_get_goal_status_array(&this->action_server, &status_array);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  ASSERT_EQ(status_array.msg.status_list.size, 1u);
+  EXPECT_EQ(status_array.msg.status_list.data[0].status, GOAL_STATE_EXECUTING);
+  EXPECT_EQ(RCL_RET_OK, rcl_action_goal_status_array_fini(&status_array));
+
+  // But the status kept by the action server was not updated
+  EXPECT_EQ(status_cache->msg.status_list.data[0].status, GOAL_STATE_ACCEPTED);
+  ret = rcl_action_update_goal_status_array(&this->action_server, &status_cache, &changed);
+  ASSERT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(status_cache->msg.status_list.data[0].status, GOAL_STATE_EXECUTING);
+  EXPECT_EQ(RCL_RET_OK, rcl_action_goal_handle_fini(goal_handle));
+}
+
 TEST_F(TestActionServer, test_action_server_get_action_name)
 {
   // Get action_name for a null action server
@@ -63,6 +63,12 @@ TEST(TestGoalHandle, test_goal_handle_init_fini)
   // Finalize with valid goal handle
   ret = rcl_action_goal_handle_fini(&goal_handle);
   EXPECT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
+  EXPECT_FALSE(rcl_action_goal_handle_is_valid(&goal_handle));
+  rcl_reset_error();
+
+  // Finalize again
+  ret = rcl_action_goal_handle_fini(&goal_handle);
+  EXPECT_EQ(ret, RCL_RET_OK) << rcl_get_error_string().str;
 }
 
 TEST(TestGoalHandle, test_goal_handle_is_valid)
@@ -15,6 +15,8 @@
 #ifndef RCL_LIFECYCLE__DATA_TYPES_H_
 #define RCL_LIFECYCLE__DATA_TYPES_H_
 
+#include "lifecycle_msgs/msg/transition_event.h"
+
 #include "rcl/rcl.h"
 
 #include "rcl_lifecycle/visibility_control.h"
@@ -43,12 +45,40 @@ typedef struct rcl_lifecycle_transition_t
   rcl_lifecycle_state_t * goal;
 } rcl_lifecycle_transition_t;
 
+/// Value of an index in a lookup table when there is no entry.
+#define RCL_LIFECYCLE_LOOKUP_NONE 0xFF
+
+/// Precomputed lookup of the valid transitions of the states of a transition map.
+/**
+ * Transition ids and labels are interned to dense indices, so the transition of a state is
+ * found with one table access rather than by scanning its valid transitions.
+ * Each table entry is an index in the valid_transitions of the state.
+ */
+typedef struct rcl_lifecycle_transition_lookup_t
+{
+  // Dense index of each transition id
+  uint8_t id_indices[256];
+  unsigned int ids_size;
+  // Distinct transition labels, a label is interned to its index in this array
+  const char ** labels;
+  unsigned int labels_size;
+  // states_size * ids_size entries
+  uint8_t * by_id;
+  // states_size * labels_size entries
+  uint8_t * by_label;
+} rcl_lifecycle_transition_lookup_t;
+
 typedef struct rcl_lifecycle_transition_map_t
 {
   rcl_lifecycle_state_t * states;
   unsigned int states_size;
   rcl_lifecycle_transition_t * transitions;
   unsigned int transitions_size;
+  // Allocated sizes of states and transitions
+  unsigned int states_capacity;
+  unsigned int transitions_capacity;
+  // Built by rcl_lifecycle_transition_map_build_lookup(), by_id is NULL while it isn't
+  rcl_lifecycle_transition_lookup_t lookup;
 } rcl_lifecycle_transition_map_t;
 
 typedef struct rcl_lifecycle_com_interface_t
@@ -60,6 +90,8 @@ typedef struct rcl_lifecycle_com_interface_t
   rcl_service_t srv_get_available_states;
   rcl_service_t srv_get_available_transitions;
   rcl_service_t srv_get_transition_graph;
+  // Reused for each notification, so state machines can publish from different threads
+  lifecycle_msgs__msg__TransitionEvent msg_transition_event;
 } rcl_lifecycle_com_interface_t;
 
 typedef struct rcl_lifecycle_state_machine_t
@@ -73,6 +73,42 @@ rcl_lifecycle_get_transitions(
   rcl_lifecycle_transition_map_t * transition_map,
   unsigned int state_id);
 
+/// Precompute the lookup of the valid transitions of each state of the map.
+/**
+ * Has to be called again once states or transitions are registered, registering them discards
+ * the lookup.
+ * The lookup isn't built if transition ids don't fit in a byte, the transitions are then found
+ * by scanning the valid transitions of the states.
+ * rcl_lifecycle_init_default_state_machine() builds it for the default state machine.
+ */
+RCL_LIFECYCLE_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_lifecycle_transition_map_build_lookup(
+  rcl_lifecycle_transition_map_t * transition_map,
+  const rcl_allocator_t * allocator);
+
+/// Find the valid transition of a state of the map with the given id.
+/**
+ * Returns NULL if the state has no such transition, without logging it.
+ */
+RCL_LIFECYCLE_PUBLIC
+RCL_WARN_UNUSED
+const rcl_lifecycle_transition_t *
+rcl_lifecycle_transition_map_find_by_id(
+  const rcl_lifecycle_transition_map_t * transition_map,
+  const rcl_lifecycle_state_t * state,
+  unsigned int transition_id);
+
+/// Find the valid transition of a state of the map with the given label.
+RCL_LIFECYCLE_PUBLIC
+RCL_WARN_UNUSED
+const rcl_lifecycle_transition_t *
+rcl_lifecycle_transition_map_find_by_label(
+  const rcl_lifecycle_transition_map_t * transition_map,
+  const rcl_lifecycle_state_t * state,
+  const char * label);
+
 #ifdef __cplusplus
 }
 #endif
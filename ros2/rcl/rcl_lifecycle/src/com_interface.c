@@ -36,7 +36,6 @@ extern "C"
 
 #include "rcl_lifecycle/data_types.h"
 
-static lifecycle_msgs__msg__TransitionEvent msg;
 static const char * pub_transition_event_topic = "~/transition_event";
 static const char * srv_change_state_service = "~/change_state";
 static const char * srv_get_state_service = "~/get_state";
@@ -55,6 +54,8 @@ rcl_lifecycle_get_zero_initialized_com_interface()
   com_interface.srv_get_available_states = rcl_get_zero_initialized_service();
   com_interface.srv_get_available_transitions = rcl_get_zero_initialized_service();
   com_interface.srv_get_transition_graph = rcl_get_zero_initialized_service();
+  // zero initialized, so it can be finalized even if it is never initialized
+  memset(&com_interface.msg_transition_event, 0, sizeof(com_interface.msg_transition_event));
   return com_interface;
 }
 
@@ -89,8 +90,11 @@ rcl_lifecycle_com_interface_init(
       goto fail;
     }
 
-    // initialize static message for notification
-    lifecycle_msgs__msg__TransitionEvent__init(&msg);
+    // initialize message for notification
+    if (!lifecycle_msgs__msg__TransitionEvent__init(&com_interface->msg_transition_event)) {
+      RCL_SET_ERROR_MSG("failed to initialize transition event message");
+      goto fail;
+    }
   }
 
   // initialize change state service
@@ -155,6 +159,7 @@ rcl_lifecycle_com_interface_init(
   return RCL_RET_OK;
 
 fail:
+  lifecycle_msgs__msg__TransitionEvent__fini(&com_interface->msg_transition_event);
   if (RCL_RET_OK != rcl_publisher_fini(&com_interface->pub_transition_event, node_handle)) {
     RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to destroy transition_event publisher");
   }
@@ -233,7 +238,7 @@ rcl_lifecycle_com_interface_fini(
 
   // destroy the publisher
   {
-    lifecycle_msgs__msg__TransitionEvent__fini(&msg);
+    lifecycle_msgs__msg__TransitionEvent__fini(&com_interface->msg_transition_event);
 
     rcl_ret_t ret = rcl_publisher_fini(
       &com_interface->pub_transition_event, node_handle);
@@ -250,12 +255,13 @@ rcl_lifecycle_com_interface_publish_notification(
   rcl_lifecycle_com_interface_t * com_interface,
   const rcl_lifecycle_state_t * start, const rcl_lifecycle_state_t * goal)
 {
-  msg.start_state.id = start->id;
-  rosidl_generator_c__String__assign(&msg.start_state.label, start->label);
-  msg.goal_state.id = goal->id;
-  rosidl_generator_c__String__assign(&msg.goal_state.label, goal->label);
+  lifecycle_msgs__msg__TransitionEvent * msg = &com_interface->msg_transition_event;
+  msg->start_state.id = start->id;
+  rosidl_generator_c__String__assign(&msg->start_state.label, start->label);
+  msg->goal_state.id = goal->id;
+  rosidl_generator_c__String__assign(&msg->goal_state.label, goal->label);
 
-  return rcl_publish(&com_interface->pub_transition_event, &msg);
+  return rcl_publish(&com_interface->pub_transition_event, msg);
 }
 
 #ifdef __cplusplus
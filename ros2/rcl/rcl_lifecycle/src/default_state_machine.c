@@ -682,6 +682,14 @@ rcl_lifecycle_init_default_state_machine(
     goto fail;
   }
 
+  // ***************************************************
+  // precompute the lookup of the transitions per state
+  // ***************************************************
+  ret = rcl_lifecycle_transition_map_build_lookup(&state_machine->transition_map, allocator);
+  if (ret != RCL_RET_OK) {
+    goto fail;
+  }
+
   // *************************************
   // set the initial state to unconfigured
   // *************************************
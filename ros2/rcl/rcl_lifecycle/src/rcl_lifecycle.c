@@ -352,8 +352,14 @@ rcl_lifecycle_trigger_transition_by_id(
     return RCL_RET_ERROR;
   }
 
-  const rcl_lifecycle_transition_t * transition =
-    rcl_lifecycle_get_transition_by_id(state_machine->current_state, id);
+  const rcl_lifecycle_transition_t * transition = rcl_lifecycle_transition_map_find_by_id(
+    &state_machine->transition_map, state_machine->current_state, id);
+  if (!transition && state_machine->current_state) {
+    RCUTILS_LOG_WARN_NAMED(
+      ROS_PACKAGE_NAME,
+      "No transition matching %d found for current state %s",
+      id, state_machine->current_state->label);
+  }
 
   return _trigger_transition(state_machine, transition, publish_notification);
 }
@@ -369,8 +375,14 @@ rcl_lifecycle_trigger_transition_by_label(
     return RCL_RET_ERROR;
   }
 
-  const rcl_lifecycle_transition_t * transition =
-    rcl_lifecycle_get_transition_by_label(state_machine->current_state, label);
+  const rcl_lifecycle_transition_t * transition = rcl_lifecycle_transition_map_find_by_label(
+    &state_machine->transition_map, state_machine->current_state, label);
+  if (!transition && state_machine->current_state) {
+    RCUTILS_LOG_WARN_NAMED(
+      ROS_PACKAGE_NAME,
+      "No transition matching %s found for current state %s",
+      label, state_machine->current_state->label);
+  }
 
   return _trigger_transition(state_machine, transition, publish_notification);
 }
@@ -34,6 +34,9 @@ rcl_lifecycle_get_zero_initialized_transition_map()
   transition_map.states_size = 0;
   transition_map.transitions = NULL;
   transition_map.transitions_size = 0;
+  transition_map.states_capacity = 0;
+  transition_map.transitions_capacity = 0;
+  memset(&transition_map.lookup, 0, sizeof(transition_map.lookup));
 
   return transition_map;
 }
@@ -48,6 +51,32 @@ rcl_lifecycle_transition_map_is_initialized(const rcl_lifecycle_transition_map_t
   return is_initialized;
 }
 
+static void
+_lookup_fini(rcl_lifecycle_transition_lookup_t * lookup, const rcutils_allocator_t * allocator)
+{
+  allocator->deallocate((void *)lookup->labels, allocator->state);
+  allocator->deallocate(lookup->by_id, allocator->state);
+  allocator->deallocate(lookup->by_label, allocator->state);
+  memset(lookup, 0, sizeof(*lookup));
+}
+
+// Grow an array to hold one more element, doubling its capacity
+static void *
+_reserve_one_more(
+  void * array, unsigned int size, unsigned int * capacity, size_t element_size,
+  const rcutils_allocator_t * allocator)
+{
+  if (size < *capacity) {
+    return array;
+  }
+  unsigned int new_capacity = *capacity ? *capacity * 2 : 8;
+  void * new_array = allocator->reallocate(array, new_capacity * element_size, allocator->state);
+  if (new_array) {
+    *capacity = new_capacity;
+  }
+  return new_array;
+}
+
 rcl_ret_t
 rcl_lifecycle_transition_map_fini(
   rcl_lifecycle_transition_map_t * transition_map,
@@ -55,12 +84,23 @@ rcl_lifecycle_transition_map_fini(
 {
   rcl_ret_t fcn_ret = RCL_RET_OK;
 
+  _lookup_fini(&transition_map->lookup, allocator);
+
+  // free the valid transitions of the states
+  for (unsigned int i = 0; i < transition_map->states_size; ++i) {
+    allocator->deallocate(transition_map->states[i].valid_transitions, allocator->state);
+    transition_map->states[i].valid_transitions = NULL;
+  }
   // free the primary states
   allocator->deallocate(transition_map->states, allocator->state);
   transition_map->states = NULL;
+  transition_map->states_size = 0;
+  transition_map->states_capacity = 0;
   // free the tansitions
   allocator->deallocate(transition_map->transitions, allocator->state);
   transition_map->transitions = NULL;
+  transition_map->transitions_size = 0;
+  transition_map->transitions_capacity = 0;
 
   return fcn_ret;
 }
@@ -79,18 +119,20 @@ rcl_lifecycle_register_state(
   RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
     allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT)
 
+  // the lookup has to be built again once all states and transitions are registered
+  _lookup_fini(&transition_map->lookup, allocator);
+
   // add new primary state memory
-  transition_map->states_size += 1;
-  rcl_lifecycle_state_t * new_states = allocator->reallocate(
-    transition_map->states,
-    transition_map->states_size * sizeof(rcl_lifecycle_state_t),
-    allocator->state);
+  rcl_lifecycle_state_t * new_states = _reserve_one_more(
+    transition_map->states, transition_map->states_size, &transition_map->states_capacity,
+    sizeof(rcl_lifecycle_state_t), allocator);
   if (!new_states) {
     RCL_SET_ERROR_MSG("failed to reallocate memory for new states");
     return RCL_RET_ERROR;
   }
   transition_map->states = new_states;
-  transition_map->states[transition_map->states_size - 1] = state;
+  transition_map->states[transition_map->states_size] = state;
+  transition_map->states_size += 1;
 
   return RCL_RET_OK;
 }
@@ -110,19 +152,20 @@ rcl_lifecycle_register_transition(
     return RCL_RET_ERROR;
   }
 
+  _lookup_fini(&transition_map->lookup, allocator);
+
   // we add a new transition, so increase the size
-  transition_map->transitions_size += 1;
-  rcl_lifecycle_transition_t * new_transitions = allocator->reallocate(
-    transition_map->transitions,
-    transition_map->transitions_size * sizeof(rcl_lifecycle_transition_t),
-    allocator->state);
+  rcl_lifecycle_transition_t * new_transitions = _reserve_one_more(
+    transition_map->transitions, transition_map->transitions_size,
+    &transition_map->transitions_capacity, sizeof(rcl_lifecycle_transition_t), allocator);
   if (!new_transitions) {
     RCL_SET_ERROR_MSG("failed to reallocate memory for new transitions");
     return RCL_RET_BAD_ALLOC;
   }
   transition_map->transitions = new_transitions;
   // finally set the new transition to the end of the array
-  transition_map->transitions[transition_map->transitions_size - 1] = transition;
+  transition_map->transitions[transition_map->transitions_size] = transition;
+  transition_map->transitions_size += 1;
 
   // we have to copy the transitons here once more to the actual state
   // as we can't assign only the pointer. This pointer gets invalidated whenever
@@ -169,6 +212,160 @@ rcl_lifecycle_get_transitions(
   return NULL;
 }
 
+// Intern a label, return its index in the labels of the lookup or RCL_LIFECYCLE_LOOKUP_NONE
+static unsigned int
+_find_label(const rcl_lifecycle_transition_lookup_t * lookup, const char * label)
+{
+  // the labels of the default state machine are shared, compare the pointers first
+  for (unsigned int i = 0; i < lookup->labels_size; ++i) {
+    if (lookup->labels[i] == label) {
+      return i;
+    }
+  }
+  for (unsigned int i = 0; i < lookup->labels_size; ++i) {
+    if (strcmp(lookup->labels[i], label) == 0) {
+      return i;
+    }
+  }
+  return RCL_LIFECYCLE_LOOKUP_NONE;
+}
+
+rcl_ret_t
+rcl_lifecycle_transition_map_build_lookup(
+  rcl_lifecycle_transition_map_t * transition_map,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCL_RET_ERROR)
+
+  rcl_lifecycle_transition_lookup_t * lookup = &transition_map->lookup;
+  _lookup_fini(lookup, allocator);
+  memset(lookup->id_indices, RCL_LIFECYCLE_LOOKUP_NONE, sizeof(lookup->id_indices));
+
+  // intern the ids and the labels, the lookup is left unbuilt if they don't fit in its entries
+  lookup->labels = allocator->allocate(
+    transition_map->transitions_size * sizeof(const char *), allocator->state);
+  if (transition_map->transitions_size && !lookup->labels) {
+    RCL_SET_ERROR_MSG("failed to allocate memory for transition labels");
+    return RCL_RET_BAD_ALLOC;
+  }
+  for (unsigned int i = 0; i < transition_map->transitions_size; ++i) {
+    const rcl_lifecycle_transition_t * transition = &transition_map->transitions[i];
+    if (transition->id >= RCL_LIFECYCLE_LOOKUP_NONE) {
+      _lookup_fini(lookup, allocator);
+      return RCL_RET_OK;
+    }
+    if (lookup->id_indices[transition->id] == RCL_LIFECYCLE_LOOKUP_NONE) {
+      lookup->id_indices[transition->id] = (uint8_t)lookup->ids_size++;
+    }
+    if (_find_label(lookup, transition->label) == RCL_LIFECYCLE_LOOKUP_NONE) {
+      lookup->labels[lookup->labels_size++] = transition->label;
+    }
+  }
+  if (lookup->ids_size >= RCL_LIFECYCLE_LOOKUP_NONE ||
+    lookup->labels_size >= RCL_LIFECYCLE_LOOKUP_NONE)
+  {
+    _lookup_fini(lookup, allocator);
+    return RCL_RET_OK;
+  }
+
+  size_t by_id_size = transition_map->states_size * lookup->ids_size;
+  size_t by_label_size = transition_map->states_size * lookup->labels_size;
+  // one more byte so an empty map still has a lookup
+  lookup->by_id = allocator->allocate(by_id_size + 1, allocator->state);
+  lookup->by_label = allocator->allocate(by_label_size + 1, allocator->state);
+  if (!lookup->by_id || !lookup->by_label) {
+    _lookup_fini(lookup, allocator);
+    RCL_SET_ERROR_MSG("failed to allocate memory for transition lookup");
+    return RCL_RET_BAD_ALLOC;
+  }
+  memset(lookup->by_id, RCL_LIFECYCLE_LOOKUP_NONE, by_id_size);
+  memset(lookup->by_label, RCL_LIFECYCLE_LOOKUP_NONE, by_label_size);
+
+  for (unsigned int s = 0; s < transition_map->states_size; ++s) {
+    const rcl_lifecycle_state_t * state = &transition_map->states[s];
+    if (state->valid_transition_size >= RCL_LIFECYCLE_LOOKUP_NONE) {
+      _lookup_fini(lookup, allocator);
+      return RCL_RET_OK;
+    }
+    // the first valid transition with an id or a label is the one found by a scan
+    for (unsigned int t = state->valid_transition_size; t-- > 0; ) {
+      const rcl_lifecycle_transition_t * transition = &state->valid_transitions[t];
+      lookup->by_id[s * lookup->ids_size + lookup->id_indices[transition->id]] = (uint8_t)t;
+      lookup->by_label[s * lookup->labels_size + _find_label(lookup, transition->label)] =
+        (uint8_t)t;
+    }
+  }
+
+  return RCL_RET_OK;
+}
+
+// Index of a state of the map, or -1 if the state isn't in the map or there is no lookup
+static int
+_lookup_state_index(
+  const rcl_lifecycle_transition_map_t * transition_map,
+  const rcl_lifecycle_state_t * state)
+{
+  if (!transition_map->lookup.by_id || state < transition_map->states ||
+    state >= transition_map->states + transition_map->states_size)
+  {
+    return -1;
+  }
+  return (int)(state - transition_map->states);
+}
+
+const rcl_lifecycle_transition_t *
+rcl_lifecycle_transition_map_find_by_id(
+  const rcl_lifecycle_transition_map_t * transition_map,
+  const rcl_lifecycle_state_t * state,
+  unsigned int transition_id)
+{
+  RCL_CHECK_FOR_NULL_WITH_MSG(state, "state pointer is null", return NULL);
+  int state_index = _lookup_state_index(transition_map, state);
+  if (state_index < 0) {
+    for (unsigned int i = 0; i < state->valid_transition_size; ++i) {
+      if (state->valid_transitions[i].id == transition_id) {
+        return &state->valid_transitions[i];
+      }
+    }
+    return NULL;
+  }
+  const rcl_lifecycle_transition_lookup_t * lookup = &transition_map->lookup;
+  if (transition_id >= RCL_LIFECYCLE_LOOKUP_NONE ||
+    lookup->id_indices[transition_id] == RCL_LIFECYCLE_LOOKUP_NONE)
+  {
+    return NULL;
+  }
+  uint8_t t = lookup->by_id[state_index * lookup->ids_size + lookup->id_indices[transition_id]];
+  return t == RCL_LIFECYCLE_LOOKUP_NONE ? NULL : &state->valid_transitions[t];
+}
+
+const rcl_lifecycle_transition_t *
+rcl_lifecycle_transition_map_find_by_label(
+  const rcl_lifecycle_transition_map_t * transition_map,
+  const rcl_lifecycle_state_t * state,
+  const char * label)
+{
+  RCL_CHECK_FOR_NULL_WITH_MSG(state, "state pointer is null", return NULL);
+  RCL_CHECK_FOR_NULL_WITH_MSG(label, "label pointer is null", return NULL);
+  int state_index = _lookup_state_index(transition_map, state);
+  if (state_index < 0) {
+    for (unsigned int i = 0; i < state->valid_transition_size; ++i) {
+      if (strcmp(state->valid_transitions[i].label, label) == 0) {
+        return &state->valid_transitions[i];
+      }
+    }
+    return NULL;
+  }
+  const rcl_lifecycle_transition_lookup_t * lookup = &transition_map->lookup;
+  unsigned int label_index = _find_label(lookup, label);
+  if (label_index == RCL_LIFECYCLE_LOOKUP_NONE) {
+    return NULL;
+  }
+  uint8_t t = lookup->by_label[state_index * lookup->labels_size + label_index];
+  return t == RCL_LIFECYCLE_LOOKUP_NONE ? NULL : &state->valid_transitions[t];
+}
+
 #ifdef __cplusplus
 }
 #endif
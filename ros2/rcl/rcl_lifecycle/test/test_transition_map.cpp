@@ -93,3 +93,68 @@ TEST_F(TestTransitionMap, initialized) {
 
   EXPECT_EQ(RCL_RET_OK, rcl_lifecycle_transition_map_fini(&transition_map, &allocator));
 }
+
+TEST_F(TestTransitionMap, lookup) {
+  rcl_lifecycle_transition_map_t transition_map =
+    rcl_lifecycle_get_zero_initialized_transition_map();
+
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+
+  rcl_lifecycle_state_t state0 = {"my_state_0", 0, NULL, 0};
+  rcl_lifecycle_state_t state1 = {"my_state_1", 1, NULL, 0};
+  EXPECT_EQ(RCL_RET_OK, rcl_lifecycle_register_state(&transition_map, state0, &allocator));
+  EXPECT_EQ(RCL_RET_OK, rcl_lifecycle_register_state(&transition_map, state1, &allocator));
+  rcl_lifecycle_state_t * start_state = rcl_lifecycle_get_state(&transition_map, 0);
+  rcl_lifecycle_state_t * goal_state = rcl_lifecycle_get_state(&transition_map, 1);
+
+  rcl_lifecycle_transition_t transition01 = {"forward", 7, start_state, goal_state};
+  rcl_lifecycle_transition_t transition00 = {"stay", 9, start_state, start_state};
+  rcl_lifecycle_transition_t transition10 = {"back", 42, goal_state, start_state};
+  EXPECT_EQ(RCL_RET_OK,
+    rcl_lifecycle_register_transition(&transition_map, transition01, &allocator));
+  EXPECT_EQ(RCL_RET_OK,
+    rcl_lifecycle_register_transition(&transition_map, transition00, &allocator));
+  EXPECT_EQ(RCL_RET_OK,
+    rcl_lifecycle_register_transition(&transition_map, transition10, &allocator));
+  EXPECT_EQ(nullptr, transition_map.lookup.by_id);
+
+  // The same transitions are found with and without the lookup
+  for (int with_lookup = 0; with_lookup < 2; ++with_lookup) {
+    if (with_lookup) {
+      EXPECT_EQ(RCL_RET_OK, rcl_lifecycle_transition_map_build_lookup(&transition_map, &allocator));
+      ASSERT_NE(nullptr, transition_map.lookup.by_id);
+      EXPECT_EQ(3u, transition_map.lookup.ids_size);
+      EXPECT_EQ(3u, transition_map.lookup.labels_size);
+    }
+    EXPECT_EQ(&start_state->valid_transitions[0],
+      rcl_lifecycle_transition_map_find_by_id(&transition_map, start_state, 7));
+    EXPECT_EQ(&start_state->valid_transitions[1],
+      rcl_lifecycle_transition_map_find_by_id(&transition_map, start_state, 9));
+    EXPECT_EQ(nullptr, rcl_lifecycle_transition_map_find_by_id(&transition_map, start_state, 42));
+    EXPECT_EQ(nullptr, rcl_lifecycle_transition_map_find_by_id(&transition_map, start_state, 8));
+    EXPECT_EQ(nullptr, rcl_lifecycle_transition_map_find_by_id(&transition_map, start_state, 300));
+    EXPECT_EQ(&goal_state->valid_transitions[0],
+      rcl_lifecycle_transition_map_find_by_id(&transition_map, goal_state, 42));
+
+    EXPECT_EQ(&start_state->valid_transitions[1],
+      rcl_lifecycle_transition_map_find_by_label(&transition_map, start_state, "stay"));
+    // labels are compared by value, not only by pointer
+    char back[] = "back";
+    EXPECT_EQ(&goal_state->valid_transitions[0],
+      rcl_lifecycle_transition_map_find_by_label(&transition_map, goal_state, back));
+    EXPECT_EQ(nullptr,
+      rcl_lifecycle_transition_map_find_by_label(&transition_map, goal_state, "forward"));
+    EXPECT_EQ(nullptr,
+      rcl_lifecycle_transition_map_find_by_label(&transition_map, goal_state, "unknown"));
+  }
+
+  // Registering a transition discards the lookup
+  rcl_lifecycle_transition_t transition11 = {"stay", 9, goal_state, goal_state};
+  EXPECT_EQ(RCL_RET_OK,
+    rcl_lifecycle_register_transition(&transition_map, transition11, &allocator));
+  EXPECT_EQ(nullptr, transition_map.lookup.by_id);
+  EXPECT_EQ(&goal_state->valid_transitions[1],
+    rcl_lifecycle_transition_map_find_by_id(&transition_map, goal_state, 9));
+
+  EXPECT_EQ(RCL_RET_OK, rcl_lifecycle_transition_map_fini(&transition_map, &allocator));
+}
@@ -0,0 +1,62 @@
+// Copyright 2018 Apex.AI, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL_YAML_PARAM_PARSER__ARENA_H_
+#define RCL_YAML_PARAM_PARSER__ARENA_H_
+
+#include <stdlib.h>
+
+#include "rcl_yaml_param_parser/types.h"
+#include "rcl_yaml_param_parser/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// \typedef rcl_yaml_arena_t
+/// \brief Memory arena the parameter structure can be allocated from
+/// Memory is taken from large blocks and only released when the arena is finalized, which avoids
+/// one allocation per parameter name and value when parsing large files.
+typedef struct rcl_yaml_arena_s rcl_yaml_arena_t;
+
+/// \brief Init an arena
+/// \param[in] block_size size of the blocks taken from the allocator, 0 for the default size
+/// \param[in] allocator memory allocator used for the blocks
+/// \return a pointer to the arena on success or NULL on failure
+RCL_YAML_PARAM_PARSER_PUBLIC
+rcl_yaml_arena_t * rcl_yaml_arena_init(
+  size_t block_size,
+  const rcutils_allocator_t allocator);
+
+/// \brief Get an allocator allocating from the arena
+/// The returned allocator is meant to be given to rcl_yaml_node_struct_init(), its deallocate is
+/// a no-op. It must not be used after rcl_yaml_arena_fini() and is not thread safe.
+/// \param[in] arena points to an initialized arena
+/// \return the allocator
+RCL_YAML_PARAM_PARSER_PUBLIC
+rcutils_allocator_t rcl_yaml_arena_get_allocator(
+  rcl_yaml_arena_t * arena);
+
+/// \brief Free an arena and all the memory allocated from it
+/// \param[in] arena points to the arena
+RCL_YAML_PARAM_PARSER_PUBLIC
+void rcl_yaml_arena_fini(
+  rcl_yaml_arena_t * arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL_YAML_PARAM_PARSER__ARENA_H_
@@ -47,6 +47,19 @@ bool rcl_parse_yaml_file(
   const char * file_path,
   rcl_params_t * params_st);
 
+/// \brief Parse the YAML file through a binary cache, initialize and populate params_st
+/// The cache is read if it was generated from the current version of the YAML file, otherwise
+/// the YAML file is parsed and the cache regenerated. Failing to write the cache is not an error.
+/// \param[in] file_path is the path to the YAML file
+/// \param[in] cache_path is the path to the cache file, if NULL the YAML file is parsed
+/// \param[inout] params_st points to the populated paramter struct
+/// \return true on success and false on failure
+RCL_YAML_PARAM_PARSER_PUBLIC
+bool rcl_parse_yaml_file_cached(
+  const char * file_path,
+  const char * cache_path,
+  rcl_params_t * params_st);
+
 /// \brief Print the parameter structure to stdout
 /// \param[in] params_st points to the populated parameter struct
 RCL_YAML_PARAM_PARSER_PUBLIC
@@ -0,0 +1,194 @@
+// Copyright 2018 Apex.AI, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rcl_yaml_param_parser/arena.h"
+
+/// Default size of the blocks of an arena
+#define DEFAULT_BLOCK_SIZE (64U * 1024U)
+
+/// Every allocation is preceded by its size and aligned on this boundary
+#define ARENA_ALIGNMENT 16U
+
+#define ALIGN_UP(size) (((size) + (ARENA_ALIGNMENT - 1U)) & ~((size_t)ARENA_ALIGNMENT - 1U))
+
+typedef struct arena_block_s
+{
+  struct arena_block_s * next;
+  size_t size;
+  size_t used;
+  // Keeps the data following the block header aligned
+  size_t padding;
+} arena_block_t;
+
+struct rcl_yaml_arena_s
+{
+  arena_block_t * blocks;  ///< Current block first, then the full ones
+  size_t block_size;
+  rcutils_allocator_t allocator;
+};
+
+static uint8_t * block_data(arena_block_t * block)
+{
+  return (uint8_t *)block + ALIGN_UP(sizeof(arena_block_t));
+}
+
+static size_t * allocation_size(void * pointer)
+{
+  return (size_t *)((uint8_t *)pointer - ARENA_ALIGNMENT);
+}
+
+static arena_block_t * new_block(rcl_yaml_arena_t * arena, size_t size)
+{
+  arena_block_t * block = arena->allocator.allocate(
+    ALIGN_UP(sizeof(arena_block_t)) + size, arena->allocator.state);
+  if (NULL == block) {
+    return NULL;
+  }
+  block->next = NULL;
+  block->size = size;
+  block->used = 0U;
+  return block;
+}
+
+static void * arena_allocate(size_t size, void * state)
+{
+  rcl_yaml_arena_t * arena = (rcl_yaml_arena_t *)state;
+  const size_t needed = ARENA_ALIGNMENT + ALIGN_UP(size);
+  arena_block_t * block = arena->blocks;
+
+  if ((NULL == block) || ((block->size - block->used) < needed)) {
+    if (needed > (arena->block_size / 2U)) {
+      /// Large allocations get a block of their own, the current block stays in use
+      block = new_block(arena, needed);
+      if (NULL == block) {
+        return NULL;
+      }
+      if (NULL == arena->blocks) {
+        arena->blocks = block;
+      } else {
+        block->next = arena->blocks->next;
+        arena->blocks->next = block;
+      }
+    } else {
+      block = new_block(arena, arena->block_size);
+      if (NULL == block) {
+        return NULL;
+      }
+      block->next = arena->blocks;
+      arena->blocks = block;
+    }
+  }
+
+  uint8_t * pointer = block_data(block) + block->used + ARENA_ALIGNMENT;
+  block->used += needed;
+  *allocation_size(pointer) = size;
+  return pointer;
+}
+
+static void * arena_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  if ((0U != size_of_element) && (number_of_elements > (SIZE_MAX / size_of_element))) {
+    return NULL;
+  }
+  const size_t size = number_of_elements * size_of_element;
+  void * pointer = arena_allocate(size, state);
+  if (NULL != pointer) {
+    memset(pointer, 0, size);
+  }
+  return pointer;
+}
+
+static void arena_deallocate(void * pointer, void * state)
+{
+  /// Memory is released with the arena
+  (void)pointer;
+  (void)state;
+}
+
+static void * arena_reallocate(void * pointer, size_t size, void * state)
+{
+  rcl_yaml_arena_t * arena = (rcl_yaml_arena_t *)state;
+  if (NULL == pointer) {
+    return arena_allocate(size, state);
+  }
+
+  const size_t old_size = *allocation_size(pointer);
+  arena_block_t * block = arena->blocks;
+  uint8_t * end = (uint8_t *)pointer + ALIGN_UP(old_size);
+  /// The last allocation of the current block is grown in place
+  if ((NULL != block) && (end == (block_data(block) + block->used)) &&
+    ((ALIGN_UP(size) <= ALIGN_UP(old_size)) ||
+    ((ALIGN_UP(size) - ALIGN_UP(old_size)) <= (block->size - block->used))))
+  {
+    block->used = block->used - ALIGN_UP(old_size) + ALIGN_UP(size);
+    *allocation_size(pointer) = size;
+    return pointer;
+  }
+
+  void * new_pointer = arena_allocate(size, state);
+  if (NULL != new_pointer) {
+    memcpy(new_pointer, pointer, (old_size < size) ? old_size : size);
+  }
+  return new_pointer;
+}
+
+rcl_yaml_arena_t * rcl_yaml_arena_init(
+  size_t block_size,
+  const rcutils_allocator_t allocator)
+{
+  if (!rcutils_allocator_is_valid(&allocator)) {
+    return NULL;
+  }
+  rcl_yaml_arena_t * arena = allocator.allocate(sizeof(rcl_yaml_arena_t), allocator.state);
+  if (NULL == arena) {
+    return NULL;
+  }
+  arena->blocks = NULL;
+  arena->block_size = ALIGN_UP((0U == block_size) ? DEFAULT_BLOCK_SIZE : block_size);
+  arena->allocator = allocator;
+  return arena;
+}
+
+rcutils_allocator_t rcl_yaml_arena_get_allocator(
+  rcl_yaml_arena_t * arena)
+{
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+  if (NULL != arena) {
+    allocator.allocate = arena_allocate;
+    allocator.deallocate = arena_deallocate;
+    allocator.reallocate = arena_reallocate;
+    allocator.zero_allocate = arena_zero_allocate;
+    allocator.state = arena;
+  }
+  return allocator;
+}
+
+void rcl_yaml_arena_fini(
+  rcl_yaml_arena_t * arena)
+{
+  if (NULL == arena) {
+    return;
+  }
+  rcutils_allocator_t allocator = arena->allocator;
+  arena_block_t * block = arena->blocks;
+  while (NULL != block) {
+    arena_block_t * next = block->next;
+    allocator.deallocate(block, allocator.state);
+    block = next;
+  }
+  allocator.deallocate(arena, allocator.state);
+}
@@ -0,0 +1,638 @@
+// Copyright 2018 Apex.AI, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// The binary cache stores the nodes parsed from a YAML file along with the size and modification
+/// time of the file. All the values are in the byte order of the host which wrote the cache:
+///
+///   header: magic "RCLYAMLC", u32 version, u32 byte order mark, u64 YAML size,
+///           i64 YAML mtime seconds, i64 YAML mtime nanoseconds, u64 payload size, u64 num nodes,
+///           u64 payload checksum
+///   node:   string name, u64 num params, params
+///   param:  string name, u8 type, value
+///   string: u64 length, characters, '\0'
+///   arrays: u64 size, values (bools as u8, strings as strings)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+
+#include "rcl_yaml_param_parser/parser.h"
+#include "rcl_yaml_param_parser/types.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/snprintf.h"
+#include "rcutils/strdup.h"
+#include "./parser_impl.h"
+
+#define CACHE_MAGIC "RCLYAMLC"
+#define CACHE_MAGIC_SIZE 8U
+#define CACHE_VERSION 2U
+#define CACHE_BYTE_ORDER 0x01020304U
+
+typedef enum cache_value_type_e
+{
+  CACHE_TYPE_NONE = 0,
+  CACHE_TYPE_BOOL = 1,
+  CACHE_TYPE_INT = 2,
+  CACHE_TYPE_DOUBLE = 3,
+  CACHE_TYPE_STRING = 4,
+  CACHE_TYPE_BOOL_ARRAY = 5,
+  CACHE_TYPE_INT_ARRAY = 6,
+  CACHE_TYPE_DOUBLE_ARRAY = 7,
+  CACHE_TYPE_STRING_ARRAY = 8
+} cache_value_type_t;
+
+typedef struct cache_header_s
+{
+  char magic[CACHE_MAGIC_SIZE];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t yaml_size;
+  int64_t yaml_mtime_sec;
+  int64_t yaml_mtime_nsec;
+  uint64_t payload_size;
+  uint64_t num_nodes;
+  uint64_t payload_checksum;
+} cache_header_t;
+
+typedef struct cache_reader_s
+{
+  const uint8_t * data;
+  size_t size;
+  size_t offset;
+} cache_reader_t;
+
+typedef struct cache_writer_s
+{
+  uint8_t * data;
+  size_t size;
+  size_t capacity;
+  rcutils_allocator_t allocator;
+} cache_writer_t;
+
+///
+/// Get the size and modification time of the YAML file, they tell whether a cache is stale
+///
+static bool get_yaml_stamp(const char * file_path, cache_header_t * header)
+{
+  struct stat file_stat;
+  if (0 != stat(file_path, &file_stat)) {
+    return false;
+  }
+  memset(header, 0, sizeof(cache_header_t));
+  header->yaml_size = (uint64_t)file_stat.st_size;
+  header->yaml_mtime_sec = (int64_t)file_stat.st_mtime;
+#if defined(__APPLE__)
+  header->yaml_mtime_nsec = (int64_t)file_stat.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+  header->yaml_mtime_nsec = 0;
+#else
+  header->yaml_mtime_nsec = (int64_t)file_stat.st_mtim.tv_nsec;
+#endif
+  return true;
+}
+
+///
+/// FNV-1a over the 64 bit words of the payload, then over its last bytes.
+/// The decoder is bounds checked, the checksum catches the corruptions it cannot tell apart from
+/// valid data, e.g. a changed size or count.
+///
+static uint64_t get_checksum(const uint8_t * data, size_t size)
+{
+  const uint64_t prime = 0x100000001b3ULL;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  size_t offset = 0U;
+  for (; (size - offset) >= sizeof(uint64_t); offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + offset, sizeof(uint64_t));
+    hash = (hash ^ word) * prime;
+  }
+  for (; offset < size; ++offset) {
+    hash = (hash ^ data[offset]) * prime;
+  }
+  return hash;
+}
+
+///
+/// Bounds checked reads from the cache payload
+///
+static const uint8_t * read_bytes(cache_reader_t * reader, size_t size)
+{
+  if (size > (reader->size - reader->offset)) {
+    return NULL;
+  }
+  const uint8_t * bytes = reader->data + reader->offset;
+  reader->offset += size;
+  return bytes;
+}
+
+static bool read_u64(cache_reader_t * reader, uint64_t * value)
+{
+  const uint8_t * bytes = read_bytes(reader, sizeof(uint64_t));
+  if (NULL == bytes) {
+    return false;
+  }
+  memcpy(value, bytes, sizeof(uint64_t));
+  return true;
+}
+
+static char * read_string(cache_reader_t * reader, const rcutils_allocator_t allocator)
+{
+  uint64_t length;
+  if (!read_u64(reader, &length) || (length >= (reader->size - reader->offset))) {
+    return NULL;
+  }
+  const uint8_t * bytes = read_bytes(reader, (size_t)length + 1U);
+  if ((NULL == bytes) || ('\0' != bytes[length])) {
+    return NULL;
+  }
+  char * string = allocator.allocate((size_t)length + 1U, allocator.state);
+  if (NULL != string) {
+    memcpy(string, bytes, (size_t)length + 1U);
+  }
+  return string;
+}
+
+///
+/// Read the size of an array of elements of at least element_size bytes
+///
+static bool read_array_size(cache_reader_t * reader, size_t element_size, size_t * size)
+{
+  uint64_t value;
+  if (!read_u64(reader, &value) || (value > ((reader->size - reader->offset) / element_size))) {
+    return false;
+  }
+  *size = (size_t)value;
+  return true;
+}
+
+static void * read_array(
+  cache_reader_t * reader, size_t element_size, size_t size,
+  const rcutils_allocator_t allocator)
+{
+  const uint8_t * bytes = read_bytes(reader, size * element_size);
+  if (NULL == bytes) {
+    return NULL;
+  }
+  void * values = allocator.allocate((0U == size) ? 1U : size * element_size, allocator.state);
+  if ((NULL != values) && (0U != size)) {
+    memcpy(values, bytes, size * element_size);
+  }
+  return values;
+}
+
+///
+/// Read a parameter value, whatever was allocated is referenced by the variant
+///
+static bool read_value(
+  cache_reader_t * reader, rcl_variant_t * variant,
+  const rcutils_allocator_t allocator)
+{
+  const uint8_t * type = read_bytes(reader, 1U);
+  size_t size;
+  if (NULL == type) {
+    return false;
+  }
+
+  switch (*type) {
+    case CACHE_TYPE_NONE:
+      return true;
+    case CACHE_TYPE_BOOL:
+      {
+        const uint8_t * value = read_bytes(reader, 1U);
+        if (NULL == value) {
+          return false;
+        }
+        variant->bool_value = allocator.allocate(sizeof(bool), allocator.state);
+        if (NULL == variant->bool_value) {
+          return false;
+        }
+        *(variant->bool_value) = (0U != *value);
+        return true;
+      }
+    case CACHE_TYPE_INT:
+      variant->integer_value = read_array(reader, sizeof(int64_t), 1U, allocator);
+      return NULL != variant->integer_value;
+    case CACHE_TYPE_DOUBLE:
+      variant->double_value = read_array(reader, sizeof(double), 1U, allocator);
+      return NULL != variant->double_value;
+    case CACHE_TYPE_STRING:
+      variant->string_value = read_string(reader, allocator);
+      return NULL != variant->string_value;
+    case CACHE_TYPE_BOOL_ARRAY:
+      {
+        if (!read_array_size(reader, 1U, &size)) {
+          return false;
+        }
+        variant->bool_array_value = allocator.allocate(sizeof(rcl_bool_array_t), allocator.state);
+        if (NULL == variant->bool_array_value) {
+          return false;
+        }
+        variant->bool_array_value->size = 0U;
+        variant->bool_array_value->values =
+          allocator.allocate((0U == size) ? 1U : size * sizeof(bool), allocator.state);
+        const uint8_t * values = read_bytes(reader, size);
+        if ((NULL == variant->bool_array_value->values) || (NULL == values)) {
+          return false;
+        }
+        for (size_t i = 0U; i < size; ++i) {
+          variant->bool_array_value->values[i] = (0U != values[i]);
+        }
+        variant->bool_array_value->size = size;
+        return true;
+      }
+    case CACHE_TYPE_INT_ARRAY:
+      {
+        if (!read_array_size(reader, sizeof(int64_t), &size)) {
+          return false;
+        }
+        variant->integer_array_value =
+          allocator.allocate(sizeof(rcl_int64_array_t), allocator.state);
+        if (NULL == variant->integer_array_value) {
+          return false;
+        }
+        variant->integer_array_value->size = size;
+        variant->integer_array_value->values =
+          read_array(reader, sizeof(int64_t), size, allocator);
+        return NULL != variant->integer_array_value->values;
+      }
+    case CACHE_TYPE_DOUBLE_ARRAY:
+      {
+        if (!read_array_size(reader, sizeof(double), &size)) {
+          return false;
+        }
+        variant->double_array_value =
+          allocator.allocate(sizeof(rcl_double_array_t), allocator.state);
+        if (NULL == variant->double_array_value) {
+          return false;
+        }
+        variant->double_array_value->size = size;
+        variant->double_array_value->values =
+          read_array(reader, sizeof(double), size, allocator);
+        return NULL != variant->double_array_value->values;
+      }
+    case CACHE_TYPE_STRING_ARRAY:
+      {
+        if (!read_array_size(reader, sizeof(uint64_t) + 1U, &size)) {
+          return false;
+        }
+        variant->string_array_value =
+          allocator.zero_allocate(1U, sizeof(rcutils_string_array_t), allocator.state);
+        if (NULL == variant->string_array_value) {
+          return false;
+        }
+        if (RCUTILS_RET_OK != rcutils_string_array_init(
+            variant->string_array_value, size, &allocator))
+        {
+          rcutils_reset_error();
+          return false;
+        }
+        for (size_t i = 0U; i < size; ++i) {
+          variant->string_array_value->data[i] = read_string(reader, allocator);
+          if (NULL == variant->string_array_value->data[i]) {
+            return false;
+          }
+        }
+        return true;
+      }
+    default:
+      return false;
+  }
+}
+
+///
+/// Read the nodes of a cache into an empty parameter structure
+///
+static bool read_nodes(cache_reader_t * reader, uint64_t num_nodes, rcl_params_t * params_st)
+{
+  const rcutils_allocator_t allocator = params_st->allocator;
+  if (num_nodes > MAX_NUM_NODE_ENTRIES) {
+    return false;
+  }
+
+  for (uint64_t node_idx = 0U; node_idx < num_nodes; ++node_idx) {
+    rcl_node_params_t * node_params = &(params_st->params[node_idx]);
+    size_t num_params;
+
+    params_st->node_names[node_idx] = read_string(reader, allocator);
+    params_st->num_nodes++;
+    /// A parameter is at least its name length, name terminator and type
+    if ((NULL == params_st->node_names[node_idx]) ||
+      !read_array_size(reader, sizeof(uint64_t) + 2U, &num_params))
+    {
+      return false;
+    }
+    node_params->parameter_names = allocator.zero_allocate(
+      (0U == num_params) ? 1U : num_params, sizeof(char *), allocator.state);
+    node_params->parameter_values = allocator.zero_allocate(
+      (0U == num_params) ? 1U : num_params, sizeof(rcl_variant_t), allocator.state);
+    if ((NULL == node_params->parameter_names) || (NULL == node_params->parameter_values)) {
+      return false;
+    }
+    for (size_t parameter_idx = 0U; parameter_idx < num_params; ++parameter_idx) {
+      node_params->num_params++;
+      node_params->parameter_names[parameter_idx] = read_string(reader, allocator);
+      if ((NULL == node_params->parameter_names[parameter_idx]) ||
+        !read_value(reader, &(node_params->parameter_values[parameter_idx]), allocator))
+      {
+        return false;
+      }
+    }
+  }
+  return reader->offset == reader->size;
+}
+
+///
+/// Map the cache file and decode it, if it matches the YAML file
+///
+static bool load_cache(
+  const char * cache_path, const cache_header_t * stamp,
+  rcl_params_t * params_st)
+{
+  uint8_t * data = NULL;
+  size_t size = 0U;
+  bool loaded = false;
+
+#ifndef _WIN32
+  int fd = open(cache_path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat cache_stat;
+  if ((0 == fstat(fd, &cache_stat)) && ((size_t)cache_stat.st_size >= sizeof(cache_header_t))) {
+    size = (size_t)cache_stat.st_size;
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == data) {
+      data = NULL;
+    }
+  }
+  close(fd);
+#else
+  const rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  FILE * cache_file = fopen(cache_path, "rb");
+  if (NULL == cache_file) {
+    return false;
+  }
+  if ((0 == fseek(cache_file, 0, SEEK_END)) && (ftell(cache_file) >= (long)sizeof(cache_header_t))) {
+    size = (size_t)ftell(cache_file);
+    rewind(cache_file);
+    data = allocator.allocate(size, allocator.state);
+    if ((NULL != data) && (size != fread(data, 1U, size, cache_file))) {
+      allocator.deallocate(data, allocator.state);
+      data = NULL;
+    }
+  }
+  fclose(cache_file);
+#endif
+  if (NULL == data) {
+    return false;
+  }
+
+  cache_header_t header;
+  memcpy(&header, data, sizeof(cache_header_t));
+  if ((0 == memcmp(header.magic, CACHE_MAGIC, CACHE_MAGIC_SIZE)) &&
+    (CACHE_VERSION == header.version) &&
+    (CACHE_BYTE_ORDER == header.byte_order) &&
+    (stamp->yaml_size == header.yaml_size) &&
+    (stamp->yaml_mtime_sec == header.yaml_mtime_sec) &&
+    (stamp->yaml_mtime_nsec == header.yaml_mtime_nsec) &&
+    (header.payload_size == (size - sizeof(cache_header_t))) &&
+    (header.payload_checksum ==
+    get_checksum(data + sizeof(cache_header_t), size - sizeof(cache_header_t))))
+  {
+    cache_reader_t reader = {data + sizeof(cache_header_t), size - sizeof(cache_header_t), 0U};
+    loaded = read_nodes(&reader, header.num_nodes, params_st);
+  }
+
+#ifndef _WIN32
+  munmap(data, size);
+#else
+  allocator.deallocate(data, allocator.state);
+#endif
+  return loaded;
+}
+
+///
+/// Append bytes to the cache being written
+///
+static bool write_bytes(cache_writer_t * writer, const void * bytes, size_t size)
+{
+  if (size > (writer->capacity - writer->size)) {
+    size_t capacity = (0U == writer->capacity) ? 4096U : writer->capacity;
+    while (size > (capacity - writer->size)) {
+      capacity *= 2U;
+    }
+    uint8_t * data = writer->allocator.reallocate(writer->data, capacity, writer->allocator.state);
+    if (NULL == data) {
+      return false;
+    }
+    writer->data = data;
+    writer->capacity = capacity;
+  }
+  if (0U != size) {
+    memcpy(writer->data + writer->size, bytes, size);
+  }
+  writer->size += size;
+  return true;
+}
+
+static bool write_u64(cache_writer_t * writer, uint64_t value)
+{
+  return write_bytes(writer, &value, sizeof(uint64_t));
+}
+
+static bool write_type(cache_writer_t * writer, cache_value_type_t type)
+{
+  const uint8_t tag = (uint8_t)type;
+  return write_bytes(writer, &tag, 1U);
+}
+
+static bool write_string(cache_writer_t * writer, const char * string)
+{
+  const size_t length = strlen(string);
+  return write_u64(writer, length) && write_bytes(writer, string, length + 1U);
+}
+
+static bool write_value(cache_writer_t * writer, const rcl_variant_t * variant)
+{
+  if (NULL != variant->bool_value) {
+    const uint8_t value = *(variant->bool_value) ? 1U : 0U;
+    return write_type(writer, CACHE_TYPE_BOOL) && write_bytes(writer, &value, 1U);
+  } else if (NULL != variant->integer_value) {
+    return write_type(writer, CACHE_TYPE_INT) &&
+           write_bytes(writer, variant->integer_value, sizeof(int64_t));
+  } else if (NULL != variant->double_value) {
+    return write_type(writer, CACHE_TYPE_DOUBLE) &&
+           write_bytes(writer, variant->double_value, sizeof(double));
+  } else if (NULL != variant->string_value) {
+    return write_type(writer, CACHE_TYPE_STRING) && write_string(writer, variant->string_value);
+  } else if (NULL != variant->bool_array_value) {
+    const rcl_bool_array_t * array = variant->bool_array_value;
+    if (!write_type(writer, CACHE_TYPE_BOOL_ARRAY) || !write_u64(writer, array->size)) {
+      return false;
+    }
+    for (size_t i = 0U; i < array->size; ++i) {
+      const uint8_t value = array->values[i] ? 1U : 0U;
+      if (!write_bytes(writer, &value, 1U)) {
+        return false;
+      }
+    }
+    return true;
+  } else if (NULL != variant->integer_array_value) {
+    const rcl_int64_array_t * array = variant->integer_array_value;
+    return write_type(writer, CACHE_TYPE_INT_ARRAY) && write_u64(writer, array->size) &&
+           write_bytes(writer, array->values, array->size * sizeof(int64_t));
+  } else if (NULL != variant->double_array_value) {
+    const rcl_double_array_t * array = variant->double_array_value;
+    return write_type(writer, CACHE_TYPE_DOUBLE_ARRAY) && write_u64(writer, array->size) &&
+           write_bytes(writer, array->values, array->size * sizeof(double));
+  } else if (NULL != variant->string_array_value) {
+    const rcutils_string_array_t * array = variant->string_array_value;
+    if (!write_type(writer, CACHE_TYPE_STRING_ARRAY) || !write_u64(writer, array->size)) {
+      return false;
+    }
+    for (size_t i = 0U; i < array->size; ++i) {
+      if (!write_string(writer, array->data[i])) {
+        return false;
+      }
+    }
+    return true;
+  } else if (NULL != variant->byte_array_value) {
+    /// Not produced by the parser
+    return false;
+  }
+  return write_type(writer, CACHE_TYPE_NONE);
+}
+
+///
+/// Write the nodes starting at first_node to the cache, through a temporary file so that a
+/// concurrent reader never sees a partial cache
+///
+static bool save_cache(
+  const char * cache_path, const cache_header_t * stamp,
+  const rcl_params_t * params_st, size_t first_node)
+{
+  /// The buffers are temporary, they are not taken from the allocator of the parameters
+  const rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  cache_writer_t writer = {NULL, 0U, 0U, allocator};
+  cache_header_t header = *stamp;
+  bool saved = write_bytes(&writer, &header, sizeof(cache_header_t));
+
+  for (size_t node_idx = first_node; saved && (node_idx < params_st->num_nodes); ++node_idx) {
+    const rcl_node_params_t * node_params = &(params_st->params[node_idx]);
+    saved = write_string(&writer, params_st->node_names[node_idx]) &&
+      write_u64(&writer, node_params->num_params);
+    for (size_t parameter_idx = 0U; saved && (parameter_idx < node_params->num_params);
+      ++parameter_idx)
+    {
+      saved = write_string(&writer, node_params->parameter_names[parameter_idx]) &&
+        write_value(&writer, &(node_params->parameter_values[parameter_idx]));
+    }
+  }
+
+  if (saved) {
+    memcpy(header.magic, CACHE_MAGIC, CACHE_MAGIC_SIZE);
+    header.version = CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER;
+    header.payload_size = writer.size - sizeof(cache_header_t);
+    header.num_nodes = params_st->num_nodes - first_node;
+    header.payload_checksum =
+      get_checksum(writer.data + sizeof(cache_header_t), header.payload_size);
+    memcpy(writer.data, &header, sizeof(cache_header_t));
+
+    const size_t tmp_path_size = strlen(cache_path) + 32U;
+    char * tmp_path = allocator.allocate(tmp_path_size, allocator.state);
+    saved = (NULL != tmp_path);
+    if (saved) {
+#ifndef _WIN32
+      const long pid = (long)getpid();
+#else
+      const long pid = (long)_getpid();
+#endif
+      saved = (0 < rcutils_snprintf(tmp_path, tmp_path_size, "%s.tmp%ld", cache_path, pid));
+      FILE * cache_file = saved ? fopen(tmp_path, "wb") : NULL;
+      saved = (NULL != cache_file);
+      if (saved) {
+        saved = (writer.size == fwrite(writer.data, 1U, writer.size, cache_file));
+        saved = (0 == fclose(cache_file)) && saved;
+      }
+#ifdef _WIN32
+      /// rename() does not replace an existing file on Windows
+      if (saved) {
+        remove(cache_path);
+      }
+#endif
+      if (saved) {
+        saved = (0 == rename(tmp_path, cache_path));
+      }
+      if (!saved) {
+        remove(tmp_path);
+      }
+      allocator.deallocate(tmp_path, allocator.state);
+    }
+  }
+  allocator.deallocate(writer.data, allocator.state);
+  return saved;
+}
+
+bool rcl_parse_yaml_file_cached(
+  const char * file_path,
+  const char * cache_path,
+  rcl_params_t * params_st)
+{
+  cache_header_t stamp;
+
+  if ((NULL == params_st) || (NULL == file_path)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Pass a initialized paramter structure and a file path");
+    return false;
+  }
+  if ((NULL == cache_path) || !get_yaml_stamp(file_path, &stamp)) {
+    return rcl_parse_yaml_file(file_path, params_st);
+  }
+
+  rcl_params_t * cached_st = rcl_yaml_node_struct_init(params_st->allocator);
+  if (NULL == cached_st) {
+    return false;
+  }
+  bool loaded = load_cache(cache_path, &stamp, cached_st);
+  if (loaded && ((params_st->num_nodes + cached_st->num_nodes) <= MAX_NUM_NODE_ENTRIES)) {
+    /// Move the cached nodes over, the cached structure is left empty
+    for (size_t node_idx = 0U; node_idx < cached_st->num_nodes; ++node_idx) {
+      params_st->node_names[params_st->num_nodes] = cached_st->node_names[node_idx];
+      params_st->params[params_st->num_nodes] = cached_st->params[node_idx];
+      params_st->num_nodes++;
+    }
+    cached_st->num_nodes = 0U;
+    rcl_yaml_node_struct_fini(cached_st);
+    return true;
+  }
+  rcl_yaml_node_struct_fini(cached_st);
+
+  const size_t first_node = params_st->num_nodes;
+  if (!rcl_parse_yaml_file(file_path, params_st)) {
+    return false;
+  }
+  /// The cache is an optimization, failing to write it is not an error
+  (void)save_cache(cache_path, &stamp, params_st, first_node);
+  return true;
+}
@@ -27,6 +27,8 @@
 #include "rcl/types.h"
 #include "rcutils/strdup.h"
 
+#include "./parser_impl.h"
+
 /// NOTE: Will allow a max YAML mapping depth of 5
 /// map level 1 : Node name mapping
 /// map level 2 : Params mapping
@@ -54,44 +56,57 @@ typedef enum namespace_type_e
 } namespace_type_t;
 
 /// Keep track of node and parameter name spaces
+/// The names are built in place, the namespaces are at most MAX_STRING_SIZE long
 typedef struct namespace_tracker_s
 {
-  char * node_ns;
+  char node_ns[MAX_STRING_SIZE + 1U];
   uint32_t num_node_ns;
-  char * parameter_ns;
+  char parameter_ns[MAX_STRING_SIZE + 1U];
   uint32_t num_parameter_ns;
 } namespace_tracker_t;
 
-#define MAX_STRING_SIZE 128U
+/// Capacities of the arrays being filled by the parser
+/// The arrays grow geometrically so that appending to them is amortized constant time
+typedef struct parse_state_s
+{
+  size_t params_capacity;  ///< Capacity of the names and values of the current node
+  size_t seq_capacity;  ///< Capacity of the values of the current sequence
+} parse_state_t;
+
+/// Value of a scalar, as converted by get_value
+typedef union scalar_value_u
+{
+  bool bool_value;
+  int64_t integer_value;
+  double double_value;
+} scalar_value_t;
+
 #define PARAMS_KEY "ros__parameters"
 #define NODE_NS_SEPERATOR "/"
 #define PARAMETER_NS_SEPERATOR "."
 
-#define MAX_NUM_NODE_ENTRIES 256U
-#define MAX_NUM_PARAMS_PER_NODE 512U
+#define INITIAL_SEQ_CAPACITY 8U
 
 static rcl_ret_t node_params_init(
   rcl_node_params_t * node_params,
   const rcl_allocator_t allocator);
 
-static rcl_ret_t add_val_to_bool_arr(
-  rcl_bool_array_t * const val_array,
-  bool * value,
-  const rcl_allocator_t allocator);
-
-static rcl_ret_t add_val_to_int_arr(
-  rcl_int64_array_t * const val_array,
-  int64_t * value,
+static rcl_ret_t node_params_grow(
+  rcl_node_params_t * node_params,
+  size_t * capacity,
   const rcl_allocator_t allocator);
 
-static rcl_ret_t add_val_to_double_arr(
-  rcl_double_array_t * const val_array,
-  double * value,
+static rcl_ret_t reserve_value(
+  void ** values,
+  const size_t size,
+  size_t * capacity,
+  const size_t value_size,
   const rcl_allocator_t allocator);
 
 static rcl_ret_t add_val_to_string_arr(
   rcutils_string_array_t * const val_array,
   char * value,
+  size_t * capacity,
   const rcl_allocator_t allocator);
 
 ///
@@ -101,30 +116,27 @@ static rcl_ret_t add_val_to_string_arr(
 static rcl_ret_t add_name_to_ns(
   namespace_tracker_t * ns_tracker,
   const char * name,
-  const namespace_type_t namespace_type,
-  rcl_allocator_t allocator);
+  const namespace_type_t namespace_type);
 
 static rcl_ret_t rem_name_from_ns(
   namespace_tracker_t * ns_tracker,
-  const namespace_type_t namespace_type,
-  rcl_allocator_t allocator);
+  const namespace_type_t namespace_type);
 
 static rcl_ret_t replace_ns(
   namespace_tracker_t * ns_tracker,
-  char * const new_ns,
+  const char * const new_ns,
   const uint32_t new_ns_count,
-  const namespace_type_t namespace_type,
-  rcl_allocator_t allocator);
+  const namespace_type_t namespace_type);
 
-static void * get_value(
+static data_types_t get_value(
   const char * const value,
-  data_types_t * val_type,
-  const rcl_allocator_t allocator);
+  scalar_value_t * scalar);
 
 static rcl_ret_t parse_value(
   const yaml_event_t event,
   const bool is_seq,
   data_types_t * seq_data_type,
+  parse_state_t * state,
   rcl_params_t * params_st);
 
 static rcl_ret_t parse_key(
@@ -132,11 +144,13 @@ static rcl_ret_t parse_key(
   uint32_t * map_level,
   bool * is_new_map,
   namespace_tracker_t * ns_tracker,
+  parse_state_t * state,
   rcl_params_t * params_st);
 
 static rcl_ret_t parse_events(
   yaml_parser_t * parser,
   namespace_tracker_t * ns_tracker,
+  parse_state_t * state,
   rcl_params_t * params_st);
 
 ///
@@ -145,8 +159,7 @@ static rcl_ret_t parse_events(
 static rcl_ret_t add_name_to_ns(
   namespace_tracker_t * ns_tracker,
   const char * name,
-  const namespace_type_t namespace_type,
-  rcl_allocator_t allocator)
+  const namespace_type_t namespace_type)
 {
   char * cur_ns;
   uint32_t * cur_count;
@@ -178,14 +191,12 @@ static rcl_ret_t add_name_to_ns(
     if (NULL == name) {
       return RCL_RET_INVALID_ARGUMENT;
     }
+    name_len = strlen(name);
     if (0U == *cur_count) {
-      cur_ns = rcutils_strdup(name, allocator);
-      if (NULL == cur_ns) {
-        return RCL_RET_BAD_ALLOC;
-      }
+      ns_len = 0U;
+      sep_len = 0U;
     } else {
       ns_len = strlen(cur_ns);
-      name_len = strlen(name);
       sep_len = strlen(sep_str);
       // Check the last sep_len characters of the current NS against the separator string.
       if (strcmp(cur_ns + ns_len - sep_len, sep_str) == 0) {
@@ -193,28 +204,21 @@ static rcl_ret_t add_name_to_ns(
         sep_len = 0;
         sep_str = "";
       }
+    }
 
-      tot_len = ns_len + sep_len + name_len + 1U;
+    tot_len = ns_len + sep_len + name_len + 1U;
 
-      if (tot_len > MAX_STRING_SIZE) {
-        RCL_SET_ERROR_MSG("New namespace string is exceeding max string size");
-        return RCL_RET_ERROR;
-      }
-      cur_ns = allocator.reallocate(cur_ns, tot_len, allocator.state);
-      if (NULL == cur_ns) {
-        return RCL_RET_BAD_ALLOC;
-      }
-      memmove((cur_ns + ns_len), sep_str, sep_len);
-      memmove((cur_ns + ns_len + sep_len), name, name_len);
-      cur_ns[tot_len - 1U] = '\0';
+    /// The first name may use the whole buffer, as for the keys
+    if (((0U == *cur_count) && (name_len > MAX_STRING_SIZE)) ||
+      ((0U != *cur_count) && (tot_len > MAX_STRING_SIZE)))
+    {
+      RCL_SET_ERROR_MSG("New namespace string is exceeding max string size");
+      return RCL_RET_ERROR;
     }
+    memcpy((cur_ns + ns_len), sep_str, sep_len);
+    memcpy((cur_ns + ns_len + sep_len), name, name_len);
+    cur_ns[tot_len - 1U] = '\0';
     *cur_count = (*cur_count + 1U);
-
-    if (NS_TYPE_NODE == namespace_type) {
-      ns_tracker->node_ns = cur_ns;
-    } else {
-      ns_tracker->parameter_ns = cur_ns;
-    }
   }
   return res;
 }
@@ -224,14 +228,11 @@ static rcl_ret_t add_name_to_ns(
 ///
 static rcl_ret_t rem_name_from_ns(
   namespace_tracker_t * ns_tracker,
-  const namespace_type_t namespace_type,
-  rcl_allocator_t allocator)
+  const namespace_type_t namespace_type)
 {
   char * cur_ns;
   uint32_t * cur_count;
   char * sep_str;
-  size_t ns_len;
-  size_t tot_len;
   rcl_ret_t res = RCL_RET_OK;
 
   switch (namespace_type) {
@@ -251,43 +252,23 @@ static rcl_ret_t rem_name_from_ns(
   }
 
   if (RCL_RET_OK == res) {
-    /// Remove last name from ns
+    /// Remove last name from ns, the string is truncated in place
     if (*cur_count > 0U) {
       if (1U == *cur_count) {
-        allocator.deallocate(cur_ns, allocator.state);
-        cur_ns = NULL;
+        cur_ns[0U] = '\0';
       } else {
-        ns_len = strlen(cur_ns);
         char * last_idx = NULL;
-        char * next_str = NULL;
-        const char * end_ptr = (cur_ns + ns_len);
-
-        next_str = strstr(cur_ns, sep_str);
+        char * next_str = strstr(cur_ns, sep_str);
         while (NULL != next_str) {
-          if (next_str > end_ptr) {
-            RCL_SET_ERROR_MSG("Internal error. Crossing arrau boundary");
-            return RCL_RET_ERROR;
-          }
           last_idx = next_str;
-          next_str = (next_str + strlen(sep_str));
-          next_str = strstr(next_str, sep_str);
+          next_str = strstr(next_str + strlen(sep_str), sep_str);
         }
         if (NULL != last_idx) {
-          tot_len = ((size_t)(last_idx - cur_ns) + 1U);
-          cur_ns = allocator.reallocate(cur_ns, tot_len, allocator.state);
-          if (NULL == cur_ns) {
-            return RCL_RET_BAD_ALLOC;
-          }
-          cur_ns[tot_len - 1U] = '\0';
+          *last_idx = '\0';
         }
       }
       *cur_count = (*cur_count - 1U);
     }
-    if (NS_TYPE_NODE == namespace_type) {
-      ns_tracker->node_ns = cur_ns;
-    } else {
-      ns_tracker->parameter_ns = cur_ns;
-    }
   }
   return res;
 }
@@ -297,33 +278,36 @@ static rcl_ret_t rem_name_from_ns(
 ///
 static rcl_ret_t replace_ns(
   namespace_tracker_t * ns_tracker,
-  char * const new_ns,
+  const char * const new_ns,
   const uint32_t new_ns_count,
-  const namespace_type_t namespace_type,
-  rcl_allocator_t allocator)
+  const namespace_type_t namespace_type)
 {
   rcl_ret_t res = RCL_RET_OK;
+  char * cur_ns;
+  const size_t new_ns_len = strlen(new_ns);
+
+  if (new_ns_len > MAX_STRING_SIZE) {
+    RCL_SET_ERROR_MSG("New namespace string is exceeding max string size");
+    return RCL_RET_ERROR;
+  }
 
-  /// Remove the old namespace and point to the new namespace
+  /// Copy the new namespace over the old one
   switch (namespace_type) {
     case NS_TYPE_NODE:
-      if (NULL != ns_tracker->node_ns) {
-        allocator.deallocate(ns_tracker->node_ns, allocator.state);
-      }
-      ns_tracker->node_ns = new_ns;
+      cur_ns = ns_tracker->node_ns;
       ns_tracker->num_node_ns = new_ns_count;
       break;
     case NS_TYPE_PARAM:
-      if (NULL != ns_tracker->parameter_ns) {
-        allocator.deallocate(ns_tracker->parameter_ns, allocator.state);
-      }
-      ns_tracker->parameter_ns = new_ns;
+      cur_ns = ns_tracker->parameter_ns;
       ns_tracker->num_parameter_ns = new_ns_count;
       break;
     default:
       res = RCL_RET_ERROR;
       break;
   }
+  if (RCL_RET_OK == res) {
+    memcpy(cur_ns, new_ns, new_ns_len + 1U);
+  }
   return res;
 }
 
@@ -338,13 +322,13 @@ static rcl_ret_t node_params_init(
     return RCL_RET_INVALID_ARGUMENT;
   }
 
-  node_params->parameter_names = allocator.zero_allocate(MAX_NUM_PARAMS_PER_NODE,
+  node_params->parameter_names = allocator.zero_allocate(INITIAL_NUM_PARAMS_PER_NODE,
       sizeof(char *), allocator.state);
   if (NULL == node_params->parameter_names) {
     return RCL_RET_BAD_ALLOC;
   }
 
-  node_params->parameter_values = allocator.zero_allocate(MAX_NUM_PARAMS_PER_NODE,
+  node_params->parameter_values = allocator.zero_allocate(INITIAL_NUM_PARAMS_PER_NODE,
       sizeof(rcl_variant_t), allocator.state);
   if (NULL == node_params->parameter_values) {
     allocator.deallocate(node_params->parameter_names, allocator.state);
@@ -354,6 +338,38 @@ static rcl_ret_t node_params_init(
   return RCL_RET_OK;
 }
 
+///
+/// Double the capacity of the parameter arrays of a node, the new entries are zeroed
+///
+static rcl_ret_t node_params_grow(
+  rcl_node_params_t * node_params,
+  size_t * capacity,
+  const rcl_allocator_t allocator)
+{
+  const size_t new_capacity = 2U * (*capacity);
+  char ** names;
+  rcl_variant_t * values;
+
+  names = allocator.reallocate(node_params->parameter_names,
+      new_capacity * sizeof(char *), allocator.state);
+  if (NULL == names) {
+    return RCL_RET_BAD_ALLOC;
+  }
+  node_params->parameter_names = names;
+  memset(names + *capacity, 0, (new_capacity - *capacity) * sizeof(char *));
+
+  values = allocator.reallocate(node_params->parameter_values,
+      new_capacity * sizeof(rcl_variant_t), allocator.state);
+  if (NULL == values) {
+    return RCL_RET_BAD_ALLOC;
+  }
+  node_params->parameter_values = values;
+  memset(values + *capacity, 0, (new_capacity - *capacity) * sizeof(rcl_variant_t));
+
+  *capacity = new_capacity;
+  return RCL_RET_OK;
+}
+
 ///
 /// Create the rcl_params_t parameter structure
 ///
@@ -571,101 +587,35 @@ void rcl_yaml_node_struct_print(
 }
 
 ///
-/// Add a value to a bool array. Create the array if it does not exist
+/// Make room for one more value at the end of an array of values
+/// The capacity is doubled when the array is full, so that filling an array is linear
 ///
-static rcl_ret_t add_val_to_bool_arr(
-  rcl_bool_array_t * const val_array,
-  bool * value,
+static rcl_ret_t reserve_value(
+  void ** values,
+  const size_t size,
+  size_t * capacity,
+  const size_t value_size,
   const rcl_allocator_t allocator)
 {
-  if ((NULL == value) || (NULL == val_array)) {
-    return RCL_RET_INVALID_ARGUMENT;
-  }
+  void * new_values;
+  size_t new_capacity;
 
-  if (NULL == val_array->values) {
-    val_array->values = value;
-    val_array->size++;
-  } else {
-    /// Increase the array size by one and add the new value
-    bool * tmp_arr = val_array->values;
-    val_array->values = allocator.zero_allocate(val_array->size + 1U, sizeof(bool),
-        allocator.state);
-    if (NULL == val_array->values) {
-      RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
-      return RCL_RET_BAD_ALLOC;
-    }
-    memmove(val_array->values, tmp_arr, (val_array->size * sizeof(bool)));
-    val_array->values[val_array->size] = *value;
-    val_array->size++;
-    allocator.deallocate(value, allocator.state);
-    allocator.deallocate(tmp_arr, allocator.state);
+  if ((NULL != *values) && (size < *capacity)) {
+    return RCL_RET_OK;
   }
-  return RCL_RET_OK;
-}
 
-///
-/// Add a value to an integer array. Create the array if it does not exist
-///
-static rcl_ret_t add_val_to_int_arr(
-  rcl_int64_array_t * const val_array,
-  int64_t * value,
-  const rcl_allocator_t allocator)
-{
-  if ((NULL == value) || (NULL == val_array)) {
-    return RCL_RET_INVALID_ARGUMENT;
-  }
-
-  if (NULL == val_array->values) {
-    val_array->values = value;
-    val_array->size++;
+  new_capacity = (0U == *capacity) ? INITIAL_SEQ_CAPACITY : (2U * (*capacity));
+  if (NULL == *values) {
+    new_values = allocator.allocate(new_capacity * value_size, allocator.state);
   } else {
-    /// Increase the array size by one and add the new value
-    int64_t * tmp_arr = val_array->values;
-    val_array->values = allocator.zero_allocate(val_array->size + 1U, sizeof(int64_t),
-        allocator.state);
-    if (NULL == val_array->values) {
-      RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
-      return RCL_RET_BAD_ALLOC;
-    }
-    memmove(val_array->values, tmp_arr, (val_array->size * sizeof(int64_t)));
-    val_array->values[val_array->size] = *value;
-    val_array->size++;
-    allocator.deallocate(value, allocator.state);
-    allocator.deallocate(tmp_arr, allocator.state);
+    new_values = allocator.reallocate(*values, new_capacity * value_size, allocator.state);
   }
-  return RCL_RET_OK;
-}
-
-///
-/// Add a value to a double array. Create the array if it does not exist
-///
-static rcl_ret_t add_val_to_double_arr(
-  rcl_double_array_t * const val_array,
-  double * value,
-  const rcl_allocator_t allocator)
-{
-  if ((NULL == value) || (NULL == val_array)) {
-    return RCL_RET_INVALID_ARGUMENT;
-  }
-
-  if (NULL == val_array->values) {
-    val_array->values = value;
-    val_array->size++;
-  } else {
-    /// Increase the array size by one and add the new value
-    double * tmp_arr = val_array->values;
-    val_array->values = allocator.zero_allocate(val_array->size + 1U, sizeof(double),
-        allocator.state);
-    if (NULL == val_array->values) {
-      RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
-      return RCL_RET_BAD_ALLOC;
-    }
-    memmove(val_array->values, tmp_arr, (val_array->size * sizeof(double)));
-    val_array->values[val_array->size] = *value;
-    val_array->size++;
-    allocator.deallocate(value, allocator.state);
-    allocator.deallocate(tmp_arr, allocator.state);
+  if (NULL == new_values) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
+    return RCL_RET_BAD_ALLOC;
   }
+  *values = new_values;
+  *capacity = new_capacity;
   return RCL_RET_OK;
 }
 
@@ -675,6 +625,7 @@ static rcl_ret_t add_val_to_double_arr(
 static rcl_ret_t add_val_to_string_arr(
   rcutils_string_array_t * const val_array,
   char * value,
+  size_t * capacity,
   const rcl_allocator_t allocator)
 {
   if ((NULL == value) || (NULL == val_array)) {
@@ -689,14 +640,14 @@ static rcl_ret_t add_val_to_string_arr(
       return res;
     }
     val_array->data[0U] = value;
+    *capacity = 1U;
   } else {
-    /// Increase the array size by one and add the new value
-    val_array->data = allocator.reallocate(val_array->data,
-        ((val_array->size + 1U) * sizeof(char *)), allocator.state);
-    if (NULL == val_array->data) {
-      RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
-      return RCL_RET_BAD_ALLOC;
+    void * data = val_array->data;
+    rcl_ret_t res = reserve_value(&data, val_array->size, capacity, sizeof(char *), allocator);
+    if (RCL_RET_OK != res) {
+      return res;
     }
+    val_array->data = data;
     val_array->data[val_array->size] = value;
     val_array->size++;
   }
@@ -704,22 +655,21 @@ static rcl_ret_t add_val_to_string_arr(
 }
 
 ///
-/// Determine the type of the value and return the converted value
+/// Determine the type of the value and convert it
+/// Strings are not converted, the caller copies the value
 /// NOTE: Only canonical forms supported as of now
 ///
-static void * get_value(
+static data_types_t get_value(
   const char * const value,
-  data_types_t * val_type,
-  const rcl_allocator_t allocator)
+  scalar_value_t * scalar)
 {
-  void * ret_val;
   int64_t ival;
   double dval;
   char * endptr = NULL;
 
-  if ((NULL == value) || (NULL == val_type)) {
+  if ((NULL == value) || (NULL == scalar)) {
     RCL_SET_ERROR_MSG("Invalid arguments");
-    return NULL;
+    return DATA_TYPE_UNKNOWN;
   }
 
   /// Check if it is bool
@@ -735,13 +685,8 @@ static void * get_value(
     (0 == strncmp(value, "On", strlen(value))) ||
     (0 == strncmp(value, "ON", strlen(value))))
   {
-    *val_type = DATA_TYPE_BOOL;
-    ret_val = allocator.zero_allocate(1U, sizeof(bool), allocator.state);
-    if (NULL == ret_val) {
-      return NULL;
-    }
-    *((bool *)ret_val) = true;
-    return ret_val;
+    scalar->bool_value = true;
+    return DATA_TYPE_BOOL;
   }
 
   if ((0 == strncmp(value, "N", strlen(value))) ||
@@ -756,13 +701,8 @@ static void * get_value(
     (0 == strncmp(value, "Off", strlen(value))) ||
     (0 == strncmp(value, "OFF", strlen(value))))
   {
-    *val_type = DATA_TYPE_BOOL;
-    ret_val = allocator.zero_allocate(1U, sizeof(bool), allocator.state);
-    if (NULL == ret_val) {
-      return NULL;
-    }
-    *((bool *)ret_val) = false;
-    return ret_val;
+    scalar->bool_value = false;
+    return DATA_TYPE_BOOL;
   }
 
   /// Check for int
@@ -771,13 +711,8 @@ static void * get_value(
   if ((0 == errno) && (NULL != endptr)) {
     if ((NULL != endptr) && (endptr != value)) {
       if (('\0' != *value) && ('\0' == *endptr)) {
-        *val_type = DATA_TYPE_INT64;
-        ret_val = allocator.zero_allocate(1U, sizeof(int64_t), allocator.state);
-        if (NULL == ret_val) {
-          return NULL;
-        }
-        *((int64_t *)ret_val) = ival;
-        return ret_val;
+        scalar->integer_value = ival;
+        return DATA_TYPE_INT64;
       }
     }
   }
@@ -789,22 +724,30 @@ static void * get_value(
   if ((0 == errno) && (NULL != endptr)) {
     if ((NULL != endptr) && (endptr != value)) {
       if (('\0' != *value) && ('\0' == *endptr)) {
-        *val_type = DATA_TYPE_DOUBLE;
-        ret_val = allocator.zero_allocate(1U, sizeof(double), allocator.state);
-        if (NULL == ret_val) {
-          return NULL;
-        }
-        *((double *)ret_val) = dval;
-        return ret_val;
+        scalar->double_value = dval;
+        return DATA_TYPE_DOUBLE;
       }
     }
   }
   errno = 0;
 
   /// It is a string
-  *val_type = DATA_TYPE_STRING;
-  ret_val = rcutils_strdup(value, allocator);
-  return ret_val;
+  return DATA_TYPE_STRING;
+}
+
+///
+/// Copy a converted scalar into a newly allocated value
+///
+static void * copy_value(
+  const void * value,
+  const size_t value_size,
+  const rcl_allocator_t allocator)
+{
+  void * copy = allocator.allocate(value_size, allocator.state);
+  if (NULL != copy) {
+    memcpy(copy, value, value_size);
+  }
+  return copy;
 }
 
 ///
@@ -814,14 +757,17 @@ static rcl_ret_t parse_value(
   const yaml_event_t event,
   const bool is_seq,
   data_types_t * seq_data_type,
+  parse_state_t * state,
   rcl_params_t * params_st)
 {
-  void * ret_val;
   data_types_t val_type;
+  scalar_value_t scalar;
   int res = RCL_RET_OK;
   rcl_allocator_t allocator;
 
-  if ((NULL == params_st) || (0U == params_st->num_nodes) || (NULL == seq_data_type)) {
+  if ((NULL == params_st) || (0U == params_st->num_nodes) || (NULL == seq_data_type) ||
+    (NULL == state))
+  {
     return RCL_RET_INVALID_ARGUMENT;
   }
   allocator = params_st->allocator;
@@ -859,139 +805,133 @@ static rcl_ret_t parse_value(
 
   param_value = &(params_st->params[node_idx].parameter_values[parameter_idx]);
 
-  // param_value->string_value = rcutils_strdup(value, allocator);
-  ret_val = get_value(value, &val_type, allocator);
-  if (NULL == ret_val) {
-    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("Error parsing value %s at line %d", value, line_num);
-    return RCL_RET_ERROR;
+  val_type = get_value(value, &scalar);
+
+  if (false == is_seq) {
+    /// A single value is allocated on its own
+    void * ret_val = NULL;
+    switch (val_type) {
+      case DATA_TYPE_BOOL:
+        ret_val = copy_value(&scalar.bool_value, sizeof(bool), allocator);
+        param_value->bool_value = (bool *)ret_val;
+        break;
+      case DATA_TYPE_INT64:
+        ret_val = copy_value(&scalar.integer_value, sizeof(int64_t), allocator);
+        param_value->integer_value = (int64_t *)ret_val;
+        break;
+      case DATA_TYPE_DOUBLE:
+        ret_val = copy_value(&scalar.double_value, sizeof(double), allocator);
+        param_value->double_value = (double *)ret_val;
+        break;
+      case DATA_TYPE_STRING:
+        ret_val = rcutils_strdup(value, allocator);
+        param_value->string_value = (char *)ret_val;
+        break;
+      default:
+        RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+          "Unknown data type of value %s at line %d", value, line_num);
+        return RCL_RET_ERROR;
+    }
+    if (NULL == ret_val) {
+      RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("Error parsing value %s at line %d", value, line_num);
+      return RCL_RET_ERROR;
+    }
+    return RCL_RET_OK;
   }
 
-  switch (val_type) {
-    case DATA_TYPE_UNKNOWN:
+  /// The values of a sequence are appended to an array of the type of its first value
+  if (DATA_TYPE_UNKNOWN == *seq_data_type) {
+    void * val_array = NULL;
+    switch (val_type) {
+      case DATA_TYPE_BOOL:
+        val_array = allocator.zero_allocate(1U, sizeof(rcl_bool_array_t), allocator.state);
+        param_value->bool_array_value = (rcl_bool_array_t *)val_array;
+        break;
+      case DATA_TYPE_INT64:
+        val_array = allocator.zero_allocate(1U, sizeof(rcl_int64_array_t), allocator.state);
+        param_value->integer_array_value = (rcl_int64_array_t *)val_array;
+        break;
+      case DATA_TYPE_DOUBLE:
+        val_array = allocator.zero_allocate(1U, sizeof(rcl_double_array_t), allocator.state);
+        param_value->double_array_value = (rcl_double_array_t *)val_array;
+        break;
+      case DATA_TYPE_STRING:
+        val_array = allocator.zero_allocate(1U, sizeof(rcutils_string_array_t), allocator.state);
+        param_value->string_array_value = (rcutils_string_array_t *)val_array;
+        break;
+      default:
+        RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+          "Unknown data type of value %s at line %d", value, line_num);
+        return RCL_RET_ERROR;
+    }
+    if (NULL == val_array) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
+      return RCL_RET_BAD_ALLOC;
+    }
+    *seq_data_type = val_type;
+    state->seq_capacity = 0U;
+  } else {
+    if (*seq_data_type != val_type) {
+      const char * type_name =
+        (DATA_TYPE_BOOL == val_type) ? "bool" :
+        (DATA_TYPE_INT64 == val_type) ? "integer" :
+        (DATA_TYPE_DOUBLE == val_type) ? "double" : "string";
       RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
-        "Unknown data type of value %s at line %d\n", value, line_num);
-      res = RCL_RET_ERROR;
-      break;
+        "Sequence should be of same type. Value type '%s' do not belong at line_num %d",
+        type_name, line_num);
+      return RCL_RET_ERROR;
+    }
+  }
+
+  switch (val_type) {
     case DATA_TYPE_BOOL:
-      if (false == is_seq) {
-        param_value->bool_value = (bool *)ret_val;
-      } else {
-        if (DATA_TYPE_UNKNOWN == *seq_data_type) {
-          *seq_data_type = val_type;
-          param_value->bool_array_value =
-            allocator.zero_allocate(1U, sizeof(rcl_bool_array_t), allocator.state);
-          if (NULL == param_value->bool_array_value) {
-            RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
-            return RCL_RET_BAD_ALLOC;
-          }
-        } else {
-          if (*seq_data_type != val_type) {
-            RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
-              "Sequence should be of same type. Value type 'bool' do not belong at line_num %d",
-              line_num);
-            allocator.deallocate(ret_val, allocator.state);
-            return RCL_RET_ERROR;
-          }
-        }
-        res = add_val_to_bool_arr(param_value->bool_array_value, ret_val, allocator);
-        if (RCL_RET_OK != res) {
-          if (NULL != ret_val) {
-            allocator.deallocate(ret_val, allocator.state);
-          }
-          return res;
+      {
+        rcl_bool_array_t * val_array = param_value->bool_array_value;
+        void * values = val_array->values;
+        res = reserve_value(&values, val_array->size, &(state->seq_capacity), sizeof(bool),
+            allocator);
+        if (RCL_RET_OK == res) {
+          val_array->values = values;
+          val_array->values[val_array->size++] = scalar.bool_value;
         }
       }
       break;
     case DATA_TYPE_INT64:
-      if (false == is_seq) {
-        param_value->integer_value = (int64_t *)ret_val;
-      } else {
-        if (DATA_TYPE_UNKNOWN == *seq_data_type) {
-          *seq_data_type = val_type;
-          param_value->integer_array_value =
-            allocator.zero_allocate(1U, sizeof(rcl_int64_array_t), allocator.state);
-          if (NULL == param_value->integer_array_value) {
-            RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
-            return RCL_RET_BAD_ALLOC;
-          }
-        } else {
-          if (*seq_data_type != val_type) {
-            RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
-              "Sequence should be of same type. Value type 'integer' do not belong at line_num %d",
-              line_num);
-            allocator.deallocate(ret_val, allocator.state);
-            return RCL_RET_ERROR;
-          }
-        }
-        res = add_val_to_int_arr(param_value->integer_array_value, ret_val, allocator);
-        if (RCL_RET_OK != res) {
-          if (NULL != ret_val) {
-            allocator.deallocate(ret_val, allocator.state);
-          }
-          return res;
+      {
+        rcl_int64_array_t * val_array = param_value->integer_array_value;
+        void * values = val_array->values;
+        res = reserve_value(&values, val_array->size, &(state->seq_capacity), sizeof(int64_t),
+            allocator);
+        if (RCL_RET_OK == res) {
+          val_array->values = values;
+          val_array->values[val_array->size++] = scalar.integer_value;
         }
       }
       break;
     case DATA_TYPE_DOUBLE:
-      if (false == is_seq) {
-        param_value->double_value = (double *)ret_val;
-      } else {
-        if (DATA_TYPE_UNKNOWN == *seq_data_type) {
-          *seq_data_type = val_type;
-          param_value->double_array_value =
-            allocator.zero_allocate(1U, sizeof(rcl_double_array_t), allocator.state);
-          if (NULL == param_value->double_array_value) {
-            RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
-            return RCL_RET_BAD_ALLOC;
-          }
-        } else {
-          if (*seq_data_type != val_type) {
-            RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
-              "Sequence should be of same type. Value type 'double' do not belong at line_num %d",
-              line_num);
-            allocator.deallocate(ret_val, allocator.state);
-            return RCL_RET_ERROR;
-          }
-        }
-        res = add_val_to_double_arr(param_value->double_array_value, ret_val, allocator);
-        if (RCL_RET_OK != res) {
-          if (NULL != ret_val) {
-            allocator.deallocate(ret_val, allocator.state);
-          }
-          return res;
+      {
+        rcl_double_array_t * val_array = param_value->double_array_value;
+        void * values = val_array->values;
+        res = reserve_value(&values, val_array->size, &(state->seq_capacity), sizeof(double),
+            allocator);
+        if (RCL_RET_OK == res) {
+          val_array->values = values;
+          val_array->values[val_array->size++] = scalar.double_value;
         }
       }
       break;
     case DATA_TYPE_STRING:
-      if (false == is_seq) {
-        param_value->string_value = (char *)ret_val;
-      } else {
-        if (DATA_TYPE_UNKNOWN == *seq_data_type) {
-          *seq_data_type = val_type;
-          param_value->string_array_value =
-            allocator.zero_allocate(1U, sizeof(rcutils_string_array_t), allocator.state);
-          if (NULL == param_value->string_array_value) {
-            RCUTILS_SAFE_FWRITE_TO_STDERR("Error allocating mem");
-            if (NULL != ret_val) {
-              allocator.deallocate(ret_val, allocator.state);
-            }
-            return RCL_RET_BAD_ALLOC;
-          }
-        } else {
-          if (*seq_data_type != val_type) {
-            RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
-              "Sequence should be of same type. Value type 'string' do not belong at line_num %d",
-              line_num);
-            allocator.deallocate(ret_val, allocator.state);
-            return RCL_RET_ERROR;
-          }
+      {
+        char * string_value = rcutils_strdup(value, allocator);
+        if (NULL == string_value) {
+          RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+            "Error parsing value %s at line %d", value, line_num);
+          return RCL_RET_ERROR;
         }
-        res = add_val_to_string_arr(param_value->string_array_value, ret_val, allocator);
+        res = add_val_to_string_arr(param_value->string_array_value, string_value,
+            &(state->seq_capacity), allocator);
         if (RCL_RET_OK != res) {
-          if (NULL != ret_val) {
-            allocator.deallocate(ret_val, allocator.state);
-          }
-          return res;
+          allocator.deallocate(string_value, allocator.state);
         }
       }
       break;
@@ -1012,6 +952,7 @@ static rcl_ret_t parse_key(
   uint32_t * map_level,
   bool * is_new_map,
   namespace_tracker_t * ns_tracker,
+  parse_state_t * state,
   rcl_params_t * params_st)
 {
   int32_t res = RCL_RET_OK;
@@ -1022,7 +963,7 @@ static rcl_ret_t parse_key(
   size_t node_idx = 0U;
   rcl_allocator_t allocator;
 
-  if ((NULL == map_level) || (NULL == params_st)) {
+  if ((NULL == map_level) || (NULL == params_st) || (NULL == state)) {
     return RCL_RET_INVALID_ARGUMENT;
   }
   allocator = params_st->allocator;
@@ -1056,7 +997,7 @@ static rcl_ret_t parse_key(
       {
         /// Till we get PARAMS_KEY, keep adding to node namespace
         if (0 != strncmp(PARAMS_KEY, value, strlen(PARAMS_KEY))) {
-          res = add_name_to_ns(ns_tracker, value, NS_TYPE_NODE, allocator);
+          res = add_name_to_ns(ns_tracker, value, NS_TYPE_NODE);
           if (RCL_RET_OK != res) {
             RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
               "Internal error adding node namespace at line %d", line_num);
@@ -1068,6 +1009,11 @@ static rcl_ret_t parse_key(
               "There are no node names before %s at line %d", PARAMS_KEY, line_num);
             return RCL_RET_ERROR;
           }
+          if (num_nodes >= MAX_NUM_NODE_ENTRIES) {
+            RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+              "There are more than %d nodes at line %d", MAX_NUM_NODE_ENTRIES, line_num);
+            return RCL_RET_ERROR;
+          }
           /// The previous key(last name in namespace) was the node name. Remove it
           /// from the namespace
           char * node_name_ns = rcutils_strdup(ns_tracker->node_ns, allocator);
@@ -1076,7 +1022,7 @@ static rcl_ret_t parse_key(
           }
           params_st->node_names[num_nodes] = node_name_ns;
 
-          res = rem_name_from_ns(ns_tracker, NS_TYPE_NODE, allocator);
+          res = rem_name_from_ns(ns_tracker, NS_TYPE_NODE);
           if (RCL_RET_OK != res) {
             RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
               "Internal error adding node namespace at line %d", line_num);
@@ -1088,6 +1034,7 @@ static rcl_ret_t parse_key(
               "Error creating node parameter at line %d", line_num);
             return RCL_RET_ERROR;
           }
+          state->params_capacity = INITIAL_NUM_PARAMS_PER_NODE;
           params_st->num_nodes++;
           /// Bump the map level to PARAMS
           (*map_level)++;
@@ -1111,7 +1058,10 @@ static rcl_ret_t parse_key(
             return RCL_RET_ERROR;
           }
           res = replace_ns(ns_tracker, parameter_ns, (ns_tracker->num_parameter_ns + 1U),
-              NS_TYPE_PARAM, allocator);
+              NS_TYPE_PARAM);
+          /// The name of the namespace was copied, its entry is reused by the next parameter
+          allocator.deallocate(parameter_ns, allocator.state);
+          params_st->params[node_idx].parameter_names[parameter_idx] = NULL;
           if (RCL_RET_OK != res) {
             RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
               "Internal error replacing namespace at line %d", line_num);
@@ -1121,8 +1071,17 @@ static rcl_ret_t parse_key(
         }
         /// Add a parameter name into the node parameters
         parameter_idx = params_st->params[node_idx].num_params;
+        if (parameter_idx >= state->params_capacity) {
+          res = node_params_grow(&(params_st->params[node_idx]), &(state->params_capacity),
+              allocator);
+          if (RCL_RET_OK != res) {
+            RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+              "Error allocating node parameters at line %d", line_num);
+            return res;
+          }
+        }
         parameter_ns = ns_tracker->parameter_ns;
-        if (NULL == parameter_ns) {
+        if (0U == ns_tracker->num_parameter_ns) {
           param_name = rcutils_strdup(value, allocator);
           if (NULL == param_name) {
             return RCL_RET_BAD_ALLOC;
@@ -1166,6 +1125,7 @@ static rcl_ret_t parse_key(
 static rcl_ret_t parse_events(
   yaml_parser_t * parser,
   namespace_tracker_t * ns_tracker,
+  parse_state_t * state,
   rcl_params_t * params_st)
 {
   int32_t done_parsing = 0;
@@ -1178,12 +1138,10 @@ static rcl_ret_t parse_events(
   uint32_t map_level = 1U;
   uint32_t map_depth = 0U;
   bool is_new_map = false;
-  rcl_allocator_t allocator;
 
-  if ((NULL == parser) || (NULL == params_st)) {
+  if ((NULL == parser) || (NULL == params_st) || (NULL == state)) {
     return RCL_RET_INVALID_ARGUMENT;
   }
-  allocator = params_st->allocator;
 
   while (0 == done_parsing) {
     if (RCL_RET_OK != res) {
@@ -1206,7 +1164,7 @@ static rcl_ret_t parse_events(
         {
           /// Need to toggle between key and value at params level
           if (true == is_key) {
-            res = parse_key(event, &map_level, &is_new_map, ns_tracker,
+            res = parse_key(event, &map_level, &is_new_map, ns_tracker, state,
                 params_st);
             if (RCL_RET_OK != res) {
               yaml_event_delete(&event);
@@ -1221,7 +1179,7 @@ static rcl_ret_t parse_events(
               yaml_event_delete(&event);
               return RCL_RET_ERROR;
             }
-            res = parse_value(event, is_seq, &seq_data_type, params_st);
+            res = parse_value(event, is_seq, &seq_data_type, state, params_st);
             if (RCL_RET_OK != res) {
               yaml_event_delete(&event);
               return res;
@@ -1270,7 +1228,7 @@ static rcl_ret_t parse_events(
         if (MAP_PARAMS_LVL == map_level) {
           if (ns_tracker->num_parameter_ns > 0U) {
             /// Remove param namesapce
-            res = rem_name_from_ns(ns_tracker, NS_TYPE_PARAM, allocator);
+            res = rem_name_from_ns(ns_tracker, NS_TYPE_PARAM);
             if (RCL_RET_OK != res) {
               RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
                 "Internal error removing parameter namespace at line %d", line_num);
@@ -1285,7 +1243,7 @@ static rcl_ret_t parse_events(
             (map_depth == (ns_tracker->num_node_ns + 1U)))
           {
             /// Remove node namespace
-            res = rem_name_from_ns(ns_tracker, NS_TYPE_NODE, allocator);
+            res = rem_name_from_ns(ns_tracker, NS_TYPE_NODE);
             if (RCL_RET_OK != res) {
               RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
                 "Internal error removing node namespace at line %d", line_num);
@@ -1343,13 +1301,12 @@ bool rcl_parse_yaml_file(
   FILE * yaml_file;
   yaml_parser_t parser;
   namespace_tracker_t ns_tracker;
-  rcutils_allocator_t allocator;
+  parse_state_t state;
 
   if (NULL == params_st) {
     RCUTILS_SAFE_FWRITE_TO_STDERR("Pass a initialized paramter structure");
     return false;
   }
-  allocator = params_st->allocator;
 
   if (NULL == file_path) {
     RCL_SET_ERROR_MSG("YAML file path is NULL");
@@ -1372,18 +1329,13 @@ bool rcl_parse_yaml_file(
   yaml_parser_set_input_file(&parser, yaml_file);
 
   memset(&ns_tracker, 0, sizeof(namespace_tracker_t));
-  res = parse_events(&parser, &ns_tracker, params_st);
+  memset(&state, 0, sizeof(parse_state_t));
+  res = parse_events(&parser, &ns_tracker, &state, params_st);
 
   yaml_parser_delete(&parser);
   fclose(yaml_file);
 
   if (RCL_RET_OK != res) {
-    if (NULL != ns_tracker.node_ns) {
-      allocator.deallocate(ns_tracker.node_ns, allocator.state);
-    }
-    if (NULL != ns_tracker.parameter_ns) {
-      allocator.deallocate(ns_tracker.parameter_ns, allocator.state);
-    }
     rcl_yaml_node_struct_fini(params_st);
     return false;
   }
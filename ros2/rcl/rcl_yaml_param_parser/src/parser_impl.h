@@ -0,0 +1,36 @@
+// Copyright 2018 Apex.AI, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PARSER_IMPL_H_
+#define PARSER_IMPL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Maximum length of the keys, values and names
+#define MAX_STRING_SIZE 128U
+
+/// Size of the node arrays allocated by rcl_yaml_node_struct_init()
+#define MAX_NUM_NODE_ENTRIES 256U
+
+/// Initial size of the parameter arrays of a node, they grow as parameters are added
+#define INITIAL_NUM_PARAMS_PER_NODE 64U
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // PARSER_IMPL_H_
@@ -0,0 +1,139 @@
+// Copyright 2018 Apex.AI, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the parsing of a large parameter file, as for nodes loading maps and lookup tables:
+// with the default allocator, with an arena, and through the binary cache when it has to be
+// generated and when it is up to date.
+//
+// Usage: benchmark_parse_yaml [size in MB] [iterations]
+
+#include <stdio.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+#include "rcl_yaml_param_parser/arena.h"
+#include "rcl_yaml_param_parser/parser.h"
+
+#include "rcutils/allocator.h"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const char * yaml_path = "benchmark_parse_yaml.yaml";
+const char * cache_path = "benchmark_parse_yaml.cache";
+
+// Write nodes holding scalar parameters and tables until the file has the requested size
+size_t write_yaml_file(size_t size)
+{
+  FILE * yaml_file = fopen(yaml_path, "w");
+  if (NULL == yaml_file) {
+    return 0U;
+  }
+  size_t num_params = 0U;
+  for (size_t node = 0U; (static_cast<size_t>(ftell(yaml_file)) < size) && (node < 200U); ++node) {
+    fprintf(yaml_file, "map_ns/node_%zu:\n  ros__parameters:\n", node);
+    for (size_t i = 0U; i < 400U; ++i) {
+      if (0U == (i % 20U)) {
+        fprintf(yaml_file, "    layer_%zu:\n", i / 20U);
+      }
+      fprintf(yaml_file, "      cell_%zu: %zu.25\n", i % 20U, i);
+    }
+    for (size_t table = 0U; table < 8U; ++table) {
+      std::string values;
+      for (size_t i = 0U; i < 500U; ++i) {
+        values += (0U == i ? "" : ", ") + std::to_string(node * i + table);
+      }
+      fprintf(yaml_file, "    table_%zu: [%s]\n", table, values.c_str());
+    }
+    fprintf(yaml_file, "    frame: map_%zu\n    enabled: true\n", node);
+    num_params += 410U;
+  }
+  fclose(yaml_file);
+  return num_params;
+}
+
+bool parse(rcutils_allocator_t allocator, const char * cache)
+{
+  rcl_params_t * params_st = rcl_yaml_node_struct_init(allocator);
+  if (NULL == params_st) {
+    return false;
+  }
+  bool res = (NULL == cache) ?
+    rcl_parse_yaml_file(yaml_path, params_st) :
+    rcl_parse_yaml_file_cached(yaml_path, cache, params_st);
+  rcl_yaml_node_struct_fini(params_st);
+  return res;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t size_mb = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5;
+  size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+  if (size_mb == 0 || iterations == 0) {
+    fprintf(stderr, "Usage: %s [size in MB] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  size_t num_params = write_yaml_file(size_mb * 1024U * 1024U);
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  double yaml = 0.0;
+  double arena = 0.0;
+  double cold = 0.0;
+  double warm = 0.0;
+  bool res = true;
+  for (size_t i = 0; res && (i < iterations); ++i) {
+    auto start = Clock::now();
+    res = parse(allocator, NULL);
+    yaml += ms_since(start);
+
+    start = Clock::now();
+    rcl_yaml_arena_t * yaml_arena = rcl_yaml_arena_init(1024U * 1024U, allocator);
+    res = res && (NULL != yaml_arena) && parse(rcl_yaml_arena_get_allocator(yaml_arena), NULL);
+    rcl_yaml_arena_fini(yaml_arena);
+    arena += ms_since(start);
+
+    remove(cache_path);
+    start = Clock::now();
+    res = res && parse(allocator, cache_path);
+    cold += ms_since(start);
+
+    start = Clock::now();
+    res = res && parse(allocator, cache_path);
+    warm += ms_since(start);
+  }
+  remove(yaml_path);
+  remove(cache_path);
+  if (!res) {
+    fprintf(stderr, "failed to parse the parameter file\n");
+    return 1;
+  }
+
+  printf("%zu parameters in %zu MB (ms per iteration)\n", num_params, size_mb);
+  printf("%-32s %10.3f\n", "parse", yaml / iterations);
+  printf("%-32s %10.3f\n", "parse with an arena", arena / iterations);
+  printf("%-32s %10.3f\n", "parse and write the cache", cold / iterations);
+  printf("%-32s %10.3f\n", "read the cache", warm / iterations);
+  return 0;
+}
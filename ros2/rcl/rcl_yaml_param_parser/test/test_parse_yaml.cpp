@@ -15,6 +15,10 @@
 #include <stdio.h>
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
+#include "rcl_yaml_param_parser/arena.h"
 #include "rcl_yaml_param_parser/parser.h"
 
 #include "rcutils/allocator.h"
@@ -24,6 +28,88 @@
 static char cur_dir[1024];
 rcutils_allocator_t allocator = rcutils_get_default_allocator();
 
+template<typename ArrayT>
+static void expect_array_eq(const ArrayT * expected, const ArrayT * actual)
+{
+  ASSERT_EQ(NULL == expected, NULL == actual);
+  if (NULL != expected) {
+    ASSERT_EQ(expected->size, actual->size);
+    for (size_t i = 0U; i < expected->size; ++i) {
+      EXPECT_EQ(expected->values[i], actual->values[i]);
+    }
+  }
+}
+
+template<typename T>
+static void expect_value_eq(const T * expected, const T * actual)
+{
+  ASSERT_EQ(NULL == expected, NULL == actual);
+  if (NULL != expected) {
+    EXPECT_EQ(*expected, *actual);
+  }
+}
+
+static void expect_params_eq(const rcl_params_t * expected, const rcl_params_t * actual)
+{
+  ASSERT_EQ(expected->num_nodes, actual->num_nodes);
+  for (size_t node_idx = 0U; node_idx < expected->num_nodes; ++node_idx) {
+    EXPECT_STREQ(expected->node_names[node_idx], actual->node_names[node_idx]);
+    const rcl_node_params_t * expected_node = &(expected->params[node_idx]);
+    const rcl_node_params_t * actual_node = &(actual->params[node_idx]);
+    ASSERT_EQ(expected_node->num_params, actual_node->num_params);
+    for (size_t parameter_idx = 0U; parameter_idx < expected_node->num_params; ++parameter_idx) {
+      EXPECT_STREQ(
+        expected_node->parameter_names[parameter_idx],
+        actual_node->parameter_names[parameter_idx]);
+      const rcl_variant_t * expected_var = &(expected_node->parameter_values[parameter_idx]);
+      const rcl_variant_t * actual_var = &(actual_node->parameter_values[parameter_idx]);
+      expect_value_eq(expected_var->bool_value, actual_var->bool_value);
+      expect_value_eq(expected_var->integer_value, actual_var->integer_value);
+      expect_value_eq(expected_var->double_value, actual_var->double_value);
+      ASSERT_EQ(NULL == expected_var->string_value, NULL == actual_var->string_value);
+      if (NULL != expected_var->string_value) {
+        EXPECT_STREQ(expected_var->string_value, actual_var->string_value);
+      }
+      expect_array_eq(expected_var->bool_array_value, actual_var->bool_array_value);
+      expect_array_eq(expected_var->integer_array_value, actual_var->integer_array_value);
+      expect_array_eq(expected_var->double_array_value, actual_var->double_array_value);
+      ASSERT_EQ(NULL == expected_var->string_array_value, NULL == actual_var->string_array_value);
+      if (NULL != expected_var->string_array_value) {
+        ASSERT_EQ(expected_var->string_array_value->size, actual_var->string_array_value->size);
+        for (size_t i = 0U; i < expected_var->string_array_value->size; ++i) {
+          EXPECT_STREQ(
+            expected_var->string_array_value->data[i], actual_var->string_array_value->data[i]);
+        }
+      }
+    }
+  }
+}
+
+/// Write a file with more parameters per node and longer sequences than the initial sizes
+static void write_large_yaml(const char * path, size_t num_params, size_t seq_size)
+{
+  FILE * yaml_file = fopen(path, "w");
+  ASSERT_FALSE(NULL == yaml_file);
+  for (const char * node_name : {"large_ns/node1", "large_ns/node2"}) {
+    fprintf(yaml_file, "%s:\n  ros__parameters:\n", node_name);
+    for (size_t i = 0U; i < num_params; ++i) {
+      if (0U == (i % 10U)) {
+        fprintf(yaml_file, "    group_%zu:\n", i / 10U);
+      }
+      fprintf(yaml_file, "      param_%zu: %zu.5\n", i % 10U, i);
+    }
+    std::string ints, strings;
+    for (size_t i = 0U; i < seq_size; ++i) {
+      ints += (0U == i ? "" : ", ") + std::to_string(i);
+      strings += (0U == i ? "" : ", ") + std::string("str_") + std::to_string(i);
+    }
+    fprintf(yaml_file, "    table: [%s]\n", ints.c_str());
+    fprintf(yaml_file, "    names: [%s]\n", strings.c_str());
+    fprintf(yaml_file, "    enabled: true\n");
+  }
+  fclose(yaml_file);
+}
+
 TEST(test_file_parser, correct_syntax) {
   rcutils_reset_error();
   EXPECT_TRUE(rcutils_get_cwd(cur_dir, 1024));
@@ -206,6 +292,213 @@ TEST(test_file_parser, indented_ns) {
   allocator.deallocate(path, allocator.state);
 }
 
+TEST(test_file_parser, large_file) {
+  rcutils_reset_error();
+  const char * path = "test_parse_yaml_large.yaml";
+  write_large_yaml(path, 1000U, 5000U);
+  rcl_params_t * params_hdl = rcl_yaml_node_struct_init(allocator);
+  ASSERT_FALSE(NULL == params_hdl);
+  bool res = rcl_parse_yaml_file(path, params_hdl);
+  fprintf(stderr, "%s\n", rcutils_get_error_string().str);
+  EXPECT_TRUE(res);
+  ASSERT_EQ(2U, params_hdl->num_nodes);
+  EXPECT_STREQ("large_ns/node2", params_hdl->node_names[1]);
+  ASSERT_EQ(1003U, params_hdl->params[1].num_params);
+  EXPECT_STREQ("group_99.param_9", params_hdl->params[1].parameter_names[999]);
+  EXPECT_DOUBLE_EQ(999.5, *(params_hdl->params[1].parameter_values[999].double_value));
+  rcl_int64_array_t * table = params_hdl->params[1].parameter_values[1000].integer_array_value;
+  ASSERT_FALSE(NULL == table);
+  ASSERT_EQ(5000U, table->size);
+  EXPECT_EQ(4999, table->values[4999]);
+  rcutils_string_array_t * names = params_hdl->params[1].parameter_values[1001].string_array_value;
+  ASSERT_FALSE(NULL == names);
+  ASSERT_EQ(5000U, names->size);
+  EXPECT_STREQ("str_4999", names->data[4999]);
+
+  // The same structure is allocated from an arena
+  rcl_yaml_arena_t * arena = rcl_yaml_arena_init(0U, allocator);
+  ASSERT_FALSE(NULL == arena);
+  rcl_params_t * arena_params_hdl = rcl_yaml_node_struct_init(
+    rcl_yaml_arena_get_allocator(arena));
+  ASSERT_FALSE(NULL == arena_params_hdl);
+  EXPECT_TRUE(rcl_parse_yaml_file(path, arena_params_hdl));
+  expect_params_eq(params_hdl, arena_params_hdl);
+  rcl_yaml_node_struct_fini(arena_params_hdl);
+  rcl_yaml_arena_fini(arena);
+
+  rcl_yaml_node_struct_fini(params_hdl);
+  remove(path);
+}
+
+TEST(test_file_parser, arena_allocator) {
+  rcl_yaml_arena_t * arena = rcl_yaml_arena_init(256U, allocator);
+  ASSERT_FALSE(NULL == arena);
+  rcutils_allocator_t arena_allocator = rcl_yaml_arena_get_allocator(arena);
+  EXPECT_TRUE(rcutils_allocator_is_valid(&arena_allocator));
+
+  // Allocations are aligned and zero_allocate clears the memory
+  char * small = static_cast<char *>(arena_allocator.allocate(3U, arena_allocator.state));
+  ASSERT_FALSE(NULL == small);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(small) % alignof(double));
+  int64_t * zeros = static_cast<int64_t *>(
+    arena_allocator.zero_allocate(8U, sizeof(int64_t), arena_allocator.state));
+  ASSERT_FALSE(NULL == zeros);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(zeros) % alignof(int64_t));
+  for (size_t i = 0U; i < 8U; ++i) {
+    EXPECT_EQ(0, zeros[i]);
+    zeros[i] = static_cast<int64_t>(i);
+  }
+
+  // Reallocating keeps the values, whether or not the allocation can grow in place
+  zeros = static_cast<int64_t *>(
+    arena_allocator.reallocate(zeros, 16U * sizeof(int64_t), arena_allocator.state));
+  ASSERT_FALSE(NULL == zeros);
+  zeros = static_cast<int64_t *>(
+    arena_allocator.reallocate(zeros, 1024U * sizeof(int64_t), arena_allocator.state));
+  ASSERT_FALSE(NULL == zeros);
+  for (size_t i = 0U; i < 8U; ++i) {
+    EXPECT_EQ(static_cast<int64_t>(i), zeros[i]);
+  }
+  arena_allocator.deallocate(zeros, arena_allocator.state);
+  arena_allocator.deallocate(small, arena_allocator.state);
+  rcl_yaml_arena_fini(arena);
+}
+
+TEST(test_file_parser, binary_cache) {
+  rcutils_reset_error();
+  EXPECT_TRUE(rcutils_get_cwd(cur_dir, 1024));
+  char * test_path = rcutils_join_path(cur_dir, "test", allocator);
+  char * path = rcutils_join_path(test_path, "correct_config.yaml", allocator);
+  const char * cache_path = "test_parse_yaml_correct_config.cache";
+  remove(cache_path);
+
+  rcl_params_t * params_hdl = rcl_yaml_node_struct_init(allocator);
+  ASSERT_FALSE(NULL == params_hdl);
+  EXPECT_TRUE(rcl_parse_yaml_file(path, params_hdl));
+
+  // The first parse generates the cache, the second one reads it
+  for (size_t i = 0U; i < 2U; ++i) {
+    rcl_params_t * cached_params_hdl = rcl_yaml_node_struct_init(allocator);
+    ASSERT_FALSE(NULL == cached_params_hdl);
+    EXPECT_TRUE(rcl_parse_yaml_file_cached(path, cache_path, cached_params_hdl));
+    EXPECT_TRUE(rcutils_exists(cache_path));
+    expect_params_eq(params_hdl, cached_params_hdl);
+    rcl_yaml_node_struct_fini(cached_params_hdl);
+  }
+
+  // A corrupted cache is ignored and regenerated
+  FILE * cache_file = fopen(cache_path, "r+b");
+  ASSERT_FALSE(NULL == cache_file);
+  fseek(cache_file, -4, SEEK_END);
+  fputs("\xff\xff\xff\xff", cache_file);
+  fclose(cache_file);
+  rcl_params_t * cached_params_hdl = rcl_yaml_node_struct_init(allocator);
+  ASSERT_FALSE(NULL == cached_params_hdl);
+  EXPECT_TRUE(rcl_parse_yaml_file_cached(path, cache_path, cached_params_hdl));
+  expect_params_eq(params_hdl, cached_params_hdl);
+  rcl_yaml_node_struct_fini(cached_params_hdl);
+
+  rcl_yaml_node_struct_fini(params_hdl);
+  remove(cache_path);
+  allocator.deallocate(test_path, allocator.state);
+  allocator.deallocate(path, allocator.state);
+}
+
+/// Overwrite the bytes of the cache which follow the first occurrence of a pattern
+static bool corrupt_cache(
+  const char * cache_path, const std::string & pattern, int offset, const std::string & bytes)
+{
+  FILE * cache_file = fopen(cache_path, "r+b");
+  if (NULL == cache_file) {
+    return false;
+  }
+  std::string content;
+  char buffer[4096];
+  size_t read_size;
+  while (0U != (read_size = fread(buffer, 1U, sizeof(buffer), cache_file))) {
+    content.append(buffer, read_size);
+  }
+  const size_t position = content.find(pattern);
+  bool corrupted = (std::string::npos != position) &&
+    (0 == fseek(cache_file, static_cast<int>(position) + offset, SEEK_SET)) &&
+    (bytes.size() == fwrite(bytes.data(), 1U, bytes.size(), cache_file));
+  return (0 == fclose(cache_file)) && corrupted;
+}
+
+TEST(test_file_parser, binary_cache_corrupt_payload) {
+  rcutils_reset_error();
+  const char * path = "test_parse_yaml_corrupt.yaml";
+  const char * cache_path = "test_parse_yaml_corrupt.cache";
+  remove(cache_path);
+  FILE * yaml_file = fopen(path, "w");
+  ASSERT_FALSE(NULL == yaml_file);
+  fputs("node:\n  ros__parameters:\n    name: hello_world\n    value: 12345\n", yaml_file);
+  fclose(yaml_file);
+
+  rcl_params_t * params_hdl = rcl_yaml_node_struct_init(allocator);
+  ASSERT_FALSE(NULL == params_hdl);
+  EXPECT_TRUE(rcl_parse_yaml_file_cached(path, cache_path, params_hdl));
+
+  // The length of a string, stored as an u64 before its characters, and an integer value are
+  // changed. The decoder itself would accept the changed integer, the checksum does not.
+  const int64_t value = 12345;
+  const std::string value_bytes(reinterpret_cast<const char *>(&value), sizeof(value));
+  const std::vector<std::string> patterns = {"hello_world", value_bytes};
+  const std::vector<int> offsets = {-static_cast<int>(sizeof(uint64_t)), 0};
+  const std::vector<std::string> bytes = {std::string(1U, '\x05'), std::string(1U, '\x3a')};
+  for (size_t i = 0U; i < patterns.size(); ++i) {
+    // Regenerate the cache, then corrupt it
+    rcl_params_t * cached_params_hdl = rcl_yaml_node_struct_init(allocator);
+    ASSERT_FALSE(NULL == cached_params_hdl);
+    remove(cache_path);
+    EXPECT_TRUE(rcl_parse_yaml_file_cached(path, cache_path, cached_params_hdl));
+    rcl_yaml_node_struct_fini(cached_params_hdl);
+    ASSERT_TRUE(corrupt_cache(cache_path, patterns[i], offsets[i], bytes[i]));
+
+    cached_params_hdl = rcl_yaml_node_struct_init(allocator);
+    ASSERT_FALSE(NULL == cached_params_hdl);
+    EXPECT_TRUE(rcl_parse_yaml_file_cached(path, cache_path, cached_params_hdl));
+    expect_params_eq(params_hdl, cached_params_hdl);
+    rcl_yaml_node_struct_fini(cached_params_hdl);
+  }
+
+  rcl_yaml_node_struct_fini(params_hdl);
+  remove(path);
+  remove(cache_path);
+}
+
+TEST(test_file_parser, binary_cache_stale) {
+  rcutils_reset_error();
+  const char * path = "test_parse_yaml_stale.yaml";
+  const char * cache_path = "test_parse_yaml_stale.cache";
+  remove(cache_path);
+  FILE * yaml_file = fopen(path, "w");
+  ASSERT_FALSE(NULL == yaml_file);
+  fputs("node:\n  ros__parameters:\n    value: 1\n", yaml_file);
+  fclose(yaml_file);
+
+  rcl_params_t * params_hdl = rcl_yaml_node_struct_init(allocator);
+  ASSERT_FALSE(NULL == params_hdl);
+  EXPECT_TRUE(rcl_parse_yaml_file_cached(path, cache_path, params_hdl));
+  rcl_yaml_node_struct_fini(params_hdl);
+
+  // The size of the file changes, so the cache is stale even with the same modification time
+  yaml_file = fopen(path, "w");
+  ASSERT_FALSE(NULL == yaml_file);
+  fputs("node:\n  ros__parameters:\n    value: 22\n    other: true\n", yaml_file);
+  fclose(yaml_file);
+
+  params_hdl = rcl_yaml_node_struct_init(allocator);
+  ASSERT_FALSE(NULL == params_hdl);
+  EXPECT_TRUE(rcl_parse_yaml_file_cached(path, cache_path, params_hdl));
+  ASSERT_EQ(1U, params_hdl->num_nodes);
+  ASSERT_EQ(2U, params_hdl->params[0].num_params);
+  EXPECT_EQ(22, *(params_hdl->params[0].parameter_values[0].integer_value));
+  rcl_yaml_node_struct_fini(params_hdl);
+  remove(path);
+  remove(cache_path);
+}
+
 int32_t main(int32_t argc, char ** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
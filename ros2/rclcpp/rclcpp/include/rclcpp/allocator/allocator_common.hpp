@@ -50,6 +50,21 @@ void retyped_deallocate(void * untyped_pointer, void * untyped_allocator)
   std::allocator_traits<Alloc>::deallocate(*typed_allocator, typed_ptr, 1);
 }
 
+// Used when the allocator has a reallocate(pointer, size) member, which keeps the content
+template<typename T, typename Alloc>
+auto reallocate_impl(Alloc & allocator, T * typed_ptr, size_t size, int)
+-> decltype(allocator.reallocate(typed_ptr, size))
+{
+  return allocator.reallocate(typed_ptr, size);
+}
+
+template<typename T, typename Alloc>
+void * reallocate_impl(Alloc & allocator, T * typed_ptr, size_t size, long)
+{
+  std::allocator_traits<Alloc>::deallocate(allocator, typed_ptr, 1);
+  return std::allocator_traits<Alloc>::allocate(allocator, size);
+}
+
 template<typename T, typename Alloc>
 void * retyped_reallocate(void * untyped_pointer, size_t size, void * untyped_allocator)
 {
@@ -58,8 +73,7 @@ void * retyped_reallocate(void * untyped_pointer, size_t size, void * untyped_al
     throw std::runtime_error("Received incorrect allocator type");
   }
   auto typed_ptr = static_cast<T *>(untyped_pointer);
-  std::allocator_traits<Alloc>::deallocate(*typed_allocator, typed_ptr, 1);
-  return std::allocator_traits<Alloc>::allocate(*typed_allocator, size);
+  return reallocate_impl<T, Alloc>(*typed_allocator, typed_ptr, size, 0);
 }
 
 
@@ -15,8 +15,8 @@
 #ifndef RCLCPP__NODE_INTERFACES__NODE_PARAMETERS_HPP_
 #define RCLCPP__NODE_INTERFACES__NODE_PARAMETERS_HPP_
 
-#include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
@@ -32,6 +32,7 @@
 #include "rclcpp/node_interfaces/node_topics_interface.hpp"
 #include "rclcpp/parameter.hpp"
 #include "rclcpp/parameter_service.hpp"
+#include "rclcpp/parameter_store.hpp"
 #include "rclcpp/publisher.hpp"
 #include "rclcpp/visibility_control.hpp"
 
@@ -59,6 +60,12 @@ public:
   virtual
   ~NodeParameters();
 
+  /// Set the parameters one by one, publishing one event for all of them.
+  /**
+   * The callback is called once per parameter, as for separate calls to
+   * set_parameters_atomically(), but the changes made by the whole call are coalesced in a single
+   * parameter event, in which each parameter appears at most once.
+   */
   RCLCPP_PUBLIC
   virtual
   std::vector<rcl_interfaces::msg::SetParametersResult>
@@ -111,11 +118,19 @@ public:
 private:
   RCLCPP_DISABLE_COPY(NodeParameters)
 
-  mutable std::mutex mutex_;
+  // Call the callback and apply the parameters if it accepts them, the changes are added to the
+  // event if it is not null. Must be called with the mutex locked exclusively.
+  rcl_interfaces::msg::SetParametersResult
+  set_parameters_atomically_common(
+    const std::vector<rclcpp::Parameter> & parameters,
+    rcl_interfaces::msg::ParameterEvent * parameter_event);
+
+  // Getters take the lock shared, setters take it exclusively
+  mutable std::shared_timed_mutex mutex_;
 
   ParametersCallbackFunction parameters_callback_ = nullptr;
 
-  std::map<std::string, rclcpp::Parameter> parameters_;
+  ParameterStore parameters_;
 
   Publisher<rcl_interfaces::msg::ParameterEvent>::SharedPtr events_publisher_;
 
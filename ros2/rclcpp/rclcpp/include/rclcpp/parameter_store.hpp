@@ -0,0 +1,160 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__PARAMETER_STORE_HPP_
+#define RCLCPP__PARAMETER_STORE_HPP_
+
+#include <cstddef>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "rclcpp/parameter.hpp"
+
+namespace rclcpp
+{
+
+/// Parameters of a node, hashed by name and indexed by name order for prefix queries.
+/**
+ * Lookups by name are done in the hash table, in constant time.
+ * The ordered index holds pointers to the entries of the hash table, which stay valid until the
+ * parameter is erased, so that the names listed by a prefix are found without scanning all the
+ * parameters.
+ * This class is not thread safe, the owner is expected to synchronize the accesses.
+ */
+class ParameterStore
+{
+public:
+  /// Return the parameter with the given name, nullptr if there is none.
+  const rclcpp::Parameter *
+  find(const std::string & name) const
+  {
+    auto it = parameters_.find(name);
+    return it != parameters_.end() ? &it->second : nullptr;
+  }
+
+  /// Return true if there is a parameter with the given name.
+  bool
+  contains(const std::string & name) const
+  {
+    return parameters_.count(name) != 0;
+  }
+
+  /// Add the parameter, or replace the value of the parameter with the same name.
+  /**
+   * \return true if the parameter was added, false if an existing one was replaced.
+   */
+  bool
+  set(const rclcpp::Parameter & parameter)
+  {
+    auto inserted = parameters_.emplace(parameter.get_name(), parameter);
+    if (!inserted.second) {
+      inserted.first->second = parameter;
+      return false;
+    }
+    names_.insert(&*inserted.first);
+    return true;
+  }
+
+  /// Remove the parameter with the given name.
+  /**
+   * \return false if there is no parameter with this name.
+   */
+  bool
+  erase(const std::string & name)
+  {
+    auto it = parameters_.find(name);
+    if (it == parameters_.end()) {
+      return false;
+    }
+    names_.erase(&*it);
+    parameters_.erase(it);
+    return true;
+  }
+
+  /// Reserve room for the given number of parameters in the hash table.
+  void
+  reserve(size_t count)
+  {
+    parameters_.reserve(count);
+  }
+
+  size_t
+  size() const
+  {
+    return parameters_.size();
+  }
+
+  bool
+  empty() const
+  {
+    return parameters_.empty();
+  }
+
+  /// Call f(parameter) for each parameter, ordered by name.
+  template<typename Functor>
+  void
+  for_each(Functor f) const
+  {
+    for (const Entry * entry : names_) {
+      f(entry->second);
+    }
+  }
+
+  /// Call f(parameter) for the parameter named prefix and those whose name is prefix + separator.
+  /**
+   * The parameters are visited by name order, only the names which start with the prefix are
+   * looked at.
+   */
+  template<typename Functor>
+  void
+  for_each_with_prefix(const std::string & prefix, char separator, Functor f) const
+  {
+    auto it = parameters_.find(prefix);
+    if (it != parameters_.end()) {
+      f(it->second);
+    }
+    // Names like "prefix-x" sort between "prefix" and "prefix.x", so the parameters below the
+    // prefix are searched from prefix + separator
+    const Entry lower(prefix + separator, rclcpp::Parameter());
+    for (auto name_it = names_.lower_bound(&lower); name_it != names_.end(); ++name_it) {
+      const std::string & name = (*name_it)->first;
+      if (name.compare(0, lower.first.size(), lower.first) != 0) {
+        break;
+      }
+      f((*name_it)->second);
+    }
+  }
+
+private:
+  using HashMap = std::unordered_map<std::string, rclcpp::Parameter>;
+  using Entry = HashMap::value_type;
+
+  struct NameLess
+  {
+    bool
+    operator()(const Entry * lhs, const Entry * rhs) const
+    {
+      return lhs->first < rhs->first;
+    }
+  };
+
+  HashMap parameters_;
+  // The entries of parameters_, by name order
+  std::set<const Entry *, NameLess> names_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__PARAMETER_STORE_HPP_
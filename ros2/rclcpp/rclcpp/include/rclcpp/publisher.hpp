@@ -29,6 +29,8 @@
 
 #include "rcl_interfaces/msg/intra_process_message.hpp"
 
+#include "rcutils/allocation_region.h"
+
 #include "rclcpp/allocator/allocator_common.hpp"
 #include "rclcpp/allocator/allocator_deleter.hpp"
 #include "rclcpp/macros.hpp"
@@ -188,6 +190,7 @@ public:
   virtual void
   publish(std::unique_ptr<MessageT, MessageDeleter> & msg)
   {
+    rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_PUBLISH);
     this->do_inter_process_publish(msg.get());
     if (store_intra_process_message_) {
       // Take the pointer from the unique_msg, release it and pass as a void *
@@ -227,6 +230,7 @@ public:
   virtual void
   publish(const std::shared_ptr<MessageT> & msg)
   {
+    rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_PUBLISH);
     // Avoid allocating when not using intra process.
     if (!store_intra_process_message_) {
       // In this case we're not using intra process.
@@ -246,6 +250,7 @@ public:
   virtual void
   publish(std::shared_ptr<const MessageT> msg)
   {
+    rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_PUBLISH);
     // Avoid allocating when not using intra process.
     if (!store_intra_process_message_) {
       // In this case we're not using intra process.
@@ -265,6 +270,7 @@ public:
   virtual void
   publish(const MessageT & msg)
   {
+    rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_PUBLISH);
     // Avoid allocating when not using intra process.
     if (!store_intra_process_message_) {
       // In this case we're not using intra process.
@@ -289,6 +295,7 @@ public:
   void
   publish(const rcl_serialized_message_t * serialized_msg)
   {
+    rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_PUBLISH);
     if (store_intra_process_message_) {
       // TODO(Karsten1987): support serialized message passed by intraprocess
       throw std::runtime_error("storing serialized messages in intra process is not supported yet");
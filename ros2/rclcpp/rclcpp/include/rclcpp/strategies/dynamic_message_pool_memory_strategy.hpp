@@ -0,0 +1,222 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__STRATEGIES__DYNAMIC_MESSAGE_POOL_MEMORY_STRATEGY_HPP_
+#define RCLCPP__STRATEGIES__DYNAMIC_MESSAGE_POOL_MEMORY_STRATEGY_HPP_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/message_memory_strategy.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace strategies
+{
+namespace dynamic_message_pool_memory_strategy
+{
+
+struct DynamicMessagePoolStatistics
+{
+  /// Number of messages owned by the pool.
+  size_t pool_size;
+  /// Number of messages currently borrowed.
+  size_t borrowed;
+  /// Number of calls to borrow_message().
+  size_t borrow_count;
+  /// Number of times the pool grew after its construction.
+  size_t grow_count;
+};
+
+/// Memory strategy recycling messages of any type, including messages with unbounded fields.
+/**
+ * Unlike MessagePoolMemoryStrategy, messages are not reconstructed when they are borrowed again:
+ * their sequences and strings keep the capacity they reached, so that taking a message of a size
+ * already seen does not allocate.
+ * The content of a borrowed message is the one of the last message taken into it.
+ *
+ * Messages which are returned are kept in a free list, borrowing and returning a message takes
+ * constant time.
+ * A returned message which is still referenced, e.g. because a callback kept it, is only reused
+ * once it is not referenced anymore.
+ * When no message is available the pool grows by growth_step messages, up to max_size messages
+ * if max_size is not 0.
+ *
+ * Borrowing and returning messages is thread-safe.
+ */
+template<typename MessageT, typename Alloc = std::allocator<void>>
+class DynamicMessagePoolMemoryStrategy
+  : public message_memory_strategy::MessageMemoryStrategy<MessageT, Alloc>
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(DynamicMessagePoolMemoryStrategy)
+
+  using MessageInitializer = std::function<void (MessageT &)>;
+
+  /// Constructor
+  /**
+   * \param[in] initial_size Number of messages allocated at construction.
+   * \param[in] growth_step Number of messages allocated when the pool is exhausted.
+   * \param[in] max_size Maximum number of messages in the pool, 0 for no limit.
+   * \param[in] initializer Called on each new message, e.g. to reserve the capacity of the
+   *   sequences to the size of the largest expected message.
+   */
+  explicit DynamicMessagePoolMemoryStrategy(
+    size_t initial_size = 1,
+    size_t growth_step = 1,
+    size_t max_size = 0,
+    MessageInitializer initializer = nullptr)
+  : growth_step_(growth_step > 0 ? growth_step : 1), max_size_(max_size),
+    initializer_(initializer), statistics_()
+  {
+    if (max_size_ > 0 && initial_size > max_size_) {
+      throw std::invalid_argument("initial_size must not be greater than max_size");
+    }
+    grow(initial_size);
+  }
+
+  /// Borrow a message from the message pool.
+  /**
+   * Throw an exception if the pool is exhausted and cannot grow anymore.
+   * \return Shared pointer to the borrowed message.
+   */
+  std::shared_ptr<MessageT> borrow_message()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++statistics_.borrow_count;
+    size_t index;
+    if (!pop_free_message(index)) {
+      if (!pop_deferred_message(index)) {
+        if (max_size_ > 0 && pool_.size() >= max_size_) {
+          throw std::runtime_error("Message pool is exhausted.");
+        }
+        size_t count = growth_step_;
+        if (max_size_ > 0 && pool_.size() + count > max_size_) {
+          count = max_size_ - pool_.size();
+        }
+        grow(count);
+        ++statistics_.grow_count;
+        pop_free_message(index);
+      }
+    }
+    borrowed_[index] = true;
+    ++statistics_.borrowed;
+    return pool_[index];
+  }
+
+  /// Return a message to the message pool.
+  /**
+   * \param[in] msg Shared pointer to the message to return, reset by this function.
+   */
+  void return_message(std::shared_ptr<MessageT> & msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = indices_.find(msg.get());
+    if (it == indices_.end()) {
+      throw std::runtime_error("Unrecognized message ptr in return_message.");
+    }
+    size_t index = it->second;
+    if (!borrowed_[index]) {
+      throw std::runtime_error("Message returned twice in return_message.");
+    }
+    borrowed_[index] = false;
+    --statistics_.borrowed;
+    free_indices_.push_back(index);
+    msg.reset();
+  }
+
+  DynamicMessagePoolStatistics get_statistics()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DynamicMessagePoolStatistics statistics = statistics_;
+    statistics.pool_size = pool_.size();
+    return statistics;
+  }
+
+protected:
+  // Must be called with mutex_ held, except from the constructor.
+  void grow(size_t count)
+  {
+    size_t new_size = pool_.size() + count;
+    // Reserve the lists now, so that borrowing and returning never allocates
+    pool_.reserve(new_size);
+    borrowed_.reserve(new_size);
+    free_indices_.reserve(new_size);
+    deferred_indices_.reserve(new_size);
+    indices_.reserve(new_size);
+    for (size_t i = 0; i < count; ++i) {
+      auto msg = std::allocate_shared<MessageT>(*this->message_allocator_.get());
+      if (initializer_) {
+        initializer_(*msg);
+      }
+      indices_[msg.get()] = pool_.size();
+      free_indices_.push_back(pool_.size());
+      pool_.push_back(msg);
+      borrowed_.push_back(false);
+    }
+  }
+
+  // Take a message from the free list which is only referenced by the pool.
+  bool pop_free_message(size_t & index)
+  {
+    while (!free_indices_.empty()) {
+      index = free_indices_.back();
+      free_indices_.pop_back();
+      if (pool_[index].use_count() == 1) {
+        return true;
+      }
+      // Still referenced outside of the pool, look at it again when the free list is empty
+      deferred_indices_.push_back(index);
+    }
+    return false;
+  }
+
+  // Take a message which was still referenced when it was in the free list, and is not anymore.
+  bool pop_deferred_message(size_t & index)
+  {
+    for (size_t i = 0; i < deferred_indices_.size(); ++i) {
+      if (pool_[deferred_indices_[i]].use_count() == 1) {
+        index = deferred_indices_[i];
+        deferred_indices_[i] = deferred_indices_.back();
+        deferred_indices_.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t growth_step_;
+  size_t max_size_;
+  MessageInitializer initializer_;
+
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<MessageT>> pool_;
+  std::vector<bool> borrowed_;
+  std::vector<size_t> free_indices_;
+  std::vector<size_t> deferred_indices_;
+  std::unordered_map<const MessageT *, size_t> indices_;
+  DynamicMessagePoolStatistics statistics_;
+};
+
+}  // namespace dynamic_message_pool_memory_strategy
+}  // namespace strategies
+}  // namespace rclcpp
+
+#endif  // RCLCPP__STRATEGIES__DYNAMIC_MESSAGE_POOL_MEMORY_STRATEGY_HPP_
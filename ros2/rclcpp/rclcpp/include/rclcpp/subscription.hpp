@@ -205,7 +205,8 @@ public:
   {
     /* The default message memory strategy provides a dynamically allocated message on each call to
      * create_message, though alternative memory strategies that re-use a preallocated message may be
-     * used (see rclcpp/strategies/message_pool_memory_strategy.hpp).
+     * used (see rclcpp/strategies/message_pool_memory_strategy.hpp for messages of a fixed size,
+     * and rclcpp/strategies/dynamic_message_pool_memory_strategy.hpp for any message).
      */
     return message_memory_strategy_->borrow_message();
   }
@@ -28,6 +28,7 @@
 
 #include "rcl_interfaces/msg/intra_process_message.hpp"
 
+#include "rcutils/allocation_region.h"
 #include "rcutils/logging_macros.h"
 
 using rclcpp::exceptions::throw_from_rcl_error;
@@ -303,6 +304,8 @@ Executor::execute_subscription(
   rmw_message_info_t message_info;
   message_info.from_intra_process = false;
 
+  // The message is taken, then the callback is executed, then the message is returned
+  rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_TAKE);
   if (subscription->is_serialized()) {
     auto serialized_msg = subscription->create_serialized_message();
     auto ret = rcl_take_serialized_message(
@@ -310,6 +313,7 @@ Executor::execute_subscription(
       serialized_msg.get(), &message_info);
     if (RCL_RET_OK == ret) {
       auto void_serialized_msg = std::static_pointer_cast<void>(serialized_msg);
+      rcutils::ScopedAllocationRegion execute_region(RCUTILS_ALLOCATION_REGION_EXECUTE);
       subscription->handle_message(void_serialized_msg, message_info);
     } else if (RCL_RET_SUBSCRIPTION_TAKE_FAILED != ret) {
       RCUTILS_LOG_ERROR_NAMED(
@@ -325,6 +329,7 @@ Executor::execute_subscription(
       subscription->get_subscription_handle().get(),
       message.get(), &message_info);
     if (RCL_RET_OK == ret) {
+      rcutils::ScopedAllocationRegion execute_region(RCUTILS_ALLOCATION_REGION_EXECUTE);
       subscription->handle_message(message, message_info);
     } else if (RCL_RET_SUBSCRIPTION_TAKE_FAILED != ret) {
       RCUTILS_LOG_ERROR_NAMED(
@@ -341,6 +346,7 @@ void
 Executor::execute_intra_process_subscription(
   rclcpp::SubscriptionBase::SharedPtr subscription)
 {
+  rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_TAKE);
   rcl_interfaces::msg::IntraProcessMessage ipm;
   rmw_message_info_t message_info;
   rcl_ret_t status = rcl_take(
@@ -350,6 +356,8 @@ Executor::execute_intra_process_subscription(
 
   if (status == RCL_RET_OK) {
     message_info.from_intra_process = true;
+    // Includes getting the message from the intra process manager
+    rcutils::ScopedAllocationRegion execute_region(RCUTILS_ALLOCATION_REGION_EXECUTE);
     subscription->handle_intra_process_message(ipm, message_info);
   } else if (status != RCL_RET_SUBSCRIPTION_TAKE_FAILED) {
     RCUTILS_LOG_ERROR_NAMED(
@@ -364,6 +372,7 @@ void
 Executor::execute_timer(
   rclcpp::TimerBase::SharedPtr timer)
 {
+  rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_EXECUTE);
   timer->execute_callback();
 }
 
@@ -14,12 +14,18 @@
 
 #include "rclcpp/node_interfaces/node_parameters.hpp"
 
+#include <rcl_yaml_param_parser/arena.h>
 #include <rcl_yaml_param_parser/parser.h>
 
-#include <map>
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -27,6 +33,7 @@
 #include "rclcpp/create_publisher.hpp"
 #include "rclcpp/parameter_map.hpp"
 #include "rclcpp/scope_exit.hpp"
+#include "rcutils/get_env.h"
 #include "rcutils/logging_macros.h"
 #include "rmw/qos_profiles.h"
 
@@ -112,16 +119,51 @@ NodeParameters::NodeParameters(
     combined_name = node_namespace + '/' + node_name;
   }
 
-  std::map<std::string, rclcpp::Parameter> parameters;
+  // All the initial values, the last value of a name overwrites the previous ones in place
+  std::vector<rclcpp::Parameter> combined_values;
+  std::unordered_map<std::string, size_t> combined_index;
+  auto combine = [&combined_values, &combined_index](const rclcpp::Parameter & param) {
+      auto inserted = combined_index.emplace(param.get_name(), combined_values.size());
+      if (inserted.second) {
+        combined_values.push_back(param);
+      } else {
+        combined_values[inserted.first->second] = param;
+      }
+    };
+
+  // When a cache directory is given, the files are read through a binary cache, so that the nodes
+  // sharing a large file do not each parse it
+  const char * cache_directory = nullptr;
+  if (nullptr != rcutils_get_env("ROS_PARAMS_CACHE_DIR", &cache_directory)) {
+    cache_directory = nullptr;
+  }
 
   // TODO(sloretz) use rcl to parse yaml when circular dependency is solved
   // See https://github.com/ros2/rcl/issues/252
   for (const std::string & yaml_path : yaml_paths) {
-    rcl_params_t * yaml_params = rcl_yaml_node_struct_init(options->allocator);
+    // The parsed structure is only needed for the conversion, it is released at once with the arena
+    rcl_yaml_arena_t * arena = rcl_yaml_arena_init(0u, options->allocator);
+    if (nullptr == arena) {
+      throw std::bad_alloc();
+    }
+    auto cleanup_arena = make_scope_exit(
+      [arena]() {
+        rcl_yaml_arena_fini(arena);
+      });
+    rcl_params_t * yaml_params = rcl_yaml_node_struct_init(rcl_yaml_arena_get_allocator(arena));
     if (nullptr == yaml_params) {
       throw std::bad_alloc();
     }
-    if (!rcl_parse_yaml_file(yaml_path.c_str(), yaml_params)) {
+    std::string cache_path;
+    if (nullptr != cache_directory && '\0' != cache_directory[0]) {
+      std::ostringstream ss;
+      ss << cache_directory << "/" << std::hex << std::hash<std::string>()(yaml_path) <<
+        ".yaml.cache";
+      cache_path = ss.str();
+    }
+    if (!rcl_parse_yaml_file_cached(
+        yaml_path.c_str(), cache_path.empty() ? nullptr : cache_path.c_str(), yaml_params))
+    {
       std::ostringstream ss;
       ss << "Failed to parse parameters from file '" << yaml_path << "': " <<
         rcl_get_error_string().str;
@@ -129,32 +171,24 @@ NodeParameters::NodeParameters(
       throw std::runtime_error(ss.str());
     }
 
-    rclcpp::ParameterMap initial_map = rclcpp::parameter_map_from(yaml_params);
-    rcl_yaml_node_struct_fini(yaml_params);
-    auto iter = initial_map.find(combined_name);
-    if (initial_map.end() == iter) {
-      continue;
-    }
+    // Only the parameters of this node are converted
+    std::vector<rclcpp::Parameter> yaml_values =
+      rclcpp::parameters_from(yaml_params, combined_name);
 
     // Combine parameter yaml files, overwriting values in older ones
-    for (auto & param : iter->second) {
-      parameters[param.get_name()] = param;
+    combined_values.reserve(combined_values.size() + yaml_values.size());
+    for (auto & param : yaml_values) {
+      combine(param);
     }
   }
 
   // initial values passed to constructor overwrite yaml file sources
   for (auto & param : initial_parameters) {
-    parameters[param.get_name()] = param;
-  }
-
-  std::vector<rclcpp::Parameter> combined_values;
-  combined_values.reserve(parameters.size());
-  for (auto & kv : parameters) {
-    combined_values.emplace_back(kv.second);
+    combine(param);
   }
 
   // TODO(sloretz) store initial values and use them when a parameter is created ros2/rclcpp#475
-  // Set initial parameter values
+  // Set all the initial parameter values at once, with a single parameter event
   if (!combined_values.empty()) {
     rcl_interfaces::msg::SetParametersResult result = set_parameters_atomically(combined_values);
     if (!result.successful) {
@@ -171,10 +205,43 @@ NodeParameters::set_parameters(
   const std::vector<rclcpp::Parameter> & parameters)
 {
   std::vector<rcl_interfaces::msg::SetParametersResult> results;
-  for (auto p : parameters) {
-    auto result = set_parameters_atomically({{p}});
+  results.reserve(parameters.size());
+
+  std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+  // Whether each parameter existed before the first change, by order of first change
+  std::vector<std::pair<std::string, bool>> changed;
+  std::unordered_map<std::string, size_t> changed_index;
+  for (const auto & p : parameters) {
+    bool existed = parameters_.contains(p.get_name());
+    auto result = set_parameters_atomically_common({p}, nullptr);
+    if (result.successful &&
+      changed_index.emplace(p.get_name(), changed.size()).second)
+    {
+      changed.emplace_back(p.get_name(), existed);
+    }
     results.push_back(result);
   }
+  if (changed.empty()) {
+    return results;
+  }
+
+  // Report each parameter once, comparing its state before and after the whole call
+  auto parameter_event = std::make_shared<rcl_interfaces::msg::ParameterEvent>();
+  for (const auto & name_existed : changed) {
+    const rclcpp::Parameter * parameter = parameters_.find(name_existed.first);
+    if (nullptr == parameter) {
+      if (name_existed.second) {
+        parameter_event->deleted_parameters.push_back(
+          rclcpp::Parameter(name_existed.first, rclcpp::ParameterValue()).to_parameter_msg());
+      }
+    } else if (name_existed.second) {
+      parameter_event->changed_parameters.push_back(parameter->to_parameter_msg());
+    } else {
+      parameter_event->new_parameters.push_back(parameter->to_parameter_msg());
+    }
+  }
+  events_publisher_->publish(parameter_event);
+
   return results;
 }
 
@@ -182,10 +249,24 @@ rcl_interfaces::msg::SetParametersResult
 NodeParameters::set_parameters_atomically(
   const std::vector<rclcpp::Parameter> & parameters)
 {
-  std::lock_guard<std::mutex> lock(mutex_);
-  std::map<std::string, rclcpp::Parameter> tmp_map;
+  std::unique_lock<std::shared_timed_mutex> lock(mutex_);
   auto parameter_event = std::make_shared<rcl_interfaces::msg::ParameterEvent>();
 
+  auto result = set_parameters_atomically_common(parameters, parameter_event.get());
+  if (!result.successful) {
+    return result;
+  }
+
+  events_publisher_->publish(parameter_event);
+
+  return result;
+}
+
+rcl_interfaces::msg::SetParametersResult
+NodeParameters::set_parameters_atomically_common(
+  const std::vector<rclcpp::Parameter> & parameters,
+  rcl_interfaces::msg::ParameterEvent * parameter_event)
+{
   // TODO(jacquelinekay): handle parameter constraints
   rcl_interfaces::msg::SetParametersResult result;
   if (parameters_callback_) {
@@ -198,55 +279,54 @@ NodeParameters::set_parameters_atomically(
     return result;
   }
 
-  for (auto p : parameters) {
-    if (p.get_type() == rclcpp::ParameterType::PARAMETER_NOT_SET) {
-      if (parameters_.find(p.get_name()) != parameters_.end()) {
-        // case: parameter was set before, and input is "NOT_SET"
-        // therefore we will erase the parameter from parameters_ later
-        parameter_event->deleted_parameters.push_back(p.to_parameter_msg());
-      }
-    } else {
-      if (parameters_.find(p.get_name()) == parameters_.end()) {
-        // case: parameter not set before, and input is something other than "NOT_SET"
-        parameter_event->new_parameters.push_back(p.to_parameter_msg());
+  if (parameter_event) {
+    for (const auto & p : parameters) {
+      if (p.get_type() == rclcpp::ParameterType::PARAMETER_NOT_SET) {
+        if (parameters_.contains(p.get_name())) {
+          // case: parameter was set before, and input is "NOT_SET"
+          // therefore we will erase the parameter from parameters_ later
+          parameter_event->deleted_parameters.push_back(p.to_parameter_msg());
+        }
       } else {
-        // case: parameter was set before, and input is something other than "NOT_SET"
-        parameter_event->changed_parameters.push_back(p.to_parameter_msg());
+        if (!parameters_.contains(p.get_name())) {
+          // case: parameter not set before, and input is something other than "NOT_SET"
+          parameter_event->new_parameters.push_back(p.to_parameter_msg());
+        } else {
+          // case: parameter was set before, and input is something other than "NOT_SET"
+          parameter_event->changed_parameters.push_back(p.to_parameter_msg());
+        }
       }
-      tmp_map[p.get_name()] = p;
     }
   }
-  // std::map::insert will not overwrite elements, so we'll keep the new
-  // ones and add only those that already exist in the Node's internal map
-  tmp_map.insert(parameters_.begin(), parameters_.end());
 
-  // remove explicitly deleted parameters
-  for (auto p : parameters) {
+  // The parameters are updated in place, the values are set before the explicitly deleted
+  // parameters are removed
+  parameters_.reserve(parameters_.size() + parameters.size());
+  for (const auto & p : parameters) {
+    if (p.get_type() != rclcpp::ParameterType::PARAMETER_NOT_SET) {
+      parameters_.set(p);
+    }
+  }
+  for (const auto & p : parameters) {
     if (p.get_type() == rclcpp::ParameterType::PARAMETER_NOT_SET) {
-      tmp_map.erase(p.get_name());
+      parameters_.erase(p.get_name());
     }
   }
 
-  std::swap(tmp_map, parameters_);
-
-  events_publisher_->publish(parameter_event);
-
   return result;
 }
 
 std::vector<rclcpp::Parameter>
 NodeParameters::get_parameters(const std::vector<std::string> & names) const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
   std::vector<rclcpp::Parameter> results;
+  results.reserve(names.size());
 
   for (auto & name : names) {
-    if (std::any_of(parameters_.cbegin(), parameters_.cend(),
-      [&name](const std::pair<std::string, rclcpp::Parameter> & kv) {
-        return name == kv.first;
-      }))
-    {
-      results.push_back(parameters_.at(name));
+    const rclcpp::Parameter * parameter = parameters_.find(name);
+    if (parameter) {
+      results.push_back(*parameter);
     }
   }
   return results;
@@ -269,10 +349,11 @@ NodeParameters::get_parameter(
   const std::string & name,
   rclcpp::Parameter & parameter) const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
 
-  if (parameters_.count(name)) {
-    parameter = parameters_.at(name);
+  const rclcpp::Parameter * found = parameters_.find(name);
+  if (found) {
+    parameter = *found;
     return true;
   } else {
     return false;
@@ -282,16 +363,15 @@ NodeParameters::get_parameter(
 std::vector<rcl_interfaces::msg::ParameterDescriptor>
 NodeParameters::describe_parameters(const std::vector<std::string> & names) const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
   std::vector<rcl_interfaces::msg::ParameterDescriptor> results;
-  for (auto & kv : parameters_) {
-    if (std::any_of(names.cbegin(), names.cend(), [&kv](const std::string & name) {
-        return name == kv.first;
-      }))
-    {
+  results.reserve(names.size());
+  for (auto & name : names) {
+    const rclcpp::Parameter * parameter = parameters_.find(name);
+    if (parameter) {
       rcl_interfaces::msg::ParameterDescriptor parameter_descriptor;
-      parameter_descriptor.name = kv.first;
-      parameter_descriptor.type = kv.second.get_type();
+      parameter_descriptor.name = name;
+      parameter_descriptor.type = parameter->get_type();
       results.push_back(parameter_descriptor);
     }
   }
@@ -301,14 +381,13 @@ NodeParameters::describe_parameters(const std::vector<std::string> & names) cons
 std::vector<uint8_t>
 NodeParameters::get_parameter_types(const std::vector<std::string> & names) const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
   std::vector<uint8_t> results;
-  for (auto & kv : parameters_) {
-    if (std::any_of(names.cbegin(), names.cend(), [&kv](const std::string & name) {
-        return name == kv.first;
-      }))
-    {
-      results.push_back(kv.second.get_type());
+  results.reserve(names.size());
+  for (auto & name : names) {
+    const rclcpp::Parameter * parameter = parameters_.find(name);
+    if (parameter) {
+      results.push_back(parameter->get_type());
     } else {
       results.push_back(rcl_interfaces::msg::ParameterType::PARAMETER_NOT_SET);
     }
@@ -319,39 +398,59 @@ NodeParameters::get_parameter_types(const std::vector<std::string> & names) cons
 rcl_interfaces::msg::ListParametersResult
 NodeParameters::list_parameters(const std::vector<std::string> & prefixes, uint64_t depth) const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
   rcl_interfaces::msg::ListParametersResult result;
 
   // TODO(mikaelarguedas) define parameter separator different from "/" to avoid ambiguity
   // using "." for now
-  const char * separator = ".";
-  for (auto & kv : parameters_) {
-    bool get_all = (prefixes.size() == 0) &&
-      ((depth == rcl_interfaces::srv::ListParameters::Request::DEPTH_RECURSIVE) ||
-      (static_cast<uint64_t>(std::count(kv.first.begin(), kv.first.end(), *separator)) < depth));
-    bool prefix_matches = std::any_of(prefixes.cbegin(), prefixes.cend(),
-        [&kv, &depth, &separator](const std::string & prefix) {
-          if (kv.first == prefix) {
-            return true;
-          } else if (kv.first.find(prefix + separator) == 0) {
-            size_t length = prefix.length();
-            std::string substr = kv.first.substr(length);
-            // Cast as unsigned integer to avoid warning
-            return (depth == rcl_interfaces::srv::ListParameters::Request::DEPTH_RECURSIVE) ||
-            (static_cast<uint64_t>(std::count(substr.begin(), substr.end(), *separator)) < depth);
+  const char separator = '.';
+  auto depth_matches = [depth, separator](const std::string & name, size_t offset) {
+      // Cast as unsigned integer to avoid warning
+      return (depth == rcl_interfaces::srv::ListParameters::Request::DEPTH_RECURSIVE) ||
+             (static_cast<uint64_t>(std::count(name.begin() + offset, name.end(), separator)) <
+             depth);
+    };
+
+  // Only the parameters under the prefixes are visited, not all the parameters of the node
+  std::vector<const rclcpp::Parameter *> matches;
+  if (prefixes.empty()) {
+    parameters_.for_each(
+      [&matches, &depth_matches](const rclcpp::Parameter & parameter) {
+        if (depth_matches(parameter.get_name(), 0)) {
+          matches.push_back(&parameter);
+        }
+      });
+  } else {
+    for (const auto & prefix : prefixes) {
+      parameters_.for_each_with_prefix(
+        prefix, separator,
+        [&matches, &depth_matches, &prefix](const rclcpp::Parameter & parameter) {
+          const std::string & name = parameter.get_name();
+          if (name.size() == prefix.size() || depth_matches(name, prefix.size())) {
+            matches.push_back(&parameter);
           }
-          return false;
         });
-    if (get_all || prefix_matches) {
-      result.names.push_back(kv.first);
-      size_t last_separator = kv.first.find_last_of(separator);
-      if (std::string::npos != last_separator) {
-        std::string prefix = kv.first.substr(0, last_separator);
-        if (std::find(result.prefixes.cbegin(), result.prefixes.cend(), prefix) ==
-          result.prefixes.cend())
-        {
-          result.prefixes.push_back(prefix);
-        }
+    }
+    if (prefixes.size() > 1) {
+      // A parameter can be under several prefixes, list it once and keep the names ordered
+      auto name_less = [](const rclcpp::Parameter * lhs, const rclcpp::Parameter * rhs) {
+          return lhs->get_name() < rhs->get_name();
+        };
+      std::sort(matches.begin(), matches.end(), name_less);
+      matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+    }
+  }
+
+  std::unordered_set<std::string> seen_prefixes;
+  result.names.reserve(matches.size());
+  for (const rclcpp::Parameter * parameter : matches) {
+    const std::string & name = parameter->get_name();
+    result.names.push_back(name);
+    size_t last_separator = name.find_last_of(separator);
+    if (std::string::npos != last_separator) {
+      std::string prefix = name.substr(0, last_separator);
+      if (seen_prefixes.insert(prefix).second) {
+        result.prefixes.push_back(std::move(prefix));
       }
     }
   }
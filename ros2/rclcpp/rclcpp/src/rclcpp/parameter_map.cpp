@@ -22,8 +22,11 @@ using rclcpp::exceptions::InvalidParameterValueException;
 using rclcpp::ParameterMap;
 using rclcpp::ParameterValue;
 
-ParameterMap
-rclcpp::parameter_map_from(const rcl_params_t * const c_params)
+namespace
+{
+
+void
+check_params(const rcl_params_t * const c_params)
 {
   if (NULL == c_params) {
     throw InvalidParametersException("parameters struct is NULL");
@@ -32,14 +35,48 @@ rclcpp::parameter_map_from(const rcl_params_t * const c_params)
   } else if (NULL == c_params->params) {
     throw InvalidParametersException("node params array is NULL");
   }
+}
+
+const char *
+get_node_name(const rcl_params_t * const c_params, size_t n)
+{
+  const char * c_node_name = c_params->node_names[n];
+  if (NULL == c_node_name) {
+    throw InvalidParametersException("Node name at index " + std::to_string(n) + " is NULL");
+  }
+  return c_node_name;
+}
+
+void
+append_node_params(
+  const rcl_params_t * const c_params, size_t n, std::vector<rclcpp::Parameter> & params_node)
+{
+  const rcl_node_params_t * const c_params_node = &(c_params->params[n]);
+  params_node.reserve(params_node.size() + c_params_node->num_params);
+
+  for (size_t p = 0; p < c_params_node->num_params; ++p) {
+    const char * const c_param_name = c_params_node->parameter_names[p];
+    if (NULL == c_param_name) {
+      std::string message(
+        "At node " + std::to_string(n) + " parameter " + std::to_string(p) + " name is NULL");
+      throw InvalidParametersException(message);
+    }
+    const rcl_variant_t * const c_param_value = &(c_params_node->parameter_values[p]);
+    params_node.emplace_back(c_param_name, rclcpp::parameter_value_from(c_param_value));
+  }
+}
+
+}  // namespace
+
+ParameterMap
+rclcpp::parameter_map_from(const rcl_params_t * const c_params)
+{
+  check_params(c_params);
 
   // Convert c structs into a list of parameters to set
   ParameterMap parameters;
   for (size_t n = 0; n < c_params->num_nodes; ++n) {
-    const char * c_node_name = c_params->node_names[n];
-    if (NULL == c_node_name) {
-      throw InvalidParametersException("Node name at index " + std::to_string(n) + " is NULL");
-    }
+    const char * c_node_name = get_node_name(c_params, n);
 
     /// make sure there is a leading slash on the fully qualified node name
     std::string node_name("/");
@@ -49,20 +86,30 @@ rclcpp::parameter_map_from(const rcl_params_t * const c_params)
       node_name = c_node_name;
     }
 
-    const rcl_node_params_t * const c_params_node = &(c_params->params[n]);
+    append_node_params(c_params, n, parameters[node_name]);
+  }
+  return parameters;
+}
 
-    std::vector<Parameter> & params_node = parameters[node_name];
-    params_node.reserve(c_params_node->num_params);
+std::vector<rclcpp::Parameter>
+rclcpp::parameters_from(const rcl_params_t * const c_params, const std::string & node_name)
+{
+  check_params(c_params);
 
-    for (size_t p = 0; p < c_params_node->num_params; ++p) {
-      const char * const c_param_name = c_params_node->parameter_names[p];
-      if (NULL == c_param_name) {
-        std::string message(
-          "At node " + std::to_string(n) + " parameter " + std::to_string(p) + " name is NULL");
-        throw InvalidParametersException(message);
-      }
-      const rcl_variant_t * const c_param_value = &(c_params_node->parameter_values[p]);
-      params_node.emplace_back(c_param_name, parameter_value_from(c_param_value));
+  // Only the parameters of the given node are converted, the node names are compared in place
+  std::vector<Parameter> parameters;
+  for (size_t n = 0; n < c_params->num_nodes; ++n) {
+    const char * c_node_name = get_node_name(c_params, n);
+    // the leading slash of the fully qualified node name is optional in the yaml file
+    bool matches;
+    if ('/' == c_node_name[0]) {
+      matches = node_name == c_node_name;
+    } else {
+      matches = !node_name.empty() && '/' == node_name[0] &&
+        node_name.compare(1, std::string::npos, c_node_name) == 0;
+    }
+    if (matches) {
+      append_node_params(c_params, n, parameters);
     }
   }
   return parameters;
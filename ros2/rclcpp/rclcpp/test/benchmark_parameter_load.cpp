@@ -0,0 +1,147 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the creation of a node whose parameters are loaded from yaml files, as for a node
+// holding the calibration of many cameras, and the parameter queries done on such a node.
+// The parameters are split in files of at most 500 parameters per node, each file also holds the
+// parameters of another node.
+//
+// Usage: benchmark_parameter_load [parameters] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const size_t parameters_per_camera = 10;
+const size_t parameters_per_file = 500;
+
+std::string parameter_name(size_t index)
+{
+  return "camera_" + std::to_string(index / parameters_per_camera) + ".k" +
+         std::to_string(index % parameters_per_camera);
+}
+
+// Write the files and return their paths
+std::vector<std::string> write_yaml_files(size_t num_parameters)
+{
+  std::vector<std::string> paths;
+  for (size_t first = 0; first < num_parameters; first += parameters_per_file) {
+    paths.push_back("benchmark_parameter_load_" + std::to_string(paths.size()) + ".yaml");
+    std::ofstream file(paths.back());
+    for (const char * node_name : {"other_node", "benchmark_node"}) {
+      file << node_name << ":\n  ros__parameters:\n";
+      for (size_t i = first; i < num_parameters && i < first + parameters_per_file; ++i) {
+        if (i % parameters_per_camera == 0) {
+          file << "    camera_" << i / parameters_per_camera << ":\n";
+        }
+        file << "      k" << i % parameters_per_camera << ": " << i << ".5\n";
+      }
+    }
+  }
+  return paths;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t num_parameters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+  size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+  if (num_parameters < parameters_per_camera || iterations == 0) {
+    fprintf(stderr, "Usage: %s [parameters] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  rclcpp::init(0, nullptr);
+  auto context = rclcpp::contexts::default_context::get_global_default_context();
+  std::vector<std::string> paths = write_yaml_files(num_parameters);
+  std::vector<std::string> arguments;
+  for (const auto & path : paths) {
+    arguments.push_back("__params:=" + path);
+  }
+
+  double load = 0.0;
+  rclcpp::Node::SharedPtr node;
+  for (size_t i = 0; i < iterations; ++i) {
+    node.reset();
+    auto start = Clock::now();
+    node = rclcpp::Node::make_shared(
+      "benchmark_node", "", context, arguments, {}, false, false);
+    load += ms_since(start);
+  }
+  for (const auto & path : paths) {
+    std::remove(path.c_str());
+  }
+  if (node->list_parameters({}, 0).names.size() != num_parameters) {
+    fprintf(stderr, "unexpected number of parameters\n");
+    return 1;
+  }
+
+  std::vector<std::string> names;
+  for (size_t i = 0; i < num_parameters; ++i) {
+    names.push_back(parameter_name(i));
+  }
+  auto start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    if (node->get_parameters(names).size() != num_parameters) {
+      fprintf(stderr, "missing parameters\n");
+      return 1;
+    }
+  }
+  double get = ms_since(start);
+
+  size_t num_cameras = num_parameters / parameters_per_camera;
+  start = Clock::now();
+  for (size_t i = 0; i < iterations * 100; ++i) {
+    node->list_parameters({"camera_" + std::to_string(i % num_cameras)}, 0);
+  }
+  double list = ms_since(start) / 100.0;
+
+  // A burst changing the calibration of one camera
+  std::vector<rclcpp::Parameter> burst;
+  for (size_t i = 0; i < parameters_per_camera; ++i) {
+    burst.emplace_back(parameter_name(i), static_cast<double>(i));
+  }
+  start = Clock::now();
+  for (size_t i = 0; i < iterations * 100; ++i) {
+    node->set_parameters(burst);
+  }
+  double set = ms_since(start) / 100.0;
+
+  printf("%zu parameters in %zu files (ms per iteration)\n", num_parameters, paths.size());
+  printf("%-32s %10.3f\n", "create node and load", load / iterations);
+  printf("%-32s %10.3f\n", "get all parameters", get / iterations);
+  printf("%-32s %10.4f\n", "list one camera", list / iterations);
+  printf("%-32s %10.4f\n", "set one camera", set / iterations);
+
+  node.reset();
+  rclcpp::shutdown();
+  return 0;
+}
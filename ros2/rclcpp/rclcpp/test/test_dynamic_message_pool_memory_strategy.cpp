@@ -0,0 +1,126 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rclcpp/strategies/dynamic_message_pool_memory_strategy.hpp"
+
+#include "rcl_interfaces/msg/list_parameters_result.hpp"
+
+using rcl_interfaces::msg::ListParametersResult;
+using rclcpp::strategies::dynamic_message_pool_memory_strategy::DynamicMessagePoolMemoryStrategy;
+
+/*
+   Tests that a returned message is borrowed again with the capacity of its sequences.
+ */
+TEST(TestDynamicMessagePoolMemoryStrategy, reuse_keeps_capacity) {
+  DynamicMessagePoolMemoryStrategy<ListParametersResult> strategy(1);
+  auto msg = strategy.borrow_message();
+  msg->names.resize(1000, "a_parameter_name_which_does_not_fit_in_the_small_string_buffer");
+  const std::string * data = msg->names.data();
+  ListParametersResult * address = msg.get();
+  strategy.return_message(msg);
+  EXPECT_EQ(nullptr, msg);
+
+  msg = strategy.borrow_message();
+  EXPECT_EQ(address, msg.get());
+  EXPECT_EQ(data, msg->names.data());
+  EXPECT_GE(msg->names.capacity(), 1000u);
+  strategy.return_message(msg);
+
+  auto statistics = strategy.get_statistics();
+  EXPECT_EQ(1u, statistics.pool_size);
+  EXPECT_EQ(0u, statistics.borrowed);
+  EXPECT_EQ(2u, statistics.borrow_count);
+  EXPECT_EQ(0u, statistics.grow_count);
+}
+
+/*
+   Tests that the pool grows by steps, up to its maximum size.
+ */
+TEST(TestDynamicMessagePoolMemoryStrategy, grow) {
+  DynamicMessagePoolMemoryStrategy<ListParametersResult> strategy(2, 3, 7);
+  std::vector<std::shared_ptr<ListParametersResult>> messages;
+  for (size_t i = 0; i < 7; ++i) {
+    messages.push_back(strategy.borrow_message());
+  }
+  auto statistics = strategy.get_statistics();
+  EXPECT_EQ(7u, statistics.pool_size);
+  EXPECT_EQ(7u, statistics.borrowed);
+  EXPECT_EQ(2u, statistics.grow_count);
+  EXPECT_THROW(strategy.borrow_message(), std::runtime_error);
+
+  for (auto & msg : messages) {
+    strategy.return_message(msg);
+  }
+  for (size_t i = 0; i < 100; ++i) {
+    auto msg = strategy.borrow_message();
+    strategy.return_message(msg);
+  }
+  statistics = strategy.get_statistics();
+  EXPECT_EQ(7u, statistics.pool_size);
+  EXPECT_EQ(2u, statistics.grow_count);
+
+  EXPECT_THROW(
+    (DynamicMessagePoolMemoryStrategy<ListParametersResult>(8, 1, 7)), std::invalid_argument);
+}
+
+/*
+   Tests that a message still referenced after being returned is not borrowed again.
+ */
+TEST(TestDynamicMessagePoolMemoryStrategy, returned_message_still_referenced) {
+  DynamicMessagePoolMemoryStrategy<ListParametersResult> strategy(1);
+  auto msg = strategy.borrow_message();
+  auto kept = msg;
+  strategy.return_message(msg);
+
+  msg = strategy.borrow_message();
+  EXPECT_NE(kept.get(), msg.get());
+  EXPECT_EQ(1u, strategy.get_statistics().grow_count);
+  strategy.return_message(msg);
+
+  // Once released, the message can be borrowed again
+  ListParametersResult * address = kept.get();
+  kept.reset();
+  auto first = strategy.borrow_message();
+  auto second = strategy.borrow_message();
+  EXPECT_TRUE(first.get() == address || second.get() == address);
+  EXPECT_EQ(1u, strategy.get_statistics().grow_count);
+  strategy.return_message(first);
+  strategy.return_message(second);
+}
+
+/*
+   Tests that the initializer is applied to every new message, and errors on return.
+ */
+TEST(TestDynamicMessagePoolMemoryStrategy, initializer_and_errors) {
+  DynamicMessagePoolMemoryStrategy<ListParametersResult> strategy(
+    2, 1, 0, [](ListParametersResult & msg) {msg.names.reserve(64);});
+  std::vector<std::shared_ptr<ListParametersResult>> messages;
+  for (size_t i = 0; i < 3; ++i) {
+    messages.push_back(strategy.borrow_message());
+    EXPECT_GE(messages.back()->names.capacity(), 64u);
+  }
+
+  auto unknown = std::make_shared<ListParametersResult>();
+  EXPECT_THROW(strategy.return_message(unknown), std::runtime_error);
+  auto copy = messages[0];
+  strategy.return_message(messages[0]);
+  EXPECT_THROW(strategy.return_message(copy), std::runtime_error);
+}
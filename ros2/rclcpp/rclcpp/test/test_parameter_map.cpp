@@ -352,3 +352,35 @@ TEST(Test_parameter_map_from, string_array_param_value)
   c_params->params[0].parameter_values[0].string_array_value = NULL;
   rcl_yaml_node_struct_fini(c_params);
 }
+
+TEST(Test_parameters_from, null_c_parameter)
+{
+  EXPECT_THROW(
+    rclcpp::parameters_from(NULL, "/foo"), rclcpp::exceptions::InvalidParametersException);
+}
+
+TEST(Test_parameters_from, only_given_node)
+{
+  rcl_params_t * c_params = make_params({"foo", "/bar", "foo/bar", "/foo"});
+  make_node_params(c_params, 0, {"first"});
+  make_node_params(c_params, 1, {"other"});
+  make_node_params(c_params, 2, {"other"});
+  make_node_params(c_params, 3, {"second"});
+  int64_t values[] = {1, 2, 3, 4};
+  for (size_t n = 0; n < 4; ++n) {
+    c_params->params[n].parameter_values[0].integer_value = &values[n];
+  }
+
+  std::vector<rclcpp::Parameter> params = rclcpp::parameters_from(c_params, "/foo");
+  ASSERT_EQ(2u, params.size());
+  EXPECT_STREQ("first", params.at(0).get_name().c_str());
+  EXPECT_EQ(1, params.at(0).get_value<int64_t>());
+  EXPECT_STREQ("second", params.at(1).get_name().c_str());
+  EXPECT_EQ(4, params.at(1).get_value<int64_t>());
+  EXPECT_TRUE(rclcpp::parameters_from(c_params, "/baz").empty());
+
+  for (size_t n = 0; n < 4; ++n) {
+    c_params->params[n].parameter_values[0].integer_value = NULL;
+  }
+  rcl_yaml_node_struct_fini(c_params);
+}
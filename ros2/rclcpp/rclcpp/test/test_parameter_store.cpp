@@ -0,0 +1,86 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "rclcpp/parameter_store.hpp"
+
+std::vector<std::string>
+names_with_prefix(const rclcpp::ParameterStore & store, const std::string & prefix)
+{
+  std::vector<std::string> names;
+  store.for_each_with_prefix(
+    prefix, '.', [&names](const rclcpp::Parameter & parameter) {
+      names.push_back(parameter.get_name());
+    });
+  return names;
+}
+
+TEST(TestParameterStore, set_find_erase) {
+  rclcpp::ParameterStore store;
+  EXPECT_TRUE(store.empty());
+  EXPECT_EQ(nullptr, store.find("foo"));
+
+  EXPECT_TRUE(store.set(rclcpp::Parameter("foo", 1)));
+  EXPECT_TRUE(store.contains("foo"));
+  ASSERT_NE(nullptr, store.find("foo"));
+  EXPECT_EQ(1, store.find("foo")->get_value<int64_t>());
+
+  EXPECT_FALSE(store.set(rclcpp::Parameter("foo", "bar")));
+  EXPECT_EQ(1u, store.size());
+  EXPECT_EQ("bar", store.find("foo")->get_value<std::string>());
+
+  EXPECT_TRUE(store.erase("foo"));
+  EXPECT_FALSE(store.erase("foo"));
+  EXPECT_FALSE(store.contains("foo"));
+  EXPECT_TRUE(store.empty());
+}
+
+TEST(TestParameterStore, for_each_in_name_order) {
+  rclcpp::ParameterStore store;
+  for (const char * name : {"b", "a.c", "c", "a", "a.b"}) {
+    store.set(rclcpp::Parameter(name, true));
+  }
+  store.erase("c");
+
+  std::vector<std::string> names;
+  store.for_each(
+    [&names](const rclcpp::Parameter & parameter) {
+      names.push_back(parameter.get_name());
+    });
+  EXPECT_EQ((std::vector<std::string>{"a", "a.b", "a.c", "b"}), names);
+}
+
+TEST(TestParameterStore, for_each_with_prefix) {
+  rclcpp::ParameterStore store;
+  for (const char * name : {
+      "camera", "camera-left.k", "camera.left.k", "camera.left.d", "camera.right.k", "cameras.k",
+      "lidar.range"})
+  {
+    store.set(rclcpp::Parameter(name, 1.0));
+  }
+
+  EXPECT_EQ(
+    (std::vector<std::string>{"camera", "camera.left.d", "camera.left.k", "camera.right.k"}),
+    names_with_prefix(store, "camera"));
+  EXPECT_EQ(
+    (std::vector<std::string>{"camera.left.d", "camera.left.k"}),
+    names_with_prefix(store, "camera.left"));
+  EXPECT_EQ((std::vector<std::string>{"lidar.range"}), names_with_prefix(store, "lidar"));
+  EXPECT_TRUE(names_with_prefix(store, "cam").empty());
+  EXPECT_TRUE(names_with_prefix(store, "radar").empty());
+}
@@ -0,0 +1,193 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+
+#include "osrf_testing_tools_cpp/memory_tools/memory_tools.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/strategies/message_pool_memory_strategy.hpp"
+
+#include "rcutils/allocation_region.h"
+#include "rcutils/cmdline_parser.h"
+
+#include "test_msgs/msg/builtins.hpp"
+
+using osrf_testing_tools_cpp::memory_tools::MemoryToolsService;
+using rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrategy;
+using test_msgs::msg::Builtins;
+
+static const size_t warmup_iterations = 100;
+static const size_t iterations = 1000;
+// The publish and take regions include the writer and reader of the middleware
+static bool check_middleware_regions = false;
+
+class TestSteadyStateAllocations : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp()
+  {
+    osrf_testing_tools_cpp::memory_tools::initialize();
+    // Count the allocations of the monitored thread against its current region
+    auto record = [](MemoryToolsService & service) {
+        rcutils_allocation_region_record(service.get_requested_size());
+        service.ignore();
+      };
+    osrf_testing_tools_cpp::memory_tools::on_malloc(record);
+    osrf_testing_tools_cpp::memory_tools::on_realloc(record);
+    osrf_testing_tools_cpp::memory_tools::on_calloc(record);
+    osrf_testing_tools_cpp::memory_tools::on_free(
+      [](MemoryToolsService & service) {
+        service.ignore();
+      });
+    rcutils_allocation_region_reset_stats();
+  }
+
+  void TearDown()
+  {
+    osrf_testing_tools_cpp::memory_tools::disable_monitoring();
+    osrf_testing_tools_cpp::memory_tools::uninitialize();
+  }
+
+  void expect_no_allocations(rcutils_allocation_region_t region)
+  {
+    rcutils_allocation_region_stats_t stats = rcutils_allocation_region_get_stats(region);
+    EXPECT_EQ(0u, stats.allocations) <<
+      stats.allocations << " allocations of " << stats.bytes << " bytes in " <<
+      rcutils_allocation_region_get_name(region) << " in " << iterations << " messages";
+  }
+};
+
+/*
+   Tests that once warmed up, publishing a fixed size message to a subscription with a message pool
+   and executing its callback does not allocate.
+ */
+TEST_F(TestSteadyStateAllocations, publish_to_callback) {
+  if (!osrf_testing_tools_cpp::memory_tools::is_working()) {
+    fprintf(stderr, "memory tools are not preloaded, allocations are not counted\n");
+    return;
+  }
+  auto node = std::make_shared<rclcpp::Node>("steady_state_allocations");
+  auto publisher = node->create_publisher<Builtins>("steady_state_allocations", 10);
+  auto msg_strategy = std::make_shared<MessagePoolMemoryStrategy<Builtins, 2>>();
+  size_t received = 0;
+  auto subscription = node->create_subscription<Builtins>(
+    "steady_state_allocations",
+    [&received](const Builtins::SharedPtr msg) {
+      (void)msg;
+      ++received;
+    }, 10, nullptr, false, msg_strategy);
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+
+  Builtins msg;
+  bool timed_out = false;
+  auto publish_and_spin = [&]() {
+      size_t expected = received + 1;
+      msg.time_value.nanosec = static_cast<uint32_t>(expected);
+      publisher->publish(msg);
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (received < expected && !timed_out) {
+        executor.spin_some();
+        timed_out = std::chrono::steady_clock::now() > deadline;
+      }
+    };
+  // Wait for the subscription to be matched, then fill the caches and pools
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (0u == received && std::chrono::steady_clock::now() < deadline) {
+    publisher->publish(msg);
+    executor.spin_some();
+  }
+  ASSERT_LT(0u, received);
+  for (size_t i = 0; i < warmup_iterations; ++i) {
+    publish_and_spin();
+  }
+
+  rcutils_allocation_region_reset_stats();
+  osrf_testing_tools_cpp::memory_tools::enable_monitoring();
+  for (size_t i = 0; i < iterations && !timed_out; ++i) {
+    publish_and_spin();
+  }
+  osrf_testing_tools_cpp::memory_tools::disable_monitoring();
+  ASSERT_FALSE(timed_out);
+
+  for (int region = RCUTILS_ALLOCATION_REGION_NONE; region < RCUTILS_ALLOCATION_REGION_COUNT;
+    ++region)
+  {
+    rcutils_allocation_region_stats_t stats =
+      rcutils_allocation_region_get_stats(static_cast<rcutils_allocation_region_t>(region));
+    printf("%12s: %8" PRIu64 " allocations, %10" PRIu64 " bytes\n",
+      rcutils_allocation_region_get_name(static_cast<rcutils_allocation_region_t>(region)),
+      stats.allocations, stats.bytes);
+  }
+  expect_no_allocations(RCUTILS_ALLOCATION_REGION_SERIALIZE);
+  expect_no_allocations(RCUTILS_ALLOCATION_REGION_DESERIALIZE);
+  expect_no_allocations(RCUTILS_ALLOCATION_REGION_EXECUTE);
+  if (check_middleware_regions) {
+    expect_no_allocations(RCUTILS_ALLOCATION_REGION_PUBLISH);
+    expect_no_allocations(RCUTILS_ALLOCATION_REGION_TAKE);
+  }
+}
+
+/*
+   Tests that executing a timer callback does not allocate.
+ */
+TEST_F(TestSteadyStateAllocations, timer_callback) {
+  if (!osrf_testing_tools_cpp::memory_tools::is_working()) {
+    fprintf(stderr, "memory tools are not preloaded, allocations are not counted\n");
+    return;
+  }
+  auto node = std::make_shared<rclcpp::Node>("steady_state_allocations_timer");
+  size_t fired = 0;
+  auto timer = node->create_wall_timer(
+    std::chrono::milliseconds(1), [&fired]() {
+      ++fired;
+    });
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  while (fired < warmup_iterations) {
+    executor.spin_once();
+  }
+
+  rcutils_allocation_region_reset_stats();
+  osrf_testing_tools_cpp::memory_tools::enable_monitoring();
+  while (fired < warmup_iterations + 10) {
+    executor.spin_once();
+  }
+  osrf_testing_tools_cpp::memory_tools::disable_monitoring();
+  expect_no_allocations(RCUTILS_ALLOCATION_REGION_EXECUTE);
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  // Fail on the allocations of the middleware writer and reader too
+  check_middleware_regions = rcutils_cli_option_exist(argv, argv + argc, "--all-regions");
+  return RUN_ALL_TESTS();
+}
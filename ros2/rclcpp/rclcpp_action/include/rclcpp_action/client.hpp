@@ -15,17 +15,26 @@
 #ifndef RCLCPP_ACTION__CLIENT_HPP_
 #define RCLCPP_ACTION__CLIENT_HPP_
 
-
+#include <rcl_action/action_client.h>
 #include <rosidl_generator_c/action_type_support_struct.h>
+#include <action_msgs/msg/goal_status_array.hpp>
+#include <action_msgs/srv/cancel_goal.hpp>
+#include <rclcpp/macros.hpp>
 #include <rclcpp/node_interfaces/node_base_interface.hpp>
 #include <rclcpp/time.hpp>
+#include <rclcpp/waitable.hpp>
 #include <rosidl_typesupport_cpp/action_type_support.hpp>
 
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "rclcpp_action/client_goal_handle.hpp"
+#include "rclcpp_action/types.hpp"
 #include "rclcpp_action/visibility_control.hpp"
 
 
@@ -36,22 +45,100 @@ class ClientBaseImpl;
 
 /// Base Action Client implementation
 /// It is responsible for interfacing with the C action client API.
-class ClientBase
+/**
+ * The feedback and status subscriptions and the goal, cancel and result clients are each
+ * executed by their own waitable, see get_waitables(), and each kind of request has its own
+ * table of pending requests.
+ */
+class ClientBase : public std::enable_shared_from_this<ClientBase>
 {
 public:
+  RCLCPP_SMART_PTR_ALIASES_ONLY(ClientBase)
+
   // TODO(sloretz) NodeLoggingInterface when it can be gotten off a node
   RCLCPP_ACTION_PUBLIC
   ClientBase(
     rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
     const std::string & name,
-    const rosidl_action_type_support_t * type_support);
+    const rosidl_action_type_support_t * type_support,
+    const rcl_action_client_options_t & options);
 
   RCLCPP_ACTION_PUBLIC
   virtual ~ClientBase();
 
-  // TODO(sloretz) add a link between this class and callbacks in the templated
+  /// Get the waitables of the feedback and status subscriptions and of the three clients.
+  /**
+   * They are added to a node by create_client(), and executed independently of each other.
+   * The action client must be owned by a shared pointer.
+   */
+  RCLCPP_ACTION_PUBLIC
+  const std::vector<rclcpp::Waitable::SharedPtr> &
+  get_waitables();
+
+protected:
+  using ResponseCallback = std::function<void (std::shared_ptr<void> response)>;
+
+  /// Generate a random goal ID.
+  RCLCPP_ACTION_PUBLIC
+  GoalID
+  generate_goal_id();
+
+  RCLCPP_ACTION_PUBLIC
+  void
+  send_goal_request(std::shared_ptr<void> request, ResponseCallback callback);
+
+  RCLCPP_ACTION_PUBLIC
+  void
+  send_result_request(std::shared_ptr<void> request, ResponseCallback callback);
+
+  RCLCPP_ACTION_PUBLIC
+  void
+  send_cancel_request(std::shared_ptr<void> request, ResponseCallback callback);
+
+  // The typed part of the client, implemented by Client<ACTION>
+
+  virtual std::shared_ptr<void>
+  create_goal_response() const = 0;
+
+  virtual std::shared_ptr<void>
+  create_result_response() const = 0;
+
+  virtual std::shared_ptr<void>
+  create_feedback_message() const = 0;
+
+  virtual void
+  handle_feedback_message(std::shared_ptr<void> message) = 0;
+
+  virtual void
+  handle_status_message(std::shared_ptr<action_msgs::msg::GoalStatusArray> message) = 0;
 
 private:
+  class Entity;
+
+  enum class EntityType {FeedbackSubscription, StatusSubscription, GoalClient, CancelClient,
+    ResultClient};
+
+  bool
+  add_to_wait_set(rcl_wait_set_t * wait_set);
+
+  bool
+  is_ready(rcl_wait_set_t * wait_set, EntityType type);
+
+  void
+  execute_feedback_received();
+
+  void
+  execute_status_received();
+
+  void
+  execute_goal_response_received();
+
+  void
+  execute_cancel_response_received();
+
+  void
+  execute_result_response_received();
+
   std::unique_ptr<ClientBaseImpl> pimpl_;
 };
 
@@ -65,35 +152,164 @@ class Client : public ClientBase
 public:
   RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(Client)
 
-  using FeedbackCallback = std::function<void (
-        std::shared_ptr<ClientGoalHandle<ACTION>>, const typename ACTION::Feedback)>;
+  using GoalHandle = ClientGoalHandle<ACTION>;
+  using FeedbackCallback = typename GoalHandle::FeedbackCallback;
+  using CancelRequest = typename ACTION::CancelGoalService::Request;
+  using CancelResponse = typename ACTION::CancelGoalService::Response;
 
   Client(
     rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
-    const std::string & name
+    const std::string & name,
+    const rcl_action_client_options_t & options
   )
   : ClientBase(
       node_base,
       name,
-      rosidl_typesupport_cpp::get_action_type_support_handle<ACTION>())
+      rosidl_typesupport_cpp::get_action_type_support_handle<ACTION>(),
+      options)
   {
-    // TODO(sloretz) what's the link that causes a feedback topic to be called ?
   }
 
-  ClientGoalHandle<ACTION>
-  async_send_goal(typename ACTION::Goal * goal, FeedbackCallback callback = nullptr);
+  /// Send a goal, the future is set to the goal handle once accepted or to nullptr if rejected.
+  std::shared_future<typename GoalHandle::SharedPtr>
+  async_send_goal(const typename ACTION::Goal & goal, FeedbackCallback callback = nullptr)
+  {
+    auto promise = std::make_shared<std::promise<typename GoalHandle::SharedPtr>>();
+    std::shared_future<typename GoalHandle::SharedPtr> future(promise->get_future());
+    auto goal_request = std::make_shared<typename ACTION::Goal>(goal);
+    goal_request->uuid = this->generate_goal_id();
+    this->send_goal_request(
+      std::static_pointer_cast<void>(goal_request),
+      [this, goal_request, callback, promise](std::shared_ptr<void> response) mutable
+      {
+        using GoalResponse = typename ACTION::GoalRequestService::Response;
+        auto goal_response = std::static_pointer_cast<GoalResponse>(response);
+        if (!goal_response->accepted) {
+          promise->set_value(nullptr);
+          return;
+        }
+        GoalInfo goal_info;
+        goal_info.uuid = goal_request->uuid;
+        goal_info.stamp = goal_response->stamp;
+        typename GoalHandle::SharedPtr goal_handle(new GoalHandle(goal_info, callback));
+        {
+          std::lock_guard<std::mutex> lock(goal_handles_mutex_);
+          goal_handles_[goal_info.uuid] = goal_handle;
+        }
+        // Ask for the result right away, it is sent once the goal is done
+        auto result_request = std::make_shared<typename ACTION::GoalResultService::Request>();
+        result_request->uuid = goal_info.uuid;
+        this->send_result_request(
+          std::static_pointer_cast<void>(result_request),
+          [this, goal_handle](std::shared_ptr<void> response)
+          {
+            {
+              std::lock_guard<std::mutex> lock(goal_handles_mutex_);
+              goal_handles_.erase(goal_handle->get_goal_id());
+            }
+            goal_handle->set_result(std::static_pointer_cast<typename ACTION::Result>(response));
+          });
+        promise->set_value(goal_handle);
+      });
+    return future;
+  }
 
-  RCLCPP_ACTION_PUBLIC
-  std::future<typename ACTION::CancelGoalService::Response>
-  async_cancel_all_goals();
+  /// Ask the action server to cancel a goal.
+  std::shared_future<typename CancelResponse::SharedPtr>
+  async_cancel_goal(typename GoalHandle::SharedPtr goal_handle)
+  {
+    auto cancel_request = std::make_shared<CancelRequest>();
+    cancel_request->goal_info.uuid = goal_handle->get_goal_id();
+    return async_cancel(cancel_request);
+  }
 
-  RCLCPP_ACTION_PUBLIC
-  std::future<typename ACTION::CancelGoalService::Response>
-  async_cancel_goals_before(rclcpp::Time);
+  /// Ask the action server to cancel all the goals.
+  std::shared_future<typename CancelResponse::SharedPtr>
+  async_cancel_all_goals()
+  {
+    auto cancel_request = std::make_shared<CancelRequest>();
+    return async_cancel(cancel_request);
+  }
+
+  /// Ask the action server to cancel the goals accepted at or before a time.
+  std::shared_future<typename CancelResponse::SharedPtr>
+  async_cancel_goals_before(const rclcpp::Time & stamp)
+  {
+    auto cancel_request = std::make_shared<CancelRequest>();
+    cancel_request->goal_info.stamp = stamp;
+    return async_cancel(cancel_request);
+  }
 
   virtual ~Client()
   {
   }
+
+protected:
+  std::shared_ptr<void>
+  create_goal_response() const override
+  {
+    return std::make_shared<typename ACTION::GoalRequestService::Response>();
+  }
+
+  std::shared_ptr<void>
+  create_result_response() const override
+  {
+    return std::make_shared<typename ACTION::Result>();
+  }
+
+  std::shared_ptr<void>
+  create_feedback_message() const override
+  {
+    return std::make_shared<typename ACTION::Feedback>();
+  }
+
+  void
+  handle_feedback_message(std::shared_ptr<void> message) override
+  {
+    auto feedback_message = std::static_pointer_cast<typename ACTION::Feedback>(message);
+    typename GoalHandle::SharedPtr goal_handle = find_goal_handle(feedback_message->uuid);
+    if (goal_handle) {
+      goal_handle->call_feedback_callback(goal_handle, feedback_message);
+    }
+  }
+
+  void
+  handle_status_message(std::shared_ptr<action_msgs::msg::GoalStatusArray> message) override
+  {
+    for (const GoalStatus & status : message->status_list) {
+      typename GoalHandle::SharedPtr goal_handle = find_goal_handle(status.goal_info.uuid);
+      if (goal_handle) {
+        goal_handle->set_status(status.status);
+      }
+    }
+  }
+
+private:
+  typename GoalHandle::SharedPtr
+  find_goal_handle(const GoalID & uuid)
+  {
+    std::lock_guard<std::mutex> lock(goal_handles_mutex_);
+    auto element = goal_handles_.find(uuid);
+    return element != goal_handles_.end() ? element->second : nullptr;
+  }
+
+  std::shared_future<typename CancelResponse::SharedPtr>
+  async_cancel(typename CancelRequest::SharedPtr cancel_request)
+  {
+    auto promise = std::make_shared<std::promise<typename CancelResponse::SharedPtr>>();
+    std::shared_future<typename CancelResponse::SharedPtr> future(promise->get_future());
+    this->send_cancel_request(
+      std::static_pointer_cast<void>(cancel_request),
+      [promise](std::shared_ptr<void> response) mutable
+      {
+        promise->set_value(std::static_pointer_cast<CancelResponse>(response));
+      });
+    return future;
+  }
+
+  // Only held to look up a goal, the goals are then locked on their own
+  std::mutex goal_handles_mutex_;
+  std::unordered_map<GoalID, typename GoalHandle::SharedPtr> goal_handles_;
 };
 }  // namespace rclcpp_action
 #endif  // RCLCPP_ACTION__CLIENT_HPP_
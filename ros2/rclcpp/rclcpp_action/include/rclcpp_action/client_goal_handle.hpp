@@ -16,10 +16,14 @@
 #define RCLCPP_ACTION__CLIENT_GOAL_HANDLE_HPP_
 
 #include <rcl_action/action_client.h>
+#include <rclcpp/macros.hpp>
 
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 
+#include "rclcpp_action/types.hpp"
 #include "rclcpp_action/visibility_control.hpp"
 
 namespace rclcpp_action
@@ -28,28 +32,63 @@ namespace rclcpp_action
 template<typename ACTION>
 class Client;
 
+/// Goal accepted by an action server, as seen by the client which sent it.
+/**
+ * Each goal handle has its own lock, the feedback of one goal does not wait on the others.
+ */
 template<typename ACTION>
 class ClientGoalHandle
 {
 public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ClientGoalHandle)
+
+  using FeedbackCallback = std::function<void (
+        typename ClientGoalHandle<ACTION>::SharedPtr,
+        const std::shared_ptr<const typename ACTION::Feedback>)>;
+
   virtual ~ClientGoalHandle();
 
-  /// TODO(sloretz) examples have this on client as `async_cancel_goal(goal_handle)`
-  std::future<bool>
-  async_cancel();
+  const GoalID &
+  get_goal_id() const;
+
+  /// Get the time the goal was accepted by the action server.
+  const builtin_interfaces::msg::Time &
+  get_goal_stamp() const;
 
-  std::future<typename ACTION::Result>
+  /// Get the last status received for the goal.
+  int8_t
+  get_status() const;
+
+  /// Get a future to the result of the goal.
+  /// The result is requested as soon as the goal is accepted.
+  std::shared_future<typename ACTION::Result::SharedPtr>
   async_result();
 
 private:
-  // The templated Server creates goal handles
+  // The templated Client creates goal handles
   friend Client<ACTION>;
 
-  ClientGoalHandle(rcl_action_client_t * rcl_client, const rcl_action_goal_info_t rcl_info);
+  ClientGoalHandle(const GoalInfo & info, FeedbackCallback callback);
+
+  void
+  set_status(int8_t status);
+
+  void
+  set_result(typename ACTION::Result::SharedPtr result);
+
+  void
+  call_feedback_callback(
+    typename ClientGoalHandle<ACTION>::SharedPtr shared_this,
+    std::shared_ptr<const typename ACTION::Feedback> feedback_message);
+
+  GoalInfo info_;
+  FeedbackCallback feedback_callback_;
+
+  std::promise<typename ACTION::Result::SharedPtr> result_promise_;
+  std::shared_future<typename ACTION::Result::SharedPtr> result_future_;
 
-  // TODO(sloretz) shared pointer to keep rcl_client_ alive while goal handles are alive
-  rcl_action_client_t * rcl_client_;
-  rcl_action_goal_info_t rcl_info_;
+  mutable std::mutex handle_mutex_;
+  int8_t status_;
 };
 }  // namespace rclcpp_action
 
@@ -17,14 +17,14 @@
 
 #include <rcl_action/types.h>
 
+#include <memory>
+
 namespace rclcpp_action
 {
 template<typename ACTION>
-ClientGoalHandle<ACTION>::ClientGoalHandle(
-  rcl_action_client_t * rcl_client,
-  const rcl_action_goal_info_t rcl_info
-)
-: rcl_client_(rcl_client), rcl_info_(rcl_info)
+ClientGoalHandle<ACTION>::ClientGoalHandle(const GoalInfo & info, FeedbackCallback callback)
+: info_(info), feedback_callback_(callback),
+  result_future_(result_promise_.get_future()), status_(GoalStatus::STATUS_ACCEPTED)
 {
 }
 
@@ -34,17 +34,63 @@ ClientGoalHandle<ACTION>::~ClientGoalHandle()
 }
 
 template<typename ACTION>
-std::future<bool>
-ClientGoalHandle<ACTION>::async_cancel()
+const GoalID &
+ClientGoalHandle<ACTION>::get_goal_id() const
+{
+  return info_.uuid;
+}
+
+template<typename ACTION>
+const builtin_interfaces::msg::Time &
+ClientGoalHandle<ACTION>::get_goal_stamp() const
 {
-  throw std::runtime_error("Failed to cancel goal");
+  return info_.stamp;
 }
 
 template<typename ACTION>
-std::future<typename ACTION::Result>
+int8_t
+ClientGoalHandle<ACTION>::get_status() const
+{
+  std::lock_guard<std::mutex> lock(handle_mutex_);
+  return status_;
+}
+
+template<typename ACTION>
+std::shared_future<typename ACTION::Result::SharedPtr>
 ClientGoalHandle<ACTION>::async_result()
 {
-  throw std::runtime_error("Failed to get result future");
+  return result_future_;
+}
+
+template<typename ACTION>
+void
+ClientGoalHandle<ACTION>::set_status(int8_t status)
+{
+  std::lock_guard<std::mutex> lock(handle_mutex_);
+  status_ = status;
+}
+
+template<typename ACTION>
+void
+ClientGoalHandle<ACTION>::set_result(typename ACTION::Result::SharedPtr result)
+{
+  {
+    std::lock_guard<std::mutex> lock(handle_mutex_);
+    status_ = result->status;
+  }
+  result_promise_.set_value(result);
+}
+
+template<typename ACTION>
+void
+ClientGoalHandle<ACTION>::call_feedback_callback(
+  typename ClientGoalHandle<ACTION>::SharedPtr shared_this,
+  std::shared_ptr<const typename ACTION::Feedback> feedback_message)
+{
+  // The callback is set once, it is called without the lock
+  if (feedback_callback_) {
+    feedback_callback_(shared_this, feedback_message);
+  }
 }
 }  // namespace rclcpp_action
 
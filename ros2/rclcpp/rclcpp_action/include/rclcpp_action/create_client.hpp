@@ -15,6 +15,7 @@
 #ifndef RCLCPP_ACTION__CREATE_CLIENT_HPP_
 #define RCLCPP_ACTION__CREATE_CLIENT_HPP_
 
+#include <rcl_action/action_client.h>
 #include <rclcpp/node.hpp>
 
 #include <memory>
@@ -25,16 +26,24 @@
 
 namespace rclcpp_action
 {
+/// Create an action client, and add its entities to the node.
 template<typename ACTION>
 typename Client<ACTION>::SharedPtr
 create_client(
   rclcpp::Node * node,
-  const std::string & name)
+  const std::string & name,
+  const rcl_action_client_options_t & options = rcl_action_client_get_default_options(),
+  rclcpp::callback_group::CallbackGroup::SharedPtr group = nullptr)
 {
-  return Client<ACTION>::make_shared(
+  auto action_client = Client<ACTION>::make_shared(
     node->get_node_base_interface(),
-    name);
+    name,
+    options);
+  auto node_waitables = node->get_node_waitables_interface();
+  for (auto & waitable : action_client->get_waitables()) {
+    node_waitables->add_waitable(waitable, group);
+  }
+  return action_client;
 }
 }  // namespace rclcpp_action
 #endif  // RCLCPP_ACTION__CREATE_CLIENT_HPP_
-// TODO(sloretz) rclcpp_action::create_client<>(node, action_name);
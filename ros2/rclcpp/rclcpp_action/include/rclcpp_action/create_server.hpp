@@ -15,6 +15,7 @@
 #ifndef RCLCPP_ACTION__CREATE_SERVER_HPP_
 #define RCLCPP_ACTION__CREATE_SERVER_HPP_
 
+#include <rcl_action/action_server.h>
 #include <rclcpp/node.hpp>
 
 #include <memory>
@@ -25,19 +26,35 @@
 
 namespace rclcpp_action
 {
+/// Create an action server, and add its entities to the node.
+/**
+ * With a reentrant callback group and a multi threaded executor, the goal, cancel and result
+ * requests of the action server are executed in parallel.
+ */
 template<typename ACTION>
 typename Server<ACTION>::SharedPtr
 create_server(
   rclcpp::Node * node,
   const std::string & name,
   typename Server<ACTION>::GoalCallback handle_goal,
-  typename Server<ACTION>::CancelCallback handle_cancel)
+  typename Server<ACTION>::CancelCallback handle_cancel,
+  typename Server<ACTION>::AcceptedCallback handle_accepted,
+  const rcl_action_server_options_t & options = rcl_action_server_get_default_options(),
+  rclcpp::callback_group::CallbackGroup::SharedPtr group = nullptr)
 {
-  return Server<ACTION>::make_shared(
+  auto action_server = Server<ACTION>::make_shared(
     node->get_node_base_interface(),
+    node->get_node_clock_interface(),
     name,
+    options,
     handle_goal,
-    handle_cancel);
+    handle_cancel,
+    handle_accepted);
+  auto node_waitables = node->get_node_waitables_interface();
+  for (auto & waitable : action_server->get_waitables()) {
+    node_waitables->add_waitable(waitable, group);
+  }
+  return action_server;
 }
 }  // namespace rclcpp_action
 #endif  // RCLCPP_ACTION__CREATE_SERVER_HPP_
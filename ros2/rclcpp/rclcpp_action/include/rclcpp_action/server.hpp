@@ -15,16 +15,24 @@
 #ifndef RCLCPP_ACTION__SERVER_HPP_
 #define RCLCPP_ACTION__SERVER_HPP_
 
+#include <rcl_action/action_server.h>
 #include <rosidl_generator_c/action_type_support_struct.h>
 #include <rosidl_typesupport_cpp/action_type_support.hpp>
+#include <rclcpp/macros.hpp>
 #include <rclcpp/node_interfaces/node_base_interface.hpp>
+#include <rclcpp/node_interfaces/node_clock_interface.hpp>
+#include <rclcpp/waitable.hpp>
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
-#include "rclcpp_action/visibility_control.hpp"
 #include "rclcpp_action/server_goal_handle.hpp"
+#include "rclcpp_action/types.hpp"
+#include "rclcpp_action/visibility_control.hpp"
 
 namespace rclcpp_action
 {
@@ -33,23 +41,120 @@ class ServerBaseImpl;
 
 /// Base Action Server implementation
 /// It is responsible for interfacing with the C action server API.
-class ServerBase
+/**
+ * The goal, cancel and result services and the goal expiration are each executed by their own
+ * waitable, see get_waitables(), so that with a reentrant callback group a slow result request
+ * does not hold back the acceptance of goals.
+ * The bookkeeping of the goals in rcl is kept under a short lock, the user callbacks and the
+ * messages sent are outside of it.
+ */
+class ServerBase : public std::enable_shared_from_this<ServerBase>
 {
 public:
+  RCLCPP_SMART_PTR_ALIASES_ONLY(ServerBase)
+
   // TODO(sloretz) NodeLoggingInterface when it can be gotten off a node
-  // TODO(sloretz) accept clock instance
   RCLCPP_ACTION_PUBLIC
   ServerBase(
     rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+    rclcpp::node_interfaces::NodeClockInterface::SharedPtr node_clock,
     const std::string & name,
-    const rosidl_action_type_support_t * type_support);
+    const rosidl_action_type_support_t * type_support,
+    const rcl_action_server_options_t & options);
 
   RCLCPP_ACTION_PUBLIC
   virtual ~ServerBase();
 
-  // TODO(sloretz) add a link between this class and callbacks in the server class
+  /// Get the waitables of the goal, cancel and result services and of the goal expiration.
+  /**
+   * They are added to a node by create_server(), and executed independently of each other.
+   * The action server must be owned by a shared pointer.
+   */
+  RCLCPP_ACTION_PUBLIC
+  const std::vector<rclcpp::Waitable::SharedPtr> &
+  get_waitables();
+
+protected:
+  // The typed part of the server, implemented by Server<ACTION>
+
+  virtual std::shared_ptr<void>
+  create_goal_request() = 0;
+
+  virtual GoalID
+  get_goal_id_from_goal_request(void * message) = 0;
+
+  /// Return whether the goal is accepted.
+  virtual bool
+  call_handle_goal_callback(const GoalID & uuid, std::shared_ptr<void> goal_request_message) = 0;
+
+  virtual std::shared_ptr<void>
+  create_goal_response(bool accepted, const GoalInfo & goal_info) = 0;
+
+  /// Create the goal handle of an accepted goal, the response was sent already.
+  virtual void
+  call_goal_accepted_callback(
+    rcl_action_goal_handle_t * rcl_handle,
+    const GoalInfo & goal_info,
+    std::shared_ptr<void> goal_request_message) = 0;
+
+  /// Return whether the goal is canceling.
+  virtual bool
+  call_handle_cancel_callback(const GoalID & uuid) = 0;
+
+  virtual std::shared_ptr<void>
+  create_result_request() = 0;
+
+  virtual GoalID
+  get_goal_id_from_result_request(void * message) = 0;
+
+  /// Create the result response for a goal the server does not know.
+  virtual std::shared_ptr<void>
+  create_result_response(int8_t status) = 0;
+
+  /// Forget a goal which reached a terminal state.
+  virtual void
+  forget_goal(const GoalID & uuid) = 0;
 
 private:
+  // The goal handles change their state and publish through the server
+  friend ServerGoalHandleBase;
+
+  class Entity;
+
+  enum class EntityType {GoalService, CancelService, ResultService, ExpireTimer};
+
+  bool
+  add_to_wait_set(rcl_wait_set_t * wait_set);
+
+  bool
+  is_ready(rcl_wait_set_t * wait_set, EntityType type);
+
+  void
+  execute_goal_request_received();
+
+  void
+  execute_cancel_request_received();
+
+  void
+  execute_result_request_received();
+
+  void
+  execute_check_expired_goals();
+
+  /// Apply an event to the state of a goal, and publish the status of the goals.
+  rcl_ret_t
+  update_goal_state(rcl_action_goal_handle_t * rcl_handle, rcl_action_goal_event_t event);
+
+  void
+  publish_status();
+
+  void
+  publish_feedback(void * feedback_msg);
+
+  /// Keep the result of a goal until it expires, and send it to the clients waiting for it.
+  void
+  publish_result(const GoalID & uuid, std::shared_ptr<void> result_msg);
+
   std::unique_ptr<ServerBaseImpl> pimpl_;
 };
 
@@ -63,33 +168,137 @@ class Server : public ServerBase
 public:
   RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(Server)
 
-  using GoalCallback = std::function<void (rcl_action_goal_info_t &, typename ACTION::Goal *)>;
-  using CancelCallback = std::function<void (std::shared_ptr<ServerGoalHandle<ACTION>>)>;
+  /// Decide whether a goal is accepted, it must not block.
+  using GoalCallback = std::function<bool (
+        const GoalID &, std::shared_ptr<const typename ACTION::Goal>)>;
+  /// Decide whether an active goal is canceled, it must not block.
+  using CancelCallback = std::function<bool (std::shared_ptr<ServerGoalHandle<ACTION>>)>;
+  /// Start executing an accepted goal, typically in another thread.
+  using AcceptedCallback = std::function<void (std::shared_ptr<ServerGoalHandle<ACTION>>)>;
 
   // TODO(sloretz) accept clock instance
   Server(
     rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+    rclcpp::node_interfaces::NodeClockInterface::SharedPtr node_clock,
     const std::string & name,
+    const rcl_action_server_options_t & options,
     GoalCallback handle_goal,
-    CancelCallback handle_cancel
+    CancelCallback handle_cancel,
+    AcceptedCallback handle_accepted
   )
   : ServerBase(
       node_base,
+      node_clock,
       name,
-      rosidl_typesupport_cpp::get_action_type_support_handle<ACTION>()),
+      rosidl_typesupport_cpp::get_action_type_support_handle<ACTION>(),
+      options),
     handle_goal_(handle_goal),
-    handle_cancel_(handle_cancel)
+    handle_cancel_(handle_cancel),
+    handle_accepted_(handle_accepted)
   {
-    // TODO(sloretz) what's the link that causes `handle_goal_` and `handle_cancel_` to be called?
   }
 
   virtual ~Server()
   {
   }
 
+protected:
+  std::shared_ptr<void>
+  create_goal_request() override
+  {
+    return std::make_shared<typename ACTION::Goal>();
+  }
+
+  GoalID
+  get_goal_id_from_goal_request(void * message) override
+  {
+    return static_cast<typename ACTION::Goal *>(message)->uuid;
+  }
+
+  bool
+  call_handle_goal_callback(const GoalID & uuid, std::shared_ptr<void> goal_request_message)
+  override
+  {
+    return handle_goal_(
+      uuid, std::static_pointer_cast<const typename ACTION::Goal>(goal_request_message));
+  }
+
+  std::shared_ptr<void>
+  create_goal_response(bool accepted, const GoalInfo & goal_info) override
+  {
+    auto response = std::make_shared<typename ACTION::GoalRequestService::Response>();
+    response->accepted = accepted;
+    response->stamp = goal_info.stamp;
+    return response;
+  }
+
+  void
+  call_goal_accepted_callback(
+    rcl_action_goal_handle_t * rcl_handle,
+    const GoalInfo & goal_info,
+    std::shared_ptr<void> goal_request_message) override
+  {
+    std::shared_ptr<ServerGoalHandle<ACTION>> goal_handle(new ServerGoalHandle<ACTION>(
+        shared_from_this(), rcl_handle, goal_info,
+        std::static_pointer_cast<const typename ACTION::Goal>(goal_request_message)));
+    {
+      std::lock_guard<std::mutex> lock(goal_handles_mutex_);
+      goal_handles_[goal_info.uuid] = goal_handle;
+    }
+    handle_accepted_(goal_handle);
+  }
+
+  bool
+  call_handle_cancel_callback(const GoalID & uuid) override
+  {
+    std::shared_ptr<ServerGoalHandle<ACTION>> goal_handle;
+    {
+      std::lock_guard<std::mutex> lock(goal_handles_mutex_);
+      auto element = goal_handles_.find(uuid);
+      if (element == goal_handles_.end()) {
+        // The goal is being accepted, or it is done already
+        return false;
+      }
+      goal_handle = element->second;
+    }
+    return handle_cancel_(goal_handle) && goal_handle->try_canceling();
+  }
+
+  std::shared_ptr<void>
+  create_result_request() override
+  {
+    return std::make_shared<typename ACTION::GoalResultService::Request>();
+  }
+
+  GoalID
+  get_goal_id_from_result_request(void * message) override
+  {
+    return static_cast<typename ACTION::GoalResultService::Request *>(message)->uuid;
+  }
+
+  std::shared_ptr<void>
+  create_result_response(int8_t status) override
+  {
+    auto result = std::make_shared<typename ACTION::Result>();
+    result->status = status;
+    return result;
+  }
+
+  void
+  forget_goal(const GoalID & uuid) override
+  {
+    std::lock_guard<std::mutex> lock(goal_handles_mutex_);
+    goal_handles_.erase(uuid);
+  }
+
 private:
   GoalCallback handle_goal_;
   CancelCallback handle_cancel_;
+  AcceptedCallback handle_accepted_;
+
+  // Only held to look up a goal, the goals are then locked on their own
+  std::mutex goal_handles_mutex_;
+  std::unordered_map<GoalID, std::shared_ptr<ServerGoalHandle<ACTION>>> goal_handles_;
 };
 }  // namespace rclcpp_action
 #endif  // RCLCPP_ACTION__SERVER_HPP_
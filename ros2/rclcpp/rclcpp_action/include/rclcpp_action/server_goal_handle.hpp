@@ -16,38 +16,147 @@
 #define RCLCPP_ACTION__SERVER_GOAL_HANDLE_HPP_
 
 #include <rcl_action/goal_handle.h>
+#include <rcl_action/types.h>
+#include <rclcpp/macros.hpp>
 
 #include <functional>
 #include <memory>
+#include <mutex>
 
+#include "rclcpp_action/types.hpp"
 #include "rclcpp_action/visibility_control.hpp"
 
 namespace rclcpp_action
 {
+// Forward declarations
+class ServerBase;
+
 template<typename ACTION>
-class ServerGoalHandle
+class Server;
+
+/// Base class of the goal handles of an action server, it is not templated on the action type.
+/**
+ * Each goal has its own lock, taken to change its state: goals executing on different threads
+ * do not wait on each other. Publishing feedback takes no lock at all.
+ * The goal handle may outlive the action server, its state is then only kept locally.
+ */
+class ServerGoalHandleBase
 {
 public:
-  virtual ~ServerGoalHandle();
+  RCLCPP_ACTION_PUBLIC
+  virtual ~ServerGoalHandleBase();
 
   /// Indicate if client has requested this goal be cancelled.
   /// \return true if a cancelation request has been accepted for this goal.
-  virtual bool
-  is_cancel_request() const = 0;
+  RCLCPP_ACTION_PUBLIC
+  bool
+  is_cancel_request() const;
+
+  /// Indicate if the goal is accepted, executing or canceling.
+  /// \return false once the goal reached a terminal state.
+  RCLCPP_ACTION_PUBLIC
+  bool
+  is_active() const;
+
+  /// Indicate if the goal is executing.
+  RCLCPP_ACTION_PUBLIC
+  bool
+  is_executing() const;
+
+  /// Get the ID and the acceptance stamp of the goal.
+  RCLCPP_ACTION_PUBLIC
+  const GoalInfo &
+  get_goal_info() const;
+
+protected:
+  RCLCPP_ACTION_PUBLIC
+  ServerGoalHandleBase(
+    std::weak_ptr<ServerBase> server,
+    rcl_action_goal_handle_t * rcl_handle,
+    const GoalInfo & goal_info);
+
+  /// Transition the goal, throws std::runtime_error if the transition is not valid.
+  RCLCPP_ACTION_PUBLIC
+  void
+  update_state(rcl_action_goal_event_t event);
+
+  /// Transition the goal to canceling if it still can be.
+  /// \return true if the goal is canceling.
+  RCLCPP_ACTION_PUBLIC
+  bool
+  try_canceling();
+
+  RCLCPP_ACTION_PUBLIC
+  void
+  publish_feedback_message(void * feedback_msg);
+
+  RCLCPP_ACTION_PUBLIC
+  void
+  publish_result_message(std::shared_ptr<void> result_msg);
+
+private:
+  RCLCPP_DISABLE_COPY(ServerGoalHandleBase)
+
+  std::weak_ptr<ServerBase> server_;
+  const GoalInfo goal_info_;
+  mutable std::mutex goal_mutex_;
+  // Owned by the rcl action server, not used once the goal reached a terminal state
+  rcl_action_goal_handle_t * rcl_handle_;
+  rcl_action_goal_state_t state_;
+};
+
+/// Goal handle given to the callbacks of an action server, to execute a goal.
+/**
+ * The methods of a goal handle may be called from any thread.
+ */
+template<typename ACTION>
+class ServerGoalHandle : public ServerGoalHandleBase
+{
+public:
+  RCLCPP_SMART_PTR_ALIASES_ONLY(ServerGoalHandle)
+
+  virtual ~ServerGoalHandle();
 
   /// Send an update about the progress of a goal.
-  virtual void
-  publish_feedback(const typename ACTION::Feedback * feedback_msg) = 0;
+  /**
+   * The message is published right away, it does not wait on the other goals or on the
+   * requests the action server is processing.
+   */
+  void
+  publish_feedback(std::shared_ptr<typename ACTION::Feedback> feedback_msg);
 
-  // TODO(sloretz) `set_cancelled`, `set_succeeded`, `set_aborted`
+  /// Indicate that the goal started executing.
+  void
+  set_executing();
+
+  /// Indicate that the goal succeeded, and send its result.
+  void
+  set_succeeded(typename ACTION::Result::SharedPtr result_msg);
+
+  /// Indicate that the goal failed, and send its result.
+  void
+  set_aborted(typename ACTION::Result::SharedPtr result_msg);
+
+  /// Indicate that the goal was canceled, and send its result.
+  void
+  set_canceled(typename ACTION::Result::SharedPtr result_msg);
 
-  // TODO(sloretz) examples has this attribute as 'goal'
   /// The original request message describing the goal.
-  const typename ACTION::Goal goal_;
+  const std::shared_ptr<const typename ACTION::Goal> goal_;
 
-protected:
-  explicit ServerGoalHandle(const typename ACTION::Goal goal)
-  : goal_(goal) {}
+private:
+  // The templated Server creates goal handles
+  friend Server<ACTION>;
+
+  ServerGoalHandle(
+    std::weak_ptr<ServerBase> server,
+    rcl_action_goal_handle_t * rcl_handle,
+    const GoalInfo & goal_info,
+    std::shared_ptr<const typename ACTION::Goal> goal);
+
+  void
+  set_terminal_state(
+    rcl_action_goal_event_t event, int8_t status, typename ACTION::Result::SharedPtr result_msg);
 };
 }  // namespace rclcpp_action
 
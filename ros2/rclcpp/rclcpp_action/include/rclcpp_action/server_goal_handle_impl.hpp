@@ -23,54 +23,66 @@
 namespace rclcpp_action
 {
 template<typename ACTION>
-class Server;
+ServerGoalHandle<ACTION>::ServerGoalHandle(
+  std::weak_ptr<ServerBase> server,
+  rcl_action_goal_handle_t * rcl_handle,
+  const GoalInfo & goal_info,
+  std::shared_ptr<const typename ACTION::Goal> goal)
+: ServerGoalHandleBase(server, rcl_handle, goal_info), goal_(goal)
+{
+}
 
 template<typename ACTION>
-class ServerGoalHandleImpl : public ServerGoalHandle<ACTION>
+ServerGoalHandle<ACTION>::~ServerGoalHandle()
 {
-public:
-  virtual ~ServerGoalHandleImpl()
-  {
-  }
+}
 
-  bool
-  is_cancel_request() const override
-  {
-    rcl_action_goal_state_t state = GOAL_STATE_UNKNOWN;
-    if (RCL_RET_OK != rcl_action_goal_handle_get_status(rcl_handle_.get(), &state)) {
-      // TODO(sloretz) more specific exception
-      throw std::runtime_error("Failed to get goal handle state");
-    }
-    return GOAL_STATE_CANCELING == state;
-  }
+template<typename ACTION>
+void
+ServerGoalHandle<ACTION>::publish_feedback(
+  std::shared_ptr<typename ACTION::Feedback> feedback_msg)
+{
+  feedback_msg->uuid = get_goal_info().uuid;
+  publish_feedback_message(feedback_msg.get());
+}
 
-  void
-  publish_feedback(const typename ACTION::Feedback * feedback_msg) override
-  {
-    (void)feedback_msg;
-    // TODO(sloretz) what is ros_message and how does IntraProcessmessage come into play?
-    // if (RCL_RET_OK != rcl_action_publish_feedback(rcl_server_, ros_message) {
-    //   // TODO(sloretz) more specific exception
-    //   throw std::runtime_error("Failed to publish feedback");
-    // }
-    throw std::runtime_error("Failed to publish feedback");
-  }
+template<typename ACTION>
+void
+ServerGoalHandle<ACTION>::set_executing()
+{
+  update_state(GOAL_EVENT_EXECUTE);
+}
 
-protected:
-  ServerGoalHandleImpl(
-    rcl_action_server_t * rcl_server,
-    const typename ACTION::Goal goal,
-    rcl_action_goal_handle_t * rcl_handle
-  )
-  : rcl_server_(rcl_server), rcl_handle_(rcl_handle), ServerGoalHandle<ACTION>(goal)
-  {
-  }
+template<typename ACTION>
+void
+ServerGoalHandle<ACTION>::set_succeeded(typename ACTION::Result::SharedPtr result_msg)
+{
+  set_terminal_state(GOAL_EVENT_SET_SUCCEEDED, GoalStatus::STATUS_SUCCEEDED, result_msg);
+}
 
-private:
-  friend Server<ACTION>;
-  std::shared_ptr<rcl_action_server_t> rcl_server_;
-  std::shared_ptr<rcl_action_goal_handle_t> rcl_handle_;
-};
+template<typename ACTION>
+void
+ServerGoalHandle<ACTION>::set_aborted(typename ACTION::Result::SharedPtr result_msg)
+{
+  set_terminal_state(GOAL_EVENT_SET_ABORTED, GoalStatus::STATUS_ABORTED, result_msg);
+}
+
+template<typename ACTION>
+void
+ServerGoalHandle<ACTION>::set_canceled(typename ACTION::Result::SharedPtr result_msg)
+{
+  set_terminal_state(GOAL_EVENT_SET_CANCELED, GoalStatus::STATUS_CANCELED, result_msg);
+}
+
+template<typename ACTION>
+void
+ServerGoalHandle<ACTION>::set_terminal_state(
+  rcl_action_goal_event_t event, int8_t status, typename ACTION::Result::SharedPtr result_msg)
+{
+  update_state(event);
+  result_msg->status = status;
+  publish_result_message(result_msg);
+}
 }  // namespace rclcpp_action
 
 #endif  // RCLCPP_ACTION__SERVER_GOAL_HANDLE_IMPL_HPP_
@@ -0,0 +1,67 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP_ACTION__TYPES_HPP_
+#define RCLCPP_ACTION__TYPES_HPP_
+
+#include <rcl_action/types.h>
+
+#include <action_msgs/msg/goal_info.hpp>
+#include <action_msgs/msg/goal_status.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+namespace rclcpp_action
+{
+
+using GoalID = std::array<uint8_t, UUID_SIZE>;
+using GoalStatus = action_msgs::msg::GoalStatus;
+using GoalInfo = action_msgs::msg::GoalInfo;
+
+/// Copy a goal ID into a rcl goal info.
+inline void
+convert(const GoalID & goal_id, rcl_action_goal_info_t * info)
+{
+  std::memcpy(info->uuid, goal_id.data(), UUID_SIZE);
+}
+
+/// Copy the goal ID of a rcl goal info.
+inline void
+convert(const rcl_action_goal_info_t & info, GoalID * goal_id)
+{
+  std::memcpy(goal_id->data(), info.uuid, UUID_SIZE);
+}
+
+}  // namespace rclcpp_action
+
+namespace std
+{
+/// Hash of a goal ID, its bytes are random already.
+template<>
+struct hash<rclcpp_action::GoalID>
+{
+  size_t operator()(const rclcpp_action::GoalID & goal_id) const noexcept
+  {
+    size_t result = 0;
+    std::memcpy(&result, goal_id.data(), sizeof(result) < UUID_SIZE ? sizeof(result) : UUID_SIZE);
+    return result;
+  }
+};
+}  // namespace std
+
+#endif  // RCLCPP_ACTION__TYPES_HPP_
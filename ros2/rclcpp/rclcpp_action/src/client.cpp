@@ -12,30 +12,388 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <rcl_action/action_client.h>
+#include <rcl_action/wait.h>
+
+#include <rclcpp/exceptions.hpp>
+#include <rclcpp/logging.hpp>
+
 #include <rclcpp_action/client.hpp>
 
+#include <cinttypes>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
 #include <string>
+#include <utility>
+#include <vector>
 
 using rclcpp_action::ClientBase;
+using rclcpp_action::GoalID;
+
+namespace
+{
+using ResponseCallback = std::function<void (std::shared_ptr<void> response)>;
+
+/// Requests waiting for a response, by sequence number.
+struct PendingRequests
+{
+  std::mutex mutex_;
+  std::map<int64_t, ResponseCallback> callbacks_;
+};
+
+template<typename SendFunction>
+void
+send_request(
+  const rcl_action_client_t * action_client, SendFunction send, std::shared_ptr<void> request,
+  ResponseCallback callback, PendingRequests & pending)
+{
+  // Held while sending, so that the response cannot be handled before the callback is known
+  std::lock_guard<std::mutex> lock(pending.mutex_);
+  int64_t sequence_number;
+  rcl_ret_t ret = send(action_client, request.get(), &sequence_number);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send request");
+  }
+  pending.callbacks_[sequence_number] = callback;
+}
+
+template<typename TakeFunction>
+void
+take_response(
+  const rcl_action_client_t * action_client, TakeFunction take, std::shared_ptr<void> response,
+  PendingRequests & pending)
+{
+  rmw_request_id_t response_header;
+  rcl_ret_t ret = take(action_client, &response_header, response.get());
+  if (RCL_RET_ACTION_CLIENT_TAKE_FAILED == ret) {
+    // Taken by another thread
+    rcl_reset_error();
+    return;
+  }
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+  ResponseCallback callback;
+  {
+    std::lock_guard<std::mutex> lock(pending.mutex_);
+    auto element = pending.callbacks_.find(response_header.sequence_number);
+    if (element == pending.callbacks_.end()) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("rclcpp_action"),
+        "Received a response to an unknown request, sequence number %" PRId64,
+        response_header.sequence_number);
+      return;
+    }
+    callback = std::move(element->second);
+    pending.callbacks_.erase(element);
+  }
+  callback(response);
+}
+}  // namespace
 
 namespace rclcpp_action
 {
 class ClientBaseImpl
 {
+public:
+  std::shared_ptr<rcl_action_client_t> action_client_;
+
+  size_t num_subscriptions_ = 0;
+  size_t num_clients_ = 0;
+
+  std::vector<rclcpp::Waitable::SharedPtr> waitables_;
+
+  PendingRequests goal_requests_;
+  PendingRequests result_requests_;
+  PendingRequests cancel_requests_;
+
+  std::mutex random_mutex_;
+  std::mt19937 random_engine_;
 };
-}
+
+/// One entity of an action client, executed on its own.
+/**
+ * The feedback subscription waitable adds the whole action client to the wait set, the others
+ * only check their entity in the wait set.
+ */
+class ClientBase::Entity : public rclcpp::Waitable
+{
+public:
+  Entity(
+    std::weak_ptr<ClientBase> client, EntityType type, size_t num_subscriptions, size_t num_clients)
+  : client_(client), type_(type), num_subscriptions_(num_subscriptions), num_clients_(num_clients)
+  {}
+
+  size_t
+  get_number_of_ready_subscriptions() override
+  {
+    return num_subscriptions_;
+  }
+
+  size_t
+  get_number_of_ready_clients() override
+  {
+    return num_clients_;
+  }
+
+  bool
+  add_to_wait_set(rcl_wait_set_t * wait_set) override
+  {
+    if (EntityType::FeedbackSubscription != type_) {
+      return true;
+    }
+    auto client = client_.lock();
+    return !client || client->add_to_wait_set(wait_set);
+  }
+
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override
+  {
+    auto client = client_.lock();
+    return client && client->is_ready(wait_set, type_);
+  }
+
+  void
+  execute() override
+  {
+    auto client = client_.lock();
+    if (!client) {
+      return;
+    }
+    switch (type_) {
+      case EntityType::FeedbackSubscription:
+        client->execute_feedback_received();
+        break;
+      case EntityType::StatusSubscription:
+        client->execute_status_received();
+        break;
+      case EntityType::GoalClient:
+        client->execute_goal_response_received();
+        break;
+      case EntityType::CancelClient:
+        client->execute_cancel_response_received();
+        break;
+      case EntityType::ResultClient:
+        client->execute_result_response_received();
+        break;
+    }
+  }
+
+private:
+  std::weak_ptr<ClientBase> client_;
+  EntityType type_;
+  size_t num_subscriptions_;
+  size_t num_clients_;
+};
+}  // namespace rclcpp_action
 
 ClientBase::ClientBase(
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
   const std::string & name,
-  const rosidl_action_type_support_t * type_support)
+  const rosidl_action_type_support_t * type_support,
+  const rcl_action_client_options_t & options)
+: pimpl_(new ClientBaseImpl())
 {
-  // TODO(sloretz) use rcl_action API when available
-  (void)node_base;
-  (void)name;
-  (void)type_support;
+  auto node_handle = node_base->get_shared_rcl_node_handle();
+  std::weak_ptr<rcl_node_t> weak_node_handle(node_handle);
+  pimpl_->action_client_ = std::shared_ptr<rcl_action_client_t>(
+    new rcl_action_client_t, [weak_node_handle](rcl_action_client_t * action_client)
+    {
+      if (!action_client->impl) {
+        // The initialization failed
+        delete action_client;
+        return;
+      }
+      auto handle = weak_node_handle.lock();
+      if (handle) {
+        if (RCL_RET_OK != rcl_action_client_fini(action_client, handle.get())) {
+          RCLCPP_ERROR(
+            rclcpp::get_logger("rclcpp_action"),
+            "Error in destruction of rcl action client handle: %s",
+            rcl_get_error_string().str);
+          rcl_reset_error();
+        }
+      } else {
+        RCLCPP_ERROR(
+          rclcpp::get_logger("rclcpp_action"),
+          "Error in destruction of rcl action client handle: "
+          "the Node Handle was destructed too early. You will leak memory");
+      }
+      delete action_client;
+    });
+  *pimpl_->action_client_ = rcl_action_get_zero_initialized_client();
+
+  rcl_ret_t ret = rcl_action_client_init(
+    pimpl_->action_client_.get(), node_handle.get(), type_support, name.c_str(), &options);
+  if (RCL_RET_OK != ret) {
+    // Nothing to finalize
+    *pimpl_->action_client_ = rcl_action_get_zero_initialized_client();
+    rclcpp::exceptions::throw_from_rcl_error(ret, "could not create action client");
+  }
+
+  size_t num_guard_conditions;
+  size_t num_timers;
+  size_t num_services;
+  ret = rcl_action_client_wait_set_get_num_entities(
+    pimpl_->action_client_.get(), &pimpl_->num_subscriptions_, &num_guard_conditions,
+    &num_timers, &pimpl_->num_clients_, &num_services);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret, "could not count action client entities");
+  }
+
+  std::random_device random_device;
+  pimpl_->random_engine_.seed(random_device());
 }
 
 ClientBase::~ClientBase()
 {
 }
+
+const std::vector<rclcpp::Waitable::SharedPtr> &
+ClientBase::get_waitables()
+{
+  if (pimpl_->waitables_.empty()) {
+    std::weak_ptr<ClientBase> weak_this = shared_from_this();
+    // The feedback subscription waitable accounts for all the entities it adds to the wait set
+    pimpl_->waitables_ = {
+      std::make_shared<Entity>(
+        weak_this, EntityType::FeedbackSubscription, pimpl_->num_subscriptions_,
+        pimpl_->num_clients_),
+      std::make_shared<Entity>(weak_this, EntityType::StatusSubscription, 0u, 0u),
+      std::make_shared<Entity>(weak_this, EntityType::GoalClient, 0u, 0u),
+      std::make_shared<Entity>(weak_this, EntityType::CancelClient, 0u, 0u),
+      std::make_shared<Entity>(weak_this, EntityType::ResultClient, 0u, 0u),
+    };
+  }
+  return pimpl_->waitables_;
+}
+
+GoalID
+ClientBase::generate_goal_id()
+{
+  GoalID goal_id;
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::lock_guard<std::mutex> lock(pimpl_->random_mutex_);
+  for (auto & byte : goal_id) {
+    byte = static_cast<uint8_t>(distribution(pimpl_->random_engine_));
+  }
+  return goal_id;
+}
+
+void
+ClientBase::send_goal_request(std::shared_ptr<void> request, ResponseCallback callback)
+{
+  send_request(
+    pimpl_->action_client_.get(), rcl_action_send_goal_request, request, callback,
+    pimpl_->goal_requests_);
+}
+
+void
+ClientBase::send_result_request(std::shared_ptr<void> request, ResponseCallback callback)
+{
+  send_request(
+    pimpl_->action_client_.get(), rcl_action_send_result_request, request, callback,
+    pimpl_->result_requests_);
+}
+
+void
+ClientBase::send_cancel_request(std::shared_ptr<void> request, ResponseCallback callback)
+{
+  send_request(
+    pimpl_->action_client_.get(), rcl_action_send_cancel_request, request, callback,
+    pimpl_->cancel_requests_);
+}
+
+bool
+ClientBase::add_to_wait_set(rcl_wait_set_t * wait_set)
+{
+  rcl_ret_t ret = rcl_action_wait_set_add_action_client(
+    wait_set, pimpl_->action_client_.get(), nullptr, nullptr);
+  return RCL_RET_OK == ret;
+}
+
+bool
+ClientBase::is_ready(rcl_wait_set_t * wait_set, EntityType type)
+{
+  bool feedback_ready;
+  bool status_ready;
+  bool goal_response_ready;
+  bool cancel_response_ready;
+  bool result_response_ready;
+  rcl_ret_t ret = rcl_action_client_wait_set_get_entities_ready(
+    wait_set, pimpl_->action_client_.get(), &feedback_ready, &status_ready,
+    &goal_response_ready, &cancel_response_ready, &result_response_ready);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+  switch (type) {
+    case EntityType::FeedbackSubscription:
+      return feedback_ready;
+    case EntityType::StatusSubscription:
+      return status_ready;
+    case EntityType::GoalClient:
+      return goal_response_ready;
+    case EntityType::CancelClient:
+      return cancel_response_ready;
+    case EntityType::ResultClient:
+      return result_response_ready;
+  }
+  return false;
+}
+
+void
+ClientBase::execute_feedback_received()
+{
+  std::shared_ptr<void> feedback_message = create_feedback_message();
+  rcl_ret_t ret = rcl_action_take_feedback(pimpl_->action_client_.get(), feedback_message.get());
+  if (RCL_RET_ACTION_CLIENT_TAKE_FAILED == ret) {
+    rcl_reset_error();
+    return;
+  }
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+  handle_feedback_message(feedback_message);
+}
+
+void
+ClientBase::execute_status_received()
+{
+  auto status_message = std::make_shared<action_msgs::msg::GoalStatusArray>();
+  rcl_ret_t ret = rcl_action_take_status(pimpl_->action_client_.get(), status_message.get());
+  if (RCL_RET_ACTION_CLIENT_TAKE_FAILED == ret) {
+    rcl_reset_error();
+    return;
+  }
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+  handle_status_message(status_message);
+}
+
+void
+ClientBase::execute_goal_response_received()
+{
+  take_response(
+    pimpl_->action_client_.get(), rcl_action_take_goal_response, create_goal_response(),
+    pimpl_->goal_requests_);
+}
+
+void
+ClientBase::execute_cancel_response_received()
+{
+  take_response(
+    pimpl_->action_client_.get(), rcl_action_take_cancel_response,
+    std::make_shared<action_msgs::srv::CancelGoal::Response>(), pimpl_->cancel_requests_);
+}
+
+void
+ClientBase::execute_result_response_received()
+{
+  take_response(
+    pimpl_->action_client_.get(), rcl_action_take_result_response, create_result_response(),
+    pimpl_->result_requests_);
+}
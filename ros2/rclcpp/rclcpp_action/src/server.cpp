@@ -12,30 +12,512 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <rcl_action/action_server.h>
+#include <rcl_action/wait.h>
+
+#include <action_msgs/msg/goal_status_array.hpp>
+#include <action_msgs/srv/cancel_goal.hpp>
+#include <rclcpp/exceptions.hpp>
+#include <rclcpp/logging.hpp>
+#include <rclcpp/scope_exit.hpp>
+
 #include <rclcpp_action/server.hpp>
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using rclcpp_action::ServerBase;
+using rclcpp_action::GoalID;
 
 namespace rclcpp_action
 {
 class ServerBaseImpl
 {
+public:
+  // Kept alive as the rcl action server holds a copy of its rcl clock
+  rclcpp::Clock::SharedPtr clock_;
+  std::shared_ptr<rcl_action_server_t> action_server_;
+
+  size_t num_timers_ = 0;
+  size_t num_services_ = 0;
+
+  std::vector<rclcpp::Waitable::SharedPtr> waitables_;
+
+  // Protects the goals tracked by the rcl action server
+  std::mutex server_mutex_;
+
+  // Serializes the status messages, taken before server_mutex_
+  std::mutex status_mutex_;
+  action_msgs::msg::GoalStatusArray status_msg_;
+
+  // Protects the results of the goals and the clients waiting for them, taken before server_mutex_
+  std::mutex results_mutex_;
+  std::unordered_map<GoalID, std::shared_ptr<void>> goal_results_;
+  std::unordered_map<GoalID, std::vector<rmw_request_id_t>> result_requests_;
 };
-}
+
+/// One entity of an action server, executed on its own.
+/**
+ * The goal service waitable adds the whole action server to the wait set, the others only
+ * check their entity in the wait set.
+ */
+class ServerBase::Entity : public rclcpp::Waitable
+{
+public:
+  Entity(std::weak_ptr<ServerBase> server, EntityType type, size_t num_timers, size_t num_services)
+  : server_(server), type_(type), num_timers_(num_timers), num_services_(num_services)
+  {}
+
+  size_t
+  get_number_of_ready_timers() override
+  {
+    return num_timers_;
+  }
+
+  size_t
+  get_number_of_ready_services() override
+  {
+    return num_services_;
+  }
+
+  bool
+  add_to_wait_set(rcl_wait_set_t * wait_set) override
+  {
+    if (EntityType::GoalService != type_) {
+      return true;
+    }
+    auto server = server_.lock();
+    return !server || server->add_to_wait_set(wait_set);
+  }
+
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override
+  {
+    auto server = server_.lock();
+    return server && server->is_ready(wait_set, type_);
+  }
+
+  void
+  execute() override
+  {
+    auto server = server_.lock();
+    if (!server) {
+      return;
+    }
+    switch (type_) {
+      case EntityType::GoalService:
+        server->execute_goal_request_received();
+        break;
+      case EntityType::CancelService:
+        server->execute_cancel_request_received();
+        break;
+      case EntityType::ResultService:
+        server->execute_result_request_received();
+        break;
+      case EntityType::ExpireTimer:
+        server->execute_check_expired_goals();
+        break;
+    }
+  }
+
+private:
+  std::weak_ptr<ServerBase> server_;
+  EntityType type_;
+  size_t num_timers_;
+  size_t num_services_;
+};
+}  // namespace rclcpp_action
 
 ServerBase::ServerBase(
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+  rclcpp::node_interfaces::NodeClockInterface::SharedPtr node_clock,
   const std::string & name,
-  const rosidl_action_type_support_t * type_support)
+  const rosidl_action_type_support_t * type_support,
+  const rcl_action_server_options_t & options)
+: pimpl_(new ServerBaseImpl())
 {
-  // TODO(sloretz) use rcl_action API when available
-  (void)node_base;
-  (void)name;
-  (void)type_support;
+  auto node_handle = node_base->get_shared_rcl_node_handle();
+  std::weak_ptr<rcl_node_t> weak_node_handle(node_handle);
+  pimpl_->action_server_ = std::shared_ptr<rcl_action_server_t>(
+    new rcl_action_server_t, [weak_node_handle](rcl_action_server_t * action_server)
+    {
+      if (!action_server->impl) {
+        // The initialization failed
+        delete action_server;
+        return;
+      }
+      auto handle = weak_node_handle.lock();
+      if (handle) {
+        if (RCL_RET_OK != rcl_action_server_fini(action_server, handle.get())) {
+          RCLCPP_ERROR(
+            rclcpp::get_logger("rclcpp_action"),
+            "Error in destruction of rcl action server handle: %s",
+            rcl_get_error_string().str);
+          rcl_reset_error();
+        }
+      } else {
+        RCLCPP_ERROR(
+          rclcpp::get_logger("rclcpp_action"),
+          "Error in destruction of rcl action server handle: "
+          "the Node Handle was destructed too early. You will leak memory");
+      }
+      delete action_server;
+    });
+  *pimpl_->action_server_ = rcl_action_get_zero_initialized_server();
+
+  pimpl_->clock_ = node_clock->get_clock();
+  rcl_ret_t ret = rcl_action_server_init(
+    pimpl_->action_server_.get(), node_handle.get(), pimpl_->clock_->get_clock_handle(),
+    type_support, name.c_str(), &options);
+  if (RCL_RET_OK != ret) {
+    // Nothing to finalize
+    *pimpl_->action_server_ = rcl_action_get_zero_initialized_server();
+    rclcpp::exceptions::throw_from_rcl_error(ret, "could not create action server");
+  }
+
+  size_t num_subscriptions;
+  size_t num_guard_conditions;
+  size_t num_clients;
+  ret = rcl_action_server_wait_set_get_num_entities(
+    pimpl_->action_server_.get(), &num_subscriptions, &num_guard_conditions,
+    &pimpl_->num_timers_, &num_clients, &pimpl_->num_services_);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret, "could not count action server entities");
+  }
 }
 
 ServerBase::~ServerBase()
 {
 }
+
+const std::vector<rclcpp::Waitable::SharedPtr> &
+ServerBase::get_waitables()
+{
+  if (pimpl_->waitables_.empty()) {
+    std::weak_ptr<ServerBase> weak_this = shared_from_this();
+    // The goal service waitable accounts for all the entities it adds to the wait set
+    pimpl_->waitables_ = {
+      std::make_shared<Entity>(
+        weak_this, EntityType::GoalService, pimpl_->num_timers_, pimpl_->num_services_),
+      std::make_shared<Entity>(weak_this, EntityType::CancelService, 0u, 0u),
+      std::make_shared<Entity>(weak_this, EntityType::ResultService, 0u, 0u),
+      std::make_shared<Entity>(weak_this, EntityType::ExpireTimer, 0u, 0u),
+    };
+  }
+  return pimpl_->waitables_;
+}
+
+bool
+ServerBase::add_to_wait_set(rcl_wait_set_t * wait_set)
+{
+  rcl_ret_t ret = rcl_action_wait_set_add_action_server(
+    wait_set, pimpl_->action_server_.get(), nullptr);
+  return RCL_RET_OK == ret;
+}
+
+bool
+ServerBase::is_ready(rcl_wait_set_t * wait_set, EntityType type)
+{
+  bool goal_request_ready;
+  bool cancel_request_ready;
+  bool result_request_ready;
+  bool goal_expired;
+  rcl_ret_t ret = rcl_action_server_wait_set_get_entities_ready(
+    wait_set, pimpl_->action_server_.get(), &goal_request_ready, &cancel_request_ready,
+    &result_request_ready, &goal_expired);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+  switch (type) {
+    case EntityType::GoalService:
+      return goal_request_ready;
+    case EntityType::CancelService:
+      return cancel_request_ready;
+    case EntityType::ResultService:
+      return result_request_ready;
+    case EntityType::ExpireTimer:
+      return goal_expired;
+  }
+  return false;
+}
+
+void
+ServerBase::execute_goal_request_received()
+{
+  rmw_request_id_t request_header;
+  std::shared_ptr<void> message = create_goal_request();
+  rcl_ret_t ret = rcl_action_take_goal_request(
+    pimpl_->action_server_.get(), &request_header, message.get());
+  if (RCL_RET_ACTION_SERVER_TAKE_FAILED == ret) {
+    // Taken by another thread, or not meant for this server
+    rcl_reset_error();
+    return;
+  }
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+
+  GoalInfo goal_info;
+  goal_info.uuid = get_goal_id_from_goal_request(message.get());
+  bool accepted = call_handle_goal_callback(goal_info.uuid, message);
+
+  rcl_action_goal_handle_t * rcl_handle = nullptr;
+  if (accepted) {
+    rcl_action_goal_info_t rcl_goal_info = rcl_action_get_zero_initialized_goal_info();
+    convert(goal_info.uuid, &rcl_goal_info);
+    std::lock_guard<std::mutex> lock(pimpl_->server_mutex_);
+    if (rcl_action_server_goal_exists(pimpl_->action_server_.get(), &rcl_goal_info)) {
+      // A client sent the same goal twice
+      accepted = false;
+    } else {
+      rcl_handle = rcl_action_accept_new_goal(pimpl_->action_server_.get(), &rcl_goal_info);
+      if (!rcl_handle) {
+        rclcpp::exceptions::throw_from_rcl_error(RCL_RET_ERROR, "could not accept goal");
+      }
+      ret = rcl_action_goal_handle_get_info(rcl_handle, &rcl_goal_info);
+      if (RCL_RET_OK != ret) {
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+      goal_info.stamp.sec = rcl_goal_info.stamp.sec;
+      goal_info.stamp.nanosec = rcl_goal_info.stamp.nanosec;
+    }
+  }
+
+  std::shared_ptr<void> response = create_goal_response(accepted, goal_info);
+  ret = rcl_action_send_goal_response(
+    pimpl_->action_server_.get(), &request_header, response.get());
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+
+  if (accepted) {
+    publish_status();
+    call_goal_accepted_callback(rcl_handle, goal_info, message);
+  }
+}
+
+void
+ServerBase::execute_cancel_request_received()
+{
+  rmw_request_id_t request_header;
+  auto request = std::make_shared<action_msgs::srv::CancelGoal::Request>();
+  rcl_ret_t ret = rcl_action_take_cancel_request(
+    pimpl_->action_server_.get(), &request_header, request.get());
+  if (RCL_RET_ACTION_SERVER_TAKE_FAILED == ret) {
+    rcl_reset_error();
+    return;
+  }
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+
+  rcl_action_cancel_request_t cancel_request = rcl_action_get_zero_initialized_cancel_request();
+  convert(request->goal_info.uuid, &cancel_request.goal_info);
+  cancel_request.goal_info.stamp.sec = request->goal_info.stamp.sec;
+  cancel_request.goal_info.stamp.nanosec = request->goal_info.stamp.nanosec;
+
+  // Only the goals to cancel are found under the lock, they are then transitioned one by one
+  rcl_action_cancel_response_t cancel_response = rcl_action_get_zero_initialized_cancel_response();
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->server_mutex_);
+    ret = rcl_action_process_cancel_request(
+      pimpl_->action_server_.get(), &cancel_request, &cancel_response);
+  }
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+  RCLCPP_SCOPE_EXIT({
+    ret = rcl_action_cancel_response_fini(&cancel_response);
+    if (RCL_RET_OK != ret) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("rclcpp_action"),
+        "Failed to finalize cancel response: %s", rcl_get_error_string().str);
+      rcl_reset_error();
+    }
+  });
+
+  auto response = std::make_shared<action_msgs::srv::CancelGoal::Response>();
+  const size_t num_goals = cancel_response.msg.goals_canceling.size;
+  response->goals_canceling.reserve(num_goals);
+  for (size_t i = 0; i < num_goals; ++i) {
+    const rcl_action_goal_info_t & rcl_goal_info = cancel_response.msg.goals_canceling.data[i];
+    GoalInfo goal_info;
+    convert(rcl_goal_info, &goal_info.uuid);
+    goal_info.stamp.sec = rcl_goal_info.stamp.sec;
+    goal_info.stamp.nanosec = rcl_goal_info.stamp.nanosec;
+    if (call_handle_cancel_callback(goal_info.uuid)) {
+      response->goals_canceling.push_back(goal_info);
+    }
+  }
+
+  ret = rcl_action_send_cancel_response(
+    pimpl_->action_server_.get(), &request_header, response.get());
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+}
+
+void
+ServerBase::execute_result_request_received()
+{
+  rmw_request_id_t request_header;
+  std::shared_ptr<void> request = create_result_request();
+  rcl_ret_t ret = rcl_action_take_result_request(
+    pimpl_->action_server_.get(), &request_header, request.get());
+  if (RCL_RET_ACTION_SERVER_TAKE_FAILED == ret) {
+    rcl_reset_error();
+    return;
+  }
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+
+  GoalID uuid = get_goal_id_from_result_request(request.get());
+  std::shared_ptr<void> result_response;
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->results_mutex_);
+    auto element = pimpl_->goal_results_.find(uuid);
+    if (element != pimpl_->goal_results_.end()) {
+      result_response = element->second;
+    } else {
+      rcl_action_goal_info_t rcl_goal_info = rcl_action_get_zero_initialized_goal_info();
+      convert(uuid, &rcl_goal_info);
+      bool goal_exists;
+      {
+        std::lock_guard<std::mutex> server_lock(pimpl_->server_mutex_);
+        goal_exists = rcl_action_server_goal_exists(pimpl_->action_server_.get(), &rcl_goal_info);
+      }
+      if (goal_exists) {
+        // Answered when the goal reaches a terminal state
+        pimpl_->result_requests_[uuid].push_back(request_header);
+        return;
+      }
+    }
+  }
+  if (!result_response) {
+    result_response = create_result_response(GoalStatus::STATUS_UNKNOWN);
+  }
+  ret = rcl_action_send_result_response(
+    pimpl_->action_server_.get(), &request_header, result_response.get());
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+}
+
+void
+ServerBase::execute_check_expired_goals()
+{
+  // Expire up to 16 goals at a time
+  rcl_action_goal_info_t expired_goals[16];
+  const size_t capacity = sizeof(expired_goals) / sizeof(expired_goals[0]);
+  size_t num_expired = capacity;
+  while (num_expired == capacity) {
+    {
+      std::lock_guard<std::mutex> lock(pimpl_->server_mutex_);
+      rcl_ret_t ret = rcl_action_expire_goals(
+        pimpl_->action_server_.get(), expired_goals, capacity, &num_expired);
+      if (RCL_RET_OK != ret) {
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    }
+    std::lock_guard<std::mutex> lock(pimpl_->results_mutex_);
+    for (size_t i = 0; i < num_expired; ++i) {
+      GoalID uuid;
+      convert(expired_goals[i], &uuid);
+      pimpl_->goal_results_.erase(uuid);
+    }
+  }
+}
+
+rcl_ret_t
+ServerBase::update_goal_state(rcl_action_goal_handle_t * rcl_handle, rcl_action_goal_event_t event)
+{
+  rcl_ret_t ret;
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->server_mutex_);
+    ret = rcl_action_update_goal_state(rcl_handle, event);
+  }
+  if (RCL_RET_OK == ret) {
+    publish_status();
+  }
+  return ret;
+}
+
+void
+ServerBase::publish_status()
+{
+  std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+  {
+    // Copy the status array rcl keeps up to date, the message keeps its capacity
+    std::lock_guard<std::mutex> server_lock(pimpl_->server_mutex_);
+    const rcl_action_goal_status_array_t * status_array = nullptr;
+    bool changed = false;
+    rcl_ret_t ret = rcl_action_update_goal_status_array(
+      pimpl_->action_server_.get(), &status_array, &changed);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+    if (!changed) {
+      return;
+    }
+    const size_t num_goals = status_array->msg.status_list.size;
+    pimpl_->status_msg_.status_list.resize(num_goals);
+    for (size_t i = 0; i < num_goals; ++i) {
+      const rcl_action_goal_status_t & rcl_status = status_array->msg.status_list.data[i];
+      GoalStatus & status = pimpl_->status_msg_.status_list[i];
+      convert(rcl_status.goal_info, &status.goal_info.uuid);
+      status.goal_info.stamp.sec = rcl_status.goal_info.stamp.sec;
+      status.goal_info.stamp.nanosec = rcl_status.goal_info.stamp.nanosec;
+      status.status = rcl_status.status;
+    }
+  }
+  rcl_ret_t ret = rcl_action_publish_status(pimpl_->action_server_.get(), &pimpl_->status_msg_);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+}
+
+void
+ServerBase::publish_feedback(void * feedback_msg)
+{
+  rcl_ret_t ret = rcl_action_publish_feedback(pimpl_->action_server_.get(), feedback_msg);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret, "failed to publish feedback");
+  }
+}
+
+void
+ServerBase::publish_result(const GoalID & uuid, std::shared_ptr<void> result_msg)
+{
+  std::vector<rmw_request_id_t> result_requests;
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->results_mutex_);
+    pimpl_->goal_results_[uuid] = result_msg;
+    auto element = pimpl_->result_requests_.find(uuid);
+    if (element != pimpl_->result_requests_.end()) {
+      result_requests = std::move(element->second);
+      pimpl_->result_requests_.erase(element);
+    }
+  }
+  forget_goal(uuid);
+
+  for (auto & request_header : result_requests) {
+    rcl_ret_t ret = rcl_action_send_result_response(
+      pimpl_->action_server_.get(), &request_header, result_msg.get());
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->server_mutex_);
+    rcl_ret_t ret = rcl_action_notify_goal_done(pimpl_->action_server_.get());
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+  }
+}
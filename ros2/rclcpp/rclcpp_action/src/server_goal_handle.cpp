@@ -13,3 +13,109 @@
 // limitations under the License.
 
 #include <rclcpp_action/server_goal_handle.hpp>
+#include <rclcpp_action/server.hpp>
+
+#include <rcl_action/goal_state_machine.h>
+#include <rclcpp/exceptions.hpp>
+
+#include <memory>
+#include <stdexcept>
+
+using rclcpp_action::ServerGoalHandleBase;
+
+ServerGoalHandleBase::ServerGoalHandleBase(
+  std::weak_ptr<ServerBase> server,
+  rcl_action_goal_handle_t * rcl_handle,
+  const GoalInfo & goal_info)
+: server_(server), goal_info_(goal_info), rcl_handle_(rcl_handle), state_(GOAL_STATE_ACCEPTED)
+{
+}
+
+ServerGoalHandleBase::~ServerGoalHandleBase()
+{
+}
+
+bool
+ServerGoalHandleBase::is_cancel_request() const
+{
+  std::lock_guard<std::mutex> lock(goal_mutex_);
+  return GOAL_STATE_CANCELING == state_;
+}
+
+bool
+ServerGoalHandleBase::is_active() const
+{
+  std::lock_guard<std::mutex> lock(goal_mutex_);
+  return GOAL_STATE_ACCEPTED == state_ || GOAL_STATE_EXECUTING == state_ ||
+         GOAL_STATE_CANCELING == state_;
+}
+
+bool
+ServerGoalHandleBase::is_executing() const
+{
+  std::lock_guard<std::mutex> lock(goal_mutex_);
+  return GOAL_STATE_EXECUTING == state_;
+}
+
+const rclcpp_action::GoalInfo &
+ServerGoalHandleBase::get_goal_info() const
+{
+  return goal_info_;
+}
+
+void
+ServerGoalHandleBase::update_state(rcl_action_goal_event_t event)
+{
+  auto server = server_.lock();
+  std::lock_guard<std::mutex> lock(goal_mutex_);
+  rcl_action_goal_state_t state = rcl_action_transition_goal_state(state_, event);
+  if (GOAL_STATE_UNKNOWN == state) {
+    throw std::runtime_error("invalid transition of the goal state");
+  }
+  if (server) {
+    rcl_ret_t ret = server->update_goal_state(rcl_handle_, event);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "failed to update goal state");
+    }
+  }
+  state_ = state;
+}
+
+bool
+ServerGoalHandleBase::try_canceling()
+{
+  auto server = server_.lock();
+  std::lock_guard<std::mutex> lock(goal_mutex_);
+  if (GOAL_STATE_CANCELING == state_) {
+    return true;
+  }
+  rcl_action_goal_state_t state = rcl_action_transition_goal_state(state_, GOAL_EVENT_CANCEL);
+  if (GOAL_STATE_UNKNOWN == state) {
+    // The goal reached a terminal state meanwhile
+    return false;
+  }
+  if (server && RCL_RET_OK != server->update_goal_state(rcl_handle_, GOAL_EVENT_CANCEL)) {
+    rcl_reset_error();
+    return false;
+  }
+  state_ = state;
+  return true;
+}
+
+void
+ServerGoalHandleBase::publish_feedback_message(void * feedback_msg)
+{
+  auto server = server_.lock();
+  if (server) {
+    server->publish_feedback(feedback_msg);
+  }
+}
+
+void
+ServerGoalHandleBase::publish_result_message(std::shared_ptr<void> result_msg)
+{
+  auto server = server_.lock();
+  if (server) {
+    server->publish_result(goal_info_.uuid, result_msg);
+  }
+}
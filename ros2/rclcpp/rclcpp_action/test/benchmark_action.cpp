@@ -0,0 +1,233 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures an action server executing many goals at once, each of them publishing feedback at
+// 50 Hz from its own thread, as for a fleet of robots each following a path.
+// Goals are sent while the others publish feedback, which measures how long the acceptance of a
+// goal waits on the feedback of the others. The client and the server run in one process, on a
+// multi threaded executor with a reentrant callback group.
+//
+// Usage: benchmark_action [goals] [seconds per goal] [executor threads]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/create_client.hpp"
+#include "rclcpp_action/create_server.hpp"
+#include "test_msgs/action/fibonacci.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+using Fibonacci = test_msgs::action::Fibonacci;
+using ServerGoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+using ClientGoalHandle = rclcpp_action::ClientGoalHandle<Fibonacci>;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// The feedback carries the time it was published at, in microseconds since the start
+int32_t us_since(Clock::time_point start)
+{
+  return static_cast<int32_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+const auto feedback_period = std::chrono::milliseconds(20);
+
+class Latencies
+{
+public:
+  void add(double ms)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples_.push_back(ms);
+  }
+
+  void print(const char * name)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.empty()) {
+      printf("%-18s %8s\n", name, "none");
+      return;
+    }
+    std::sort(samples_.begin(), samples_.end());
+    printf("%-18s %8zu %10.3f %10.3f %10.3f\n", name, samples_.size(),
+      samples_[samples_.size() / 2], samples_[samples_.size() * 99 / 100], samples_.back());
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<double> samples_;
+};
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t num_goals = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100;
+  double seconds_per_goal = argc > 2 ? std::strtod(argv[2], nullptr) : 2.0;
+  size_t num_threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+  if (num_goals == 0 || seconds_per_goal <= 0.0 || num_threads == 0) {
+    fprintf(stderr, "Usage: %s [goals] [seconds per goal] [executor threads]\n", argv[0]);
+    return 1;
+  }
+
+  rclcpp::init(argc, argv);
+  auto node = std::make_shared<rclcpp::Node>("benchmark_action");
+  auto group = node->create_callback_group(rclcpp::callback_group::CallbackGroupType::Reentrant);
+  const auto start = Clock::now();
+
+  std::mutex threads_mutex;
+  std::vector<std::thread> goal_threads;
+  std::atomic<size_t> feedback_sent(0);
+  // The time each goal was done at, set before its result is published
+  std::vector<Clock::time_point> done_times(num_goals);
+  auto execute = [start, seconds_per_goal, &feedback_sent, &done_times](
+    std::shared_ptr<ServerGoalHandle> goal_handle)
+    {
+      goal_handle->set_executing();
+      auto feedback = std::make_shared<Fibonacci::Feedback>();
+      feedback->sequence.resize(1);
+      auto end = Clock::now() + std::chrono::duration<double>(seconds_per_goal);
+      auto next = Clock::now();
+      while (next < end) {
+        feedback->sequence[0] = us_since(start);
+        goal_handle->publish_feedback(feedback);
+        ++feedback_sent;
+        next += feedback_period;
+        std::this_thread::sleep_until(next);
+      }
+      if (goal_handle->goal_->order >= 0) {
+        done_times[goal_handle->goal_->order] = Clock::now();
+      }
+      goal_handle->set_succeeded(std::make_shared<Fibonacci::Result>());
+    };
+  auto server = rclcpp_action::create_server<Fibonacci>(node.get(), "benchmark",
+      [](const rclcpp_action::GoalID &, std::shared_ptr<const Fibonacci::Goal>) {return true;},
+      [](std::shared_ptr<ServerGoalHandle>) {return true;},
+      [&threads_mutex, &goal_threads, execute](std::shared_ptr<ServerGoalHandle> goal_handle)
+      {
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        goal_threads.emplace_back(execute, goal_handle);
+      },
+      rcl_action_server_get_default_options(), group);
+  auto client = rclcpp_action::create_client<Fibonacci>(
+    node.get(), "benchmark", rcl_action_client_get_default_options(), group);
+
+  rclcpp::executors::MultiThreadedExecutor executor(rclcpp::executor::ExecutorArgs(), num_threads);
+  executor.add_node(node);
+  std::thread spin_thread([&executor]() {executor.spin();});
+
+  Latencies acceptance, feedback_latency, result;
+  std::atomic<size_t> feedback_received(0);
+  auto on_feedback = [start, &feedback_latency, &feedback_received](
+    ClientGoalHandle::SharedPtr, std::shared_ptr<const Fibonacci::Feedback> feedback)
+    {
+      feedback_latency.add((us_since(start) - feedback->sequence[0]) / 1000.0);
+      ++feedback_received;
+    };
+
+  // Wait for the discovery of the action server with a first goal, which is not measured
+  {
+    Fibonacci::Goal goal;
+    goal.order = -1;
+    auto goal_future = client->async_send_goal(goal);
+    if (goal_future.wait_for(std::chrono::seconds(10)) != std::future_status::ready ||
+      !goal_future.get())
+    {
+      fprintf(stderr, "The action server was not discovered\n");
+      executor.cancel();
+      spin_thread.join();
+      rclcpp::shutdown();
+      return 1;
+    }
+    goal_future.get()->async_result().wait();
+    feedback_sent = 0;
+  }
+
+  // Spread the goals over the duration of one goal, so they overlap with the feedback of others.
+  // The futures are polled every millisecond, which is the resolution of the latencies.
+  const auto goal_interval = std::chrono::duration<double>(seconds_per_goal / num_goals);
+  const auto sending_start = Clock::now();
+  std::vector<Clock::time_point> sent_times(num_goals);
+  std::vector<std::shared_future<ClientGoalHandle::SharedPtr>> goal_futures(num_goals);
+  std::vector<ClientGoalHandle::SharedPtr> goal_handles(num_goals);
+  size_t sent = 0, answered = 0, rejected = 0, done = 0;
+  while (done + rejected < num_goals) {
+    if (sent < num_goals && Clock::now() >= sending_start + goal_interval * sent) {
+      Fibonacci::Goal goal;
+      goal.order = static_cast<int32_t>(sent);
+      sent_times[sent] = Clock::now();
+      goal_futures[sent] = client->async_send_goal(goal, on_feedback);
+      ++sent;
+    }
+    for (size_t i = answered; i < sent; ++i) {
+      // Goals are answered in the order they are received
+      if (goal_futures[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        break;
+      }
+      goal_handles[i] = goal_futures[i].get();
+      if (goal_handles[i]) {
+        acceptance.add(ms_since(sent_times[i]));
+      } else {
+        ++rejected;
+      }
+      ++answered;
+    }
+    for (size_t i = 0; i < answered; ++i) {
+      if (goal_handles[i] && goal_handles[i]->async_result().wait_for(
+          std::chrono::seconds(0)) == std::future_status::ready)
+      {
+        result.add(ms_since(done_times[i]));
+        goal_handles[i].reset();
+        ++done;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  double total_ms = ms_since(sending_start);
+
+  executor.cancel();
+  spin_thread.join();
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    for (auto & thread : goal_threads) {
+      thread.join();
+    }
+  }
+
+  printf("%zu goals, %.1f s each, %zu executor threads, %zu rejected, %.1f s in total\n",
+    num_goals, seconds_per_goal, num_threads, rejected, total_ms / 1000.0);
+  printf("feedback sent %zu, received %zu, %.1f messages/s\n",
+    feedback_sent.load(), feedback_received.load(), feedback_received * 1000.0 / total_ms);
+  printf("%-18s %8s %10s %10s %10s\n", "latency (ms)", "samples", "median", "p99", "max");
+  acceptance.print("goal acceptance");
+  feedback_latency.print("feedback");
+  result.print("result");
+
+  rclcpp::shutdown();
+  return 0;
+}
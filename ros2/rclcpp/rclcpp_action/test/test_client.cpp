@@ -19,17 +19,29 @@
 #include <rclcpp/rclcpp.hpp>
 #include <test_msgs/action/fibonacci.hpp>
 
+#include <chrono>
+#include <future>
 #include <memory>
+#include <vector>
 
 #include "rclcpp_action/create_client.hpp"
+#include "rclcpp_action/create_server.hpp"
 #include "rclcpp_action/client.hpp"
+#include "rclcpp_action/server.hpp"
+
+using Fibonacci = test_msgs::action::Fibonacci;
+using ServerGoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+using ClientGoalHandle = rclcpp_action::ClientGoalHandle<Fibonacci>;
 
 class TestClient : public ::testing::Test
 {
 protected:
   static void SetUpTestCase()
   {
-    rclcpp::init(0, nullptr);
+    // Also run for the fixtures derived from this one
+    if (!rclcpp::ok()) {
+      rclcpp::init(0, nullptr);
+    }
   }
 };
 
@@ -40,3 +52,115 @@ TEST_F(TestClient, construction_and_destruction)
   auto ac = rclcpp_action::create_client<test_msgs::action::Fibonacci>(node.get(), "fibonacci");
   (void)ac;
 }
+
+class TestClientServer : public TestClient
+{
+protected:
+  void SetUp()
+  {
+    node = std::make_shared<rclcpp::Node>("client_server_node", "/rclcpp_action/test");
+    server = rclcpp_action::create_server<Fibonacci>(node.get(), "fibonacci",
+        [](const rclcpp_action::GoalID &, std::shared_ptr<const Fibonacci::Goal> goal)
+        {
+          return goal->order >= 0;
+        },
+        [](std::shared_ptr<ServerGoalHandle>) {return true;},
+        [this](std::shared_ptr<ServerGoalHandle> goal_handle)
+        {
+          accepted_goal = goal_handle;
+        });
+    client = rclcpp_action::create_client<Fibonacci>(node.get(), "fibonacci");
+  }
+
+  void TearDown()
+  {
+    accepted_goal.reset();
+    client.reset();
+    server.reset();
+    node.reset();
+  }
+
+  // Allow for the discovery of the action server on the first request
+  template<typename FutureT>
+  bool spin_until_ready(FutureT & future)
+  {
+    return rclcpp::spin_until_future_complete(node, future, std::chrono::seconds(5)) ==
+           rclcpp::executor::FutureReturnCode::SUCCESS;
+  }
+
+  ClientGoalHandle::SharedPtr send_goal(int order, ClientGoalHandle::FeedbackCallback callback)
+  {
+    Fibonacci::Goal goal;
+    goal.order = order;
+    auto future = client->async_send_goal(goal, callback);
+    if (!spin_until_ready(future)) {
+      ADD_FAILURE() << "goal response not received";
+      return nullptr;
+    }
+    return future.get();
+  }
+
+  rclcpp::Node::SharedPtr node;
+  rclcpp_action::Server<Fibonacci>::SharedPtr server;
+  rclcpp_action::Client<Fibonacci>::SharedPtr client;
+  std::shared_ptr<ServerGoalHandle> accepted_goal;
+};
+
+TEST_F(TestClientServer, goal_feedback_and_result)
+{
+  std::promise<std::vector<int32_t>> feedback_promise;
+  std::shared_future<std::vector<int32_t>> feedback_future(feedback_promise.get_future());
+  auto goal_handle = send_goal(3,
+      [&feedback_promise](
+        ClientGoalHandle::SharedPtr, std::shared_ptr<const Fibonacci::Feedback> feedback)
+      {
+        feedback_promise.set_value(feedback->sequence);
+      });
+  ASSERT_NE(nullptr, goal_handle);
+  ASSERT_NE(nullptr, accepted_goal);
+  EXPECT_EQ(goal_handle->get_goal_id(), accepted_goal->get_goal_info().uuid);
+  EXPECT_EQ(3, accepted_goal->goal_->order);
+
+  accepted_goal->set_executing();
+  auto feedback = std::make_shared<Fibonacci::Feedback>();
+  feedback->sequence = {0, 1};
+  accepted_goal->publish_feedback(feedback);
+  ASSERT_TRUE(spin_until_ready(feedback_future));
+  EXPECT_EQ(feedback->sequence, feedback_future.get());
+
+  auto result = std::make_shared<Fibonacci::Result>();
+  result->sequence = {0, 1, 1, 2};
+  accepted_goal->set_succeeded(result);
+
+  auto result_future = goal_handle->async_result();
+  ASSERT_TRUE(spin_until_ready(result_future));
+  EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_SUCCEEDED, result_future.get()->status);
+  EXPECT_EQ(result->sequence, result_future.get()->sequence);
+  EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_SUCCEEDED, goal_handle->get_status());
+  EXPECT_FALSE(accepted_goal->is_active());
+}
+
+TEST_F(TestClientServer, goal_rejected)
+{
+  auto goal_handle = send_goal(-1, nullptr);
+  EXPECT_EQ(nullptr, goal_handle);
+  EXPECT_EQ(nullptr, accepted_goal);
+}
+
+TEST_F(TestClientServer, goal_canceled)
+{
+  auto goal_handle = send_goal(5, nullptr);
+  ASSERT_NE(nullptr, goal_handle);
+  ASSERT_NE(nullptr, accepted_goal);
+  accepted_goal->set_executing();
+
+  auto cancel_future = client->async_cancel_goal(goal_handle);
+  ASSERT_TRUE(spin_until_ready(cancel_future));
+  ASSERT_EQ(1u, cancel_future.get()->goals_canceling.size());
+  EXPECT_TRUE(accepted_goal->is_cancel_request());
+
+  accepted_goal->set_canceled(std::make_shared<Fibonacci::Result>());
+  auto result_future = goal_handle->async_result();
+  ASSERT_TRUE(spin_until_ready(result_future));
+  EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_CANCELED, result_future.get()->status);
+}
@@ -40,7 +40,30 @@ TEST_F(TestServer, construction_and_destruction)
 
   using GoalHandle = rclcpp_action::ServerGoalHandle<test_msgs::action::Fibonacci>;
   auto as = rclcpp_action::create_server<test_msgs::action::Fibonacci>(node.get(), "fibonacci",
-      [](rcl_action_goal_info_t &, test_msgs::action::Fibonacci::Goal *) {},
+      [](const rclcpp_action::GoalID &, std::shared_ptr<const test_msgs::action::Fibonacci::Goal>)
+      {
+        return true;
+      },
+      [](std::shared_ptr<GoalHandle>) {return true;},
       [](std::shared_ptr<GoalHandle>) {});
   (void)as;
 }
+
+TEST_F(TestServer, waitables_added_to_node)
+{
+  auto node = std::make_shared<rclcpp::Node>("waitables_node", "/rclcpp_action/test/server");
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<test_msgs::action::Fibonacci>;
+  auto as = rclcpp_action::create_server<test_msgs::action::Fibonacci>(node.get(), "fibonacci",
+      [](const rclcpp_action::GoalID &, std::shared_ptr<const test_msgs::action::Fibonacci::Goal>)
+      {
+        return true;
+      },
+      [](std::shared_ptr<GoalHandle>) {return true;},
+      [](std::shared_ptr<GoalHandle>) {});
+
+  // Goal, cancel and result services and the expire timer are executed separately
+  ASSERT_EQ(4u, as->get_waitables().size());
+  auto group = node->get_node_base_interface()->get_default_callback_group();
+  EXPECT_EQ(4u, group->get_waitable_ptrs().size());
+}
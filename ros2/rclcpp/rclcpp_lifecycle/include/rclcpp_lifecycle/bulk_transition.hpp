@@ -0,0 +1,49 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP_LIFECYCLE__BULK_TRANSITION_HPP_
+#define RCLCPP_LIFECYCLE__BULK_TRANSITION_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "rclcpp_lifecycle/visibility_control.h"
+
+namespace rclcpp_lifecycle
+{
+
+/// Trigger a transition on many lifecycle nodes of this process in parallel.
+/**
+ * Meant for orchestrators which bring up many managed nodes at startup.
+ * Each node goes through the transition, its callbacks included, on one of the threads.
+ * The nodes must be distinct, and must not be transitioned from elsewhere meanwhile.
+ *
+ * \param[in] nodes the nodes to transition
+ * \param[in] transition_id id of the transition, see lifecycle_msgs::msg::Transition
+ * \param[in] number_of_threads threads to use, 0 to use as many as there are cores
+ * \return the callback return code of each node, in the order of the nodes.
+ *   It is ERROR for a node whose current state has no such transition.
+ */
+RCLCPP_LIFECYCLE_PUBLIC
+std::vector<node_interfaces::LifecycleNodeInterface::CallbackReturn>
+trigger_transition(
+  const std::vector<LifecycleNode::SharedPtr> & nodes,
+  uint8_t transition_id,
+  size_t number_of_threads = 0);
+
+}  // namespace rclcpp_lifecycle
+
+#endif  // RCLCPP_LIFECYCLE__BULK_TRANSITION_HPP_
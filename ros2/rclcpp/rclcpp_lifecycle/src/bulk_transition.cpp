@@ -0,0 +1,62 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp_lifecycle/bulk_transition.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace rclcpp_lifecycle
+{
+
+std::vector<node_interfaces::LifecycleNodeInterface::CallbackReturn>
+trigger_transition(
+  const std::vector<LifecycleNode::SharedPtr> & nodes,
+  uint8_t transition_id,
+  size_t number_of_threads)
+{
+  using CallbackReturn = node_interfaces::LifecycleNodeInterface::CallbackReturn;
+  std::vector<CallbackReturn> cb_return_codes(nodes.size(), CallbackReturn::ERROR);
+
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  number_of_threads = std::min(number_of_threads, nodes.size());
+
+  // Each thread takes the next node, so slow callbacks don't hold up the other nodes
+  std::atomic<size_t> next_node(0);
+  auto transition_nodes =
+    [&nodes, &cb_return_codes, &next_node, transition_id]()
+    {
+      for (size_t i = next_node++; i < nodes.size(); i = next_node++) {
+        nodes[i]->trigger_transition(transition_id, cb_return_codes[i]);
+      }
+    };
+
+  std::vector<std::thread> threads;
+  // The calling thread is one of them
+  for (size_t i = 1; i < number_of_threads; ++i) {
+    threads.emplace_back(transition_nodes);
+  }
+  transition_nodes();
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  return cb_return_codes;
+}
+
+}  // namespace rclcpp_lifecycle
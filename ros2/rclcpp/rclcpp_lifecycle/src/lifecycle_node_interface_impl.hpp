@@ -213,8 +213,9 @@ public:
     // can be different.
     // the result of this is that the label takes presedence of the id.
     if (req->transition.label.size() != 0) {
-      auto rcl_transition = rcl_lifecycle_get_transition_by_label(
-        state_machine_.current_state, req->transition.label.c_str());
+      auto rcl_transition = rcl_lifecycle_transition_map_find_by_label(
+        &state_machine_.transition_map, state_machine_.current_state,
+        req->transition.label.c_str());
       if (rcl_transition == nullptr) {
         resp->success = false;
         return;
@@ -448,8 +449,8 @@ public:
   const State & trigger_transition(
     const char * transition_label, LifecycleNodeInterface::CallbackReturn & cb_return_code)
   {
-    auto transition =
-      rcl_lifecycle_get_transition_by_label(state_machine_.current_state, transition_label);
+    auto transition = rcl_lifecycle_transition_map_find_by_label(
+      &state_machine_.transition_map, state_machine_.current_state, transition_label);
     if (transition) {
       change_state(transition->id, cb_return_code);
     }
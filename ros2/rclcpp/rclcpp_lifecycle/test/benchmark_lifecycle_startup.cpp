@@ -0,0 +1,125 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Measures the startup of many lifecycle nodes in one process, as done by an orchestrator
+// bringing up a robot: creating the nodes, then configuring and activating them one after the
+// other or in parallel with rclcpp_lifecycle::trigger_transition().
+// Also measures a single transition, which finds the transition in the state machine of the node
+// and publishes a TransitionEvent.
+//
+// Usage: benchmark_lifecycle_startup [nodes] [threads]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lifecycle_msgs/msg/transition.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_lifecycle/bulk_transition.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+using Transition = lifecycle_msgs::msg::Transition;
+using Nodes = std::vector<rclcpp_lifecycle::LifecycleNode::SharedPtr>;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+Nodes create_nodes(size_t number_of_nodes, const std::string & prefix)
+{
+  Nodes nodes;
+  for (size_t i = 0; i < number_of_nodes; ++i) {
+    nodes.push_back(std::make_shared<rclcpp_lifecycle::LifecycleNode>(
+        prefix + std::to_string(i)));
+  }
+  return nodes;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t number_of_nodes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+  size_t number_of_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+  if (number_of_nodes == 0) {
+    fprintf(stderr, "Usage: %s [nodes] [threads]\n", argv[0]);
+    return 1;
+  }
+  rclcpp::init(argc, argv);
+
+  printf("%zu lifecycle nodes\n", number_of_nodes);
+  printf("%-32s %12s %12s\n", "step", "total (ms)", "per node (us)");
+  auto print = [number_of_nodes](const char * step, double ms) {
+      printf("%-32s %12.3f %12.3f\n", step, ms, ms * 1000.0 / number_of_nodes);
+    };
+
+  {
+    auto start = Clock::now();
+    Nodes nodes = create_nodes(number_of_nodes, "sequential_");
+    print("create", ms_since(start));
+
+    start = Clock::now();
+    for (auto & node : nodes) {
+      node->configure();
+    }
+    print("configure, one after the other", ms_since(start));
+
+    start = Clock::now();
+    for (auto & node : nodes) {
+      node->activate();
+    }
+    print("activate, one after the other", ms_since(start));
+  }
+
+  {
+    Nodes nodes = create_nodes(number_of_nodes, "parallel_");
+    auto start = Clock::now();
+    rclcpp_lifecycle::trigger_transition(
+      nodes, Transition::TRANSITION_CONFIGURE, number_of_threads);
+    print("configure, in parallel", ms_since(start));
+
+    start = Clock::now();
+    rclcpp_lifecycle::trigger_transition(
+      nodes, Transition::TRANSITION_ACTIVATE, number_of_threads);
+    print("activate, in parallel", ms_since(start));
+  }
+
+  {
+    // Deactivate and activate one node again and again
+    auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("single");
+    node->configure();
+    const size_t iterations = 10000;
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+      node->activate();
+      node->deactivate();
+    }
+    double ms = ms_since(start);
+    printf("%-32s %12.3f us per transition\n", "activate and deactivate",
+      ms * 1000.0 / (2 * iterations));
+  }
+
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,92 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lifecycle_msgs/msg/state.hpp"
+#include "lifecycle_msgs/msg/transition.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_lifecycle/bulk_transition.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+
+using lifecycle_msgs::msg::State;
+using lifecycle_msgs::msg::Transition;
+using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+
+class TestBulkTransition : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  std::vector<rclcpp_lifecycle::LifecycleNode::SharedPtr>
+  create_nodes(size_t number_of_nodes)
+  {
+    std::vector<rclcpp_lifecycle::LifecycleNode::SharedPtr> nodes;
+    for (size_t i = 0; i < number_of_nodes; ++i) {
+      nodes.push_back(std::make_shared<rclcpp_lifecycle::LifecycleNode>(
+          "bulk_node_" + std::to_string(i)));
+    }
+    return nodes;
+  }
+};
+
+TEST_F(TestBulkTransition, configure_and_activate) {
+  auto nodes = create_nodes(20);
+
+  auto cb_return_codes = rclcpp_lifecycle::trigger_transition(
+    nodes, Transition::TRANSITION_CONFIGURE, 4);
+  ASSERT_EQ(nodes.size(), cb_return_codes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    EXPECT_EQ(CallbackReturn::SUCCESS, cb_return_codes[i]);
+    EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, nodes[i]->get_current_state().id());
+  }
+
+  cb_return_codes = rclcpp_lifecycle::trigger_transition(nodes, Transition::TRANSITION_ACTIVATE);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    EXPECT_EQ(CallbackReturn::SUCCESS, cb_return_codes[i]);
+    EXPECT_EQ(State::PRIMARY_STATE_ACTIVE, nodes[i]->get_current_state().id());
+  }
+}
+
+TEST_F(TestBulkTransition, failures_stay_per_node) {
+  auto nodes = create_nodes(8);
+  nodes[3]->register_on_configure(
+    [](const rclcpp_lifecycle::State &) {return CallbackReturn::FAILURE;});
+  // Not a valid transition from the unconfigured state
+  nodes[5]->configure();
+
+  auto cb_return_codes = rclcpp_lifecycle::trigger_transition(
+    nodes, Transition::TRANSITION_CONFIGURE, 3);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (i == 3) {
+      EXPECT_EQ(CallbackReturn::FAILURE, cb_return_codes[i]);
+      EXPECT_EQ(State::PRIMARY_STATE_UNCONFIGURED, nodes[i]->get_current_state().id());
+    } else if (i == 5) {
+      EXPECT_EQ(CallbackReturn::ERROR, cb_return_codes[i]);
+      EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, nodes[i]->get_current_state().id());
+    } else {
+      EXPECT_EQ(CallbackReturn::SUCCESS, cb_return_codes[i]);
+      EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, nodes[i]->get_current_state().id());
+    }
+  }
+}
@@ -34,17 +34,6 @@ g_wait_set_spinning_lock = Lock()
 g_wait_set_spinning = False
 
 
-class _WaitSet:
-    """Make sure the wait set gets destroyed when a generator exits."""
-
-    def __enter__(self):
-        self.wait_set = _rclpy.rclpy_get_zero_initialized_wait_set()
-        return self.wait_set
-
-    def __exit__(self, t, v, tb):
-        _rclpy.rclpy_destroy_wait_set(self.wait_set)
-
-
 class _WorkTracker:
     """Track the amount of work that is in progress."""
 
@@ -131,6 +120,8 @@ class Executor:
         self._cb_iter = None
         self._last_args = None
         self._last_kwargs = None
+        # Wait set reused by every spin, only resized when the number of entities changes
+        self._wait_set = _rclpy.rclpy_get_zero_initialized_wait_set()
 
     @property
     def context(self):
@@ -179,6 +170,8 @@ class Executor:
     def __del__(self):
         if self._guard_condition is not None:
             _rclpy.rclpy_destroy_entity(self._guard_condition)
+        # The wait set is not destroyed by shutdown() since another thread may be waiting on it
+        _rclpy.rclpy_destroy_wait_set(self._wait_set)
 
     def add_node(self, node):
         """
@@ -370,9 +363,10 @@ class Executor:
                 # Get rid of any tasks that are done
                 self._tasks = list(filter(lambda t_e_n: not t_e_n[0].done(), self._tasks))
 
+        wait_set = self._wait_set
         yielded_work = False
         while not yielded_work and not self._is_shutdown:
-            # Gather entities that can be waited on
+            # Gather entities that can be waited on, with the node they belong to
             subscriptions = []
             guards = []
             timers = []
@@ -380,134 +374,127 @@ class Executor:
             services = []
             waitables = []
             for node in nodes:
-                subscriptions.extend(filter(self.can_execute, node.subscriptions))
-                timers.extend(filter(self.can_execute, node.timers))
-                clients.extend(filter(self.can_execute, node.clients))
-                services.extend(filter(self.can_execute, node.services))
-                node_guards = filter(self.can_execute, node.guards)
+                subscriptions.extend((e, node) for e in node.subscriptions if self.can_execute(e))
+                timers.extend((e, node) for e in node.timers if self.can_execute(e))
+                clients.extend((e, node) for e in node.clients if self.can_execute(e))
+                services.extend((e, node) for e in node.services if self.can_execute(e))
                 waitables.extend(filter(self.can_execute, node.waitables))
-                # retrigger a guard condition that was triggered but not handled
-                for gc in node_guards:
-                    if gc._executor_triggered:
-                        gc.trigger()
-                    guards.append(gc)
+                for gc in node.guards:
+                    if self.can_execute(gc):
+                        # retrigger a guard condition that was triggered but not handled
+                        if gc._executor_triggered:
+                            gc.trigger()
+                        guards.append((gc, node))
+
+            timer_handles = [tmr.timer_handle for tmr, _ in timers]
             if timeout_timer is not None:
-                timers.append(timeout_timer)
+                timer_handles.append(timeout_timer.timer_handle)
 
             node_entity_count = NumberOfEntities(
-                len(subscriptions), len(guards), len(timers), len(clients), len(services))
+                len(subscriptions), len(guards), len(timer_handles), len(clients), len(services))
             executor_entity_count = NumberOfEntities(0, 2, 0, 0, 0)
             entity_count = node_entity_count + executor_entity_count
             for waitable in waitables:
                 entity_count += waitable.get_num_entities()
 
-            # Construct a wait set
-            with _WaitSet() as wait_set:
-                _rclpy.rclpy_wait_set_init(
-                    wait_set,
-                    entity_count.num_subscriptions,
-                    entity_count.num_guard_conditions,
-                    entity_count.num_timers,
-                    entity_count.num_clients,
-                    entity_count.num_services)
-
-                entities = {
-                    'subscription': (subscriptions, 'subscription_handle'),
-                    'guard_condition': (guards, 'guard_handle'),
-                    'client': (clients, 'client_handle'),
-                    'service': (services, 'service_handle'),
-                    'timer': (timers, 'timer_handle'),
-                }
-                _rclpy.rclpy_wait_set_clear_entities(wait_set)
-                for entity, (handles, handle_name) in entities.items():
-                    for h in handles:
-                        _rclpy.rclpy_wait_set_add_entity(
-                            entity, wait_set, h.__getattribute__(handle_name)
-                        )
-                for waitable in waitables:
-                    waitable.add_to_wait_set(wait_set)
-                (sigint_gc, sigint_gc_handle) = \
-                    _rclpy.rclpy_get_sigint_guard_condition(self._context.handle)
-                try:
-                    _rclpy.rclpy_wait_set_add_entity('guard_condition', wait_set, sigint_gc)
-                    _rclpy.rclpy_wait_set_add_entity(
-                        'guard_condition', wait_set, self._guard_condition)
-
-                    # Wait for something to become ready
-                    _rclpy.rclpy_wait(wait_set, timeout_nsec)
-
-                    # get ready entities
-                    subs_ready = _rclpy.rclpy_get_ready_entities('subscription', wait_set)
-                    guards_ready = _rclpy.rclpy_get_ready_entities('guard_condition', wait_set)
-                    timers_ready = _rclpy.rclpy_get_ready_entities('timer', wait_set)
-                    clients_ready = _rclpy.rclpy_get_ready_entities('client', wait_set)
-                    services_ready = _rclpy.rclpy_get_ready_entities('service', wait_set)
-                finally:
-                    _rclpy.rclpy_destroy_entity(sigint_gc)
-
-                # Mark all guards as triggered before yielding since they're auto-taken
-                for gc in guards:
-                    if gc.guard_pointer in guards_ready:
-                        gc._executor_triggered = True
-
-                # Check waitables before wait set is destroyed
-                for node in nodes:
-                    for wt in node.waitables:
-                        if wt.is_ready(wait_set):
-                            handler = self._make_handler(
-                                wt, node, lambda e: e.take_data(), lambda e, a: e.execute(a))
-                            yielded_work = True
-                            yield handler, wt, node
-
-            # Process ready entities one node at a time
-            for node in nodes:
-                for tmr in node.timers:
-                    if tmr.timer_pointer in timers_ready:
-                        # Check that a timer is ready to workaround rcl issue with cancelled timers
-                        if _rclpy.rclpy_is_timer_ready(tmr.timer_handle):
-                            if tmr.callback_group.can_execute(tmr):
-                                handler = self._make_handler(
-                                    tmr, node, self._take_timer, self._execute_timer)
-                                yielded_work = True
-                                yield handler, tmr, node
-
-                for sub in node.subscriptions:
-                    if sub.subscription_pointer in subs_ready:
-                        if sub.callback_group.can_execute(sub):
-                            handler = self._make_handler(
-                                sub, node, self._take_subscription, self._execute_subscription)
-                            yielded_work = True
-                            yield handler, sub, node
+            # Populate the wait set, entities of the nodes come first so that their index in the
+            # lists above is also their index in the wait set
+            _rclpy.rclpy_wait_set_resize(
+                wait_set,
+                entity_count.num_subscriptions,
+                entity_count.num_guard_conditions,
+                entity_count.num_timers,
+                entity_count.num_clients,
+                entity_count.num_services)
+            _rclpy.rclpy_wait_set_add_entities(
+                'subscription', wait_set, [sub.subscription_handle for sub, _ in subscriptions])
+            _rclpy.rclpy_wait_set_add_entities(
+                'guard_condition', wait_set, [gc.guard_handle for gc, _ in guards])
+            _rclpy.rclpy_wait_set_add_entities('timer', wait_set, timer_handles)
+            _rclpy.rclpy_wait_set_add_entities(
+                'client', wait_set, [client.client_handle for client, _ in clients])
+            _rclpy.rclpy_wait_set_add_entities(
+                'service', wait_set, [srv.service_handle for srv, _ in services])
+            for waitable in waitables:
+                waitable.add_to_wait_set(wait_set)
+            (sigint_gc, sigint_gc_handle) = \
+                _rclpy.rclpy_get_sigint_guard_condition(self._context.handle)
+            try:
+                _rclpy.rclpy_wait_set_add_entities(
+                    'guard_condition', wait_set, [sigint_gc, self._guard_condition])
 
-                for gc in node.guards:
-                    if gc._executor_triggered:
-                        if gc.callback_group.can_execute(gc):
-                            handler = self._make_handler(
-                                gc, node, self._take_guard_condition,
-                                self._execute_guard_condition)
-                            yielded_work = True
-                            yield handler, gc, node
-
-                for client in node.clients:
-                    if client.client_pointer in clients_ready:
-                        if client.callback_group.can_execute(client):
-                            handler = self._make_handler(
-                                client, node, self._take_client, self._execute_client)
-                            yielded_work = True
-                            yield handler, client, node
-
-                for srv in node.services:
-                    if srv.service_pointer in services_ready:
-                        if srv.callback_group.can_execute(srv):
-                            handler = self._make_handler(
-                                srv, node, self._take_service, self._execute_service)
-                            yielded_work = True
-                            yield handler, srv, node
+                # Wait for something to become ready
+                _rclpy.rclpy_wait(wait_set, timeout_nsec)
+
+                # get the indices of ready entities
+                subs_ready, guards_ready, timers_ready, clients_ready, services_ready = \
+                    _rclpy.rclpy_wait_set_get_ready_indices(wait_set)
+            finally:
+                _rclpy.rclpy_destroy_entity(sigint_gc)
+
+            # Mark all guards as triggered before yielding since they're auto-taken
+            for i in guards_ready:
+                if i < len(guards):
+                    guards[i][0]._executor_triggered = True
+
+            # Check waitables before the wait set is reused
+            for node in nodes:
+                for wt in node.waitables:
+                    if wt.is_ready(wait_set):
+                        handler = self._make_handler(
+                            wt, node, lambda e: e.take_data(), lambda e, a: e.execute(a))
+                        yielded_work = True
+                        yield handler, wt, node
+
+            # Process ready entities
+            for i in timers_ready:
+                if i < len(timers):
+                    tmr, node = timers[i]
+                    if tmr.callback_group.can_execute(tmr):
+                        handler = self._make_handler(
+                            tmr, node, self._take_timer, self._execute_timer)
+                        yielded_work = True
+                        yield handler, tmr, node
+
+            for i in subs_ready:
+                if i < len(subscriptions):
+                    sub, node = subscriptions[i]
+                    if sub.callback_group.can_execute(sub):
+                        handler = self._make_handler(
+                            sub, node, self._take_subscription, self._execute_subscription)
+                        yielded_work = True
+                        yield handler, sub, node
+
+            for gc, node in guards:
+                if gc._executor_triggered:
+                    if gc.callback_group.can_execute(gc):
+                        handler = self._make_handler(
+                            gc, node, self._take_guard_condition, self._execute_guard_condition)
+                        yielded_work = True
+                        yield handler, gc, node
+
+            for i in clients_ready:
+                if i < len(clients):
+                    client, node = clients[i]
+                    if client.callback_group.can_execute(client):
+                        handler = self._make_handler(
+                            client, node, self._take_client, self._execute_client)
+                        yielded_work = True
+                        yield handler, client, node
+
+            for i in services_ready:
+                if i < len(services):
+                    srv, node = services[i]
+                    if srv.callback_group.can_execute(srv):
+                        handler = self._make_handler(
+                            srv, node, self._take_service, self._execute_service)
+                        yielded_work = True
+                        yield handler, srv, node
 
             # Check timeout timer
             if (
                 timeout_nsec == 0 or
-                (timeout_timer is not None and timeout_timer.timer_pointer in timers_ready)
+                (timeout_timer is not None and len(timers) in timers_ready)
             ):
                 raise TimeoutException()
 
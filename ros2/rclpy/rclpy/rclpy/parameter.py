@@ -79,9 +79,9 @@ class Parameter:
         elif Parameter.Type.BOOL_ARRAY == type_:
             value = param_msg.value.bool_array_value
         elif Parameter.Type.INTEGER_ARRAY == type_:
-            value = param_msg.value.integer_array_value
+            value = param_msg.value.integer_array_value.tolist()
         elif Parameter.Type.DOUBLE_ARRAY == type_:
-            value = param_msg.value.double_array_value
+            value = param_msg.value.double_array_value.tolist()
         elif Parameter.Type.STRING_ARRAY == type_:
             value = param_msg.value.string_array_value
         return cls(param_msg.name, type_, value)
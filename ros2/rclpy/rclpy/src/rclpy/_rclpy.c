@@ -2304,6 +2304,71 @@ rclpy_wait_set_init(PyObject * Py_UNUSED(self), PyObject * args)
   Py_RETURN_NONE;
 }
 
+/// Prepare a wait set to be filled with the given number of entities
+/**
+ * The wait set is initialized on the first call.
+ * Later calls only reallocate it when the number of entities changes and otherwise just clear
+ * it, so that the same wait set can be reused by every spin of an executor.
+ *
+ * Raises RuntimeError if the wait set could not be initialized, resized or cleared
+ *
+ * \param[in] pywait_set Capsule pointing to the wait set structure
+ * \param[in] number_of_subscriptions int
+ * \param[in] number_of_guard_conditions int
+ * \param[in] number_of_timers int
+ * \param[in] number_of_clients int
+ * \param[in] number_of_services int
+ * \return None
+ */
+static PyObject *
+rclpy_wait_set_resize(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pywait_set;
+  unsigned PY_LONG_LONG number_of_subscriptions;
+  unsigned PY_LONG_LONG number_of_guard_conditions;
+  unsigned PY_LONG_LONG number_of_timers;
+  unsigned PY_LONG_LONG number_of_clients;
+  unsigned PY_LONG_LONG number_of_services;
+
+  if (!PyArg_ParseTuple(
+      args, "OKKKKK", &pywait_set, &number_of_subscriptions,
+      &number_of_guard_conditions, &number_of_timers,
+      &number_of_clients, &number_of_services))
+  {
+    return NULL;
+  }
+
+  rcl_wait_set_t * wait_set = (rcl_wait_set_t *)PyCapsule_GetPointer(pywait_set, "rcl_wait_set_t");
+  if (!wait_set) {
+    return NULL;
+  }
+  rcl_ret_t ret;
+  if (NULL == wait_set->impl) {
+    ret = rcl_wait_set_init(
+      wait_set, number_of_subscriptions, number_of_guard_conditions, number_of_timers,
+      number_of_clients, number_of_services, rcl_get_default_allocator());
+  } else if (
+    wait_set->size_of_subscriptions == number_of_subscriptions &&
+    wait_set->size_of_guard_conditions == number_of_guard_conditions &&
+    wait_set->size_of_timers == number_of_timers &&
+    wait_set->size_of_clients == number_of_clients &&
+    wait_set->size_of_services == number_of_services)
+  {
+    ret = rcl_wait_set_clear(wait_set);
+  } else {
+    ret = rcl_wait_set_resize(
+      wait_set, number_of_subscriptions, number_of_guard_conditions, number_of_timers,
+      number_of_clients, number_of_services);
+  }
+  if (ret != RCL_RET_OK) {
+    PyErr_Format(PyExc_RuntimeError,
+      "Failed to resize wait set: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
 /// Clear all the pointers in the wait set
 /**
  * Raises RuntimeError if any rcl error occurs
@@ -2394,6 +2459,80 @@ rclpy_wait_set_add_entity(PyObject * Py_UNUSED(self), PyObject * args)
   return PyLong_FromSize_t(index);
 }
 
+#define ADD_ENTITIES(ENTITY_TYPE) \
+  for (Py_ssize_t i = 0; i < num_entities; ++i) { \
+    rcl_ ## ENTITY_TYPE ## _t * entity = (rcl_ ## ENTITY_TYPE ## _t *)PyCapsule_GetPointer( \
+      entities[i], "rcl_" #ENTITY_TYPE "_t"); \
+    if (!entity) { \
+      Py_DECREF(pyentities_fast); \
+      return NULL; \
+    } \
+    ret = rcl_wait_set_add_ ## ENTITY_TYPE(wait_set, entity, NULL); \
+    if (ret != RCL_RET_OK) { \
+      break; \
+    } \
+  }
+/// Add a sequence of entities of the same type to the wait set structure
+/**
+ * The entities are added in order, so the index of an entity in the sequence is also its index
+ * in the wait set if the wait set was empty.
+ *
+ * Raises RuntimeError if the entity type is unknown or any rcl error occurrs
+ * Raises TypeError if pyentities is not a sequence
+ *
+ * \param[in] entity_type string defining the entity ["subscription, client, service"]
+ * \param[in] pywait_set Capsule pointing to the wait set structure
+ * \param[in] pyentities sequence of Capsules pointing to the entities to add
+ * \return None
+ */
+static PyObject *
+rclpy_wait_set_add_entities(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  const char * entity_type;
+  PyObject * pywait_set;
+  PyObject * pyentities;
+
+  if (!PyArg_ParseTuple(args, "zOO", &entity_type, &pywait_set, &pyentities)) {
+    return NULL;
+  }
+  rcl_wait_set_t * wait_set = (rcl_wait_set_t *)PyCapsule_GetPointer(pywait_set, "rcl_wait_set_t");
+  if (!wait_set) {
+    return NULL;
+  }
+  PyObject * pyentities_fast = PySequence_Fast(pyentities, "expected a sequence of entities");
+  if (!pyentities_fast) {
+    return NULL;
+  }
+  Py_ssize_t num_entities = PySequence_Fast_GET_SIZE(pyentities_fast);
+  PyObject ** entities = PySequence_Fast_ITEMS(pyentities_fast);
+
+  rcl_ret_t ret = RCL_RET_OK;
+  if (0 == strcmp(entity_type, "subscription")) {
+    ADD_ENTITIES(subscription)
+  } else if (0 == strcmp(entity_type, "client")) {
+    ADD_ENTITIES(client)
+  } else if (0 == strcmp(entity_type, "service")) {
+    ADD_ENTITIES(service)
+  } else if (0 == strcmp(entity_type, "timer")) {
+    ADD_ENTITIES(timer)
+  } else if (0 == strcmp(entity_type, "guard_condition")) {
+    ADD_ENTITIES(guard_condition)
+  } else {
+    Py_DECREF(pyentities_fast);
+    PyErr_Format(PyExc_RuntimeError,
+      "'%s' is not a known entity", entity_type);
+    return NULL;
+  }
+  Py_DECREF(pyentities_fast);
+  if (ret != RCL_RET_OK) {
+    PyErr_Format(PyExc_RuntimeError,
+      "Failed to add '%s' to wait set: %s", entity_type, rcl_get_error_string().str);
+    rcl_reset_error();
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
 /// Check if an entity in the wait set is ready by its index
 /**
  * This must be called after waiting on the wait set.
@@ -2561,6 +2700,111 @@ rclpy_get_ready_entities(PyObject * Py_UNUSED(self), PyObject * args)
   return NULL;
 }
 
+/// Append the indices of the non-null entries of a wait set array to a list
+static bool
+_rclpy_append_ready_indices(PyObject * pylist, const void ** entities, size_t num_entities)
+{
+  for (size_t idx = 0; idx < num_entities; ++idx) {
+    if (NULL == entities[idx]) {
+      continue;
+    }
+    PyObject * pyindex = PyLong_FromSize_t(idx);
+    if (!pyindex) {
+      return false;
+    }
+    int rc = PyList_Append(pylist, pyindex);
+    Py_DECREF(pyindex);
+    if (rc) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Append the indices of the timers of a wait set which are still ready to a list
+static bool
+_rclpy_append_ready_timer_indices(PyObject * pylist, const rcl_wait_set_t * wait_set)
+{
+  for (size_t idx = 0; idx < wait_set->size_of_timers; ++idx) {
+    if (NULL == wait_set->timers[idx]) {
+      continue;
+    }
+    // Work around rcl reporting canceled timers as ready
+    bool is_ready = false;
+    if (rcl_timer_is_ready(wait_set->timers[idx], &is_ready) != RCL_RET_OK) {
+      PyErr_Format(PyExc_RuntimeError,
+        "Failed to check timer ready: %s", rcl_get_error_string().str);
+      rcl_reset_error();
+      return false;
+    }
+    if (!is_ready) {
+      continue;
+    }
+    PyObject * pyindex = PyLong_FromSize_t(idx);
+    if (!pyindex) {
+      return false;
+    }
+    int rc = PyList_Append(pylist, pyindex);
+    Py_DECREF(pyindex);
+    if (rc) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Get the indices of the entities of all types which are ready in the wait set
+/**
+ * This must be called after waiting on the wait set.
+ * It replaces five calls to rclpy_get_ready_entities() and, since entities are added in order,
+ * lets the caller find the ready entities without searching for their pointers.
+ * Timers which are not ready anymore (e.g. because they were canceled) are not returned.
+ *
+ * Raises ValueError if pywait_set is not a wait set capsule
+ * Raises RuntimeError if the readiness of a timer could not be checked
+ *
+ * \param[in] pywait_set Capsule pointing to the wait set structure
+ * \return tuple of five lists with the indices of the ready subscriptions, guard conditions,
+ *   timers, clients and services
+ */
+static PyObject *
+rclpy_wait_set_get_ready_indices(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pywait_set;
+  if (!PyArg_ParseTuple(args, "O", &pywait_set)) {
+    return NULL;
+  }
+
+  rcl_wait_set_t * wait_set = (rcl_wait_set_t *)PyCapsule_GetPointer(pywait_set, "rcl_wait_set_t");
+  if (!wait_set) {
+    return NULL;
+  }
+
+  PyObject * pyready = Py_BuildValue("([][][][][])");
+  if (!pyready) {
+    return NULL;
+  }
+  if (
+    !_rclpy_append_ready_indices(
+      PyTuple_GET_ITEM(pyready, 0), (const void **)wait_set->subscriptions,
+      wait_set->size_of_subscriptions) ||
+    !_rclpy_append_ready_indices(
+      PyTuple_GET_ITEM(pyready, 1), (const void **)wait_set->guard_conditions,
+      wait_set->size_of_guard_conditions) ||
+    !_rclpy_append_ready_timer_indices(PyTuple_GET_ITEM(pyready, 2), wait_set) ||
+    !_rclpy_append_ready_indices(
+      PyTuple_GET_ITEM(pyready, 3), (const void **)wait_set->clients,
+      wait_set->size_of_clients) ||
+    !_rclpy_append_ready_indices(
+      PyTuple_GET_ITEM(pyready, 4), (const void **)wait_set->services,
+      wait_set->size_of_services))
+  {
+    Py_DECREF(pyready);
+    return NULL;
+  }
+  return pyready;
+}
+
 /// Wait until timeout is reached or event happened
 /**
  * Raises ValueError if pywait_set is not a wait set capsule
@@ -4256,6 +4500,11 @@ static PyMethodDef rclpy_methods[] = {
     "rclpy_wait_set_init."
   },
 
+  {
+    "rclpy_wait_set_resize", rclpy_wait_set_resize, METH_VARARGS,
+    "Initialize, resize or clear a wait set so it can hold the given entities."
+  },
+
   {
     "rclpy_wait_set_clear_entities", rclpy_wait_set_clear_entities, METH_VARARGS,
     "rclpy_wait_set_clear_entities."
@@ -4266,6 +4515,11 @@ static PyMethodDef rclpy_methods[] = {
     "rclpy_wait_set_add_entity."
   },
 
+  {
+    "rclpy_wait_set_add_entities", rclpy_wait_set_add_entities, METH_VARARGS,
+    "Add a sequence of entities of the same type to a wait set."
+  },
+
   {
     "rclpy_wait_set_is_ready", rclpy_wait_set_is_ready, METH_VARARGS,
     "rclpy_wait_set_is_ready."
@@ -4281,6 +4535,11 @@ static PyMethodDef rclpy_methods[] = {
     "List non null entities in wait set."
   },
 
+  {
+    "rclpy_wait_set_get_ready_indices", rclpy_wait_set_get_ready_indices, METH_VARARGS,
+    "Get the indices of the ready entities of every type in a wait set."
+  },
+
   {
     "rclpy_reset_timer", rclpy_reset_timer, METH_VARARGS,
     "Reset a timer."
@@ -0,0 +1,106 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Measure the overhead of the executor with many subscriptions and timers.
+
+Two numbers are reported for each configuration:
+
+- the number of spin_once() calls per second when there is no work at all, which is the cost
+  of collecting the entities and waiting on them, and
+- the number of callbacks per second when every timer is always ready and a message is
+  published to one of the subscriptions before every spin.
+
+This is not run as part of the tests, run it directly:
+
+    python3 benchmark_executor.py [duration_sec]
+"""
+
+import sys
+import time
+
+import rclpy
+from rclpy.executors import SingleThreadedExecutor
+from test_msgs.msg import Primitives
+
+CONFIGURATIONS = [(1, 1), (10, 10), (100, 10), (10, 100), (500, 100)]
+
+
+def measure(executor, duration):
+    count = 0
+    start = time.monotonic()
+    while time.monotonic() - start < duration:
+        executor.spin_once(timeout_sec=0)
+        count += 1
+    return count / (time.monotonic() - start)
+
+
+def run(context, num_subscriptions, num_timers, duration):
+    node = rclpy.create_node('benchmark_executor', context=context)
+    executor = SingleThreadedExecutor(context=context)
+    executor.add_node(node)
+    callbacks = 0
+
+    def callback(*args):
+        nonlocal callbacks
+        callbacks += 1
+
+    subscriptions = [
+        node.create_subscription(Primitives, 'benchmark_%d' % i, callback)
+        for i in range(num_subscriptions)]
+    timers = [node.create_timer(3600, callback) for i in range(num_timers)]
+    idle = measure(executor, duration)
+
+    for tmr in timers:
+        tmr.timer_period_ns = 1
+    publishers = [
+        node.create_publisher(Primitives, 'benchmark_%d' % i) for i in range(num_subscriptions)]
+    msg = Primitives()
+    callbacks = 0
+    spins = 0
+    start = time.monotonic()
+    while time.monotonic() - start < duration:
+        # publish to the subscriptions in turn
+        if publishers:
+            publishers[spins % len(publishers)].publish(msg)
+        executor.spin_once(timeout_sec=0)
+        spins += 1
+    busy = callbacks / (time.monotonic() - start)
+
+    for pub in publishers:
+        node.destroy_publisher(pub)
+    for sub in subscriptions:
+        node.destroy_subscription(sub)
+    for tmr in timers:
+        node.destroy_timer(tmr)
+    executor.shutdown()
+    node.destroy_node()
+    return idle, busy
+
+
+def main(argv=sys.argv[1:]):
+    duration = float(argv[0]) if argv else 2.0
+    context = rclpy.context.Context()
+    rclpy.init(context=context)
+    try:
+        print('%14s %7s %18s %16s' % ('subscriptions', 'timers', 'idle spins/sec', 'callbacks/sec'))
+        for num_subscriptions, num_timers in CONFIGURATIONS:
+            idle, busy = run(context, num_subscriptions, num_timers, duration)
+            print('%14d %7d %18.1f %16.1f' % (num_subscriptions, num_timers, idle, busy))
+    finally:
+        rclpy.shutdown(context=context)
+
+
+if __name__ == '__main__':
+    main()
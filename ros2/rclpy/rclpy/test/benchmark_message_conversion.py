@@ -0,0 +1,85 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Measure how many messages with large primitive arrays rclpy can publish and take per second.
+
+Every message goes through the Python <-> C conversion functions generated by
+rosidl_generator_py twice, once when published and once when taken.
+This is not run as part of the tests, run it directly:
+
+    python3 benchmark_message_conversion.py [duration_sec]
+"""
+
+import array
+import sys
+import time
+
+import rclpy
+from test_msgs.msg import DynamicArrayPrimitives
+
+SIZES = [0, 1000, 10000, 100000, 1000000]
+
+
+def make_message(size):
+    msg = DynamicArrayPrimitives()
+    msg.float64_values = array.array('d', range(size))
+    msg.uint8_values = array.array('B', (i % 256 for i in range(size)))
+    return msg
+
+
+def run(node, size, duration):
+    received = []
+    pub = node.create_publisher(DynamicArrayPrimitives, 'benchmark_%d' % size)
+    sub = node.create_subscription(
+        DynamicArrayPrimitives, 'benchmark_%d' % size, lambda msg: received.append(msg))
+    msg = make_message(size)
+
+    # wait for the subscription to be matched before measuring
+    while not received:
+        pub.publish(msg)
+        rclpy.spin_once(node, timeout_sec=0.1)
+    assert msg == received[-1]
+
+    count = 0
+    start = time.monotonic()
+    while time.monotonic() - start < duration:
+        del received[:]
+        pub.publish(msg)
+        while not received:
+            rclpy.spin_once(node, timeout_sec=1.0)
+        count += 1
+    elapsed = time.monotonic() - start
+
+    node.destroy_subscription(sub)
+    node.destroy_publisher(pub)
+    return count / elapsed
+
+
+def main(argv=sys.argv[1:]):
+    duration = float(argv[0]) if argv else 2.0
+    context = rclpy.context.Context()
+    rclpy.init(context=context)
+    try:
+        node = rclpy.create_node('benchmark_message_conversion', context=context)
+        print('%10s %12s' % ('elements', 'msgs/sec'))
+        for size in SIZES:
+            print('%10d %12.1f' % (size, run(node, size, duration)))
+        node.destroy_node()
+    finally:
+        rclpy.shutdown(context=context)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,164 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCUTILS__ALLOCATION_REGION_H_
+#define RCUTILS__ALLOCATION_REGION_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/visibility_control.h"
+
+/// Named code regions of the message path, to which allocations are attributed.
+/**
+ * The client libraries and middleware implementations mark the regions they
+ * run, and an allocation hook, e.g. the callbacks of osrf_testing_tools_cpp
+ * memory tools, calls rcutils_allocation_region_record() for each allocation.
+ * Allocations are then counted against the region the allocating thread is in.
+ */
+typedef enum rcutils_allocation_region_t
+{
+  /// Outside of any marked region.
+  RCUTILS_ALLOCATION_REGION_NONE = 0,
+  /// Publishing a message, from the client library down to the middleware.
+  RCUTILS_ALLOCATION_REGION_PUBLISH,
+  /// Serializing a message in the middleware.
+  RCUTILS_ALLOCATION_REGION_SERIALIZE,
+  /// Taking a message, from the executor down to the middleware.
+  RCUTILS_ALLOCATION_REGION_TAKE,
+  /// Deserializing a message in the middleware.
+  RCUTILS_ALLOCATION_REGION_DESERIALIZE,
+  /// Executing a user callback.
+  RCUTILS_ALLOCATION_REGION_EXECUTE,
+  /// Number of regions, not a region.
+  RCUTILS_ALLOCATION_REGION_COUNT
+} rcutils_allocation_region_t;
+
+/// Allocations counted against a region.
+typedef struct rcutils_allocation_region_stats_t
+{
+  /// Number of allocations, including reallocations.
+  uint64_t allocations;
+  /// Sum of the requested sizes.
+  uint64_t bytes;
+} rcutils_allocation_region_stats_t;
+
+/// Enter a region on the calling thread.
+/**
+ * Regions nest: allocations are counted against the innermost region only,
+ * e.g. an allocation while serializing a published message counts as a
+ * serialize allocation and not as a publish one.
+ * The previous region is returned and must be given back to
+ * rcutils_allocation_region_exit() when leaving the region.
+ *
+ * The state is thread-local, entering a region is a single store.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] region the region to enter
+ * \return the region the calling thread was in
+ */
+RCUTILS_PUBLIC
+rcutils_allocation_region_t
+rcutils_allocation_region_enter(rcutils_allocation_region_t region);
+
+/// Leave a region on the calling thread, going back to the previous one.
+/**
+ * \param[in] previous the region returned by rcutils_allocation_region_enter()
+ */
+RCUTILS_PUBLIC
+void
+rcutils_allocation_region_exit(rcutils_allocation_region_t previous);
+
+/// Return the region the calling thread is in.
+RCUTILS_PUBLIC
+rcutils_allocation_region_t
+rcutils_allocation_region_get(void);
+
+/// Return the name of a region, e.g. "publish", or NULL if it is out of range.
+RCUTILS_PUBLIC
+const char *
+rcutils_allocation_region_get_name(rcutils_allocation_region_t region);
+
+/// Count an allocation of the calling thread against its current region.
+/**
+ * This is meant to be called from an allocation hook, so it does not allocate
+ * and does not take any lock.
+ *
+ * \param[in] bytes the requested size of the allocation
+ */
+RCUTILS_PUBLIC
+void
+rcutils_allocation_region_record(size_t bytes);
+
+/// Return the allocations counted against a region by the calling thread.
+/**
+ * \param[in] region the region to get the counts of
+ * \return the counts, zero if the region is out of range
+ */
+RCUTILS_PUBLIC
+rcutils_allocation_region_stats_t
+rcutils_allocation_region_get_stats(rcutils_allocation_region_t region);
+
+/// Reset the counts of all the regions of the calling thread.
+RCUTILS_PUBLIC
+void
+rcutils_allocation_region_reset_stats(void);
+
+#ifdef __cplusplus
+}
+
+namespace rcutils
+{
+
+/// Attribute the allocations of the calling thread to a region until the end of the scope.
+/**
+ * The counts are only updated when an allocation hook calls
+ * rcutils_allocation_region_record(), otherwise marking a region costs two
+ * thread-local stores.
+ */
+class ScopedAllocationRegion
+{
+public:
+  explicit ScopedAllocationRegion(rcutils_allocation_region_t region)
+  : previous_(rcutils_allocation_region_enter(region))
+  {}
+
+  ~ScopedAllocationRegion()
+  {
+    rcutils_allocation_region_exit(previous_);
+  }
+
+  ScopedAllocationRegion(const ScopedAllocationRegion &) = delete;
+  ScopedAllocationRegion & operator=(const ScopedAllocationRegion &) = delete;
+
+private:
+  rcutils_allocation_region_t previous_;
+};
+
+}  // namespace rcutils
+#endif
+
+#endif  // RCUTILS__ALLOCATION_REGION_H_
@@ -0,0 +1,100 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcutils/allocation_region.h"
+
+#include <string.h>
+
+#include "rcutils/macros.h"
+
+static const char * const g_rcutils_allocation_region_names[RCUTILS_ALLOCATION_REGION_COUNT] = {
+  "none",
+  "publish",
+  "serialize",
+  "take",
+  "deserialize",
+  "execute",
+};
+
+// Zero initialized, so threads start outside of any region with no count
+RCUTILS_THREAD_LOCAL rcutils_allocation_region_t gtls_rcutils_allocation_region =
+  RCUTILS_ALLOCATION_REGION_NONE;
+RCUTILS_THREAD_LOCAL rcutils_allocation_region_stats_t
+  gtls_rcutils_allocation_region_stats[RCUTILS_ALLOCATION_REGION_COUNT];
+
+rcutils_allocation_region_t
+rcutils_allocation_region_enter(rcutils_allocation_region_t region)
+{
+  rcutils_allocation_region_t previous = gtls_rcutils_allocation_region;
+  gtls_rcutils_allocation_region = region;
+  return previous;
+}
+
+void
+rcutils_allocation_region_exit(rcutils_allocation_region_t previous)
+{
+  gtls_rcutils_allocation_region = previous;
+}
+
+rcutils_allocation_region_t
+rcutils_allocation_region_get(void)
+{
+  return gtls_rcutils_allocation_region;
+}
+
+const char *
+rcutils_allocation_region_get_name(rcutils_allocation_region_t region)
+{
+  if (region < RCUTILS_ALLOCATION_REGION_NONE || region >= RCUTILS_ALLOCATION_REGION_COUNT) {
+    return NULL;
+  }
+  return g_rcutils_allocation_region_names[region];
+}
+
+void
+rcutils_allocation_region_record(size_t bytes)
+{
+  rcutils_allocation_region_t region = gtls_rcutils_allocation_region;
+  if (region < RCUTILS_ALLOCATION_REGION_NONE || region >= RCUTILS_ALLOCATION_REGION_COUNT) {
+    return;
+  }
+  gtls_rcutils_allocation_region_stats[region].allocations++;
+  gtls_rcutils_allocation_region_stats[region].bytes += bytes;
+}
+
+rcutils_allocation_region_stats_t
+rcutils_allocation_region_get_stats(rcutils_allocation_region_t region)
+{
+  if (region < RCUTILS_ALLOCATION_REGION_NONE || region >= RCUTILS_ALLOCATION_REGION_COUNT) {
+    rcutils_allocation_region_stats_t zero = {0u, 0u};
+    return zero;
+  }
+  return gtls_rcutils_allocation_region_stats[region];
+}
+
+void
+rcutils_allocation_region_reset_stats(void)
+{
+  memset(
+    gtls_rcutils_allocation_region_stats, 0, sizeof(gtls_rcutils_allocation_region_stats));
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,177 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "rcutils/allocation_region.h"
+
+#include "osrf_testing_tools_cpp/memory_tools/memory_tools.hpp"
+
+using osrf_testing_tools_cpp::memory_tools::disable_monitoring_in_all_threads;
+using osrf_testing_tools_cpp::memory_tools::enable_monitoring_in_all_threads;
+using osrf_testing_tools_cpp::memory_tools::MemoryToolsService;
+
+class TestAllocationRegionFixture : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    osrf_testing_tools_cpp::memory_tools::initialize();
+    rcutils_allocation_region_reset_stats();
+  }
+
+  void TearDown()
+  {
+    disable_monitoring_in_all_threads();
+    osrf_testing_tools_cpp::memory_tools::uninitialize();
+  }
+};
+
+/* Tests the names of the regions.
+ */
+TEST_F(TestAllocationRegionFixture, test_names) {
+  EXPECT_EQ(
+    std::string("none"), rcutils_allocation_region_get_name(RCUTILS_ALLOCATION_REGION_NONE));
+  EXPECT_EQ(
+    std::string("publish"), rcutils_allocation_region_get_name(RCUTILS_ALLOCATION_REGION_PUBLISH));
+  EXPECT_EQ(
+    std::string("serialize"),
+    rcutils_allocation_region_get_name(RCUTILS_ALLOCATION_REGION_SERIALIZE));
+  EXPECT_EQ(
+    std::string("take"), rcutils_allocation_region_get_name(RCUTILS_ALLOCATION_REGION_TAKE));
+  EXPECT_EQ(
+    std::string("deserialize"),
+    rcutils_allocation_region_get_name(RCUTILS_ALLOCATION_REGION_DESERIALIZE));
+  EXPECT_EQ(
+    std::string("execute"), rcutils_allocation_region_get_name(RCUTILS_ALLOCATION_REGION_EXECUTE));
+  EXPECT_EQ(nullptr, rcutils_allocation_region_get_name(RCUTILS_ALLOCATION_REGION_COUNT));
+}
+
+/* Tests entering and leaving nested regions.
+ */
+TEST_F(TestAllocationRegionFixture, test_nesting) {
+  EXPECT_EQ(RCUTILS_ALLOCATION_REGION_NONE, rcutils_allocation_region_get());
+  rcutils_allocation_region_t outer =
+    rcutils_allocation_region_enter(RCUTILS_ALLOCATION_REGION_PUBLISH);
+  EXPECT_EQ(RCUTILS_ALLOCATION_REGION_NONE, outer);
+  rcutils_allocation_region_record(8u);
+  rcutils_allocation_region_t inner =
+    rcutils_allocation_region_enter(RCUTILS_ALLOCATION_REGION_SERIALIZE);
+  EXPECT_EQ(RCUTILS_ALLOCATION_REGION_PUBLISH, inner);
+  EXPECT_EQ(RCUTILS_ALLOCATION_REGION_SERIALIZE, rcutils_allocation_region_get());
+  rcutils_allocation_region_record(16u);
+  rcutils_allocation_region_record(32u);
+  rcutils_allocation_region_exit(inner);
+  EXPECT_EQ(RCUTILS_ALLOCATION_REGION_PUBLISH, rcutils_allocation_region_get());
+  rcutils_allocation_region_exit(outer);
+  EXPECT_EQ(RCUTILS_ALLOCATION_REGION_NONE, rcutils_allocation_region_get());
+  rcutils_allocation_region_record(64u);
+
+  rcutils_allocation_region_stats_t stats =
+    rcutils_allocation_region_get_stats(RCUTILS_ALLOCATION_REGION_PUBLISH);
+  EXPECT_EQ(1u, stats.allocations);
+  EXPECT_EQ(8u, stats.bytes);
+  stats = rcutils_allocation_region_get_stats(RCUTILS_ALLOCATION_REGION_SERIALIZE);
+  EXPECT_EQ(2u, stats.allocations);
+  EXPECT_EQ(48u, stats.bytes);
+  stats = rcutils_allocation_region_get_stats(RCUTILS_ALLOCATION_REGION_NONE);
+  EXPECT_EQ(1u, stats.allocations);
+  EXPECT_EQ(64u, stats.bytes);
+  stats = rcutils_allocation_region_get_stats(RCUTILS_ALLOCATION_REGION_COUNT);
+  EXPECT_EQ(0u, stats.allocations);
+
+  rcutils_allocation_region_reset_stats();
+  stats = rcutils_allocation_region_get_stats(RCUTILS_ALLOCATION_REGION_SERIALIZE);
+  EXPECT_EQ(0u, stats.allocations);
+  EXPECT_EQ(0u, stats.bytes);
+}
+
+/* Tests that the scoped helper leaves its region at the end of the scope.
+ */
+TEST_F(TestAllocationRegionFixture, test_scoped) {
+  {
+    rcutils::ScopedAllocationRegion outer(RCUTILS_ALLOCATION_REGION_TAKE);
+    EXPECT_EQ(RCUTILS_ALLOCATION_REGION_TAKE, rcutils_allocation_region_get());
+    {
+      rcutils::ScopedAllocationRegion inner(RCUTILS_ALLOCATION_REGION_DESERIALIZE);
+      EXPECT_EQ(RCUTILS_ALLOCATION_REGION_DESERIALIZE, rcutils_allocation_region_get());
+    }
+    EXPECT_EQ(RCUTILS_ALLOCATION_REGION_TAKE, rcutils_allocation_region_get());
+  }
+  EXPECT_EQ(RCUTILS_ALLOCATION_REGION_NONE, rcutils_allocation_region_get());
+}
+
+/* Tests that the regions and counts of threads are separate.
+ */
+TEST_F(TestAllocationRegionFixture, test_thread_local) {
+  rcutils_allocation_region_t previous =
+    rcutils_allocation_region_enter(RCUTILS_ALLOCATION_REGION_EXECUTE);
+  rcutils_allocation_region_record(1u);
+
+  rcutils_allocation_region_t other_region = RCUTILS_ALLOCATION_REGION_COUNT;
+  uint64_t other_allocations = 1u;
+  std::thread other([&other_region, &other_allocations]() {
+      other_region = rcutils_allocation_region_get();
+      rcutils_allocation_region_t previous =
+        rcutils_allocation_region_enter(RCUTILS_ALLOCATION_REGION_EXECUTE);
+      other_allocations =
+        rcutils_allocation_region_get_stats(RCUTILS_ALLOCATION_REGION_EXECUTE).allocations;
+      rcutils_allocation_region_record(1u);
+      rcutils_allocation_region_exit(previous);
+    });
+  other.join();
+  EXPECT_EQ(RCUTILS_ALLOCATION_REGION_NONE, other_region);
+  EXPECT_EQ(0u, other_allocations);
+
+  rcutils_allocation_region_exit(previous);
+  EXPECT_EQ(1u, rcutils_allocation_region_get_stats(RCUTILS_ALLOCATION_REGION_EXECUTE).allocations);
+}
+
+/* Tests that the regions can be used from allocation hooks: they do not allocate themselves.
+ */
+TEST_F(TestAllocationRegionFixture, test_memory_tools_hooks) {
+  auto record = [](MemoryToolsService & service) {
+      rcutils_allocation_region_record(service.get_requested_size());
+      service.ignore();
+    };
+  osrf_testing_tools_cpp::memory_tools::on_malloc(record);
+  osrf_testing_tools_cpp::memory_tools::on_realloc(record);
+  osrf_testing_tools_cpp::memory_tools::on_calloc(record);
+  osrf_testing_tools_cpp::memory_tools::on_free(
+    [](MemoryToolsService & service) {
+      service.ignore();
+    });
+
+  enable_monitoring_in_all_threads();
+  rcutils_allocation_region_t previous = RCUTILS_ALLOCATION_REGION_NONE;
+  EXPECT_NO_MEMORY_OPERATIONS({
+    previous = rcutils_allocation_region_enter(RCUTILS_ALLOCATION_REGION_TAKE);
+  });
+  void * memory = std::malloc(100);
+  memory = std::realloc(memory, 200);
+  std::free(memory);
+  EXPECT_NO_MEMORY_OPERATIONS({
+    rcutils_allocation_region_exit(previous);
+  });
+  disable_monitoring_in_all_threads();
+
+  rcutils_allocation_region_stats_t stats =
+    rcutils_allocation_region_get_stats(RCUTILS_ALLOCATION_REGION_TAKE);
+  EXPECT_EQ(2u, stats.allocations);
+  EXPECT_EQ(300u, stats.bytes);
+}
@@ -18,12 +18,16 @@
 #include <time.h>
 #include <sched.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+/// Maximum number of phases which can be registered with rttest_register_phase().
+#define RTTEST_MAX_PHASES 16
+
 // rttest can have one instance per thread!
 struct rttest_params
 {
@@ -36,6 +40,9 @@ struct rttest_params
   // TODO(dirk-thomas) currently this pointer is never deallocated or copied
   // so whatever value is being assigned must stay valid forever
   char * filename;
+
+  // Name of the file to save the latency histograms to, in the binary results format.
+  char * histogram_filename;
 };
 
 struct rttest_results
@@ -49,6 +56,16 @@ struct rttest_results
 
   size_t minor_pagefaults;
   size_t major_pagefaults;
+
+  // Latency percentiles, filled by rttest_calculate_statistics only.
+  // They are computed from a histogram and may be up to 1% higher than the exact values.
+  int p50_latency;
+  int p99_latency;
+  int p999_latency;
+  int p9999_latency;
+
+  // Number of negative latencies, i.e. early wakeups, filled by rttest_calculate_statistics only.
+  size_t negative_latencies;
 };
 
 /// \brief Initialize rttest with arguments
@@ -177,7 +194,8 @@ int rttest_get_statistics(struct rttest_results * results);
 /// wakeup time and the actual wakeup time
 int rttest_get_sample_at(const size_t iteration, int * sample);
 
-/// \brief Write the sample buffer to a file.
+/// \brief Write the sample buffer to a file, and the latency histograms to the histogram file
+/// if one was given.
 /// \return Error code to propagate to main
 int rttest_write_results();
 
@@ -186,6 +204,44 @@ int rttest_write_results();
 /// \return Error code to propagate to main
 int rttest_write_results_file(char * filename);
 
+/// \brief Write the latency histogram of this thread and the histograms of all the phases to a
+/// file in the binary results format.
+/// The file only depends on the number of distinct latencies, not on the number of iterations.
+/// Compare two of these files with the rttest_compare script.
+/// \param[in] Filename to store the histograms; overrides default param.
+/// \return Error code to propagate to main
+int rttest_write_histogram_file(char * filename);
+
+/// \brief Register a phase of the user code, e.g. the time between the publication of a message
+/// and its reception.
+/// Registering the same name again returns the same phase.
+/// Phases are shared by all threads. Not real time safe.
+/// \param[in] name Name of the phase
+/// \param[out] phase_id Identifier of the phase to pass to rttest_record_phase
+/// \return Error code if more than RTTEST_MAX_PHASES phases are registered
+int rttest_register_phase(const char * name, size_t * phase_id);
+
+/// \brief Record a latency sample in the histogram of a phase.
+/// Lock-free, can be called concurrently from any thread.
+/// \param[in] phase_id Identifier returned by rttest_register_phase
+/// \param[in] latency Latency in nanoseconds
+/// \return Error code if the phase does not exist
+int rttest_record_phase(size_t phase_id, int64_t latency);
+
+/// \brief Record the time elapsed since a timestamp taken from CLOCK_MONOTONIC in the histogram
+/// of a phase, e.g. the time the message was published when it is received.
+/// Lock-free, can be called concurrently from any thread.
+/// \param[in] phase_id Identifier returned by rttest_register_phase
+/// \param[in] start_time Beginning of the phase
+/// \return Error code if the phase does not exist
+int rttest_record_phase_since(size_t phase_id, const struct timespec * start_time);
+
+/// \brief Calculate the statistics of a phase.
+/// \param[in] phase_id Identifier returned by rttest_register_phase
+/// \param[out] results The results struct to fill, iteration is set to the number of samples.
+/// \return Error code if the phase does not exist or if results is NULL
+int rttest_get_phase_statistics(size_t phase_id, struct rttest_results * results);
+
 /// \brief Free memory and cleanup
 /// \return Error code to propagate to main
 int rttest_finish();
@@ -0,0 +1,289 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LATENCY_HISTOGRAM_HPP_
+#define LATENCY_HISTOGRAM_HPP_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+
+/// Log-linear histogram of latencies in nanoseconds, using a constant amount of memory.
+/**
+ * Values below 2^sub_bucket_bits have a bucket each.
+ * Above, every power of two is split in 2^sub_bucket_bits buckets of equal width, so the value
+ * reported for a percentile is at most 1 / 2^sub_bucket_bits (< 1%) above the exact one.
+ * Values of max_value and above share the last bucket.
+ *
+ * Negative values (e.g. early wakeups) are counted by magnitude in a second set of buckets of the
+ * same layout, so that they rank below zero in the percentiles.
+ *
+ * record() is lock-free and can be called concurrently from several threads.
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr uint32_t sub_bucket_bits = 7;
+  static constexpr uint32_t sub_bucket_count = 1u << sub_bucket_bits;
+  /// Highest power of two which is tracked, 2^40 ns is about 18 minutes.
+  static constexpr uint32_t max_value_bits = 40;
+  static constexpr uint64_t max_value = 1ull << max_value_bits;
+  static constexpr uint32_t bucket_count =
+    sub_bucket_count + (max_value_bits - sub_bucket_bits) * sub_bucket_count;
+
+  LatencyHistogram()
+  {
+    reset();
+  }
+
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram & operator=(const LatencyHistogram &) = delete;
+
+  void reset()
+  {
+    for (auto & count : counts_) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    for (auto & count : negative_counts_) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    negative_count_.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    max_.store(std::numeric_limits<int64_t>::min(), std::memory_order_relaxed);
+  }
+
+  void record(int64_t value)
+  {
+    if (value >= 0) {
+      counts_[get_bucket_index(static_cast<uint64_t>(value))].fetch_add(
+        1, std::memory_order_relaxed);
+    } else {
+      // The magnitude of INT64_MIN does not fit in an int64_t
+      uint64_t magnitude = static_cast<uint64_t>(-(value + 1)) + 1;
+      negative_counts_[get_bucket_index(magnitude)].fetch_add(1, std::memory_order_relaxed);
+      negative_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    int64_t current = min_.load(std::memory_order_relaxed);
+    while (value < current &&
+      !min_.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+    current = max_.load(std::memory_order_relaxed);
+    while (value > current &&
+      !max_.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  static uint32_t get_bucket_index(uint64_t value)
+  {
+    if (value < sub_bucket_count) {
+      return static_cast<uint32_t>(value);
+    }
+    if (value >= max_value) {
+      return bucket_count - 1;
+    }
+    uint32_t msb = 63 - __builtin_clzll(value);
+    uint32_t shift = msb - sub_bucket_bits;
+    uint32_t sub_bucket = static_cast<uint32_t>(value >> shift) & (sub_bucket_count - 1);
+    return sub_bucket_count + shift * sub_bucket_count + sub_bucket;
+  }
+
+  /// Smallest value counted in a bucket.
+  static uint64_t get_bucket_lowest_value(uint32_t index)
+  {
+    if (index < sub_bucket_count) {
+      return index;
+    }
+    uint32_t shift = (index - sub_bucket_count) / sub_bucket_count;
+    uint64_t sub_bucket = (index - sub_bucket_count) % sub_bucket_count;
+    return (sub_bucket_count + sub_bucket) << shift;
+  }
+
+  /// Largest value counted in a bucket.
+  static uint64_t get_bucket_highest_value(uint32_t index)
+  {
+    if (index < sub_bucket_count) {
+      return index;
+    }
+    uint32_t shift = (index - sub_bucket_count) / sub_bucket_count;
+    return get_bucket_lowest_value(index) + (1ull << shift) - 1;
+  }
+
+  uint64_t get_count() const
+  {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t get_bucket(uint32_t index) const
+  {
+    return counts_[index].load(std::memory_order_relaxed);
+  }
+
+  /// Number of negative values recorded.
+  uint64_t get_negative_count() const
+  {
+    return negative_count_.load(std::memory_order_relaxed);
+  }
+
+  /// Number of negative values recorded whose magnitude falls in a bucket.
+  uint64_t get_negative_bucket(uint32_t index) const
+  {
+    return negative_counts_[index].load(std::memory_order_relaxed);
+  }
+
+  int64_t get_min() const
+  {
+    return get_count() ? min_.load(std::memory_order_relaxed) : 0;
+  }
+
+  int64_t get_max() const
+  {
+    return get_count() ? max_.load(std::memory_order_relaxed) : 0;
+  }
+
+  int64_t get_sum() const
+  {
+    return sum_.load(std::memory_order_relaxed);
+  }
+
+  double get_mean() const
+  {
+    uint64_t count = get_count();
+    return count ? static_cast<double>(get_sum()) / count : 0.0;
+  }
+
+  /// Standard deviation computed from the middle of the buckets.
+  double get_stddev() const
+  {
+    uint64_t count = get_count();
+    if (count == 0) {
+      return 0.0;
+    }
+    double mean = get_mean();
+    double sum = 0.0;
+    for (uint32_t i = 0; i < bucket_count; ++i) {
+      double middle = (get_bucket_lowest_value(i) + get_bucket_highest_value(i)) / 2.0;
+      uint64_t bucket = get_bucket(i);
+      if (bucket) {
+        sum += bucket * (middle - mean) * (middle - mean);
+      }
+      bucket = get_negative_bucket(i);
+      if (bucket) {
+        sum += bucket * (middle + mean) * (middle + mean);
+      }
+    }
+    return std::sqrt(sum / count);
+  }
+
+  /// Value below or equal to which percentile % of the recorded values are.
+  /**
+   * The highest value of the bucket holding the percentile is reported, limited to the range of
+   * recorded values.
+   */
+  int64_t get_percentile(double percentile) const
+  {
+    uint64_t count = get_count();
+    if (count == 0) {
+      return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count));
+    if (rank == 0) {
+      rank = 1;
+    }
+    uint64_t cumulated = 0;
+    int64_t value = get_max();
+    bool found = false;
+    // The negative values come first, from the largest magnitude down
+    for (uint32_t i = bucket_count; i-- > 0 && !found; ) {
+      cumulated += get_negative_bucket(i);
+      if (cumulated >= rank) {
+        value = -static_cast<int64_t>(get_bucket_lowest_value(i));
+        found = true;
+      }
+    }
+    for (uint32_t i = 0; i < bucket_count && !found; ++i) {
+      cumulated += get_bucket(i);
+      if (cumulated >= rank) {
+        value = static_cast<int64_t>(get_bucket_highest_value(i));
+        found = true;
+      }
+    }
+    if (value > get_max()) {
+      value = get_max();
+    }
+    if (value < get_min()) {
+      value = get_min();
+    }
+    return value;
+  }
+
+  /// Append the histogram in the binary results format, see rttest_write_histogram_file().
+  void write(std::ostream & stream, const std::string & name) const
+  {
+    write_value(stream, static_cast<uint32_t>(name.size()));
+    stream.write(name.data(), name.size());
+    write_value(stream, get_count());
+    write_value(stream, get_min());
+    write_value(stream, get_max());
+    write_value(stream, get_sum());
+    write_buckets(stream, counts_);
+    write_buckets(stream, negative_counts_);
+  }
+
+  template<typename T>
+  static void write_value(std::ostream & stream, T value)
+  {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+private:
+  static void write_buckets(
+    std::ostream & stream, const std::atomic<uint64_t> (&counts)[bucket_count])
+  {
+    uint32_t used_buckets = 0;
+    for (uint32_t i = 0; i < bucket_count; ++i) {
+      if (counts[i].load(std::memory_order_relaxed)) {
+        ++used_buckets;
+      }
+    }
+    write_value(stream, used_buckets);
+    for (uint32_t i = 0; i < bucket_count; ++i) {
+      uint64_t bucket = counts[i].load(std::memory_order_relaxed);
+      if (bucket) {
+        write_value(stream, i);
+        write_value(stream, bucket);
+      }
+    }
+  }
+
+  std::atomic<uint64_t> counts_[bucket_count];
+  std::atomic<uint64_t> negative_counts_[bucket_count];
+  std::atomic<uint64_t> negative_count_;
+  std::atomic<uint64_t> count_;
+  std::atomic<int64_t> sum_;
+  std::atomic<int64_t> min_;
+  std::atomic<int64_t> max_;
+};
+
+#endif  // LATENCY_HISTOGRAM_HPP_
@@ -23,19 +23,22 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <cmath>
 #include <fstream>
-#include <functional>
 #include <iostream>
 #include <map>
-#include <numeric>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "latency_histogram.hpp"
+
 extern "C"
 {
 class rttest_sample_buffer
@@ -128,6 +131,8 @@ class Rttest
 private:
   struct rttest_params params;
   struct rttest_sample_buffer sample_buffer;
+  // Shared by the copies made when the instance is stored in rttest_instance_map
+  std::shared_ptr<LatencyHistogram> latency_histogram;
   struct rusage prev_usage;
 
   pthread_t thread_id;
@@ -138,6 +143,10 @@ private:
 
   int accumulate_statistics(size_t iteration);
 
+  // Index of an iteration in the sample buffer, which only holds the last sample unless every
+  // sample is written to a file
+  size_t get_sample_index(size_t iteration) const;
+
 public:
   int running = 0;
   struct rttest_results results;
@@ -150,7 +159,7 @@ public:
   int init(
     size_t iterations, struct timespec update_period,
     size_t sched_policy, int sched_priority, size_t stack_size,
-    char * filename);
+    char * filename, char * histogram_filename = nullptr);
 
   int spin(void *(*user_function)(void *), void * args);
 
@@ -185,6 +194,8 @@ public:
 
   int write_results_file(char * filename);
 
+  int write_histogram_file(char * filename);
+
   std::string results_to_string(char * name);
 
   int finish();
@@ -200,8 +211,66 @@ public:
 std::map<pthread_t, Rttest> rttest_instance_map;
 pthread_t initial_thread_id = 0;
 
+// Phases are shared by all threads. They are only added under rttest_phase_mutex, and published
+// to the threads recording samples by incrementing rttest_phase_count.
+struct rttest_phase
+{
+  std::string name;
+  LatencyHistogram histogram;
+};
+std::unique_ptr<rttest_phase> rttest_phases[RTTEST_MAX_PHASES];
+std::atomic<size_t> rttest_phase_count(0);
+std::mutex rttest_phase_mutex;
+
+static char * copy_filename(const char * filename)
+{
+  size_t n = strlen(filename);
+  char * copy = static_cast<char *>(std::malloc(n * sizeof(char) + 1));
+  if (!copy) {
+    fprintf(stderr, "Failed to allocate filename\n");
+    return nullptr;
+  }
+  copy[n] = 0;
+  strncpy(copy, filename, n);
+  return copy;
+}
+
+static int clamp_latency(int64_t latency)
+{
+  return static_cast<int>(std::max<int64_t>(INT_MIN, std::min<int64_t>(INT_MAX, latency)));
+}
+
+static void histogram_to_results(
+  const LatencyHistogram & histogram, struct rttest_results * output)
+{
+  output->min_latency = clamp_latency(histogram.get_min());
+  output->max_latency = clamp_latency(histogram.get_max());
+  output->mean_latency = histogram.get_mean();
+  output->latency_stddev = histogram.get_stddev();
+  output->p50_latency = clamp_latency(histogram.get_percentile(50.0));
+  output->p99_latency = clamp_latency(histogram.get_percentile(99.0));
+  output->p999_latency = clamp_latency(histogram.get_percentile(99.9));
+  output->p9999_latency = clamp_latency(histogram.get_percentile(99.99));
+  output->negative_latencies = histogram.get_negative_count();
+}
+
+static void latency_to_stream(std::stringstream & sstring, const struct rttest_results & results)
+{
+  sstring << "    - Min: " << results.min_latency << " ns" << std::endl;
+  sstring << "    - Max: " << results.max_latency << " ns" << std::endl;
+  sstring << "    - Mean: " << results.mean_latency << " ns" << std::endl;
+  sstring << "    - Standard deviation: " << results.latency_stddev << std::endl;
+  sstring << "    - 50th percentile: " << results.p50_latency << " ns" << std::endl;
+  sstring << "    - 99th percentile: " << results.p99_latency << " ns" << std::endl;
+  sstring << "    - 99.9th percentile: " << results.p999_latency << " ns" << std::endl;
+  sstring << "    - 99.99th percentile: " << results.p9999_latency << " ns" << std::endl;
+  sstring << "    - Negative latencies: " << results.negative_latencies << std::endl;
+}
+
 Rttest::Rttest()
+: latency_histogram(std::make_shared<LatencyHistogram>())
 {
+  memset(&this->params, 0, sizeof(struct rttest_params));
   memset(&this->results, 0, sizeof(struct rttest_results));
   this->results.min_latency = INT_MAX;
   this->results.max_latency = INT_MIN;
@@ -225,11 +294,7 @@ int Rttest::record_jitter(
   const struct timespec * deadline,
   const struct timespec * result_time, const size_t iteration)
 {
-  size_t i = iteration;
-  // Check if settings authorize buffer recording
-  if (this->params.iterations == 0) {
-    i = 0;
-  }
+  size_t i = this->get_sample_index(iteration);
   struct timespec jitter;
   int parity = 1;
   if (timespec_gt(result_time, deadline)) {
@@ -247,6 +312,14 @@ int Rttest::record_jitter(
   return 0;
 }
 
+size_t Rttest::get_sample_index(size_t iteration) const
+{
+  if (this->sample_buffer.buffer_size == 1) {
+    return 0;
+  }
+  return iteration;
+}
+
 
 Rttest * get_rttest_thread_instance(pthread_t thread_id)
 {
@@ -273,10 +346,12 @@ int Rttest::read_args(int argc, char ** argv)
   // -f,--filename
   // Don't write a file unless filename specified
   char * filename = nullptr;
+  // -b,--histogram-filename
+  char * histogram_filename = nullptr;
   int index;
   int c;
 
-  std::string args_string = "i:u:p:t:s:m:f:r:";
+  std::string args_string = "i:u:p:t:s:m:f:r:b:";
   opterr = 0;
   optind = 1;
 
@@ -352,6 +427,9 @@ int Rttest::read_args(int argc, char ** argv)
       case 'f':
         filename = optarg;
         break;
+      case 'b':
+        histogram_filename = optarg;
+        break;
       case '?':
         if (args_string.find(optopt) != std::string::npos) {
           fprintf(stderr, "Option -%c requires an argument.\n", optopt);
@@ -367,7 +445,8 @@ int Rttest::read_args(int argc, char ** argv)
   }
 
   return this->init(
-    iterations, update_period, sched_policy, sched_priority, stack_size, filename);
+    iterations, update_period, sched_policy, sched_priority, stack_size, filename,
+    histogram_filename);
 }
 
 int rttest_get_params(struct rttest_params * params_in)
@@ -425,7 +504,7 @@ int rttest_read_args(int argc, char ** argv)
 int Rttest::init(
   size_t iterations, struct timespec update_period,
   size_t sched_policy, int sched_priority, size_t stack_size,
-  char * filename)
+  char * filename, char * histogram_filename)
 {
   this->params.iterations = iterations;
   this->params.update_period = update_period;
@@ -434,19 +513,25 @@ int Rttest::init(
   this->params.stack_size = stack_size;
 
   if (filename != nullptr) {
-    size_t n = strlen(filename);
-    this->params.filename = static_cast<char *>(std::malloc(n * sizeof(char) + 1));
+    this->params.filename = copy_filename(filename);
     if (!this->params.filename) {
-      fprintf(stderr, "Failed to allocate major pagefaults buffer\n");
       return -1;
     }
-    this->params.filename[n] = 0;
-    strncpy(this->params.filename, filename, n);
     fprintf(stderr, "Writing results to file: %s\n", this->params.filename);
   } else {
     this->params.filename = nullptr;
   }
 
+  if (histogram_filename != nullptr) {
+    this->params.histogram_filename = copy_filename(histogram_filename);
+    if (!this->params.histogram_filename) {
+      return -1;
+    }
+    fprintf(stderr, "Writing histograms to file: %s\n", this->params.histogram_filename);
+  } else {
+    this->params.histogram_filename = nullptr;
+  }
+
   this->initialize_dynamic_memory();
   this->running = 1;
   return 0;
@@ -454,12 +539,15 @@ int Rttest::init(
 
 void Rttest::initialize_dynamic_memory()
 {
-  size_t iterations = this->params.iterations;
+  // Every sample is only kept when they are written to a file; the statistics come from the
+  // latency histogram, so that the memory used does not grow with the number of iterations
+  size_t iterations = this->params.filename != nullptr ? this->params.iterations : 0;
   if (iterations == 0) {
     // Allocate a sample buffer of size 1
     iterations = 1;
   }
   this->sample_buffer.resize(iterations);
+  this->latency_histogram->reset();
 }
 
 int rttest_init(
@@ -492,9 +580,7 @@ int Rttest::get_next_rusage(size_t i)
   }
   assert(this->prev_usage.ru_majflt >= prev_maj_pagefaults);
   assert(this->prev_usage.ru_minflt >= prev_min_pagefaults);
-  if (this->params.iterations == 0) {
-    i = 0;
-  }
+  i = this->get_sample_index(i);
   this->sample_buffer.major_pagefaults[i] =
     this->prev_usage.ru_majflt - prev_maj_pagefaults;
   this->sample_buffer.minor_pagefaults[i] =
@@ -748,14 +834,13 @@ int rttest_set_sched_priority(size_t sched_priority, int policy)
 
 int Rttest::accumulate_statistics(size_t iteration)
 {
-  size_t i = iteration;
   this->results.iteration = iteration;
-  if (params.iterations == 0) {
-    i = 0;
-  } else if (iteration > params.iterations) {
+  if (params.iterations > 0 && iteration > params.iterations) {
     return -1;
   }
+  size_t i = this->get_sample_index(iteration);
   int latency = sample_buffer.latency_samples[i];
+  this->latency_histogram->record(latency);
   if (latency > this->results.max_latency) {
     this->results.max_latency = latency;
   }
@@ -782,47 +867,11 @@ int Rttest::calculate_statistics(struct rttest_results * output)
     fprintf(stderr, "Need to allocate rttest_results struct\n");
     return -1;
   }
-  if (this->sample_buffer.latency_samples == NULL) {
-    fprintf(stderr, "Pointer to latency samples was NULL\n");
-    return -1;
-  }
-  if (this->sample_buffer.minor_pagefaults == NULL) {
-    fprintf(stderr, "Pointer to minor pagefaults was NULL\n");
-    return -1;
-  }
-  if (this->sample_buffer.major_pagefaults == NULL) {
-    fprintf(stderr, "Pointer to major pagefaults was NULL\n");
-    return -1;
-  }
-
-  std::vector<int> latency_dataset;
-  latency_dataset.assign(this->sample_buffer.latency_samples,
-    this->sample_buffer.latency_samples + this->sample_buffer.buffer_size);
-
-  output->min_latency = *std::min_element(latency_dataset.begin(),
-      latency_dataset.end());
-  output->max_latency = *std::max_element(latency_dataset.begin(),
-      latency_dataset.end());
-  output->mean_latency = std::accumulate(latency_dataset.begin(),
-      latency_dataset.end(), 0.0) / latency_dataset.size();
-
-  // Calculate standard deviation and try to avoid overflow
-  std::vector<int> latency_diff(latency_dataset.size());
-  std::transform(latency_dataset.begin(), latency_dataset.end(), latency_diff.begin(),
-    std::bind2nd(std::minus<int>(), output->mean_latency));
-  int sq_sum = std::inner_product(latency_diff.begin(), latency_diff.end(),
-      latency_diff.begin(), 0);
-  output->latency_stddev = std::sqrt(sq_sum / latency_dataset.size());
-
-  std::vector<size_t> min_pagefaults;
-  min_pagefaults.assign(this->sample_buffer.minor_pagefaults,
-    this->sample_buffer.minor_pagefaults + this->sample_buffer.buffer_size);
-  output->minor_pagefaults = std::accumulate(min_pagefaults.begin(), min_pagefaults.end(), 0);
-
-  std::vector<size_t> maj_pagefaults;
-  maj_pagefaults.assign(this->sample_buffer.major_pagefaults,
-    this->sample_buffer.major_pagefaults + this->sample_buffer.buffer_size);
-  output->major_pagefaults = std::accumulate(maj_pagefaults.begin(), maj_pagefaults.end(), 0);
+
+  histogram_to_results(*this->latency_histogram, output);
+  output->iteration = this->results.iteration;
+  output->minor_pagefaults = this->results.minor_pagefaults;
+  output->major_pagefaults = this->results.major_pagefaults;
   return 0;
 }
 
@@ -853,7 +902,8 @@ int rttest_get_statistics(struct rttest_results * output)
 
 int Rttest::get_sample_at(const size_t iteration, int & sample) const
 {
-  if (this->params.iterations == 0) {
+  if (this->params.iterations == 0 || this->sample_buffer.buffer_size == 1) {
+    // Only the last sample is kept
     sample = this->sample_buffer.latency_samples[0];
     return 0;
   }
@@ -889,10 +939,7 @@ std::string Rttest::results_to_string(char * name)
   sstring << "  - Minor pagefaults: " << results.minor_pagefaults << std::endl;
   sstring << "  - Major pagefaults: " << results.major_pagefaults << std::endl;
   sstring << "  Latency (time after deadline was missed):" << std::endl;
-  sstring << "    - Min: " << results.min_latency << " ns" << std::endl;
-  sstring << "    - Max: " << results.max_latency << " ns" << std::endl;
-  sstring << "    - Mean: " << results.mean_latency << " ns" << std::endl;
-  sstring << "    - Standard deviation: " << results.latency_stddev << std::endl;
+  latency_to_stream(sstring, results);
   sstring << std::endl;
 
   return sstring.str();
@@ -906,6 +953,22 @@ int rttest_finish()
   }
   int status = thread_rttest_instance->finish();
 
+  // Phases span threads, print them once
+  if (pthread_self() == initial_thread_id) {
+    std::stringstream sstring;
+    size_t phase_count = rttest_phase_count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < phase_count; ++i) {
+      struct rttest_results results;
+      rttest_get_phase_statistics(i, &results);
+      sstring << "  Phase " << rttest_phases[i]->name << " (" << results.iteration <<
+        " samples):" << std::endl;
+      latency_to_stream(sstring, results);
+    }
+    if (phase_count > 0) {
+      printf("%s\n", sstring.str().c_str());
+    }
+  }
+
   rttest_instance_map.erase(pthread_self());
 
   return status;
@@ -920,6 +983,7 @@ int Rttest::finish()
   this->calculate_statistics(&this->results);
   printf("%s\n", this->results_to_string(this->params.filename).c_str());
   free(this->params.filename);
+  free(this->params.histogram_filename);
 
   return 0;
 }
@@ -944,13 +1008,22 @@ int rttest_write_results()
 
 int Rttest::write_results()
 {
+  if (this->params.histogram_filename != nullptr) {
+    if (this->write_histogram_file(this->params.histogram_filename) != 0) {
+      return -1;
+    }
+    if (this->params.filename == nullptr) {
+      return 0;
+    }
+  }
   return this->write_results_file(this->params.filename);
 }
 
 int Rttest::write_results_file(char * filename)
 {
-  if (this->params.iterations == 0) {
+  if (this->params.iterations == 0 || this->sample_buffer.buffer_size != this->params.iterations) {
     fprintf(stderr, "No sample buffer was saved, not writing results\n");
+    fprintf(stderr, "Samples are only saved when a filename is passed to rttest_init\n");
     return -1;
   }
   if (filename == NULL) {
@@ -991,6 +1064,112 @@ int Rttest::write_results_file(char * filename)
   return 0;
 }
 
+int rttest_write_histogram_file(char * filename)
+{
+  auto thread_rttest_instance = get_rttest_thread_instance(pthread_self());
+  if (!thread_rttest_instance) {
+    return -1;
+  }
+  return thread_rttest_instance->write_histogram_file(filename);
+}
+
+int Rttest::write_histogram_file(char * filename)
+{
+  if (filename == NULL) {
+    fprintf(stderr, "No histogram filename given, not writing histograms\n");
+    return -1;
+  }
+
+  std::ofstream fstream(filename, std::ios::out | std::ios::binary);
+
+  if (!fstream.is_open()) {
+    fprintf(stderr, "Couldn't open file %s, not writing histograms\n", filename);
+    return -1;
+  }
+
+  // See README.md for the description of the format
+  fstream.write("RTTH", 4);
+  LatencyHistogram::write_value<uint32_t>(fstream, 2);
+  LatencyHistogram::write_value<uint32_t>(fstream, LatencyHistogram::sub_bucket_bits);
+  LatencyHistogram::write_value<uint32_t>(fstream, LatencyHistogram::bucket_count);
+  LatencyHistogram::write_value<uint64_t>(fstream, this->params.iterations);
+  LatencyHistogram::write_value<uint64_t>(
+    fstream, timespec_to_long(&this->params.update_period));
+  LatencyHistogram::write_value<uint64_t>(fstream, this->results.minor_pagefaults);
+  LatencyHistogram::write_value<uint64_t>(fstream, this->results.major_pagefaults);
+  size_t phase_count = rttest_phase_count.load(std::memory_order_acquire);
+  LatencyHistogram::write_value<uint32_t>(fstream, static_cast<uint32_t>(1 + phase_count));
+  this->latency_histogram->write(fstream, "latency");
+  for (size_t i = 0; i < phase_count; ++i) {
+    rttest_phases[i]->histogram.write(fstream, rttest_phases[i]->name);
+  }
+
+  if (!fstream.good()) {
+    fprintf(stderr, "Couldn't write histograms to file %s\n", filename);
+    return -1;
+  }
+  fstream.close();
+
+  return 0;
+}
+
+int rttest_register_phase(const char * name, size_t * phase_id)
+{
+  if (name == NULL || phase_id == NULL) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(rttest_phase_mutex);
+  size_t phase_count = rttest_phase_count.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < phase_count; ++i) {
+    if (rttest_phases[i]->name == name) {
+      *phase_id = i;
+      return 0;
+    }
+  }
+  if (phase_count == RTTEST_MAX_PHASES) {
+    fprintf(stderr, "Cannot register more than %d phases\n", RTTEST_MAX_PHASES);
+    return -1;
+  }
+  rttest_phases[phase_count].reset(new rttest_phase());
+  rttest_phases[phase_count]->name = name;
+  rttest_phase_count.store(phase_count + 1, std::memory_order_release);
+  *phase_id = phase_count;
+  return 0;
+}
+
+int rttest_record_phase(size_t phase_id, int64_t latency)
+{
+  if (phase_id >= rttest_phase_count.load(std::memory_order_acquire)) {
+    return -1;
+  }
+  rttest_phases[phase_id]->histogram.record(latency);
+  return 0;
+}
+
+int rttest_record_phase_since(size_t phase_id, const struct timespec * start_time)
+{
+  if (start_time == NULL) {
+    return -1;
+  }
+  struct timespec current_time;
+  clock_gettime(CLOCK_MONOTONIC, &current_time);
+  int64_t latency = static_cast<int64_t>(timespec_to_long(&current_time)) -
+    static_cast<int64_t>(timespec_to_long(start_time));
+  return rttest_record_phase(phase_id, latency);
+}
+
+int rttest_get_phase_statistics(size_t phase_id, struct rttest_results * results)
+{
+  if (results == NULL || phase_id >= rttest_phase_count.load(std::memory_order_acquire)) {
+    return -1;
+  }
+  const LatencyHistogram & histogram = rttest_phases[phase_id]->histogram;
+  memset(results, 0, sizeof(struct rttest_results));
+  histogram_to_results(histogram, results);
+  results->iteration = histogram.get_count();
+  return 0;
+}
+
 int rttest_running()
 {
   auto thread_rttest_instance = get_rttest_thread_instance(pthread_self());
@@ -15,6 +15,11 @@
 #include <sys/resource.h>
 
 #include <array>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 
 #include "rttest/rttest.h"
@@ -160,3 +165,137 @@ TEST(TestApi, running) {
   EXPECT_EQ(0, rttest_finish());
   EXPECT_EQ(0, rttest_running());
 }
+
+TEST(TestApi, calculate_statistics) {
+  struct timespec update_period;
+  update_period.tv_sec = 0;
+  update_period.tv_nsec = 100000;
+  EXPECT_EQ(0, rttest_init(100, update_period, SCHED_RR, 80, 0, NULL));
+  size_t counter = 0;
+  EXPECT_EQ(0, rttest_spin(test_callback, static_cast<void *>(&counter)));
+
+  struct rttest_results results;
+  EXPECT_EQ(0, rttest_calculate_statistics(&results));
+  EXPECT_EQ(99u, results.iteration);
+  EXPECT_LE(results.min_latency, results.p50_latency);
+  EXPECT_LE(results.p50_latency, results.p99_latency);
+  EXPECT_LE(results.p99_latency, results.p999_latency);
+  EXPECT_LE(results.p999_latency, results.p9999_latency);
+  EXPECT_LE(results.p9999_latency, results.max_latency);
+  EXPECT_GE(results.mean_latency, results.min_latency);
+  EXPECT_LE(results.mean_latency, results.max_latency);
+
+  // No filename was given, so only the last sample is kept
+  int sample;
+  EXPECT_EQ(0, rttest_get_sample_at(results.iteration, &sample));
+  EXPECT_NE(0, rttest_write_results_file(const_cast<char *>("rttest_no_samples.txt")));
+
+  EXPECT_EQ(0, rttest_finish());
+}
+
+TEST(TestApi, phases) {
+  size_t phase_id;
+  EXPECT_EQ(0, rttest_register_phase("test_phases", &phase_id));
+  size_t same_phase_id;
+  EXPECT_EQ(0, rttest_register_phase("test_phases", &same_phase_id));
+  EXPECT_EQ(phase_id, same_phase_id);
+  EXPECT_NE(0, rttest_record_phase(RTTEST_MAX_PHASES, 1));
+
+  for (int64_t latency = 1; latency <= 10000; ++latency) {
+    EXPECT_EQ(0, rttest_record_phase(phase_id, latency));
+  }
+  struct rttest_results results;
+  EXPECT_EQ(0, rttest_get_phase_statistics(phase_id, &results));
+  EXPECT_EQ(10000u, results.iteration);
+  EXPECT_EQ(1, results.min_latency);
+  EXPECT_EQ(10000, results.max_latency);
+  EXPECT_DOUBLE_EQ(5000.5, results.mean_latency);
+  EXPECT_NEAR(2886.75, results.latency_stddev, 30.0);
+  // Percentiles are at most 1% above the exact value
+  EXPECT_GE(results.p50_latency, 5000);
+  EXPECT_LE(results.p50_latency, 5050);
+  EXPECT_GE(results.p99_latency, 9900);
+  EXPECT_LE(results.p99_latency, 9999);
+  EXPECT_GE(results.p999_latency, 9990);
+  EXPECT_LE(results.p999_latency, 10000);
+  EXPECT_EQ(10000, results.p9999_latency);
+}
+
+TEST(TestApi, phases_negative) {
+  size_t phase_id;
+  EXPECT_EQ(0, rttest_register_phase("test_phases_negative", &phase_id));
+  for (int64_t latency = -5000; latency < 5000; ++latency) {
+    EXPECT_EQ(0, rttest_record_phase(phase_id, latency));
+  }
+  struct rttest_results results;
+  EXPECT_EQ(0, rttest_get_phase_statistics(phase_id, &results));
+  EXPECT_EQ(10000u, results.iteration);
+  EXPECT_EQ(5000u, results.negative_latencies);
+  EXPECT_EQ(-5000, results.min_latency);
+  EXPECT_EQ(4999, results.max_latency);
+  EXPECT_DOUBLE_EQ(-0.5, results.mean_latency);
+  EXPECT_NEAR(2886.75, results.latency_stddev, 30.0);
+  // Negative latencies rank below zero instead of being counted as no latency
+  EXPECT_EQ(-1, results.p50_latency);
+  EXPECT_GE(results.p99_latency, 4899);
+  EXPECT_LE(results.p99_latency, 4949);
+  EXPECT_EQ(4999, results.p9999_latency);
+
+  size_t early_phase_id;
+  EXPECT_EQ(0, rttest_register_phase("test_phases_early", &early_phase_id));
+  for (int64_t latency = 1; latency <= 100; ++latency) {
+    EXPECT_EQ(0, rttest_record_phase(early_phase_id, -latency * 1000));
+  }
+  EXPECT_EQ(0, rttest_get_phase_statistics(early_phase_id, &results));
+  EXPECT_EQ(100u, results.negative_latencies);
+  // Percentiles are at most 1% above the exact value
+  EXPECT_GE(results.p50_latency, -51000);
+  EXPECT_LE(results.p50_latency, -50500);
+  EXPECT_EQ(-1000, results.p9999_latency);
+}
+
+TEST(TestApi, phases_threads) {
+  size_t phase_id;
+  EXPECT_EQ(0, rttest_register_phase("test_phases_threads", &phase_id));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back(
+      [phase_id]() {
+        struct timespec start_time;
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        for (int i = 0; i < 10000; ++i) {
+          rttest_record_phase_since(phase_id, &start_time);
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  struct rttest_results results;
+  EXPECT_EQ(0, rttest_get_phase_statistics(phase_id, &results));
+  EXPECT_EQ(40000u, results.iteration);
+  EXPECT_GE(results.min_latency, 0);
+}
+
+TEST(TestApi, write_histogram_file) {
+  size_t phase_id;
+  EXPECT_EQ(0, rttest_register_phase("test_write_histogram_file", &phase_id));
+  EXPECT_EQ(0, rttest_record_phase(phase_id, 1000));
+  struct timespec update_period;
+  update_period.tv_sec = 0;
+  update_period.tv_nsec = 100000;
+  EXPECT_EQ(0, rttest_init(10, update_period, SCHED_RR, 80, 0, NULL));
+  size_t counter = 0;
+  EXPECT_EQ(0, rttest_spin(test_callback, static_cast<void *>(&counter)));
+  char filename[] = "rttest_histograms.bin";
+  EXPECT_EQ(0, rttest_write_histogram_file(filename));
+  EXPECT_EQ(0, rttest_finish());
+
+  std::ifstream file(filename, std::ios::binary);
+  ASSERT_TRUE(file.is_open());
+  std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  EXPECT_EQ("RTTH", content.substr(0, 4));
+  EXPECT_NE(std::string::npos, content.find("latency"));
+  EXPECT_NE(std::string::npos, content.find("test_write_histogram_file"));
+  std::remove(filename);
+}
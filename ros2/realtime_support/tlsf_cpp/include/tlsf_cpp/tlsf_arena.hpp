@@ -0,0 +1,430 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Thread-safe TLSF memory pool with lock-free per-thread caches of small blocks, and an allocator
+// implementing the allocator_traits template on top of it.
+// Unlike tlsf_heap_allocator, an arena can be shared by allocators used from several threads,
+// e.g. by the publishers, subscriptions and AllocatorMemoryStrategy of a multithreaded executor.
+
+#ifndef TLSF_CPP__TLSF_ARENA_HPP_
+#define TLSF_CPP__TLSF_ARENA_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+
+#include "tlsf/tlsf.h"
+
+namespace tlsf_cpp
+{
+
+struct tlsf_arena_statistics
+{
+  /// Size of the memory pool in bytes.
+  size_t pool_size;
+  /// Bytes currently allocated from the pool, including the blocks held by thread caches.
+  size_t used_size;
+  /// Highest value reached by used_size.
+  size_t high_water_mark;
+  /// Bytes which are free in the pool.
+  size_t free_size;
+  /// Size of the largest block which can still be allocated from the pool.
+  size_t largest_free_block;
+  /// 1 - largest_free_block / free_size, 0 when all the free memory is contiguous.
+  double fragmentation;
+  /// Number of allocations served by the pool; allocations served by a thread cache are excluded.
+  size_t pool_allocations;
+  /// Number of allocations which failed because the pool was exhausted.
+  size_t failed_allocations;
+};
+
+/// TLSF memory pool of a fixed size, allocated and touched once at construction.
+/**
+ * Blocks of up to max_cached_size bytes are served by a per-thread cache without taking any lock.
+ * When a cache is empty it is refilled with a few blocks at once from the pool, and when it holds
+ * too many blocks half of them are given back, both under the pool mutex.
+ * Larger blocks always come from the pool.
+ *
+ * Each thread registers its cache on the first allocation from an arena, which may allocate
+ * from the system; call prepare_thread() from a thread before it enters its realtime section.
+ */
+class tlsf_arena
+{
+public:
+  static constexpr size_t default_pool_size = 8 * 1024 * 1024;
+  /// Cached size classes are powers of two from min_cached_size to max_cached_size bytes.
+  static constexpr size_t min_cached_size = 16;
+  static constexpr size_t num_size_classes = 8;
+  static constexpr size_t max_cached_size = min_cached_size << (num_size_classes - 1);
+  /// Number of blocks taken from the pool when a thread cache is empty.
+  static constexpr size_t refill_count = 8;
+  /// Maximum number of blocks of each size class kept by a thread.
+  static constexpr size_t max_cached_blocks = 64;
+  /// Number of arenas a thread can keep a cache for.
+  static constexpr size_t max_thread_caches = 4;
+
+  explicit tlsf_arena(size_t pool_size)
+  : pool_size_(pool_size), memory_pool_(new char[pool_size]), used_size_(0),
+    high_water_mark_(0), pool_allocations_(0), failed_allocations_(0)
+  {
+    // Touch the whole pool now, so that no page fault happens when it is used
+    memset(memory_pool_, 0, pool_size_);
+    // Leave the default pool of tlsf_malloc(), used by tlsf_heap_allocator, alone
+    init_memory_pool_ex(pool_size_, memory_pool_);
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    id_ = ++last_id();
+    registry()[id_] = this;
+  }
+
+  ~tlsf_arena()
+  {
+    {
+      std::lock_guard<std::mutex> lock(registry_mutex());
+      registry().erase(id_);
+    }
+    destroy_memory_pool(memory_pool_);
+    delete[] memory_pool_;
+  }
+
+  tlsf_arena(const tlsf_arena &) = delete;
+  tlsf_arena & operator=(const tlsf_arena &) = delete;
+
+  /// Arena shared by default constructed tlsf_arena_allocator.
+  /**
+   * The pool size is fixed by the first call; call this at startup to choose it.
+   */
+  static tlsf_arena & get_default(size_t pool_size = default_pool_size)
+  {
+    static tlsf_arena arena(pool_size);
+    return arena;
+  }
+
+  /// Register the cache of the calling thread, see the class documentation.
+  void prepare_thread()
+  {
+    get_thread_cache();
+  }
+
+  /// Allocate a block of at least size bytes, aligned like malloc(), or return nullptr.
+  void * allocate(size_t size)
+  {
+    size_t size_class = get_size_class(size);
+    if (size_class < num_size_classes) {
+      thread_cache * cache = get_thread_cache();
+      if (cache) {
+        if (!cache->free_lists[size_class]) {
+          refill(*cache, size_class);
+        }
+        void * block = cache->free_lists[size_class];
+        if (block) {
+          cache->free_lists[size_class] = *static_cast<void **>(block);
+          --cache->counts[size_class];
+        }
+        return block;
+      }
+      size = min_cached_size << size_class;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocate_from_pool(size, size_class);
+  }
+
+  /// Give back a block returned by allocate() or reallocate(); the calling thread may differ.
+  void deallocate(void * ptr)
+  {
+    if (!ptr) {
+      return;
+    }
+    size_t size_class = get_header(ptr)->size_class;
+    if (size_class < num_size_classes) {
+      thread_cache * cache = get_thread_cache();
+      if (cache) {
+        *static_cast<void **>(ptr) = cache->free_lists[size_class];
+        cache->free_lists[size_class] = ptr;
+        if (++cache->counts[size_class] > max_cached_blocks) {
+          flush(*cache, size_class, max_cached_blocks / 2);
+        }
+        return;
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    deallocate_to_pool(ptr);
+  }
+
+  /// Same as realloc(), the content of the block is kept if it has to move.
+  void * reallocate(void * ptr, size_t size)
+  {
+    if (!ptr) {
+      return allocate(size);
+    }
+    size_t old_size = get_header(ptr)->size;
+    if (size <= old_size) {
+      return ptr;
+    }
+    void * new_ptr = allocate(size);
+    if (new_ptr) {
+      memcpy(new_ptr, ptr, old_size);
+      deallocate(ptr);
+    }
+    return new_ptr;
+  }
+
+  tlsf_arena_statistics get_statistics()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tlsf_arena_statistics statistics;
+    statistics.pool_size = pool_size_;
+    statistics.used_size = used_size_;
+    statistics.high_water_mark = high_water_mark_;
+    statistics.free_size = get_free_size(memory_pool_);
+    statistics.largest_free_block = get_largest_free_block(memory_pool_);
+    statistics.fragmentation = statistics.free_size ?
+      1.0 - static_cast<double>(statistics.largest_free_block) / statistics.free_size : 0.0;
+    statistics.pool_allocations = pool_allocations_;
+    statistics.failed_allocations = failed_allocations_;
+    return statistics;
+  }
+
+private:
+  // Stored in front of every block, keeps the alignment given by TLSF.
+  struct alignas(16) block_header
+  {
+    size_t size;
+    size_t size_class;
+  };
+
+  struct thread_cache
+  {
+    uint64_t arena_id;
+    void * free_lists[num_size_classes];
+    size_t counts[num_size_classes];
+  };
+
+  struct thread_caches
+  {
+    thread_cache caches[max_thread_caches];
+
+    ~thread_caches()
+    {
+      // Give the cached blocks back to the arenas which still exist
+      std::lock_guard<std::mutex> lock(registry_mutex());
+      for (auto & cache : caches) {
+        auto it = registry().find(cache.arena_id);
+        if (it != registry().end()) {
+          for (size_t size_class = 0; size_class < num_size_classes; ++size_class) {
+            it->second->flush(cache, size_class, 0);
+          }
+        }
+      }
+    }
+  };
+
+  static size_t get_size_class(size_t size)
+  {
+    size_t size_class = 0;
+    while (size_class < num_size_classes && (min_cached_size << size_class) < size) {
+      ++size_class;
+    }
+    return size_class;
+  }
+
+  static block_header * get_header(void * ptr)
+  {
+    return static_cast<block_header *>(ptr) - 1;
+  }
+
+  static std::mutex & registry_mutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  // Arenas which exist by id, ids are never reused unlike addresses.
+  static std::map<uint64_t, tlsf_arena *> & registry()
+  {
+    static std::map<uint64_t, tlsf_arena *> arenas;
+    return arenas;
+  }
+
+  static uint64_t & last_id()
+  {
+    static uint64_t id = 0;
+    return id;
+  }
+
+  // Return the cache of this arena for the calling thread, or nullptr if it has no free slot.
+  thread_cache * get_thread_cache()
+  {
+    static thread_local thread_caches local;
+    for (auto & cache : local.caches) {
+      if (cache.arena_id == id_) {
+        return &cache;
+      }
+    }
+    // First use of this arena by this thread, take a slot which is unused or belongs to an arena
+    // which was destroyed (its blocks went away with it)
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    for (auto & cache : local.caches) {
+      if (cache.arena_id == 0 || registry().find(cache.arena_id) == registry().end()) {
+        memset(&cache, 0, sizeof(cache));
+        cache.arena_id = id_;
+        return &cache;
+      }
+    }
+    return nullptr;
+  }
+
+  void refill(thread_cache & cache, size_t size_class)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < refill_count; ++i) {
+      void * block = allocate_from_pool(min_cached_size << size_class, size_class);
+      if (!block) {
+        break;
+      }
+      *static_cast<void **>(block) = cache.free_lists[size_class];
+      cache.free_lists[size_class] = block;
+      ++cache.counts[size_class];
+    }
+  }
+
+  void flush(thread_cache & cache, size_t size_class, size_t keep)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (cache.counts[size_class] > keep) {
+      void * block = cache.free_lists[size_class];
+      cache.free_lists[size_class] = *static_cast<void **>(block);
+      --cache.counts[size_class];
+      deallocate_to_pool(block);
+    }
+  }
+
+  // Must be called with mutex_ held.
+  void * allocate_from_pool(size_t size, size_t size_class)
+  {
+    void * raw = malloc_ex(sizeof(block_header) + size, memory_pool_);
+    if (!raw) {
+      ++failed_allocations_;
+      return nullptr;
+    }
+    block_header * header = static_cast<block_header *>(raw);
+    header->size = size;
+    header->size_class = size_class;
+    used_size_ += sizeof(block_header) + size;
+    if (used_size_ > high_water_mark_) {
+      high_water_mark_ = used_size_;
+    }
+    ++pool_allocations_;
+    return header + 1;
+  }
+
+  // Must be called with mutex_ held.
+  void deallocate_to_pool(void * ptr)
+  {
+    block_header * header = get_header(ptr);
+    used_size_ -= sizeof(block_header) + header->size;
+    free_ex(header, memory_pool_);
+  }
+
+  uint64_t id_;
+  size_t pool_size_;
+  char * memory_pool_;
+  std::mutex mutex_;
+  size_t used_size_;
+  size_t high_water_mark_;
+  size_t pool_allocations_;
+  size_t failed_allocations_;
+};
+
+template<typename T>
+struct tlsf_arena_allocator
+{
+  // Needed for std::allocator_traits
+  using value_type = T;
+
+  // Needed for std::allocator_traits
+  tlsf_arena_allocator() noexcept
+  : arena(&tlsf_arena::get_default())
+  {
+  }
+
+  explicit tlsf_arena_allocator(tlsf_arena & arena) noexcept
+  : arena(&arena)
+  {
+  }
+
+  // Needed for std::allocator_traits
+  template<typename U>
+  tlsf_arena_allocator(const tlsf_arena_allocator<U> & alloc) noexcept
+  : arena(alloc.arena)
+  {
+  }
+
+  // Needed for std::allocator_traits
+  T * allocate(size_t size)
+  {
+    T * ptr = static_cast<T *>(arena->allocate(size * sizeof(T)));
+    if (ptr == nullptr && size > 0) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  // Needed for std::allocator_traits
+  void deallocate(T * ptr, size_t)
+  {
+    arena->deallocate(ptr);
+  }
+
+  // Used by rclcpp::allocator::get_rcl_allocator() to implement rcl reallocate
+  T * reallocate(T * ptr, size_t size)
+  {
+    T * new_ptr = static_cast<T *>(arena->reallocate(ptr, size * sizeof(T)));
+    if (new_ptr == nullptr && size > 0) {
+      throw std::bad_alloc();
+    }
+    return new_ptr;
+  }
+
+  template<typename U>
+  struct rebind
+  {
+    typedef tlsf_arena_allocator<U> other;
+  };
+
+  tlsf_arena * arena;
+};
+
+// Needed for std::allocator_traits
+template<typename T, typename U>
+constexpr bool operator==(
+  const tlsf_arena_allocator<T> & a,
+  const tlsf_arena_allocator<U> & b) noexcept
+{
+  return a.arena == b.arena;
+}
+
+// Needed for std::allocator_traits
+template<typename T, typename U>
+constexpr bool operator!=(
+  const tlsf_arena_allocator<T> & a,
+  const tlsf_arena_allocator<U> & b) noexcept
+{
+  return a.arena != b.arena;
+}
+
+}  // namespace tlsf_cpp
+
+#endif  // TLSF_CPP__TLSF_ARENA_HPP_
@@ -0,0 +1,196 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "tlsf_cpp/tlsf.hpp"
+#include "tlsf_cpp/tlsf_arena.hpp"
+
+using tlsf_cpp::tlsf_arena;
+using tlsf_cpp::tlsf_arena_allocator;
+
+TEST(TestTLSFArena, allocate_deallocate) {
+  tlsf_arena arena(1024 * 1024);
+  std::vector<void *> blocks;
+  for (size_t size : {0, 1, 16, 17, 100, 2048, 2049, 100000}) {
+    void * ptr = arena.allocate(size);
+    ASSERT_NE(nullptr, ptr);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t));
+    memset(ptr, 0xff, size);
+    blocks.push_back(ptr);
+  }
+  auto statistics = arena.get_statistics();
+  EXPECT_EQ(1024u * 1024u, statistics.pool_size);
+  EXPECT_GT(statistics.used_size, 100000u + 2049u);
+  EXPECT_EQ(statistics.used_size, statistics.high_water_mark);
+  EXPECT_EQ(0u, statistics.failed_allocations);
+
+  for (void * ptr : blocks) {
+    arena.deallocate(ptr);
+  }
+  statistics = arena.get_statistics();
+  // Small blocks stay in the cache of this thread
+  EXPECT_LT(statistics.used_size, 100000u);
+  EXPECT_GT(statistics.high_water_mark, 100000u + 2049u);
+  EXPECT_GE(statistics.fragmentation, 0.0);
+  EXPECT_LE(statistics.fragmentation, 1.0);
+}
+
+TEST(TestTLSFArena, heap_allocator_keeps_its_pool) {
+  tlsf_heap_allocator<char> heap(64 * 1024);
+  auto in_heap_pool = [&heap](const char * ptr) {
+      return ptr >= heap.memory_pool && ptr < heap.memory_pool + heap.pool_size;
+    };
+  char * before = heap.allocate(100);
+  EXPECT_TRUE(in_heap_pool(before));
+  {
+    // Creating an arena does not change the pool of tlsf_malloc()
+    tlsf_arena arena(1024 * 1024);
+    void * ptr = arena.allocate(4096);
+    ASSERT_NE(nullptr, ptr);
+    char * during = heap.allocate(100);
+    EXPECT_TRUE(in_heap_pool(during));
+    heap.deallocate(during, 100);
+    arena.deallocate(ptr);
+  }
+  // Nor does destroying it
+  char * after = heap.allocate(100);
+  EXPECT_TRUE(in_heap_pool(after));
+  memset(after, 0xff, 100);
+  heap.deallocate(after, 100);
+  heap.deallocate(before, 100);
+}
+
+TEST(TestTLSFArena, thread_cache_reuses_blocks) {
+  tlsf_arena arena(1024 * 1024);
+  void * ptr = arena.allocate(64);
+  size_t pool_allocations = arena.get_statistics().pool_allocations;
+  arena.deallocate(ptr);
+  for (size_t i = 0; i < 1000; ++i) {
+    void * other = arena.allocate(64);
+    arena.deallocate(other);
+  }
+  EXPECT_EQ(pool_allocations, arena.get_statistics().pool_allocations);
+}
+
+TEST(TestTLSFArena, reallocate_keeps_content) {
+  tlsf_arena arena(1024 * 1024);
+  char * ptr = static_cast<char *>(arena.allocate(10));
+  memcpy(ptr, "123456789", 10);
+  ptr = static_cast<char *>(arena.reallocate(ptr, 5000));
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_STREQ("123456789", ptr);
+  arena.deallocate(ptr);
+}
+
+TEST(TestTLSFArena, exhausted) {
+  tlsf_arena arena(64 * 1024);
+  EXPECT_EQ(nullptr, arena.allocate(128 * 1024));
+  EXPECT_EQ(1u, arena.get_statistics().failed_allocations);
+
+  tlsf_arena_allocator<char> alloc(arena);
+  EXPECT_THROW(alloc.allocate(128 * 1024), std::bad_alloc);
+}
+
+TEST(TestTLSFArena, fragmentation) {
+  tlsf_arena arena(1024 * 1024);
+  std::vector<void *> blocks;
+  for (size_t i = 0; i < 64; ++i) {
+    blocks.push_back(arena.allocate(8192));
+  }
+  double contiguous = arena.get_statistics().fragmentation;
+  // Free every other block, the free memory is split in holes of 8 KiB
+  for (size_t i = 0; i < blocks.size(); i += 2) {
+    arena.deallocate(blocks[i]);
+  }
+  auto statistics = arena.get_statistics();
+  EXPECT_GT(statistics.fragmentation, contiguous);
+  EXPECT_GT(statistics.free_size, 32u * 8192u);
+  for (size_t i = 1; i < blocks.size(); i += 2) {
+    arena.deallocate(blocks[i]);
+  }
+}
+
+TEST(TestTLSFArena, threads) {
+  tlsf_arena arena(16 * 1024 * 1024);
+  const size_t num_threads = 8;
+  const size_t iterations = 20000;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<char *>> leftovers(num_threads);
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back(
+      [&arena, &leftovers, t, iterations]() {
+        std::vector<char *> live;
+        for (size_t i = 0; i < iterations; ++i) {
+          size_t size = 1 + (i * 7919 + t * 104729) % 3000;
+          char * ptr = static_cast<char *>(arena.allocate(size));
+          ASSERT_NE(nullptr, ptr);
+          memset(ptr, static_cast<int>(t), size);
+          live.push_back(ptr);
+          if (live.size() > 32) {
+            EXPECT_EQ(static_cast<char>(t), live.front()[0]);
+            arena.deallocate(live.front());
+            live.erase(live.begin());
+          }
+        }
+        leftovers[t] = live;
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  // Blocks allocated by a thread can be given back by another one
+  std::thread(
+    [&arena, &leftovers]() {
+      for (auto & live : leftovers) {
+        for (char * ptr : live) {
+          arena.deallocate(ptr);
+        }
+      }
+    }).join();
+  auto statistics = arena.get_statistics();
+  EXPECT_EQ(0u, statistics.failed_allocations);
+  // The caches of the threads which exited were given back to the pool
+  EXPECT_EQ(0u, statistics.used_size);
+}
+
+TEST(TestTLSFArena, allocator_traits) {
+  tlsf_arena arena(1024 * 1024);
+  tlsf_arena_allocator<int> alloc(arena);
+  tlsf_arena_allocator<double> other(alloc);
+  EXPECT_TRUE(alloc == other);
+  EXPECT_FALSE(alloc == tlsf_arena_allocator<int>());
+
+  std::vector<int, tlsf_arena_allocator<int>> values(alloc);
+  for (int i = 0; i < 10000; ++i) {
+    values.push_back(i);
+  }
+  EXPECT_EQ(9999, values.back());
+
+  std::map<int, int, std::less<int>, tlsf_arena_allocator<std::pair<const int, int>>> map(alloc);
+  for (int i = 0; i < 1000; ++i) {
+    map[i] = i;
+  }
+  EXPECT_EQ(1000u, map.size());
+
+  auto shared = std::allocate_shared<int>(alloc, 42);
+  EXPECT_EQ(42, *shared);
+}
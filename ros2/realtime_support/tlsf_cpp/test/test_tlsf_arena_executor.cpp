@@ -0,0 +1,169 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/memory_tools/memory_tools.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/strategies/allocator_memory_strategy.hpp"
+#include "rclcpp/strategies/message_pool_memory_strategy.hpp"
+
+#include "rcutils/allocation_region.h"
+
+#include "std_msgs/msg/u_int32.hpp"
+#include "tlsf_cpp/tlsf_arena.hpp"
+
+using osrf_testing_tools_cpp::memory_tools::MemoryToolsService;
+using rclcpp::memory_strategies::allocator_memory_strategy::AllocatorMemoryStrategy;
+using rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrategy;
+using std_msgs::msg::UInt32;
+
+static const size_t number_of_threads = 3;
+static const uint32_t warmup_iterations = 100;
+static const uint32_t iterations = 1000;
+
+class TestTLSFArenaExecutor : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp()
+  {
+    osrf_testing_tools_cpp::memory_tools::initialize();
+    // Count the allocations of every thread against its current region
+    auto record = [](MemoryToolsService & service) {
+        rcutils_allocation_region_record(service.get_requested_size());
+        service.ignore();
+      };
+    osrf_testing_tools_cpp::memory_tools::on_malloc(record);
+    osrf_testing_tools_cpp::memory_tools::on_realloc(record);
+    osrf_testing_tools_cpp::memory_tools::on_calloc(record);
+    osrf_testing_tools_cpp::memory_tools::on_free(
+      [](MemoryToolsService & service) {
+        service.ignore();
+      });
+    rcutils_allocation_region_reset_stats();
+  }
+
+  void TearDown()
+  {
+    osrf_testing_tools_cpp::memory_tools::disable_monitoring();
+    osrf_testing_tools_cpp::memory_tools::uninitialize();
+  }
+
+  void expect_no_allocations(rcutils_allocation_region_t region)
+  {
+    rcutils_allocation_region_stats_t stats = rcutils_allocation_region_get_stats(region);
+    EXPECT_EQ(0u, stats.allocations) <<
+      stats.allocations << " allocations of " << stats.bytes << " bytes in " <<
+      rcutils_allocation_region_get_name(region) << " in " << iterations << " messages";
+  }
+};
+
+/*
+   Tests that once warmed up, a multithreaded executor allocating from the TLSF arena executes
+   subscriptions with a message pool without allocating.
+ */
+TEST_F(TestTLSFArenaExecutor, multithreaded_steady_state) {
+  if (!osrf_testing_tools_cpp::memory_tools::is_working()) {
+    fprintf(stderr, "memory tools are not preloaded, allocations are not counted\n");
+    return;
+  }
+  auto node = std::make_shared<rclcpp::Node>("tlsf_arena_executor");
+  auto publisher = node->create_publisher<UInt32>("tlsf_arena_executor", 10);
+  // Each callback may be executed by any thread of the executor, one at a time
+  auto msg_strategy = std::make_shared<MessagePoolMemoryStrategy<UInt32, number_of_threads>>();
+  std::atomic<uint32_t> received(0);
+  auto subscription = node->create_subscription<UInt32>(
+    "tlsf_arena_executor",
+    [&received](const UInt32::SharedPtr msg) {
+      received.store(msg->data);
+    }, 10, nullptr, false, msg_strategy);
+
+  rclcpp::executor::ExecutorArgs args;
+  args.memory_strategy = std::make_shared<AllocatorMemoryStrategy<
+        tlsf_cpp::tlsf_arena_allocator<void>>>();
+  rclcpp::executors::MultiThreadedExecutor executor(args, number_of_threads);
+  executor.add_node(node);
+  // The threads of the executor register their cache of the arena on their first allocation
+  std::thread spin_thread([&executor]() {
+      executor.spin();
+    });
+
+  UInt32 msg;
+  bool timed_out = false;
+  auto publish_and_wait = [&]() {
+      ++msg.data;
+      publisher->publish(msg);
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (received.load() < msg.data && !timed_out) {
+        std::this_thread::yield();
+        timed_out = std::chrono::steady_clock::now() > deadline;
+      }
+    };
+  // Wait for the subscription to be matched, then fill the caches and pools
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  msg.data = 1;
+  while (0u == received.load() && std::chrono::steady_clock::now() < deadline) {
+    publisher->publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  timed_out = 0u == received.load();
+  for (uint32_t i = 0; i < warmup_iterations && !timed_out; ++i) {
+    publish_and_wait();
+  }
+
+  rcutils_allocation_region_reset_stats();
+  osrf_testing_tools_cpp::memory_tools::enable_monitoring();
+  for (uint32_t i = 0; i < iterations && !timed_out; ++i) {
+    publish_and_wait();
+  }
+  osrf_testing_tools_cpp::memory_tools::disable_monitoring();
+
+  executor.cancel();
+  spin_thread.join();
+  ASSERT_FALSE(timed_out);
+
+  for (int region = RCUTILS_ALLOCATION_REGION_NONE; region < RCUTILS_ALLOCATION_REGION_COUNT;
+    ++region)
+  {
+    rcutils_allocation_region_stats_t stats =
+      rcutils_allocation_region_get_stats(static_cast<rcutils_allocation_region_t>(region));
+    printf("%12s: %8" PRIu64 " allocations, %10" PRIu64 " bytes\n",
+      rcutils_allocation_region_get_name(static_cast<rcutils_allocation_region_t>(region)),
+      stats.allocations, stats.bytes);
+  }
+  expect_no_allocations(RCUTILS_ALLOCATION_REGION_SERIALIZE);
+  expect_no_allocations(RCUTILS_ALLOCATION_REGION_DESERIALIZE);
+  expect_no_allocations(RCUTILS_ALLOCATION_REGION_EXECUTE);
+
+  auto statistics = tlsf_cpp::tlsf_arena::get_default().get_statistics();
+  EXPECT_EQ(0u, statistics.failed_allocations);
+}
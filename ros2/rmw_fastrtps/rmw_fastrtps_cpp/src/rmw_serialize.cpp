@@ -41,22 +41,24 @@ rmw_serialize(
 
   auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
   auto tss = new MessageTypeSupport_cpp(callbacks);
-  auto data_length = tss->getEstimatedSerializedSize(ros_message);
-  if (serialized_message->buffer_capacity < data_length) {
-    if (rmw_serialized_message_resize(serialized_message, data_length) != RMW_RET_OK) {
-      RMW_SET_ERROR_MSG("unable to dynamically resize serialized message");
-      return RMW_RET_ERROR;
+  // Serialized messages are usually reused, so try the buffer the message already has first.
+  // The size of the message is only computed when it does not fit.
+  size_t data_length = 0;
+  auto ret = tss->serializeROSmessageToBuffer(
+    ros_message, serialized_message->buffer, serialized_message->buffer_capacity, data_length);
+  if (!ret) {
+    auto estimated_length = tss->getEstimatedSerializedSize(ros_message);
+    if (serialized_message->buffer_capacity < estimated_length) {
+      if (rmw_serialized_message_resize(serialized_message, estimated_length) != RMW_RET_OK) {
+        delete tss;
+        RMW_SET_ERROR_MSG("unable to dynamically resize serialized message");
+        return RMW_RET_ERROR;
+      }
     }
+    ret = tss->serializeROSmessageToBuffer(
+      ros_message, serialized_message->buffer, serialized_message->buffer_capacity, data_length);
   }
-
-  eprosima::fastcdr::FastBuffer buffer(
-    reinterpret_cast<char *>(serialized_message->buffer), data_length);
-  eprosima::fastcdr::Cdr ser(
-    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
-
-  auto ret = tss->serializeROSmessage(ros_message, ser);
   serialized_message->buffer_length = data_length;
-  serialized_message->buffer_capacity = data_length;
   delete tss;
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
@@ -0,0 +1,77 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__SERIALIZATIONPLAN_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__SERIALIZATIONPLAN_HPP_
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+// Flattened description of how to (de)serialize a message type, built once per type from its
+// introspection members.
+// Nested messages are inlined, and consecutive primitive members whose in-memory layout matches
+// their CDR layout are merged into runs that are copied with a single memcpy.
+template<typename MembersType>
+struct SerializationPlan
+{
+  using MemberType = typename std::remove_const<
+    typename std::remove_pointer<decltype(std::declval<MembersType>().members_)>::type>::type;
+
+  struct Field
+  {
+    const MemberType * member;
+    // Offset of the field from the start of the outermost message the plan was built for.
+    size_t offset;
+  };
+
+  struct Step
+  {
+    enum Kind
+    {
+      // Primitives (and fixed size arrays of primitives) laid out in memory exactly as in CDR.
+      RUN,
+      // A single member handled on its own: bools, strings and primitive sequences.
+      FIELD,
+      // A fixed size array or a sequence of messages, each element driven by sub_plan.
+      MESSAGE_ARRAY
+    };
+
+    Kind kind;
+    // Offset of the first field of the step.
+    size_t offset;
+    // RUN only: CDR size of the first primitive, which is also the largest alignment in the run.
+    size_t first_size;
+    // RUN only: bytes covered by the run, first primitive included.
+    size_t length;
+    // All the fields of a RUN (used when the endianness does not allow a plain copy),
+    // or the single field of a FIELD or MESSAGE_ARRAY step.
+    std::vector<Field> fields;
+    // MESSAGE_ARRAY only.
+    const SerializationPlan * sub_plan;
+    const MembersType * sub_members;
+    size_t sub_members_max_align;
+  };
+
+  std::vector<Step> steps;
+  std::vector<std::unique_ptr<SerializationPlan>> sub_plans;
+};
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__SERIALIZATIONPLAN_HPP_
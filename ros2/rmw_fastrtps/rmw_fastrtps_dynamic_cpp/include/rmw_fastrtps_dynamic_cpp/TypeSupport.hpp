@@ -23,6 +23,9 @@
 #include <fastcdr/FastBuffer.h>
 #include <fastcdr/Cdr.h>
 #include <cassert>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 
 #include "rcutils/logging_macros.h"
@@ -41,6 +44,8 @@
 
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
+#include "rmw_fastrtps_dynamic_cpp/SerializationPlan.hpp"
+
 namespace rmw_fastrtps_dynamic_cpp
 {
 
@@ -100,12 +105,41 @@ struct StringHelper<rosidl_typesupport_introspection_c__MessageMembers>
     return std::string(data.data);
   }
 
+  // Serializes the string straight from its buffer, without an intermediate std::string.
+  static void serialize(eprosima::fastcdr::Cdr & ser, const rosidl_generator_c__String & c_string)
+  {
+    if (!c_string.data) {
+      RCUTILS_LOG_ERROR_NAMED(
+        "rmw_fastrtps_dynamic_cpp",
+        "rosidl_generator_c_String had invalid data");
+      ser << "";
+      return;
+    }
+    ser << static_cast<const char *>(c_string.data);
+  }
+
+  // Deserializes the string straight from the CDR buffer, without an intermediate std::string.
   static void assign(eprosima::fastcdr::Cdr & deser, void * field, bool)
   {
-    std::string str;
-    deser >> str;
+    uint32_t length = 0;
+    deser >> length;
+    const char * data = deser.getCurrentPosition();
+    size_t size = 0;
+    if (length > 0) {
+      // jump() does not record the size of the last datum, which Fast-CDR needs to align what
+      // follows, so the final character goes through the regular extraction operator.
+      if (length > 1 && !deser.jump(length - 1)) {
+        throw std::runtime_error("not enough data to deserialize rosidl_generator_c__String");
+      }
+      char last = '\0';
+      deser >> last;
+      // The serialized length accounts for the null terminator
+      size = last == '\0' ? length - 1 : length;
+    }
     rosidl_generator_c__String * c_str = static_cast<rosidl_generator_c__String *>(field);
-    rosidl_generator_c__String__assign(c_str, str.c_str());
+    if (!rosidl_generator_c__String__assignn(c_str, data, size)) {
+      throw std::runtime_error("unable to assign rosidl_generator_c__String");
+    }
   }
 };
 
@@ -148,15 +182,25 @@ protected:
   const MembersType * members_;
 
 private:
+  using Plan = SerializationPlan<MembersType>;
+
+  // Returns the serialization plan for members_, building it on first use.
+  const Plan & getPlan();
+
+  static void buildPlan(const MembersType * members, size_t base_offset, Plan & plan);
+
   size_t getEstimatedSerializedSize(
-    const MembersType * members, const void * ros_message, size_t current_alignment);
+    const Plan & plan, const void * ros_message, size_t current_alignment);
 
   bool serializeROSmessage(
-    eprosima::fastcdr::Cdr & ser, const MembersType * members, const void * ros_message);
+    eprosima::fastcdr::Cdr & ser, const Plan & plan, const void * ros_message);
 
   bool deserializeROSmessage(
-    eprosima::fastcdr::Cdr & deser, const MembersType * members, void * ros_message,
+    eprosima::fastcdr::Cdr & deser, const Plan & plan, void * ros_message,
     bool call_new);
+
+  std::unique_ptr<Plan> plan_;
+  std::once_flag plan_once_;
 };
 
 }  // namespace rmw_fastrtps_dynamic_cpp
@@ -18,6 +18,8 @@
 #include <fastcdr/FastBuffer.h>
 #include <fastcdr/Cdr.h>
 #include <cassert>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -238,33 +240,26 @@ void serialize_field<std::string>(
 {
   using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
   if (!member->is_array_) {
-    auto && str = CStringHelper::convert_to_std_string(field);
+    auto & c_string = *static_cast<rosidl_generator_c__String *>(field);
     // Control maximum length.
-    if (member->string_upper_bound_ && str.length() > member->string_upper_bound_ + 1) {
+    if (member->string_upper_bound_ && c_string.size > member->string_upper_bound_ + 1) {
       throw std::runtime_error("string overcomes the maximum length");
     }
-    ser << str;
+    CStringHelper::serialize(ser, c_string);
   } else {
-    // First, cast field to rosidl_generator_c
-    // Then convert to a std::string using StringHelper and serialize the std::string
+    // Strings are written straight from their rosidl_generator_c__String buffers
     if (member->array_size_ && !member->is_upper_bound_) {
-      // tmpstring is defined here and not below to avoid
-      // memory allocation in every iteration of the for loop
-      std::string tmpstring;
       auto string_field = static_cast<rosidl_generator_c__String *>(field);
       for (size_t i = 0; i < member->array_size_; ++i) {
-        tmpstring = string_field[i].data;
-        ser.serialize(tmpstring);
+        CStringHelper::serialize(ser, string_field[i]);
       }
     } else {
       auto & string_sequence_field =
         *reinterpret_cast<rosidl_generator_c__String__Sequence *>(field);
-      std::vector<std::string> cpp_string_vector;
+      ser << static_cast<uint32_t>(string_sequence_field.size);
       for (size_t i = 0; i < string_sequence_field.size; ++i) {
-        cpp_string_vector.push_back(
-          CStringHelper::convert_to_std_string(string_sequence_field.data[i]));
+        CStringHelper::serialize(ser, string_sequence_field.data[i]);
       }
-      ser << cpp_string_vector;
     }
   }
 }
@@ -302,93 +297,277 @@ size_t get_array_size_and_assign_field(
   return tmpsequence->size;
 }
 
+template<typename MemberType>
+void serialize_member(const MemberType * member, void * field, eprosima::fastcdr::Cdr & ser)
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      if (!member->is_array_) {
+        // don't cast to bool here because if the bool is
+        // uninitialized the random value can't be deserialized
+        ser << (*static_cast<uint8_t *>(field) ? true : false);
+      } else {
+        serialize_field<bool>(member, field, ser);
+      }
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      serialize_field<uint8_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      serialize_field<char>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      serialize_field<float>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      serialize_field<double>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      serialize_field<int16_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      serialize_field<uint16_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      serialize_field<int32_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      serialize_field<uint32_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      serialize_field<int64_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      serialize_field<uint64_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      serialize_field<std::string>(member, field, ser);
+      break;
+    default:
+      throw std::runtime_error("unknown type");
+  }
+}
+
+// Unsigned integer with the same size, alignment and byte order as any primitive of SIZE bytes.
+template<size_t SIZE>
+struct RunPrimitive;
+
+template<>
+struct RunPrimitive<1>
+{
+  using type = uint8_t;
+};
+
+template<>
+struct RunPrimitive<2>
+{
+  using type = uint16_t;
+};
+
+template<>
+struct RunPrimitive<4>
+{
+  using type = uint32_t;
+};
+
+template<>
+struct RunPrimitive<8>
+{
+  using type = uint64_t;
+};
+
+template<size_t SIZE>
+void serialize_run_head(const char * data, eprosima::fastcdr::Cdr & ser)
+{
+  typename RunPrimitive<SIZE>::type value;
+  memcpy(&value, data, SIZE);
+  ser << value;
+}
+
+// Serializes a run of primitives whose memory layout matches the CDR one.
+// The first primitive goes through Fast-CDR so the buffer gets aligned, the rest is copied as is.
+inline void serialize_run(
+  const char * data, size_t first_size, size_t length, eprosima::fastcdr::Cdr & ser)
+{
+  switch (first_size) {
+    case 1:
+      serialize_run_head<1>(data, ser);
+      break;
+    case 2:
+      serialize_run_head<2>(data, ser);
+      break;
+    case 4:
+      serialize_run_head<4>(data, ser);
+      break;
+    case 8:
+      serialize_run_head<8>(data, ser);
+      break;
+    default:
+      throw std::runtime_error("invalid primitive size in serialization plan");
+  }
+  if (length > first_size) {
+    ser.serializeArray(reinterpret_cast<const uint8_t *>(data + first_size), length - first_size);
+  }
+}
+
+// CDR size of the primitive types that can be part of a memcpy run, 0 for any other type.
+// Bools are left out because they have to be normalized on serialization.
+inline size_t get_run_primitive_size(uint8_t type_id)
+{
+  switch (type_id) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      return 1;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      return 2;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      return 4;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
 template<typename MembersType>
-bool TypeSupport<MembersType>::serializeROSmessage(
-  eprosima::fastcdr::Cdr & ser, const MembersType * members, const void * ros_message)
+void TypeSupport<MembersType>::buildPlan(
+  const MembersType * members, size_t base_offset, Plan & plan)
 {
   assert(members);
-  assert(ros_message);
 
   for (uint32_t i = 0; i < members->member_count_; ++i) {
     const auto member = members->members_ + i;
-    void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        if (!member->is_array_) {
-          // don't cast to bool here because if the bool is
-          // uninitialized the random value can't be deserialized
-          ser << (*static_cast<uint8_t *>(field) ? true : false);
+    const size_t offset = base_offset + member->offset_;
+
+    if (member->type_id_ == ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE) {
+      auto sub_members = static_cast<const MembersType *>(member->members_->data);
+      if (!member->is_array_) {
+        // Inline the nested message so its primitives can join the surrounding runs
+        buildPlan(sub_members, offset, plan);
+        continue;
+      }
+      std::unique_ptr<Plan> sub_plan(new Plan());
+      buildPlan(sub_members, 0, *sub_plan);
+
+      typename Plan::Step step{};
+      step.kind = Plan::Step::MESSAGE_ARRAY;
+      step.offset = offset;
+      step.fields.push_back({member, offset});
+      step.sub_plan = sub_plan.get();
+      step.sub_members = sub_members;
+      step.sub_members_max_align = calculateMaxAlign(sub_members);
+      plan.sub_plans.push_back(std::move(sub_plan));
+      plan.steps.push_back(std::move(step));
+      continue;
+    }
+
+    const size_t size = get_run_primitive_size(member->type_id_);
+    const bool fixed_size = !member->is_array_ || (member->array_size_ && !member->is_upper_bound_);
+    if (!size || !fixed_size) {
+      typename Plan::Step step{};
+      step.kind = Plan::Step::FIELD;
+      step.offset = offset;
+      step.fields.push_back({member, offset});
+      plan.steps.push_back(std::move(step));
+      continue;
+    }
+
+    const size_t count = member->is_array_ ? member->array_size_ : 1;
+    if (!plan.steps.empty()) {
+      // A run starts CDR aligned to its first primitive, so a smaller or equally sized primitive
+      // can join it when its offset in memory is the same it will have in the CDR stream.
+      auto & last = plan.steps.back();
+      if (last.kind == Plan::Step::RUN && size <= last.first_size && offset >= last.offset) {
+        const size_t cdr_offset = last.length +
+          eprosima::fastcdr::Cdr::alignment(last.length, size);
+        if (offset - last.offset == cdr_offset) {
+          last.length = cdr_offset + size * count;
+          last.fields.push_back({member, offset});
+          continue;
+        }
+      }
+    }
+
+    typename Plan::Step step{};
+    step.kind = Plan::Step::RUN;
+    step.offset = offset;
+    step.first_size = size;
+    step.length = size * count;
+    step.fields.push_back({member, offset});
+    plan.steps.push_back(std::move(step));
+  }
+}
+
+template<typename MembersType>
+const typename TypeSupport<MembersType>::Plan & TypeSupport<MembersType>::getPlan()
+{
+  std::call_once(plan_once_, [this]() {
+      plan_.reset(new Plan());
+      buildPlan(members_, 0, *plan_);
+    });
+  return *plan_;
+}
+
+template<typename MembersType>
+bool TypeSupport<MembersType>::serializeROSmessage(
+  eprosima::fastcdr::Cdr & ser, const Plan & plan, const void * ros_message)
+{
+  assert(ros_message);
+
+  // Runs can only be copied as they are when no byte swapping is needed
+  const bool native_endianness = ser.endianness() == eprosima::fastcdr::Cdr::DEFAULT_ENDIAN;
+  char * message = const_cast<char *>(static_cast<const char *>(ros_message));
+
+  for (const auto & step : plan.steps) {
+    void * field = message + step.offset;
+    switch (step.kind) {
+      case Plan::Step::RUN:
+        if (native_endianness) {
+          serialize_run(static_cast<const char *>(field), step.first_size, step.length, ser);
         } else {
-          serialize_field<bool>(member, field, ser);
+          for (const auto & run_field : step.fields) {
+            serialize_member(run_field.member, message + run_field.offset, ser);
+          }
         }
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        serialize_field<uint8_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        serialize_field<char>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        serialize_field<float>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        serialize_field<double>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        serialize_field<int16_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        serialize_field<uint16_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        serialize_field<int32_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        serialize_field<uint32_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        serialize_field<int64_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        serialize_field<uint64_t>(member, field, ser);
+      case Plan::Step::FIELD:
+        serialize_member(step.fields[0].member, field, ser);
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        serialize_field<std::string>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      case Plan::Step::MESSAGE_ARRAY:
         {
-          auto sub_members = static_cast<const MembersType *>(member->members_->data);
-          if (!member->is_array_) {
-            serializeROSmessage(ser, sub_members, field);
+          const auto member = step.fields[0].member;
+          void * subros_message = nullptr;
+          size_t array_size = 0;
+          size_t sub_members_size = step.sub_members->size_of_;
+          size_t max_align = step.sub_members_max_align;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            subros_message = field;
+            array_size = member->array_size_;
           } else {
-            void * subros_message = nullptr;
-            size_t array_size = 0;
-            size_t sub_members_size = sub_members->size_of_;
-            size_t max_align = calculateMaxAlign(sub_members);
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              subros_message = field;
-              array_size = member->array_size_;
-            } else {
-              array_size = get_array_size_and_assign_field(
-                member, field, subros_message, sub_members_size, max_align);
-
-              // Serialize length
-              ser << (uint32_t)array_size;
-            }
-
-            for (size_t index = 0; index < array_size; ++index) {
-              serializeROSmessage(ser, sub_members, subros_message);
-              subros_message = static_cast<char *>(subros_message) + sub_members_size;
-              subros_message = align_(max_align, subros_message);
-            }
+            array_size = get_array_size_and_assign_field(
+              member, field, subros_message, sub_members_size, max_align);
+
+            // Serialize length
+            ser << (uint32_t)array_size;
+          }
+
+          for (size_t index = 0; index < array_size; ++index) {
+            serializeROSmessage(ser, *step.sub_plan, subros_message);
+            subros_message = static_cast<char *>(subros_message) + sub_members_size;
+            subros_message = align_(max_align, subros_message);
           }
         }
         break;
-      default:
-        throw std::runtime_error("unknown type");
     }
   }
 
@@ -515,90 +694,87 @@ size_t next_field_align<std::string>(
   return current_alignment;
 }
 
+template<typename MemberType>
+size_t next_member_align(const MemberType * member, void * field, size_t current_alignment)
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      return next_field_align<bool>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      return next_field_align<uint8_t>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      return next_field_align<char>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      return next_field_align<float>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      return next_field_align<double>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      return next_field_align<int16_t>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      return next_field_align<uint16_t>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      return next_field_align<int32_t>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      return next_field_align<uint32_t>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      return next_field_align<int64_t>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      return next_field_align<uint64_t>(member, field, current_alignment);
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      return next_field_align<std::string>(member, field, current_alignment);
+    default:
+      throw std::runtime_error("unknown type");
+  }
+}
+
 template<typename MembersType>
 size_t TypeSupport<MembersType>::getEstimatedSerializedSize(
-  const MembersType * members, const void * ros_message, size_t current_alignment)
+  const Plan & plan, const void * ros_message, size_t current_alignment)
 {
-  assert(members);
   assert(ros_message);
 
   size_t initial_alignment = current_alignment;
-
-  for (uint32_t i = 0; i < members->member_count_; ++i) {
-    const auto member = members->members_ + i;
-    void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        current_alignment = next_field_align<bool>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        current_alignment = next_field_align<uint8_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        current_alignment = next_field_align<char>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        current_alignment = next_field_align<float>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        current_alignment = next_field_align<double>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        current_alignment = next_field_align<int16_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        current_alignment = next_field_align<uint16_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        current_alignment = next_field_align<int32_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        current_alignment = next_field_align<uint32_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        current_alignment = next_field_align<int64_t>(member, field, current_alignment);
+  char * message = const_cast<char *>(static_cast<const char *>(ros_message));
+
+  for (const auto & step : plan.steps) {
+    void * field = message + step.offset;
+    switch (step.kind) {
+      case Plan::Step::RUN:
+        current_alignment += eprosima::fastcdr::Cdr::alignment(current_alignment, step.first_size);
+        current_alignment += step.length;
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        current_alignment = next_field_align<uint64_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        current_alignment = next_field_align<std::string>(member, field, current_alignment);
+      case Plan::Step::FIELD:
+        current_alignment = next_member_align(step.fields[0].member, field, current_alignment);
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      case Plan::Step::MESSAGE_ARRAY:
         {
-          auto sub_members = static_cast<const MembersType *>(member->members_->data);
-          if (!member->is_array_) {
-            current_alignment += getEstimatedSerializedSize(sub_members, field, current_alignment);
+          const auto member = step.fields[0].member;
+          void * subros_message = nullptr;
+          size_t array_size = 0;
+          size_t sub_members_size = step.sub_members->size_of_;
+          size_t max_align = step.sub_members_max_align;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            subros_message = field;
+            array_size = member->array_size_;
           } else {
-            void * subros_message = nullptr;
-            size_t array_size = 0;
-            size_t sub_members_size = sub_members->size_of_;
-            size_t max_align = calculateMaxAlign(sub_members);
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              subros_message = field;
-              array_size = member->array_size_;
-            } else {
-              array_size = get_array_size_and_assign_field(
-                member, field, subros_message, sub_members_size, max_align);
-
-              // Length serialization
-              current_alignment += 4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
-            }
-
-            for (size_t index = 0; index < array_size; ++index) {
-              current_alignment += getEstimatedSerializedSize(
-                sub_members, subros_message, current_alignment);
-              subros_message = static_cast<char *>(subros_message) + sub_members_size;
-              subros_message = align_(max_align, subros_message);
-            }
+            array_size = get_array_size_and_assign_field(
+              member, field, subros_message, sub_members_size, max_align);
+
+            // Length serialization
+            current_alignment += 4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
+          }
+
+          for (size_t index = 0; index < array_size; ++index) {
+            current_alignment += getEstimatedSerializedSize(
+              *step.sub_plan, subros_message, current_alignment);
+            subros_message = static_cast<char *>(subros_message) + sub_members_size;
+            subros_message = align_(max_align, subros_message);
           }
         }
         break;
-      default:
-        throw std::runtime_error("unknown type");
     }
   }
 
@@ -685,46 +861,114 @@ inline void deserialize_field<std::string>(
   eprosima::fastcdr::Cdr & deser,
   bool call_new)
 {
-  (void)call_new;
+  using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
   if (!member->is_array_) {
-    using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
     CStringHelper::assign(deser, field, call_new);
   } else {
+    // Strings are copied straight from the CDR buffer into their rosidl_generator_c__String
     if (member->array_size_ && !member->is_upper_bound_) {
       auto deser_field = static_cast<rosidl_generator_c__String *>(field);
-      // tmpstring is defined here and not below to avoid
-      // memory allocation in every iteration of the for loop
-      std::string tmpstring;
       for (size_t i = 0; i < member->array_size_; ++i) {
-        deser.deserialize(tmpstring);
-        if (!rosidl_generator_c__String__assign(&deser_field[i], tmpstring.c_str())) {
-          throw std::runtime_error("unable to assign rosidl_generator_c__String");
-        }
+        CStringHelper::assign(deser, &deser_field[i], call_new);
       }
     } else {
-      std::vector<std::string> cpp_string_vector;
-      deser >> cpp_string_vector;
+      uint32_t size = 0;
+      deser >> size;
 
       auto & string_sequence_field =
         *reinterpret_cast<rosidl_generator_c__String__Sequence *>(field);
-      if (
-        !rosidl_generator_c__String__Sequence__init(
-          &string_sequence_field, cpp_string_vector.size()))
-      {
+      if (!rosidl_generator_c__String__Sequence__init(&string_sequence_field, size)) {
         throw std::runtime_error("unable to initialize rosidl_generator_c__String array");
       }
 
-      for (size_t i = 0; i < cpp_string_vector.size(); ++i) {
-        if (!rosidl_generator_c__String__assign(&string_sequence_field.data[i],
-          cpp_string_vector[i].c_str()))
-        {
-          throw std::runtime_error("unable to assign rosidl_generator_c__String");
-        }
+      for (size_t i = 0; i < size; ++i) {
+        CStringHelper::assign(deser, &string_sequence_field.data[i], call_new);
       }
     }
   }
 }
 
+template<typename MemberType>
+void deserialize_member(
+  const MemberType * member, void * field, eprosima::fastcdr::Cdr & deser, bool call_new)
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      deserialize_field<bool>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      deserialize_field<uint8_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      deserialize_field<char>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      deserialize_field<float>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      deserialize_field<double>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      deserialize_field<int16_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      deserialize_field<uint16_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      deserialize_field<int32_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      deserialize_field<uint32_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      deserialize_field<int64_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      deserialize_field<uint64_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      deserialize_field<std::string>(member, field, deser, call_new);
+      break;
+    default:
+      throw std::runtime_error("unknown type");
+  }
+}
+
+template<size_t SIZE>
+void deserialize_run_head(char * data, eprosima::fastcdr::Cdr & deser)
+{
+  typename RunPrimitive<SIZE>::type value;
+  deser >> value;
+  memcpy(data, &value, SIZE);
+}
+
+// Counterpart of serialize_run.
+inline void deserialize_run(
+  char * data, size_t first_size, size_t length, eprosima::fastcdr::Cdr & deser)
+{
+  switch (first_size) {
+    case 1:
+      deserialize_run_head<1>(data, deser);
+      break;
+    case 2:
+      deserialize_run_head<2>(data, deser);
+      break;
+    case 4:
+      deserialize_run_head<4>(data, deser);
+      break;
+    case 8:
+      deserialize_run_head<8>(data, deser);
+      break;
+    default:
+      throw std::runtime_error("invalid primitive size in serialization plan");
+  }
+  if (length > first_size) {
+    deser.deserializeArray(reinterpret_cast<uint8_t *>(data + first_size), length - first_size);
+  }
+}
+
 inline size_t get_submessage_array_deserialize(
   const rosidl_typesupport_introspection_cpp::MessageMember * member,
   eprosima::fastcdr::Cdr & deser,
@@ -769,85 +1013,54 @@ inline size_t get_submessage_array_deserialize(
 
 template<typename MembersType>
 bool TypeSupport<MembersType>::deserializeROSmessage(
-  eprosima::fastcdr::Cdr & deser, const MembersType * members, void * ros_message, bool call_new)
+  eprosima::fastcdr::Cdr & deser, const Plan & plan, void * ros_message, bool call_new)
 {
-  assert(members);
   assert(ros_message);
 
-  for (uint32_t i = 0; i < members->member_count_; ++i) {
-    const auto * member = members->members_ + i;
-    void * field = static_cast<char *>(ros_message) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        deserialize_field<bool>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        deserialize_field<uint8_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        deserialize_field<char>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        deserialize_field<float>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        deserialize_field<double>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        deserialize_field<int16_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        deserialize_field<uint16_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        deserialize_field<int32_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        deserialize_field<uint32_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        deserialize_field<int64_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        deserialize_field<uint64_t>(member, field, deser, call_new);
+  const bool native_endianness = deser.endianness() == eprosima::fastcdr::Cdr::DEFAULT_ENDIAN;
+  char * message = static_cast<char *>(ros_message);
+
+  for (const auto & step : plan.steps) {
+    void * field = message + step.offset;
+    switch (step.kind) {
+      case Plan::Step::RUN:
+        if (native_endianness) {
+          deserialize_run(static_cast<char *>(field), step.first_size, step.length, deser);
+        } else {
+          for (const auto & run_field : step.fields) {
+            deserialize_member(run_field.member, message + run_field.offset, deser, call_new);
+          }
+        }
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        deserialize_field<std::string>(member, field, deser, call_new);
+      case Plan::Step::FIELD:
+        deserialize_member(step.fields[0].member, field, deser, call_new);
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      case Plan::Step::MESSAGE_ARRAY:
         {
-          auto sub_members = (const MembersType *)member->members_->data;
-          if (!member->is_array_) {
-            deserializeROSmessage(deser, sub_members, field, call_new);
+          const auto member = step.fields[0].member;
+          void * subros_message = nullptr;
+          size_t array_size = 0;
+          size_t sub_members_size = step.sub_members->size_of_;
+          size_t max_align = step.sub_members_max_align;
+          bool recall_new = call_new;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            subros_message = field;
+            array_size = member->array_size_;
           } else {
-            void * subros_message = nullptr;
-            size_t array_size = 0;
-            size_t sub_members_size = sub_members->size_of_;
-            size_t max_align = calculateMaxAlign(sub_members);
-            bool recall_new = call_new;
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              subros_message = field;
-              array_size = member->array_size_;
-            } else {
-              array_size = get_submessage_array_deserialize(
-                member, deser, field, subros_message,
-                call_new, sub_members_size, max_align);
-              recall_new = true;
-            }
-
-            for (size_t index = 0; index < array_size; ++index) {
-              deserializeROSmessage(deser, sub_members, subros_message, recall_new);
-              subros_message = static_cast<char *>(subros_message) + sub_members_size;
-              subros_message = align_(max_align, subros_message);
-            }
+            array_size = get_submessage_array_deserialize(
+              member, deser, field, subros_message,
+              call_new, sub_members_size, max_align);
+            recall_new = true;
+          }
+
+          for (size_t index = 0; index < array_size; ++index) {
+            deserializeROSmessage(deser, *step.sub_plan, subros_message, recall_new);
+            subros_message = static_cast<char *>(subros_message) + sub_members_size;
+            subros_message = align_(max_align, subros_message);
           }
         }
         break;
-      default:
-        throw std::runtime_error("unknown type");
     }
   }
 
@@ -943,7 +1156,7 @@ size_t TypeSupport<MembersType>::getEstimatedSerializedSize(
   size_t ret_val = 4;
 
   if (members_->member_count_ != 0) {
-    ret_val += TypeSupport::getEstimatedSerializedSize(members_, ros_message, 0);
+    ret_val += TypeSupport::getEstimatedSerializedSize(getPlan(), ros_message, 0);
   } else {
     ret_val += 1;
   }
@@ -961,7 +1174,7 @@ bool TypeSupport<MembersType>::serializeROSmessage(
   ser.serialize_encapsulation();
 
   if (members_->member_count_ != 0) {
-    TypeSupport::serializeROSmessage(ser, members_, ros_message);
+    TypeSupport::serializeROSmessage(ser, getPlan(), ros_message);
   } else {
     ser << (uint8_t)0;
   }
@@ -979,7 +1192,7 @@ bool TypeSupport<MembersType>::deserializeROSmessage(
   deser.read_encapsulation();
 
   if (members_->member_count_ != 0) {
-    TypeSupport::deserializeROSmessage(deser, members_, ros_message, false);
+    TypeSupport::deserializeROSmessage(deser, getPlan(), ros_message, false);
   } else {
     uint8_t dump = 0;
     deser >> dump;
@@ -0,0 +1,173 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the introspection based typesupport of this package with the code generated by
+// rosidl_typesupport_fastrtps_cpp (the one used by rmw_fastrtps_cpp) on the test_msgs fixtures.
+// Both must produce the same bytes; the time per message of each is printed.
+// As in both rmw implementations, the encapsulation header is part of what is measured.
+//
+// Usage: benchmark_serialization [iterations]
+
+#include <fastcdr/Cdr.h>
+#include <fastcdr/FastBuffer.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support_decl.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_type_support_decl.hpp"
+#include "test_msgs/message_fixtures.hpp"
+
+namespace
+{
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+using Clock = std::chrono::steady_clock;
+
+double ns_per_message(Clock::time_point start, size_t messages)
+{
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+         static_cast<double>(messages);
+}
+
+std::vector<char> serialize_generated(
+  const message_type_support_callbacks_t * callbacks, const void * msg, FastBuffer & buffer)
+{
+  Cdr ser(buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  ser.serialize_encapsulation();
+  callbacks->cdr_serialize(msg, ser);
+  return std::vector<char>(buffer.getBuffer(), buffer.getBuffer() + ser.getSerializedDataLength());
+}
+
+std::vector<char> serialize_dynamic(
+  rmw_fastrtps_dynamic_cpp::MessageTypeSupport<MessageMembers> & type, const void * msg,
+  FastBuffer & buffer)
+{
+  Cdr ser(buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  type.serializeROSmessage(msg, ser);
+  return std::vector<char>(buffer.getBuffer(), buffer.getBuffer() + ser.getSerializedDataLength());
+}
+
+template<typename T>
+bool benchmark(
+  const char * name, const std::vector<std::shared_ptr<T>> & messages, size_t iterations)
+{
+  auto generated_handle = rosidl_typesupport_fastrtps_cpp::get_message_type_support_handle<T>();
+  auto callbacks =
+    static_cast<const message_type_support_callbacks_t *>(generated_handle->data);
+  auto introspection_handle =
+    rosidl_typesupport_introspection_cpp::get_message_type_support_handle<T>();
+  rmw_fastrtps_dynamic_cpp::MessageTypeSupport<MessageMembers> dynamic(
+    static_cast<const MessageMembers *>(introspection_handle->data));
+
+  FastBuffer buffer;
+  std::vector<std::vector<char>> serialized;
+  for (const auto & msg : messages) {
+    serialized.push_back(serialize_generated(callbacks, msg.get(), buffer));
+    if (serialize_dynamic(dynamic, msg.get(), buffer) != serialized.back()) {
+      fprintf(stderr, "%s: serialized data differs from rmw_fastrtps_cpp\n", name);
+      return false;
+    }
+  }
+
+  size_t count = iterations * messages.size();
+  double results[4];
+
+  auto start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    for (const auto & msg : messages) {
+      Cdr ser(buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+      ser.serialize_encapsulation();
+      callbacks->cdr_serialize(msg.get(), ser);
+    }
+  }
+  results[0] = ns_per_message(start, count);
+
+  start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    for (const auto & msg : messages) {
+      Cdr ser(buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+      dynamic.serializeROSmessage(msg.get(), ser);
+    }
+  }
+  results[1] = ns_per_message(start, count);
+
+  T output;
+  start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    for (auto & data : serialized) {
+      FastBuffer input(data.data(), data.size());
+      Cdr deser(input, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+      deser.read_encapsulation();
+      callbacks->cdr_deserialize(deser, &output);
+    }
+  }
+  results[2] = ns_per_message(start, count);
+
+  start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    for (auto & data : serialized) {
+      FastBuffer input(data.data(), data.size());
+      Cdr deser(input, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+      dynamic.deserializeROSmessage(deser, &output);
+    }
+  }
+  results[3] = ns_per_message(start, count);
+
+  printf(
+    "%-44s %10.1f %10.1f %10.1f %10.1f\n", name, results[0], results[1], results[2], results[3]);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t iterations = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 100000;
+
+  printf("ns per message over %zu iterations\n", iterations);
+  printf(
+    "%-44s %10s %10s %10s %10s\n", "message", "ser gen", "ser dyn", "deser gen", "deser dyn");
+
+  bool ok = true;
+  ok &= benchmark("Primitives", get_messages_primitives(), iterations);
+  ok &= benchmark("StaticArrayPrimitives", get_messages_static_array_primitives(), iterations);
+  ok &= benchmark(
+    "StaticArrayPrimitivesNested", get_messages_static_array_primitives_nested(), iterations);
+  ok &= benchmark("DynamicArrayPrimitives", get_messages_dynamic_array_primitives(), iterations);
+  ok &= benchmark(
+    "DynamicArrayPrimitivesNested", get_messages_dynamic_array_primitives_nested(), iterations);
+  ok &= benchmark(
+    "DynamicArrayStaticArrayPrimitivesNested",
+    get_messages_dynamic_array_static_array_primitives_nested(), iterations);
+  ok &= benchmark("BoundedArrayPrimitives", get_messages_bounded_array_primitives(), iterations);
+  ok &= benchmark(
+    "BoundedArrayPrimitivesNested", get_messages_bounded_array_primitives_nested(), iterations);
+  ok &= benchmark("Nested", get_messages_nested(), iterations);
+  ok &= benchmark("DynamicArrayNested", get_messages_dynamic_array_nested(), iterations);
+  ok &= benchmark("BoundedArrayNested", get_messages_bounded_array_nested(), iterations);
+  ok &= benchmark("StaticArrayNested", get_messages_static_array_nested(), iterations);
+  ok &= benchmark("Builtins", get_messages_builtins(), iterations);
+
+  return ok ? 0 : 1;
+}
@@ -46,6 +46,12 @@ public:
 
   virtual bool deserializeROSmessage(eprosima::fastcdr::Cdr & deser, void * ros_message) = 0;
 
+  // Serializes ros_message into a buffer of the given capacity.
+  // Returns false without computing the size of the message if it does not fit.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool serializeROSmessageToBuffer(
+    const void * ros_message, uint8_t * buffer, size_t capacity, size_t & serialized_length);
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   bool serialize(void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload);
 
@@ -14,10 +14,13 @@
 
 #include <fastcdr/FastBuffer.h>
 #include <fastcdr/Cdr.h>
+#include <fastcdr/exceptions/NotEnoughMemoryException.h>
 #include <cassert>
 #include <string>
 #include <vector>
 
+#include "rcutils/allocation_region.h"
+
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 namespace rmw_fastrtps_shared_cpp
@@ -40,12 +43,38 @@ void * TypeSupport::createData()
   return new eprosima::fastcdr::FastBuffer();
 }
 
+bool TypeSupport::serializeROSmessageToBuffer(
+  const void * ros_message, uint8_t * buffer, size_t capacity, size_t & serialized_length)
+{
+  assert(ros_message);
+
+  if (!buffer || capacity == 0) {
+    return false;
+  }
+
+  rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_SERIALIZE);
+  eprosima::fastcdr::FastBuffer fastbuffer(reinterpret_cast<char *>(buffer), capacity);
+  eprosima::fastcdr::Cdr ser(
+    fastbuffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+  try {
+    if (!this->serializeROSmessage(ros_message, ser)) {
+      return false;
+    }
+  } catch (const eprosima::fastcdr::exception::NotEnoughMemoryException &) {
+    return false;
+  }
+
+  serialized_length = ser.getSerializedDataLength();
+  return true;
+}
+
 bool TypeSupport::serialize(
   void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload)
 {
   assert(data);
   assert(payload);
 
+  rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_SERIALIZE);
   auto ser_data = static_cast<SerializedData *>(data);
   if (ser_data->is_cdr_buffer) {
     auto ser = static_cast<eprosima::fastcdr::Cdr *>(ser_data->data);
@@ -56,7 +85,38 @@ bool TypeSupport::serialize(
       memcpy(payload->data, ser->getBufferPointer(), ser->getSerializedDataLength());
       return true;
     }
+  } else if (!max_size_bound_) {
+    // The size of the message was not computed beforehand (see getSerializedSizeProvider).
+    // Hand the payload to Fast-CDR instead, which grows it in place if the message does not fit.
+    eprosima::fastcdr::FastBuffer fastbuffer;
+    if (payload->data) {
+      fastbuffer.adopt(reinterpret_cast<char *>(payload->data), payload->max_size);
+    }
+    auto give_back = [payload, &fastbuffer]()
+      {
+        payload->max_size = static_cast<uint32_t>(fastbuffer.getBufferSize());
+        payload->data = reinterpret_cast<eprosima::fastrtps::rtps::octet *>(fastbuffer.release());
+      };
+    bool ret = false;
+    size_t length = 0;
+    try {
+      eprosima::fastcdr::Cdr ser(fastbuffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
+        eprosima::fastcdr::Cdr::DDS_CDR);
+      ret = this->serializeROSmessage(ser_data->data, ser);
+      payload->encapsulation = ser.endianness() ==
+        eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
+      length = ser.getSerializedDataLength();
+    } catch (...) {
+      give_back();
+      throw;
+    }
+    give_back();
+    if (ret) {
+      payload->length = static_cast<uint32_t>(length);
+      return true;
+    }
   } else {
+    // Fully bound types always fit in the payload reserved for them.
     eprosima::fastcdr::FastBuffer fastbuffer(
       reinterpret_cast<char *>(payload->data),
       payload->max_size);  // Object that manages the raw buffer.
@@ -80,6 +140,7 @@ bool TypeSupport::deserialize(
   assert(data);
   assert(payload);
 
+  rcutils::ScopedAllocationRegion region(RCUTILS_ALLOCATION_REGION_DESERIALIZE);
   auto ser_data = static_cast<SerializedData *>(data);
   if (ser_data->is_cdr_buffer) {
     auto buffer = static_cast<eprosima::fastcdr::FastBuffer *>(ser_data->data);
@@ -111,6 +172,10 @@ std::function<uint32_t()> TypeSupport::getSerializedSizeProvider(void * data)
         auto ser = static_cast<eprosima::fastcdr::Cdr *>(ser_data->data);
         return static_cast<uint32_t>(ser->getSerializedDataLength());
       }
+      if (!max_size_bound_) {
+        // Unknown, serialize() grows the payload as needed instead of walking the message twice
+        return 0u;
+      }
       return static_cast<uint32_t>(this->getEstimatedSerializedSize(ser_data->data));
     };
   return ser_size;
@@ -33,6 +33,7 @@
 #include "fastrtps/rtps/reader/ReaderListener.h"
 #include "fastrtps/rtps/reader/RTPSReader.h"
 
+#include "topic_cache.hpp"
 #include "types/guard_condition.hpp"
 
 class ReaderInfo : public eprosima::fastrtps::rtps::ReaderListener
@@ -75,35 +76,22 @@ public:
 
     auto fqdn = proxyData.topicName();
 
-    bool trigger = false;
-    mapmutex.lock();
+    bool trigger = true;
     if (eprosima::fastrtps::rtps::ALIVE == change->kind) {
-      topicNtypes[fqdn].push_back(proxyData.typeName());
-      trigger = true;
-    } else {
-      auto it = topicNtypes.find(fqdn);
-      if (it != topicNtypes.end()) {
-        const auto & loc =
-          std::find(std::begin(it->second), std::end(it->second), proxyData.typeName());
-        if (loc != std::end(it->second)) {
-          topicNtypes[fqdn].erase(loc, loc + 1);
-          trigger = true;
-        } else {
-          RCUTILS_LOG_DEBUG_NAMED(
-            "rmw_fastrtps_shared_cpp",
-            "unexpected removal of subscription on topic '%s' with type '%s'",
-            fqdn.c_str(), proxyData.typeName().c_str());
-        }
-      }
+      topic_cache.add_topic(fqdn, proxyData.typeName());
+    } else if (!topic_cache.remove_topic(fqdn, proxyData.typeName())) {
+      RCUTILS_LOG_DEBUG_NAMED(
+        "rmw_fastrtps_shared_cpp",
+        "unexpected removal of subscription on topic '%s' with type '%s'",
+        fqdn.c_str(), proxyData.typeName().c_str());
+      trigger = false;
     }
-    mapmutex.unlock();
 
     if (trigger) {
       graph_guard_condition_->trigger();
     }
   }
-  std::map<std::string, std::vector<std::string>> topicNtypes;
-  std::mutex mapmutex;
+  TopicCache topic_cache;
   eprosima::fastrtps::Participant * participant_;
   GuardCondition * graph_guard_condition_;
 };
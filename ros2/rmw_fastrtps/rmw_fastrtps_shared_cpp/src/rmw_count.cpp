@@ -66,15 +66,10 @@ __rmw_count_publishers(
   auto impl = static_cast<CustomParticipantInfo *>(node->data);
   WriterInfo * slave_target = impl->secondaryPubListener;
 
-  slave_target->mapmutex.lock();
   // Search and sum up the publisher counts
   for (const auto & topic_fqdn : topic_fqdns) {
-    const auto & it = slave_target->topicNtypes.find(topic_fqdn);
-    if (it != slave_target->topicNtypes.end()) {
-      *count += it->second.size();
-    }
+    *count += slave_target->topic_cache.count(topic_fqdn);
   }
-  slave_target->mapmutex.unlock();
 
   RCUTILS_LOG_DEBUG_NAMED(
     "rmw_fastrtps_shared_cpp",
@@ -119,15 +114,10 @@ __rmw_count_subscribers(
   CustomParticipantInfo * impl = static_cast<CustomParticipantInfo *>(node->data);
   ReaderInfo * slave_target = impl->secondarySubListener;
 
-  slave_target->mapmutex.lock();
   // Search and sum up the subscriber counts
   for (const auto & topic_fqdn : topic_fqdns) {
-    const auto & it = slave_target->topicNtypes.find(topic_fqdn);
-    if (it != slave_target->topicNtypes.end()) {
-      *count += it->second.size();
-    }
+    *count += slave_target->topic_cache.count(topic_fqdn);
   }
-  slave_target->mapmutex.unlock();
 
   RCUTILS_LOG_DEBUG_NAMED(
     "rmw_fastrtps_shared_cpp",
@@ -61,46 +61,25 @@ __rmw_get_service_names_and_types(
 
   auto impl = static_cast<CustomParticipantInfo *>(node->data);
 
-  // Access the slave Listeners, which are the ones that have the topicnamesandtypes member
+  // Access the slave Listeners, which are the ones that have the topic cache
   // Get info from publisher and subscriber
   // Combined results from the two lists
   std::map<std::string, std::set<std::string>> services;
-  {
-    ReaderInfo * slave_target = impl->secondarySubListener;
-    slave_target->mapmutex.lock();
-    for (auto it : slave_target->topicNtypes) {
-      std::string service_name = _demangle_service_from_topic(it.first);
-      if (!service_name.length()) {
+  auto add_service =
+    [&services](const std::string &, const TopicCache::TopicInfo & info) {
+      if (info.service_name.empty()) {
         // not a service
-        continue;
+        return;
       }
-      for (auto & itt : it.second) {
-        std::string service_type = _demangle_service_type_only(itt);
+      for (const auto & type : info.types) {
+        const std::string & service_type = type.second.demangled_name;
         if (service_type.length()) {
-          services[service_name].insert(service_type);
+          services[info.service_name].insert(service_type);
         }
       }
-    }
-    slave_target->mapmutex.unlock();
-  }
-  {
-    WriterInfo * slave_target = impl->secondaryPubListener;
-    slave_target->mapmutex.lock();
-    for (auto it : slave_target->topicNtypes) {
-      std::string service_name = _demangle_service_from_topic(it.first);
-      if (!service_name.length()) {
-        // not a service
-        continue;
-      }
-      for (auto & itt : it.second) {
-        std::string service_type = _demangle_service_type_only(itt);
-        if (service_type.length()) {
-          services[service_name].insert(service_type);
-        }
-      }
-    }
-    slave_target->mapmutex.unlock();
-  }
+    };
+  impl->secondarySubListener->topic_cache.for_each_topic(add_service);
+  impl->secondaryPubListener->topic_cache.for_each_topic(add_service);
 
   // Fill out service_names_and_types
   if (services.size()) {
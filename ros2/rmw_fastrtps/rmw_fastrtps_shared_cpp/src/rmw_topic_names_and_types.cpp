@@ -70,38 +70,26 @@ __rmw_get_topic_names_and_types(
 
   auto impl = static_cast<CustomParticipantInfo *>(node->data);
 
-  // Access the slave Listeners, which are the ones that have the topicnamesandtypes member
+  // Access the slave Listeners, which are the ones that have the topic cache
   // Get info from publisher and subscriber
-  // Combined results from the two lists
+  // Combined results from the two lists, demangled unless no_demangle is set
   std::map<std::string, std::set<std::string>> topics;
-  {
-    ReaderInfo * slave_target = impl->secondarySubListener;
-    slave_target->mapmutex.lock();
-    for (auto it : slave_target->topicNtypes) {
-      if (!no_demangle && _get_ros_prefix_if_exists(it.first) != ros_topic_prefix) {
+  auto add_topic =
+    [&topics, no_demangle](const std::string & topic_name, const TopicCache::TopicInfo & info) {
+      if (!no_demangle && info.ros_prefix != ros_topic_prefix) {
         // if we are demangling and this is not prefixed with rt/, skip it
-        continue;
+        return;
       }
-      for (auto & itt : it.second) {
-        topics[it.first].insert(itt);
-      }
-    }
-    slave_target->mapmutex.unlock();
-  }
-  {
-    WriterInfo * slave_target = impl->secondaryPubListener;
-    slave_target->mapmutex.lock();
-    for (auto it : slave_target->topicNtypes) {
-      if (!no_demangle && _get_ros_prefix_if_exists(it.first) != ros_topic_prefix) {
-        // if we are demangling and this is not prefixed with rt/, skip it
-        continue;
-      }
-      for (auto & itt : it.second) {
-        topics[it.first].insert(itt);
+      for (const auto & type : info.types) {
+        if (no_demangle) {
+          topics[topic_name].insert(type.first);
+        } else {
+          topics[info.demangled_name].insert(type.second.demangled_name);
+        }
       }
-    }
-    slave_target->mapmutex.unlock();
-  }
+    };
+  impl->secondarySubListener->topic_cache.for_each_topic(add_topic);
+  impl->secondaryPubListener->topic_cache.for_each_topic(add_topic);
 
   // Copy data to results handle
   if (topics.size() > 0) {
@@ -119,21 +107,11 @@ __rmw_get_topic_names_and_types(
             "error during report of error: %s", rmw_get_error_string().str);
         }
       };
-    // Setup demangling functions based on no_demangle option
-    auto demangle_topic = _demangle_if_ros_topic;
-    auto demangle_type = _demangle_if_ros_type;
-    if (no_demangle) {
-      auto noop = [](const std::string & in) {
-          return in;
-        };
-      demangle_topic = noop;
-      demangle_type = noop;
-    }
     // For each topic, store the name, initialize the string array for types, and store all types
     size_t index = 0;
     for (const auto & topic_n_types : topics) {
       // Duplicate and store the topic_name
-      char * topic_name = rcutils_strdup(demangle_topic(topic_n_types.first).c_str(), *allocator);
+      char * topic_name = rcutils_strdup(topic_n_types.first.c_str(), *allocator);
       if (!topic_name) {
         RMW_SET_ERROR_MSG("failed to allocate memory for topic name");
         fail_cleanup();
@@ -155,7 +133,7 @@ __rmw_get_topic_names_and_types(
       // Duplicate and store each type for the topic
       size_t type_index = 0;
       for (const auto & type : topic_n_types.second) {
-        char * type_name = rcutils_strdup(demangle_type(type).c_str(), *allocator);
+        char * type_name = rcutils_strdup(type.c_str(), *allocator);
         if (!type_name) {
           RMW_SET_ERROR_MSG("failed to allocate memory for type name");
           fail_cleanup();
@@ -0,0 +1,253 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TOPIC_CACHE_HPP_
+#define TOPIC_CACHE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "demangle.hpp"
+#include "namespace_prefix.hpp"
+
+/// Topics and types of the endpoints discovered on the graph, updated by the discovery callbacks.
+/**
+ * The demangled names are computed once, when a topic or a type is first discovered, so that the
+ * graph queries iterate the cache in place instead of demangling copies of it.
+ * Every change increments a generation counter and the topics are kept in the order of their last
+ * change, so that callers polling the graph can ask what changed since their previous query
+ * instead of comparing copies of the whole graph.
+ */
+class TopicCache
+{
+public:
+  struct TypeInfo
+  {
+    /// Number of endpoints of the topic with this type.
+    size_t count;
+    /// The service type for service topics ("" if not a ROS srv type), else the ROS type.
+    std::string demangled_name;
+  };
+
+  struct TopicInfo
+  {
+    /// Number of endpoints of the topic, of any type.
+    size_t count = 0;
+    /// The ROS prefix of the topic, "" if it has none.
+    std::string ros_prefix;
+    /// The topic name without its ROS prefix.
+    std::string demangled_name;
+    /// The service name if the topic is a ROS service request or reply topic, else "".
+    std::string service_name;
+    std::map<std::string, TypeInfo> types;
+  };
+
+  /// Create an empty cache, its generations start after the given one.
+  /**
+   * The generation counter wraps around, generations are compared with serial number arithmetic.
+   */
+  explicit TopicCache(uint64_t generation = 0)
+  : generation_(generation)
+  {}
+
+  /// Add an endpoint of the given topic and type.
+  void
+  add_topic(const std::string & topic_name, const std::string & type_name)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = topics_.find(topic_name);
+    if (it == topics_.end()) {
+      it = topics_.emplace(topic_name, make_topic_info(topic_name)).first;
+    }
+    TopicInfo & topic = it->second;
+    auto type_it = topic.types.find(type_name);
+    if (type_it == topic.types.end()) {
+      type_it = topic.types.emplace(
+        type_name, TypeInfo{0, demangle_type(topic, type_name)}).first;
+    }
+    ++type_it->second.count;
+    ++topic.count;
+    touch(topic_name);
+  }
+
+  /// Remove an endpoint of the given topic and type.
+  /**
+   * Topics without endpoints left are removed, their removal is still reported as a change.
+   * \return false if there is no endpoint with this topic and type.
+   */
+  bool
+  remove_topic(const std::string & topic_name, const std::string & type_name)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = topics_.find(topic_name);
+    if (it == topics_.end()) {
+      return false;
+    }
+    TopicInfo & topic = it->second;
+    auto type_it = topic.types.find(type_name);
+    if (type_it == topic.types.end()) {
+      return false;
+    }
+    if (--type_it->second.count == 0) {
+      topic.types.erase(type_it);
+    }
+    if (--topic.count == 0) {
+      topics_.erase(it);
+    }
+    touch(topic_name);
+    return true;
+  }
+
+  /// Return the generation of the last change, the one given to the constructor if none.
+  uint64_t
+  get_generation() const
+  {
+    return generation_.load();
+  }
+
+  /// Return the number of endpoints of the given topic.
+  size_t
+  count(const std::string & topic_name) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = topics_.find(topic_name);
+    return it != topics_.end() ? it->second.count : 0;
+  }
+
+  /// Return the number of topics with at least one endpoint.
+  size_t
+  size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return topics_.size();
+  }
+
+  /// Return the number of topics changed since the given generation.
+  size_t
+  count_changes_since(uint64_t generation) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto it = changes_.rbegin(); it != changes_.rend() && is_after(it->first, generation);
+      ++it)
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  /// Call f(topic_name, topic_info) for each topic, ordered by name.
+  /**
+   * The cache is locked during the calls, f must not call back into it.
+   */
+  template<typename Functor>
+  void
+  for_each_topic(Functor f) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & topic : topics_) {
+      f(topic.first, topic.second);
+    }
+  }
+
+  /// Call f(topic_name, topic_info) for each topic changed since the given generation.
+  /**
+   * The topics are ordered by the generation of their last change, topics whose endpoints were
+   * all removed are included with a count of 0 and no types.
+   * The cache is locked during the calls, f must not call back into it.
+   */
+  template<typename Functor>
+  void
+  for_each_change_since(uint64_t generation, Functor f) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto first = changes_.end();
+    while (first != changes_.begin() && is_after(std::prev(first)->first, generation)) {
+      --first;
+    }
+    for (auto it = first; it != changes_.end(); ++it) {
+      auto topic_it = topics_.find(it->second);
+      if (topic_it != topics_.end()) {
+        f(it->second, topic_it->second);
+      } else {
+        f(it->second, make_topic_info(it->second));
+      }
+    }
+  }
+
+private:
+  // The topic names in the order of their last change, with the generation of that change
+  typedef std::list<std::pair<uint64_t, std::string>> ChangeList;
+
+  static TopicInfo
+  make_topic_info(const std::string & topic_name)
+  {
+    TopicInfo topic;
+    topic.ros_prefix = _get_ros_prefix_if_exists(topic_name);
+    topic.demangled_name = _demangle_if_ros_topic(topic_name);
+    if (
+      topic.ros_prefix == ros_service_requester_prefix ||
+      topic.ros_prefix == ros_service_response_prefix)
+    {
+      topic.service_name = _demangle_service_from_topic(topic_name);
+    }
+    return topic;
+  }
+
+  static std::string
+  demangle_type(const TopicInfo & topic, const std::string & type_name)
+  {
+    if (!topic.service_name.empty()) {
+      return _demangle_service_type_only(type_name);
+    }
+    return _demangle_if_ros_type(type_name);
+  }
+
+  static bool
+  is_after(uint64_t generation, uint64_t other)
+  {
+    return static_cast<int64_t>(generation - other) > 0;
+  }
+
+  // Must be called with the mutex held.
+  void
+  touch(const std::string & topic_name)
+  {
+    uint64_t generation = generation_.load() + 1;
+    auto it = last_changes_.find(topic_name);
+    if (it == last_changes_.end()) {
+      changes_.emplace_back(generation, topic_name);
+      last_changes_.emplace(topic_name, std::prev(changes_.end()));
+    } else {
+      changes_.splice(changes_.end(), changes_, it->second);
+      it->second->first = generation;
+    }
+    generation_.store(generation);
+  }
+
+  mutable std::mutex mutex_;
+  std::map<std::string, TopicInfo> topics_;
+  // Each topic ever discovered appears once, removed topics included
+  ChangeList changes_;
+  std::map<std::string, ChangeList::iterator> last_changes_;
+  std::atomic<uint64_t> generation_;
+};
+
+#endif  // TOPIC_CACHE_HPP_
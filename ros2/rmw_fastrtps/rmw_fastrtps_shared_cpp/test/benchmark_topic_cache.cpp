@@ -0,0 +1,200 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the topic cache with the map of topics and types it replaced, on a graph made of
+// message topics and service request/reply topics.
+// The time per call of the graph queries done by rmw_get_topic_names_and_types() (before the
+// copy to the result handle), rmw_count_publishers() and of polling for changes is printed.
+//
+// Usage: benchmark_topic_cache [topics] [iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "demangle.hpp"
+#include "namespace_prefix.hpp"
+#include "topic_cache.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double us_per_call(Clock::time_point start, size_t calls)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count() /
+         static_cast<double>(calls);
+}
+
+// The previous implementation, as used by rmw_get_topic_names_and_types and rmw_count_publishers
+struct TopicMap
+{
+  std::map<std::string, std::vector<std::string>> topicNtypes;
+  std::mutex mapmutex;
+
+  std::map<std::string, std::set<std::string>> get_topic_names_and_types()
+  {
+    std::map<std::string, std::set<std::string>> topics;
+    mapmutex.lock();
+    for (auto it : topicNtypes) {
+      if (_get_ros_prefix_if_exists(it.first) != ros_topic_prefix) {
+        continue;
+      }
+      for (auto & itt : it.second) {
+        topics[it.first].insert(itt);
+      }
+    }
+    mapmutex.unlock();
+    std::map<std::string, std::set<std::string>> demangled;
+    for (const auto & topic : topics) {
+      auto & types = demangled[_demangle_if_ros_topic(topic.first)];
+      for (const auto & type : topic.second) {
+        types.insert(_demangle_if_ros_type(type));
+      }
+    }
+    return demangled;
+  }
+
+  size_t count(const std::string & topic_name)
+  {
+    std::lock_guard<std::mutex> lock(mapmutex);
+    auto it = topicNtypes.find(topic_name);
+    return it != topicNtypes.end() ? it->second.size() : 0;
+  }
+};
+
+std::map<std::string, std::set<std::string>> get_topic_names_and_types(const TopicCache & cache)
+{
+  std::map<std::string, std::set<std::string>> topics;
+  cache.for_each_topic(
+    [&topics](const std::string &, const TopicCache::TopicInfo & info) {
+      if (info.ros_prefix != ros_topic_prefix) {
+        return;
+      }
+      for (const auto & type : info.types) {
+        topics[info.demangled_name].insert(type.second.demangled_name);
+      }
+    });
+  return topics;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t num_topics = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+  size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+  if (num_topics < 4 || iterations == 0) {
+    fprintf(stderr, "Usage: %s [topics] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  // One topic in four belongs to a service, each topic has two endpoints
+  std::vector<std::pair<std::string, std::string>> endpoints;
+  for (size_t i = 0; i < num_topics; ++i) {
+    std::string index = std::to_string(i);
+    if (i % 4 == 0) {
+      endpoints.emplace_back(
+        "rq/node_" + index + "/get_parametersRequest",
+        "rcl_interfaces::srv::dds_::GetParameters_Request_");
+    } else {
+      endpoints.emplace_back(
+        "rt/robot/sensor_" + index, "sensor_msgs::msg::dds_::LaserScan_");
+    }
+    endpoints.push_back(endpoints.back());
+  }
+
+  TopicMap topic_map;
+  TopicCache topic_cache;
+  auto start = Clock::now();
+  for (const auto & endpoint : endpoints) {
+    topic_map.topicNtypes[endpoint.first].push_back(endpoint.second);
+  }
+  double map_add = us_per_call(start, endpoints.size());
+  start = Clock::now();
+  for (const auto & endpoint : endpoints) {
+    topic_cache.add_topic(endpoint.first, endpoint.second);
+  }
+  double cache_add = us_per_call(start, endpoints.size());
+
+  size_t map_size = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    map_size += topic_map.get_topic_names_and_types().size();
+  }
+  double map_list = us_per_call(start, iterations);
+  size_t cache_size = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    cache_size += get_topic_names_and_types(topic_cache).size();
+  }
+  double cache_list = us_per_call(start, iterations);
+  if (map_size != cache_size ||
+    topic_map.get_topic_names_and_types() != get_topic_names_and_types(topic_cache))
+  {
+    fprintf(stderr, "topic names and types differ\n");
+    return 1;
+  }
+
+  size_t map_count = 0;
+  size_t cache_count = 0;
+  size_t count_calls = iterations * 1000;
+  start = Clock::now();
+  for (size_t i = 0; i < count_calls; ++i) {
+    map_count += topic_map.count(endpoints[(i * 2) % endpoints.size()].first);
+  }
+  double map_count_time = us_per_call(start, count_calls);
+  start = Clock::now();
+  for (size_t i = 0; i < count_calls; ++i) {
+    cache_count += topic_cache.count(endpoints[(i * 2) % endpoints.size()].first);
+  }
+  double cache_count_time = us_per_call(start, count_calls);
+  if (map_count != cache_count) {
+    fprintf(stderr, "publisher counts differ\n");
+    return 1;
+  }
+
+  // A poller which saw the graph at some generation, one topic changes between two polls
+  size_t changes = 0;
+  size_t polls = std::min(iterations, endpoints.size() / 2);
+  start = Clock::now();
+  for (size_t i = 0; i < polls; ++i) {
+    uint64_t generation = topic_cache.get_generation();
+    topic_cache.remove_topic(endpoints[i * 2].first, endpoints[i * 2].second);
+    topic_cache.for_each_change_since(
+      generation, [&changes](const std::string &, const TopicCache::TopicInfo &) {++changes;});
+  }
+  double cache_poll = us_per_call(start, polls);
+  if (changes != polls || topic_cache.count_changes_since(0) != num_topics) {
+    fprintf(stderr, "unexpected changes\n");
+    return 1;
+  }
+
+  printf("%zu topics, %zu endpoints (us per call)\n", num_topics, endpoints.size());
+  printf("%-24s %12s %12s\n", "", "map", "topic cache");
+  printf("%-24s %12.3f %12.3f\n", "add endpoint", map_add, cache_add);
+  printf("%-24s %12.1f %12.1f\n", "topic names and types", map_list, cache_list);
+  printf("%-24s %12.3f %12.3f\n", "count publishers", map_count_time, cache_count_time);
+  printf("%-24s %12s %12.3f\n", "changes since", "-", cache_poll);
+  return 0;
+}
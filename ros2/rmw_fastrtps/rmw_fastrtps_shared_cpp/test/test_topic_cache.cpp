@@ -0,0 +1,249 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "topic_cache.hpp"
+
+namespace
+{
+
+std::vector<std::string> topic_names(const TopicCache & cache)
+{
+  std::vector<std::string> names;
+  cache.for_each_topic(
+    [&names](const std::string & topic_name, const TopicCache::TopicInfo &) {
+      names.push_back(topic_name);
+    });
+  return names;
+}
+
+std::map<std::string, size_t> topic_types(const TopicCache & cache, const std::string & topic)
+{
+  std::map<std::string, size_t> types;
+  cache.for_each_topic(
+    [&types, &topic](const std::string & topic_name, const TopicCache::TopicInfo & info) {
+      if (topic_name == topic) {
+        for (const auto & type : info.types) {
+          types[type.second.demangled_name] = type.second.count;
+        }
+      }
+    });
+  return types;
+}
+
+}  // namespace
+
+TEST(TestTopicCache, add_and_remove) {
+  TopicCache cache;
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.count("rt/chatter"));
+
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::Header_");
+  cache.add_topic("rt/alpha", "std_msgs::msg::dds_::Empty_");
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(3u, cache.count("rt/chatter"));
+  EXPECT_EQ(1u, cache.count("rt/alpha"));
+  EXPECT_EQ((std::vector<std::string>{"rt/alpha", "rt/chatter"}), topic_names(cache));
+  EXPECT_EQ(
+    (std::map<std::string, size_t>{{"std_msgs/Header", 1}, {"std_msgs/String", 2}}),
+    topic_types(cache, "rt/chatter"));
+
+  EXPECT_TRUE(cache.remove_topic("rt/chatter", "std_msgs::msg::dds_::String_"));
+  EXPECT_EQ(2u, cache.count("rt/chatter"));
+  EXPECT_TRUE(cache.remove_topic("rt/chatter", "std_msgs::msg::dds_::Header_"));
+  EXPECT_EQ(
+    (std::map<std::string, size_t>{{"std_msgs/String", 1}}), topic_types(cache, "rt/chatter"));
+
+  // The last endpoint of a topic removes the topic
+  EXPECT_TRUE(cache.remove_topic("rt/chatter", "std_msgs::msg::dds_::String_"));
+  EXPECT_EQ(0u, cache.count("rt/chatter"));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ((std::vector<std::string>{"rt/alpha"}), topic_names(cache));
+
+  // Adding it again after its removal starts from scratch
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  EXPECT_EQ(1u, cache.count("rt/chatter"));
+  EXPECT_EQ(
+    (std::map<std::string, size_t>{{"std_msgs/String", 1}}), topic_types(cache, "rt/chatter"));
+}
+
+TEST(TestTopicCache, unexpected_removal) {
+  TopicCache cache;
+  EXPECT_FALSE(cache.remove_topic("rt/chatter", "std_msgs::msg::dds_::String_"));
+
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  EXPECT_FALSE(cache.remove_topic("rt/chatter", "std_msgs::msg::dds_::Header_"));
+  EXPECT_FALSE(cache.remove_topic("rt/other", "std_msgs::msg::dds_::String_"));
+  EXPECT_EQ(1u, cache.count("rt/chatter"));
+
+  EXPECT_TRUE(cache.remove_topic("rt/chatter", "std_msgs::msg::dds_::String_"));
+  EXPECT_FALSE(cache.remove_topic("rt/chatter", "std_msgs::msg::dds_::String_"));
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(TestTopicCache, demangled_names) {
+  TopicCache cache;
+  cache.add_topic("rt/ns/chatter", "std_msgs::msg::dds_::String_");
+  cache.add_topic("rq/add_two_intsRequest", "example_interfaces::srv::dds_::AddTwoInts_Request_");
+  cache.add_topic("rr/add_two_intsReply", "example_interfaces::srv::dds_::AddTwoInts_Response_");
+  cache.add_topic("dds_topic", "DdsType");
+
+  std::map<std::string, TopicCache::TopicInfo> topics;
+  cache.for_each_topic(
+    [&topics](const std::string & topic_name, const TopicCache::TopicInfo & info) {
+      topics.emplace(topic_name, info);
+    });
+  ASSERT_EQ(4u, topics.size());
+
+  const TopicCache::TopicInfo & chatter = topics["rt/ns/chatter"];
+  EXPECT_EQ("rt", chatter.ros_prefix);
+  EXPECT_EQ("/ns/chatter", chatter.demangled_name);
+  EXPECT_EQ("", chatter.service_name);
+  EXPECT_EQ("std_msgs/String", chatter.types.begin()->second.demangled_name);
+
+  const TopicCache::TopicInfo & request = topics["rq/add_two_intsRequest"];
+  EXPECT_EQ("rq", request.ros_prefix);
+  EXPECT_EQ("/add_two_ints", request.service_name);
+  EXPECT_EQ("example_interfaces/AddTwoInts", request.types.begin()->second.demangled_name);
+
+  const TopicCache::TopicInfo & reply = topics["rr/add_two_intsReply"];
+  EXPECT_EQ("rr", reply.ros_prefix);
+  EXPECT_EQ("/add_two_ints", reply.service_name);
+  EXPECT_EQ("example_interfaces/AddTwoInts", reply.types.begin()->second.demangled_name);
+
+  const TopicCache::TopicInfo & dds_topic = topics["dds_topic"];
+  EXPECT_EQ("", dds_topic.ros_prefix);
+  EXPECT_EQ("dds_topic", dds_topic.demangled_name);
+  EXPECT_EQ("DdsType", dds_topic.types.begin()->second.demangled_name);
+}
+
+namespace
+{
+
+std::map<std::string, size_t> changes_since(const TopicCache & cache, uint64_t generation)
+{
+  std::map<std::string, size_t> changes;
+  cache.for_each_change_since(
+    generation, [&changes](const std::string & topic_name, const TopicCache::TopicInfo & info) {
+      changes[topic_name] = info.count;
+    });
+  return changes;
+}
+
+}  // namespace
+
+TEST(TestTopicCache, changes_since) {
+  TopicCache cache;
+  EXPECT_EQ(0u, cache.get_generation());
+  EXPECT_EQ(0u, cache.count_changes_since(0));
+
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  cache.add_topic("rt/alpha", "std_msgs::msg::dds_::Empty_");
+  uint64_t generation = cache.get_generation();
+  EXPECT_EQ(2u, generation);
+  EXPECT_EQ(2u, cache.count_changes_since(0));
+  EXPECT_EQ(0u, cache.count_changes_since(generation));
+  EXPECT_TRUE(changes_since(cache, generation).empty());
+
+  // A topic changed several times is reported once, ordered by its last change
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  cache.add_topic("rt/beta", "std_msgs::msg::dds_::Empty_");
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::Header_");
+  EXPECT_EQ(2u, cache.count_changes_since(generation));
+  std::vector<std::string> names;
+  cache.for_each_change_since(
+    generation, [&names](const std::string & topic_name, const TopicCache::TopicInfo &) {
+      names.push_back(topic_name);
+    });
+  EXPECT_EQ((std::vector<std::string>{"rt/beta", "rt/chatter"}), names);
+  EXPECT_EQ(
+    (std::map<std::string, size_t>{{"rt/beta", 1}, {"rt/chatter", 3}}),
+    changes_since(cache, generation));
+  EXPECT_EQ(3u, cache.count_changes_since(0));
+
+  // Unexpected removals change nothing
+  generation = cache.get_generation();
+  EXPECT_FALSE(cache.remove_topic("rt/other", "std_msgs::msg::dds_::String_"));
+  EXPECT_FALSE(cache.remove_topic("rt/alpha", "std_msgs::msg::dds_::String_"));
+  EXPECT_EQ(generation, cache.get_generation());
+  EXPECT_EQ(0u, cache.count_changes_since(generation));
+}
+
+TEST(TestTopicCache, changes_since_removal) {
+  TopicCache cache;
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  cache.add_topic("rt/alpha", "std_msgs::msg::dds_::Empty_");
+  uint64_t generation = cache.get_generation();
+
+  // A removed topic is reported with a count of 0 and no types
+  EXPECT_TRUE(cache.remove_topic("rt/chatter", "std_msgs::msg::dds_::String_"));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(1u, cache.count_changes_since(generation));
+  std::vector<TopicCache::TopicInfo> infos;
+  cache.for_each_change_since(
+    generation, [&infos](const std::string &, const TopicCache::TopicInfo & info) {
+      infos.push_back(info);
+    });
+  ASSERT_EQ(1u, infos.size());
+  EXPECT_EQ(0u, infos[0].count);
+  EXPECT_EQ("/chatter", infos[0].demangled_name);
+  EXPECT_TRUE(infos[0].types.empty());
+  EXPECT_EQ(2u, cache.count_changes_since(0));
+
+  // Adding it again reports it once, with its endpoint
+  uint64_t removed = cache.get_generation();
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  EXPECT_EQ((std::map<std::string, size_t>{{"rt/chatter", 1}}), changes_since(cache, generation));
+  EXPECT_EQ((std::map<std::string, size_t>{{"rt/chatter", 1}}), changes_since(cache, removed));
+  EXPECT_EQ(2u, cache.count_changes_since(0));
+}
+
+TEST(TestTopicCache, changes_since_wrap_around) {
+  const uint64_t max = std::numeric_limits<uint64_t>::max();
+  TopicCache cache(max - 1);
+  EXPECT_EQ(max - 1, cache.get_generation());
+
+  cache.add_topic("rt/alpha", "std_msgs::msg::dds_::Empty_");
+  EXPECT_EQ(max, cache.get_generation());
+  cache.add_topic("rt/beta", "std_msgs::msg::dds_::Empty_");
+  EXPECT_EQ(0u, cache.get_generation());
+  cache.add_topic("rt/chatter", "std_msgs::msg::dds_::String_");
+  EXPECT_EQ(1u, cache.get_generation());
+
+  // Generations before the wrap around are older than the ones after it
+  EXPECT_EQ(3u, cache.count_changes_since(max - 1));
+  EXPECT_EQ(2u, cache.count_changes_since(max));
+  EXPECT_EQ(1u, cache.count_changes_since(0));
+  EXPECT_EQ(0u, cache.count_changes_since(1));
+  EXPECT_EQ(
+    (std::map<std::string, size_t>{{"rt/beta", 1}, {"rt/chatter", 1}}),
+    changes_since(cache, max));
+
+  // A topic changed before the wrap around moves after it
+  EXPECT_TRUE(cache.remove_topic("rt/alpha", "std_msgs::msg::dds_::Empty_"));
+  EXPECT_EQ(2u, cache.get_generation());
+  EXPECT_EQ(
+    (std::map<std::string, size_t>{{"rt/alpha", 0}, {"rt/chatter", 1}}),
+    changes_since(cache, 0));
+  EXPECT_EQ(3u, cache.count_changes_since(max - 1));
+}
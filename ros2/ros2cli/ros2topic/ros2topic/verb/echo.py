@@ -13,6 +13,7 @@
 # limitations under the License.
 
 from argparse import ArgumentTypeError
+import array
 from collections import OrderedDict
 import importlib
 import sys
@@ -163,7 +164,7 @@ def msg_to_csv(args, msg):
     def to_string(val):
         nonlocal args
         r = ''
-        if any(isinstance(val, t) for t in [list, tuple]):
+        if any(isinstance(val, t) for t in [array.array, list, tuple]):
             for i, v in enumerate(val):
                 if r:
                     r += ','
@@ -208,6 +209,9 @@ def msg_to_ordereddict(msg, truncate_length=None):
 
 
 def _convert_value(value, truncate_length=None):
+    if isinstance(value, array.array):
+        # numeric arrays are stored in an array.array, dump them as lists
+        value = value.tolist()
     if isinstance(value, bytes):
         if truncate_length is not None and len(value) > truncate_length:
             value = ''.join([chr(c) for c in value[:truncate_length]]) + '...'
@@ -10,10 +10,14 @@
 @#  - spec (rosidl_parser.MessageSpecification)
 @#    Parsed specification of the .msg file
 @#  - constant_value_to_py (function)
+@#  - get_array_typecode (function)
 @#  - get_python_type (function)
 @#  - value_to_py (function)
 @#######################################################################
 @
+@[if any(get_array_typecode(field.type) for field in spec.fields)]@
+import array
+@[end if]@
 from copy import copy
 import logging
 import traceback
@@ -154,7 +158,12 @@ class @(spec.base_type.type)(metaclass=Metaclass):
         from @(field.type.pkg_name).msg import @(field.type.type)
 @[      end if]@
 @[      if field.type.array_size and not field.type.is_upper_bound]@
-@[        if field.type.type == 'byte']@
+@[        if get_array_typecode(field.type)]@
+        self.@(field.name) = kwargs.get(
+            '@(field.name)',
+            array.array('@(get_array_typecode(field.type))', [0]) * @(field.type.array_size)
+        )
+@[        elif field.type.type == 'byte']@
         self.@(field.name) = kwargs.get(
             '@(field.name)',
             [bytes([0]) for x in range(@(field.type.array_size))]
@@ -170,6 +179,9 @@ class @(spec.base_type.type)(metaclass=Metaclass):
             [@(get_python_type(field.type))() for x in range(@(field.type.array_size))]
         )
 @[        end if]@
+@[      elif get_array_typecode(field.type)]@
+        self.@(field.name) = kwargs.get(
+            '@(field.name)', array.array('@(get_array_typecode(field.type))'))
 @[      elif field.type.is_array]@
         self.@(field.name) = kwargs.get('@(field.name)', [])
 @[      elif field.type.type == 'byte']@
@@ -218,6 +230,23 @@ if field.name in dict(inspect.getmembers(builtins)).keys():
 
     @@@(field.name).setter@(noqa_string)
     def @(field.name)(self, value):
+@[  if get_array_typecode(field.type)]@
+@{typecode = get_array_typecode(field.type)}@
+        if isinstance(value, array.array):
+            assert value.typecode == '@(typecode)', \
+                "The '@(field.name)' array.array() must have the type code of '@(typecode)'"
+@[    if field.type.array_size]@
+@[      if field.type.is_upper_bound]@
+            assert len(value) <= @(field.type.array_size), \
+                "The '@(field.name)' array.array() must have a length <= @(field.type.array_size)"
+@[      else]@
+            assert len(value) == @(field.type.array_size), \
+                "The '@(field.name)' array.array() must have a length of @(field.type.array_size)"
+@[      end if]@
+@[    end if]@
+            self._@(field.name) = value
+            return
+@[  end if]@
         if __debug__:
 @[  if not field.type.is_primitive_type()]@
             from @(field.type.pkg_name).msg import @(field.type.type)
@@ -324,5 +353,9 @@ bound = 2**nbits
 @[  else]@
                 False
 @[  end if]@
+@[  if get_array_typecode(field.type)]@
+        self._@(field.name) = array.array('@(get_array_typecode(field.type))', value)
+@[  else]@
         self._@(field.name) = value
+@[  end if]@
 @[end for]@
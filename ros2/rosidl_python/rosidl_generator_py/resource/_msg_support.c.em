@@ -9,6 +9,7 @@
 @#  - spec (rosidl_parser.MessageSpecification)
 @#    Parsed specification of the .msg file
 @#  - convert_camel_case_to_lower_case_underscore (function)
+@#  - get_array_typecode (function)
 @#  - primitive_msg_type_to_c (function)
 @#######################################################################
 @
@@ -159,6 +160,44 @@ lowercase_field_type = convert_camel_case_to_lower_case_underscore(field.type.ty
       return false;
     }
 @[    end if]@
+@[  elif get_array_typecode(field.type)]@
+    // numeric arrays are stored in an array.array, its buffer is copied at once
+    Py_buffer view;
+    if (PyObject_GetBuffer(field, &view, PyBUF_FORMAT) < 0) {
+      Py_DECREF(field);
+      return false;
+    }
+    if (
+      view.itemsize != sizeof(@primitive_msg_type_to_c(field.type.type)) ||
+      strcmp(view.format, "@(get_array_typecode(field.type))") != 0)
+    {
+      PyErr_SetString(PyExc_TypeError, "expected an array.array('@(get_array_typecode(field.type))') in '@(field.name)'");
+      PyBuffer_Release(&view);
+      Py_DECREF(field);
+      return false;
+    }
+    Py_ssize_t size = view.len / view.itemsize;
+@[    if field.type.array_size is None or field.type.is_upper_bound]@
+    if (!rosidl_generator_c__@(field.type.type)__Sequence__init(&(ros_message->@(field.name)), size)) {
+      PyErr_SetString(PyExc_RuntimeError, "unable to create @(field.type.type)__Sequence ros_message");
+      PyBuffer_Release(&view);
+      Py_DECREF(field);
+      return false;
+    }
+    @primitive_msg_type_to_c(field.type.type) * dest = ros_message->@(field.name).data;
+@[    else]@
+    if (size != @(field.type.array_size)) {
+      PyErr_SetString(PyExc_ValueError, "expected @(field.type.array_size) elements in '@(field.name)'");
+      PyBuffer_Release(&view);
+      Py_DECREF(field);
+      return false;
+    }
+    @primitive_msg_type_to_c(field.type.type) * dest = ros_message->@(field.name);
+@[    end if]@
+    if (size > 0) {
+      memcpy(dest, view.buf, view.len);
+    }
+    PyBuffer_Release(&view);
 @[  elif field.type.is_array]@
     PyObject * seq_field = PySequence_Fast(field, "expected a sequence in '@(field.name)'");
     if (!seq_field) {
@@ -363,6 +402,45 @@ lowercase_field_type = convert_camel_case_to_lower_case_underscore(field.type.ty
       return NULL;
     }
 @[    end if]@
+@[  elif get_array_typecode(field.type)]@
+    // the constructor already created the array.array, fill it in place
+    field = PyObject_GetAttrString(_pymessage, "@(field.name)");
+    if (!field) {
+      return NULL;
+    }
+@[    if field.type.array_size is None or field.type.is_upper_bound]@
+    // frombytes appends, drop the default values first
+    if (PySequence_DelSlice(field, 0, PY_SSIZE_T_MAX) < 0) {
+      Py_DECREF(field);
+      return NULL;
+    }
+    size_t size = ros_message->@(field.name).size;
+    @primitive_msg_type_to_c(field.type.type) * src = ros_message->@(field.name).data;
+    if (size > 0) {
+      PyObject * data = PyMemoryView_FromMemory(
+        (char *)src, size * sizeof(@primitive_msg_type_to_c(field.type.type)), PyBUF_READ);
+      if (!data) {
+        Py_DECREF(field);
+        return NULL;
+      }
+      PyObject * ret = PyObject_CallMethod(field, "frombytes", "O", data);
+      Py_DECREF(data);
+      if (!ret) {
+        Py_DECREF(field);
+        return NULL;
+      }
+      Py_DECREF(ret);
+    }
+@[    else]@
+    Py_buffer view;
+    if (PyObject_GetBuffer(field, &view, PyBUF_WRITABLE) < 0) {
+      Py_DECREF(field);
+      return NULL;
+    }
+    assert(view.len == @(field.type.array_size) * sizeof(@primitive_msg_type_to_c(field.type.type)));
+    memcpy(view.buf, ros_message->@(field.name), view.len);
+    PyBuffer_Release(&view);
+@[    end if]@
 @[  elif field.type.is_array]@
 @[    if field.type.array_size is None or field.type.is_upper_bound]@
     size_t size = ros_message->@(field.name).size;
@@ -53,6 +53,7 @@ def generate_py(generator_arguments_file, typesupport_impls):
 
     functions = {
         'constant_value_to_py': constant_value_to_py,
+        'get_array_typecode': get_array_typecode,
         'get_python_type': get_python_type,
         'primitive_msg_type_to_c': primitive_msg_type_to_c,
         'value_to_py': value_to_py,
@@ -245,3 +246,32 @@ def get_python_type(type_):
         return 'str'
 
     assert False, "unknown type '%s'" % type_
+
+
+# array.array type codes of the numeric types, the item size of all of them
+# matches the size of the C type on the supported platforms
+ARRAY_TYPECODES = {
+    'float32': 'f',
+    'float64': 'd',
+    'int8': 'b',
+    'uint8': 'B',
+    'int16': 'h',
+    'uint16': 'H',
+    'int32': 'i',
+    'uint32': 'I',
+    'int64': 'q',
+    'uint64': 'Q',
+}
+
+
+def get_array_typecode(type_):
+    """
+    Return the array.array type code used to store an array field.
+
+    Arrays of numeric types are stored in an array.array, so that they can be
+    copied to and from the C message with a single memcpy.
+    Other arrays are stored in lists and None is returned for them.
+    """
+    if not type_.is_primitive_type() or not type_.is_array:
+        return None
+    return ARRAY_TYPECODES.get(type_.type)
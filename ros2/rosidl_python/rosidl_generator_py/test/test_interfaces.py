@@ -12,6 +12,9 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import array
+import ctypes
+
 import pytest
 
 from rosidl_generator_py.msg import Constants
@@ -209,11 +212,11 @@ def test_check_constraints():
         setattr(c, 'char_value', b'abc')
 
     c.up_to_three_int32_values = []
-    assert [] == c.up_to_three_int32_values
+    assert array.array('i') == c.up_to_three_int32_values
     c.up_to_three_int32_values = [12345, -12345]
-    assert [12345, -12345] == c.up_to_three_int32_values
+    assert array.array('i', [12345, -12345]) == c.up_to_three_int32_values
     c.up_to_three_int32_values = [12345, -12345, 6789]
-    assert [12345, -12345, 6789] == c.up_to_three_int32_values
+    assert array.array('i', [12345, -12345, 6789]) == c.up_to_three_int32_values
     c.up_to_three_int32_values = [12345, -12345, 6789]
     with pytest.raises(AssertionError):
         setattr(c, 'up_to_three_int32_values', [12345, -12345, 6789, -6789])
@@ -228,6 +231,85 @@ def test_check_constraints():
         setattr(c, 'up_to_three_string_values', ['foo', 'bar', 'baz', 'hello'])
 
 
+def test_numeric_arrays():
+    c = Various()
+    assert array.array('H', [5, 23]) == c.two_uint16_value
+    assert array.array('i', [5, 23]) == c.up_to_three_int32_values_with_default_values
+    assert array.array('Q') == c.unbounded_uint64_values
+
+    # lists are converted to an array.array
+    c.unbounded_uint64_values = [1, 2, 3]
+    assert isinstance(c.unbounded_uint64_values, array.array)
+    assert [1, 2, 3] == c.unbounded_uint64_values.tolist()
+
+    # an array.array of the right type is stored as is
+    values = array.array('Q', range(1000))
+    c.unbounded_uint64_values = values
+    assert values is c.unbounded_uint64_values
+    with pytest.raises(AssertionError):
+        setattr(c, 'unbounded_uint64_values', array.array('d', [1.0]))
+
+    c.two_uint16_value = array.array('H', [1, 2])
+    assert array.array('H', [1, 2]) == c.two_uint16_value
+    with pytest.raises(AssertionError):
+        setattr(c, 'two_uint16_value', array.array('H', [1, 2, 3]))
+
+    c.up_to_three_int32_values = array.array('i', [1, 2, 3])
+    assert array.array('i', [1, 2, 3]) == c.up_to_three_int32_values
+    with pytest.raises(AssertionError):
+        setattr(c, 'up_to_three_int32_values', array.array('i', [1, 2, 3, 4]))
+
+    # arrays of other types remain lists
+    c.up_to_three_string_values = ['foo']
+    assert ['foo'] == c.up_to_three_string_values
+
+
+def _round_trip(msg):
+    """Convert a message to its C structure and back with the functions of its type support."""
+    metaclass = type(msg).__class__
+    if metaclass._TYPE_SUPPORT is None:
+        metaclass.__import_type_support__()
+    get_pointer = ctypes.pythonapi.PyCapsule_GetPointer
+    get_pointer.restype = ctypes.c_void_p
+    get_pointer.argtypes = [ctypes.py_object, ctypes.c_char_p]
+    create_ros_message = ctypes.CFUNCTYPE(ctypes.c_void_p)(
+        get_pointer(metaclass._CREATE_ROS_MESSAGE, None))
+    destroy_ros_message = ctypes.CFUNCTYPE(None, ctypes.c_void_p)(
+        get_pointer(metaclass._DESTROY_ROS_MESSAGE, None))
+    convert_from_py = ctypes.PYFUNCTYPE(ctypes.c_bool, ctypes.py_object, ctypes.c_void_p)(
+        get_pointer(metaclass._CONVERT_FROM_PY, None))
+    convert_to_py = ctypes.PYFUNCTYPE(ctypes.py_object, ctypes.c_void_p)(
+        get_pointer(metaclass._CONVERT_TO_PY, None))
+
+    ros_message = create_ros_message()
+    try:
+        assert convert_from_py(msg, ros_message)
+        return convert_to_py(ros_message)
+    finally:
+        destroy_ros_message(ros_message)
+
+
+def test_numeric_arrays_round_trip():
+    c = Various()
+    c.up_to_three_int32_values_with_default_values = [1]
+    c.unbounded_uint64_values = [1, 2, 3]
+    d = _round_trip(c)
+    # the values received replace the default values
+    assert array.array('i', [1]) == d.up_to_three_int32_values_with_default_values
+    assert array.array('Q', [1, 2, 3]) == d.unbounded_uint64_values
+    assert array.array('H', [5, 23]) == d.two_uint16_value
+
+    c.up_to_three_int32_values_with_default_values = []
+    c.two_uint16_value = [1, 2]
+    d = _round_trip(c)
+    assert array.array('i') == d.up_to_three_int32_values_with_default_values
+    assert array.array('H', [1, 2]) == d.two_uint16_value
+
+    d = _round_trip(Various())
+    assert array.array('i', [5, 23]) == d.up_to_three_int32_values_with_default_values
+    assert array.array('Q') == d.unbounded_uint64_values
+
+
 def test_out_of_range():
     a = Primitives()
     with pytest.raises(AssertionError):
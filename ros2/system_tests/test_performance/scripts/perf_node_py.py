@@ -0,0 +1,288 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+One stage of a publish / subscribe pipeline, measured through rclpy.
+
+Same roles, topics and output as perf_node, except the pipeline role: there is no intra-process
+communication in rclpy. Allocations are not counted.
+"""
+
+import argparse
+import array
+import json
+import math
+import os
+import sys
+import time
+
+TYPES = {
+    'Image': 'sensor_msgs.msg',
+    'PointCloud2': 'sensor_msgs.msg',
+    'Builtins': 'test_msgs.msg',
+}
+
+
+def now_ns():
+    # The monotonic clock is the steady clock of perf_node
+    return int(time.monotonic() * 1e9)
+
+
+def cpu_time():
+    times = os.times()
+    return times.user + times.system
+
+
+def hop_topic(hop):
+    return 'perf/hop_%d' % hop
+
+
+def make_message(msg_type, type_name, size):
+    msg = msg_type()
+    if type_name == 'Image':
+        msg.height = 1
+        msg.width = size
+        msg.encoding = 'mono8'
+        msg.step = size
+        msg.data = array.array('B', bytes(size))
+    elif type_name == 'PointCloud2':
+        msg.height = 1
+        msg.width = size
+        msg.point_step = 1
+        msg.row_step = size
+        msg.is_dense = True
+        msg.data = array.array('B', bytes(size))
+    return msg
+
+
+def stamp_of(msg, type_name):
+    return msg.time_value if type_name == 'Builtins' else msg.header.stamp
+
+
+def size_of(msg, type_name):
+    # Size of the two builtin fields, as the fixed size struct of perf_node
+    return 16 if type_name == 'Builtins' else len(msg.data)
+
+
+class Recorder:
+    """Messages handled by a stage, and their latencies when it is the last one."""
+
+    def __init__(self, args):
+        self.args = args
+        self.handled = 0
+        self.bytes = 0
+        self.last = now_ns()
+        self.latencies = []
+        self.start = None
+        self.end = None
+        self.cpu_start = None
+        self.cpu_end = None
+
+    def on_message(self, size, stamp=0):
+        now = now_ns()
+        index = self.handled
+        self.handled += 1
+        self.last = now
+        if index == self.args.warmup:
+            self.start = now
+            self.cpu_start = cpu_time()
+        if self.args.warmup <= index < self.args.warmup + self.args.count:
+            if stamp:
+                self.latencies.append(now - stamp)
+            self.bytes += size
+        if index + 1 == self.args.warmup + self.args.count:
+            self.stop(now)
+
+    def done(self):
+        return self.end is not None
+
+    def stop(self, end=None):
+        if self.start is None or self.end is not None:
+            return
+        self.end = self.last if end is None else end
+        self.cpu_end = cpu_time()
+
+    def measured(self):
+        return min(max(self.handled - self.args.warmup, 0), self.args.count)
+
+    def result(self, rmw_implementation):
+        measured = self.measured()
+        duration = (self.end - self.start) / 1e9 if self.end is not None else 0.0
+        cpu = self.cpu_end - self.cpu_start if self.end is not None else None
+        result = {
+            'client_library': 'rclpy',
+            'rmw_implementation': rmw_implementation,
+            'role': self.args.role,
+            'type': self.args.type,
+            'size': self.args.size,
+            'rate': self.args.rate,
+            'hops': self.args.hops,
+            'messages': self.args.count,
+            'handled': measured,
+            'duration': duration if duration > 0.0 else None,
+            'throughput': measured / duration if duration > 0.0 else None,
+            'bandwidth': self.bytes / duration if duration > 0.0 else None,
+            'cpu_time': cpu,
+            'cpu_usage': cpu / duration if cpu is not None and duration > 0.0 else None,
+            'allocations_per_message': None,
+        }
+        if self.latencies:
+            result['latency'] = latency_statistics(self.latencies)
+        return result
+
+
+def latency_statistics(latencies_ns):
+    """Return the latencies in microseconds, with a histogram of 1-2-5 buckets up to 5 s."""
+    latencies = sorted(latency / 1e3 for latency in latencies_ns)
+
+    def percentile(p):
+        index = int(math.ceil(p / 100.0 * len(latencies)))
+        return latencies[min(len(latencies), max(index, 1)) - 1]
+
+    histogram = []
+    counted = 0
+    for decade in range(7):
+        for step in (1, 2, 5):
+            bound = step * 10 ** decade
+            end = counted
+            while end < len(latencies) and latencies[end] <= bound:
+                end += 1
+            histogram.append([bound, end - counted])
+            counted = end
+    histogram.append([None, len(latencies) - counted])
+    return {
+        'min': latencies[0],
+        'mean': sum(latencies) / len(latencies),
+        'p50': percentile(50.0),
+        'p90': percentile(90.0),
+        'p99': percentile(99.0),
+        'max': latencies[-1],
+        'histogram': histogram,
+    }
+
+
+def wait_for_subscribers(node, topic, timeout):
+    deadline = time.monotonic() + timeout
+    while node.count_subscribers(topic) == 0:
+        if time.monotonic() > deadline:
+            return False
+        time.sleep(0.01)
+    return True
+
+
+def run(args):
+    import importlib
+    import rclpy
+    from rclpy.executors import SingleThreadedExecutor
+    from rclpy.qos import qos_profile_default
+    from rclpy.qos import QoSProfile
+    from rclpy.utilities import get_rmw_implementation_identifier
+
+    type_name = args.type
+    msg_type = getattr(importlib.import_module(TYPES[type_name]), type_name)
+    qos = QoSProfile(
+        history=qos_profile_default.history,
+        depth=args.depth,
+        reliability=qos_profile_default.reliability,
+        durability=qos_profile_default.durability)
+
+    rclpy.init(args=[])
+    executor = SingleThreadedExecutor()
+    recorder = Recorder(args)
+    ret = 0
+    node = rclpy.create_node('perf_%s_py' % args.role, namespace=args.namespace or None)
+    executor.add_node(node)
+
+    if args.role == 'sub':
+        def on_message(msg):
+            stamp = stamp_of(msg, type_name)
+            recorder.on_message(size_of(msg, type_name), stamp.sec * 1000000000 + stamp.nanosec)
+        node.create_subscription(msg_type, hop_topic(args.hops), on_message, qos_profile=qos)
+    elif args.role == 'relay':
+        publisher = node.create_publisher(msg_type, hop_topic(args.hop + 1), qos_profile=qos)
+        if not wait_for_subscribers(node, hop_topic(args.hop + 1), args.timeout):
+            print("no subscriber on '%s'" % hop_topic(args.hop + 1), file=sys.stderr)
+            return 1
+
+        def on_message(msg):
+            publisher.publish(msg)
+            recorder.on_message(size_of(msg, type_name))
+        node.create_subscription(msg_type, hop_topic(args.hop), on_message, qos_profile=qos)
+    else:
+        publisher = node.create_publisher(msg_type, hop_topic(0), qos_profile=qos)
+        if not wait_for_subscribers(node, hop_topic(0), args.timeout):
+            print("no subscriber on '%s'" % hop_topic(0), file=sys.stderr)
+            ret = 1
+        msg = make_message(msg_type, type_name, args.size)
+        stamp = stamp_of(msg, type_name)
+        period = 1.0 / args.rate if args.rate > 0.0 else 0.0
+        next_time = time.monotonic()
+        for _ in range(args.warmup + args.count if ret == 0 else 0):
+            now = now_ns()
+            stamp.sec = now // 1000000000
+            stamp.nanosec = now % 1000000000
+            publisher.publish(msg)
+            recorder.on_message(size_of(msg, type_name))
+            if period:
+                next_time += period
+                time.sleep(max(0.0, next_time - time.monotonic()))
+        recorder.stop()
+        # Let the last messages be delivered before the publisher goes away
+        time.sleep(1.0)
+
+    while args.role != 'pub' and not recorder.done() and \
+            now_ns() - recorder.last < args.timeout * 1e9:
+        executor.spin_once(timeout_sec=0.1)
+    recorder.stop()
+
+    result = recorder.result(get_rmw_implementation_identifier())
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(result, f, indent=2)
+    else:
+        print(json.dumps(result, indent=2))
+    if args.role != 'pub' and not recorder.measured():
+        print('no message received', file=sys.stderr)
+        ret = 1
+
+    node.destroy_node()
+    rclpy.shutdown()
+    return ret
+
+
+def main(argv=sys.argv[1:]):
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+    parser.add_argument('type', choices=sorted(TYPES.keys()), help='message type')
+    parser.add_argument('role', choices=['pub', 'relay', 'sub'], help='stage of the pipeline')
+    parser.add_argument('--rate', type=float, default=100.0, help='messages per second, 0 for '
+                        'as fast as possible')
+    parser.add_argument('--size', type=int, default=1024, help='payload size in bytes')
+    parser.add_argument('--count', type=int, default=1000, help='number of measured messages')
+    parser.add_argument('--warmup', type=int, default=100, help='number of messages to ignore')
+    parser.add_argument('--hops', type=int, default=0, help='number of relays')
+    parser.add_argument('--hop', type=int, default=0, help='index of the relay')
+    parser.add_argument('--depth', type=int, default=10, help='history depth')
+    parser.add_argument('--timeout', type=float, default=10.0,
+                        help='seconds to wait for a subscriber or a message')
+    parser.add_argument('--namespace', default='', help='namespace of the node')
+    parser.add_argument('--output', default='', help='JSON file to write the results to')
+    args = parser.parse_args(argv)
+    if args.count <= 0 or args.rate < 0.0:
+        parser.error('--count must be positive and --rate must not be negative')
+    return run(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
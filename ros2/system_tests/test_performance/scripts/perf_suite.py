@@ -0,0 +1,319 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Run publish / subscribe pipelines through rclcpp and rclpy, and compare their results.
+
+The run command starts every scenario for every combination of message type, size and rate,
+and writes the results as JSON. The compare command reports the differences between two such
+files, and fails when a metric regressed by more than a threshold.
+
+Scenarios:
+  intra           rclcpp publisher and subscriber in one process, intra-process
+  intra_multihop  same, through relays
+  inter           rclcpp publisher and subscriber in two processes
+  multihop        same, through relays, each in its own process
+  rclpy           rclpy publisher and subscriber in two processes
+"""
+
+import argparse
+import datetime
+import itertools
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+
+SCENARIOS = ['intra', 'intra_multihop', 'inter', 'multihop', 'rclpy']
+
+# Compared metrics, the direction in which they improve and the change ignored below threshold
+METRICS = [
+    ('latency.p50', 'lower', 0.0),
+    ('latency.p99', 'lower', 0.0),
+    ('throughput', 'higher', 0.0),
+    ('cpu_time_per_message', 'lower', 0.0),
+    ('allocations_per_message', 'lower', 0.5),
+]
+
+KEY = ('scenario', 'type', 'size', 'rate', 'hops')
+
+
+def stages(scenario, hops):
+    """Return the client library and the (role, hop) of each process, the last stage first."""
+    if scenario in ('intra', 'intra_multihop'):
+        return 'rclcpp', [('pipeline', 0)]
+    stage_list = [('sub', 0)]
+    stage_list += [('relay', hop) for hop in reversed(range(hops))]
+    stage_list.append(('pub', 0))
+    return 'rclpy' if scenario == 'rclpy' else 'rclcpp', stage_list
+
+
+def run_scenario(args, scenario, type_name, size, rate, allocations, directory, index):
+    hops = args.hops if scenario in ('intra_multihop', 'multihop') else 0
+    client_library, stage_list = stages(scenario, hops)
+    namespace = '/perf_%d_%d' % (os.getpid(), index)
+    count = args.allocation_count if allocations else args.count
+    env = dict(os.environ)
+    if allocations:
+        preload = 'DYLD_INSERT_LIBRARIES' if sys.platform == 'darwin' else 'LD_PRELOAD'
+        env[preload] = args.memory_tools
+
+    processes = []
+    for role, hop in stage_list:
+        output = os.path.join(directory, '%d_%s_%d.json' % (index, role, hop))
+        if client_library == 'rclpy':
+            cmd = [sys.executable, args.perf_node_py]
+        else:
+            cmd = [args.perf_node]
+        cmd += [
+            type_name, role,
+            '--rate', str(rate), '--size', str(size),
+            '--count', str(count), '--warmup', str(args.warmup),
+            '--hops', str(hops), '--hop', str(hop), '--depth', str(args.depth),
+            '--timeout', str(args.timeout), '--namespace', namespace, '--output', output]
+        if allocations and client_library == 'rclcpp':
+            cmd.append('--allocations')
+        processes.append((role, output, subprocess.Popen(cmd, env=env)))
+
+    # Every stage ends on its own, at the latest once its timeout expired without messages
+    deadline = (args.warmup + count) / rate if rate > 0.0 else 0.0
+    deadline += 4 * args.timeout + 10.0 * (len(processes) + 1)
+    failed = False
+    for role, output, process in reversed(processes):
+        try:
+            failed = process.wait(timeout=deadline) != 0 or failed
+        except subprocess.TimeoutExpired:
+            process.kill()
+            process.wait()
+            failed = True
+
+    results = []
+    for role, output, process in processes:
+        try:
+            with open(output, 'r') as f:
+                results.append(json.load(f))
+        except (IOError, ValueError):
+            failed = True
+    return failed, results
+
+
+def summarize(scenario, type_name, size, rate, hops, results):
+    """Merge the results of the processes of a scenario."""
+    last = next((result for result in results if result.get('role') in ('sub', 'pipeline')), {})
+    received = last.get('handled', 0)
+    cpu_times = [result.get('cpu_time') for result in results]
+    cpu_time = sum(cpu_times) if cpu_times and None not in cpu_times else None
+    duration = last.get('duration')
+    return {
+        'scenario': scenario,
+        'client_library': last.get('client_library'),
+        'rmw_implementation': last.get('rmw_implementation'),
+        'type': type_name,
+        'size': size,
+        'rate': rate,
+        'hops': hops,
+        'messages': last.get('messages'),
+        'received': received,
+        'lost': last.get('messages', 0) - received,
+        'latency': last.get('latency'),
+        'throughput': last.get('throughput'),
+        'bandwidth': last.get('bandwidth'),
+        'cpu_usage': cpu_time / duration if cpu_time is not None and duration else None,
+        'cpu_time_per_message': 1e6 * cpu_time / received if cpu_time is not None and received
+        else None,
+        'allocations_per_message': None,
+        'processes': results,
+    }
+
+
+def add_allocations(summary, results):
+    allocations = [result.get('allocations_per_message') for result in results]
+    if results and None not in allocations:
+        summary['allocations_per_message'] = sum(allocations)
+
+
+def command_run(args):
+    if args.quick:
+        args.types, args.sizes, args.rates = 'Image', '1024', '100'
+        args.count, args.warmup, args.allocation_count = 100, 10, 20
+    scenarios = args.scenarios.split(',')
+    for scenario in scenarios:
+        if scenario not in SCENARIOS:
+            print("unknown scenario '%s'" % scenario, file=sys.stderr)
+            return 1
+    if args.memory_tools and not os.path.isfile(args.memory_tools):
+        print("memory_tools library '%s' not found" % args.memory_tools, file=sys.stderr)
+        return 1
+
+    summaries = []
+    failures = 0
+    index = 0
+    with tempfile.TemporaryDirectory() as directory:
+        combinations = itertools.product(
+            scenarios, args.types.split(','),
+            [int(size) for size in args.sizes.split(',')],
+            [float(rate) for rate in args.rates.split(',')])
+        for scenario, type_name, size, rate in combinations:
+            hops = args.hops if scenario in ('intra_multihop', 'multihop') else 0
+            print('%s %s size %d rate %g hops %d' % (scenario, type_name, size, rate, hops),
+                  file=sys.stderr)
+            index += 1
+            failed, results = run_scenario(
+                args, scenario, type_name, size, rate, False, directory, index)
+            summary = summarize(scenario, type_name, size, rate, hops, results)
+            # Counting allocations slows them down, they are counted in a separate run
+            if args.memory_tools and scenario != 'rclpy':
+                index += 1
+                allocation_failed, allocation_results = run_scenario(
+                    args, scenario, type_name, size, rate, True, directory, index)
+                add_allocations(summary, allocation_results)
+                failed = failed or allocation_failed
+            if failed or not summary['received']:
+                print('  failed', file=sys.stderr)
+                failures += 1
+            summaries.append(summary)
+
+    document = {
+        'format': 1,
+        'date': datetime.datetime.utcnow().isoformat() + 'Z',
+        'host': platform.node(),
+        'platform': platform.platform(),
+        'results': summaries,
+    }
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(document, f, indent=2)
+    else:
+        print(json.dumps(document, indent=2))
+    print_table(summaries, sys.stderr)
+    return 1 if failures else 0
+
+
+def get_metric(result, metric):
+    value = result
+    for part in metric.split('.'):
+        if not isinstance(value, dict):
+            return None
+        value = value.get(part)
+    return value
+
+
+def key_of(result):
+    return tuple(result.get(field) for field in KEY)
+
+
+def format_key(key):
+    return '%s %s size %s rate %g hops %s' % (key[0], key[1], key[2], key[3], key[4])
+
+
+def print_table(results, file):
+    columns = ['latency.p50', 'latency.p99', 'throughput', 'cpu_time_per_message',
+               'allocations_per_message']
+    print('%-48s %12s %12s %12s %12s %12s' % (
+        'scenario', 'p50 (us)', 'p99 (us)', 'msg/s', 'cpu/msg (us)', 'allocs/msg'), file=file)
+    for result in results:
+        values = []
+        for column in columns:
+            value = get_metric(result, column)
+            values.append('%12s' % ('-' if value is None else '%.2f' % value))
+        print('%-48s %s' % (format_key(key_of(result)), ' '.join(values)), file=file)
+
+
+def command_compare(args):
+    with open(args.baseline, 'r') as f:
+        baseline = {key_of(result): result for result in json.load(f)['results']}
+    with open(args.current, 'r') as f:
+        current = {key_of(result): result for result in json.load(f)['results']}
+
+    regressions = 0
+    print('%-48s %-24s %12s %12s %9s' % ('scenario', 'metric', 'baseline', 'current', 'change'))
+    for key in sorted(set(baseline) | set(current), key=lambda key: [str(part) for part in key]):
+        if key not in baseline or key not in current:
+            print('%-48s only in %s' % (
+                format_key(key), 'baseline' if key in baseline else 'current'))
+            continue
+        for metric, better, ignored in METRICS:
+            old = get_metric(baseline[key], metric)
+            new = get_metric(current[key], metric)
+            if old is None or new is None:
+                continue
+            change = 100.0 * (new - old) / old if old else (0.0 if new == old else float('inf'))
+            worse = new - old if better == 'lower' else old - new
+            regressed = worse > ignored and abs(change) > args.threshold
+            regressions += 1 if regressed else 0
+            print('%-48s %-24s %12.2f %12.2f %+8.1f%%%s' % (
+                format_key(key), metric, old, new, change, ' REGRESSION' if regressed else ''))
+    print('%d regression(s) above %g%%' % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+def main(argv=sys.argv[1:]):
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    subparsers = parser.add_subparsers(dest='command')
+
+    run_parser = subparsers.add_parser('run', help='run the scenarios')
+    run_parser.add_argument('--scenarios', default=','.join(SCENARIOS),
+                            help='comma separated scenarios, default: %(default)s')
+    run_parser.add_argument('--types', default='Image,PointCloud2,Builtins',
+                            help='comma separated message types, default: %(default)s')
+    run_parser.add_argument('--sizes', default='1024,65536,1048576',
+                            help='comma separated payload sizes in bytes, default: %(default)s')
+    run_parser.add_argument('--rates', default='100,1000',
+                            help='comma separated rates in Hz, 0 for as fast as possible, '
+                            'default: %(default)s')
+    run_parser.add_argument('--count', type=int, default=1000,
+                            help='measured messages per run, default: %(default)s')
+    run_parser.add_argument('--warmup', type=int, default=100,
+                            help='messages ignored at the start, default: %(default)s')
+    run_parser.add_argument('--hops', type=int, default=2,
+                            help='relays of the multihop scenarios, default: %(default)s')
+    run_parser.add_argument('--depth', type=int, default=10,
+                            help='history depth, default: %(default)s')
+    run_parser.add_argument('--timeout', type=float, default=10.0,
+                            help='seconds a stage waits for a peer, default: %(default)s')
+    run_parser.add_argument('--memory-tools', default='',
+                            help='memory_tools interpose library, to count allocations')
+    run_parser.add_argument('--allocation-count', type=int, default=100,
+                            help='measured messages when counting allocations, '
+                            'default: %(default)s')
+    run_parser.add_argument('--perf-node', default=os.path.join(here, 'perf_node'),
+                            help='perf_node executable')
+    run_parser.add_argument('--perf-node-py', default=os.path.join(here, 'perf_node_py.py'),
+                            help='perf_node_py.py script')
+    run_parser.add_argument('--quick', action='store_true',
+                            help='run small and short pipelines only, as a smoke test')
+    run_parser.add_argument('--output', default='', help='JSON file to write the results to')
+
+    compare_parser = subparsers.add_parser('compare', help='compare two results files')
+    compare_parser.add_argument('baseline', help='results of the reference run')
+    compare_parser.add_argument('current', help='results to check')
+    compare_parser.add_argument('--threshold', type=float, default=10.0,
+                                help='change in percent reported as a regression, '
+                                'default: %(default)s')
+
+    args = parser.parse_args(argv)
+    if args.command == 'run':
+        return command_run(args)
+    if args.command == 'compare':
+        return command_compare(args)
+    parser.print_help()
+    return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,680 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// One stage of a publish / subscribe pipeline, measured through rclcpp.
+//
+// A pipeline goes from a publisher through a number of relays to a subscriber, over the topics
+// perf/hop_0 ... perf/hop_<hops>. Each stage can run in its own process (roles pub, relay and
+// sub), or the whole pipeline can run in a single process with intra-process communication
+// (role pipeline). Messages are stamped with the steady clock when published, so latencies are
+// only meaningful between processes on the same host.
+//
+// Usage: perf_node <Image|PointCloud2|Builtins> <pub|relay|sub|pipeline>
+//   [--rate HZ] [--size BYTES] [--count N] [--warmup N] [--hops N] [--hop I] [--depth N]
+//   [--timeout S] [--namespace NS] [--allocations] [--output FILE]
+//
+// A rate of 0 publishes as fast as possible. With --allocations, and with the memory_tools
+// library preloaded, allocations are counted instead of being left out; counting slows every
+// allocation down, so latencies and CPU usage of such runs should not be compared to others.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+# include <sys/resource.h>
+#endif
+
+#include "osrf_testing_tools_cpp/memory_tools/memory_tools.hpp"
+#include "osrf_testing_tools_cpp/memory_tools/verbosity.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "rcutils/cmdline_parser.h"
+
+#include "rmw/rmw.h"
+
+#include "sensor_msgs/msg/image.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+
+#include "test_msgs/msg/builtins.hpp"
+
+namespace
+{
+
+struct Options
+{
+  std::string type;
+  std::string role;
+  double rate = 100.0;
+  size_t size = 1024;
+  size_t count = 1000;
+  size_t warmup = 100;
+  size_t hops = 0;
+  size_t hop = 0;
+  size_t depth = 10;
+  double timeout = 10.0;
+  std::string namespace_;
+  bool allocations = false;
+  std::string output;
+};
+
+int64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double process_cpu_time()
+{
+#ifdef _WIN32
+  return -1.0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1.0;
+  }
+  return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+         static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+void to_time(int64_t stamp, builtin_interfaces::msg::Time & time)
+{
+  time.sec = static_cast<int32_t>(stamp / 1000000000);
+  time.nanosec = static_cast<uint32_t>(stamp % 1000000000);
+}
+
+int64_t from_time(const builtin_interfaces::msg::Time & time)
+{
+  return static_cast<int64_t>(time.sec) * 1000000000 + time.nanosec;
+}
+
+// How to fill a message with a payload of a given size, and where to put its stamp
+template<typename MessageT>
+struct MessageTraits;
+
+template<>
+struct MessageTraits<sensor_msgs::msg::Image>
+{
+  static void fill(sensor_msgs::msg::Image & msg, size_t size)
+  {
+    msg.height = 1;
+    msg.width = static_cast<uint32_t>(size);
+    msg.encoding = "mono8";
+    msg.step = static_cast<uint32_t>(size);
+    msg.data.resize(size);
+  }
+
+  static size_t size(const sensor_msgs::msg::Image & msg)
+  {
+    return msg.data.size();
+  }
+
+  static builtin_interfaces::msg::Time & stamp(sensor_msgs::msg::Image & msg)
+  {
+    return msg.header.stamp;
+  }
+};
+
+template<>
+struct MessageTraits<sensor_msgs::msg::PointCloud2>
+{
+  static void fill(sensor_msgs::msg::PointCloud2 & msg, size_t size)
+  {
+    msg.height = 1;
+    msg.width = static_cast<uint32_t>(size);
+    msg.point_step = 1;
+    msg.row_step = static_cast<uint32_t>(size);
+    msg.is_dense = true;
+    msg.data.resize(size);
+  }
+
+  static size_t size(const sensor_msgs::msg::PointCloud2 & msg)
+  {
+    return msg.data.size();
+  }
+
+  static builtin_interfaces::msg::Time & stamp(sensor_msgs::msg::PointCloud2 & msg)
+  {
+    return msg.header.stamp;
+  }
+};
+
+// Fixed size, the requested size is ignored
+template<>
+struct MessageTraits<test_msgs::msg::Builtins>
+{
+  static void fill(test_msgs::msg::Builtins &, size_t)
+  {
+  }
+
+  static size_t size(const test_msgs::msg::Builtins &)
+  {
+    return sizeof(test_msgs::msg::Builtins);
+  }
+
+  static builtin_interfaces::msg::Time & stamp(test_msgs::msg::Builtins & msg)
+  {
+    return msg.time_value;
+  }
+};
+
+std::atomic<uint64_t> g_allocations(0);
+
+// Counts the allocations of all threads while enabled, when the memory_tools library is preloaded
+class AllocationCounter
+{
+public:
+  explicit AllocationCounter(bool requested)
+  : working_(false)
+  {
+    if (!requested) {
+      return;
+    }
+    namespace memory_tools = osrf_testing_tools_cpp::memory_tools;
+    memory_tools::set_verbosity_level(memory_tools::VerbosityLevel::quiet);
+    memory_tools::initialize();
+    memory_tools::enable_monitoring_in_all_threads();
+    working_ = memory_tools::is_working();
+    auto count = [](memory_tools::MemoryToolsService & service) {
+        service.ignore();
+        ++g_allocations;
+      };
+    memory_tools::on_malloc(count);
+    memory_tools::on_realloc(count);
+    memory_tools::on_calloc(count);
+    memory_tools::disable_monitoring_in_all_threads();
+    if (!working_) {
+      fprintf(stderr, "memory_tools is not preloaded, allocations are not counted\n");
+    }
+  }
+
+  ~AllocationCounter()
+  {
+    if (working_) {
+      osrf_testing_tools_cpp::memory_tools::uninitialize();
+    }
+  }
+
+  bool working() const
+  {
+    return working_;
+  }
+
+  void enable()
+  {
+    if (working_) {
+      osrf_testing_tools_cpp::memory_tools::enable_monitoring_in_all_threads();
+    }
+  }
+
+  void disable()
+  {
+    if (working_) {
+      osrf_testing_tools_cpp::memory_tools::disable_monitoring_in_all_threads();
+    }
+  }
+
+private:
+  bool working_;
+};
+
+// Wall time, CPU time and allocations between the first and the last measured message
+class Window
+{
+public:
+  explicit Window(AllocationCounter & allocation_counter)
+  : allocation_counter_(allocation_counter), started_(false), stopped_(false),
+    start_(0), end_(0), cpu_start_(0.0), cpu_end_(0.0), allocations_(0)
+  {
+  }
+
+  void start()
+  {
+    started_ = true;
+    start_ = now_ns();
+    cpu_start_ = process_cpu_time();
+    allocations_ = g_allocations.load();
+    allocation_counter_.enable();
+  }
+
+  void stop(int64_t end)
+  {
+    if (!started_ || stopped_) {
+      return;
+    }
+    allocation_counter_.disable();
+    stopped_ = true;
+    end_ = end;
+    cpu_end_ = process_cpu_time();
+    allocations_ = g_allocations.load() - allocations_;
+  }
+
+  // Seconds between start and stop
+  double duration() const
+  {
+    return stopped_ ? static_cast<double>(end_ - start_) / 1e9 : 0.0;
+  }
+
+  // Seconds of CPU used by the process, negative when unknown
+  double cpu_time() const
+  {
+    return stopped_ && cpu_start_ >= 0.0 ? cpu_end_ - cpu_start_ : -1.0;
+  }
+
+  // Allocations made by the process, negative when not counted
+  int64_t allocations() const
+  {
+    return stopped_ && allocation_counter_.working() ? static_cast<int64_t>(allocations_) : -1;
+  }
+
+private:
+  AllocationCounter & allocation_counter_;
+  bool started_;
+  bool stopped_;
+  int64_t start_;
+  int64_t end_;
+  double cpu_start_;
+  double cpu_end_;
+  uint64_t allocations_;
+};
+
+// Messages handled by a stage, and their latencies when it is the last one
+class Recorder
+{
+public:
+  Recorder(const Options & options, AllocationCounter & allocation_counter)
+  : warmup_(options.warmup), count_(options.count), window_(allocation_counter), handled_(0),
+    bytes_(0), last_(now_ns()), done_(false)
+  {
+    latencies_.reserve(count_);
+  }
+
+  // Called for every message, with its stamp when the latency is recorded
+  void on_message(size_t bytes, int64_t stamp = 0)
+  {
+    int64_t now = now_ns();
+    size_t index = handled_++;
+    last_ = now;
+    if (index == warmup_) {
+      window_.start();
+    }
+    if (index >= warmup_ && index < warmup_ + count_) {
+      if (0 != stamp) {
+        latencies_.push_back(now - stamp);
+      }
+      bytes_ += bytes;
+    }
+    if (index + 1 == warmup_ + count_) {
+      window_.stop(now);
+      done_ = true;
+    }
+  }
+
+  bool done() const
+  {
+    return done_;
+  }
+
+  // Nanoseconds since the last message, or since the recorder was created
+  int64_t idle() const
+  {
+    return now_ns() - last_;
+  }
+
+  // Stop the window at the last message when messages are missing
+  void stop()
+  {
+    window_.stop(last_);
+  }
+
+  size_t measured() const
+  {
+    return handled_ > warmup_ ? std::min(handled_.load() - warmup_, count_) : 0;
+  }
+
+  void write(const Options & options, FILE * file) const;
+
+private:
+  size_t warmup_;
+  size_t count_;
+  Window window_;
+  std::atomic<size_t> handled_;
+  uint64_t bytes_;
+  std::atomic<int64_t> last_;
+  std::atomic<bool> done_;
+  std::vector<int64_t> latencies_;
+};
+
+void write_number(FILE * file, const char * name, double value, bool last = false)
+{
+  if (value < 0.0 || std::isnan(value)) {
+    fprintf(file, "  \"%s\": null%s\n", name, last ? "" : ",");
+  } else {
+    fprintf(file, "  \"%s\": %.6f%s\n", name, value, last ? "" : ",");
+  }
+}
+
+void Recorder::write(const Options & options, FILE * file) const
+{
+  size_t measured = this->measured();
+  double duration = window_.duration();
+  double cpu_time = window_.cpu_time();
+  int64_t allocations = window_.allocations();
+
+  fprintf(file, "{\n");
+  fprintf(file, "  \"client_library\": \"rclcpp\",\n");
+  fprintf(file, "  \"rmw_implementation\": \"%s\",\n", rmw_get_implementation_identifier());
+  fprintf(file, "  \"role\": \"%s\",\n", options.role.c_str());
+  fprintf(file, "  \"type\": \"%s\",\n", options.type.c_str());
+  fprintf(file, "  \"size\": %zu,\n", options.size);
+  fprintf(file, "  \"rate\": %.3f,\n", options.rate);
+  fprintf(file, "  \"hops\": %zu,\n", options.hops);
+  fprintf(file, "  \"messages\": %zu,\n", count_);
+  fprintf(file, "  \"handled\": %zu,\n", measured);
+  write_number(file, "duration", duration);
+  write_number(file, "throughput", duration > 0.0 ? measured / duration : -1.0);
+  write_number(file, "bandwidth", duration > 0.0 ? bytes_ / duration : -1.0);
+  write_number(file, "cpu_time", cpu_time);
+  write_number(file, "cpu_usage", cpu_time >= 0.0 && duration > 0.0 ? cpu_time / duration : -1.0);
+  write_number(
+    file, "allocations_per_message",
+    allocations >= 0 && measured > 0 ? static_cast<double>(allocations) / measured : -1.0,
+    latencies_.empty());
+  if (latencies_.empty()) {
+    fprintf(file, "}\n");
+    return;
+  }
+
+  // Latencies in microseconds, with a histogram of 1-2-5 buckets from 1 us to 5 s
+  std::vector<double> latencies;
+  latencies.reserve(latencies_.size());
+  for (int64_t latency : latencies_) {
+    latencies.push_back(static_cast<double>(latency) / 1e3);
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+      size_t index = static_cast<size_t>(std::ceil(p / 100.0 * latencies.size()));
+      return latencies[std::min(latencies.size(), std::max<size_t>(index, 1)) - 1];
+    };
+  double sum = 0.0;
+  for (double latency : latencies) {
+    sum += latency;
+  }
+  fprintf(file, "  \"latency\": {\n");
+  fprintf(file, "    \"min\": %.3f,\n", latencies.front());
+  fprintf(file, "    \"mean\": %.3f,\n", sum / latencies.size());
+  fprintf(file, "    \"p50\": %.3f,\n", percentile(50.0));
+  fprintf(file, "    \"p90\": %.3f,\n", percentile(90.0));
+  fprintf(file, "    \"p99\": %.3f,\n", percentile(99.0));
+  fprintf(file, "    \"max\": %.3f,\n", latencies.back());
+  fprintf(file, "    \"histogram\": [");
+  size_t counted = 0;
+  const char * separator = "";
+  for (double decade = 1.0; decade < 1e7; decade *= 10.0) {
+    for (double step : {1.0, 2.0, 5.0}) {
+      double bound = decade * step;
+      size_t end = std::upper_bound(latencies.begin(), latencies.end(), bound) - latencies.begin();
+      fprintf(file, "%s[%.0f, %zu]", separator, bound, end - counted);
+      counted = end;
+      separator = ", ";
+    }
+  }
+  fprintf(file, ", [null, %zu]]\n", latencies.size() - counted);
+  fprintf(file, "  }\n");
+  fprintf(file, "}\n");
+}
+
+std::string hop_topic(size_t hop)
+{
+  return "perf/hop_" + std::to_string(hop);
+}
+
+// Wait until a publisher is matched, or the timeout expires
+bool wait_for_subscribers(
+  const rclcpp::Node::SharedPtr & node, const std::string & topic, double timeout)
+{
+  int64_t deadline = now_ns() + static_cast<int64_t>(timeout * 1e9);
+  while (rclcpp::ok() && node->count_subscribers(topic) == 0) {
+    if (now_ns() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return rclcpp::ok();
+}
+
+template<typename MessageT>
+int run(const Options & options)
+{
+  using Traits = MessageTraits<MessageT>;
+
+  rmw_qos_profile_t qos = rmw_qos_profile_default;
+  qos.depth = options.depth;
+
+  const bool pipeline = options.role == "pipeline";
+  const bool publishes = pipeline || options.role == "pub";
+  rclcpp::executors::SingleThreadedExecutor executor;
+  std::vector<rclcpp::Node::SharedPtr> nodes;
+  auto add_node = [&](const std::string & name) -> rclcpp::Node::SharedPtr {
+      auto node = std::make_shared<rclcpp::Node>(name, options.namespace_, pipeline);
+      executor.add_node(node);
+      nodes.push_back(node);
+      return node;
+    };
+
+  AllocationCounter allocation_counter(options.allocations);
+  Recorder recorder(options, allocation_counter);
+  std::vector<rclcpp::SubscriptionBase::SharedPtr> subscriptions;
+  std::vector<rclcpp::PublisherBase::SharedPtr> publishers;
+
+  // Stages are created from the end of the pipeline, each relay subscribes once it is matched
+  if (pipeline || options.role == "sub") {
+    rclcpp::Node::SharedPtr node = add_node("perf_sub");
+    subscriptions.push_back(node->create_subscription<MessageT>(
+        hop_topic(options.hops),
+        [&recorder](std::unique_ptr<MessageT> msg) {
+          recorder.on_message(Traits::size(*msg), from_time(Traits::stamp(*msg)));
+        }, qos));
+  }
+  std::vector<size_t> relays;
+  if (pipeline) {
+    for (size_t hop = options.hops; hop > 0; --hop) {
+      relays.push_back(hop - 1);
+    }
+  } else if (options.role == "relay") {
+    relays.push_back(options.hop);
+  }
+  for (size_t hop : relays) {
+    rclcpp::Node::SharedPtr node = add_node("perf_relay_" + std::to_string(hop));
+    auto publisher = node->create_publisher<MessageT>(hop_topic(hop + 1), qos);
+    publishers.push_back(publisher);
+    if (!wait_for_subscribers(node, hop_topic(hop + 1), options.timeout)) {
+      fprintf(stderr, "no subscriber on '%s'\n", hop_topic(hop + 1).c_str());
+      return 1;
+    }
+    // A relay process records the messages it forwards, a pipeline only records its subscriber
+    const bool record = !pipeline;
+    subscriptions.push_back(node->create_subscription<MessageT>(
+        hop_topic(hop),
+        [&recorder, publisher, record](std::unique_ptr<MessageT> msg) {
+          size_t size = Traits::size(*msg);
+          publisher->publish(msg);
+          if (record) {
+            recorder.on_message(size);
+          }
+        }, qos));
+  }
+
+  typename rclcpp::Publisher<MessageT>::SharedPtr publisher;
+  if (publishes) {
+    rclcpp::Node::SharedPtr node = add_node("perf_pub");
+    publisher = node->create_publisher<MessageT>(hop_topic(0), qos);
+  }
+
+  std::thread spinner([&executor]() {executor.spin();});
+
+  int ret = 0;
+  if (publishes) {
+    if (!wait_for_subscribers(nodes.back(), hop_topic(0), options.timeout)) {
+      fprintf(stderr, "no subscriber on '%s'\n", hop_topic(0).c_str());
+      ret = 1;
+    }
+    MessageT prototype;
+    Traits::fill(prototype, options.size);
+    Recorder sent(options, allocation_counter);
+    std::unique_ptr<rclcpp::WallRate> rate;
+    if (options.rate > 0.0) {
+      rate.reset(new rclcpp::WallRate(options.rate));
+    }
+    for (size_t i = 0; 0 == ret && rclcpp::ok() && i < options.warmup + options.count; ++i) {
+      if (pipeline) {
+        // Ownership of the message is passed along, it is never copied
+        std::unique_ptr<MessageT> msg(new MessageT(prototype));
+        to_time(now_ns(), Traits::stamp(*msg));
+        publisher->publish(msg);
+      } else {
+        to_time(now_ns(), Traits::stamp(prototype));
+        publisher->publish(prototype);
+        sent.on_message(Traits::size(prototype));
+      }
+      if (rate) {
+        rate->sleep();
+      }
+    }
+    if (!pipeline) {
+      sent.stop();
+      // Let the last messages be delivered before the publisher goes away
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+      if (!options.output.empty()) {
+        FILE * file = fopen(options.output.c_str(), "w");
+        if (file) {
+          sent.write(options, file);
+          fclose(file);
+        }
+      }
+    }
+  }
+
+  if (options.role != "pub") {
+    while (rclcpp::ok() && !recorder.done() &&
+      recorder.idle() < static_cast<int64_t>(options.timeout * 1e9))
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  executor.cancel();
+  spinner.join();
+  recorder.stop();
+
+  if (options.role != "pub") {
+    FILE * file = options.output.empty() ? stdout : fopen(options.output.c_str(), "w");
+    if (!file) {
+      fprintf(stderr, "could not open '%s'\n", options.output.c_str());
+      return 1;
+    }
+    recorder.write(options, file);
+    if (file != stdout) {
+      fclose(file);
+    }
+    if (recorder.measured() == 0) {
+      fprintf(stderr, "no message received\n");
+      ret = 1;
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  if (argc < 3) {
+    fprintf(stderr, "Usage: %s <Image|PointCloud2|Builtins> <pub|relay|sub|pipeline> [options]\n",
+      argv[0]);
+    return 1;
+  }
+
+  Options options;
+  options.type = argv[1];
+  options.role = argv[2];
+  char ** begin = argv + 3;
+  char ** end = argv + argc;
+  char * value = nullptr;
+  if ((value = rcutils_cli_get_option(begin, end, "--rate"))) {
+    options.rate = std::strtod(value, nullptr);
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--size"))) {
+    options.size = std::strtoul(value, nullptr, 10);
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--count"))) {
+    options.count = std::strtoul(value, nullptr, 10);
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--warmup"))) {
+    options.warmup = std::strtoul(value, nullptr, 10);
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--hops"))) {
+    options.hops = std::strtoul(value, nullptr, 10);
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--hop"))) {
+    options.hop = std::strtoul(value, nullptr, 10);
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--depth"))) {
+    options.depth = std::strtoul(value, nullptr, 10);
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--timeout"))) {
+    options.timeout = std::strtod(value, nullptr);
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--namespace"))) {
+    options.namespace_ = value;
+  }
+  if ((value = rcutils_cli_get_option(begin, end, "--output"))) {
+    options.output = value;
+  }
+  options.allocations = rcutils_cli_option_exist(begin, end, "--allocations");
+  if (0 == options.count || options.rate < 0.0) {
+    fprintf(stderr, "--count must be positive and --rate must not be negative\n");
+    return 1;
+  }
+
+  rclcpp::init(argc, argv);
+
+  int ret = 1;
+  if (options.role != "pub" && options.role != "relay" && options.role != "sub" &&
+    options.role != "pipeline")
+  {
+    fprintf(stderr, "Unknown role '%s'\n", options.role.c_str());
+  } else if (options.type == "Image") {
+    ret = run<sensor_msgs::msg::Image>(options);
+  } else if (options.type == "PointCloud2") {
+    ret = run<sensor_msgs::msg::PointCloud2>(options);
+  } else if (options.type == "Builtins") {
+    ret = run<test_msgs::msg::Builtins>(options);
+  } else {
+    fprintf(stderr, "Unknown message type '%s'\n", options.type.c_str());
+  }
+  rclcpp::shutdown();
+  return ret;
+}
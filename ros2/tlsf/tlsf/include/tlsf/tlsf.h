@@ -27,8 +27,11 @@ extern "C"
 #include <sys/types.h>
 
 extern size_t init_memory_pool(size_t, void *);
+extern size_t init_memory_pool_ex(size_t, void *);
 extern size_t get_used_size(void *);
 extern size_t get_max_size(void *);
+extern size_t get_free_size(void *);
+extern size_t get_largest_free_block(void *);
 extern void destroy_memory_pool(void *);
 extern size_t add_new_area(void *, size_t, void *);
 extern void *malloc_ex(size_t, void *);
@@ -462,6 +462,18 @@ static char *mp = NULL;         /* Default memory pool. */
 size_t init_memory_pool(size_t mem_pool_size, void *mem_pool)
 {
 /******************************************************************/
+    size_t size = init_memory_pool_ex(mem_pool_size, mem_pool);
+
+    if (size != (size_t) -1)
+        mp = mem_pool;
+    return size;
+}
+
+/******************************************************************/
+size_t init_memory_pool_ex(size_t mem_pool_size, void *mem_pool)
+{
+/******************************************************************/
+    /* Same as init_memory_pool (), without making it the default pool */
     tlsf_t *tlsf;
     bhdr_t *b, *ib;
 
@@ -477,13 +489,10 @@ size_t init_memory_pool(size_t mem_pool_size, void *mem_pool)
     tlsf = (tlsf_t *) mem_pool;
     /* Check if already initialised */
     if (tlsf->tlsf_signature == TLSF_SIGNATURE) {
-        mp = mem_pool;
-        b = GET_NEXT_BLOCK(mp, ROUNDUP_SIZE(sizeof(tlsf_t)));
+        b = GET_NEXT_BLOCK(mem_pool, ROUNDUP_SIZE(sizeof(tlsf_t)));
         return b->size & BLOCK_SIZE;
     }
 
-    mp = mem_pool;
-
     /* Zeroing the memory pool */
     memset(mem_pool, 0, sizeof(tlsf_t));
 
@@ -606,6 +615,46 @@ size_t get_max_size(void *mem_pool)
 #endif
 }
 
+/******************************************************************/
+size_t get_free_size(void *mem_pool)
+{
+/******************************************************************/
+    tlsf_t *tlsf = (tlsf_t *) mem_pool;
+    size_t free_size = 0;
+    bhdr_t *b;
+    int fl, sl;
+
+    for (fl = 0; fl < REAL_FLI; fl++) {
+        for (sl = 0; sl < MAX_SLI; sl++) {
+            for (b = tlsf->matrix[fl][sl]; b; b = b->ptr.free_ptr.next)
+                free_size += b->size & BLOCK_SIZE;
+        }
+    }
+    return free_size;
+}
+
+/******************************************************************/
+size_t get_largest_free_block(void *mem_pool)
+{
+/******************************************************************/
+    tlsf_t *tlsf = (tlsf_t *) mem_pool;
+    size_t largest = 0;
+    bhdr_t *b;
+    int fl, sl;
+
+    if (!tlsf->fl_bitmap)
+        return 0;
+
+    /* The largest free block is in the highest non empty list */
+    fl = ms_bit(tlsf->fl_bitmap);
+    sl = ms_bit(tlsf->sl_bitmap[fl]);
+    for (b = tlsf->matrix[fl][sl]; b; b = b->ptr.free_ptr.next) {
+        if ((b->size & BLOCK_SIZE) > largest)
+            largest = b->size & BLOCK_SIZE;
+    }
+    return largest;
+}
+
 /******************************************************************/
 void destroy_memory_pool(void *mem_pool)
 {